@@ -1,4 +1,4 @@
-// Copyright (C) 2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2016-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -6,13 +6,94 @@
 
 #include <config.h>
 #include <agent/ctrl_agent_cfg_mgr.h>
+#include <dhcpsrv/parsers/dhcp_parsers.h>
+#include <boost/foreach.hpp>
+#include <limits>
+#include <sstream>
 
+using namespace isc::data;
 using namespace isc::dhcp;
 using namespace isc::process;
 
 namespace isc {
 namespace agent {
 
+const char* CtrlAgentCfgContext::DFT_HTTP_HOST = "127.0.0.1";
+const uint16_t CtrlAgentCfgContext::DFT_HTTP_PORT;
+const uint32_t CtrlAgentCfgContext::DFT_HTTP_REQUEST_TIMEOUT;
+const uint32_t CtrlAgentCfgContext::DFT_HTTP_IDLE_TIMEOUT;
+const uint32_t CtrlAgentCfgContext::DFT_HTTP_MAX_REQUEST_SIZE;
+const uint32_t CtrlAgentCfgContext::DFT_CONTROL_SOCKET_TIMEOUT;
+
+CtrlAgentCfgContext::CtrlAgentCfgContext()
+    : http_host_(DFT_HTTP_HOST), http_port_(DFT_HTTP_PORT),
+      http_request_timeout_(DFT_HTTP_REQUEST_TIMEOUT),
+      http_idle_timeout_(DFT_HTTP_IDLE_TIMEOUT),
+      http_max_request_size_(DFT_HTTP_MAX_REQUEST_SIZE),
+      control_socket_timeout_(DFT_CONTROL_SOCKET_TIMEOUT),
+      control_sockets_() {
+}
+
+std::string
+CtrlAgentCfgContext::getControlSocket(const std::string& service) const {
+    ControlSocketMap::const_iterator socket = control_sockets_.find(service);
+    if (socket == control_sockets_.end()) {
+        return ("");
+    }
+    return (socket->second);
+}
+
+ControlSocketsParser::ControlSocketsParser(const CtrlAgentCfgContextPtr& context)
+    : context_(context), control_sockets_() {
+}
+
+void
+ControlSocketsParser::build(ConstElementPtr sockets_config) {
+    if (sockets_config->getType() != Element::map) {
+        isc_throw(CtrlAgentCfgError, "control-sockets must be a map ("
+                  << sockets_config->getPosition() << ")");
+    }
+
+    ConfigPair service;
+    BOOST_FOREACH(service, sockets_config->mapValue()) {
+        ConstElementPtr socket = service.second;
+        if (socket->getType() != Element::map) {
+            isc_throw(CtrlAgentCfgError, "control socket of the service "
+                      << service.first << " must be a map ("
+                      << socket->getPosition() << ")");
+        }
+
+        ConstElementPtr socket_type = socket->get("socket-type");
+        if (!socket_type || (socket_type->getType() != Element::string)) {
+            isc_throw(CtrlAgentCfgError, "missing socket-type of the control"
+                      " socket of the service " << service.first << " ("
+                      << socket->getPosition() << ")");
+        }
+
+        if (socket_type->stringValue() != "unix") {
+            isc_throw(CtrlAgentCfgError, "unsupported socket-type '"
+                      << socket_type->stringValue() << "' of the control"
+                      " socket of the service " << service.first << " ("
+                      << socket_type->getPosition() << ")");
+        }
+
+        ConstElementPtr socket_name = socket->get("socket-name");
+        if (!socket_name || (socket_name->getType() != Element::string) ||
+            socket_name->stringValue().empty()) {
+            isc_throw(CtrlAgentCfgError, "missing socket-name of the control"
+                      " socket of the service " << service.first << " ("
+                      << socket->getPosition() << ")");
+        }
+
+        control_sockets_[service.first] = socket_name->stringValue();
+    }
+}
+
+void
+ControlSocketsParser::commit() {
+    context_->setControlSockets(control_sockets_);
+}
+
 CtrlAgentCfgMgr::CtrlAgentCfgMgr()
     : DCfgMgrBase(DCfgContextBasePtr(new CtrlAgentCfgContext())) {
 }
@@ -22,15 +103,107 @@ CtrlAgentCfgMgr::~CtrlAgentCfgMgr() {
 
 std::string
 CtrlAgentCfgMgr::getConfigSummary(const uint32_t /*selection*/) {
-    return ("Control Agent is currently not configurable.");
+    CtrlAgentCfgContextPtr context = getCtrlAgentCfgContext();
+    std::ostringstream s;
+    s << "listening on " << context->getHttpHost() << ", port "
+      << context->getHttpPort() << ", control sockets: ";
+
+    const ControlSocketMap& sockets = context->getControlSockets();
+    if (sockets.empty()) {
+        s << "none";
+    }
+    for (ControlSocketMap::const_iterator socket = sockets.begin();
+         socket != sockets.end(); ++socket) {
+        s << (socket == sockets.begin() ? "" : ", ") << socket->first;
+    }
+    return (s.str());
+}
+
+void
+CtrlAgentCfgMgr::buildParams(ConstElementPtr params_config) {
+    // Base class build creates parses and invokes build on each parser.
+    // This populate the context scalar stores with all of the parameters.
+    DCfgMgrBase::buildParams(params_config);
+
+    CtrlAgentCfgContextPtr context = getCtrlAgentCfgContext();
+    StringStoragePtr strings = context->getStringStorage();
+    Uint32StoragePtr ints = context->getUint32Storage();
+
+    // Fetch and validate the address of the HTTP service.
+    std::string http_host =
+        strings->getOptionalParam("http-host",
+                                  CtrlAgentCfgContext::DFT_HTTP_HOST);
+    try {
+        context->setHttpHost(asiolink::IOAddress(http_host));
+    } catch (const std::exception& ex) {
+        isc_throw(CtrlAgentCfgError, "http-host invalid : \"" << http_host
+                  << "\" (" << strings->getPosition("http-host") << ")");
+    }
+
+    // Fetch and validate the port of the HTTP service.
+    uint32_t http_port =
+        ints->getOptionalParam("http-port",
+                               static_cast<uint32_t>(CtrlAgentCfgContext::
+                                                     DFT_HTTP_PORT));
+    if ((http_port == 0) ||
+        (http_port > std::numeric_limits<uint16_t>::max())) {
+        isc_throw(CtrlAgentCfgError, "http-port must be between 1 and "
+                  << std::numeric_limits<uint16_t>::max() << " ("
+                  << ints->getPosition("http-port") << ")");
+    }
+    context->setHttpPort(static_cast<uint16_t>(http_port));
+
+    // Fetch and validate the timeouts. The HTTP listener uses signed
+    // values.
+    const char* timeouts[] = { "http-request-timeout", "http-idle-timeout",
+                               "control-socket-timeout" };
+    const uint32_t defaults[] = {
+        CtrlAgentCfgContext::DFT_HTTP_REQUEST_TIMEOUT,
+        CtrlAgentCfgContext::DFT_HTTP_IDLE_TIMEOUT,
+        CtrlAgentCfgContext::DFT_CONTROL_SOCKET_TIMEOUT
+    };
+    uint32_t values[3];
+    for (int i = 0; i < 3; ++i) {
+        values[i] = ints->getOptionalParam(timeouts[i], defaults[i]);
+        if ((values[i] == 0) ||
+            (values[i] > static_cast<uint32_t>(std::numeric_limits<int>::max()))) {
+            isc_throw(CtrlAgentCfgError, timeouts[i] << " must be between 1"
+                      " and " << std::numeric_limits<int>::max() << " ("
+                      << ints->getPosition(timeouts[i]) << ")");
+        }
+    }
+    context->setHttpRequestTimeout(values[0]);
+    context->setHttpIdleTimeout(values[1]);
+    context->setControlSocketTimeout(values[2]);
+
+    // Fetch the maximum size of the request, 0 means unlimited.
+    context->setHttpMaxRequestSize(ints->getOptionalParam("http-max-request-size",
+                                                          CtrlAgentCfgContext::
+                                                          DFT_HTTP_MAX_REQUEST_SIZE));
 }
 
 isc::dhcp::ParserPtr
 CtrlAgentCfgMgr::createConfigParser(const std::string& element_id,
-                                    const isc::data::Element::Position& /*pos*/) {
-    // Create dummy parser, so as we don't return null pointer.
+                                    const isc::data::Element::Position& pos) {
+    CtrlAgentCfgContextPtr context = getCtrlAgentCfgContext();
+
     isc::dhcp::ParserPtr parser;
-    parser.reset(new Uint32Parser(element_id, getContext()->getUint32Storage()));
+    if ((element_id == "http-port") ||
+        (element_id == "http-request-timeout") ||
+        (element_id == "http-idle-timeout") ||
+        (element_id == "http-max-request-size") ||
+        (element_id == "control-socket-timeout")) {
+        parser.reset(new Uint32Parser(element_id, context->getUint32Storage()));
+    } else if (element_id == "http-host") {
+        parser.reset(new StringParser(element_id, context->getStringStorage()));
+    } else if (element_id == "control-sockets") {
+        parser.reset(new ControlSocketsParser(context));
+    } else {
+        isc_throw(NotImplemented,
+                  "parser error: Control Agent parameter not supported : "
+                  " (" << element_id << pos << ")");
+    }
+
     return (parser);
 }
 
@@ -1,4 +1,4 @@
-// Copyright (C) 2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2016-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -7,12 +7,28 @@
 #ifndef CTRL_AGENT_CFG_MGR_H
 #define CTRL_AGENT_CFG_MGR_H
 
+#include <asiolink/io_address.h>
+#include <dhcpsrv/parsers/dhcp_config_parser.h>
 #include <process/d_cfg_mgr.h>
 #include <boost/pointer_cast.hpp>
+#include <map>
+#include <stdint.h>
+#include <string>
 
 namespace isc {
 namespace agent {
 
+/// @brief Exception thrown when the Control Agent configuration is invalid.
+class CtrlAgentCfgError : public isc::Exception {
+public:
+    CtrlAgentCfgError(const char* file, size_t line, const char* what) :
+        isc::Exception(file, line, what) { };
+};
+
+/// @brief Maps the names of the services, e.g. "dhcp4", to the names of
+/// the UNIX sockets on which the services accept the control commands.
+typedef std::map<std::string, std::string> ControlSocketMap;
+
 class CtrlAgentCfgContext;
 /// @brief Pointer to a configuration context.
 typedef boost::shared_ptr<CtrlAgentCfgContext> CtrlAgentCfgContextPtr;
@@ -26,6 +42,32 @@ typedef boost::shared_ptr<CtrlAgentCfgContext> CtrlAgentCfgContextPtr;
 /// It is derived from the context base class, DCfgContextBase.
 class CtrlAgentCfgContext : public process::DCfgContextBase {
 public:
+
+    /// @brief Default address on which the HTTP service listens.
+    static const char* DFT_HTTP_HOST;
+
+    /// @brief Default port on which the HTTP service listens.
+    static const uint16_t DFT_HTTP_PORT = 8000;
+
+    /// @brief Default time to receive a HTTP request, in milliseconds.
+    static const uint32_t DFT_HTTP_REQUEST_TIMEOUT = 10000;
+
+    /// @brief Default time after which an idle persistent HTTP connection
+    /// is closed, in milliseconds.
+    static const uint32_t DFT_HTTP_IDLE_TIMEOUT = 30000;
+
+    /// @brief Default maximum size of a HTTP request, in bytes.
+    static const uint32_t DFT_HTTP_MAX_REQUEST_SIZE = 65536;
+
+    /// @brief Default time to wait for a response from a control socket,
+    /// in milliseconds.
+    static const uint32_t DFT_CONTROL_SOCKET_TIMEOUT = 10000;
+
+    /// @brief Constructor.
+    ///
+    /// Sets the parameters to their default values.
+    CtrlAgentCfgContext();
+
     /// @brief Creates a clone of this context object.
     ///
     /// @return A pointer to the new clone.
@@ -33,9 +75,170 @@ public:
         return (process::DCfgContextBasePtr(new CtrlAgentCfgContext(*this)));
     }
 
+    /// @brief Returns the address on which the HTTP service listens.
+    const asiolink::IOAddress& getHttpHost() const {
+        return (http_host_);
+    }
+
+    /// @brief Sets the address on which the HTTP service listens.
+    ///
+    /// @param http_host New address.
+    void setHttpHost(const asiolink::IOAddress& http_host) {
+        http_host_ = http_host;
+    }
+
+    /// @brief Returns the port on which the HTTP service listens.
+    uint16_t getHttpPort() const {
+        return (http_port_);
+    }
+
+    /// @brief Sets the port on which the HTTP service listens.
+    ///
+    /// @param http_port New port.
+    void setHttpPort(const uint16_t http_port) {
+        http_port_ = http_port;
+    }
+
+    /// @brief Returns the time to receive a HTTP request in milliseconds.
+    uint32_t getHttpRequestTimeout() const {
+        return (http_request_timeout_);
+    }
+
+    /// @brief Sets the time to receive a HTTP request.
+    ///
+    /// @param timeout New timeout in milliseconds.
+    void setHttpRequestTimeout(const uint32_t timeout) {
+        http_request_timeout_ = timeout;
+    }
+
+    /// @brief Returns the time after which an idle persistent HTTP
+    /// connection is closed, in milliseconds.
+    uint32_t getHttpIdleTimeout() const {
+        return (http_idle_timeout_);
+    }
+
+    /// @brief Sets the time after which an idle persistent HTTP connection
+    /// is closed.
+    ///
+    /// @param timeout New timeout in milliseconds.
+    void setHttpIdleTimeout(const uint32_t timeout) {
+        http_idle_timeout_ = timeout;
+    }
+
+    /// @brief Returns the maximum size of a HTTP request in bytes.
+    ///
+    /// The value of 0 means that the size is not limited.
+    uint32_t getHttpMaxRequestSize() const {
+        return (http_max_request_size_);
+    }
+
+    /// @brief Sets the maximum size of a HTTP request.
+    ///
+    /// @param size New size in bytes, 0 means that the size is not limited.
+    void setHttpMaxRequestSize(const uint32_t size) {
+        http_max_request_size_ = size;
+    }
+
+    /// @brief Returns the time to wait for a response from a control socket
+    /// in milliseconds.
+    uint32_t getControlSocketTimeout() const {
+        return (control_socket_timeout_);
+    }
+
+    /// @brief Sets the time to wait for a response from a control socket.
+    ///
+    /// @param timeout New timeout in milliseconds.
+    void setControlSocketTimeout(const uint32_t timeout) {
+        control_socket_timeout_ = timeout;
+    }
+
+    /// @brief Returns the control sockets of the services.
+    const ControlSocketMap& getControlSockets() const {
+        return (control_sockets_);
+    }
+
+    /// @brief Sets the control sockets of the services.
+    ///
+    /// @param control_sockets New control sockets.
+    void setControlSockets(const ControlSocketMap& control_sockets) {
+        control_sockets_ = control_sockets;
+    }
+
+    /// @brief Returns the name of the control socket of the service.
+    ///
+    /// @param service Name of the service, e.g. "dhcp4".
+    ///
+    /// @return Name of the socket or an empty string if the socket of the
+    /// service is not configured.
+    std::string getControlSocket(const std::string& service) const;
+
 private:
     /// @brief Private assignment operator to avoid potential for slicing.
     CtrlAgentCfgContext& operator=(const CtrlAgentCfgContext& rhs);
+
+    /// @brief Address on which the HTTP service listens.
+    asiolink::IOAddress http_host_;
+
+    /// @brief Port on which the HTTP service listens.
+    uint16_t http_port_;
+
+    /// @brief Time to receive a HTTP request in milliseconds.
+    uint32_t http_request_timeout_;
+
+    /// @brief Time after which an idle persistent HTTP connection is
+    /// closed, in milliseconds.
+    uint32_t http_idle_timeout_;
+
+    /// @brief Maximum size of a HTTP request in bytes.
+    uint32_t http_max_request_size_;
+
+    /// @brief Time to wait for a response from a control socket in
+    /// milliseconds.
+    uint32_t control_socket_timeout_;
+
+    /// @brief Control sockets of the services.
+    ControlSocketMap control_sockets_;
+};
+
+/// @brief Parser for the "control-sockets" map.
+///
+/// The map specifies the control socket of each service to which the
+/// Control Agent forwards the commands, e.g.:
+/// @code
+///     "control-sockets": {
+///         "dhcp4": {
+///             "socket-type": "unix",
+///             "socket-name": "/tmp/kea-dhcp4-ctrl.sock"
+///         }
+///     }
+/// @endcode
+///
+/// Only the "unix" socket type is currently supported.
+class ControlSocketsParser : public isc::dhcp::DhcpConfigParser {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// @param context Context into which the control sockets are committed.
+    explicit ControlSocketsParser(const CtrlAgentCfgContextPtr& context);
+
+    /// @brief Parses and validates the control sockets.
+    ///
+    /// @param sockets_config Map of the services' control sockets.
+    ///
+    /// @throw CtrlAgentCfgError if the configuration is invalid.
+    virtual void build(isc::data::ConstElementPtr sockets_config);
+
+    /// @brief Stores the parsed control sockets in the context.
+    virtual void commit();
+
+private:
+
+    /// @brief Context into which the control sockets are committed.
+    CtrlAgentCfgContextPtr context_;
+
+    /// @brief Parsed control sockets.
+    ControlSocketMap control_sockets_;
 };
 
 /// @brief Ctrl Agent Configuration Manager.
@@ -69,6 +272,15 @@ public:
 
 protected:
 
+    /// @brief Parses the global parameters and validates them.
+    ///
+    /// The values are stored in the context.
+    ///
+    /// @param params_config set of scalar configuration elements to parse
+    ///
+    /// @throw CtrlAgentCfgError if a parameter is invalid.
+    virtual void buildParams(isc::data::ConstElementPtr params_config);
+
     /// @brief  Create a parser instance based on an element id.
     ///
     /// Given an element_id returns an instance of the appropriate parser.
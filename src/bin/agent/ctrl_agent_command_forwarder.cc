@@ -0,0 +1,421 @@
+// Copyright (C) 2017 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <asiolink/asio_wrapper.h>
+#include <agent/ctrl_agent_command_forwarder.h>
+#include <asiolink/interval_timer.h>
+#include <cc/json_feed.h>
+#include <boost/asio/local/stream_protocol.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/bind.hpp>
+#include <boost/enable_shared_from_this.hpp>
+#include <boost/system/error_code.hpp>
+#include <deque>
+#include <poll.h>
+#include <string.h>
+#include <vector>
+
+using namespace isc::asiolink;
+using namespace isc::config;
+using namespace isc::data;
+
+namespace {
+
+/// @brief Size of the buffer used to receive the responses.
+const size_t RECEIVE_BUFFER_SIZE = 65536;
+
+}
+
+namespace isc {
+namespace agent {
+
+/// @brief Connection to the UNIX control socket of a single server.
+///
+/// The connection holds the queue of the commands forwarded to the socket.
+/// The command at the head of the queue is in progress, i.e. it is being
+/// sent or its response is being received. The next command is sent when
+/// the response has been received. The pending asynchronous operations hold
+/// the pointer to the connection, so it remains valid until they complete.
+class CtrlAgentCommandForwarder::Connection
+    : public boost::enable_shared_from_this<Connection> {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// @param forwarder Forwarder owning the connection.
+    /// @param socket_name Name of the UNIX socket.
+    Connection(CtrlAgentCommandForwarder& forwarder,
+               const std::string& socket_name)
+        : forwarder_(&forwarder), io_service_(forwarder.io_service_),
+          socket_name_(socket_name),
+          socket_(io_service_.get_io_service()),
+          timer_(io_service_), exchanges_(), output_buf_(),
+          input_buf_(RECEIVE_BUFFER_SIZE), feed_(), connected_(false),
+          in_progress_(false), closed_(false) {
+    }
+
+    /// @brief Queues the command.
+    ///
+    /// The command is sent when the previous commands have been answered.
+    ///
+    /// @param command Text of the command.
+    /// @param timeout Time to wait for the response in milliseconds.
+    /// @param handler Callback invoked with the response or the error.
+    void enqueue(const std::string& command, const long timeout,
+                 const ForwardHandler& handler) {
+        Exchange exchange = { command, timeout, handler };
+        exchanges_.push_back(exchange);
+
+        // Don't start the exchange right away, so as the handler is never
+        // invoked before the command has been queued by the caller.
+        if (!in_progress_) {
+            io_service_.post(boost::bind(&Connection::start,
+                                         shared_from_this()));
+        }
+    }
+
+    /// @brief Checks if the server has closed the idle connection.
+    ///
+    /// No data is expected on the idle connection. If it is readable the
+    /// server has closed it (or has sent garbage), so it must not be used.
+    ///
+    /// @return true if the connection is idle and can't be used.
+    bool isStale() {
+        if (!connected_ || !exchanges_.empty()) {
+            return (false);
+        }
+        struct pollfd pfd;
+        memset(&pfd, 0, sizeof(pfd));
+        pfd.fd = socket_.native_handle();
+        pfd.events = POLLIN;
+        return (poll(&pfd, 1, 0) != 0);
+    }
+
+    /// @brief Closes the connection.
+    ///
+    /// The handlers of the queued commands are posted to the IO service
+    /// with the error.
+    ///
+    /// @param error Error message passed to the handlers.
+    void close(const std::string& error) {
+        if (closed_) {
+            return;
+        }
+        closeSocket();
+        forwarder_ = 0;
+        for (std::deque<Exchange>::const_iterator exchange = exchanges_.begin();
+             exchange != exchanges_.end(); ++exchange) {
+            io_service_.post(boost::bind(exchange->handler_,
+                                         ConstElementPtr(), error));
+        }
+        exchanges_.clear();
+    }
+
+private:
+
+    /// @brief Command forwarded over the connection.
+    struct Exchange {
+        /// @brief Text of the command.
+        std::string command_;
+
+        /// @brief Time to wait for the response in milliseconds.
+        long timeout_;
+
+        /// @brief Callback invoked with the response or the error.
+        ForwardHandler handler_;
+    };
+
+    /// @brief Starts the exchange of the command at the head of the queue.
+    ///
+    /// Connects to the socket first if the connection hasn't been
+    /// established yet.
+    void start() {
+        if (closed_ || in_progress_ || exchanges_.empty()) {
+            return;
+        }
+        in_progress_ = true;
+
+        const long timeout = exchanges_.front().timeout_;
+        if (timeout > 0) {
+            timer_.setup(boost::bind(&Connection::timeoutCallback, this),
+                         timeout, IntervalTimer::ONE_SHOT);
+        }
+
+        if (connected_) {
+            send();
+            return;
+        }
+
+        try {
+            boost::asio::local::stream_protocol::endpoint endpoint(socket_name_);
+            socket_.async_connect(endpoint,
+                                  boost::bind(&Connection::connectCallback,
+                                              shared_from_this(),
+                                              boost::asio::placeholders::error));
+        } catch (const std::exception& ex) {
+            fail(std::string("failed to connect to the socket: ") + ex.what());
+        }
+    }
+
+    /// @brief Sends the command at the head of the queue.
+    void send() {
+        output_buf_ = exchanges_.front().command_;
+        boost::asio::async_write(socket_, boost::asio::buffer(output_buf_),
+                                 boost::bind(&Connection::sendCallback,
+                                             shared_from_this(),
+                                             boost::asio::placeholders::error));
+    }
+
+    /// @brief Starts receiving the response.
+    void receive() {
+        socket_.async_read_some(boost::asio::buffer(input_buf_),
+                                boost::bind(&Connection::receiveCallback,
+                                            shared_from_this(),
+                                            boost::asio::placeholders::error,
+                                            boost::asio::placeholders::
+                                            bytes_transferred));
+    }
+
+    /// @brief Callback invoked when the connection has been established.
+    ///
+    /// @param ec Error code.
+    void connectCallback(const boost::system::error_code& ec) {
+        if (closed_) {
+            return;
+        }
+        if (ec) {
+            fail("failed to connect to the socket: " + ec.message());
+            return;
+        }
+        connected_ = true;
+        send();
+    }
+
+    /// @brief Callback invoked when the command has been sent.
+    ///
+    /// @param ec Error code.
+    void sendCallback(const boost::system::error_code& ec) {
+        if (closed_) {
+            return;
+        }
+        if (ec) {
+            fail("failed to send the command: " + ec.message());
+            return;
+        }
+        receive();
+    }
+
+    /// @brief Callback invoked when a chunk of the response has been
+    /// received.
+    ///
+    /// The chunks are scanned as they are received and the response is
+    /// parsed once it is complete.
+    ///
+    /// @param ec Error code.
+    /// @param length Length of the received chunk.
+    void receiveCallback(const boost::system::error_code& ec,
+                         const size_t length) {
+        if (closed_) {
+            return;
+        }
+        if (ec == boost::asio::error::eof) {
+            fail("connection closed by the server before sending the whole"
+                 " response");
+            return;
+
+        } else if (ec) {
+            fail("failed to receive the response: " + ec.message());
+            return;
+        }
+
+        feed_.postBuffer(&input_buf_[0], length);
+        if (!feed_.elementReady()) {
+            receive();
+            return;
+        }
+
+        ConstElementPtr response;
+        try {
+            response = Element::fromJSON(feed_.popElement());
+        } catch (const std::exception& ex) {
+            fail(std::string("invalid response: ") + ex.what());
+            return;
+        }
+
+        // The data following the response can't be matched with any
+        // command, so the connection can't be used any more.
+        if (feed_.getPendingSize() > 0) {
+            fail("unexpected data received after the response");
+            return;
+        }
+
+        timer_.cancel();
+        in_progress_ = false;
+        ForwardHandler handler = exchanges_.front().handler_;
+        exchanges_.pop_front();
+
+        // The handler may forward another command or close the connection.
+        handler(response, std::string());
+        start();
+    }
+
+    /// @brief Callback invoked when the response hasn't been received
+    /// within the timeout.
+    void timeoutCallback() {
+        if (closed_) {
+            return;
+        }
+        fail("timeout waiting for the response");
+    }
+
+    /// @brief Closes the socket and cancels the timer.
+    void closeSocket() {
+        closed_ = true;
+        timer_.cancel();
+        boost::system::error_code ignored;
+        socket_.close(ignored);
+    }
+
+    /// @brief Closes the connection after an error of the exchange.
+    ///
+    /// The state of the connection is unknown after an error, e.g. the late
+    /// response would be taken as the response to the next command. The
+    /// command in progress fails, because the server may have executed it.
+    /// The queued commands are forwarded over a new connection, unless the
+    /// connection couldn't be established at all.
+    ///
+    /// @param error Error message.
+    void fail(const std::string& error) {
+        // Keep the connection alive until the handlers are invoked.
+        ConnectionPtr self = shared_from_this();
+        closeSocket();
+
+        const std::string msg = "error communicating over the socket " +
+            socket_name_ + ": " + error;
+        CtrlAgentCommandForwarder* forwarder = forwarder_;
+        forwarder_ = 0;
+
+        std::deque<Exchange> exchanges;
+        exchanges.swap(exchanges_);
+        if (forwarder) {
+            forwarder->connectionClosed(socket_name_, self);
+        }
+
+        for (std::deque<Exchange>::const_iterator exchange = exchanges.begin();
+             exchange != exchanges.end(); ++exchange) {
+            if (forwarder && connected_ && (exchange != exchanges.begin())) {
+                forwarder->getConnection(socket_name_)->
+                    enqueue(exchange->command_, exchange->timeout_,
+                            exchange->handler_);
+            } else {
+                exchange->handler_(ConstElementPtr(), msg);
+            }
+        }
+    }
+
+    /// @brief Forwarder owning the connection or null if the connection
+    /// has been closed.
+    CtrlAgentCommandForwarder* forwarder_;
+
+    /// @brief IO service used to exchange the commands.
+    IOService& io_service_;
+
+    /// @brief Name of the UNIX socket.
+    std::string socket_name_;
+
+    /// @brief Socket connected to the server.
+    boost::asio::local::stream_protocol::socket socket_;
+
+    /// @brief Timer guarding the exchange in progress.
+    IntervalTimer timer_;
+
+    /// @brief Queued commands, the first one is in progress.
+    std::deque<Exchange> exchanges_;
+
+    /// @brief Command being sent.
+    std::string output_buf_;
+
+    /// @brief Buffer receiving the response.
+    std::vector<char> input_buf_;
+
+    /// @brief Feed detecting the end of the response.
+    JSONFeed feed_;
+
+    /// @brief Indicates if the connection has been established.
+    bool connected_;
+
+    /// @brief Indicates if the exchange is in progress.
+    bool in_progress_;
+
+    /// @brief Indicates if the connection has been closed.
+    bool closed_;
+};
+
+CtrlAgentCommandForwarder::CtrlAgentCommandForwarder(IOService& io_service,
+                                                     const long timeout)
+    : io_service_(io_service), timeout_(timeout), connections_() {
+}
+
+CtrlAgentCommandForwarder::~CtrlAgentCommandForwarder() {
+    closeAll();
+}
+
+void
+CtrlAgentCommandForwarder::asyncForward(const std::string& socket_name,
+                                        const ConstElementPtr& command,
+                                        const ForwardHandler& handler) {
+    if (!command) {
+        isc_throw(CtrlAgentCommandForwarderError, "command must not be null");
+    }
+    if (!handler) {
+        isc_throw(CtrlAgentCommandForwarderError, "handler must not be null");
+    }
+
+    getConnection(socket_name)->enqueue(command->str(), timeout_, handler);
+}
+
+void
+CtrlAgentCommandForwarder::closeAll() {
+    // The handlers may forward new commands, so the map is not iterated
+    // over while the connections are closed.
+    std::map<std::string, ConnectionPtr> connections;
+    connections.swap(connections_);
+    for (std::map<std::string, ConnectionPtr>::const_iterator conn =
+             connections.begin(); conn != connections.end(); ++conn) {
+        conn->second->close("connection closed");
+    }
+}
+
+CtrlAgentCommandForwarder::ConnectionPtr
+CtrlAgentCommandForwarder::getConnection(const std::string& socket_name) {
+    std::map<std::string, ConnectionPtr>::iterator conn =
+        connections_.find(socket_name);
+    if (conn != connections_.end()) {
+        if (!conn->second->isStale()) {
+            return (conn->second);
+        }
+        conn->second->close("connection closed by the server");
+        connections_.erase(conn);
+    }
+
+    ConnectionPtr connection(new Connection(*this, socket_name));
+    connections_[socket_name] = connection;
+    return (connection);
+}
+
+void
+CtrlAgentCommandForwarder::connectionClosed(const std::string& socket_name,
+                                            const ConnectionPtr& connection) {
+    std::map<std::string, ConnectionPtr>::iterator conn =
+        connections_.find(socket_name);
+    if ((conn != connections_.end()) && (conn->second == connection)) {
+        connections_.erase(conn);
+    }
+}
+
+} // namespace isc::agent
+} // namespace isc
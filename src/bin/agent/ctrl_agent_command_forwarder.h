@@ -0,0 +1,156 @@
+// Copyright (C) 2017 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef CTRL_AGENT_COMMAND_FORWARDER_H
+#define CTRL_AGENT_COMMAND_FORWARDER_H
+
+#include <asiolink/io_service.h>
+#include <cc/data.h>
+#include <exceptions/exceptions.h>
+#include <boost/function.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <map>
+#include <string>
+
+namespace isc {
+namespace agent {
+
+/// @brief Exception thrown when a command couldn't be forwarded or the
+/// response couldn't be received.
+class CtrlAgentCommandForwarderError : public isc::Exception {
+public:
+    CtrlAgentCommandForwarderError(const char* file, size_t line,
+                                   const char* what) :
+        isc::Exception(file, line, what) { };
+};
+
+/// @brief Forwards the control commands to the Kea servers.
+///
+/// The commands are sent to the UNIX control sockets of the servers (see
+/// @c isc::config::CommandMgr). The server keeps the connection open after
+/// sending the response, so the forwarder keeps one connection per socket
+/// and reuses it for the subsequent commands. This saves a connection setup
+/// and teardown on the server for each command.
+///
+/// The exchange is asynchronous: the command is sent and the response is
+/// received over the IO service used by the Control Agent, and the handler
+/// is invoked when the response has been received, when an error occurred
+/// or when the server hasn't responded within the timeout. The server
+/// responds to the commands in order, so the commands forwarded to the same
+/// socket while the previous command is in progress are queued and sent
+/// one after another.
+///
+/// The server may close the connection while it is not used, e.g. when it
+/// is reconfigured or restarted. The forwarder checks if the server has
+/// closed the connection before sending the command over it and connects
+/// again in such case. The command is not resent if the connection breaks
+/// after it has been sent, because the server may have executed it. The
+/// connection is closed in such case and the queued commands are sent over
+/// a new connection.
+class CtrlAgentCommandForwarder : public boost::noncopyable {
+public:
+
+    /// @brief Type of the callback invoked when the command has been
+    /// forwarded.
+    ///
+    /// The first argument is the response received from the server or null
+    /// if the command couldn't be forwarded. The second argument holds the
+    /// error message in the latter case.
+    typedef boost::function<void(const data::ConstElementPtr&,
+                                 const std::string&)> ForwardHandler;
+
+    /// @brief Constructor.
+    ///
+    /// @param io_service IO service used to exchange the commands.
+    /// @param timeout Time to wait for a response in milliseconds.
+    CtrlAgentCommandForwarder(asiolink::IOService& io_service,
+                              const long timeout);
+
+    /// @brief Destructor.
+    ///
+    /// Closes all connections.
+    ~CtrlAgentCommandForwarder();
+
+    /// @brief Sets the time to wait for a response.
+    ///
+    /// The new timeout applies to the commands forwarded after the call.
+    ///
+    /// @param timeout New timeout in milliseconds.
+    void setTimeout(const long timeout) {
+        timeout_ = timeout;
+    }
+
+    /// @brief Sends the command to the socket without waiting for the
+    /// response.
+    ///
+    /// The handler is invoked from the IO service, never before this method
+    /// returns.
+    ///
+    /// @param socket_name Name of the UNIX socket of the server.
+    /// @param command Command to be sent.
+    /// @param handler Callback invoked with the response or the error.
+    /// @throw CtrlAgentCommandForwarderError if the command or the handler
+    /// is null.
+    void asyncForward(const std::string& socket_name,
+                      const data::ConstElementPtr& command,
+                      const ForwardHandler& handler);
+
+    /// @brief Closes all connections.
+    ///
+    /// The handlers of the commands in progress and of the queued commands
+    /// are invoked with an error.
+    void closeAll();
+
+    /// @brief Returns the number of open connections.
+    size_t getConnectionCount() const {
+        return (connections_.size());
+    }
+
+private:
+
+    /// @brief Connection to a single socket (defined in the .cc file).
+    class Connection;
+
+    /// @brief Pointer to the @c Connection.
+    typedef boost::shared_ptr<Connection> ConnectionPtr;
+
+    /// @brief Returns the connection to the socket.
+    ///
+    /// The idle connection is replaced with a new one if the server has
+    /// closed it.
+    ///
+    /// @param socket_name Name of the UNIX socket.
+    /// @return Pointer to the existing or the new connection.
+    ConnectionPtr getConnection(const std::string& socket_name);
+
+    /// @brief Removes the connection which has been closed.
+    ///
+    /// Called by the connection when it is closed because of an error.
+    ///
+    /// @param socket_name Name of the UNIX socket.
+    /// @param connection Pointer to the closed connection.
+    void connectionClosed(const std::string& socket_name,
+                          const ConnectionPtr& connection);
+
+    /// @brief IO service used to exchange the commands.
+    asiolink::IOService& io_service_;
+
+    /// @brief Time to wait for a response in milliseconds.
+    long timeout_;
+
+    /// @brief Open connections by socket name.
+    std::map<std::string, ConnectionPtr> connections_;
+};
+
+/// @brief Pointer to the @ref CtrlAgentCommandForwarder.
+typedef boost::shared_ptr<CtrlAgentCommandForwarder>
+CtrlAgentCommandForwarderPtr;
+
+} // namespace isc::agent
+} // namespace isc
+
+#endif
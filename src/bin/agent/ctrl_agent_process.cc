@@ -7,9 +7,11 @@
 #include <config.h>
 #include <agent/ctrl_agent_process.h>
 #include <agent/ctrl_agent_log.h>
+#include <agent/ctrl_agent_response_creator.h>
 #include <cc/command_interpreter.h>
 #include <boost/pointer_cast.hpp>
 
+using namespace isc::http;
 using namespace isc::process;
 
 namespace isc {
@@ -17,7 +19,11 @@ namespace agent {
 
 CtrlAgentProcess::CtrlAgentProcess(const char* name,
                                    const asiolink::IOServicePtr& io_service)
-    : DProcessBase(name, io_service, DCfgMgrBasePtr(new CtrlAgentCfgMgr())) {
+    : DProcessBase(name, io_service, DCfgMgrBasePtr(new CtrlAgentCfgMgr())),
+      http_listener_(),
+      forwarder_(new CtrlAgentCommandForwarder(*io_service,
+                                               CtrlAgentCfgContext::
+                                               DFT_CONTROL_SOCKET_TIMEOUT)) {
 }
 
 CtrlAgentProcess::~CtrlAgentProcess() {
@@ -35,10 +41,18 @@ CtrlAgentProcess::run() {
         while (!shouldShutdown()) {
             getIoService()->run_one();
         }
+        if (http_listener_) {
+            http_listener_->stop();
+        }
+        forwarder_->closeAll();
         stopIOService();
     } catch (const std::exception& ex) {
         LOG_FATAL(agent_logger, CTRL_AGENT_FAILED).arg(ex.what());
         try {
+            if (http_listener_) {
+                http_listener_->stop();
+            }
+            forwarder_->closeAll();
             stopIOService();
         } catch (...) {
             // Ignore double errors
@@ -61,9 +75,60 @@ CtrlAgentProcess::configure(isc::data::ConstElementPtr config_set) {
     int rcode = 0;
     isc::data::ConstElementPtr answer = getCfgMgr()->parseConfig(config_set);
     config::parseAnswer(rcode, answer);
+    if (rcode != 0) {
+        return (answer);
+    }
+
+    // The control sockets may have changed, so don't reuse the connections.
+    CtrlAgentCfgContextPtr ctx = getCtrlAgentCfgMgr()->getCtrlAgentCfgContext();
+    forwarder_->closeAll();
+    forwarder_->setTimeout(ctx->getControlSocketTimeout());
+
+    try {
+        startHttpListener();
+
+    } catch (const std::exception& ex) {
+        LOG_ERROR(agent_logger, CTRL_AGENT_HTTP_SERVICE_START_FAILED)
+            .arg(ctx->getHttpHost().toText())
+            .arg(ctx->getHttpPort())
+            .arg(ex.what());
+        return (isc::config::createAnswer(1, std::string("failed to start"
+                                                         " HTTP service: ") +
+                                          ex.what()));
+    }
+
+    LOG_INFO(agent_logger, CTRL_AGENT_HTTP_SERVICE_STARTED)
+        .arg(ctx->getHttpHost().toText())
+        .arg(ctx->getHttpPort());
+
     return (answer);
 }
 
+void
+CtrlAgentProcess::startHttpListener() {
+    CtrlAgentCfgContextPtr ctx = getCtrlAgentCfgMgr()->getCtrlAgentCfgContext();
+
+    // The new listener may use the same address and port, so the old one
+    // must release them first. The established connections are closed.
+    if (http_listener_) {
+        http_listener_->stop();
+        http_listener_.reset();
+    }
+
+    HttpResponseCreatorFactoryPtr
+        factory(new CtrlAgentResponseCreatorFactory(getCtrlAgentCfgMgr(),
+                                                    forwarder_));
+    HttpListenerPtr listener(new HttpListener(*getIoService(),
+                                              ctx->getHttpHost(),
+                                              ctx->getHttpPort(),
+                                              factory,
+                                              ctx->getHttpRequestTimeout(),
+                                              ctx->getHttpIdleTimeout(),
+                                              ctx->getHttpMaxRequestSize()));
+    listener->start();
+    http_listener_ = listener;
+}
+
 isc::data::ConstElementPtr
 CtrlAgentProcess::command(const std::string& command,
                           isc::data::ConstElementPtr /*args*/) {
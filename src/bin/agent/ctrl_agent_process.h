@@ -1,4 +1,4 @@
-// Copyright (C) 2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2016-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -8,6 +8,8 @@
 #define CTRL_AGENT_PROCESS_H
 
 #include <agent/ctrl_agent_cfg_mgr.h>
+#include <agent/ctrl_agent_command_forwarder.h>
+#include <http/listener.h>
 #include <process/d_process.h>
 
 namespace isc {
@@ -27,6 +29,11 @@ namespace agent {
 /// Some commands are handled by the Control Agent process itself, rather than
 /// forwarded to the Kea servers. An example of such command is the one that
 /// instructs the agent to start a specific service.
+///
+/// The HTTP connections are persistent, i.e. the client may send many
+/// requests over the same connection. The connections to the control
+/// sockets of the Kea servers are also kept open and reused for the
+/// subsequent commands (see @ref CtrlAgentCommandForwarder).
 class CtrlAgentProcess : public process::DProcessBase {
 public:
     /// @brief Constructor
@@ -78,6 +85,10 @@ public:
     /// processing errors and return a success or failure answer as described
     /// below.
     ///
+    /// When the configuration is accepted, the HTTP listener is (re)started
+    /// with the new parameters. The connections to the control sockets are
+    /// closed because the sockets may have changed.
+    ///
     /// @param config_set a new configuration (JSON) for the process
     /// @return an Element that contains the results of configuration composed
     /// of an integer status value (0 means successful, non-zero means failure),
@@ -107,6 +118,29 @@ public:
 
     /// @brief Returns a pointer to the configuration manager.
     CtrlAgentCfgMgrPtr getCtrlAgentCfgMgr();
+
+    /// @brief Returns a pointer to the HTTP listener.
+    ///
+    /// @return Pointer to the listener or null pointer if the process
+    /// hasn't been configured yet.
+    http::HttpListenerPtr getHttpListener() const {
+        return (http_listener_);
+    }
+
+private:
+
+    /// @brief Creates and starts the HTTP listener using the current
+    /// configuration.
+    ///
+    /// @throw HttpListenerError if the listener couldn't be started.
+    void startHttpListener();
+
+    /// @brief Pointer to the HTTP listener receiving the commands.
+    http::HttpListenerPtr http_listener_;
+
+    /// @brief Pointer to the forwarder sending the commands to the
+    /// Kea servers.
+    CtrlAgentCommandForwarderPtr forwarder_;
 };
 
 /// @brief Defines a shared pointer to CtrlAgentProcess.
@@ -0,0 +1,226 @@
+// Copyright (C) 2017 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <agent/ctrl_agent_log.h>
+#include <agent/ctrl_agent_response_creator.h>
+#include <cc/command_interpreter.h>
+#include <http/post_request_json.h>
+#include <http/response_json.h>
+#include <boost/bind.hpp>
+#include <boost/pointer_cast.hpp>
+#include <boost/shared_ptr.hpp>
+#include <vector>
+
+using namespace isc::agent;
+using namespace isc::config;
+using namespace isc::data;
+using namespace isc::http;
+
+namespace {
+
+/// @brief State of the command forwarded to the services.
+///
+/// Collects the answers of the services and creates the response when all
+/// of them have been received. The state is shared by the callbacks of the
+/// forwarded commands.
+class ForwardState {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// @param request Pointer to the request.
+    /// @param handler Callback invoked with the response.
+    /// @param services_num Number of the services.
+    ForwardState(const ConstHttpRequestPtr& request,
+                 const HttpResponseHandler& handler,
+                 const size_t services_num)
+        : request_(request), handler_(handler), answers_(services_num),
+          remaining_(services_num) {
+    }
+
+    /// @brief Stores the answer of the service.
+    ///
+    /// Creates the response when this is the last answer.
+    ///
+    /// @param index Position of the service in the "service" list.
+    /// @param answer Answer of the service.
+    void setAnswer(const size_t index, const ConstElementPtr& answer) {
+        answers_[index] = answer;
+        if (--remaining_ == 0) {
+            createResponse();
+        }
+    }
+
+    /// @brief Creates the response from the answers and passes it to the
+    /// handler.
+    void createResponse() {
+        ElementPtr answers = Element::createList();
+        for (std::vector<ConstElementPtr>::const_iterator answer =
+                 answers_.begin(); answer != answers_.end(); ++answer) {
+            answers->add(boost::const_pointer_cast<Element>(*answer));
+        }
+
+        HttpResponseJsonPtr response(new HttpResponseJson(request_->getHttpVersion(),
+                                                          HttpStatusCode::OK));
+        response->setBodyAsJson(answers);
+        handler_(response);
+    }
+
+private:
+
+    /// @brief Pointer to the request.
+    ConstHttpRequestPtr request_;
+
+    /// @brief Callback invoked with the response.
+    HttpResponseHandler handler_;
+
+    /// @brief Answers of the services in the order of the "service" list.
+    std::vector<ConstElementPtr> answers_;
+
+    /// @brief Number of the services which haven't answered yet.
+    size_t remaining_;
+};
+
+/// @brief Pointer to the @c ForwardState.
+typedef boost::shared_ptr<ForwardState> ForwardStatePtr;
+
+/// @brief Callback invoked when the command has been forwarded to the
+/// service.
+///
+/// @param command_name Name of the command.
+/// @param service Name of the service.
+/// @param handler Callback invoked with the answer.
+/// @param answer Answer of the service or null on error.
+/// @param error Error message if the command couldn't be forwarded.
+void
+forwardCallback(const std::string& command_name, const std::string& service,
+                const boost::function<void(const ConstElementPtr&)>& handler,
+                const ConstElementPtr& answer, const std::string& error) {
+    if (answer) {
+        LOG_DEBUG(agent_logger, DBGLVL_COMMAND, CTRL_AGENT_COMMAND_FORWARDED)
+            .arg(command_name)
+            .arg(service);
+        handler(answer);
+        return;
+    }
+
+    LOG_ERROR(agent_logger, CTRL_AGENT_COMMAND_FORWARD_FAILED)
+        .arg(command_name)
+        .arg(service)
+        .arg(error);
+    handler(createAnswer(CONTROL_RESULT_ERROR, "failed to forward the"
+                         " command to the service " + service + ": " + error));
+}
+
+}
+
+namespace isc {
+namespace agent {
+
+CtrlAgentResponseCreator::
+CtrlAgentResponseCreator(const CtrlAgentCfgMgrPtr& cfg_mgr,
+                         const CtrlAgentCommandForwarderPtr& forwarder)
+    : cfg_mgr_(cfg_mgr), forwarder_(forwarder) {
+}
+
+HttpRequestPtr
+CtrlAgentResponseCreator::createNewHttpRequest() const {
+    return (HttpRequestPtr(new PostHttpRequestJson()));
+}
+
+HttpResponsePtr
+CtrlAgentResponseCreator::
+createStockHttpResponse(const ConstHttpRequestPtr& request,
+                        const HttpStatusCode& status_code) const {
+    // The request line may have not been received, e.g. when the request
+    // timed out. Use HTTP/1.1 in such case.
+    HttpVersion http_version(request->context()->http_version_major_,
+                             request->context()->http_version_minor_);
+    if (http_version.major_ == 0) {
+        http_version = HttpVersion(1, 1);
+    }
+    return (HttpResponsePtr(new HttpResponseJson(http_version, status_code)));
+}
+
+HttpResponsePtr
+CtrlAgentResponseCreator::
+createDynamicHttpResponse(const ConstHttpRequestPtr&) {
+    isc_throw(HttpResponseError, "the Control Agent creates the responses"
+              " asynchronously");
+}
+
+void
+CtrlAgentResponseCreator::
+asyncCreateDynamicHttpResponse(const ConstHttpRequestPtr& request,
+                               const HttpResponseHandler& handler) {
+    ConstPostHttpRequestJsonPtr request_json =
+        boost::dynamic_pointer_cast<const PostHttpRequestJson>(request);
+    ConstElementPtr body;
+    if (request_json) {
+        try {
+            body = request_json->getBodyAsJson();
+        } catch (...) {
+            // Malformed body is reported below.
+        }
+    }
+
+    // The command and the list of services must be specified.
+    if (!body || (body->getType() != Element::map) ||
+        !body->get("command") ||
+        (body->get("command")->getType() != Element::string) ||
+        !body->get("service") ||
+        (body->get("service")->getType() != Element::list)) {
+        handler(createStockHttpResponse(request, HttpStatusCode::BAD_REQUEST));
+        return;
+    }
+
+    // The servers don't understand the "service" parameter.
+    ElementPtr command = Element::createMap();
+    command->set("command", body->get("command"));
+    if (body->get("arguments")) {
+        command->set("arguments", body->get("arguments"));
+    }
+
+    const std::vector<ElementPtr>& services = body->get("service")->listValue();
+    ForwardStatePtr state(new ForwardState(request, handler, services.size()));
+    if (services.empty()) {
+        state->createResponse();
+        return;
+    }
+
+    for (size_t i = 0; i < services.size(); ++i) {
+        AnswerHandler answer_handler = boost::bind(&ForwardState::setAnswer,
+                                                   state, i, _1);
+        if (services[i]->getType() != Element::string) {
+            answer_handler(createAnswer(CONTROL_RESULT_ERROR,
+                                        "service name must be a string"));
+            continue;
+        }
+        forwardCommand(services[i]->stringValue(), command, answer_handler);
+    }
+}
+
+void
+CtrlAgentResponseCreator::forwardCommand(const std::string& service,
+                                         const ConstElementPtr& command,
+                                         const AnswerHandler& handler) {
+    const std::string socket_name =
+        cfg_mgr_->getCtrlAgentCfgContext()->getControlSocket(service);
+    if (socket_name.empty()) {
+        handler(createAnswer(CONTROL_RESULT_ERROR, "control socket of the"
+                             " service " + service + " is not configured"));
+        return;
+    }
+
+    forwarder_->asyncForward(socket_name, command,
+                             boost::bind(&forwardCallback,
+                                         command->get("command")->stringValue(),
+                                         service, handler, _1, _2));
+}
+
+} // namespace isc::agent
+} // namespace isc
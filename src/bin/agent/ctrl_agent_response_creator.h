@@ -0,0 +1,147 @@
+// Copyright (C) 2017 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef CTRL_AGENT_RESPONSE_CREATOR_H
+#define CTRL_AGENT_RESPONSE_CREATOR_H
+
+#include <agent/ctrl_agent_cfg_mgr.h>
+#include <agent/ctrl_agent_command_forwarder.h>
+#include <http/response_creator.h>
+#include <http/response_creator_factory.h>
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
+#include <string>
+
+namespace isc {
+namespace agent {
+
+/// @brief Concrete implementation of the HTTP response creator used
+/// by the Control Agent.
+///
+/// The body of the received request is a JSON map holding the "command"
+/// name, optional "arguments" and the "service" list naming the Kea servers
+/// to which the command should be forwarded, e.g.
+///
+/// @code
+/// {
+///     "command": "config-get",
+///     "service": [ "dhcp4", "dhcp6" ]
+/// }
+/// @endcode
+///
+/// The command (without the "service" list) is forwarded to the control
+/// socket of each listed service, as configured in the "control-sockets"
+/// map. The body of the response is a JSON list holding one answer per
+/// service, in the order of the "service" list. If the command couldn't
+/// be forwarded to a service, the corresponding answer holds an error
+/// status and the explanation.
+///
+/// The command is forwarded to all services at once and the response is
+/// sent when all of them have answered, so the Control Agent serves other
+/// requests while waiting for the answers.
+class CtrlAgentResponseCreator : public http::HttpResponseCreator {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// @param cfg_mgr Pointer to the configuration manager holding the
+    /// control sockets of the services.
+    /// @param forwarder Pointer to the command forwarder.
+    CtrlAgentResponseCreator(const CtrlAgentCfgMgrPtr& cfg_mgr,
+                             const CtrlAgentCommandForwarderPtr& forwarder);
+
+    /// @brief Create a new request.
+    ///
+    /// @return Pointer to the new instance of the
+    /// @ref isc::http::PostHttpRequestJson.
+    virtual http::HttpRequestPtr createNewHttpRequest() const;
+
+    /// @brief Creates stock HTTP response.
+    ///
+    /// @param request Pointer to an object representing HTTP request.
+    /// @param status_code Status code of the response.
+    /// @return Pointer to an @ref isc::http::HttpResponseJson object
+    /// representing stock HTTP response.
+    virtual http::HttpResponsePtr
+    createStockHttpResponse(const http::ConstHttpRequestPtr& request,
+                            const http::HttpStatusCode& status_code) const;
+
+private:
+
+    /// @brief Type of the callback invoked with the answer of a service.
+    typedef boost::function<void(const data::ConstElementPtr&)> AnswerHandler;
+
+    /// @brief Creates implementation specific HTTP response.
+    ///
+    /// The commands are forwarded asynchronously, so the response can't be
+    /// created synchronously. The @ref isc::http::HttpConnection uses
+    /// @c asyncCreateDynamicHttpResponse instead.
+    ///
+    /// @param request Pointer to an object representing HTTP request.
+    /// @throw isc::http::HttpResponseError always.
+    virtual http::HttpResponsePtr
+    createDynamicHttpResponse(const http::ConstHttpRequestPtr& request);
+
+    /// @brief Creates implementation specific HTTP response without
+    /// waiting for the answers of the services.
+    ///
+    /// Forwards the command to all services at once and invokes the handler
+    /// with the response when all services have answered.
+    ///
+    /// @param request Pointer to an object representing HTTP request.
+    /// @param handler Callback invoked with the created response.
+    virtual void
+    asyncCreateDynamicHttpResponse(const http::ConstHttpRequestPtr& request,
+                                   const http::HttpResponseHandler& handler);
+
+    /// @brief Forwards the command to a single service.
+    ///
+    /// @param service Name of the service.
+    /// @param command Command to be forwarded.
+    /// @param handler Callback invoked with the answer of the service or
+    /// with an error answer if the command couldn't be forwarded.
+    void forwardCommand(const std::string& service,
+                        const data::ConstElementPtr& command,
+                        const AnswerHandler& handler);
+
+    /// @brief Pointer to the configuration manager.
+    CtrlAgentCfgMgrPtr cfg_mgr_;
+
+    /// @brief Pointer to the command forwarder.
+    CtrlAgentCommandForwarderPtr forwarder_;
+};
+
+/// @brief HTTP response creator factory for the Control Agent.
+///
+/// The response creator doesn't hold the state of the requests in progress,
+/// so all connections can share the same response creator instance.
+class CtrlAgentResponseCreatorFactory : public http::HttpResponseCreatorFactory {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// @param cfg_mgr Pointer to the configuration manager.
+    /// @param forwarder Pointer to the command forwarder.
+    CtrlAgentResponseCreatorFactory(const CtrlAgentCfgMgrPtr& cfg_mgr,
+                                    const CtrlAgentCommandForwarderPtr& forwarder)
+        : sole_creator_(new CtrlAgentResponseCreator(cfg_mgr, forwarder)) {
+    }
+
+    /// @brief Returns an instance of the @ref CtrlAgentResponseCreator.
+    virtual http::HttpResponseCreatorPtr create() const {
+        return (sole_creator_);
+    }
+
+private:
+
+    /// @brief Instance of the response creator returned for each connection.
+    http::HttpResponseCreatorPtr sole_creator_;
+};
+
+} // namespace isc::agent
+} // namespace isc
+
+#endif
@@ -1,4 +1,4 @@
-// Copyright (C) 2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2016-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -6,14 +6,28 @@
 
 #include <config.h>
 #include <agent/ctrl_agent_cfg_mgr.h>
+#include <cc/command_interpreter.h>
 #include <process/testutils/d_test_stubs.h>
 #include <boost/scoped_ptr.hpp>
 #include <gtest/gtest.h>
 
 using namespace isc::agent;
+using namespace isc::config;
+using namespace isc::data;
 
 namespace  {
 
+/// @brief Parses the configuration and returns the status code.
+///
+/// @param cfg_mgr Configuration manager.
+/// @param config Configuration in the JSON format.
+int
+parseConfig(CtrlAgentCfgMgr& cfg_mgr, const std::string& config) {
+    int rcode = -1;
+    parseAnswer(rcode, cfg_mgr.parseConfig(Element::fromJSON(config)));
+    return (rcode);
+}
+
 // Tests construction of CtrlAgentCfgMgr class.
 TEST(CtrlAgentCfgMgr, construction) {
     boost::scoped_ptr<CtrlAgentCfgMgr> cfg_mgr;
@@ -30,4 +44,80 @@ TEST(CtrlAgentCfgMgr, construction) {
     EXPECT_NO_THROW(cfg_mgr.reset());
 }
 
+// Tests that the default values are used when the parameters are not
+// specified.
+TEST(CtrlAgentCfgMgr, defaults) {
+    CtrlAgentCfgMgr cfg_mgr;
+    ASSERT_EQ(0, parseConfig(cfg_mgr, "{ }"));
+
+    CtrlAgentCfgContextPtr context = cfg_mgr.getCtrlAgentCfgContext();
+    EXPECT_EQ("127.0.0.1", context->getHttpHost().toText());
+    EXPECT_EQ(CtrlAgentCfgContext::DFT_HTTP_PORT, context->getHttpPort());
+    EXPECT_EQ(CtrlAgentCfgContext::DFT_HTTP_REQUEST_TIMEOUT,
+              context->getHttpRequestTimeout());
+    EXPECT_EQ(CtrlAgentCfgContext::DFT_HTTP_IDLE_TIMEOUT,
+              context->getHttpIdleTimeout());
+    EXPECT_EQ(CtrlAgentCfgContext::DFT_HTTP_MAX_REQUEST_SIZE,
+              context->getHttpMaxRequestSize());
+    EXPECT_EQ(CtrlAgentCfgContext::DFT_CONTROL_SOCKET_TIMEOUT,
+              context->getControlSocketTimeout());
+    EXPECT_TRUE(context->getControlSockets().empty());
+}
+
+// Tests that all parameters are parsed.
+TEST(CtrlAgentCfgMgr, parameters) {
+    CtrlAgentCfgMgr cfg_mgr;
+    ASSERT_EQ(0, parseConfig(cfg_mgr, "{"
+                             "  \"http-host\": \"::1\","
+                             "  \"http-port\": 8080,"
+                             "  \"http-request-timeout\": 2000,"
+                             "  \"http-idle-timeout\": 5000,"
+                             "  \"http-max-request-size\": 1024,"
+                             "  \"control-socket-timeout\": 3000,"
+                             "  \"control-sockets\": {"
+                             "    \"dhcp4\": {"
+                             "      \"socket-type\": \"unix\","
+                             "      \"socket-name\": \"/tmp/kea4-ctrl-socket\""
+                             "    },"
+                             "    \"dhcp6\": {"
+                             "      \"socket-type\": \"unix\","
+                             "      \"socket-name\": \"/tmp/kea6-ctrl-socket\""
+                             "    }"
+                             "  }"
+                             "}"));
+
+    CtrlAgentCfgContextPtr context = cfg_mgr.getCtrlAgentCfgContext();
+    EXPECT_EQ("::1", context->getHttpHost().toText());
+    EXPECT_EQ(8080, context->getHttpPort());
+    EXPECT_EQ(2000, context->getHttpRequestTimeout());
+    EXPECT_EQ(5000, context->getHttpIdleTimeout());
+    EXPECT_EQ(1024, context->getHttpMaxRequestSize());
+    EXPECT_EQ(3000, context->getControlSocketTimeout());
+    EXPECT_EQ(2, context->getControlSockets().size());
+    EXPECT_EQ("/tmp/kea4-ctrl-socket", context->getControlSocket("dhcp4"));
+    EXPECT_EQ("/tmp/kea6-ctrl-socket", context->getControlSocket("dhcp6"));
+    EXPECT_TRUE(context->getControlSocket("d2").empty());
+}
+
+// Tests that invalid parameters are rejected.
+TEST(CtrlAgentCfgMgr, invalidParameters) {
+    CtrlAgentCfgMgr cfg_mgr;
+    EXPECT_NE(0, parseConfig(cfg_mgr, "{ \"http-host\": \"foo\" }"));
+    EXPECT_NE(0, parseConfig(cfg_mgr, "{ \"http-port\": 0 }"));
+    EXPECT_NE(0, parseConfig(cfg_mgr, "{ \"http-port\": 65536 }"));
+    EXPECT_NE(0, parseConfig(cfg_mgr, "{ \"http-request-timeout\": 0 }"));
+    EXPECT_NE(0, parseConfig(cfg_mgr, "{ \"http-idle-timeout\": 0 }"));
+    EXPECT_NE(0, parseConfig(cfg_mgr, "{ \"control-socket-timeout\": 0 }"));
+    EXPECT_NE(0, parseConfig(cfg_mgr, "{ \"unknown-parameter\": 1 }"));
+    EXPECT_NE(0, parseConfig(cfg_mgr, "{ \"control-sockets\": [ ] }"));
+    EXPECT_NE(0, parseConfig(cfg_mgr, "{ \"control-sockets\": {"
+                             "  \"dhcp4\": { \"socket-type\": \"tcp\","
+                             "               \"socket-name\": \"foo\" } } }"));
+    EXPECT_NE(0, parseConfig(cfg_mgr, "{ \"control-sockets\": {"
+                             "  \"dhcp4\": { \"socket-type\": \"unix\" } } }"));
+    EXPECT_NE(0, parseConfig(cfg_mgr, "{ \"control-sockets\": {"
+                             "  \"dhcp4\": { \"socket-type\": \"unix\","
+                             "               \"socket-name\": \"\" } } }"));
+}
+
 }
@@ -0,0 +1,272 @@
+// Copyright (C) 2017 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <agent/ctrl_agent_command_forwarder.h>
+#include <agent/tests/test_control_server.h>
+#include <asiolink/interval_timer.h>
+#include <asiolink/io_service.h>
+#include <cc/data.h>
+#include <boost/bind.hpp>
+#include <boost/lexical_cast.hpp>
+#include <gtest/gtest.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+
+using namespace isc::agent;
+using namespace isc::asiolink;
+using namespace isc::agent::test;
+using namespace isc::data;
+
+namespace {
+
+/// @brief Timeout for the responses used in the tests (ms).
+const long RESPONSE_TIMEOUT = 5000;
+
+/// @brief Time after which the test gives up waiting for the handlers (ms).
+const long TEST_TIMEOUT = 10000;
+
+/// @brief Test fixture class for @ref CtrlAgentCommandForwarder.
+class CtrlAgentCommandForwarderTest : public ::testing::Test {
+public:
+
+    /// @brief Constructor.
+    CtrlAgentCommandForwarderTest()
+        : io_service_(), forwarder_(io_service_, RESPONSE_TIMEOUT),
+          command_(Element::fromJSON("{ \"command\": \"list-commands\" }")),
+          answers_(), errors_() {
+    }
+
+    /// @brief Forwards the command to the socket.
+    ///
+    /// @param socket_name Name of the socket.
+    void forward(const std::string& socket_name) {
+        forwarder_.asyncForward(socket_name, command_,
+                                boost::bind(&CtrlAgentCommandForwarderTest::
+                                            forwardHandler, this, _1, _2));
+    }
+
+    /// @brief Handler recording the results of the forwarded commands.
+    ///
+    /// @param answer Answer of the server or null on error.
+    /// @param error Error message.
+    void forwardHandler(const ConstElementPtr& answer,
+                        const std::string& error) {
+        answers_.push_back(answer);
+        errors_.push_back(error);
+    }
+
+    /// @brief Runs the IO service until the specified number of handlers
+    /// have been invoked.
+    ///
+    /// @param handlers_num Number of the handlers.
+    void runIOService(const size_t handlers_num) {
+        bool expired = false;
+        IntervalTimer timer(io_service_);
+        timer.setup(boost::bind(&CtrlAgentCommandForwarderTest::timeoutHandler,
+                                &expired), TEST_TIMEOUT,
+                    IntervalTimer::ONE_SHOT);
+        while (!expired && (answers_.size() < handlers_num)) {
+            io_service_.run_one();
+        }
+        ASSERT_EQ(handlers_num, answers_.size());
+    }
+
+    /// @brief Callback invoked when the test timeout expires.
+    ///
+    /// @param expired Pointer to the flag set by the callback.
+    static void timeoutHandler(bool* expired) {
+        *expired = true;
+        ADD_FAILURE() << "timeout waiting for the forwarded commands";
+    }
+
+    /// @brief Returns the expected answer of the test server.
+    ///
+    /// @param command_num Number of the command received by the server.
+    static std::string expectedAnswer(const int command_num) {
+        return ("{ \"result\": 0, \"text\": \"command " +
+                boost::lexical_cast<std::string>(command_num) + "\" }");
+    }
+
+    /// @brief IO service used by the forwarder.
+    IOService io_service_;
+
+    /// @brief Forwarder under test.
+    CtrlAgentCommandForwarder forwarder_;
+
+    /// @brief Command sent in the tests.
+    ConstElementPtr command_;
+
+    /// @brief Answers passed to the handlers.
+    std::vector<ConstElementPtr> answers_;
+
+    /// @brief Error messages passed to the handlers.
+    std::vector<std::string> errors_;
+};
+
+// Verifies that the null command or handler is rejected.
+TEST_F(CtrlAgentCommandForwarderTest, nullArguments) {
+    EXPECT_THROW(forwarder_.asyncForward(TestControlServer::defaultSocketPath(),
+                                         ConstElementPtr(),
+                                         boost::bind(&CtrlAgentCommandForwarderTest::
+                                                     forwardHandler, this, _1, _2)),
+                 CtrlAgentCommandForwarderError);
+    EXPECT_THROW(forwarder_.asyncForward(TestControlServer::defaultSocketPath(),
+                                         command_,
+                                         CtrlAgentCommandForwarder::ForwardHandler()),
+                 CtrlAgentCommandForwarderError);
+}
+
+// Verifies that the connection to the socket is reused for the subsequent
+// commands.
+TEST_F(CtrlAgentCommandForwarderTest, reuseConnection) {
+    TestControlServer server(TestControlServer::RESPOND, 1);
+
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_NO_THROW(forward(server.getSocketPath()));
+        // The handler is never invoked before the command is queued.
+        EXPECT_EQ(i, answers_.size());
+        ASSERT_NO_FATAL_FAILURE(runIOService(i + 1));
+        ASSERT_TRUE(answers_[i]) << errors_[i];
+        EXPECT_EQ(expectedAnswer(i + 1), answers_[i]->str());
+        EXPECT_EQ(1, forwarder_.getConnectionCount());
+    }
+
+    forwarder_.closeAll();
+    EXPECT_EQ(0, forwarder_.getConnectionCount());
+
+    server.wait();
+    EXPECT_EQ(1, server.getConnectionsAccepted());
+    EXPECT_EQ(3, server.getCommandsReceived());
+}
+
+// Verifies that the commands forwarded to the same socket at once are
+// sent one after another over the same connection.
+TEST_F(CtrlAgentCommandForwarderTest, queuedCommands) {
+    TestControlServer server(TestControlServer::RESPOND, 1);
+
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_NO_THROW(forward(server.getSocketPath()));
+    }
+    EXPECT_EQ(1, forwarder_.getConnectionCount());
+    ASSERT_NO_FATAL_FAILURE(runIOService(3));
+
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_TRUE(answers_[i]) << errors_[i];
+        EXPECT_EQ(expectedAnswer(i + 1), answers_[i]->str());
+    }
+
+    forwarder_.closeAll();
+    server.wait();
+    EXPECT_EQ(1, server.getConnectionsAccepted());
+    EXPECT_EQ(3, server.getCommandsReceived());
+}
+
+// Verifies that the forwarder connects again when the server has closed
+// the connection.
+TEST_F(CtrlAgentCommandForwarderTest, reconnect) {
+    TestControlServer server(TestControlServer::RESPOND_AND_CLOSE, 2);
+
+    ASSERT_NO_THROW(forward(server.getSocketPath()));
+    ASSERT_NO_FATAL_FAILURE(runIOService(1));
+    EXPECT_TRUE(answers_[0]) << errors_[0];
+
+    // Give the server time to close the connection.
+    usleep(100000);
+    ASSERT_NO_THROW(forward(server.getSocketPath()));
+    ASSERT_NO_FATAL_FAILURE(runIOService(2));
+    EXPECT_TRUE(answers_[1]) << errors_[1];
+
+    server.wait();
+    EXPECT_EQ(2, server.getConnectionsAccepted());
+    EXPECT_EQ(2, server.getCommandsReceived());
+}
+
+// Verifies that the command in progress fails when the server closes the
+// connection, and the queued command is sent over a new connection.
+TEST_F(CtrlAgentCommandForwarderTest, resendQueued) {
+    TestControlServer server(TestControlServer::RESPOND_AND_CLOSE, 2);
+
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_NO_THROW(forward(server.getSocketPath()));
+    }
+    ASSERT_NO_FATAL_FAILURE(runIOService(3));
+
+    ASSERT_TRUE(answers_[0]) << errors_[0];
+    EXPECT_EQ(expectedAnswer(1), answers_[0]->str());
+    EXPECT_FALSE(answers_[1]);
+    EXPECT_FALSE(errors_[1].empty());
+    ASSERT_TRUE(answers_[2]) << errors_[2];
+    EXPECT_EQ(expectedAnswer(2), answers_[2]->str());
+
+    server.wait();
+    EXPECT_EQ(2, server.getConnectionsAccepted());
+}
+
+// Verifies that the response sent in several chunks is received.
+TEST_F(CtrlAgentCommandForwarderTest, splitResponse) {
+    TestControlServer server(TestControlServer::RESPOND_IN_CHUNKS, 1);
+
+    ASSERT_NO_THROW(forward(server.getSocketPath()));
+    ASSERT_NO_FATAL_FAILURE(runIOService(1));
+    ASSERT_TRUE(answers_[0]) << errors_[0];
+    EXPECT_EQ(expectedAnswer(1), answers_[0]->str());
+
+    forwarder_.closeAll();
+    server.wait();
+}
+
+// Verifies that an error is reported when the server is not running.
+TEST_F(CtrlAgentCommandForwarderTest, noServer) {
+    static_cast<void>(::remove(TestControlServer::defaultSocketPath().c_str()));
+
+    ASSERT_NO_THROW(forward(TestControlServer::defaultSocketPath()));
+    ASSERT_NO_THROW(forward(TestControlServer::defaultSocketPath()));
+    ASSERT_NO_FATAL_FAILURE(runIOService(2));
+
+    // The queued command fails too, because the connection couldn't be
+    // established.
+    for (int i = 0; i < 2; ++i) {
+        EXPECT_FALSE(answers_[i]);
+        EXPECT_FALSE(errors_[i].empty());
+    }
+    EXPECT_EQ(0, forwarder_.getConnectionCount());
+}
+
+// Verifies that the connection is closed when the server doesn't respond
+// within the timeout.
+TEST_F(CtrlAgentCommandForwarderTest, timeout) {
+    TestControlServer server(TestControlServer::NO_RESPONSE, 1);
+
+    forwarder_.setTimeout(100);
+    ASSERT_NO_THROW(forward(server.getSocketPath()));
+    ASSERT_NO_FATAL_FAILURE(runIOService(1));
+    EXPECT_FALSE(answers_[0]);
+    EXPECT_NE(std::string::npos, errors_[0].find("timeout"));
+    EXPECT_EQ(0, forwarder_.getConnectionCount());
+
+    server.wait();
+    EXPECT_EQ(1, server.getCommandsReceived());
+}
+
+// Verifies that the handlers of the pending commands are invoked with an
+// error when the connections are closed.
+TEST_F(CtrlAgentCommandForwarderTest, closeAll) {
+    ASSERT_NO_THROW(forward(TestControlServer::defaultSocketPath()));
+    ASSERT_NO_THROW(forward(TestControlServer::defaultSocketPath()));
+    forwarder_.closeAll();
+    EXPECT_EQ(0, forwarder_.getConnectionCount());
+    EXPECT_TRUE(answers_.empty());
+
+    ASSERT_NO_FATAL_FAILURE(runIOService(2));
+    for (int i = 0; i < 2; ++i) {
+        EXPECT_FALSE(answers_[i]);
+        EXPECT_FALSE(errors_[i].empty());
+    }
+}
+
+}
@@ -0,0 +1,216 @@
+// Copyright (C) 2017 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <agent/ctrl_agent_response_creator.h>
+#include <agent/tests/test_control_server.h>
+#include <asiolink/interval_timer.h>
+#include <asiolink/io_service.h>
+#include <cc/command_interpreter.h>
+#include <http/post_request_json.h>
+#include <http/request_parser.h>
+#include <boost/bind.hpp>
+#include <boost/lexical_cast.hpp>
+#include <gtest/gtest.h>
+
+using namespace isc::agent;
+using namespace isc::agent::test;
+using namespace isc::asiolink;
+using namespace isc::config;
+using namespace isc::data;
+using namespace isc::http;
+
+namespace {
+
+/// @brief Time after which the test gives up waiting for the response (ms).
+const long TEST_TIMEOUT = 10000;
+
+/// @brief Test fixture class for @ref CtrlAgentResponseCreator.
+class CtrlAgentResponseCreatorTest : public ::testing::Test {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// Configures the control socket of the "dhcp4" service and creates
+    /// the response creator.
+    CtrlAgentResponseCreatorTest()
+        : io_service_(), cfg_mgr_(new CtrlAgentCfgMgr()),
+          forwarder_(new CtrlAgentCommandForwarder(io_service_, 5000)),
+          factory_(cfg_mgr_, forwarder_) {
+        int rcode = -1;
+        parseAnswer(rcode, cfg_mgr_->parseConfig(Element::fromJSON(
+            "{ \"control-sockets\": {"
+            "    \"dhcp4\": {"
+            "      \"socket-type\": \"unix\","
+            "      \"socket-name\": \"" +
+            TestControlServer::defaultSocketPath() + "\""
+            "    }"
+            "} }")));
+        EXPECT_EQ(0, rcode);
+        creator_ = factory_.create();
+    }
+
+    /// @brief Parses the HTTP request and creates the response.
+    ///
+    /// @param body Body of the HTTP request.
+    /// @return Textual representation of the response.
+    std::string createResponse(const std::string& body) {
+        const std::string request_text =
+            "POST / HTTP/1.1\r\n"
+            "Content-Type: application/json\r\n"
+            "Content-Length: " + boost::lexical_cast<std::string>(body.size()) +
+            "\r\n\r\n" + body;
+
+        HttpRequestPtr request = creator_->createNewHttpRequest();
+        HttpRequestParser parser(*request);
+        parser.initModel();
+        parser.postBuffer(request_text.c_str(), request_text.size());
+        parser.poll();
+        EXPECT_TRUE(parser.httpParseOk());
+
+        // The response is created when the services have answered.
+        HttpResponsePtr response;
+        bool expired = false;
+        IntervalTimer timer(io_service_);
+        timer.setup(boost::bind(&CtrlAgentResponseCreatorTest::timeoutHandler,
+                                &expired), TEST_TIMEOUT,
+                    IntervalTimer::ONE_SHOT);
+        creator_->asyncCreateHttpResponse(request,
+                                          boost::bind(&CtrlAgentResponseCreatorTest::
+                                                      responseHandler,
+                                                      &response, _1));
+        while (!expired && !response) {
+            io_service_.run_one();
+        }
+        if (!response) {
+            ADD_FAILURE() << "no response created";
+            return ("");
+        }
+        return (response->toString());
+    }
+
+    /// @brief Handler storing the created response.
+    ///
+    /// @param [out] response Pointer to the stored response.
+    /// @param created Created response.
+    static void responseHandler(HttpResponsePtr* response,
+                                const HttpResponsePtr& created) {
+        *response = created;
+    }
+
+    /// @brief Callback invoked when the test timeout expires.
+    ///
+    /// @param expired Pointer to the flag set by the callback.
+    static void timeoutHandler(bool* expired) {
+        *expired = true;
+    }
+
+    /// @brief Returns the body of the response.
+    ///
+    /// @param response Textual representation of the response.
+    static std::string getBody(const std::string& response) {
+        const size_t pos = response.find("\r\n\r\n");
+        return (pos == std::string::npos ? "" : response.substr(pos + 4));
+    }
+
+    /// @brief IO service used by the forwarder.
+    IOService io_service_;
+
+    /// @brief Configuration manager.
+    CtrlAgentCfgMgrPtr cfg_mgr_;
+
+    /// @brief Command forwarder.
+    CtrlAgentCommandForwarderPtr forwarder_;
+
+    /// @brief Response creator factory.
+    CtrlAgentResponseCreatorFactory factory_;
+
+    /// @brief Response creator under test.
+    HttpResponseCreatorPtr creator_;
+};
+
+// Verifies that the factory returns the same creator for each connection
+// and that the creator expects JSON requests.
+TEST_F(CtrlAgentResponseCreatorTest, factory) {
+    EXPECT_TRUE(creator_ == factory_.create());
+    EXPECT_TRUE(boost::dynamic_pointer_cast<PostHttpRequestJson>
+                (creator_->createNewHttpRequest()));
+}
+
+// Verifies that the command is forwarded to the service and the answer
+// is returned in the response.
+TEST_F(CtrlAgentResponseCreatorTest, forwardCommand) {
+    TestControlServer server(TestControlServer::RESPOND, 1);
+
+    const std::string response =
+        createResponse("{ \"command\": \"list-commands\","
+                       "  \"service\": [ \"dhcp4\" ] }");
+    EXPECT_EQ(0, response.find("HTTP/1.1 200 OK"));
+    ConstElementPtr answers = Element::fromJSON(getBody(response));
+    ASSERT_EQ(Element::list, answers->getType());
+    ASSERT_EQ(1, answers->size());
+    EXPECT_EQ("{ \"result\": 0, \"text\": \"command 1\" }",
+              answers->get(0)->str());
+
+    forwarder_->closeAll();
+    server.wait();
+    EXPECT_EQ(1, server.getCommandsReceived());
+}
+
+// Verifies that an error answer is returned for the services without
+// control socket and for the unreachable services.
+TEST_F(CtrlAgentResponseCreatorTest, serviceErrors) {
+    const std::string response =
+        createResponse("{ \"command\": \"list-commands\","
+                       "  \"service\": [ \"dhcp6\", \"dhcp4\" ] }");
+    EXPECT_EQ(0, response.find("HTTP/1.1 200 OK"));
+    ConstElementPtr answers = Element::fromJSON(getBody(response));
+    ASSERT_EQ(Element::list, answers->getType());
+    ASSERT_EQ(2, answers->size());
+    for (int i = 0; i < 2; ++i) {
+        int rcode = 0;
+        parseAnswer(rcode, answers->get(i));
+        EXPECT_EQ(CONTROL_RESULT_ERROR, rcode);
+    }
+}
+
+// Verifies that the command is forwarded to all services at once and the
+// answers are returned in the order of the services.
+TEST_F(CtrlAgentResponseCreatorTest, multipleServices) {
+    TestControlServer server(TestControlServer::RESPOND, 1);
+
+    const std::string response =
+        createResponse("{ \"command\": \"list-commands\","
+                       "  \"service\": [ \"dhcp4\", \"dhcp6\", \"dhcp4\" ] }");
+    EXPECT_EQ(0, response.find("HTTP/1.1 200 OK"));
+    ConstElementPtr answers = Element::fromJSON(getBody(response));
+    ASSERT_EQ(Element::list, answers->getType());
+    ASSERT_EQ(3, answers->size());
+    EXPECT_EQ("{ \"result\": 0, \"text\": \"command 1\" }",
+              answers->get(0)->str());
+    int rcode = 0;
+    parseAnswer(rcode, answers->get(1));
+    EXPECT_EQ(CONTROL_RESULT_ERROR, rcode);
+    EXPECT_EQ("{ \"result\": 0, \"text\": \"command 2\" }",
+              answers->get(2)->str());
+
+    forwarder_->closeAll();
+    server.wait();
+    EXPECT_EQ(2, server.getCommandsReceived());
+}
+
+// Verifies that the request without command or service list is rejected.
+TEST_F(CtrlAgentResponseCreatorTest, badRequest) {
+    EXPECT_EQ(0, createResponse("{ \"service\": [ \"dhcp4\" ] }")
+              .find("HTTP/1.1 400 Bad Request"));
+    EXPECT_EQ(0, createResponse("{ \"command\": \"list-commands\" }")
+              .find("HTTP/1.1 400 Bad Request"));
+    EXPECT_EQ(0, createResponse("{ \"command\": \"list-commands\","
+                                "  \"service\": \"dhcp4\" }")
+              .find("HTTP/1.1 400 Bad Request"));
+}
+
+}
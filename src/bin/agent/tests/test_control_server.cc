@@ -0,0 +1,147 @@
+// Copyright (C) 2017 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <agent/tests/test_control_server.h>
+#include <exceptions/exceptions.h>
+#include <boost/bind.hpp>
+#include <boost/lexical_cast.hpp>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace isc::util::thread;
+
+namespace {
+
+/// @brief Time after which the server gives up waiting for an event (ms).
+const int SERVER_TIMEOUT = 5000;
+
+/// @brief Waits until the descriptor is readable.
+///
+/// @param fd Descriptor.
+/// @return true if the descriptor is readable, false on timeout or error.
+bool
+waitReadable(const int fd) {
+    struct pollfd pfd;
+    memset(&pfd, 0, sizeof(pfd));
+    pfd.fd = fd;
+    pfd.events = POLLIN;
+    return (poll(&pfd, 1, SERVER_TIMEOUT) > 0);
+}
+
+}
+
+namespace isc {
+namespace agent {
+namespace test {
+
+TestControlServer::TestControlServer(const Mode mode, const int connections)
+    : mode_(mode), connections_(connections),
+      socket_path_(defaultSocketPath()), listen_fd_(-1),
+      connections_accepted_(0), commands_received_(0), thread_() {
+    static_cast<void>(::remove(socket_path_.c_str()));
+
+    listen_fd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listen_fd_ < 0) {
+        isc_throw(isc::Unexpected, "failed to open test control socket");
+    }
+
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, socket_path_.c_str(), sizeof(addr.sun_path) - 1);
+    if ((bind(listen_fd_, reinterpret_cast<struct sockaddr*>(&addr),
+              sizeof(addr)) < 0) || (listen(listen_fd_, 1) < 0)) {
+        static_cast<void>(close(listen_fd_));
+        isc_throw(isc::Unexpected, "failed to bind test control socket "
+                  << socket_path_);
+    }
+
+    thread_.reset(new Thread(boost::bind(&TestControlServer::run, this)));
+}
+
+TestControlServer::~TestControlServer() {
+    wait();
+    static_cast<void>(close(listen_fd_));
+    static_cast<void>(::remove(socket_path_.c_str()));
+}
+
+std::string
+TestControlServer::defaultSocketPath() {
+    const char* env = getenv("KEA_SOCKET_TEST_DIR");
+    if (env) {
+        return (std::string(env) + "/test-ctrl-agent.sock");
+    }
+    return (std::string(TEST_DATA_BUILDDIR) + "/test-ctrl-agent.sock");
+}
+
+void
+TestControlServer::wait() {
+    if (thread_) {
+        thread_->wait();
+        thread_.reset();
+    }
+}
+
+void
+TestControlServer::run() {
+    for (int i = 0; i < connections_; ++i) {
+        if (!waitReadable(listen_fd_)) {
+            return;
+        }
+        int fd = accept(listen_fd_, NULL, NULL);
+        if (fd < 0) {
+            return;
+        }
+        ++connections_accepted_;
+        handleConnection(fd);
+        static_cast<void>(close(fd));
+    }
+}
+
+void
+TestControlServer::handleConnection(const int fd) {
+    char buf[65536];
+    for (;;) {
+        if (!waitReadable(fd)) {
+            return;
+        }
+        ssize_t len = recv(fd, buf, sizeof(buf), 0);
+        if (len <= 0) {
+            return;
+        }
+        ++commands_received_;
+
+        if (mode_ == NO_RESPONSE) {
+            continue;
+        }
+
+        const std::string response = "{ \"result\": 0, \"text\": \"command " +
+            boost::lexical_cast<std::string>(commands_received_) + "\" }";
+        if (mode_ == RESPOND_IN_CHUNKS) {
+            const size_t half = response.size() / 2;
+            static_cast<void>(send(fd, response.c_str(), half, 0));
+            usleep(50000);
+            static_cast<void>(send(fd, response.c_str() + half,
+                                   response.size() - half, 0));
+        } else {
+            static_cast<void>(send(fd, response.c_str(), response.size(), 0));
+        }
+
+        if (mode_ == RESPOND_AND_CLOSE) {
+            return;
+        }
+    }
+}
+
+} // namespace isc::agent::test
+} // namespace isc::agent
+} // namespace isc
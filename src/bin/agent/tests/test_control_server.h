@@ -0,0 +1,115 @@
+// Copyright (C) 2017 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef TEST_CONTROL_SERVER_H
+#define TEST_CONTROL_SERVER_H
+
+#include <util/threads/thread.h>
+#include <boost/noncopyable.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <string>
+
+namespace isc {
+namespace agent {
+namespace test {
+
+/// @brief Simple server listening on the UNIX control socket.
+///
+/// It mimics the control channel of the Kea servers: the command is read
+/// with a single read and the response is sent over the same connection,
+/// which is kept open until the client closes it. The server runs in a
+/// separate thread and exits when it has handled the specified number of
+/// connections or when nothing happens for a few seconds.
+class TestControlServer : public boost::noncopyable {
+public:
+
+    /// @brief Behavior of the server.
+    enum Mode {
+        /// Responds to each command.
+        RESPOND,
+        /// Closes the connection after sending the response.
+        RESPOND_AND_CLOSE,
+        /// Sends the response in two writes.
+        RESPOND_IN_CHUNKS,
+        /// Receives the commands but doesn't respond.
+        NO_RESPONSE
+    };
+
+    /// @brief Constructor.
+    ///
+    /// Opens the socket and starts the server thread.
+    ///
+    /// @param mode Behavior of the server.
+    /// @param connections Number of connections to handle.
+    TestControlServer(const Mode mode, const int connections);
+
+    /// @brief Destructor.
+    ///
+    /// Waits for the server thread and removes the socket.
+    ~TestControlServer();
+
+    /// @brief Returns the default path to the socket used in the tests.
+    static std::string defaultSocketPath();
+
+    /// @brief Returns the path to the socket.
+    const std::string& getSocketPath() const {
+        return (socket_path_);
+    }
+
+    /// @brief Waits for the server thread to finish.
+    void wait();
+
+    /// @brief Returns the number of accepted connections.
+    ///
+    /// Must be called after @c wait.
+    int getConnectionsAccepted() const {
+        return (connections_accepted_);
+    }
+
+    /// @brief Returns the number of received commands.
+    ///
+    /// Must be called after @c wait.
+    int getCommandsReceived() const {
+        return (commands_received_);
+    }
+
+private:
+
+    /// @brief Main function of the server thread.
+    void run();
+
+    /// @brief Handles a single connection.
+    ///
+    /// @param fd Descriptor of the accepted connection.
+    void handleConnection(const int fd);
+
+    /// @brief Behavior of the server.
+    Mode mode_;
+
+    /// @brief Number of connections to handle.
+    int connections_;
+
+    /// @brief Path to the socket.
+    std::string socket_path_;
+
+    /// @brief Descriptor of the listening socket.
+    int listen_fd_;
+
+    /// @brief Number of accepted connections.
+    int connections_accepted_;
+
+    /// @brief Number of received commands.
+    int commands_received_;
+
+    /// @brief Server thread.
+    boost::scoped_ptr<isc::util::thread::Thread> thread_;
+};
+
+} // namespace isc::agent::test
+} // namespace isc::agent
+} // namespace isc
+
+#endif
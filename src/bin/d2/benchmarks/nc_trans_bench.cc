@@ -0,0 +1,215 @@
+// Copyright (C) 2017 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/// @file nc_trans_bench.cc
+///
+/// Measures the overhead of the state model of the @c NameChangeTransaction:
+/// - starting a transaction, which builds its event and state dictionaries,
+/// - stepping a running transaction, i.e. resuming it with IO_COMPLETED_EVT
+///   as the DNS client callback does and running the state handlers until
+///   the transaction waits for the next IO.
+/// No DNS updates are sent, so as only the state model is measured. The
+/// number of transactions started and steps taken per second is printed.
+
+#include <config.h>
+#include <asiolink/io_service.h>
+#include <d2/d2_cfg_mgr.h>
+#include <d2/d2_config.h>
+#include <d2/nc_trans.h>
+#include <dhcp_ddns/ncr_msg.h>
+#include <boost/bind.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+using namespace isc;
+using namespace isc::d2;
+
+namespace {
+
+/// @brief Transaction which steps through its states without doing IO.
+///
+/// Each step resembles the processing of the DNS update response: the
+/// transaction goes from the state waiting for the IO to the server
+/// selection state and back to the update state, where it waits again.
+class SteppingTransaction : public NameChangeTransaction {
+public:
+
+    /// @brief State in which the transaction waits for the IO.
+    static const int UPDATING_ST = NCT_DERIVED_STATE_MIN + 1;
+
+    /// @brief Event posted to send the update.
+    static const int SEND_UPDATE_EVT = NCT_DERIVED_EVENT_MIN + 1;
+
+    /// @brief Constructor.
+    ///
+    /// Parameters match those needed by NameChangeTransaction.
+    SteppingTransaction(asiolink::IOServicePtr& io_service,
+                        dhcp_ddns::NameChangeRequestPtr& ncr,
+                        DdnsDomainPtr& forward_domain,
+                        DdnsDomainPtr& reverse_domain,
+                        D2CfgMgrPtr& cfg_mgr)
+        : NameChangeTransaction(io_service, ncr, forward_domain,
+                                reverse_domain, cfg_mgr) {
+    }
+
+    /// @brief Resumes the transaction as if the IO has completed.
+    void step() {
+        runModel(IO_COMPLETED_EVT);
+    }
+
+private:
+
+    /// @brief Handler for the READY_ST.
+    void readyHandler() {
+        transition(SELECTING_FWD_SERVER_ST, SELECT_SERVER_EVT);
+    }
+
+    /// @brief Handler for the SELECTING_FWD_SERVER_ST.
+    void selectingHandler() {
+        transition(UPDATING_ST, SEND_UPDATE_EVT);
+    }
+
+    /// @brief Handler for the UPDATING_ST.
+    ///
+    /// Waits for the IO after sending the update and selects the server
+    /// for the next update when the IO has completed.
+    void updatingHandler() {
+        if (getNextEvent() == SEND_UPDATE_EVT) {
+            postNextEvent(NOP_EVT);
+        } else {
+            transition(SELECTING_FWD_SERVER_ST, SELECT_SERVER_EVT);
+        }
+    }
+
+    /// @brief Handler for the final states.
+    void doneHandler() {
+        endModel();
+    }
+
+    /// @brief Adds the events of the transaction.
+    virtual void defineEvents() {
+        NameChangeTransaction::defineEvents();
+        defineEvent(SEND_UPDATE_EVT, "SEND_UPDATE_EVT");
+    }
+
+    /// @brief Verifies the events of the transaction.
+    virtual void verifyEvents() {
+        NameChangeTransaction::verifyEvents();
+        getEvent(SEND_UPDATE_EVT);
+    }
+
+    /// @brief Adds the states of the transaction.
+    virtual void defineStates() {
+        NameChangeTransaction::defineStates();
+        defineState(READY_ST, "READY_ST",
+                    boost::bind(&SteppingTransaction::readyHandler, this));
+        defineState(SELECTING_FWD_SERVER_ST, "SELECTING_FWD_SERVER_ST",
+                    boost::bind(&SteppingTransaction::selectingHandler, this));
+        defineState(SELECTING_REV_SERVER_ST, "SELECTING_REV_SERVER_ST",
+                    boost::bind(&SteppingTransaction::selectingHandler, this));
+        defineState(UPDATING_ST, "UPDATING_ST",
+                    boost::bind(&SteppingTransaction::updatingHandler, this));
+        defineState(PROCESS_TRANS_OK_ST, "PROCESS_TRANS_OK_ST",
+                    boost::bind(&SteppingTransaction::doneHandler, this));
+        defineState(PROCESS_TRANS_FAILED_ST, "PROCESS_TRANS_FAILED_ST",
+                    boost::bind(&SteppingTransaction::doneHandler, this));
+    }
+
+    /// @brief Verifies the states of the transaction.
+    virtual void verifyStates() {
+        NameChangeTransaction::verifyStates();
+        getState(UPDATING_ST);
+    }
+};
+
+/// @brief Pointer to the @c SteppingTransaction.
+typedef boost::shared_ptr<SteppingTransaction> SteppingTransactionPtr;
+
+/// @brief Creates the transaction for the forward change.
+SteppingTransactionPtr
+createTransaction(asiolink::IOServicePtr& io_service, D2CfgMgrPtr& cfg_mgr) {
+    dhcp_ddns::NameChangeRequestPtr ncr = dhcp_ddns::NameChangeRequest::fromJSON(
+        "{"
+        " \"change-type\" : 0 , "
+        " \"forward-change\" : true , "
+        " \"reverse-change\" : false , "
+        " \"fqdn\" : \"example.com.\" , "
+        " \"ip-address\" : \"192.168.2.1\" , "
+        " \"dhcid\" : \"0102030405060708\" , "
+        " \"lease-expires-on\" : \"20130121132405\" , "
+        " \"lease-length\" : 1300 "
+        "}");
+    DnsServerInfoStoragePtr servers(new DnsServerInfoStorage());
+    DdnsDomainPtr forward_domain(new DdnsDomain("example.com.", servers));
+    DdnsDomainPtr reverse_domain;
+
+    return (SteppingTransactionPtr(new SteppingTransaction(io_service, ncr,
+                                                           forward_domain,
+                                                           reverse_domain,
+                                                           cfg_mgr)));
+}
+
+/// @brief Prints the result of the benchmark.
+///
+/// @param name Name of the benchmark.
+/// @param count Number of operations done.
+/// @param start Time when the benchmark started.
+void
+report(const std::string& name, const size_t count,
+       const boost::posix_time::ptime& start) {
+    boost::posix_time::time_duration elapsed =
+        boost::posix_time::microsec_clock::universal_time() - start;
+    const double seconds = elapsed.total_microseconds() / 1000000.0;
+
+    std::cout << std::left << std::setw(8) << name << std::right
+              << std::setw(14) << std::fixed << std::setprecision(1)
+              << (seconds > 0 ? count / seconds : 0) << " per second"
+              << std::endl;
+}
+
+}
+
+int
+main() {
+    try {
+        asiolink::IOServicePtr io_service(new asiolink::IOService());
+        D2CfgMgrPtr cfg_mgr(new D2CfgMgr());
+
+        // Start the transactions, which builds their dictionaries.
+        const size_t transactions = 10000;
+        boost::posix_time::ptime start =
+            boost::posix_time::microsec_clock::universal_time();
+        for (size_t i = 0; i < transactions; ++i) {
+            createTransaction(io_service, cfg_mgr)->startTransaction();
+        }
+        report("start", transactions, start);
+
+        // Step the running transaction.
+        SteppingTransactionPtr trans = createTransaction(io_service, cfg_mgr);
+        trans->startTransaction();
+        const size_t steps = 5000000;
+        start = boost::posix_time::microsec_clock::universal_time();
+        for (size_t i = 0; i < steps; ++i) {
+            trans->step();
+        }
+        report("step", steps, start);
+
+        if (!trans->isModelWaiting()) {
+            std::cerr << "transaction is not running: "
+                      << trans->getContextStr() << std::endl;
+            return (EXIT_FAILURE);
+        }
+
+    } catch (const std::exception& ex) {
+        std::cerr << "benchmark failed: " << ex.what() << std::endl;
+        return (EXIT_FAILURE);
+    }
+
+    return (EXIT_SUCCESS);
+}
@@ -1,4 +1,4 @@
-// Copyright (C) 2014-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2014-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -289,10 +289,19 @@ D2CfgMgr::buildParams(isc::data::ConstElementPtr params_config) {
                   << strings->getPosition("ncr-format") << ")");
     }
 
+    // Fetch update batching parameters. Any values are valid.
+    uint32_t update_batch_size
+        = ints->getOptionalParam("update-batch-size",
+                                 D2Params::DFT_UPDATE_BATCH_SIZE);
+    uint32_t update_batch_window
+        = ints->getOptionalParam("update-batch-window",
+                                 D2Params::DFT_UPDATE_BATCH_WINDOW);
+
     // Attempt to create the new client config. This ought to fly as
     // we already validated everything.
     D2ParamsPtr params(new D2Params(ip_address, port, dns_server_timeout,
-                                    ncr_protocol, ncr_format));
+                                    ncr_protocol, ncr_format,
+                                    update_batch_size, update_batch_window));
 
     context->getD2Params() = params;
 }
@@ -306,7 +315,9 @@ D2CfgMgr::createConfigParser(const std::string& config_id,
     // Create parser instance based on element_id.
     isc::dhcp::ParserPtr parser;
     if ((config_id.compare("port") == 0) ||
-        (config_id.compare("dns-server-timeout") == 0)) {
+        (config_id.compare("dns-server-timeout") == 0) ||
+        (config_id.compare("update-batch-size") == 0) ||
+        (config_id.compare("update-batch-window") == 0)) {
         parser.reset(new isc::dhcp::Uint32Parser(config_id,
                                                  context->getUint32Storage()));
     } else if ((config_id.compare("ip-address") == 0) ||
@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -15,6 +15,7 @@
 #include <boost/foreach.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/scoped_ptr.hpp>
+#include <boost/algorithm/string/case_conv.hpp>
 #include <boost/algorithm/string/predicate.hpp>
 
 #include <sstream>
@@ -32,17 +33,23 @@ const size_t D2Params::DFT_PORT = 53001;
 const size_t D2Params::DFT_DNS_SERVER_TIMEOUT = 100;
 const char *D2Params::DFT_NCR_PROTOCOL = "UDP";
 const char *D2Params::DFT_NCR_FORMAT = "JSON";
+const size_t D2Params::DFT_UPDATE_BATCH_SIZE = 0;
+const size_t D2Params::DFT_UPDATE_BATCH_WINDOW = 10;
 
 D2Params::D2Params(const isc::asiolink::IOAddress& ip_address,
                    const size_t port,
                    const size_t dns_server_timeout,
                    const dhcp_ddns::NameChangeProtocol& ncr_protocol,
-                   const dhcp_ddns::NameChangeFormat& ncr_format)
+                   const dhcp_ddns::NameChangeFormat& ncr_format,
+                   const size_t update_batch_size,
+                   const size_t update_batch_window)
     : ip_address_(ip_address),
     port_(port),
     dns_server_timeout_(dns_server_timeout),
     ncr_protocol_(ncr_protocol),
-    ncr_format_(ncr_format) {
+    ncr_format_(ncr_format),
+    update_batch_size_(update_batch_size),
+    update_batch_window_(update_batch_window) {
     validateContents();
 }
 
@@ -51,7 +58,9 @@ D2Params::D2Params()
      port_(DFT_PORT),
      dns_server_timeout_(DFT_DNS_SERVER_TIMEOUT),
      ncr_protocol_(dhcp_ddns::NCR_UDP),
-     ncr_format_(dhcp_ddns::FMT_JSON) {
+     ncr_format_(dhcp_ddns::FMT_JSON),
+     update_batch_size_(DFT_UPDATE_BATCH_SIZE),
+     update_batch_window_(DFT_UPDATE_BATCH_WINDOW) {
     validateContents();
 }
 
@@ -100,7 +109,9 @@ D2Params::operator == (const D2Params& other) const {
             (port_ == other.port_) &&
             (dns_server_timeout_ == other.dns_server_timeout_) &&
             (ncr_protocol_ == other.ncr_protocol_) &&
-            (ncr_format_ == other.ncr_format_));
+            (ncr_format_ == other.ncr_format_) &&
+            (update_batch_size_ == other.update_batch_size_) &&
+            (update_batch_window_ == other.update_batch_window_));
 }
 
 bool
@@ -118,7 +129,9 @@ D2Params::toText() const {
            << ", ncr-protocol: "
            << dhcp_ddns::ncrProtocolToString(ncr_protocol_)
            << ", ncr-format: " << ncr_format_
-           << dhcp_ddns::ncrFormatToString(ncr_format_);
+           << dhcp_ddns::ncrFormatToString(ncr_format_)
+           << ", update-batch-size: " << update_batch_size_
+           << ", update-batch-window: " << update_batch_window_;
 
     return (stream.str());
 }
@@ -194,9 +207,9 @@ const char* DnsServerInfo::EMPTY_IP_STR = "0.0.0.0";
 
 DnsServerInfo::DnsServerInfo(const std::string& hostname,
                              isc::asiolink::IOAddress ip_address, uint32_t port,
-                             bool enabled)
+                             bool enabled, DNSClient::Protocol protocol)
     :hostname_(hostname), ip_address_(ip_address), port_(port),
-    enabled_(enabled) {
+    enabled_(enabled), protocol_(protocol) {
 }
 
 DnsServerInfo::~DnsServerInfo() {
@@ -265,6 +278,16 @@ DdnsDomainListMgr::setDomains(DdnsDomainMapPtr domains) {
     if (gotit != domains_->end()) {
             wildcard_domain_ = gotit->second;
     }
+
+    // Index the domains by their lower case names, so as the matching is
+    // case insensitive.  If the names differ only in case, the first one
+    // in the map wins.
+    domain_index_.clear();
+    DdnsDomainMapPair map_pair;
+    BOOST_FOREACH (map_pair, *domains_) {
+        domain_index_.insert(DdnsDomainIndex::value_type(
+            boost::algorithm::to_lower_copy(map_pair.first), map_pair.second));
+    }
 }
 
 bool
@@ -275,61 +298,36 @@ DdnsDomainListMgr::matchDomain(const std::string& fqdn, DdnsDomainPtr& domain) {
         return (true);
     }
 
-    // Iterate over the domain map looking for the domain which matches
-    // the longest portion of the given fqdn.
-
-    size_t req_len = fqdn.size();
-    size_t match_len = 0;
-    DdnsDomainMapPair map_pair;
-    DdnsDomainPtr best_match;
-    BOOST_FOREACH (map_pair, *domains_) {
-        std::string domain_name = map_pair.first;
-        size_t dom_len = domain_name.size();
-
-        // If the domain name is longer than the fqdn, then it cant be match.
-        if (req_len < dom_len) {
-            continue;
+    // Look up the fqdn and then each of its suffixes starting on a label
+    // boundary, from the longest to the shortest.  The first hit is the
+    // domain which matches the longest portion of the fqdn.  Starting only
+    // on the boundaries prevents "onetwo.net" from matching "two.net".
+    const std::string name = boost::algorithm::to_lower_copy(fqdn);
+    size_t offset = 0;
+    while (offset < name.size()) {
+        DdnsDomainIndex::const_iterator gotit =
+            domain_index_.find(offset == 0 ? name : name.substr(offset));
+        if (gotit != domain_index_.end()) {
+            domain = gotit->second;
+            return (true);
         }
 
-        // If the lengths are identical and the names match we're done.
-        if (req_len == dom_len) {
-            if (boost::iequals(fqdn, domain_name)) {
-                // exact match, done
-                domain = map_pair.second;
-                return (true);
-            }
-        } else {
-            // The fqdn is longer than the domain name.  Adjust the start
-            // point of comparison by the excess in length.  Only do the
-            // comparison if the adjustment lands on a boundary. This
-            // prevents "onetwo.net" from matching "two.net".
-            size_t offset = req_len - dom_len;
-            if ((fqdn[offset - 1] == '.')  &&
-               (boost::iequals(fqdn.substr(offset), domain_name))) {
-                // Fqdn contains domain name, keep it if its better than
-                // any we have matched so far.
-                if (dom_len > match_len) {
-                    match_len = dom_len;
-                    best_match = map_pair.second;
-                }
-            }
+        offset = name.find('.', offset);
+        if (offset == std::string::npos) {
+            break;
         }
+        ++offset;
     }
 
-    if (!best_match) {
-        // There's no match. If they specified a wild card domain use it
-        // otherwise there's no domain for this entry.
-        if (wildcard_domain_) {
-            domain = wildcard_domain_;
-            return (true);
-        }
-
-        LOG_WARN(dhcp_to_d2_logger, DHCP_DDNS_NO_MATCH).arg(fqdn);
-        return (false);
+    // There's no match. If they specified a wild card domain use it
+    // otherwise there's no domain for this entry.
+    if (wildcard_domain_) {
+        domain = wildcard_domain_;
+        return (true);
     }
 
-    domain = best_match;
-    return (true);
+    LOG_WARN(dhcp_to_d2_logger, DHCP_DDNS_NO_MATCH).arg(fqdn);
+    return (false);
 }
 
 // *************************** PARSERS ***********************************
@@ -576,6 +574,7 @@ DnsServerInfoParser::build(isc::data::ConstElementPtr server_config) {
     std::string hostname;
     std::string ip_address;
     uint32_t port = DnsServerInfo::STANDARD_DNS_PORT;
+    std::string protocol_str = "UDP";
     std::map<std::string, isc::data::Element::Position> pos;
 
     // Fetch the server configuration's parsed scalar values from parser's
@@ -586,6 +585,8 @@ DnsServerInfoParser::build(isc::data::ConstElementPtr server_config) {
                                                 DCfgContextBase::OPTIONAL);
     pos["port"] =  local_scalars_.getParam("port", port,
                                            DCfgContextBase::OPTIONAL);
+    pos["protocol"] = local_scalars_.getParam("protocol", protocol_str,
+                                              DCfgContextBase::OPTIONAL);
 
     // The configuration must specify one or the other.
     if (hostname.empty() == ip_address.empty()) {
@@ -600,6 +601,16 @@ DnsServerInfoParser::build(isc::data::ConstElementPtr server_config) {
                   << " (" << pos["port"] << ")");
     }
 
+    // Protocol must be either UDP or TCP.
+    DNSClient::Protocol protocol = DNSClient::UDP;
+    if (boost::iequals(protocol_str, "TCP")) {
+        protocol = DNSClient::TCP;
+    } else if (!boost::iequals(protocol_str, "UDP")) {
+        isc_throw(D2CfgError, "Dns Server : invalid protocol : "
+                  << protocol_str << ", must be UDP or TCP"
+                  << " (" << pos["protocol"] << ")");
+    }
+
     DnsServerInfoPtr serverInfo;
     if (!hostname.empty()) {
         /// @todo when resolvable hostname is supported we create the entry
@@ -623,7 +634,8 @@ DnsServerInfoParser::build(isc::data::ConstElementPtr server_config) {
             // Create an IOAddress from the IP address string given and then
             // create the DnsServerInfo.
             isc::asiolink::IOAddress io_addr(ip_address);
-            serverInfo.reset(new DnsServerInfo(hostname, io_addr, port));
+            serverInfo.reset(new DnsServerInfo(hostname, io_addr, port,
+                                               true, protocol));
         } catch (const isc::asiolink::IOError& ex) {
             isc_throw(D2CfgError, "Dns Server : invalid IP address : "
                       << ip_address << " (" << pos["ip-address"] << ")");
@@ -642,7 +654,8 @@ DnsServerInfoParser::createConfigParser(const std::string& config_id,
     // Based on the configuration id of the element, create the appropriate
     // parser. Scalars are set to use the parser's local scalar storage.
     if ((config_id == "hostname")  ||
-        (config_id == "ip-address")) {
+        (config_id == "ip-address") ||
+        (config_id == "protocol")) {
         parser = new isc::dhcp::StringParser(config_id,
                                              local_scalars_.getStringStorage());
     } else if (config_id == "port") {
@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -9,12 +9,14 @@
 
 #include <asiolink/io_service.h>
 #include <cc/data.h>
+#include <d2/dns_client.h>
 #include <dhcpsrv/parsers/dhcp_parsers.h>
 #include <dns/tsig.h>
 #include <exceptions/exceptions.h>
 #include <process/d_cfg_mgr.h>
 
 #include <boost/foreach.hpp>
+#include <boost/unordered_map.hpp>
 
 #include <stdint.h>
 #include <string>
@@ -149,6 +151,8 @@ public:
     static const size_t DFT_DNS_SERVER_TIMEOUT;
     static const char *DFT_NCR_PROTOCOL;
     static const char *DFT_NCR_FORMAT;
+    static const size_t DFT_UPDATE_BATCH_SIZE;
+    static const size_t DFT_UPDATE_BATCH_WINDOW;
     //@}
 
     /// @brief Constructor
@@ -159,6 +163,11 @@ public:
     /// wait for a response to a single DNS update request.
     /// @param ncr_protocol socket protocol D2 should use to receive NCRS
     /// @param ncr_format packet format of the inbound NCRs
+    /// @param update_batch_size maximum number of requests whose forward
+    /// updates are coalesced into a single DNS update. Values lower than 2
+    /// disable the coalescing.
+    /// @param update_batch_window maximum amount of time in milliseconds a
+    /// request may wait for other requests to coalesce with.
     ///
     /// @throw D2CfgError if:
     /// -# ip_address is 0.0.0.0 or ::
@@ -170,7 +179,9 @@ public:
                    const size_t port,
                    const size_t dns_server_timeout,
                    const dhcp_ddns::NameChangeProtocol& ncr_protocol,
-                   const dhcp_ddns::NameChangeFormat& ncr_format);
+                   const dhcp_ddns::NameChangeFormat& ncr_format,
+                   const size_t update_batch_size = DFT_UPDATE_BATCH_SIZE,
+                   const size_t update_batch_window = DFT_UPDATE_BATCH_WINDOW);
 
     /// @brief Default constructor
     /// The default constructor creates an instance that has updates disabled.
@@ -204,6 +215,18 @@ public:
         return(ncr_format_);
     }
 
+    /// @brief Return the maximum number of requests coalesced into a single
+    /// forward DNS update.
+    size_t getUpdateBatchSize() const {
+        return(update_batch_size_);
+    }
+
+    /// @brief Return the maximum time in milliseconds a request may wait
+    /// for other requests to coalesce with.
+    size_t getUpdateBatchWindow() const {
+        return(update_batch_window_);
+    }
+
     /// @brief Return summary of the configuration used by D2.
     ///
     /// The returned summary of the configuration is meant to be appended to
@@ -253,6 +276,14 @@ private:
     /// @brief Format of the inbound requests (NCRs).
     /// Currently only JSON format is supported.
     dhcp_ddns::NameChangeFormat ncr_format_;
+
+    /// @brief Maximum number of requests whose forward updates are
+    /// coalesced into a single DNS update.
+    size_t update_batch_size_;
+
+    /// @brief Maximum time in milliseconds a request may wait for other
+    /// requests to coalesce with.
+    size_t update_batch_window_;
 };
 
 /// @brief Dumps the contents of a D2Params as text to an output stream
@@ -444,10 +475,13 @@ public:
     /// the default.)
     /// @param enabled is a flag that indicates whether this server is
     /// enabled for use. It defaults to true.
+    /// @param protocol is the transport protocol used to send the updates to
+    /// the server. It defaults to UDP.
     DnsServerInfo(const std::string& hostname,
                   isc::asiolink::IOAddress ip_address,
                   uint32_t port = STANDARD_DNS_PORT,
-                  bool enabled=true);
+                  bool enabled=true,
+                  DNSClient::Protocol protocol = DNSClient::UDP);
 
     /// @brief Destructor
     virtual ~DnsServerInfo();
@@ -473,6 +507,13 @@ public:
         return (ip_address_);
     }
 
+    /// @brief Getter which returns the server's transport protocol.
+    ///
+    /// @return returns the protocol used to send the updates to the server.
+    DNSClient::Protocol getProtocol() const {
+        return (protocol_);
+    }
+
     /// @brief Convenience method which returns whether or not the
     /// server is enabled.
     ///
@@ -510,6 +551,9 @@ private:
     /// @param enabled is a flag that indicates whether this server is
     /// enabled for use. It defaults to true.
     bool enabled_;
+
+    /// @brief The transport protocol used to send the updates to the server.
+    DNSClient::Protocol protocol_;
 };
 
 std::ostream&
@@ -599,6 +643,9 @@ typedef std::pair<std::string, DdnsDomainPtr> DdnsDomainMapPair;
 /// @brief Defines a pointer to DdnsDomain storage containers.
 typedef boost::shared_ptr<DdnsDomainMap> DdnsDomainMapPtr;
 
+/// @brief Defines a hash of DdnsDomains, keyed by the lower case domain name.
+typedef boost::unordered_map<std::string, DdnsDomainPtr> DdnsDomainIndex;
+
 /// @brief Provides storage for and management of a list of DNS domains.
 /// In addition to housing the domain list storage, it provides domain matching
 /// services.  These services are used to match a FQDN to a domain.  Currently
@@ -632,6 +679,10 @@ public:
     /// match.  If the wild card domain is the only domain in the list, then
     /// it will be returned immediately for any FQDN.
     ///
+    /// The search uses the index of domain names built by @c setDomains, so
+    /// it takes one hash lookup per label of the FQDN regardless of the
+    /// number of configured domains.
+    ///
     /// @param fqdn is the name for which to look.
     /// @param domain receives the matching domain. If no match is found its
     /// contents will be unchanged.
@@ -674,7 +725,8 @@ public:
 
     /// @brief Sets the manger's domain list to the given list of domains.
     /// This method will scan the inbound list for the wild card domain and
-    /// set the internal wild card domain pointer accordingly.
+    /// set the internal wild card domain pointer accordingly.  It also
+    /// builds the index of the lower case domain names used for matching.
     void setDomains(DdnsDomainMapPtr domains);
 
 private:
@@ -686,6 +738,9 @@ private:
 
     /// @brief Pointer to the wild card domain.
     DdnsDomainPtr wildcard_domain_;
+
+    /// @brief Domains keyed by the lower case names, used for matching.
+    DdnsDomainIndex domain_index_;
 };
 
 /// @brief Defines a pointer for DdnsDomain instances.
@@ -886,6 +941,7 @@ public:
     /// -# hostname is not blank, hostname is not yet supported
     /// -# ip_address is invalid
     /// -# port is 0
+    /// -# protocol is neither "UDP" nor "TCP"
     virtual void build(isc::data::ConstElementPtr server_config);
 
     /// @brief Creates a parser for the given "dns-server" member element id.
@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2015 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -9,9 +9,12 @@
 #include <d2/d2_update_mgr.h>
 #include <d2/nc_add.h>
 #include <d2/nc_remove.h>
+#include <util/strutil.h>
 
+#include <algorithm>
 #include <sstream>
 #include <iostream>
+#include <set>
 #include <vector>
 
 namespace isc {
@@ -36,11 +39,18 @@ D2UpdateMgr::D2UpdateMgr(D2QueueMgrPtr& queue_mgr, D2CfgMgrPtr& cfg_mgr,
         isc_throw(D2UpdateMgrError, "IOServicePtr cannot be null");
     }
 
+    socket_pool_.reset(new DNSSocketPool(*io_service_));
+
     // Use setter to do validation.
     setMaxTransactions(max_transactions);
 }
 
 D2UpdateMgr::~D2UpdateMgr() {
+    if (batch_timer_) {
+        batch_timer_->cancel();
+    }
+
+    batch_list_.clear();
     transaction_list_.clear();
 }
 
@@ -89,6 +99,16 @@ D2UpdateMgr::checkFinishedTransactions() {
             ++it;
         }
     }
+
+    // Batches are done once they have started their transactions.
+    BatchList::iterator batch = batch_list_.begin();
+    while (batch != batch_list_.end()) {
+        if ((*batch)->isDone()) {
+            batch_list_.erase(batch++);
+        } else {
+            ++batch;
+        }
+    }
 }
 
 void D2UpdateMgr::pickNextJob() {
@@ -102,6 +122,10 @@ void D2UpdateMgr::pickNextJob() {
     for (size_t index = 0; index < queue_count; ++index) {
         dhcp_ddns::NameChangeRequestPtr found_ncr = queue_mgr_->peekAt(index);
         if (!hasTransaction(found_ncr->getDhcid())) {
+            if (makeBatch(index)) {
+                return;
+            }
+
             queue_mgr_->dequeueAt(index);
             makeTransaction(found_ncr);
             return;
@@ -114,8 +138,158 @@ void D2UpdateMgr::pickNextJob() {
               .arg(getQueueCount()).arg(getTransactionCount());
 }
 
+bool
+D2UpdateMgr::makeBatch(const size_t index) {
+    // Coalescing is enabled with a batch size of two or more. Never exceed
+    // the maximum number of transactions.
+    if (getTransactionCount() >= getMaxTransactions()) {
+        return (false);
+    }
+
+    D2ParamsPtr d2_params = cfg_mgr_->getD2Params();
+    size_t batch_size = std::min(d2_params->getUpdateBatchSize(),
+                                 getMaxTransactions() - getTransactionCount());
+    if (batch_size < 2) {
+        return (false);
+    }
+
+    dhcp_ddns::NameChangeRequestPtr first_ncr = queue_mgr_->peekAt(index);
+    DdnsDomainPtr forward_domain;
+    if (!isBatchable(first_ncr, forward_domain)) {
+        return (false);
+    }
+
+    // Gather the companions. Requests for the same client or FQDN as any
+    // skipped request, including those ahead of the first request, are
+    // skipped too, to keep them in order.
+    std::vector<size_t> indexes(1, index);
+    std::set<std::string> dhcids;
+    std::set<std::string> fqdns;
+    std::set<std::string> skipped_dhcids;
+    std::set<std::string> skipped_fqdns;
+    std::string first_fqdn = first_ncr->getFqdn();
+    util::str::lowercase(first_fqdn);
+    dhcids.insert(first_ncr->getDhcid().toStr());
+    fqdns.insert(first_fqdn);
+
+    size_t queue_count = getQueueCount();
+    for (size_t pos = 0;
+         (pos < queue_count) && (indexes.size() < batch_size); ++pos) {
+        if (pos == index) {
+            continue;
+        }
+
+        dhcp_ddns::NameChangeRequestPtr ncr = queue_mgr_->peekAt(pos);
+        std::string dhcid = ncr->getDhcid().toStr();
+        std::string fqdn = ncr->getFqdn();
+        util::str::lowercase(fqdn);
+        DdnsDomainPtr ncr_domain;
+        if ((pos < index) || (ncr->getChangeType() != first_ncr->getChangeType()) ||
+            dhcids.count(dhcid) || fqdns.count(fqdn) ||
+            skipped_dhcids.count(dhcid) || skipped_fqdns.count(fqdn) ||
+            hasTransaction(ncr->getDhcid()) ||
+            !isBatchable(ncr, ncr_domain) ||
+            (ncr_domain != forward_domain)) {
+            skipped_dhcids.insert(dhcid);
+            skipped_fqdns.insert(fqdn);
+            continue;
+        }
+
+        indexes.push_back(pos);
+        dhcids.insert(dhcid);
+        fqdns.insert(fqdn);
+    }
+
+    // If the batch isn't full, wait for more requests until the window of
+    // the first request expires.
+    if (indexes.size() < batch_size) {
+        boost::posix_time::ptime now =
+            boost::posix_time::microsec_clock::universal_time();
+        if (batch_wait_ncr_ != first_ncr) {
+            batch_wait_ncr_ = first_ncr;
+            batch_wait_start_ = now;
+        }
+
+        long elapsed = (now - batch_wait_start_).total_milliseconds();
+        long window = static_cast<long>(d2_params->getUpdateBatchWindow());
+        if (elapsed < window) {
+            // The timer's only purpose is to produce an IO event which
+            // returns the control to the upper layer calling sweep().
+            if (!batch_timer_) {
+                batch_timer_.reset(new asiolink::IntervalTimer(*io_service_));
+            }
+
+            batch_timer_->setup(&D2UpdateMgr::batchTimerExpired,
+                                window - elapsed,
+                                asiolink::IntervalTimer::ONE_SHOT);
+            return (true);
+        }
+    }
+
+    batch_wait_ncr_.reset();
+
+    // A single request is processed as usual.
+    if (indexes.size() < 2) {
+        return (false);
+    }
+
+    // Dequeue the requests, starting from the back of the queue so as the
+    // positions of the remaining ones are not affected.
+    std::vector<dhcp_ddns::NameChangeRequestPtr> ncrs;
+    for (size_t i = 0; i < indexes.size(); ++i) {
+        ncrs.push_back(queue_mgr_->peekAt(indexes[i]));
+    }
+
+    for (size_t i = indexes.size(); i > 0; --i) {
+        queue_mgr_->dequeueAt(indexes[i - 1]);
+    }
+
+    NameChangeBatchPtr batch(new NameChangeBatch(io_service_, forward_domain,
+                                                 cfg_mgr_, socket_pool_));
+    for (size_t i = 0; i < ncrs.size(); ++i) {
+        NameChangeTransactionPtr trans = createTransaction(ncrs[i]);
+        if (!trans) {
+            continue;
+        }
+
+        // The transaction is listed right away, so as no other request for
+        // the same DHCID is picked while the coalesced update is in progress.
+        transaction_list_[trans->getTransactionKey()] = trans;
+        if (trans->getForwardDomain() == forward_domain) {
+            batch->addTransaction(trans);
+        } else {
+            trans->startTransaction();
+        }
+    }
+
+    batch_list_.push_back(batch);
+    batch->start();
+    return (true);
+}
+
+bool
+D2UpdateMgr::isBatchable(const dhcp_ddns::NameChangeRequestPtr& ncr,
+                         DdnsDomainPtr& forward_domain) {
+    return (ncr->isForwardChange() && cfg_mgr_->forwardUpdatesEnabled() &&
+            cfg_mgr_->matchForward(ncr->getFqdn(), forward_domain));
+}
+
 void
 D2UpdateMgr::makeTransaction(dhcp_ddns::NameChangeRequestPtr& next_ncr) {
+    NameChangeTransactionPtr trans = createTransaction(next_ncr);
+    if (!trans) {
+        return;
+    }
+
+    // Add the new transaction to the list.
+    transaction_list_[trans->getTransactionKey()] = trans;
+
+    // Start it.
+    trans->startTransaction();
+}
+
+NameChangeTransactionPtr
+D2UpdateMgr::createTransaction(dhcp_ddns::NameChangeRequestPtr& next_ncr) {
     // First lets ensure there is not a transaction in progress for this
     // DHCID. (pickNextJob should ensure this, as it is the only real caller
     // but for safety's sake we'll check).
@@ -146,7 +320,7 @@ D2UpdateMgr::makeTransaction(dhcp_ddns::NameChangeRequestPtr& next_ncr) {
                 LOG_ERROR(dhcp_to_d2_logger, DHCP_DDNS_NO_FWD_MATCH_ERROR)
                           .arg(next_ncr->getRequestId())
                           .arg(next_ncr->toText());
-                return;
+                return (NameChangeTransactionPtr());
             }
 
             ++direction_count;
@@ -172,7 +346,7 @@ D2UpdateMgr::makeTransaction(dhcp_ddns::NameChangeRequestPtr& next_ncr) {
                 LOG_ERROR(dhcp_to_d2_logger, DHCP_DDNS_NO_REV_MATCH_ERROR)
                           .arg(next_ncr->getRequestId())
                           .arg(next_ncr->toText());
-                return;
+                return (NameChangeTransactionPtr());
             }
 
             ++direction_count;
@@ -186,7 +360,7 @@ D2UpdateMgr::makeTransaction(dhcp_ddns::NameChangeRequestPtr& next_ncr) {
                   DHCP_DDNS_REQUEST_DROPPED)
                   .arg(next_ncr->getRequestId())
                   .arg(next_ncr->toText());
-        return;
+        return (NameChangeTransactionPtr());
     }
 
     // We matched to the required servers, so construct the transaction.
@@ -205,11 +379,10 @@ D2UpdateMgr::makeTransaction(dhcp_ddns::NameChangeRequestPtr& next_ncr) {
                                               cfg_mgr_));
     }
 
-    // Add the new transaction to the list.
-    transaction_list_[key] = trans;
+    // Have the transaction send its updates through the shared sockets.
+    trans->setSocketPool(socket_pool_);
 
-    // Start it.
-    trans->startTransaction();
+    return (trans);
 }
 
 TransactionList::iterator
@@ -244,6 +417,7 @@ void
 D2UpdateMgr::clearTransactionList() {
     // @todo for now this just wipes them out. We might need something
     // more elegant, that allows a cancel first.
+    batch_list_.clear();
     transaction_list_.clear();
 }
 
@@ -275,6 +449,16 @@ D2UpdateMgr::getTransactionCount() const {
     return (transaction_list_.size());
 }
 
+size_t
+D2UpdateMgr::getBatchCount() const {
+    return (batch_list_.size());
+}
+
+void
+D2UpdateMgr::batchTimerExpired() {
+    // Nothing to do, sweep() will be invoked by the upper layer.
+}
+
 
 } // namespace isc::d2
 } // namespace isc
@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2015 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -9,15 +9,19 @@
 
 /// @file d2_update_mgr.h This file defines the class D2UpdateMgr.
 
+#include <asiolink/interval_timer.h>
 #include <asiolink/io_service.h>
 #include <exceptions/exceptions.h>
 #include <d2/d2_log.h>
 #include <d2/d2_queue_mgr.h>
 #include <d2/d2_cfg_mgr.h>
+#include <d2/nc_batch.h>
 #include <d2/nc_trans.h>
 
+#include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/noncopyable.hpp>
 #include <boost/shared_ptr.hpp>
+#include <list>
 #include <map>
 
 namespace isc {
@@ -33,6 +37,9 @@ public:
 /// @brief Defines a list of transactions.
 typedef std::map<TransactionKey, NameChangeTransactionPtr> TransactionList;
 
+/// @brief Defines a list of batches of transactions.
+typedef std::list<NameChangeBatchPtr> BatchList;
+
 /// @brief D2UpdateMgr creates and manages update transactions.
 ///
 /// D2UpdateMgr is the DHCP_DDNS task master, instantiating and then supervising
@@ -57,6 +64,15 @@ typedef std::map<TransactionKey, NameChangeTransactionPtr> TransactionList;
 /// transactions complete,  D2UpdateMgr removes them from the transaction list,
 /// replacing them with new transactions.
 ///
+/// If the update coalescing is enabled in the configuration (the
+/// update-batch-size parameter is greater than one), D2UpdateMgr gathers the
+/// queued requests of the same kind for distinct FQDNs in the same forward
+/// domain and carries out their initial forward updates with a single DNS
+/// update, see @ref NameChangeBatch.  If fewer requests than the batch size
+/// are queued, the first of them waits up to update-batch-window milliseconds
+/// for the others to arrive.  The requests are never reordered with respect
+/// to the requests for the same DHCID or FQDN.
+///
 /// D2UpdateMgr carries out each of the above steps, with a method called
 /// sweep().  This method is intended to be called as IO events complete.
 /// The upper layer(s) are responsible for calling sweep in a timely and cyclic
@@ -135,8 +151,41 @@ protected:
     /// It is possible that no such request exists, though this is likely to be
     /// rather rare unless a system is frequently seeing requests for the same
     /// clients in quick succession.
+    ///
+    /// If the update coalescing is enabled, the request is handed over to
+    /// @ref makeBatch first.
     void pickNextJob();
 
+    /// @brief Starts a batch of transactions for the request in the queue
+    /// and other requests it may be coalesced with.
+    ///
+    /// The companions of the request are searched in the rest of the queue.
+    /// They must ask for the same kind of change (an addition or removal) in
+    /// the same forward domain, and have distinct DHCIDs and FQDNs with no
+    /// transactions in progress.  A request is skipped if an earlier request
+    /// for its DHCID or FQDN is skipped, so as the requests for the same
+    /// client or name are carried out in order.
+    ///
+    /// If fewer requests than the batch size are found and the batching
+    /// window of the request hasn't expired, the method arms a timer to
+    /// return to the queue later and leaves the requests in it.
+    ///
+    /// @param index position of the request in the queue.
+    ///
+    /// @return true if the request has been dequeued or has to wait, false
+    /// if it should be processed on its own.
+    bool makeBatch(const size_t index);
+
+    /// @brief Checks if the request may be coalesced with others.
+    ///
+    /// @param ncr the request to check.
+    /// @param[out] forward_domain the forward domain matching the request.
+    ///
+    /// @return true if the request calls for a forward change which is
+    /// enabled and matches a forward domain, false otherwise.
+    bool isBatchable(const dhcp_ddns::NameChangeRequestPtr& ncr,
+                     DdnsDomainPtr& forward_domain);
+
     /// @brief Create a new transaction for the given request.
     ///
     /// This method will attempt to match the request to suitable DNS servers.
@@ -161,6 +210,22 @@ protected:
     /// exists. Note this would be programmatic error.
     void makeTransaction(isc::dhcp_ddns::NameChangeRequestPtr& ncr);
 
+    /// @brief Creates a new transaction for the given request.
+    ///
+    /// Matches the request to the DNS servers, as described in
+    /// @ref makeTransaction, and instantiates the transaction without adding
+    /// it to the transaction list or starting it.
+    ///
+    /// @param ncr the NameChangeRequest for which to create a transaction.
+    ///
+    /// @return Pointer to the new transaction or an empty pointer if the
+    /// request has been discarded.
+    ///
+    /// @throw D2UpdateMgrError if a transaction for this DHCID already
+    /// exists.
+    NameChangeTransactionPtr
+    createTransaction(isc::dhcp_ddns::NameChangeRequestPtr& ncr);
+
 public:
     /// @brief Gets the D2UpdateMgr's IOService.
     ///
@@ -169,6 +234,13 @@ public:
         return (io_service_);
     }
 
+    /// @brief Gets the pool of sockets shared by the transactions.
+    ///
+    /// @return returns a reference to the socket pool
+    const DNSSocketPoolPtr& getSocketPool() {
+        return (socket_pool_);
+    }
+
     /// @brief Returns the maximum number of concurrent transactions.
     size_t getMaxTransactions() const {
         return (max_transactions_);
@@ -225,7 +297,17 @@ public:
     /// @brief Returns the current number of transactions.
     size_t getTransactionCount() const;
 
+    /// @brief Returns the number of batches whose coalesced update is
+    /// in progress.
+    size_t getBatchCount() const;
+
 private:
+    /// @brief Invoked when the wait for the requests to coalesce with ends.
+    ///
+    /// The method does nothing. The expiration of the timer is an IO event
+    /// after which the upper layer calls @ref sweep.
+    static void batchTimerExpired();
+
     /// @brief Pointer to the queue manager.
     D2QueueMgrPtr queue_mgr_;
 
@@ -245,6 +327,23 @@ private:
 
     /// @brief List of transactions.
     TransactionList transaction_list_;
+
+    /// @brief List of batches whose coalesced update is in progress.
+    BatchList batch_list_;
+
+    /// @brief Timer which ends the wait for the requests to coalesce with.
+    asiolink::IntervalTimerPtr batch_timer_;
+
+    /// @brief The request waiting for the requests to coalesce with.
+    dhcp_ddns::NameChangeRequestPtr batch_wait_ncr_;
+
+    /// @brief The time at which the request started to wait.
+    boost::posix_time::ptime batch_wait_start_;
+
+    /// @brief Pool of sockets shared by the transactions.
+    /// The transactions send their DNS updates through the long-lived
+    /// sockets of this pool rather than opening a socket for each update.
+    DNSSocketPoolPtr socket_pool_;
 };
 
 /// @brief Defines a pointer to a D2UpdateMgr instance.
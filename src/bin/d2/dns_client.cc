@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2015 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -29,8 +29,9 @@ using namespace isc::dns;
 
 // This class provides the implementation for the DNSClient. This allows for
 // the separation of the DNSClient interface from the implementation details.
-// Currently, implementation uses IOFetch object to handle asynchronous
-// communication with the DNS. This design may be revisited in the future. If
+// The implementation uses either the IOFetch object or the DNSSocketPool,
+// if one was supplied, to handle asynchronous communication with the DNS.
+// Both report the completion through the IOFetch::Callback interface. If
 // implementation is changed, the DNSClient API will remain unchanged thanks
 // to this separation.
 class DNSClientImpl : public asiodns::IOFetch::Callback {
@@ -55,11 +56,21 @@ public:
     DNSClient::Protocol proto_;
     // TSIG context used to sign outbound and verify inbound messages.
     dns::TSIGContextPtr tsig_context_;
+    // A pool of sockets used for the exchanges. If null, IOFetch is used.
+    DNSSocketPoolPtr socket_pool_;
+    // A buffer holding the request sent through the socket pool. It is
+    // reused across the exchanges.
+    util::OutputBufferPtr out_buf_;
+    // An identifier of the exchange in progress in the socket pool.
+    DNSSocketPool::ExchangeId exchange_id_;
+    // Indicates if the exchange is in progress in the socket pool.
+    bool exchange_pending_;
 
     // Constructor and Destructor
     DNSClientImpl(D2UpdateMessagePtr& response_placeholder,
                   DNSClient::Callback* callback,
-                  const DNSClient::Protocol proto);
+                  const DNSClient::Protocol proto,
+                  const DNSSocketPoolPtr& socket_pool);
     virtual ~DNSClientImpl();
 
     // This internal callback is called when the DNS update message exchange is
@@ -78,13 +89,19 @@ public:
 
     // This function maps the IO error to the DNSClient error.
     DNSClient::Status getStatus(const asiodns::IOFetch::Result);
+
+    // This function maps the DNSClient protocol to the IOFetch protocol.
+    asiodns::IOFetch::Protocol getFetchProtocol() const;
 };
 
 DNSClientImpl::DNSClientImpl(D2UpdateMessagePtr& response_placeholder,
                              DNSClient::Callback* callback,
-                             const DNSClient::Protocol proto)
+                             const DNSClient::Protocol proto,
+                             const DNSSocketPoolPtr& socket_pool)
     : in_buf_(new OutputBuffer(DEFAULT_BUFFER_SIZE)),
-      response_(response_placeholder), callback_(callback), proto_(proto) {
+      response_(response_placeholder), callback_(callback), proto_(proto),
+      socket_pool_(socket_pool), out_buf_(new OutputBuffer(DEFAULT_BUFFER_SIZE)),
+      exchange_id_(0), exchange_pending_(false) {
 
     // Response should be an empty pointer. It gets populated by the
     // operator() method.
@@ -92,17 +109,6 @@ DNSClientImpl::DNSClientImpl(D2UpdateMessagePtr& response_placeholder,
         isc_throw(isc::BadValue, "Response buffer pointer should be null");
     }
 
-    // @todo Currently we only support UDP. The support for TCP is planned for
-    // the future release.
-    if (proto_ == DNSClient::TCP) {
-        isc_throw(isc::NotImplemented, "TCP is currently not supported as a"
-                  << " Transport protocol for DNS Updates; please use UDP");
-    }
-
-    // Given that we already eliminated the possibility that TCP is used, it
-    // would be sufficient  to check that (proto != DNSClient::UDP). But, once
-    // support TCP is added the check above will disappear and the extra check
-    // will be needed here anyway.
     // Note that cascaded check is used here instead of:
     //   if (proto_ != DNSClient::TCP && proto_ != DNSClient::UDP)..
     // because some versions of GCC compiler complain that check above would
@@ -118,10 +124,17 @@ DNSClientImpl::DNSClientImpl(D2UpdateMessagePtr& response_placeholder,
 }
 
 DNSClientImpl::~DNSClientImpl() {
+    // The socket pool outlives this object, so make sure it doesn't invoke
+    // this object when the exchange completes.
+    if (exchange_pending_) {
+        socket_pool_->cancel(exchange_id_);
+    }
 }
 
 void
 DNSClientImpl::operator()(asiodns::IOFetch::Result result) {
+    exchange_pending_ = false;
+
     // Get the status from IO. If no success, we just call user's callback
     // and pass the status code.
     DNSClient::Status status = getStatus(result);
@@ -174,6 +187,12 @@ DNSClientImpl::getStatus(const asiodns::IOFetch::Result result) {
     }
     return (DNSClient::OTHER);
 }
+
+IOFetch::Protocol
+DNSClientImpl::getFetchProtocol() const {
+    return (proto_ == DNSClient::TCP ? IOFetch::TCP : IOFetch::UDP);
+}
+
 void
 DNSClientImpl::doUpdate(asiolink::IOService& io_service,
                         const IOAddress& ns_addr,
@@ -204,24 +223,42 @@ DNSClientImpl::doUpdate(asiolink::IOService& io_service,
     // renders data by default. However, this buffer can't be directly accessed.
     // Fortunately, the renderer's API accepts user-supplied buffers. So, let's
     // create our own buffer and pass it to the renderer so as the message is
-    // rendered to this buffer. Finally, we pass this buffer to IOFetch.
+    // rendered to this buffer. Finally, we pass this buffer to IOFetch or to
+    // the socket pool. The buffer used with the socket pool is reused unless
+    // the previous exchange is still in progress.
+    if (socket_pool_ && exchange_pending_) {
+        socket_pool_->cancel(exchange_id_);
+        exchange_pending_ = false;
+        out_buf_.reset(new OutputBuffer(DEFAULT_BUFFER_SIZE));
+    }
     dns::MessageRenderer renderer;
-    OutputBufferPtr msg_buf(new OutputBuffer(DEFAULT_BUFFER_SIZE));
+    OutputBufferPtr msg_buf = socket_pool_ ? out_buf_ :
+        OutputBufferPtr(new OutputBuffer(DEFAULT_BUFFER_SIZE));
+    msg_buf->clear();
     renderer.setBuffer(msg_buf.get());
 
     // Render DNS Update message. This may throw a bunch of exceptions if
     // invalid message object is given.
     update.toWire(renderer, tsig_context_.get());
 
+    // Timeout value is explicitly cast to the int type to avoid warnings about
+    // overflows when doing implicit cast. It should have been checked by the
+    // caller that the unsigned timeout value will fit into int.
+    if (socket_pool_) {
+        // The socket pool posts the exchange to its own IO service. As a
+        // result operator()(Status) will be called.
+        exchange_id_ = socket_pool_->send(ns_addr, ns_port, msg_buf, in_buf_,
+                                          this, static_cast<int>(wait),
+                                          getFetchProtocol());
+        exchange_pending_ = true;
+        return;
+    }
+
     // IOFetch has all the mechanisms that we need to perform asynchronous
     // communication with the DNS server. The last but one argument points to
     // this object as a completion callback for the message exchange. As a
     // result operator()(Status) will be called.
-
-    // Timeout value is explicitly cast to the int type to avoid warnings about
-    // overflows when doing implicit cast. It should have been checked by the
-    // caller that the unsigned timeout value will fit into int.
-    IOFetch io_fetch(IOFetch::UDP, io_service, msg_buf, ns_addr, ns_port,
+    IOFetch io_fetch(getFetchProtocol(), io_service, msg_buf, ns_addr, ns_port,
                      in_buf_, this, static_cast<int>(wait));
 
     // Post the task to the task queue in the IO service. Caller will actually
@@ -230,8 +267,10 @@ DNSClientImpl::doUpdate(asiolink::IOService& io_service,
 }
 
 DNSClient::DNSClient(D2UpdateMessagePtr& response_placeholder,
-                     Callback* callback, const DNSClient::Protocol proto)
-    : impl_(new DNSClientImpl(response_placeholder, callback, proto)) {
+                     Callback* callback, const DNSClient::Protocol proto,
+                     const DNSSocketPoolPtr& socket_pool)
+    : impl_(new DNSClientImpl(response_placeholder, callback, proto,
+                              socket_pool)) {
 }
 
 DNSClient::~DNSClient() {
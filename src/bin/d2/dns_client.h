@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2015 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -8,6 +8,7 @@
 #define DNS_CLIENT_H
 
 #include <d2/d2_update_message.h>
+#include <d2/dns_socket_pool.h>
 
 #include <asiolink/io_service.h>
 #include <util/buffer.h>
@@ -39,13 +40,20 @@ class DNSClientImpl;
 /// encapsulate DNS response, through class constructor. An exception will be
 /// thrown if the pointer is not initialized by the caller.
 ///
-/// @todo Ultimately, this class will support both TCP and UDP Transport.
-/// Currently only UDP is supported and can be specified as a preferred
-/// protocol. @c DNSClient constructor will throw an exception if TCP is
-/// specified. Once both protocols are supported, the @c DNSClient logic will
-/// try to obey caller's preference. However, it may use the other protocol if
-/// on its own discretion, when there is a legitimate reason to do so. For
-/// example, if communication with the server using preferred protocol fails.
+/// By default, each message exchange is carried out by a new
+/// @c asiodns::IOFetch, which opens a new socket.  If the @c DNSSocketPool
+/// is supplied through the constructor, the exchanges are carried out
+/// through the long-lived sockets of the pool instead.
+///
+/// The message exchanges may use either UDP or TCP as specified through the
+/// constructor.  When TCP is used with the @c DNSSocketPool, the exchanges
+/// with the same server share a persistent connection, over which the
+/// messages are pipelined.  Otherwise a new connection is established for
+/// each exchange.
+///
+/// @todo The @c DNSClient may use the other protocol on its own discretion,
+/// when there is a legitimate reason to do so, e.g. when the response
+/// received over UDP is truncated.
 class DNSClient {
 public:
 
@@ -92,8 +100,11 @@ public:
     /// if an error occurs. NULL value disables callback invocation.
     /// @param proto caller's preference regarding Transport layer protocol to
     /// be used by DNS Client to communicate with a server.
+    /// @param socket_pool Pool of sockets used for the message exchanges. If
+    /// null, a new @c asiodns::IOFetch is used for each exchange.
     DNSClient(D2UpdateMessagePtr& response_placeholder, Callback* callback,
-              const Protocol proto = UDP);
+              const Protocol proto = UDP,
+              const DNSSocketPoolPtr& socket_pool = DNSSocketPoolPtr());
 
     /// @brief Virtual destructor, does nothing.
     ~DNSClient();
@@ -132,6 +143,8 @@ public:
     /// initiate multiple message exchanges.
     ///
     /// @param io_service IO service to be used to run the message exchange.
+    /// It is ignored if the socket pool is in use, in which case the exchange
+    /// is run by the IO service of the pool.
     /// @param ns_addr DNS server address.
     /// @param ns_port DNS server port.
     /// @param update A DNS Update message to be sent to the server.
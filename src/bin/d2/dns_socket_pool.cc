@@ -0,0 +1,987 @@
+// Copyright (C) 2017 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <asiolink/asio_wrapper.h>
+#include <d2/d2_log.h>
+#include <d2/dns_socket_pool.h>
+#include <util/io_utilities.h>
+#include <util/random/qid_gen.h>
+
+#include <boost/asio/deadline_timer.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/ip/udp.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/bind.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/enable_shared_from_this.hpp>
+
+#include <deque>
+#include <limits>
+
+using namespace isc::asiodns;
+using namespace isc::asiolink;
+using namespace isc::util;
+
+namespace isc {
+namespace d2 {
+
+/// @brief Base class of the channels used by the DNS exchanges with a
+/// single server.
+///
+/// It holds the pending exchanges by query IDs along with their timers and
+/// delivers the responses to them.  The derived classes implement the
+/// transport.
+///
+/// The channel is always held by a shared pointer, which is also bound to
+/// each of its completion handlers.  This keeps the channel alive until all
+/// of its asynchronous operations complete, even if the pool is destroyed
+/// in the meantime.
+class DNSChannel : public boost::enable_shared_from_this<DNSChannel>,
+                   public boost::noncopyable {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// @param io_service IO service used to run the exchanges.
+    /// @param ns_addr DNS server address.
+    /// @param ns_port DNS server port.
+    DNSChannel(IOService& io_service, const IOAddress& ns_addr,
+               const uint16_t ns_port)
+        : io_service_(io_service),
+          server_address_(boost::asio::ip::address::from_string(
+                              ns_addr.toText())),
+          server_port_(ns_port), pending_(), closed_(false) {
+    }
+
+    /// @brief Virtual destructor.
+    virtual ~DNSChannel() {
+    }
+
+    /// @brief Returns the number of pending exchanges.
+    size_t getPendingNum() const {
+        return (pending_.size());
+    }
+
+    /// @brief Checks if an exchange with the query ID is pending.
+    ///
+    /// @param qid Query ID.
+    bool isPending(const uint16_t qid) const {
+        return (pending_.count(qid) > 0);
+    }
+
+    /// @brief Starts the exchange.
+    ///
+    /// @param exchange_id Identifier of the exchange.
+    /// @param qid Query ID already written in the message.
+    /// @param msg_buf Rendered DNS message.
+    /// @param response_buf Buffer receiving the response.
+    /// @param callback Callback invoked when the exchange completes.
+    /// @param wait Timeout in milliseconds for the response.
+    void send(const DNSSocketPool::ExchangeId exchange_id, const uint16_t qid,
+              const OutputBufferPtr& msg_buf,
+              const OutputBufferPtr& response_buf,
+              IOFetch::Callback* callback, const int wait) {
+        Exchange& exchange = pending_[qid];
+        exchange.id_ = exchange_id;
+        exchange.response_buf_ = response_buf;
+        exchange.callback_ = callback;
+        exchange.timer_.reset(new boost::asio::deadline_timer(
+                                  io_service_.get_io_service()));
+        exchange.timer_->expires_from_now(boost::posix_time::milliseconds(wait));
+        exchange.timer_->async_wait(boost::bind(&DNSChannel::timeoutExpired,
+                                                shared_from_this(),
+                                                exchange_id, qid, _1));
+
+        // Like the IOFetch, post the send to the IO service, so as the
+        // message is sent when the caller runs the IO service.
+        io_service_.post(boost::bind(&DNSChannel::postedSend,
+                                     shared_from_this(), exchange_id, qid,
+                                     msg_buf));
+    }
+
+    /// @brief Cancels the exchange without invoking its callback.
+    ///
+    /// @param exchange_id Identifier of the exchange.
+    ///
+    /// @return true if the exchange was pending on this channel.
+    bool cancel(const DNSSocketPool::ExchangeId exchange_id) {
+        for (ExchangeMap::iterator it = pending_.begin(); it != pending_.end();
+             ++it) {
+            if (it->second.id_ == exchange_id) {
+                cancelTimer(it->second);
+                pending_.erase(it);
+                exchangeRemoved();
+                return (true);
+            }
+        }
+        return (false);
+    }
+
+    /// @brief Closes the channel and drops all pending exchanges.
+    virtual void close() {
+        closed_ = true;
+        for (ExchangeMap::iterator it = pending_.begin(); it != pending_.end();
+             ++it) {
+            cancelTimer(it->second);
+        }
+        pending_.clear();
+    }
+
+protected:
+
+    /// @brief Pending exchange.
+    struct Exchange {
+        /// @brief Constructor.
+        Exchange()
+            : id_(0), response_buf_(), callback_(NULL), timer_(),
+              sent_(false) {
+        }
+
+        /// @brief Identifier of the exchange.
+        DNSSocketPool::ExchangeId id_;
+
+        /// @brief Buffer receiving the response.
+        OutputBufferPtr response_buf_;
+
+        /// @brief Callback invoked when the exchange completes.
+        IOFetch::Callback* callback_;
+
+        /// @brief Timer measuring the timeout of the exchange.
+        boost::shared_ptr<boost::asio::deadline_timer> timer_;
+
+        /// @brief Indicates if the message has been handed to the transport.
+        bool sent_;
+    };
+
+    /// @brief Defines a map of the pending exchanges by query IDs.
+    typedef std::map<uint16_t, Exchange> ExchangeMap;
+
+    /// @brief Returns the pointer to this channel cast to the derived type.
+    ///
+    /// @tparam ChannelType Type of the derived channel.
+    template<typename ChannelType>
+    boost::shared_ptr<ChannelType> self() {
+        return (boost::static_pointer_cast<ChannelType>(shared_from_this()));
+    }
+
+    /// @brief Finds the pending exchange.
+    ///
+    /// @param exchange_id Identifier of the exchange.
+    /// @param qid Query ID.
+    ///
+    /// @return Iterator pointing to the exchange or to the end of the map
+    /// if the exchange is no longer pending.
+    ExchangeMap::iterator findExchange(const DNSSocketPool::ExchangeId
+                                       exchange_id, const uint16_t qid) {
+        ExchangeMap::iterator it = pending_.find(qid);
+        if ((it != pending_.end()) && (it->second.id_ != exchange_id)) {
+            return (pending_.end());
+        }
+        return (it);
+    }
+
+    /// @brief Sends the message of the exchange.
+    ///
+    /// Invoked from the IO service for the exchanges which haven't been
+    /// canceled since they were started.
+    ///
+    /// @param exchange_id Identifier of the exchange.
+    /// @param qid Query ID.
+    /// @param msg_buf Rendered DNS message.
+    virtual void startSend(const DNSSocketPool::ExchangeId exchange_id,
+                           const uint16_t qid,
+                           const OutputBufferPtr& msg_buf) = 0;
+
+    /// @brief Invoked when an exchange is removed from the pending ones.
+    virtual void exchangeRemoved() {
+    }
+
+    /// @brief Completes the exchange and invokes its callback.
+    ///
+    /// The exchange is removed before the callback is invoked, so as the
+    /// callback may start a new exchange.
+    ///
+    /// @param it Iterator pointing to the exchange.
+    /// @param result Result of the exchange.
+    void complete(ExchangeMap::iterator it, const IOFetch::Result result) {
+        Exchange exchange = it->second;
+        pending_.erase(it);
+        cancelTimer(exchange);
+        exchangeRemoved();
+        if (exchange.callback_) {
+            (*exchange.callback_)(result);
+        }
+    }
+
+    /// @brief Delivers the response to the pending exchange having its
+    /// query ID.  The response for no pending exchange is dropped.
+    ///
+    /// @param data Received message.
+    /// @param length Length of the received message.
+    void deliver(const uint8_t* data, const size_t length) {
+        if (length < sizeof(uint16_t)) {
+            return;
+        }
+        ExchangeMap::iterator it = pending_.find(readUint16(data, length));
+        if (it != pending_.end()) {
+            it->second.response_buf_->clear();
+            it->second.response_buf_->writeData(data, length);
+            complete(it, IOFetch::SUCCESS);
+        }
+    }
+
+    /// @brief Completes the exchange after a transport failure.
+    ///
+    /// @param exchange_id Identifier of the exchange.
+    /// @param qid Query ID.
+    /// @param ec Error code.
+    void fail(const DNSSocketPool::ExchangeId exchange_id, const uint16_t qid,
+              const boost::system::error_code& ec) {
+        ExchangeMap::iterator it = findExchange(exchange_id, qid);
+        if (it != pending_.end()) {
+            LOG_DEBUG(d2_to_dns_logger, DBGLVL_TRACE_DETAIL,
+                      DHCP_DDNS_SOCKET_POOL_SEND_FAILED)
+                .arg(server_address_.to_string()).arg(ec.message());
+            complete(it, IOFetch::NOTSET);
+        }
+    }
+
+    /// @brief IO service used to run the exchanges.
+    IOService& io_service_;
+
+    /// @brief Address of the server.
+    boost::asio::ip::address server_address_;
+
+    /// @brief Port of the server.
+    uint16_t server_port_;
+
+    /// @brief Pending exchanges.
+    ExchangeMap pending_;
+
+    /// @brief Indicates if the channel has been closed.
+    bool closed_;
+
+private:
+
+    /// @brief Cancels the timer of the exchange.
+    ///
+    /// @param exchange Exchange.
+    static void cancelTimer(Exchange& exchange) {
+        if (exchange.timer_) {
+            boost::system::error_code ec;
+            exchange.timer_->cancel(ec);
+        }
+    }
+
+    /// @brief Handler of the posted send.
+    ///
+    /// @param exchange_id Identifier of the exchange.
+    /// @param qid Query ID.
+    /// @param msg_buf Rendered DNS message.
+    void postedSend(const DNSSocketPool::ExchangeId exchange_id,
+                    const uint16_t qid, const OutputBufferPtr& msg_buf) {
+        if (!closed_ && (findExchange(exchange_id, qid) != pending_.end())) {
+            startSend(exchange_id, qid, msg_buf);
+        }
+    }
+
+    /// @brief Handler invoked when the timeout of the exchange expires.
+    ///
+    /// @param exchange_id Identifier of the exchange.
+    /// @param qid Query ID.
+    /// @param ec Error code.
+    void timeoutExpired(const DNSSocketPool::ExchangeId exchange_id,
+                        const uint16_t qid,
+                        const boost::system::error_code& ec) {
+        if ((ec == boost::asio::error::operation_aborted) || closed_) {
+            return;
+        }
+        ExchangeMap::iterator it = findExchange(exchange_id, qid);
+        if (it != pending_.end()) {
+            complete(it, IOFetch::TIME_OUT);
+        }
+    }
+};
+
+/// @brief UDP socket shared by the DNS exchanges with a single server.
+///
+/// The channel has an outstanding receive only when it has pending
+/// exchanges.
+class DNSUDPChannel : public DNSChannel {
+public:
+
+    /// @brief Maximum size of the received message.
+    static const size_t MAX_MESSAGE_SIZE = 65535;
+
+    /// @brief Constructor.
+    ///
+    /// Opens the socket.  The local port is assigned on the first send.
+    ///
+    /// @param io_service IO service used to run the exchanges.
+    /// @param ns_addr DNS server address.
+    /// @param ns_port DNS server port.
+    ///
+    /// @throw DNSSocketPoolError if the socket can't be opened.
+    DNSUDPChannel(IOService& io_service, const IOAddress& ns_addr,
+                  const uint16_t ns_port)
+        : DNSChannel(io_service, ns_addr, ns_port),
+          socket_(io_service.get_io_service()),
+          server_(server_address_, server_port_), sender_(),
+          buffer_(MAX_MESSAGE_SIZE), receiving_(false) {
+        boost::system::error_code ec;
+        socket_.open(server_.protocol(), ec);
+        if (ec) {
+            isc_throw(DNSSocketPoolError, "failed to open the socket for the"
+                      " DNS server " << ns_addr << " port " << ns_port
+                      << ": " << ec.message());
+        }
+    }
+
+    /// @brief Destructor.
+    virtual ~DNSUDPChannel() {
+        close();
+    }
+
+    /// @brief Closes the socket and drops all pending exchanges.
+    virtual void close() {
+        DNSChannel::close();
+        boost::system::error_code ec;
+        socket_.close(ec);
+    }
+
+protected:
+
+    /// @brief Sends the message to the server.
+    ///
+    /// @param exchange_id Identifier of the exchange.
+    /// @param qid Query ID.
+    /// @param msg_buf Rendered DNS message.
+    virtual void startSend(const DNSSocketPool::ExchangeId exchange_id,
+                           const uint16_t qid,
+                           const OutputBufferPtr& msg_buf) {
+        // The message buffer is bound to the handler so as it outlives the
+        // send, even if the exchange is canceled before the send completes.
+        socket_.async_send_to(boost::asio::buffer(msg_buf->getData(),
+                                                  msg_buf->getLength()),
+                              server_,
+                              boost::bind(&DNSUDPChannel::sendCompleted,
+                                          self<DNSUDPChannel>(), exchange_id,
+                                          qid, msg_buf, _1));
+        startReceive();
+    }
+
+    /// @brief Cancels the outstanding receive if there is no pending
+    /// exchange.
+    virtual void exchangeRemoved() {
+        if (pending_.empty() && receiving_) {
+            boost::system::error_code ec;
+            socket_.cancel(ec);
+        }
+    }
+
+private:
+
+    /// @brief Starts receiving unless the receive is already outstanding.
+    void startReceive() {
+        if (receiving_ || closed_) {
+            return;
+        }
+        receiving_ = true;
+        socket_.async_receive_from(boost::asio::buffer(&buffer_[0],
+                                                       buffer_.size()),
+                                   sender_,
+                                   boost::bind(&DNSUDPChannel::receiveCompleted,
+                                               self<DNSUDPChannel>(), _1, _2));
+    }
+
+    /// @brief Handler invoked when the send completes.
+    ///
+    /// @param exchange_id Identifier of the exchange.
+    /// @param qid Query ID.
+    /// @param msg_buf Sent message, unused.
+    /// @param ec Error code.
+    void sendCompleted(const DNSSocketPool::ExchangeId exchange_id,
+                       const uint16_t qid, const OutputBufferPtr&,
+                       const boost::system::error_code& ec) {
+        if (ec && !closed_) {
+            fail(exchange_id, qid, ec);
+        }
+    }
+
+    /// @brief Handler invoked when a message is received.
+    ///
+    /// The message is delivered to the pending exchange if it comes from
+    /// the server.  Other messages are dropped.
+    ///
+    /// @param ec Error code.
+    /// @param length Length of the received message.
+    void receiveCompleted(const boost::system::error_code& ec,
+                          const size_t length) {
+        receiving_ = false;
+        if (closed_) {
+            return;
+        }
+
+        if (!ec && (sender_ == server_)) {
+            deliver(&buffer_[0], length);
+        }
+
+        // Keep receiving while there are pending exchanges, including
+        // those started since the receive was canceled.
+        if (!pending_.empty()) {
+            startReceive();
+        }
+    }
+
+    /// @brief Socket used to communicate with the server.
+    boost::asio::ip::udp::socket socket_;
+
+    /// @brief Endpoint of the server.
+    boost::asio::ip::udp::endpoint server_;
+
+    /// @brief Endpoint from which the last message was received.
+    boost::asio::ip::udp::endpoint sender_;
+
+    /// @brief Buffer receiving the messages.
+    std::vector<uint8_t> buffer_;
+
+    /// @brief Indicates if the receive is outstanding.
+    bool receiving_;
+};
+
+/// @brief Persistent TCP connection shared by the DNS exchanges with a
+/// single server.
+///
+/// The connection is established when the first message is to be sent and
+/// the messages of the subsequent exchanges are pipelined over it, one
+/// write at a time, as described in RFC 7766.  The responses may arrive
+/// in any order and are matched to the exchanges by the query ID.  The
+/// connection is closed when it has been idle for the configured time.
+///
+/// When the connection fails, the exchanges whose messages have already
+/// been written fail, as it is unknown whether the server has processed
+/// them, and the connection is established again for the remaining ones.
+/// If the connection can't be established, all pending exchanges fail.
+/// The failed exchanges are reported with the @c IOFetch::NOTSET result.
+class DNSTCPChannel : public DNSChannel {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// @param io_service IO service used to run the exchanges.
+    /// @param ns_addr DNS server address.
+    /// @param ns_port DNS server port.
+    /// @param idle_timeout Time in milliseconds after which the idle
+    /// connection is closed.
+    DNSTCPChannel(IOService& io_service, const IOAddress& ns_addr,
+                  const uint16_t ns_port, const long idle_timeout)
+        : DNSChannel(io_service, ns_addr, ns_port),
+          socket_(io_service.get_io_service()),
+          idle_timer_(io_service.get_io_service()),
+          idle_timeout_(idle_timeout), state_(CLOSED), generation_(0),
+          write_queue_(), writing_(false), buffer_() {
+    }
+
+    /// @brief Destructor.
+    virtual ~DNSTCPChannel() {
+        close();
+    }
+
+    /// @brief Closes the connection and drops all pending exchanges.
+    virtual void close() {
+        DNSChannel::close();
+        write_queue_.clear();
+        closeConnection();
+    }
+
+    /// @brief Checks if the connection is established.
+    bool isConnected() const {
+        return (state_ == CONNECTED);
+    }
+
+protected:
+
+    /// @brief Queues the message, establishing the connection if needed.
+    ///
+    /// @param exchange_id Identifier of the exchange.
+    /// @param qid Query ID.
+    /// @param msg_buf Rendered DNS message.
+    virtual void startSend(const DNSSocketPool::ExchangeId exchange_id,
+                           const uint16_t qid,
+                           const OutputBufferPtr& msg_buf) {
+        boost::system::error_code ec;
+        idle_timer_.cancel(ec);
+
+        write_queue_.push_back(QueuedMessage(exchange_id, qid, msg_buf));
+        if (state_ == CLOSED) {
+            connect();
+        } else if (state_ == CONNECTED) {
+            startWrite();
+        }
+    }
+
+    /// @brief Starts the idle timer if there is no pending exchange.
+    virtual void exchangeRemoved() {
+        startIdleTimer();
+    }
+
+private:
+
+    /// @brief State of the connection.
+    enum State {
+        CLOSED,
+        CONNECTING,
+        CONNECTED
+    };
+
+    /// @brief Message waiting to be written to the connection.
+    struct QueuedMessage {
+        /// @brief Constructor.
+        ///
+        /// @param exchange_id Identifier of the exchange.
+        /// @param qid Query ID.
+        /// @param msg_buf Rendered DNS message.
+        QueuedMessage(const DNSSocketPool::ExchangeId exchange_id,
+                      const uint16_t qid, const OutputBufferPtr& msg_buf)
+            : exchange_id_(exchange_id), qid_(qid), msg_buf_(msg_buf) {
+            writeUint16(static_cast<uint16_t>(msg_buf->getLength()),
+                        length_, sizeof(length_));
+        }
+
+        /// @brief Identifier of the exchange.
+        DNSSocketPool::ExchangeId exchange_id_;
+
+        /// @brief Query ID.
+        uint16_t qid_;
+
+        /// @brief Rendered DNS message.
+        OutputBufferPtr msg_buf_;
+
+        /// @brief Length of the message preceding it on the connection.
+        uint8_t length_[2];
+    };
+
+    /// @brief Starts the idle timer if the connection is established and
+    /// there is no pending exchange.
+    void startIdleTimer() {
+        if (pending_.empty() && (state_ == CONNECTED) && !closed_) {
+            idle_timer_.expires_from_now(boost::posix_time::milliseconds(
+                                             idle_timeout_));
+            idle_timer_.async_wait(boost::bind(&DNSTCPChannel::idleExpired,
+                                               self<DNSTCPChannel>(),
+                                               generation_, _1));
+        }
+    }
+
+    /// @brief Starts establishing the connection.
+    void connect() {
+        state_ = CONNECTING;
+        ++generation_;
+        boost::asio::ip::tcp::endpoint server(server_address_, server_port_);
+        socket_.async_connect(server,
+                              boost::bind(&DNSTCPChannel::connectCompleted,
+                                          self<DNSTCPChannel>(), generation_,
+                                          _1));
+    }
+
+    /// @brief Closes the connection.
+    ///
+    /// The queued messages are kept.
+    void closeConnection() {
+        boost::system::error_code ec;
+        idle_timer_.cancel(ec);
+        socket_.close(ec);
+        state_ = CLOSED;
+        writing_ = false;
+        ++generation_;
+    }
+
+    /// @brief Handles the failure of the connection.
+    ///
+    /// Closes the connection, fails the exchanges whose messages have been
+    /// written and establishes the connection again for the remaining
+    /// messages.  If the connection couldn't be established, fails all
+    /// pending exchanges.
+    ///
+    /// @param ec Error code.
+    /// @param connect_failed Indicates if the connection couldn't be
+    /// established.
+    void connectionFailed(const boost::system::error_code& ec,
+                          const bool connect_failed) {
+        closeConnection();
+
+        // The callbacks may start new exchanges, so collect the failed
+        // exchanges before invoking them.
+        std::vector<std::pair<DNSSocketPool::ExchangeId, uint16_t> > failed;
+        for (ExchangeMap::const_iterator it = pending_.begin();
+             it != pending_.end(); ++it) {
+            if (connect_failed || it->second.sent_) {
+                failed.push_back(std::make_pair(it->second.id_, it->first));
+            }
+        }
+        if (connect_failed) {
+            write_queue_.clear();
+        }
+        for (size_t i = 0; i < failed.size(); ++i) {
+            fail(failed[i].first, failed[i].second, ec);
+        }
+
+        if (!closed_ && (state_ == CLOSED) && !write_queue_.empty()) {
+            connect();
+        }
+    }
+
+    /// @brief Handler invoked when the connection is established.
+    ///
+    /// @param generation Generation of the connection.
+    /// @param ec Error code.
+    void connectCompleted(const uint64_t generation,
+                          const boost::system::error_code& ec) {
+        if (closed_ || (generation != generation_)) {
+            return;
+        }
+        if (ec) {
+            LOG_DEBUG(d2_to_dns_logger, DBGLVL_TRACE_DETAIL,
+                      DHCP_DDNS_SOCKET_POOL_CONNECT_FAILED)
+                .arg(server_address_.to_string()).arg(server_port_)
+                .arg(ec.message());
+            connectionFailed(ec, true);
+            return;
+        }
+        state_ = CONNECTED;
+        startRead();
+        startWrite();
+
+        // All exchanges may have been canceled in the meantime.
+        startIdleTimer();
+    }
+
+    /// @brief Writes the next queued message unless a write is in progress.
+    void startWrite() {
+        // The front message is being written, so it must stay in the queue
+        // until the write completes, even if its exchange has been canceled.
+        if (writing_) {
+            return;
+        }
+
+        // Skip the messages of the exchanges canceled in the meantime.
+        while (!write_queue_.empty() &&
+               (findExchange(write_queue_.front().exchange_id_,
+                             write_queue_.front().qid_) == pending_.end())) {
+            write_queue_.pop_front();
+        }
+        if (write_queue_.empty()) {
+            return;
+        }
+
+        QueuedMessage& msg = write_queue_.front();
+        pending_[msg.qid_].sent_ = true;
+        writing_ = true;
+
+        std::vector<boost::asio::const_buffer> buffers;
+        buffers.push_back(boost::asio::buffer(msg.length_, sizeof(msg.length_)));
+        buffers.push_back(boost::asio::buffer(msg.msg_buf_->getData(),
+                                              msg.msg_buf_->getLength()));
+        boost::asio::async_write(socket_, buffers,
+                                 boost::bind(&DNSTCPChannel::writeCompleted,
+                                             self<DNSTCPChannel>(),
+                                             generation_, msg.msg_buf_, _1));
+    }
+
+    /// @brief Handler invoked when the message has been written.
+    ///
+    /// @param generation Generation of the connection.
+    /// @param msg_buf Written message, unused.
+    /// @param ec Error code.
+    void writeCompleted(const uint64_t generation, const OutputBufferPtr&,
+                        const boost::system::error_code& ec) {
+        if (closed_ || (generation != generation_)) {
+            return;
+        }
+        writing_ = false;
+        if (ec) {
+            connectionFailed(ec, false);
+            return;
+        }
+        write_queue_.pop_front();
+        startWrite();
+    }
+
+    /// @brief Starts reading the length of the next message.
+    void startRead() {
+        boost::asio::async_read(socket_,
+                                boost::asio::buffer(length_, sizeof(length_)),
+                                boost::bind(&DNSTCPChannel::lengthRead,
+                                            self<DNSTCPChannel>(),
+                                            generation_, _1));
+    }
+
+    /// @brief Handler invoked when the length of the message has been read.
+    ///
+    /// @param generation Generation of the connection.
+    /// @param ec Error code.
+    void lengthRead(const uint64_t generation,
+                    const boost::system::error_code& ec) {
+        if (closed_ || (generation != generation_)) {
+            return;
+        }
+        if (ec) {
+            readFailed(ec);
+            return;
+        }
+        buffer_.resize(readUint16(length_, sizeof(length_)));
+        if (buffer_.empty()) {
+            startRead();
+            return;
+        }
+        boost::asio::async_read(socket_,
+                                boost::asio::buffer(&buffer_[0],
+                                                    buffer_.size()),
+                                boost::bind(&DNSTCPChannel::messageRead,
+                                            self<DNSTCPChannel>(),
+                                            generation_, _1));
+    }
+
+    /// @brief Handler invoked when the message has been read.
+    ///
+    /// @param generation Generation of the connection.
+    /// @param ec Error code.
+    void messageRead(const uint64_t generation,
+                     const boost::system::error_code& ec) {
+        if (closed_ || (generation != generation_)) {
+            return;
+        }
+        if (ec) {
+            readFailed(ec);
+            return;
+        }
+        deliver(&buffer_[0], buffer_.size());
+
+        // The callback may have closed the connection.
+        if (!closed_ && (generation == generation_)) {
+            startRead();
+        }
+    }
+
+    /// @brief Handles the failure to read from the connection.
+    ///
+    /// The server closing the idle connection is not reported.
+    ///
+    /// @param ec Error code.
+    void readFailed(const boost::system::error_code& ec) {
+        if (!pending_.empty()) {
+            LOG_DEBUG(d2_to_dns_logger, DBGLVL_TRACE_DETAIL,
+                      DHCP_DDNS_SOCKET_POOL_CONNECTION_LOST)
+                .arg(server_address_.to_string()).arg(server_port_)
+                .arg(ec.message());
+        }
+        connectionFailed(ec, false);
+    }
+
+    /// @brief Handler invoked when the idle timer expires.
+    ///
+    /// @param generation Generation of the connection.
+    /// @param ec Error code.
+    void idleExpired(const uint64_t generation,
+                     const boost::system::error_code& ec) {
+        if ((ec == boost::asio::error::operation_aborted) || closed_ ||
+            (generation != generation_)) {
+            return;
+        }
+        // The queued messages, if any, belong to the canceled exchanges.
+        if (pending_.empty()) {
+            write_queue_.clear();
+            closeConnection();
+        }
+    }
+
+    /// @brief Socket used to communicate with the server.
+    boost::asio::ip::tcp::socket socket_;
+
+    /// @brief Timer closing the idle connection.
+    boost::asio::deadline_timer idle_timer_;
+
+    /// @brief Time in milliseconds after which the idle connection is
+    /// closed.
+    long idle_timeout_;
+
+    /// @brief State of the connection.
+    State state_;
+
+    /// @brief Generation of the connection, incremented when the connection
+    /// is being established or closed.  The handlers compare it with the
+    /// generation they were started for and do nothing if they differ.
+    uint64_t generation_;
+
+    /// @brief Messages waiting to be written.  The front message is being
+    /// written if the write is in progress.
+    std::deque<QueuedMessage> write_queue_;
+
+    /// @brief Indicates if the write is in progress.
+    bool writing_;
+
+    /// @brief Buffer receiving the length of the message.
+    uint8_t length_[2];
+
+    /// @brief Buffer receiving the message.
+    std::vector<uint8_t> buffer_;
+};
+
+const size_t DNSUDPChannel::MAX_MESSAGE_SIZE;
+
+const size_t DNSSocketPool::DEFAULT_SOCKETS_PER_SERVER;
+const long DNSSocketPool::DEFAULT_TCP_IDLE_TIMEOUT;
+
+DNSSocketPool::DNSSocketPool(IOService& io_service,
+                             const size_t sockets_per_server,
+                             const long tcp_idle_timeout)
+    : io_service_(io_service), sockets_per_server_(sockets_per_server),
+      tcp_idle_timeout_(tcp_idle_timeout), channels_(), next_exchange_id_(1) {
+    if (sockets_per_server_ == 0) {
+        isc_throw(DNSSocketPoolError, "number of sockets per DNS server"
+                  " must be greater than 0");
+    }
+
+    if (tcp_idle_timeout_ < 0) {
+        isc_throw(DNSSocketPoolError, "idle timeout of the TCP connections"
+                  " must not be negative");
+    }
+}
+
+DNSSocketPool::~DNSSocketPool() {
+    for (ChannelMap::iterator server = channels_.begin();
+         server != channels_.end(); ++server) {
+        for (size_t i = 0; i < server->second.size(); ++i) {
+            server->second[i]->close();
+        }
+    }
+}
+
+DNSSocketPool::ExchangeId
+DNSSocketPool::send(const IOAddress& ns_addr, const uint16_t ns_port,
+                    const OutputBufferPtr& msg_buf,
+                    const OutputBufferPtr& response_buf,
+                    IOFetch::Callback* callback, const int wait,
+                    const IOFetch::Protocol protocol) {
+    if (!msg_buf || (msg_buf->getLength() < sizeof(uint16_t))) {
+        isc_throw(DNSSocketPoolError, "DNS message to be sent to "
+                  << ns_addr << " is too short");
+    }
+
+    if ((protocol == IOFetch::TCP) &&
+        (msg_buf->getLength() > std::numeric_limits<uint16_t>::max())) {
+        isc_throw(DNSSocketPoolError, "DNS message to be sent to "
+                  << ns_addr << " is too long");
+    }
+
+    if (!response_buf) {
+        isc_throw(DNSSocketPoolError, "response buffer must not be null");
+    }
+
+    DNSChannelPtr channel = getChannel(ns_addr, ns_port, protocol);
+    if (channel->getPendingNum() > std::numeric_limits<uint16_t>::max()) {
+        isc_throw(DNSSocketPoolError, "too many pending exchanges with "
+                  << ns_addr);
+    }
+
+    // Pick a query ID which doesn't collide with the other exchanges
+    // pending on the channel.
+    uint16_t qid;
+    do {
+        qid = random::QidGenerator::getInstance().generateQid();
+    } while (channel->isPending(qid));
+    msg_buf->writeUint16At(qid, 0);
+
+    const ExchangeId exchange_id = next_exchange_id_++;
+    channel->send(exchange_id, qid, msg_buf, response_buf, callback, wait);
+    return (exchange_id);
+}
+
+void
+DNSSocketPool::cancel(const ExchangeId exchange_id) {
+    for (ChannelMap::iterator server = channels_.begin();
+         server != channels_.end(); ++server) {
+        for (size_t i = 0; i < server->second.size(); ++i) {
+            if (server->second[i]->cancel(exchange_id)) {
+                return;
+            }
+        }
+    }
+}
+
+size_t
+DNSSocketPool::getPendingNum() const {
+    size_t pending_num = 0;
+    for (ChannelMap::const_iterator server = channels_.begin();
+         server != channels_.end(); ++server) {
+        for (size_t i = 0; i < server->second.size(); ++i) {
+            pending_num += server->second[i]->getPendingNum();
+        }
+    }
+    return (pending_num);
+}
+
+size_t
+DNSSocketPool::getSocketsNum(const IOAddress& ns_addr,
+                             const uint16_t ns_port,
+                             const IOFetch::Protocol protocol) const {
+    ChannelMap::const_iterator server =
+        channels_.find(ServerKey(std::make_pair(ns_addr, ns_port), protocol));
+    return (server != channels_.end() ? server->second.size() : 0);
+}
+
+bool
+DNSSocketPool::isConnected(const IOAddress& ns_addr,
+                           const uint16_t ns_port) const {
+    ChannelMap::const_iterator server =
+        channels_.find(ServerKey(std::make_pair(ns_addr, ns_port), IOFetch::TCP));
+    if ((server == channels_.end()) || server->second.empty()) {
+        return (false);
+    }
+    return (boost::static_pointer_cast<DNSTCPChannel>
+            (server->second[0])->isConnected());
+}
+
+DNSChannelPtr
+DNSSocketPool::getChannel(const IOAddress& ns_addr, const uint16_t ns_port,
+                          const IOFetch::Protocol protocol) {
+    std::vector<DNSChannelPtr>& channels =
+        channels_[ServerKey(std::make_pair(ns_addr, ns_port), protocol)];
+
+    // The exchanges over TCP are pipelined over a single connection.
+    if (protocol == IOFetch::TCP) {
+        if (channels.empty()) {
+            channels.push_back(DNSChannelPtr(new DNSTCPChannel(io_service_,
+                                                               ns_addr,
+                                                               ns_port,
+                                                               tcp_idle_timeout_)));
+        }
+        return (channels[0]);
+    }
+
+    // Use the least busy channel, opening a new one if all are busy and
+    // the limit hasn't been reached.
+    DNSChannelPtr channel;
+    for (size_t i = 0; i < channels.size(); ++i) {
+        if (!channel ||
+            (channels[i]->getPendingNum() < channel->getPendingNum())) {
+            channel = channels[i];
+        }
+    }
+
+    if (!channel || ((channel->getPendingNum() > 0) &&
+                     (channels.size() < sockets_per_server_))) {
+        channel.reset(new DNSUDPChannel(io_service_, ns_addr, ns_port));
+        channels.push_back(channel);
+    }
+    return (channel);
+}
+
+} // namespace d2
+} // namespace isc
@@ -0,0 +1,204 @@
+// Copyright (C) 2017 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef DNS_SOCKET_POOL_H
+#define DNS_SOCKET_POOL_H
+
+#include <asiodns/io_fetch.h>
+#include <asiolink/io_address.h>
+#include <asiolink/io_service.h>
+#include <exceptions/exceptions.h>
+#include <util/buffer.h>
+
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace isc {
+namespace d2 {
+
+/// @brief Thrown if the DNS socket pool encounters a general error.
+class DNSSocketPoolError : public isc::Exception {
+public:
+    DNSSocketPoolError(const char* file, size_t line, const char* what) :
+        isc::Exception(file, line, what) { };
+};
+
+/// @brief Socket or connection shared by the DNS exchanges with a single
+/// server.
+///
+/// The class is defined in the implementation file.
+class DNSChannel;
+
+/// @brief Defines a pointer to a @c DNSChannel.
+typedef boost::shared_ptr<DNSChannel> DNSChannelPtr;
+
+/// @brief Pool of long-lived sockets used for the DNS exchanges.
+///
+/// Sending each DNS update through a new @c asiodns::IOFetch opens a new
+/// socket and allocates the endpoints and buffers for each exchange, which
+/// costs system calls and ephemeral ports when the rate of updates is high.
+/// The pool instead keeps up to a configured number of open UDP sockets
+/// (channels) per DNS server and sends the updates to that server through
+/// them.  Multiple exchanges may be in progress on a channel at the same
+/// time.  Each exchange is assigned a query ID which is unique among the
+/// exchanges pending on its channel, and the responses are matched to the
+/// pending exchanges by the query ID and the address of the server.  Each
+/// exchange has its own timer.  The receive buffer of each channel is
+/// reused across the exchanges.
+///
+/// Like the @c asiodns::IOFetch, the pool overwrites the query ID in the
+/// rendered message, which doesn't invalidate the TSIG signature as it
+/// carries the original ID.  The completion of the exchange is reported
+/// through the @c asiodns::IOFetch::Callback, so the callers may handle the
+/// results in the same way as those of the @c asiodns::IOFetch.
+///
+/// A channel has an outstanding receive only when it has pending exchanges,
+/// so the idle channels have no handlers queued in the IO service.
+///
+/// The exchanges over TCP use a single persistent connection per DNS
+/// server, over which the messages are pipelined as described in RFC 7766.
+/// The connection is established when needed and closed after it has been
+/// idle for the configured time.  If the connection fails, the exchanges
+/// whose messages have already been written fail and the connection is
+/// established again for the remaining exchanges.
+class DNSSocketPool : public boost::noncopyable {
+public:
+
+    /// @brief Identifier of the exchange returned by @c send.
+    typedef uint64_t ExchangeId;
+
+    /// @brief Default maximum number of sockets per DNS server.
+    static const size_t DEFAULT_SOCKETS_PER_SERVER = 4;
+
+    /// @brief Default time in milliseconds after which the idle TCP
+    /// connection is closed.
+    static const long DEFAULT_TCP_IDLE_TIMEOUT = 30000;
+
+    /// @brief Constructor.
+    ///
+    /// @param io_service IO service used to run the exchanges.
+    /// @param sockets_per_server Maximum number of UDP sockets opened for
+    /// a single DNS server.
+    /// @param tcp_idle_timeout Time in milliseconds after which the idle
+    /// TCP connection is closed.
+    ///
+    /// @throw DNSSocketPoolError if the number of sockets is 0 or the
+    /// timeout is negative.
+    DNSSocketPool(asiolink::IOService& io_service,
+                  const size_t sockets_per_server = DEFAULT_SOCKETS_PER_SERVER,
+                  const long tcp_idle_timeout = DEFAULT_TCP_IDLE_TIMEOUT);
+
+    /// @brief Destructor.
+    ///
+    /// Closes all sockets and connections.  The callbacks of the pending exchanges are not
+    /// invoked.
+    ~DNSSocketPool();
+
+    /// @brief Starts asynchronous exchange with a DNS server.
+    ///
+    /// Selects the socket for the server, writes the query ID at the
+    /// beginning of the message and posts sending it to the IO service, like
+    /// the @c asiodns::IOFetch does.  The callback is
+    /// invoked from the IO service when the response is received, the
+    /// timeout occurs or the send fails, never from within this method.
+    ///
+    /// @param ns_addr DNS server address.
+    /// @param ns_port DNS server port.
+    /// @param msg_buf Rendered DNS message.  The buffer must not be modified
+    /// until the exchange completes or is canceled.
+    /// @param response_buf Buffer receiving the response.
+    /// @param callback Callback invoked when the exchange completes.
+    /// @param wait Timeout in milliseconds for the response.
+    /// @param protocol Transport protocol used for the exchange.
+    ///
+    /// @return Identifier of the exchange which may be used to cancel it.
+    ///
+    /// @throw DNSSocketPoolError if the message is too short or too long
+    /// or the socket can't be opened.
+    ExchangeId send(const asiolink::IOAddress& ns_addr,
+                    const uint16_t ns_port,
+                    const util::OutputBufferPtr& msg_buf,
+                    const util::OutputBufferPtr& response_buf,
+                    asiodns::IOFetch::Callback* callback,
+                    const int wait,
+                    const asiodns::IOFetch::Protocol protocol =
+                    asiodns::IOFetch::UDP);
+
+    /// @brief Cancels the pending exchange.
+    ///
+    /// The callback of the canceled exchange is not invoked.  The method
+    /// does nothing if the exchange is not pending.
+    ///
+    /// @param exchange_id Identifier of the exchange returned by @c send.
+    void cancel(const ExchangeId exchange_id);
+
+    /// @brief Returns the number of pending exchanges.
+    size_t getPendingNum() const;
+
+    /// @brief Returns the number of sockets opened for the DNS server.
+    ///
+    /// @param ns_addr DNS server address.
+    /// @param ns_port DNS server port.
+    /// @param protocol Transport protocol.
+    size_t getSocketsNum(const asiolink::IOAddress& ns_addr,
+                         const uint16_t ns_port,
+                         const asiodns::IOFetch::Protocol protocol =
+                         asiodns::IOFetch::UDP) const;
+
+    /// @brief Checks if the TCP connection to the DNS server is established.
+    ///
+    /// @param ns_addr DNS server address.
+    /// @param ns_port DNS server port.
+    bool isConnected(const asiolink::IOAddress& ns_addr,
+                     const uint16_t ns_port) const;
+
+private:
+
+    /// @brief Key identifying the DNS server and the transport protocol.
+    typedef std::pair<std::pair<asiolink::IOAddress, uint16_t>,
+                      asiodns::IOFetch::Protocol> ServerKey;
+
+    /// @brief Defines a map of the channels opened for the DNS servers.
+    typedef std::map<ServerKey, std::vector<DNSChannelPtr> > ChannelMap;
+
+    /// @brief Returns the channel to be used for the next exchange with the
+    /// DNS server, opening a new one if necessary.
+    ///
+    /// @param ns_addr DNS server address.
+    /// @param ns_port DNS server port.
+    /// @param protocol Transport protocol.
+    DNSChannelPtr getChannel(const asiolink::IOAddress& ns_addr,
+                             const uint16_t ns_port,
+                             const asiodns::IOFetch::Protocol protocol);
+
+    /// @brief IO service used to run the exchanges.
+    asiolink::IOService& io_service_;
+
+    /// @brief Maximum number of UDP sockets opened for a single DNS server.
+    size_t sockets_per_server_;
+
+    /// @brief Time in milliseconds after which the idle TCP connection is
+    /// closed.
+    long tcp_idle_timeout_;
+
+    /// @brief Channels by DNS servers.
+    ChannelMap channels_;
+
+    /// @brief Identifier assigned to the next exchange.
+    ExchangeId next_exchange_id_;
+};
+
+/// @brief Defines a pointer to a @c DNSSocketPool.
+typedef boost::shared_ptr<DNSSocketPool> DNSSocketPoolPtr;
+
+} // namespace d2
+} // namespace isc
+
+#endif // DNS_SOCKET_POOL_H
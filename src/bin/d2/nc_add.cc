@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2015 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -125,7 +125,16 @@ void
 NameAddTransaction::readyHandler() {
     switch(getNextEvent()) {
     case START_EVT:
-        if (getForwardDomain()) {
+        if (getInitialFwdCompleted()) {
+            // The forward addresses have been added by the update shared
+            // with other transactions, so the forward change is done.
+            setForwardChangeCompleted(true);
+            if (getReverseDomain()) {
+                transition(SELECTING_REV_SERVER_ST, SELECT_SERVER_EVT);
+            } else {
+                transition(PROCESS_TRANS_OK_ST, UPDATE_OK_EVT);
+            }
+        } else if (getForwardDomain()) {
             // Request includes a forward change, do that first.
             transition(SELECTING_FWD_SERVER_ST, SELECT_SERVER_EVT);
         } else {
@@ -581,6 +590,14 @@ NameAddTransaction::processAddFailedHandler() {
     }
 }
 
+D2UpdateMessagePtr
+NameAddTransaction::buildInitialFwdRequest() {
+    buildAddFwdAddressRequest();
+    D2UpdateMessagePtr request = getDnsUpdateRequest();
+    clearDnsUpdateRequest();
+    return (request);
+}
+
 void
 NameAddTransaction::buildAddFwdAddressRequest() {
     // Construct an empty request.
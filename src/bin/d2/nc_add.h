@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2015 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -92,6 +92,17 @@ public:
     /// @brief Destructor
     virtual ~NameAddTransaction();
 
+    /// @brief Builds the initial forward update request for the transaction.
+    ///
+    /// Builds the request adding the forward DNS entry for the FQDN, as
+    /// described in @ref buildAddFwdAddressRequest, and returns it without
+    /// storing it as the transaction's update request.
+    ///
+    /// @return Pointer to the request.
+    ///
+    /// @throw This method does not throw but underlying methods may.
+    virtual D2UpdateMessagePtr buildInitialFwdRequest();
+
 protected:
     /// @brief Adds events defined by NameAddTransaction to the event set.
     ///
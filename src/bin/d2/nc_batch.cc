@@ -0,0 +1,217 @@
+// Copyright (C) 2017 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <d2/d2_log.h>
+#include <d2/nc_batch.h>
+
+#include <sstream>
+
+namespace isc {
+namespace d2 {
+
+NameChangeBatch::NameChangeBatch(asiolink::IOServicePtr& io_service,
+                                 const DdnsDomainPtr& forward_domain,
+                                 D2CfgMgrPtr& cfg_mgr,
+                                 const DNSSocketPoolPtr& socket_pool)
+    : io_service_(io_service), forward_domain_(forward_domain),
+      cfg_mgr_(cfg_mgr), socket_pool_(socket_pool), transactions_(),
+      dns_client_(), dns_update_request_(), dns_update_response_(),
+      tsig_key_(), current_server_(), next_server_pos_(0), started_(false),
+      done_(false) {
+    if (!io_service_) {
+        isc_throw(NameChangeBatchError, "IOServicePtr cannot be null");
+    }
+
+    if (!forward_domain_) {
+        isc_throw(NameChangeBatchError, "Forward domain cannot be null");
+    }
+
+    if (!cfg_mgr_) {
+        isc_throw(NameChangeBatchError,
+                  "Configuration manager cannot be null");
+    }
+}
+
+NameChangeBatch::~NameChangeBatch() {
+}
+
+void
+NameChangeBatch::addTransaction(const NameChangeTransactionPtr& trans) {
+    if (!trans) {
+        isc_throw(NameChangeBatchError, "Transaction cannot be null");
+    }
+
+    if (started_) {
+        isc_throw(NameChangeBatchError,
+                  "Cannot add a transaction to a started batch");
+    }
+
+    if (trans->getForwardDomain() != forward_domain_) {
+        isc_throw(NameChangeBatchError, "Transaction for "
+                  << trans->getNcr()->getFqdn()
+                  << " does not match the batch forward domain "
+                  << forward_domain_->getName());
+    }
+
+    transactions_.push_back(trans);
+}
+
+void
+NameChangeBatch::start() {
+    if (started_) {
+        isc_throw(NameChangeBatchError, "Batch has already been started");
+    }
+
+    started_ = true;
+
+    // Merge the initial forward updates of the members into a single
+    // request for the zone. Members which can't provide their update are
+    // started on their own so as they report the failure themselves.
+    D2UpdateMessagePtr request(new D2UpdateMessage(D2UpdateMessage::OUTBOUND));
+    request->setZone(dns::Name(forward_domain_->getName()), dns::RRClass::IN());
+
+    std::vector<NameChangeTransactionPtr> members;
+    for (size_t i = 0; i < transactions_.size(); ++i) {
+        const NameChangeTransactionPtr& trans = transactions_[i];
+        D2UpdateMessagePtr trans_request;
+        try {
+            trans_request = trans->buildInitialFwdRequest();
+        } catch (const std::exception&) {
+            trans_request.reset();
+        }
+
+        if (!trans_request) {
+            trans->startTransaction();
+            continue;
+        }
+
+        for (dns::RRsetIterator it = trans_request->
+             beginSection(D2UpdateMessage::SECTION_PREREQUISITE);
+             it != trans_request->
+             endSection(D2UpdateMessage::SECTION_PREREQUISITE); ++it) {
+            request->addRRset(D2UpdateMessage::SECTION_PREREQUISITE, *it);
+        }
+
+        for (dns::RRsetIterator it = trans_request->
+             beginSection(D2UpdateMessage::SECTION_UPDATE);
+             it != trans_request->
+             endSection(D2UpdateMessage::SECTION_UPDATE); ++it) {
+            request->addRRset(D2UpdateMessage::SECTION_UPDATE, *it);
+        }
+
+        members.push_back(trans);
+    }
+
+    transactions_.swap(members);
+
+    // There is nothing to coalesce for a single member.
+    if (transactions_.size() < 2) {
+        startTransactions(false);
+        return;
+    }
+
+    dns_update_request_ = request;
+
+    // Use the TSIG key of the domain, like the transactions do.
+    TSIGKeyInfoPtr tsig_key_info = forward_domain_->getTSIGKeyInfo();
+    if (tsig_key_info) {
+        tsig_key_ = tsig_key_info->getTSIGKey();
+    }
+
+    sendToNextServer();
+}
+
+void
+NameChangeBatch::operator()(DNSClient::Status status) {
+    if (status != DNSClient::SUCCESS) {
+        // We couldn't communicate with the current server, so try the
+        // next one.
+        sendToNextServer();
+        return;
+    }
+
+    const dns::Rcode& rcode = dns_update_response_->getRcode();
+    if (rcode != dns::Rcode::NOERROR()) {
+        std::ostringstream stream;
+        stream << "server " << current_server_->toText()
+               << " rejected it with RCODE: " << rcode.getCode();
+        fallback(stream.str());
+        return;
+    }
+
+    LOG_DEBUG(d2_to_dns_logger, DBGLVL_TRACE_DETAIL,
+              DHCP_DDNS_BATCH_UPDATE_COMPLETED)
+              .arg(transactions_.size())
+              .arg(forward_domain_->getName())
+              .arg(current_server_->toText());
+
+    startTransactions(true);
+}
+
+void
+NameChangeBatch::sendToNextServer() {
+    const DnsServerInfoStoragePtr& servers = forward_domain_->getServers();
+    if (!servers || (next_server_pos_ >= servers->size())) {
+        fallback("no more servers to try");
+        return;
+    }
+
+    current_server_ = (*servers)[next_server_pos_];
+    ++next_server_pos_;
+
+    try {
+        // Toss out any previous response.
+        dns_update_response_.reset();
+        dns_client_.reset(new DNSClient(dns_update_response_, this,
+                                        current_server_->getProtocol(),
+                                        socket_pool_));
+
+        D2ParamsPtr d2_params = cfg_mgr_->getD2Params();
+        dns_client_->doUpdate(*io_service_, current_server_->getIpAddress(),
+                              current_server_->getPort(),
+                              *dns_update_request_,
+                              d2_params->getDnsServerTimeout(), tsig_key_);
+    } catch (const std::exception& ex) {
+        // The coalesced update can't be sent, e.g. it is too large. Let the
+        // transactions do their updates.
+        fallback(ex.what());
+        return;
+    }
+
+    LOG_DEBUG(d2_to_dns_logger, DBGLVL_TRACE_DETAIL,
+              DHCP_DDNS_BATCH_UPDATE_SENT)
+              .arg(transactions_.size())
+              .arg(forward_domain_->getName())
+              .arg(current_server_->toText());
+}
+
+void
+NameChangeBatch::startTransactions(const bool initial_fwd_completed) {
+    done_ = true;
+    for (size_t i = 0; i < transactions_.size(); ++i) {
+        if (initial_fwd_completed) {
+            transactions_[i]->startTransactionAfterInitialFwd();
+        } else {
+            transactions_[i]->startTransaction();
+        }
+    }
+}
+
+void
+NameChangeBatch::fallback(const std::string& reason) {
+    LOG_DEBUG(d2_to_dns_logger, DBGLVL_TRACE_DETAIL,
+              DHCP_DDNS_BATCH_UPDATE_FALLBACK)
+              .arg(transactions_.size())
+              .arg(forward_domain_->getName())
+              .arg(reason);
+
+    startTransactions(false);
+}
+
+} // namespace isc::d2
+} // namespace isc
@@ -0,0 +1,199 @@
+// Copyright (C) 2017 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef NC_BATCH_H
+#define NC_BATCH_H
+
+/// @file nc_batch.h This file defines the class NameChangeBatch.
+
+#include <asiolink/io_service.h>
+#include <exceptions/exceptions.h>
+#include <d2/d2_cfg_mgr.h>
+#include <d2/dns_client.h>
+#include <d2/dns_socket_pool.h>
+#include <d2/nc_trans.h>
+#include <dns/tsig.h>
+
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <string>
+#include <vector>
+
+namespace isc {
+namespace d2 {
+
+/// @brief Thrown if the batch encounters a general error.
+class NameChangeBatchError : public isc::Exception {
+public:
+    NameChangeBatchError(const char* file, size_t line, const char* what) :
+        isc::Exception(file, line, what) { };
+};
+
+/// @brief Carries out the initial forward updates of several transactions
+/// with a single DNS update.
+///
+/// When many requests for the same zone arrive in a short time, sending one
+/// DNS update per request costs a packet exchange and a zone change on the
+/// DNS server for each request.  NameChangeBatch merges the initial forward
+/// update requests of several transactions for the same forward domain into
+/// a single DNS update (RFC 2136 allows any number of prerequisite and update
+/// RRs for the zone in one message) and sends it to the domain's servers.
+///
+/// The prerequisites of an update are evaluated together, so the server
+/// applies the coalesced update only if the prerequisites of every member
+/// hold.  If the server accepts the update, each transaction is started with
+/// its initial forward update marked as completed, see
+/// @ref NameChangeTransaction::startTransactionAfterInitialFwd.  Otherwise,
+/// e.g. because one of the FQDNs is in use by another client, or none of
+/// the servers could be reached, each transaction is started as usual and
+/// carries out its own updates.  The conflicts are therefore detected and
+/// resolved per FQDN exactly as without the coalescing.
+///
+/// Each server of the domain is tried once.  The retries are left to the
+/// transactions in the fallback.
+class NameChangeBatch : public DNSClient::Callback, public boost::noncopyable {
+public:
+    /// @brief Constructor
+    ///
+    /// @param io_service IO service to be used for IO processing
+    /// @param forward_domain is the domain which the FQDNs of the member
+    /// transactions belong to
+    /// @param cfg_mgr reference to the current configuration manager
+    /// @param socket_pool pool of sockets used to send the update (may
+    /// be empty)
+    ///
+    /// @throw NameChangeBatchError if the IO service, the domain or the
+    /// configuration manager is empty.
+    NameChangeBatch(asiolink::IOServicePtr& io_service,
+                    const DdnsDomainPtr& forward_domain,
+                    D2CfgMgrPtr& cfg_mgr,
+                    const DNSSocketPoolPtr& socket_pool);
+
+    /// @brief Destructor
+    virtual ~NameChangeBatch();
+
+    /// @brief Adds a transaction to the batch.
+    ///
+    /// The transaction must match the batch's forward domain and must not
+    /// be started.
+    ///
+    /// @param trans transaction to add
+    ///
+    /// @throw NameChangeBatchError if the transaction is empty, doesn't
+    /// match the forward domain or the batch has already been started.
+    void addTransaction(const NameChangeTransactionPtr& trans);
+
+    /// @brief Builds the coalesced update and sends it to the first server.
+    ///
+    /// The transactions whose initial forward update can't be built are
+    /// started individually, and so is the only remaining transaction if
+    /// there is just one.
+    ///
+    /// @throw NameChangeBatchError if the batch has already been started.
+    void start();
+
+    /// @brief Serves as the DNSClient IO completion event handler.
+    ///
+    /// Starts the member transactions if the server accepted the update.
+    /// Tries the next server on an IO error or falls back to the individual
+    /// updates if there are no more servers or the server rejected the
+    /// update.
+    ///
+    /// @param status is the outcome of the DNS update packet exchange.
+    virtual void operator()(DNSClient::Status status);
+
+    /// @brief Checks if all of the member transactions have been started.
+    bool isDone() const {
+        return (done_);
+    }
+
+    /// @brief Returns the number of the member transactions.
+    size_t getTransactionCount() const {
+        return (transactions_.size());
+    }
+
+    /// @brief Returns the forward domain of the batch.
+    const DdnsDomainPtr& getForwardDomain() const {
+        return (forward_domain_);
+    }
+
+    /// @brief Returns the coalesced update request.
+    ///
+    /// @return Pointer to the request or an empty pointer if the batch
+    /// hasn't been started or no coalesced update was needed.
+    const D2UpdateMessagePtr& getDnsUpdateRequest() const {
+        return (dns_update_request_);
+    }
+
+    /// @brief Returns the currently selected server.
+    const DnsServerInfoPtr& getCurrentServer() const {
+        return (current_server_);
+    }
+
+private:
+    /// @brief Sends the coalesced update to the next server.
+    ///
+    /// Falls back to the individual updates if there are no more servers
+    /// or the update can't be sent.
+    void sendToNextServer();
+
+    /// @brief Starts the member transactions.
+    ///
+    /// @param initial_fwd_completed indicates if the coalesced update has
+    /// been accepted by the server.
+    void startTransactions(const bool initial_fwd_completed);
+
+    /// @brief Logs the reason and starts the member transactions as usual.
+    ///
+    /// @param reason text explaining why the coalesced update failed.
+    void fallback(const std::string& reason);
+
+    /// @brief The IOService which should be used to for IO processing.
+    asiolink::IOServicePtr io_service_;
+
+    /// @brief The forward domain which the member FQDNs belong to.
+    DdnsDomainPtr forward_domain_;
+
+    /// @brief Pointer to the configuration manager.
+    D2CfgMgrPtr cfg_mgr_;
+
+    /// @brief Pointer to the pool of sockets used by the DNSClient (if any).
+    DNSSocketPoolPtr socket_pool_;
+
+    /// @brief The member transactions.
+    std::vector<NameChangeTransactionPtr> transactions_;
+
+    /// @brief The DNSClient instance that carries out the packet exchange.
+    DNSClientPtr dns_client_;
+
+    /// @brief The coalesced update request.
+    D2UpdateMessagePtr dns_update_request_;
+
+    /// @brief The DNS update response packet most recently received.
+    D2UpdateMessagePtr dns_update_response_;
+
+    /// @brief Pointer to the TSIG key which should be used (if any).
+    dns::TSIGKeyPtr tsig_key_;
+
+    /// @brief Pointer to the currently selected server.
+    DnsServerInfoPtr current_server_;
+
+    /// @brief Next server position in the domain's server list.
+    size_t next_server_pos_;
+
+    /// @brief Indicates if the batch has been started.
+    bool started_;
+
+    /// @brief Indicates if the member transactions have been started.
+    bool done_;
+};
+
+/// @brief Defines a pointer to a NameChangeBatch.
+typedef boost::shared_ptr<NameChangeBatch> NameChangeBatchPtr;
+
+} // namespace isc::d2
+} // namespace isc
+#endif
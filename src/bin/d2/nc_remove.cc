@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2015 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -165,8 +165,14 @@ NameRemoveTransaction::selectingFwdServerHandler() {
 
     // Select the next server from the list of forward servers.
     if (selectNextServer()) {
-        // We have a server to try.
-        transition(REMOVING_FWD_ADDRS_ST, SERVER_SELECTED_EVT);
+        // We have a server to try. If the forward address has already been
+        // removed by the update shared with other transactions, continue
+        // with the removal of the remaining RRs.
+        if (getInitialFwdCompleted()) {
+            transition(REMOVING_FWD_RRS_ST, SERVER_SELECTED_EVT);
+        } else {
+            transition(REMOVING_FWD_ADDRS_ST, SERVER_SELECTED_EVT);
+        }
     }
     else {
         // Server list is exhausted, so fail the transaction.
@@ -595,6 +601,14 @@ NameRemoveTransaction::processRemoveFailedHandler() {
     }
 }
 
+D2UpdateMessagePtr
+NameRemoveTransaction::buildInitialFwdRequest() {
+    buildRemoveFwdAddressRequest();
+    D2UpdateMessagePtr request = getDnsUpdateRequest();
+    clearDnsUpdateRequest();
+    return (request);
+}
+
 void
 NameRemoveTransaction::buildRemoveFwdAddressRequest() {
     // Construct an empty request.
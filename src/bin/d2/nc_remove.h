@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2015 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -88,6 +88,17 @@ public:
     /// @brief Destructor
     virtual ~NameRemoveTransaction();
 
+    /// @brief Builds the initial forward update request for the transaction.
+    ///
+    /// Builds the request removing the forward DNS address mapping for the
+    /// FQDN, as described in @ref buildRemoveFwdAddressRequest, and returns
+    /// it without storing it as the transaction's update request.
+    ///
+    /// @return Pointer to the request.
+    ///
+    /// @throw This method does not throw but underlying methods may.
+    virtual D2UpdateMessagePtr buildInitialFwdRequest();
+
 protected:
     /// @brief Adds events defined by NameRemoveTransaction to the event set.
     ///
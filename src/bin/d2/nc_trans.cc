@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -49,8 +49,8 @@ NameChangeTransaction(asiolink::IOServicePtr& io_service,
      reverse_domain_(reverse_domain), dns_client_(), dns_update_request_(),
      dns_update_status_(DNSClient::OTHER), dns_update_response_(),
      forward_change_completed_(false), reverse_change_completed_(false),
-     current_server_list_(), current_server_(), next_server_pos_(0),
-     update_attempts_(0), cfg_mgr_(cfg_mgr), tsig_key_() {
+     initial_fwd_completed_(false), current_server_list_(), current_server_(), next_server_pos_(0),
+     update_attempts_(0), cfg_mgr_(cfg_mgr), tsig_key_(), socket_pool_() {
     /// @todo if io_service is NULL we are multi-threading and should
     /// instantiate our own
     if (!io_service_) {
@@ -91,6 +91,17 @@ NameChangeTransaction::startTransaction() {
     startModel(READY_ST);
 }
 
+void
+NameChangeTransaction::startTransactionAfterInitialFwd() {
+    initial_fwd_completed_ = true;
+    startTransaction();
+}
+
+D2UpdateMessagePtr
+NameChangeTransaction::buildInitialFwdRequest() {
+    return (D2UpdateMessagePtr());
+}
+
 void
 NameChangeTransaction::operator()(DNSClient::Status status) {
     // Stow the completion status and re-enter the run loop with the event
@@ -448,12 +459,11 @@ NameChangeTransaction::selectNextServer() {
         // Toss out any previous response.
         dns_update_response_.reset();
 
-        // @todo  Protocol is set on DNSClient constructor.  We need
-        // to propagate a configuration value downward, probably starting
-        // at global, then domain, then server
-        // Once that is supported we need to add it here.
+        // Use the protocol configured for the server. The exchanges over
+        // TCP share the persistent connection held by the socket pool.
         dns_client_.reset(new DNSClient(dns_update_response_ , this,
-                                        DNSClient::UDP));
+                                        current_server_->getProtocol(),
+                                        socket_pool_));
         ++next_server_pos_;
         return (true);
     }
@@ -466,6 +476,16 @@ NameChangeTransaction::getDNSClient() const {
     return (dns_client_);
 }
 
+void
+NameChangeTransaction::setSocketPool(const DNSSocketPoolPtr& socket_pool) {
+    socket_pool_ = socket_pool;
+}
+
+const DNSSocketPoolPtr&
+NameChangeTransaction::getSocketPool() const {
+    return (socket_pool_);
+}
+
 const DnsServerInfoPtr&
 NameChangeTransaction::getCurrentServer() const {
     return (current_server_);
@@ -501,6 +521,11 @@ NameChangeTransaction::getReverseChangeCompleted() const {
     return (reverse_change_completed_);
 }
 
+bool
+NameChangeTransaction::getInitialFwdCompleted() const {
+    return (initial_fwd_completed_);
+}
+
 size_t
 NameChangeTransaction::getUpdateAttempts() const {
     return (update_attempts_);
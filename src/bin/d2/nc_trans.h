@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -182,6 +182,31 @@ public:
     /// with the state handler for READY_ST.
     void startTransaction();
 
+    /// @brief Begins execution of the transaction whose initial forward
+    /// update has already been carried out.
+    ///
+    /// This method is used when the initial forward update of the
+    /// transaction was sent to the DNS server together with the updates of
+    /// other transactions, see @ref NameChangeBatch.  It marks the initial
+    /// forward update as completed and invokes @ref startTransaction.  The
+    /// state handlers consult @ref getInitialFwdCompleted to skip that
+    /// update.
+    void startTransactionAfterInitialFwd();
+
+    /// @brief Builds the initial forward update request for the transaction.
+    ///
+    /// The request is returned to the caller rather than stored as the
+    /// transaction's update request so as it may be merged with the requests
+    /// of other transactions for the same zone.  Derivations which support
+    /// this must override the method. The default implementation returns
+    /// an empty pointer.
+    ///
+    /// @return Pointer to the request or an empty pointer if the transaction
+    /// doesn't support it.
+    ///
+    /// @throw This method does not throw but the overrides may.
+    virtual D2UpdateMessagePtr buildInitialFwdRequest();
+
     /// @brief Serves as the DNSClient IO completion event handler.
     ///
     /// This is the implementation of the method inherited by our derivation
@@ -475,6 +500,20 @@ public:
     /// @return A const pointer reference to the DNSClient
     const DNSClientPtr& getDNSClient() const;
 
+    /// @brief Sets the pool of sockets used by the DNSClient.
+    ///
+    /// The pool is passed to the DNSClient instances created when the
+    /// servers are selected.  If the pool is not set, each DNS update is
+    /// sent through a new socket.
+    ///
+    /// @param socket_pool Pointer to the socket pool.
+    void setSocketPool(const DNSSocketPoolPtr& socket_pool);
+
+    /// @brief Fetches the pool of sockets used by the DNSClient.
+    ///
+    /// @return A const pointer reference to the socket pool.
+    const DNSSocketPoolPtr& getSocketPool() const;
+
     /// @brief Fetches the current DNS update request packet.
     ///
     /// @return A const pointer reference to the current D2UpdateMessage
@@ -511,6 +550,13 @@ public:
     /// @return True if the reverse change has been completed, false otherwise.
     bool getReverseChangeCompleted() const;
 
+    /// @brief Returns whether the initial forward update has been carried
+    /// out before the transaction was started.
+    ///
+    /// @return True if the transaction was started with
+    /// @ref startTransactionAfterInitialFwd, false otherwise.
+    bool getInitialFwdCompleted() const;
+
     /// @brief Fetches the update attempt count for the current update.
     ///
     /// @return size_t which is the number of times the current request has
@@ -562,6 +608,10 @@ private:
     /// @brief Indicator for whether or not the reverse change completed ok.
     bool reverse_change_completed_;
 
+    /// @brief Indicator for whether or not the initial forward update was
+    /// carried out before the transaction was started.
+    bool initial_fwd_completed_;
+
     /// @brief Pointer to the current server selection list.
     DnsServerInfoStoragePtr current_server_list_;
 
@@ -582,6 +632,9 @@ private:
 
     /// @brief Pointer to the TSIG key which should be used (if any).
     dns::TSIGKeyPtr tsig_key_;
+
+    /// @brief Pointer to the pool of sockets used by the DNSClient (if any).
+    DNSSocketPoolPtr socket_pool_;
 };
 
 /// @brief Defines a pointer to a NameChangeTransaction.
@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -14,10 +14,14 @@
 #include <test_data_files_config.h>
 #include <util/encode/base64.h>
 
+#include <boost/date_time/posix_time/posix_time.hpp>
 #include <boost/foreach.hpp>
+#include <boost/lexical_cast.hpp>
 #include <boost/scoped_ptr.hpp>
 #include <gtest/gtest.h>
 
+#include <iostream>
+
 using namespace std;
 using namespace isc;
 using namespace isc::d2;
@@ -464,6 +468,39 @@ TEST_F(D2CfgMgrTest, defaultValues) {
     runConfig(config);
     EXPECT_EQ(dhcp_ddns::stringToNcrFormat(D2Params::DFT_NCR_FORMAT),
               d2_params_->getNcrFormat());
+
+    // Check that omitting update batching parameters gets you their defaults
+    EXPECT_EQ(D2Params::DFT_UPDATE_BATCH_SIZE,
+              d2_params_->getUpdateBatchSize());
+    EXPECT_EQ(D2Params::DFT_UPDATE_BATCH_WINDOW,
+              d2_params_->getUpdateBatchWindow());
+}
+
+/// @brief Tests that the update batching parameters are parsed.
+TEST_F(D2CfgMgrTest, updateBatchParams) {
+    std::string config =
+            "{"
+            " \"ip-address\": \"192.0.0.1\" , "
+            " \"port\": 777 , "
+            " \"update-batch-size\": 16 , "
+            " \"update-batch-window\": 5 , "
+            "\"tsig-keys\": [], "
+            "\"forward-ddns\" : {}, "
+            "\"reverse-ddns\" : {} "
+            "}";
+
+    runConfig(config);
+    EXPECT_EQ(16, d2_params_->getUpdateBatchSize());
+    EXPECT_EQ(5, d2_params_->getUpdateBatchWindow());
+
+    // Verify that the parameters are compared.
+    D2Params params(isc::asiolink::IOAddress("192.0.0.1"), 777,
+                    D2Params::DFT_DNS_SERVER_TIMEOUT, dhcp_ddns::NCR_UDP,
+                    dhcp_ddns::FMT_JSON);
+    EXPECT_TRUE(params != *d2_params_);
+    EXPECT_TRUE(D2Params(isc::asiolink::IOAddress("192.0.0.1"), 777,
+                         D2Params::DFT_DNS_SERVER_TIMEOUT, dhcp_ddns::NCR_UDP,
+                         dhcp_ddns::FMT_JSON, 16, 5) == *d2_params_);
 }
 
 /// @brief Tests the unsupported scalar parameters and objects are detected.
@@ -817,6 +854,7 @@ TEST_F(TSIGKeyInfoTest, validTSIGKeyList) {
 /// 1. Specifying both a hostname and an ip address is not allowed.
 /// 2. Specifying both blank a hostname and blank ip address is not allowed.
 /// 3. Specifying a negative port number is not allowed.
+/// 4. Specifying a protocol other than UDP or TCP is not allowed.
 TEST_F(DnsServerInfoTest, invalidEntry) {
     // Create a config in which both host and ip address are supplied.
     // Verify that build fails.
@@ -838,6 +876,13 @@ TEST_F(DnsServerInfoTest, invalidEntry) {
              "  \"port\": -100 }";
     ASSERT_TRUE(fromJSON(config));
     EXPECT_THROW (parser_->build(config_set_), isc::BadValue);
+
+    // Create a config with an unsupported protocol.
+    // Verify that build fails.
+    config = "{ \"ip-address\": \"192.168.5.6\" ,"
+             "  \"protocol\": \"SCTP\" }";
+    ASSERT_TRUE(fromJSON(config));
+    EXPECT_THROW (parser_->build(config_set_), D2CfgError);
 }
 
 
@@ -847,6 +892,7 @@ TEST_F(DnsServerInfoTest, invalidEntry) {
 /// 1. A DnsServerInfo entry is correctly made, when given only a hostname.
 /// 2. A DnsServerInfo entry is correctly made, when given ip address and port.
 /// 3. A DnsServerInfo entry is correctly made, when given only an ip address.
+/// 4. The protocol defaults to UDP and may be set to TCP.
 TEST_F(DnsServerInfoTest, validEntry) {
     /// @todo When resolvable hostname is supported you'll need this test.
     /// // Valid entries for dynamic host
@@ -906,6 +952,26 @@ TEST_F(DnsServerInfoTest, validEntry) {
     server = (*servers_)[0];
     EXPECT_TRUE(checkServer(server, "", "192.168.2.5",
                             DnsServerInfo::STANDARD_DNS_PORT));
+    EXPECT_EQ(DNSClient::UDP, server->getProtocol());
+
+    // Start over for a new test.
+    reset();
+
+    // Valid entries for static ip and TCP, the protocol is case insensitive.
+    config = " { \"ip-address\": \"192.168.2.6\" , "
+             "  \"protocol\": \"tcp\" }";
+    ASSERT_TRUE(fromJSON(config));
+
+    // Verify that it builds and commits without throwing.
+    ASSERT_NO_THROW(parser_->build(config_set_));
+    ASSERT_NO_THROW(parser_->commit());
+
+    // Verify the server exists and has the correct values.
+    ASSERT_EQ(1, servers_->size());
+    server = (*servers_)[0];
+    EXPECT_TRUE(checkServer(server, "", "192.168.2.6",
+                            DnsServerInfo::STANDARD_DNS_PORT));
+    EXPECT_EQ(DNSClient::TCP, server->getProtocol());
 }
 
 /// @brief Verifies that attempting to parse an invalid list of DnsServerInfo
@@ -1556,6 +1622,95 @@ TEST_F(D2CfgMgrTest, matchAll) {
 
 }
 
+/// @brief Creates a domain list manager holding the given domains.
+///
+/// @param names names of the domains to add to the manager.
+DdnsDomainListMgrPtr
+createDomainListMgr(const std::vector<std::string>& names) {
+    DdnsDomainMapPtr domains(new DdnsDomainMap());
+    BOOST_FOREACH(std::string name, names) {
+        DnsServerInfoStoragePtr servers(new DnsServerInfoStorage());
+        (*domains)[name] = DdnsDomainPtr(new DdnsDomain(name, servers));
+    }
+
+    DdnsDomainListMgrPtr mgr(new DdnsDomainListMgr("test"));
+    mgr->setDomains(domains);
+    return (mgr);
+}
+
+/// @brief Tests that domain matching honors the label boundaries and
+/// ignores the case of both the FQDN and the domain names.
+TEST(DdnsDomainListMgr, matchLabels) {
+    std::vector<std::string> names;
+    names.push_back("two.net");
+    names.push_back("Example.COM");
+    names.push_back("sub.example.com");
+    DdnsDomainListMgrPtr mgr = createDomainListMgr(names);
+
+    DdnsDomainPtr match;
+    EXPECT_TRUE(mgr->matchDomain("two.net", match));
+    EXPECT_EQ("two.net", match->getName());
+    EXPECT_TRUE(mgr->matchDomain("one.two.net", match));
+    EXPECT_EQ("two.net", match->getName());
+
+    // The name which doesn't end on a label boundary must not match.
+    match.reset();
+    EXPECT_FALSE(mgr->matchDomain("onetwo.net", match));
+    EXPECT_FALSE(match);
+
+    // The domain configured in mixed case matches the lower case FQDN.
+    EXPECT_TRUE(mgr->matchDomain("host.example.com", match));
+    EXPECT_EQ("Example.COM", match->getName());
+
+    // The longest match wins regardless of the case.
+    EXPECT_TRUE(mgr->matchDomain("HOST.SUB.EXAMPLE.COM", match));
+    EXPECT_EQ("sub.example.com", match->getName());
+    EXPECT_TRUE(mgr->matchDomain("host.sub.example.com.", match));
+    EXPECT_EQ("Example.COM", match->getName());
+
+    // Replacing the domains rebuilds the index.
+    names.clear();
+    names.push_back("example.org");
+    names.push_back("*");
+    mgr->setDomains(createDomainListMgr(names)->getDomains());
+    EXPECT_TRUE(mgr->matchDomain("host.example.org", match));
+    EXPECT_EQ("example.org", match->getName());
+    EXPECT_TRUE(mgr->matchDomain("host.example.com", match));
+    EXPECT_EQ("*", match->getName());
+}
+
+/// @brief Measures the domain matching time with a large number of
+/// configured domains.
+///
+/// The test is disabled by default as it doesn't verify anything but
+/// prints the time taken by the matching.
+TEST(DdnsDomainListMgr, DISABLED_matchPerformance) {
+    const size_t domains_num = 10000;
+    const size_t lookups_num = 100000;
+
+    std::vector<std::string> names;
+    for (size_t i = 0; i < domains_num; ++i) {
+        names.push_back("zone" + boost::lexical_cast<std::string>(i) +
+                        ".example.com");
+    }
+    DdnsDomainListMgrPtr mgr = createDomainListMgr(names);
+
+    DdnsDomainPtr match;
+    boost::posix_time::ptime start =
+        boost::posix_time::microsec_clock::universal_time();
+    for (size_t i = 0; i < lookups_num; ++i) {
+        const std::string fqdn = "host.zone" +
+            boost::lexical_cast<std::string>(i % domains_num) + ".example.com";
+        ASSERT_TRUE(mgr->matchDomain(fqdn, match));
+    }
+    boost::posix_time::time_duration elapsed =
+        boost::posix_time::microsec_clock::universal_time() - start;
+
+    std::cout << lookups_num << " matches against " << domains_num
+              << " domains took " << elapsed.total_milliseconds()
+              << " ms" << std::endl;
+}
+
 /// @brief Tests the basics of the D2CfgMgr reverse FQDN-domain matching
 /// This test uses a valid configuration to exercise the D2CfgMgr's
 /// reverse FQDN-to-domain matching.
@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -14,9 +14,11 @@
 
 #include <boost/function.hpp>
 #include <boost/bind.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
 #include <gtest/gtest.h>
 #include <gtest/gtest.h>
 #include <algorithm>
+#include <sstream>
 #include <vector>
 
 using namespace std;
@@ -51,6 +53,7 @@ public:
     using D2UpdateMgr::checkFinishedTransactions;
     using D2UpdateMgr::pickNextJob;
     using D2UpdateMgr::makeTransaction;
+    using D2UpdateMgr::makeBatch;
 };
 
 /// @brief Defines a pointer to a D2UpdateMgr instance.
@@ -113,11 +116,18 @@ public:
     }
 
     /// @brief Seeds configuration manager with a valid DHCP_DDNS configuration.
-    void makeCannedConfig() {
+    ///
+    /// @param batch_size value of the update-batch-size parameter.
+    /// @param batch_window value of the update-batch-window parameter.
+    void makeCannedConfig(const size_t batch_size = 0,
+                          const size_t batch_window = 0) {
+        std::ostringstream batch_params;
+        batch_params << "\"update-batch-size\" : " << batch_size << " , "
+                     << "\"update-batch-window\" : " << batch_window << " , ";
         std::string canned_config_ =
                  "{ "
                   "\"ip-address\" : \"192.168.1.33\" , "
-                  "\"port\" : 88 , "
+                  "\"port\" : 88 , " + batch_params.str() +
                   "\"tsig-keys\": [] ,"
                   "\"forward-ddns\" : {"
                   "\"ddns-domains\": [ "
@@ -177,18 +187,42 @@ public:
     /// @brief Determines if any transactions are waiting for IO completion.
     ///
     /// @returns True if isModelWaiting() is true for at least one of the current
-    /// transactions.
+    /// transactions or a coalesced update is in progress.
     bool anyoneWaiting() {
+        if (update_mgr_->getBatchCount() > 0) {
+            return true;
+        }
+
         TransactionList::iterator it = update_mgr_->transactionListBegin();
         while (it != update_mgr_->transactionListEnd()) {
             if (((*it).second)->isModelWaiting()) {
                 return true;
             }
+            ++it;
         }
 
         return false;
     }
 
+    /// @brief Enqueues a request for the given FQDN.
+    ///
+    /// @param change_type type of the change
+    /// @param dhcid DHCID of the request
+    /// @param fqdn FQDN of the request
+    /// @param reverse_change indicates if the reverse change is requested
+    NameChangeRequestPtr enqueueNcr(const NameChangeType change_type,
+                                    const std::string& dhcid,
+                                    const std::string& fqdn,
+                                    const bool reverse_change = false) {
+        NameChangeRequestPtr ncr(new NameChangeRequest(*canned_ncrs_[0]));
+        ncr->setChangeType(change_type);
+        ncr->setDhcid(dhcid);
+        ncr->setFqdn(fqdn);
+        ncr->setReverseChange(reverse_change);
+        queue_mgr_->enqueue(ncr);
+        return (ncr);
+    }
+
     /// @brief Process events until all requests have been completed.
     ///
     /// This method iteratively calls D2UpdateMgr::sweep and executes
@@ -462,6 +496,9 @@ TEST_F(D2UpdateMgrTest, checkFinishedTransaction) {
         NameChangeTransactionPtr trans = (*pos).second;
         ASSERT_EQ(dhcp_ddns::ST_PENDING, trans->getNcrStatus());
         ASSERT_TRUE(trans->isModelRunning());
+        // All transactions share the socket pool of the update manager.
+        ASSERT_TRUE(trans->getSocketPool());
+        EXPECT_EQ(update_mgr_->getSocketPool(), trans->getSocketPool());
         ++pos;
     }
 
@@ -860,4 +897,151 @@ TEST_F(D2UpdateMgrTest, multiTransactionTimeout) {
     }
 }
 
+/// @brief Tests coalescing of the forward updates.
+/// This test verifies that the update manager dequeues the additions for
+/// the same forward domain into a single batch, which sends a single forward
+/// update for them, and that the transactions complete their remaining
+/// updates on their own.
+TEST_F(D2UpdateMgrTest, batchAddTransactions) {
+    makeCannedConfig(4, 0);
+
+    std::vector<NameChangeRequestPtr> ncrs;
+    ncrs.push_back(enqueueNcr(CHG_ADD, "111111", "one.example.com.", true));
+    ncrs.push_back(enqueueNcr(CHG_ADD, "222222", "two.example.com."));
+    ncrs.push_back(enqueueNcr(CHG_ADD, "333333", "three.example.com.", true));
+
+    // Call sweep once, this should dequeue all of the requests and
+    // start a single batch for them.
+    ASSERT_NO_THROW(update_mgr_->sweep());
+    EXPECT_EQ(0, update_mgr_->getQueueCount());
+    EXPECT_EQ(3, update_mgr_->getTransactionCount());
+    EXPECT_EQ(1, update_mgr_->getBatchCount());
+
+    // The transactions wait for the coalesced update.
+    std::vector<NameChangeTransactionPtr> transactions;
+    for (int i = 0; i < ncrs.size(); ++i) {
+        TransactionList::iterator pos =
+            update_mgr_->findTransaction(ncrs[i]->getDhcid());
+        ASSERT_TRUE(pos != update_mgr_->transactionListEnd());
+        EXPECT_TRUE(pos->second->isModelNew());
+        transactions.push_back(pos->second);
+    }
+
+    // Create a server and start it listening.
+    asiolink::IOAddress server_ip("127.0.0.1");
+    FauxServer server(*io_service_, server_ip, 5301);
+    server.receive(FauxServer::USE_RCODE, dns::Rcode::NOERROR());
+
+    // Run sweep and IO until everything is done.
+    processAll();
+
+    EXPECT_EQ(0, update_mgr_->getBatchCount());
+    for (int i = 0; i < ncrs.size(); ++i) {
+        EXPECT_EQ(dhcp_ddns::ST_COMPLETED, ncrs[i]->getStatus());
+        EXPECT_TRUE(transactions[i]->getForwardChangeCompleted());
+    }
+
+    // The forward only transaction didn't send any update itself.
+    EXPECT_EQ(0, transactions[1]->getUpdateAttempts());
+}
+
+/// @brief Tests the selection of the requests for a batch.
+/// This test verifies that a batch includes only the requests of the same
+/// type for the same forward domain, and that requests are not reordered
+/// with respect to the requests for the same DHCID or FQDN.
+TEST_F(D2UpdateMgrTest, batchSelection) {
+    makeCannedConfig(4, 0);
+
+    enqueueNcr(CHG_ADD, "111111", "one.example.com.");
+    // Different change type.
+    enqueueNcr(CHG_REMOVE, "222222", "two.example.com.");
+    // Same DHCID as the skipped request.
+    enqueueNcr(CHG_ADD, "222222", "three.example.com.");
+    // Same FQDN as the skipped request.
+    enqueueNcr(CHG_ADD, "333333", "TWO.example.com.");
+    // Same FQDN as the first request.
+    enqueueNcr(CHG_ADD, "666666", "one.example.com.");
+    // Eligible.
+    enqueueNcr(CHG_ADD, "444444", "four.example.com.");
+    // Different forward domain.
+    enqueueNcr(CHG_ADD, "555555", "five.org.");
+
+    ASSERT_NO_THROW(update_mgr_->sweep());
+    EXPECT_EQ(5, update_mgr_->getQueueCount());
+    EXPECT_EQ(2, update_mgr_->getTransactionCount());
+    EXPECT_EQ(1, update_mgr_->getBatchCount());
+    EXPECT_TRUE(update_mgr_->hasTransaction(D2Dhcid("111111")));
+    EXPECT_TRUE(update_mgr_->hasTransaction(D2Dhcid("444444")));
+
+    // The remove request is next in the queue.
+    EXPECT_EQ(dhcp_ddns::CHG_REMOVE, queue_mgr_->peek()->getChangeType());
+}
+
+/// @brief Tests the batching window.
+/// This test verifies that the requests wait for the others to coalesce
+/// with until the batching window expires.
+TEST_F(D2UpdateMgrTest, batchWindow) {
+    makeCannedConfig(3, 50);
+
+    boost::posix_time::ptime start =
+        boost::posix_time::microsec_clock::universal_time();
+
+    // The request waits for the others.
+    enqueueNcr(CHG_ADD, "111111", "one.example.com.");
+    ASSERT_NO_THROW(update_mgr_->sweep());
+    EXPECT_EQ(1, update_mgr_->getQueueCount());
+    EXPECT_EQ(0, update_mgr_->getTransactionCount());
+
+    // The batch is still not full.
+    enqueueNcr(CHG_ADD, "222222", "two.example.com.");
+    ASSERT_NO_THROW(update_mgr_->sweep());
+    EXPECT_EQ(2, update_mgr_->getQueueCount());
+    EXPECT_EQ(0, update_mgr_->getTransactionCount());
+
+    // Run IO until the window expires.
+    for (int i = 0; (i < 10) && (update_mgr_->getQueueCount() > 0); ++i) {
+        ASSERT_LT(0, runTimedIO(500));
+        ASSERT_NO_THROW(update_mgr_->sweep());
+    }
+
+    EXPECT_EQ(0, update_mgr_->getQueueCount());
+    EXPECT_EQ(2, update_mgr_->getTransactionCount());
+    EXPECT_EQ(1, update_mgr_->getBatchCount());
+    EXPECT_LE(50, (boost::posix_time::microsec_clock::universal_time()
+                   - start).total_milliseconds());
+}
+
+/// @brief Tests the fallback of the coalesced update.
+/// This test verifies that when the coalesced update fails, the requests
+/// are carried out on their own.  No server is running, so everything will
+/// time out.
+TEST_F(D2UpdateMgrTest, batchFallback) {
+    makeCannedConfig(4, 0);
+
+    std::vector<NameChangeRequestPtr> ncrs;
+    ncrs.push_back(enqueueNcr(CHG_REMOVE, "111111", "one.example.com."));
+    ncrs.push_back(enqueueNcr(CHG_REMOVE, "222222", "two.example.com."));
+
+    ASSERT_NO_THROW(update_mgr_->sweep());
+    EXPECT_EQ(1, update_mgr_->getBatchCount());
+
+    // Grab the transactions before they are finished.
+    std::vector<NameChangeTransactionPtr> transactions;
+    for (int i = 0; i < ncrs.size(); ++i) {
+        TransactionList::iterator pos =
+            update_mgr_->findTransaction(ncrs[i]->getDhcid());
+        ASSERT_TRUE(pos != update_mgr_->transactionListEnd());
+        transactions.push_back(pos->second);
+    }
+
+    // Run sweep and IO until everything is done.
+    processAll();
+
+    // Each of the transactions has made its own attempts.
+    for (int i = 0; i < ncrs.size(); ++i) {
+        EXPECT_EQ(dhcp_ddns::ST_FAILED, ncrs[i]->getStatus());
+        EXPECT_LT(0, transactions[i]->getUpdateAttempts());
+    }
+}
+
 }
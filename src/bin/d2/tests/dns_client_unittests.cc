@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2015 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -57,6 +57,7 @@ public:
     D2UpdateMessagePtr response_;
     DNSClient::Status status_;
     uint8_t receive_buffer_[MAX_SIZE];
+    DNSSocketPoolPtr socket_pool_;
     DNSClientPtr dns_client_;
     bool corrupt_response_;
     bool expect_response_;
@@ -133,6 +134,13 @@ public:
         }
     }
 
+    // @brief Makes the DNSClient use the socket pool for the exchanges.
+    void useSocketPool() {
+        socket_pool_.reset(new DNSSocketPool(service_));
+        dns_client_.reset(new DNSClient(response_, this, DNSClient::UDP,
+                                        socket_pool_));
+    }
+
     // @brief Handler invoked when test timeout is hit.
     //
     // This callback stops all running (hanging) tasks on IO service.
@@ -261,10 +269,11 @@ public:
     void runConstructorTest() {
         EXPECT_NO_THROW(DNSClient(response_, NULL, DNSClient::UDP));
 
-        // The TCP Transport is not supported right now. So, we return exception
-        // if caller specified TCP as a preferred protocol. This test will be
-        // removed once TCP is supported.
-        EXPECT_THROW(DNSClient(response_, NULL, DNSClient::TCP),
+        EXPECT_NO_THROW(DNSClient(response_, NULL, DNSClient::TCP));
+
+        // The out of range protocol is rejected.
+        EXPECT_THROW(DNSClient(response_, NULL,
+                               static_cast<DNSClient::Protocol>(2)),
                      isc::NotImplemented);
     }
 
@@ -542,6 +551,48 @@ TEST_F(DNSClientTest, sendReceiveTwice) {
     EXPECT_EQ(2, received_);
 }
 
+// Verify that the DNSClient using the socket pool reports a timeout when no
+// response is received from DNS.
+TEST_F(DNSClientTest, timeoutSocketPool) {
+    useSocketPool();
+    runSendNoReceiveTest();
+    EXPECT_EQ(0, socket_pool_->getPendingNum());
+}
+
+// Verify that the DNSClient using the socket pool receives the responses
+// and the sequential exchanges are carried out through the same socket.
+TEST_F(DNSClientTest, sendReceiveSocketPool) {
+    useSocketPool();
+    runSendReceiveTest(false, false);
+    runSendReceiveTest(true, false);
+    runSendReceiveTest(false, false);
+    EXPECT_EQ(3, received_);
+    EXPECT_EQ(1, socket_pool_->getSocketsNum(IOAddress(TEST_ADDRESS),
+                                             TEST_PORT));
+}
+
+// Verifies that the signed requests sent through the socket pool can be
+// verified and the signed responses are verified, even though the socket
+// pool changes the query ID of the signed request.
+TEST_F(DNSClientTest, runTSIGTestSocketPool) {
+    std::string secret ("key number one");
+    TSIGKeyPtr key_one;
+    ASSERT_NO_THROW(key_one.reset(new
+                                    TSIGKey(Name("one.com"),
+                                            TSIGKey::HMACMD5_NAME(),
+                                            secret.c_str(), secret.size())));
+    secret = "key number two";
+    TSIGKeyPtr key_two;
+    ASSERT_NO_THROW(key_two.reset(new
+                                    TSIGKey(Name("two.com"),
+                                            TSIGKey::HMACMD5_NAME(),
+                                            secret.c_str(), secret.size())));
+
+    useSocketPool();
+    runTSIGTest(key_one, key_one);
+    runTSIGTest(key_one, key_two, false);
+}
+
 // Verify that it is possible to use the DNSClient instance to perform the
 // following  sequence of message exchanges:
 // 1. send
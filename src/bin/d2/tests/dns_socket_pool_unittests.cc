@@ -0,0 +1,706 @@
+// Copyright (C) 2017 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <asiolink/asio_wrapper.h>
+#include <asiolink/interval_timer.h>
+#include <d2/dns_socket_pool.h>
+#include <util/io_utilities.h>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/ip/udp.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/bind.hpp>
+#include <boost/shared_ptr.hpp>
+#include <gtest/gtest.h>
+
+#include <set>
+#include <vector>
+
+using namespace isc;
+using namespace isc::asiodns;
+using namespace isc::asiolink;
+using namespace isc::d2;
+using namespace isc::util;
+using namespace boost::asio::ip;
+
+namespace {
+
+const char* TEST_ADDRESS = "127.0.0.1";
+const uint16_t TEST_PORT = 5301;
+const size_t MAX_SIZE = 1024;
+const long TEST_TIMEOUT = 5 * 1000;
+
+/// @brief Test DNS server.
+///
+/// Receives the messages and, once the configured number of messages has
+/// been received, sends them back in the reverse order.  The QR bit is set
+/// in each response, and the query ID is optionally altered.
+class TestServer {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// @param io_service IO service used to receive and send the messages.
+    /// @param respond_after Number of messages to receive before responding.
+    /// If 0, the server doesn't respond.
+    /// @param alter_qid Indicates if the query ID should be altered in the
+    /// responses.
+    TestServer(IOService& io_service, const size_t respond_after,
+               const bool alter_qid = false)
+        : socket_(io_service.get_io_service(), udp::v4()),
+          respond_after_(respond_after), alter_qid_(alter_qid) {
+        socket_.set_option(boost::asio::socket_base::reuse_address(true));
+        socket_.bind(udp::endpoint(address::from_string(TEST_ADDRESS),
+                                   TEST_PORT));
+        receive();
+    }
+
+    /// @brief Destructor.
+    ~TestServer() {
+        boost::system::error_code ec;
+        socket_.close(ec);
+    }
+
+    /// @brief Starts receiving the next message.
+    void receive() {
+        socket_.async_receive_from(boost::asio::buffer(buffer_, sizeof(buffer_)),
+                                   remote_,
+                                   boost::bind(&TestServer::receiveHandler,
+                                               this, _1, _2));
+    }
+
+    /// @brief Handler invoked when the message is received.
+    ///
+    /// @param ec Error code.
+    /// @param length Length of the received message.
+    void receiveHandler(const boost::system::error_code& ec,
+                        const size_t length) {
+        if (ec) {
+            return;
+        }
+
+        senders_.insert(remote_);
+        pending_.push_back(Message(remote_,
+                                   std::vector<uint8_t>(buffer_,
+                                                        buffer_ + length)));
+        if ((respond_after_ > 0) && (pending_.size() >= respond_after_)) {
+            for (std::vector<Message>::reverse_iterator msg = pending_.rbegin();
+                 msg != pending_.rend(); ++msg) {
+                std::vector<uint8_t>& data = msg->second;
+                data[2] |= 0x80;
+                if (alter_qid_) {
+                    ++data[1];
+                }
+                socket_.send_to(boost::asio::buffer(&data[0], data.size()),
+                                msg->first);
+            }
+            pending_.clear();
+        }
+        receive();
+    }
+
+    /// @brief Received message and its sender.
+    typedef std::pair<udp::endpoint, std::vector<uint8_t> > Message;
+
+    /// @brief Server socket.
+    udp::socket socket_;
+
+    /// @brief Receive buffer.
+    uint8_t buffer_[MAX_SIZE];
+
+    /// @brief Sender of the last message.
+    udp::endpoint remote_;
+
+    /// @brief Number of messages to receive before responding.
+    size_t respond_after_;
+
+    /// @brief Indicates if the query ID should be altered in the responses.
+    bool alter_qid_;
+
+    /// @brief Messages waiting for the responses.
+    std::vector<Message> pending_;
+
+    /// @brief Senders of all received messages.
+    std::set<udp::endpoint> senders_;
+};
+
+/// @brief Test DNS server accepting TCP connections.
+///
+/// Reads the length prefixed messages from each connection and, once the
+/// configured number of messages has been read from the connection, writes
+/// them back in the reverse order with the QR bit set.
+class TestTCPServer {
+public:
+
+    /// @brief Connection accepted by the server.
+    struct Connection {
+        /// @brief Constructor.
+        ///
+        /// @param io_service IO service used by the connection.
+        Connection(IOService& io_service)
+            : socket_(io_service.get_io_service()), data_(), pending_() {
+        }
+
+        /// @brief Connection socket.
+        tcp::socket socket_;
+
+        /// @brief Buffer receiving the length of the message.
+        uint8_t length_[2];
+
+        /// @brief Buffer receiving the message.
+        std::vector<uint8_t> data_;
+
+        /// @brief Messages waiting for the responses.
+        std::vector<std::vector<uint8_t> > pending_;
+    };
+
+    /// @brief Defines a pointer to the connection.
+    typedef boost::shared_ptr<Connection> ConnectionPtr;
+
+    /// @brief Constructor.
+    ///
+    /// @param io_service IO service used to accept the connections.
+    /// @param respond_after Number of messages to read from the connection
+    /// before responding.
+    /// @param drop_first Indicates if the first connection should be closed
+    /// by the server after reading the first message.
+    TestTCPServer(IOService& io_service, const size_t respond_after,
+                  const bool drop_first = false)
+        : io_service_(io_service), acceptor_(io_service.get_io_service()),
+          respond_after_(respond_after), drop_first_(drop_first),
+          connections_() {
+        tcp::endpoint endpoint(address::from_string(TEST_ADDRESS), TEST_PORT);
+        acceptor_.open(endpoint.protocol());
+        acceptor_.set_option(boost::asio::socket_base::reuse_address(true));
+        acceptor_.bind(endpoint);
+        acceptor_.listen();
+        accept();
+    }
+
+    /// @brief Destructor.
+    ~TestTCPServer() {
+        boost::system::error_code ec;
+        acceptor_.close(ec);
+        for (size_t i = 0; i < connections_.size(); ++i) {
+            connections_[i]->socket_.close(ec);
+        }
+    }
+
+    /// @brief Starts accepting the next connection.
+    void accept() {
+        ConnectionPtr conn(new Connection(io_service_));
+        acceptor_.async_accept(conn->socket_,
+                               boost::bind(&TestTCPServer::acceptHandler,
+                                           this, conn, _1));
+    }
+
+    /// @brief Handler invoked when the connection is accepted.
+    ///
+    /// @param conn Accepted connection.
+    /// @param ec Error code.
+    void acceptHandler(const ConnectionPtr& conn,
+                       const boost::system::error_code& ec) {
+        if (ec) {
+            return;
+        }
+        connections_.push_back(conn);
+        readLength(conn);
+        accept();
+    }
+
+    /// @brief Starts reading the length of the next message.
+    ///
+    /// @param conn Connection.
+    void readLength(const ConnectionPtr& conn) {
+        boost::asio::async_read(conn->socket_,
+                                boost::asio::buffer(conn->length_,
+                                                    sizeof(conn->length_)),
+                                boost::bind(&TestTCPServer::lengthHandler,
+                                            this, conn, _1));
+    }
+
+    /// @brief Handler invoked when the length of the message has been read.
+    ///
+    /// @param conn Connection.
+    /// @param ec Error code.
+    void lengthHandler(const ConnectionPtr& conn,
+                       const boost::system::error_code& ec) {
+        if (ec) {
+            return;
+        }
+        conn->data_.resize(readUint16(conn->length_, sizeof(conn->length_)));
+        boost::asio::async_read(conn->socket_,
+                                boost::asio::buffer(&conn->data_[0],
+                                                    conn->data_.size()),
+                                boost::bind(&TestTCPServer::messageHandler,
+                                            this, conn, _1));
+    }
+
+    /// @brief Handler invoked when the message has been read.
+    ///
+    /// @param conn Connection.
+    /// @param ec Error code.
+    void messageHandler(const ConnectionPtr& conn,
+                        const boost::system::error_code& ec) {
+        if (ec) {
+            return;
+        }
+
+        if (drop_first_) {
+            drop_first_ = false;
+            conn->socket_.close();
+            return;
+        }
+
+        conn->pending_.push_back(conn->data_);
+        if (conn->pending_.size() >= respond_after_) {
+            for (size_t i = conn->pending_.size(); i > 0; --i) {
+                std::vector<uint8_t>& data = conn->pending_[i - 1];
+                data[2] |= 0x80;
+                uint8_t length[2];
+                writeUint16(data.size(), length, sizeof(length));
+                boost::asio::write(conn->socket_,
+                                   boost::asio::buffer(length, sizeof(length)));
+                boost::asio::write(conn->socket_,
+                                   boost::asio::buffer(&data[0], data.size()));
+            }
+            conn->pending_.clear();
+        }
+        readLength(conn);
+    }
+
+    /// @brief IO service.
+    IOService& io_service_;
+
+    /// @brief Acceptor of the connections.
+    tcp::acceptor acceptor_;
+
+    /// @brief Number of messages to read before responding.
+    size_t respond_after_;
+
+    /// @brief Indicates if the first connection should be dropped.
+    bool drop_first_;
+
+    /// @brief Accepted connections.
+    std::vector<ConnectionPtr> connections_;
+};
+
+/// @brief Test fixture class for the @c DNSSocketPool.
+class DNSSocketPoolTest : public ::testing::Test {
+public:
+
+    /// @brief Exchange completion callback.
+    class Callback : public IOFetch::Callback {
+    public:
+        /// @brief Constructor.
+        ///
+        /// @param test Test fixture.
+        Callback(DNSSocketPoolTest* test) : test_(test), results_() {
+        }
+
+        /// @brief Records the result and stops the IO service when all
+        /// expected exchanges have completed.
+        ///
+        /// @param result Result of the exchange.
+        virtual void operator()(IOFetch::Result result) {
+            results_.push_back(result);
+            test_->exchangeCompleted();
+        }
+
+        /// @brief Test fixture.
+        DNSSocketPoolTest* test_;
+
+        /// @brief Results of the exchanges.
+        std::vector<IOFetch::Result> results_;
+    };
+
+    /// @brief Constructor.
+    DNSSocketPoolTest()
+        : service_(), test_timer_(service_), completed_(0), expected_(0) {
+    }
+
+    /// @brief Counts the completed exchanges and stops the IO service when
+    /// all expected exchanges have completed.
+    void exchangeCompleted() {
+        if (++completed_ == expected_) {
+            service_.stop();
+        }
+    }
+
+    /// @brief Handler invoked when test timeout is hit.
+    void testTimeoutHandler() {
+        service_.stop();
+        FAIL() << "Test timeout hit.";
+    }
+
+    /// @brief Runs the IO service until the expected number of exchanges
+    /// completes.
+    ///
+    /// @param expected Number of exchanges expected to complete.
+    void run(const size_t expected) {
+        expected_ = expected;
+        test_timer_.setup(boost::bind(&DNSSocketPoolTest::testTimeoutHandler,
+                                      this), TEST_TIMEOUT);
+        service_.run();
+        test_timer_.cancel();
+        service_.get_io_service().reset();
+    }
+
+    /// @brief Runs the IO service for the specified time.
+    ///
+    /// @param timeout Time in milliseconds.
+    void runFor(const long timeout) {
+        IntervalTimer timer(service_);
+        timer.setup(boost::bind(&IOService::stop, &service_), timeout,
+                    IntervalTimer::ONE_SHOT);
+        service_.run();
+        service_.get_io_service().reset();
+    }
+
+    /// @brief Creates the message to be sent.
+    ///
+    /// @param payload Byte distinguishing the message.
+    OutputBufferPtr createMessage(const uint8_t payload) {
+        OutputBufferPtr msg(new OutputBuffer(MAX_SIZE));
+        // Header with a zero query ID followed by the payload.
+        for (size_t i = 0; i < 12; ++i) {
+            msg->writeUint8(0);
+        }
+        msg->writeUint8(payload);
+        return (msg);
+    }
+
+    /// @brief IO service.
+    IOService service_;
+
+    /// @brief Timer breaking the test if it hangs.
+    IntervalTimer test_timer_;
+
+    /// @brief Number of completed exchanges.
+    size_t completed_;
+
+    /// @brief Number of exchanges expected to complete.
+    size_t expected_;
+};
+
+// Verifies that the number of sockets per server must not be 0 and the
+// TCP idle timeout must not be negative.
+TEST_F(DNSSocketPoolTest, constructor) {
+    EXPECT_THROW(DNSSocketPool(service_, 0), DNSSocketPoolError);
+    EXPECT_THROW(DNSSocketPool(service_, 1, -1), DNSSocketPoolError);
+    EXPECT_NO_THROW(DNSSocketPool(service_, 1));
+    EXPECT_NO_THROW(DNSSocketPool(service_, 1, 0));
+}
+
+// Verifies that the message is sent and the response received.
+TEST_F(DNSSocketPoolTest, sendReceive) {
+    TestServer server(service_, 1);
+    DNSSocketPool pool(service_);
+    Callback callback(this);
+
+    OutputBufferPtr msg = createMessage(7);
+    OutputBufferPtr response(new OutputBuffer(MAX_SIZE));
+    ASSERT_NO_THROW(pool.send(IOAddress(TEST_ADDRESS), TEST_PORT, msg,
+                              response, &callback, 1000));
+    EXPECT_EQ(1, pool.getPendingNum());
+    run(1);
+
+    ASSERT_EQ(1, callback.results_.size());
+    EXPECT_EQ(IOFetch::SUCCESS, callback.results_[0]);
+    EXPECT_EQ(0, pool.getPendingNum());
+
+    // The response holds the query ID written by the pool in the request.
+    ASSERT_EQ(msg->getLength(), response->getLength());
+    EXPECT_EQ(readUint16(msg->getData(), msg->getLength()),
+              readUint16(response->getData(), response->getLength()));
+    EXPECT_EQ(7, (*response)[12]);
+
+    // The message is too short to hold the query ID.
+    EXPECT_THROW(pool.send(IOAddress(TEST_ADDRESS), TEST_PORT,
+                           OutputBufferPtr(new OutputBuffer(1)),
+                           response, &callback, 1000),
+                 DNSSocketPoolError);
+}
+
+// Verifies that the sequential exchanges reuse the same socket.
+TEST_F(DNSSocketPoolTest, reuseSocket) {
+    TestServer server(service_, 1);
+    DNSSocketPool pool(service_);
+    Callback callback(this);
+
+    OutputBufferPtr response(new OutputBuffer(MAX_SIZE));
+    for (uint8_t i = 0; i < 3; ++i) {
+        ASSERT_NO_THROW(pool.send(IOAddress(TEST_ADDRESS), TEST_PORT,
+                                  createMessage(i), response, &callback,
+                                  1000));
+        run(i + 1);
+        EXPECT_EQ(i, (*response)[12]);
+    }
+
+    ASSERT_EQ(3, callback.results_.size());
+    for (size_t i = 0; i < callback.results_.size(); ++i) {
+        EXPECT_EQ(IOFetch::SUCCESS, callback.results_[i]);
+    }
+    EXPECT_EQ(1, pool.getSocketsNum(IOAddress(TEST_ADDRESS), TEST_PORT));
+    EXPECT_EQ(1, server.senders_.size());
+}
+
+// Verifies that the concurrent exchanges share the limited number of
+// sockets and the responses are matched to the exchanges.
+TEST_F(DNSSocketPoolTest, concurrentExchanges) {
+    const size_t exchanges_num = 10;
+    TestServer server(service_, exchanges_num);
+    DNSSocketPool pool(service_, 2);
+    std::vector<boost::shared_ptr<Callback> > callbacks;
+    std::vector<OutputBufferPtr> responses;
+
+    for (size_t i = 0; i < exchanges_num; ++i) {
+        callbacks.push_back(boost::shared_ptr<Callback>(new Callback(this)));
+        responses.push_back(OutputBufferPtr(new OutputBuffer(MAX_SIZE)));
+        ASSERT_NO_THROW(pool.send(IOAddress(TEST_ADDRESS), TEST_PORT,
+                                  createMessage(i), responses[i],
+                                  callbacks[i].get(), 1000));
+    }
+    EXPECT_EQ(exchanges_num, pool.getPendingNum());
+    EXPECT_EQ(2, pool.getSocketsNum(IOAddress(TEST_ADDRESS), TEST_PORT));
+    run(exchanges_num);
+
+    for (size_t i = 0; i < exchanges_num; ++i) {
+        ASSERT_EQ(1, callbacks[i]->results_.size());
+        EXPECT_EQ(IOFetch::SUCCESS, callbacks[i]->results_[0]);
+        ASSERT_EQ(13, responses[i]->getLength());
+        EXPECT_EQ(i, (*responses[i])[12]);
+    }
+    EXPECT_EQ(2, server.senders_.size());
+    EXPECT_EQ(0, pool.getPendingNum());
+}
+
+// Verifies that the timeout is reported when there is no response.
+TEST_F(DNSSocketPoolTest, timeout) {
+    DNSSocketPool pool(service_);
+    Callback callback(this);
+
+    OutputBufferPtr response(new OutputBuffer(MAX_SIZE));
+    ASSERT_NO_THROW(pool.send(IOAddress(TEST_ADDRESS), TEST_PORT,
+                              createMessage(1), response, &callback, 100));
+    run(1);
+
+    ASSERT_EQ(1, callback.results_.size());
+    EXPECT_EQ(IOFetch::TIME_OUT, callback.results_[0]);
+    EXPECT_EQ(0, pool.getPendingNum());
+}
+
+// Verifies that the response with an unexpected query ID is dropped.
+TEST_F(DNSSocketPoolTest, unexpectedQid) {
+    TestServer server(service_, 1, true);
+    DNSSocketPool pool(service_);
+    Callback callback(this);
+
+    OutputBufferPtr response(new OutputBuffer(MAX_SIZE));
+    ASSERT_NO_THROW(pool.send(IOAddress(TEST_ADDRESS), TEST_PORT,
+                              createMessage(1), response, &callback, 200));
+    run(1);
+
+    ASSERT_EQ(1, callback.results_.size());
+    EXPECT_EQ(IOFetch::TIME_OUT, callback.results_[0]);
+    EXPECT_EQ(0, response->getLength());
+}
+
+// Verifies that the canceled exchange is not sent and its callback is not
+// invoked.
+TEST_F(DNSSocketPoolTest, cancel) {
+    TestServer server(service_, 1);
+    DNSSocketPool pool(service_);
+    Callback canceled(this);
+    Callback callback(this);
+
+    OutputBufferPtr response(new OutputBuffer(MAX_SIZE));
+    DNSSocketPool::ExchangeId exchange_id = 0;
+    ASSERT_NO_THROW(exchange_id = pool.send(IOAddress(TEST_ADDRESS), TEST_PORT,
+                                            createMessage(1), response,
+                                            &canceled, 1000));
+    ASSERT_NO_THROW(pool.send(IOAddress(TEST_ADDRESS), TEST_PORT,
+                              createMessage(2), response, &callback, 1000));
+    pool.cancel(exchange_id);
+    EXPECT_EQ(1, pool.getPendingNum());
+
+    // Canceling the exchange again does nothing.
+    pool.cancel(exchange_id);
+    EXPECT_EQ(1, pool.getPendingNum());
+    run(1);
+
+    EXPECT_TRUE(canceled.results_.empty());
+    ASSERT_EQ(1, callback.results_.size());
+    EXPECT_EQ(IOFetch::SUCCESS, callback.results_[0]);
+    EXPECT_EQ(2, (*response)[12]);
+}
+
+// Verifies that the concurrent exchanges over TCP are pipelined over
+// a single connection and the responses are matched to the exchanges.
+TEST_F(DNSSocketPoolTest, tcpPipelining) {
+    const size_t exchanges_num = 5;
+    TestTCPServer server(service_, exchanges_num);
+    DNSSocketPool pool(service_);
+    std::vector<boost::shared_ptr<Callback> > callbacks;
+    std::vector<OutputBufferPtr> responses;
+
+    for (size_t i = 0; i < exchanges_num; ++i) {
+        callbacks.push_back(boost::shared_ptr<Callback>(new Callback(this)));
+        responses.push_back(OutputBufferPtr(new OutputBuffer(MAX_SIZE)));
+        ASSERT_NO_THROW(pool.send(IOAddress(TEST_ADDRESS), TEST_PORT,
+                                  createMessage(i), responses[i],
+                                  callbacks[i].get(), 1000, IOFetch::TCP));
+    }
+    EXPECT_EQ(exchanges_num, pool.getPendingNum());
+    EXPECT_EQ(1, pool.getSocketsNum(IOAddress(TEST_ADDRESS), TEST_PORT,
+                                    IOFetch::TCP));
+    EXPECT_EQ(0, pool.getSocketsNum(IOAddress(TEST_ADDRESS), TEST_PORT));
+    run(exchanges_num);
+
+    for (size_t i = 0; i < exchanges_num; ++i) {
+        ASSERT_EQ(1, callbacks[i]->results_.size());
+        EXPECT_EQ(IOFetch::SUCCESS, callbacks[i]->results_[0]);
+        ASSERT_EQ(13, responses[i]->getLength());
+        EXPECT_EQ(i, (*responses[i])[12]);
+    }
+    EXPECT_EQ(1, server.connections_.size());
+    EXPECT_TRUE(pool.isConnected(IOAddress(TEST_ADDRESS), TEST_PORT));
+
+    // The next exchange reuses the connection.
+    Callback callback(this);
+    completed_ = 0;
+    ASSERT_NO_THROW(pool.send(IOAddress(TEST_ADDRESS), TEST_PORT,
+                              createMessage(9), responses[0], &callback,
+                              1000, IOFetch::TCP));
+    server.respond_after_ = 1;
+    run(1);
+    ASSERT_EQ(1, callback.results_.size());
+    EXPECT_EQ(IOFetch::SUCCESS, callback.results_[0]);
+    EXPECT_EQ(9, (*responses[0])[12]);
+    EXPECT_EQ(1, server.connections_.size());
+}
+
+// Verifies that canceling the exchange whose message is being written
+// over TCP doesn't affect the messages of the other exchanges.
+TEST_F(DNSSocketPoolTest, tcpCancelWhileWriting) {
+    TestTCPServer server(service_, 1);
+    DNSSocketPool pool(service_);
+    Callback canceled(this);
+    Callback callback(this);
+
+    std::vector<OutputBufferPtr> responses;
+    for (size_t i = 0; i < 3; ++i) {
+        responses.push_back(OutputBufferPtr(new OutputBuffer(MAX_SIZE)));
+    }
+    ASSERT_NO_THROW(pool.send(IOAddress(TEST_ADDRESS), TEST_PORT,
+                              createMessage(1), responses[0], &callback,
+                              1000, IOFetch::TCP));
+    DNSSocketPool::ExchangeId exchange_id = 0;
+    ASSERT_NO_THROW(exchange_id = pool.send(IOAddress(TEST_ADDRESS), TEST_PORT,
+                                            createMessage(2), responses[1],
+                                            &canceled, 1000, IOFetch::TCP));
+
+    // The write of the first message starts when the connection is
+    // established.
+    for (size_t i = 0; (i < 10) &&
+             !pool.isConnected(IOAddress(TEST_ADDRESS), TEST_PORT); ++i) {
+        service_.get_io_service().run_one();
+    }
+    ASSERT_TRUE(pool.isConnected(IOAddress(TEST_ADDRESS), TEST_PORT));
+
+    // The handlers run in order: the completion of the first write starts
+    // writing the second message, whose exchange is then canceled before
+    // the third message is queued.
+    service_.post(boost::bind(&DNSSocketPool::cancel, &pool, exchange_id));
+    ASSERT_NO_THROW(pool.send(IOAddress(TEST_ADDRESS), TEST_PORT,
+                              createMessage(3), responses[2], &callback,
+                              1000, IOFetch::TCP));
+    run(2);
+
+    EXPECT_TRUE(canceled.results_.empty());
+    ASSERT_EQ(2, callback.results_.size());
+    EXPECT_EQ(IOFetch::SUCCESS, callback.results_[0]);
+    EXPECT_EQ(IOFetch::SUCCESS, callback.results_[1]);
+    EXPECT_EQ(1, (*responses[0])[12]);
+    EXPECT_EQ(3, (*responses[2])[12]);
+    EXPECT_EQ(1, server.connections_.size());
+}
+
+// Verifies that the idle TCP connection is closed and established again
+// for the next exchange.
+TEST_F(DNSSocketPoolTest, tcpIdleTimeout) {
+    TestTCPServer server(service_, 1);
+    DNSSocketPool pool(service_, 1, 50);
+    Callback callback(this);
+
+    OutputBufferPtr response(new OutputBuffer(MAX_SIZE));
+    ASSERT_NO_THROW(pool.send(IOAddress(TEST_ADDRESS), TEST_PORT,
+                              createMessage(1), response, &callback, 1000,
+                              IOFetch::TCP));
+    run(1);
+    EXPECT_TRUE(pool.isConnected(IOAddress(TEST_ADDRESS), TEST_PORT));
+
+    runFor(200);
+    EXPECT_FALSE(pool.isConnected(IOAddress(TEST_ADDRESS), TEST_PORT));
+
+    ASSERT_NO_THROW(pool.send(IOAddress(TEST_ADDRESS), TEST_PORT,
+                              createMessage(2), response, &callback, 1000,
+                              IOFetch::TCP));
+    run(2);
+    ASSERT_EQ(2, callback.results_.size());
+    EXPECT_EQ(IOFetch::SUCCESS, callback.results_[1]);
+    EXPECT_EQ(2, (*response)[12]);
+    EXPECT_EQ(2, server.connections_.size());
+}
+
+// Verifies that the exchange fails when the TCP connection is lost after
+// sending its message and that the next exchange reconnects.
+TEST_F(DNSSocketPoolTest, tcpConnectionLost) {
+    TestTCPServer server(service_, 1, true);
+    DNSSocketPool pool(service_);
+    Callback callback(this);
+
+    OutputBufferPtr response(new OutputBuffer(MAX_SIZE));
+    ASSERT_NO_THROW(pool.send(IOAddress(TEST_ADDRESS), TEST_PORT,
+                              createMessage(1), response, &callback, 1000,
+                              IOFetch::TCP));
+    run(1);
+    ASSERT_EQ(1, callback.results_.size());
+    EXPECT_EQ(IOFetch::NOTSET, callback.results_[0]);
+    EXPECT_FALSE(pool.isConnected(IOAddress(TEST_ADDRESS), TEST_PORT));
+
+    ASSERT_NO_THROW(pool.send(IOAddress(TEST_ADDRESS), TEST_PORT,
+                              createMessage(2), response, &callback, 1000,
+                              IOFetch::TCP));
+    run(2);
+    ASSERT_EQ(2, callback.results_.size());
+    EXPECT_EQ(IOFetch::SUCCESS, callback.results_[1]);
+    EXPECT_EQ(2, (*response)[12]);
+    EXPECT_EQ(2, server.connections_.size());
+}
+
+// Verifies that the pending exchanges fail when the TCP connection can't
+// be established.
+TEST_F(DNSSocketPoolTest, tcpConnectFailed) {
+    DNSSocketPool pool(service_);
+    Callback callback(this);
+
+    OutputBufferPtr response(new OutputBuffer(MAX_SIZE));
+    for (uint8_t i = 0; i < 2; ++i) {
+        ASSERT_NO_THROW(pool.send(IOAddress(TEST_ADDRESS), TEST_PORT,
+                                  createMessage(i), response, &callback,
+                                  1000, IOFetch::TCP));
+    }
+    run(2);
+
+    ASSERT_EQ(2, callback.results_.size());
+    EXPECT_EQ(IOFetch::NOTSET, callback.results_[0]);
+    EXPECT_EQ(IOFetch::NOTSET, callback.results_[1]);
+    EXPECT_EQ(0, pool.getPendingNum());
+}
+
+}
@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -441,6 +441,44 @@ TEST_F(NameAddTransactionTest, readyHandler) {
     EXPECT_THROW(name_add->readyHandler(), NameAddTransactionError);
 }
 
+// Tests the initial forward update support used by the update coalescing.
+// It verifies that:
+// 1. The initial forward request is built without being stored in the
+// transaction
+// 2. A forward only transaction started after the initial forward update
+// completes without sending any update
+// 3. A forward and reverse transaction started after the initial forward
+// update proceeds with the reverse update
+TEST_F(NameAddTransactionTest, startTransactionAfterInitialFwd) {
+    NameAddStubPtr name_add;
+    D2UpdateMessagePtr request;
+
+    // Verify that the request is built and returned.
+    ASSERT_NO_THROW(name_add = makeTransaction4(FORWARD_CHG));
+    ASSERT_NO_THROW(request = name_add->buildInitialFwdRequest());
+    ASSERT_TRUE(request);
+    EXPECT_FALSE(name_add->getDnsUpdateRequest());
+    checkRRCount(request, D2UpdateMessage::SECTION_PREREQUISITE, 1);
+    checkRRCount(request, D2UpdateMessage::SECTION_UPDATE, 2);
+
+    // Verify that the forward only transaction completes right away.
+    ASSERT_NO_THROW(name_add->startTransactionAfterInitialFwd());
+    EXPECT_TRUE(name_add->isModelDone());
+    EXPECT_FALSE(name_add->didModelFail());
+    EXPECT_TRUE(name_add->getForwardChangeCompleted());
+    EXPECT_EQ(0, name_add->getUpdateAttempts());
+    EXPECT_EQ(dhcp_ddns::ST_COMPLETED, name_add->getNcrStatus());
+
+    // Verify that the forward and reverse transaction sends the reverse
+    // update.
+    ASSERT_NO_THROW(name_add = makeTransaction4(FWD_AND_REV_CHG));
+    ASSERT_NO_THROW(name_add->startTransactionAfterInitialFwd());
+    EXPECT_TRUE(name_add->isModelWaiting());
+    EXPECT_TRUE(name_add->getForwardChangeCompleted());
+    EXPECT_EQ(NameAddTransaction::REPLACING_REV_PTRS_ST,
+              name_add->getCurrState());
+}
+
 // Tests the selectingFwdServerHandler functionality.
 // It verifies behavior for the following scenarios:
 //
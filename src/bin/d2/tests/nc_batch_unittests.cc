@@ -0,0 +1,213 @@
+// Copyright (C) 2017 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <asiolink/io_service.h>
+#include <d2/nc_add.h>
+#include <d2/nc_batch.h>
+#include <d2/nc_remove.h>
+#include <nc_test_utils.h>
+
+#include <gtest/gtest.h>
+#include <string>
+
+using namespace std;
+using namespace isc;
+using namespace isc::d2;
+
+namespace {
+
+/// @brief Test fixture for testing NameChangeBatch.
+class NameChangeBatchTest : public TimedIO, public ::testing::Test {
+public:
+    D2CfgMgrPtr cfg_mgr_;
+    DdnsDomainPtr forward_domain_;
+    DdnsDomainPtr reverse_domain_;
+
+    /// @brief Constructor
+    ///
+    /// Creates the forward domain "example.com." with a single server.
+    NameChangeBatchTest() : cfg_mgr_(new D2CfgMgr()) {
+        forward_domain_ = makeDomain("example.com.");
+        addDomainServer(forward_domain_, "forward.example.com");
+    }
+
+    /// @brief Creates a forward only transaction for the given FQDN.
+    ///
+    /// @param change_type type of the change
+    /// @param fqdn FQDN of the request
+    /// @param dhcid DHCID of the request
+    NameChangeTransactionPtr
+    makeTransaction(const dhcp_ddns::NameChangeType change_type,
+                    const std::string& fqdn, const std::string& dhcid) {
+        const char* msg_str =
+            "{"
+            " \"change-type\" : 0 , "
+            " \"forward-change\" : true , "
+            " \"reverse-change\" : false , "
+            " \"fqdn\" : \"my.example.com.\" , "
+            " \"ip-address\" : \"192.168.2.1\" , "
+            " \"dhcid\" : \"0102030405060708\" , "
+            " \"lease-expires-on\" : \"20130121132405\" , "
+            " \"lease-length\" : 1300 "
+            "}";
+
+        dhcp_ddns::NameChangeRequestPtr ncr = makeNcrFromString(msg_str);
+        ncr->setChangeType(change_type);
+        ncr->setFqdn(fqdn);
+        ncr->setDhcid(dhcid);
+
+        NameChangeTransactionPtr trans;
+        if (change_type == dhcp_ddns::CHG_ADD) {
+            trans.reset(new NameAddTransaction(io_service_, ncr,
+                                               forward_domain_,
+                                               reverse_domain_, cfg_mgr_));
+        } else {
+            trans.reset(new NameRemoveTransaction(io_service_, ncr,
+                                                  forward_domain_,
+                                                  reverse_domain_, cfg_mgr_));
+        }
+
+        return (trans);
+    }
+};
+
+/// @brief Tests NameChangeBatch construction.
+/// This test verifies that:
+/// 1. Construction with an empty IO service is not allowed
+/// 2. Construction with an empty forward domain is not allowed
+/// 3. Construction with an empty configuration manager is not allowed
+/// 4. Valid construction functions properly
+TEST_F(NameChangeBatchTest, construction) {
+    asiolink::IOServicePtr empty_io_service;
+    DdnsDomainPtr empty_domain;
+    D2CfgMgrPtr empty_cfg_mgr;
+    DNSSocketPoolPtr socket_pool;
+
+    EXPECT_THROW(NameChangeBatch(empty_io_service, forward_domain_, cfg_mgr_,
+                                 socket_pool), NameChangeBatchError);
+    EXPECT_THROW(NameChangeBatch(io_service_, empty_domain, cfg_mgr_,
+                                 socket_pool), NameChangeBatchError);
+    EXPECT_THROW(NameChangeBatch(io_service_, forward_domain_, empty_cfg_mgr,
+                                 socket_pool), NameChangeBatchError);
+
+    NameChangeBatchPtr batch;
+    ASSERT_NO_THROW(batch.reset(new NameChangeBatch(io_service_,
+                                                    forward_domain_,
+                                                    cfg_mgr_, socket_pool)));
+    EXPECT_FALSE(batch->isDone());
+    EXPECT_EQ(0, batch->getTransactionCount());
+    EXPECT_FALSE(batch->getDnsUpdateRequest());
+}
+
+/// @brief Tests adding transactions to a batch.
+/// This test verifies that only the transactions for the batch's forward
+/// domain may be added and only until the batch is started.
+TEST_F(NameChangeBatchTest, addTransaction) {
+    NameChangeBatch batch(io_service_, forward_domain_, cfg_mgr_,
+                          DNSSocketPoolPtr());
+
+    EXPECT_THROW(batch.addTransaction(NameChangeTransactionPtr()),
+                 NameChangeBatchError);
+
+    // A transaction for another domain is refused.
+    DdnsDomainPtr domain = forward_domain_;
+    forward_domain_ = makeDomain("example.org.");
+    NameChangeTransactionPtr trans = makeTransaction(dhcp_ddns::CHG_ADD,
+                                                     "one.example.org.",
+                                                     "010101");
+    EXPECT_THROW(batch.addTransaction(trans), NameChangeBatchError);
+    forward_domain_ = domain;
+
+    trans = makeTransaction(dhcp_ddns::CHG_ADD, "one.example.com.", "010101");
+    EXPECT_NO_THROW(batch.addTransaction(trans));
+    EXPECT_EQ(1, batch.getTransactionCount());
+
+    // A single transaction is started on its own.
+    ASSERT_NO_THROW(batch.start());
+    EXPECT_TRUE(batch.isDone());
+    EXPECT_FALSE(batch.getDnsUpdateRequest());
+    EXPECT_TRUE(trans->isModelWaiting());
+
+    trans = makeTransaction(dhcp_ddns::CHG_ADD, "two.example.com.", "020202");
+    EXPECT_THROW(batch.addTransaction(trans), NameChangeBatchError);
+    EXPECT_THROW(batch.start(), NameChangeBatchError);
+}
+
+/// @brief Tests the coalesced update of the additions.
+/// This test verifies that the batch merges the initial forward updates of
+/// the transactions into a single request for the zone, and that the
+/// transactions complete once the server accepts it.
+TEST_F(NameChangeBatchTest, coalescedAdd) {
+    NameChangeBatch batch(io_service_, forward_domain_, cfg_mgr_,
+                          DNSSocketPoolPtr());
+    NameChangeTransactionPtr trans1 =
+        makeTransaction(dhcp_ddns::CHG_ADD, "one.example.com.", "010101");
+    NameChangeTransactionPtr trans2 =
+        makeTransaction(dhcp_ddns::CHG_ADD, "two.example.com.", "020202");
+    ASSERT_NO_THROW(batch.addTransaction(trans1));
+    ASSERT_NO_THROW(batch.addTransaction(trans2));
+
+    // Create a server and start it listening.
+    FauxServer server(*io_service_, *(*forward_domain_->getServers())[0]);
+    server.receive(FauxServer::USE_RCODE, dns::Rcode::NOERROR());
+
+    ASSERT_NO_THROW(batch.start());
+    EXPECT_FALSE(batch.isDone());
+    EXPECT_TRUE(trans1->isModelNew());
+    EXPECT_TRUE(trans2->isModelNew());
+
+    // Verify the coalesced request.
+    D2UpdateMessagePtr request = batch.getDnsUpdateRequest();
+    ASSERT_TRUE(request);
+    checkZone(request, "example.com.");
+    checkRRCount(request, D2UpdateMessage::SECTION_PREREQUISITE, 2);
+    checkRRCount(request, D2UpdateMessage::SECTION_UPDATE, 4);
+
+    // Run IO until the transactions are done.
+    while (!trans1->isModelDone() || !trans2->isModelDone()) {
+        ASSERT_LT(0, runTimedIO(500));
+    }
+
+    EXPECT_TRUE(batch.isDone());
+    EXPECT_EQ(dhcp_ddns::ST_COMPLETED, trans1->getNcrStatus());
+    EXPECT_EQ(dhcp_ddns::ST_COMPLETED, trans2->getNcrStatus());
+    EXPECT_TRUE(trans1->getForwardChangeCompleted());
+    EXPECT_TRUE(trans2->getForwardChangeCompleted());
+}
+
+/// @brief Tests the fallback of the coalesced update.
+/// This test verifies that the transactions are started on their own when
+/// the server rejects the coalesced update.
+TEST_F(NameChangeBatchTest, rejectedUpdate) {
+    NameChangeBatch batch(io_service_, forward_domain_, cfg_mgr_,
+                          DNSSocketPoolPtr());
+    NameChangeTransactionPtr trans1 =
+        makeTransaction(dhcp_ddns::CHG_REMOVE, "one.example.com.", "010101");
+    NameChangeTransactionPtr trans2 =
+        makeTransaction(dhcp_ddns::CHG_REMOVE, "two.example.com.", "020202");
+    ASSERT_NO_THROW(batch.addTransaction(trans1));
+    ASSERT_NO_THROW(batch.addTransaction(trans2));
+
+    // Create a server which refuses the updates.
+    FauxServer server(*io_service_, *(*forward_domain_->getServers())[0]);
+    server.receive(FauxServer::USE_RCODE, dns::Rcode::REFUSED());
+
+    ASSERT_NO_THROW(batch.start());
+    while (!batch.isDone()) {
+        ASSERT_LT(0, runTimedIO(500));
+    }
+
+    // The transactions send their own updates.
+    EXPECT_TRUE(trans1->isModelWaiting());
+    EXPECT_TRUE(trans2->isModelWaiting());
+    EXPECT_EQ(NameRemoveTransaction::REMOVING_FWD_ADDRS_ST,
+              trans1->getCurrState());
+    EXPECT_EQ(NameRemoveTransaction::REMOVING_FWD_ADDRS_ST,
+              trans2->getCurrState());
+}
+
+}
@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -443,6 +443,32 @@ TEST_F(NameRemoveTransactionTest, readyHandler) {
 }
 
 
+// Tests the initial forward update support used by the update coalescing.
+// It verifies that:
+// 1. The initial forward request is built without being stored in the
+// transaction
+// 2. A transaction started after the initial forward update proceeds with
+// the removal of the remaining forward RRs
+TEST_F(NameRemoveTransactionTest, startTransactionAfterInitialFwd) {
+    NameRemoveStubPtr name_remove;
+    D2UpdateMessagePtr request;
+
+    // Verify that the request is built and returned.
+    ASSERT_NO_THROW(name_remove = makeTransaction4(FORWARD_CHG));
+    ASSERT_NO_THROW(request = name_remove->buildInitialFwdRequest());
+    ASSERT_TRUE(request);
+    EXPECT_FALSE(name_remove->getDnsUpdateRequest());
+    checkRRCount(request, D2UpdateMessage::SECTION_PREREQUISITE, 1);
+    checkRRCount(request, D2UpdateMessage::SECTION_UPDATE, 1);
+
+    // Verify that the transaction skips the removal of the address.
+    ASSERT_NO_THROW(name_remove->startTransactionAfterInitialFwd());
+    EXPECT_TRUE(name_remove->isModelWaiting());
+    EXPECT_EQ(NameRemoveTransaction::REMOVING_FWD_RRS_ST,
+              name_remove->getCurrState());
+    EXPECT_EQ(1, name_remove->getUpdateAttempts());
+}
+
 // Tests the selectingFwdServerHandler functionality.
 // It verifies behavior for the following scenarios:
 //
@@ -13,6 +13,8 @@
 #include <dhcp4/json_config_parser.h>
 #include <dhcpsrv/cfgmgr.h>
 #include <dhcpsrv/cfg_db_access.h>
+#include <dhcpsrv/host_cmds.h>
+#include <dhcpsrv/lease_cmds.h>
 #include <config/command_mgr.h>
 #include <stats/stats_mgr.h>
 
@@ -220,6 +222,10 @@ ControlledDhcpv4Srv::processConfig(isc::data::ConstElementPtr config) {
         return (isc::config::createAnswer(1, err.str()));
     }
 
+    // Stop the thread reclaiming the expired leases, if it is running. It
+    // is started again if the new configuration enables it.
+    srv->reclamation_worker_.reset();
+
     ConstElementPtr answer = configureDhcp4Server(*srv, config);
 
     // Check that configuration was successful. If not, do not reopen sockets
@@ -275,12 +281,30 @@ ControlledDhcpv4Srv::processConfig(isc::data::ConstElementPtr config) {
     CfgMgr::instance().getStagingCfg()->getCfgIface()->
         openSockets(AF_INET, srv->getPort(), getInstance()->useBroadcast());
 
+    // Reclaim the expired leases in the background thread, if enabled. The
+    // timers are used instead when the thread can't be started, e.g. for
+    // the memfile backend or when the reclamation callouts are installed.
+    CfgExpirationPtr cfg_expiration =
+        CfgMgr::instance().getStagingCfg()->getCfgExpiration();
+    if (cfg_expiration->getReclaimThread()) {
+        try {
+            LeaseReclamationWorkerPtr worker(new LeaseReclamationWorker(false,
+                srv->alloc_engine_, *cfg_expiration));
+            worker->start();
+            srv->reclamation_worker_ = worker;
+        } catch (const std::exception& ex) {
+            LOG_WARN(dhcp4_logger, DHCP4_RECLAIM_THREAD_FAILED).arg(ex.what());
+        }
+    }
+
     // Install the timers for handling leases reclamation.
     try {
-        CfgMgr::instance().getStagingCfg()->getCfgExpiration()->
-            setupTimers(&ControlledDhcpv4Srv::reclaimExpiredLeases,
-                        &ControlledDhcpv4Srv::deleteExpiredReclaimedLeases,
-                        server_);
+        if (!srv->reclamation_worker_) {
+            cfg_expiration->
+                setupTimers(&ControlledDhcpv4Srv::reclaimExpiredLeases,
+                            &ControlledDhcpv4Srv::deleteExpiredReclaimedLeases,
+                            server_);
+        }
 
     } catch (const std::exception& ex) {
         err << "unable to setup timers for periodically running the"
@@ -326,6 +350,32 @@ ControlledDhcpv4Srv::ControlledDhcpv4Srv(uint16_t port /*= DHCP4_SERVER_PORT*/)
     CommandMgr::instance().registerCommand("leases-reclaim",
         boost::bind(&ControlledDhcpv4Srv::commandLeasesReclaimHandler, this, _1, _2));
 
+    // Register host reservation related commands
+    CommandMgr::instance().registerCommand("reservation-add",
+        boost::bind(&HostCmds::reservationAddHandler, AF_INET, _1, _2));
+
+    CommandMgr::instance().registerCommand("reservation-get",
+        boost::bind(&HostCmds::reservationGetHandler, AF_INET, _1, _2));
+
+    CommandMgr::instance().registerCommand("reservation-del",
+        boost::bind(&HostCmds::reservationDelHandler, AF_INET, _1, _2));
+
+    // Register lease related commands
+    CommandMgr::instance().registerCommand("lease4-add",
+        boost::bind(&LeaseCmds::leaseAddHandler, AF_INET, _1, _2));
+
+    CommandMgr::instance().registerCommand("lease4-get",
+        boost::bind(&LeaseCmds::leaseGetHandler, AF_INET, _1, _2));
+
+    CommandMgr::instance().registerCommand("lease4-update",
+        boost::bind(&LeaseCmds::leaseUpdateHandler, AF_INET, _1, _2));
+
+    CommandMgr::instance().registerCommand("lease4-del",
+        boost::bind(&LeaseCmds::leaseDelHandler, AF_INET, _1, _2));
+
+    CommandMgr::instance().registerCommand("lease-get-all",
+        boost::bind(&LeaseCmds::leaseGetAllHandler, AF_INET, _1, _2));
+
     // Register statistic related commands
     CommandMgr::instance().registerCommand("statistic-get",
         boost::bind(&StatsMgr::statisticGetHandler, _1, _2));
@@ -344,6 +394,12 @@ ControlledDhcpv4Srv::ControlledDhcpv4Srv(uint16_t port /*= DHCP4_SERVER_PORT*/)
 
     CommandMgr::instance().registerCommand("statistic-remove-all",
         boost::bind(&StatsMgr::statisticRemoveAllHandler, _1, _2));
+
+    CommandMgr::instance().registerCommand("statistic-sample-age-set",
+        boost::bind(&StatsMgr::statisticSetMaxSampleAgeHandler, _1, _2));
+
+    CommandMgr::instance().registerCommand("statistic-sample-count-set",
+        boost::bind(&StatsMgr::statisticSetMaxSampleCountHandler, _1, _2));
 }
 
 void ControlledDhcpv4Srv::shutdown() {
@@ -355,6 +411,9 @@ ControlledDhcpv4Srv::~ControlledDhcpv4Srv() {
     try {
         cleanup();
 
+        // Stop the thread reclaiming the expired leases, if it is running.
+        reclamation_worker_.reset();
+
         // Stop worker thread running timers, if it is running. Then
         // unregister any timers.
         timer_mgr_->stopThread();
@@ -368,12 +427,22 @@ ControlledDhcpv4Srv::~ControlledDhcpv4Srv() {
         CommandMgr::instance().deregisterCommand("libreload");
         CommandMgr::instance().deregisterCommand("set-config");
         CommandMgr::instance().deregisterCommand("leases-reclaim");
+        CommandMgr::instance().deregisterCommand("reservation-add");
+        CommandMgr::instance().deregisterCommand("reservation-get");
+        CommandMgr::instance().deregisterCommand("reservation-del");
+        CommandMgr::instance().deregisterCommand("lease4-add");
+        CommandMgr::instance().deregisterCommand("lease4-get");
+        CommandMgr::instance().deregisterCommand("lease4-update");
+        CommandMgr::instance().deregisterCommand("lease4-del");
+        CommandMgr::instance().deregisterCommand("lease-get-all");
         CommandMgr::instance().deregisterCommand("statistic-get");
         CommandMgr::instance().deregisterCommand("statistic-reset");
         CommandMgr::instance().deregisterCommand("statistic-remove");
         CommandMgr::instance().deregisterCommand("statistic-get-all");
         CommandMgr::instance().deregisterCommand("statistic-reset-all");
         CommandMgr::instance().deregisterCommand("statistic-remove-all");
+        CommandMgr::instance().deregisterCommand("statistic-sample-age-set");
+        CommandMgr::instance().deregisterCommand("statistic-sample-count-set");
 
     } catch (...) {
         // Don't want to throw exceptions from the destructor. The server
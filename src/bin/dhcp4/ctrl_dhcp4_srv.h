@@ -11,6 +11,7 @@
 #include <asiolink/asiolink.h>
 #include <cc/data.h>
 #include <cc/command_interpreter.h>
+#include <dhcpsrv/lease_reclamation_worker.h>
 #include <dhcpsrv/timer_mgr.h>
 #include <dhcp4/dhcp4_srv.h>
 
@@ -219,6 +220,11 @@ private:
     /// Shared pointer to the instance of timer @c TimerMgr is held here to
     /// make sure that the @c TimerMgr outlives instance of this class.
     TimerMgrPtr timer_mgr_;
+
+    /// @brief Worker reclaiming the expired leases in the background thread.
+    ///
+    /// It is null when the expired leases are reclaimed using the timers.
+    LeaseReclamationWorkerPtr reclamation_worker_;
 };
 
 }; // namespace isc::dhcp
@@ -55,6 +55,7 @@ using namespace std;
   DHCP_SOCKET_TYPE "dhcp-socket-type"
   RAW "raw"
   UDP "udp"
+  RAW_MMAP "raw-mmap"
 
   ECHO_CLIENT_ID "echo-client-id"
   MATCH_CLIENT_ID "match-client-id"
@@ -128,6 +129,7 @@ using namespace std;
   MAX_RECLAIM_LEASES "max-reclaim-leases"
   MAX_RECLAIM_TIME "max-reclaim-time"
   UNWARNED_RECLAIM_CYCLES "unwarned-reclaim-cycles"
+  RECLAIM_THREAD "reclaim-thread"
 
   SERVER_ID "server-id"
   IDENTIFIER "identifier"
@@ -480,6 +482,7 @@ dhcp_socket_type: DHCP_SOCKET_TYPE {
 
 socket_type: RAW { $$ = ElementPtr(new StringElement("raw", ctx.loc2pos(@1))); }
            | UDP { $$ = ElementPtr(new StringElement("udp", ctx.loc2pos(@1))); }
+           | RAW_MMAP { $$ = ElementPtr(new StringElement("raw-mmap", ctx.loc2pos(@1))); }
            ;
 
 lease_database: LEASE_DATABASE {
@@ -691,6 +694,7 @@ expired_leases_param: reclaim_timer_wait_time
                     | max_reclaim_leases
                     | max_reclaim_time
                     | unwarned_reclaim_cycles
+                    | reclaim_thread
                     ;
 
 reclaim_timer_wait_time: RECLAIM_TIMER_WAIT_TIME COLON INTEGER {
@@ -723,6 +727,11 @@ unwarned_reclaim_cycles: UNWARNED_RECLAIM_CYCLES COLON INTEGER {
     ctx.stack_.back()->set("unwarned-reclaim-cycles", value);
 };
 
+reclaim_thread: RECLAIM_THREAD COLON BOOLEAN {
+    ElementPtr value(new BoolElement($3, ctx.loc2pos(@3)));
+    ctx.stack_.back()->set("reclaim-thread", value);
+};
+
 // --- subnet4 ------------------------------------------
 // This defines subnet4 as a list of maps.
 // "subnet4": [ ... ]
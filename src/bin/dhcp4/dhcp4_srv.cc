@@ -1,4 +1,4 @@
-// Copyright (C) 2011-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2011-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -1200,21 +1200,21 @@ Dhcpv4Srv::appendRequestedOptions(Dhcpv4Exchange& ex) {
 
     // Get the codes of requested options.
     const std::vector<uint8_t>& requested_opts = option_prl->getValues();
-    // For each requested option code get the instance of the option
-    // to be returned to the client.
-    for (std::vector<uint8_t>::const_iterator opt = requested_opts.begin();
-         opt != requested_opts.end(); ++opt) {
+    // Get the instances of the requested options to be returned to the
+    // client. They are looked up and packed once for the given option
+    // list and requested codes.
+    ConstPackedOptionListPtr options =
+        requested_options_cache_.get(co_list, DHCP4_OPTION_SPACE,
+                                     std::vector<uint16_t>(requested_opts.begin(),
+                                                           requested_opts.end()));
+    for (PackedOptionList::const_iterator opt = options->begin();
+         opt != options->end(); ++opt) {
         // Add nothing when it is already there
-        if (!resp->getOption(*opt)) {
-            // Iterate on the configured option list
-            for (CfgOptionList::const_iterator copts = co_list.begin();
-                 copts != co_list.end(); ++copts) {
-                OptionDescriptor desc = (*copts)->get(DHCP4_OPTION_SPACE, *opt);
-                // Got it: add it and jump to the outer loop
-                if (desc.option_) {
-                    resp->addOption(desc.option_);
-                    break;
-                }
+        if (!resp->getOption(opt->option_->getType())) {
+            if (opt->wire_data_) {
+                resp->addPackedOption(opt->option_, opt->wire_data_);
+            } else {
+                resp->addOption(opt->option_);
             }
         }
     }
@@ -2277,6 +2277,9 @@ Dhcpv4Srv::processRelease(Pkt4Ptr& release) {
             bool success = LeaseMgrFactory::instance().deleteLease(lease->addr_);
 
             if (success) {
+                alloc_engine_->invalidateLeaseLookupCache(Lease::TYPE_V4,
+                                                          lease->addr_);
+
                 // Release successful
                 LOG_INFO(lease4_logger, DHCP4_RELEASE)
                     .arg(release->getLabel())
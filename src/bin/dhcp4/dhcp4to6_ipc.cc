@@ -1,4 +1,4 @@
-// Copyright (C) 2015-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -55,29 +55,39 @@ void Dhcp4to6Ipc::open() {
 
 void Dhcp4to6Ipc::handler() {
     Dhcp4to6Ipc& ipc = Dhcp4to6Ipc::instance();
-    Pkt6Ptr pkt;
 
-    try {
-        LOG_DEBUG(packet4_logger, DBG_DHCP4_DETAIL, DHCP4_DHCP4O6_RECEIVING);
-        // Receive message from the IPC socket.
-        pkt = ipc.receive();
+    // Process the messages queued on the socket. The number of messages
+    // is limited so the other sockets are not starved.
+    for (size_t i = 0; i < RECEIVE_BATCH_SIZE; ++i) {
+        Pkt6Ptr pkt;
+
+        try {
+            LOG_DEBUG(packet4_logger, DBG_DHCP4_DETAIL, DHCP4_DHCP4O6_RECEIVING);
+            // Receive message from the IPC socket.
+            pkt = ipc.receive();
+
+            // No more queued messages.
+            if (!pkt) {
+                return;
+            }
 
-        // from Dhcpv4Srv::run_one() after receivePacket()
-        if (pkt) {
+            // from Dhcpv4Srv::run_one() after receivePacket()
             LOG_DEBUG(packet4_logger, DBG_DHCP4_BASIC, DHCP6_DHCP4O6_PACKET_RECEIVED)
                 .arg(static_cast<int>(pkt->getType()))
                 .arg(pkt->getRemoteAddr().toText())
                 .arg(pkt->getIface());
+        } catch (const std::exception& e) {
+            // The malformed message has been consumed: try the next one.
+            LOG_DEBUG(packet4_logger, DBG_DHCP4_DETAIL, DHCP4_DHCP4O6_RECEIVE_FAIL)
+                .arg(e.what());
+            continue;
         }
-    } catch (const std::exception& e) {
-        LOG_DEBUG(packet4_logger, DBG_DHCP4_DETAIL, DHCP4_DHCP4O6_RECEIVE_FAIL)
-            .arg(e.what());
-    }
 
-    if (!pkt) {
-        return;
+        processQuery(pkt);
     }
+}
 
+void Dhcp4to6Ipc::processQuery(const Pkt6Ptr& pkt) {
     // Each message must contain option holding DHCPv4 message.
     OptionCollection msgs = pkt->getOptions(D6O_DHCPV4_MSG);
     if (msgs.empty()) {
@@ -169,7 +179,7 @@ void Dhcp4to6Ipc::handler() {
             .arg(static_cast<int>(rsp6->getType()))
             .arg(rsp6->toText());
 
-        ipc.send(rsp6->getPkt6());
+        Dhcp4to6Ipc::instance().send(rsp6->getPkt6());
 
         // Update statistics accordingly for sent packet.
         Dhcpv4Srv::processStatsSent(rsp);
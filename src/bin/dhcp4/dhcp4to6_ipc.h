@@ -1,4 +1,4 @@
-// Copyright (C) 2015-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -45,9 +45,19 @@ public:
 
     /// @brief On receive handler
     ///
-    /// The handler processes the DHCPv4-query DHCPv6 packet and
-    /// sends the DHCPv4-response DHCPv6 packet back to the DHCPv6 server
+    /// The handler receives the DHCPv4-query DHCPv6 packets queued on
+    /// the socket (up to @c RECEIVE_BATCH_SIZE), processes them and
+    /// sends the DHCPv4-response DHCPv6 packets back to the DHCPv6 server
     static void handler();
+
+private:
+    /// @brief Processes a DHCPv4-query DHCPv6 packet
+    ///
+    /// Processes the DHCPv4 query and sends the DHCPv4-response DHCPv6
+    /// packet back to the DHCPv6 server
+    ///
+    /// @param pkt DHCPv4-query DHCPv6 packet received over the IPC
+    static void processQuery(const Pkt6Ptr& pkt);
 };
 
 } // namespace isc
@@ -21,6 +21,7 @@
 #include <dhcpsrv/parsers/host_reservation_parser.h>
 #include <dhcpsrv/parsers/host_reservations_list_parser.h>
 #include <dhcpsrv/parsers/ifaces_config_parser.h>
+#include <dhcpsrv/parsers/parallel_host_reservations_parser.h>
 #include <dhcpsrv/timer_mgr.h>
 #include <config/command_mgr.h>
 #include <util/encode/hex.h>
@@ -113,9 +114,24 @@ public:
     /// @brief Constructor
     ///
     /// @param ignored first parameter
+    /// @param current_subnet Unchanged subnet from the current configuration
+    /// which should be used instead of parsing the subnet configuration.
+    /// If NULL, the subnet is parsed.
+    /// @param reuse_reservations Boolean flag indicating if the host
+    /// reservations for the subnet are unchanged and should be copied
+    /// from the current configuration rather than parsed.
+    /// @param hosts_parser Parser to which the host reservations of the
+    /// subnet are queued. If NULL, the reservations are parsed and added
+    /// to the configuration by this parser.
     /// stores global scope parameters, options, option definitions.
-    Subnet4ConfigParser(const std::string&)
-        :SubnetConfigParser("", globalContext(), IOAddress("0.0.0.0")) {
+    Subnet4ConfigParser(const std::string&,
+                        const Subnet4Ptr& current_subnet = Subnet4Ptr(),
+                        const bool reuse_reservations = false,
+                        ParallelHostReservationsParser* hosts_parser = NULL)
+        :SubnetConfigParser("", globalContext(), IOAddress("0.0.0.0")),
+         current_subnet_(current_subnet),
+         reuse_reservations_(reuse_reservations),
+         hosts_parser_(hosts_parser) {
     }
 
     /// @brief Parses a single IPv4 subnet configuration and adds to the
@@ -123,10 +139,15 @@ public:
     ///
     /// @param subnet A new subnet being configured.
     void build(ConstElementPtr subnet) {
-        SubnetConfigParser::build(subnet);
+        Subnet4Ptr sub4ptr = current_subnet_;
+        if (sub4ptr) {
+            LOG_DEBUG(dhcp4_logger, DBG_DHCP4_DETAIL, DHCP4_CONFIG_SUBNET_REUSED)
+                .arg(sub4ptr->toText()).arg(sub4ptr->getID());
 
-        if (subnet_) {
-            Subnet4Ptr sub4ptr = boost::dynamic_pointer_cast<Subnet4>(subnet_);
+        } else {
+            SubnetConfigParser::build(subnet);
+
+            sub4ptr = boost::dynamic_pointer_cast<Subnet4>(subnet_);
             if (!sub4ptr) {
                 // If we hit this, it is a programming error.
                 isc_throw(Unexpected,
@@ -137,23 +158,45 @@ public:
             if (relay_info_) {
                 sub4ptr->setRelayInfo(*relay_info_);
             }
+        }
 
-            // Adding a subnet to the Configuration Manager may fail if the
-            // subnet id is invalid (duplicate). Thus, we catch exceptions
-            // here to append a position in the configuration string.
-            try {
-                CfgMgr::instance().getStagingCfg()->getCfgSubnets4()->add(sub4ptr);
-            } catch (const std::exception& ex) {
-                isc_throw(DhcpConfigError, ex.what() << " ("
-                          << subnet->getPosition() << ")");
+        // Adding a subnet to the Configuration Manager may fail if the
+        // subnet id is invalid (duplicate). Thus, we catch exceptions
+        // here to append a position in the configuration string.
+        try {
+            CfgMgr::instance().getStagingCfg()->getCfgSubnets4()->add(sub4ptr);
+        } catch (const std::exception& ex) {
+            isc_throw(DhcpConfigError, ex.what() << " ("
+                      << subnet->getPosition() << ")");
+        }
+
+        if (reuse_reservations_) {
+            // Copy unchanged Host Reservations from the current configuration.
+            LOG_DEBUG(dhcp4_logger, DBG_DHCP4_DETAIL,
+                      DHCP4_CONFIG_RESERVATIONS_REUSED).arg(sub4ptr->getID());
+            ConstHostCollection hosts = CfgMgr::instance().getCurrentCfg()->
+                getCfgHosts()->getAll4(sub4ptr->getID());
+            if (hosts_parser_) {
+                hosts_parser_->add(hosts);
+                return;
             }
+            CfgHostsPtr cfg_hosts = CfgMgr::instance().getStagingCfg()->getCfgHosts();
+            for (ConstHostCollection::const_iterator host = hosts.begin();
+                 host != hosts.end(); ++host) {
+                cfg_hosts->add(HostPtr(new Host(**host)));
+            }
+            return;
         }
 
         // Parse Host Reservations for this subnet if any.
         ConstElementPtr reservations = subnet->get("reservations");
         if (reservations) {
-            HostReservationsListParser<HostReservationParser4> parser;
-            parser.parse(subnet_->getID(), reservations);
+            if (hosts_parser_) {
+                hosts_parser_->add(sub4ptr->getID(), reservations);
+            } else {
+                HostReservationsListParser<HostReservationParser4> parser;
+                parser.parse(sub4ptr->getID(), reservations);
+            }
         }
     }
 
@@ -349,6 +392,16 @@ protected:
             // That's ok if it fails. client-class is optional.
         }
     }
+
+    /// @brief Unchanged subnet from the current configuration or NULL.
+    Subnet4Ptr current_subnet_;
+
+    /// @brief Indicates if the host reservations should be copied from
+    /// the current configuration.
+    bool reuse_reservations_;
+
+    /// @brief Parser to which the host reservations are queued.
+    ParallelHostReservationsParser* hosts_parser_;
 };
 
 /// @brief this class parses list of DHCP4 subnets
@@ -371,12 +424,65 @@ public:
     /// Iterates over all entries on the list and creates Subnet4ConfigParser
     /// for each entry.
     ///
+    /// The subnets and host reservations which haven't changed since the
+    /// current configuration was applied are taken from the current
+    /// configuration rather than parsed again. This significantly reduces
+    /// the reconfiguration time for large configurations.
+    ///
+    /// The host reservations of all subnets are parsed by multiple threads
+    /// after the subnets are parsed. If parsing a subnet fails, the
+    /// reservations of the preceding subnets are parsed first, so as the
+    /// same error is reported as if the reservations were parsed along
+    /// with their subnets.
+    ///
     /// @param subnets_list pointer to a list of IPv4 subnets
     void build(ConstElementPtr subnets_list) {
+        ConstSrvConfigPtr current_cfg = CfgMgr::instance().getCurrentCfg();
+        const CfgIncremental& previous = *current_cfg->getCfgIncremental();
+        CfgIncrementalPtr incremental =
+            CfgMgr::instance().getStagingCfg()->getCfgIncremental();
+
+        // Nothing can be reused if any of the global parameters inherited
+        // by the subnets has changed.
+        std::map<SubnetID, Subnet4Ptr> current_subnets;
+        if (incremental->inheritedEquals(previous)) {
+            const Subnet4Collection* subnets = current_cfg->getCfgSubnets4()->getAll();
+            for (Subnet4Collection::const_iterator subnet = subnets->begin();
+                 subnet != subnets->end(); ++subnet) {
+                current_subnets[(*subnet)->getID()] = *subnet;
+            }
+        }
+
+        ParallelHostReservationsParser hosts_parser(&ParallelHostReservationsParser::
+                                                    parseHost<HostReservationParser4>);
+
         BOOST_FOREACH(ConstElementPtr subnet, subnets_list->listValue()) {
-            ParserPtr parser(new Subnet4ConfigParser("subnet"));
-            parser->build(subnet);
+            Subnet4Ptr current_subnet;
+            bool reuse_reservations = false;
+            std::map<SubnetID, Subnet4Ptr>::const_iterator current =
+                current_subnets.find(CfgIncremental::getSubnetId(subnet));
+            if (current != current_subnets.end()) {
+                if (previous.subnetEquals(subnet)) {
+                    current_subnet = current->second;
+                }
+                reuse_reservations = previous.reservationsEqual(subnet);
+            }
+
+            ParserPtr parser(new Subnet4ConfigParser("subnet", current_subnet,
+                                                     reuse_reservations,
+                                                     &hosts_parser));
+            try {
+                parser->build(subnet);
+            } catch (...) {
+                // Report the error in the reservations of the preceding
+                // subnets, if any.
+                hosts_parser.parse();
+                throw;
+            }
+            incremental->addSubnet(subnet);
         }
+
+        hosts_parser.parse();
     }
 
     /// @brief commits subnets definitions.
@@ -601,6 +707,13 @@ configureDhcp4Server(Dhcpv4Srv&, isc::data::ConstElementPtr config_set) {
         // Set all default values if not specified by the user.
         SimpleParser4::setAllDefaults(mutable_cfg);
 
+        // Remember the global parameters inherited by the subnets. The
+        // subnets can only be reused during the next reconfiguration if
+        // these parameters remain unchanged.
+        CfgMgr::instance().getStagingCfg()->getCfgIncremental()->
+            setInheritedParameters(mutable_cfg,
+                                   SimpleParser4::SUBNET4_PARSE_DEPENDENCIES);
+
         // We need definitions first
         ConstElementPtr option_defs = mutable_cfg->get("option-def");
         if (option_defs) {
@@ -10,6 +10,7 @@
 #include <dhcp4/ctrl_dhcp4_srv.h>
 #include <dhcp4/dhcp4_log.h>
 #include <dhcp4/parser_context.h>
+#include <cc/element_arena.h>
 #include <dhcpsrv/cfgmgr.h>
 #include <exceptions/exceptions.h>
 
@@ -47,6 +48,11 @@ void configure(const std::string& file_name) {
                       " Please use -c command line option.");
         }
 
+        // Allocate the elements created while the configuration is parsed
+        // and applied from the arena. The memory is released in large
+        // blocks when the parsed configuration is no longer used.
+        isc::data::ElementArena arena;
+
         // Read contents of the file and parse it as JSON
         Parser4Context parser;
         json = parser.parseFile(file_name, Parser4Context::PARSER_DHCP4);
@@ -1,4 +1,4 @@
-// Copyright (C) 2012-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2012-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -1024,6 +1024,126 @@ TEST_F(Dhcp4ParserTest, reconfigureRemoveSubnet) {
 
 /// @todo: implement subnet removal test as part of #3281.
 
+// This test verifies that the subnets and host reservations which haven't
+// changed are taken from the current configuration during reconfiguration
+// and that the changed ones are parsed again.
+TEST_F(Dhcp4ParserTest, reconfigureReuseUnchangedSubnets) {
+    string config = "{ " + genIfaceConfig() + "," +
+        "\"rebind-timer\": 2000, "
+        "\"renew-timer\": 1000, "
+        "\"subnet4\": [ { "
+        "    \"pools\": [ { \"pool\": \"192.0.2.1 - 192.0.2.100\" } ],"
+        "    \"subnet\": \"192.0.2.0/24\", "
+        "    \"id\": 1, "
+        "    \"reservations\": [ { "
+        "        \"hw-address\": \"01:02:03:04:05:06\", "
+        "        \"ip-address\": \"192.0.2.10\" } ]"
+        " },"
+        " {"
+        "    \"pools\": [ { \"pool\": \"192.0.3.101 - 192.0.3.150\" } ],"
+        "    \"subnet\": \"192.0.3.0/24\", "
+        "    \"id\": 2 "
+        " } ],"
+        "\"valid-lifetime\": 4000 }";
+
+    // The second subnet has a different pool.
+    string config_changed = "{ " + genIfaceConfig() + "," +
+        "\"rebind-timer\": 2000, "
+        "\"renew-timer\": 1000, "
+        "\"subnet4\": [ { "
+        "    \"pools\": [ { \"pool\": \"192.0.2.1 - 192.0.2.100\" } ],"
+        "    \"subnet\": \"192.0.2.0/24\", "
+        "    \"id\": 1, "
+        "    \"reservations\": [ { "
+        "        \"hw-address\": \"01:02:03:04:05:06\", "
+        "        \"ip-address\": \"192.0.2.10\" } ]"
+        " },"
+        " {"
+        "    \"pools\": [ { \"pool\": \"192.0.3.101 - 192.0.3.200\" } ],"
+        "    \"subnet\": \"192.0.3.0/24\", "
+        "    \"id\": 2 "
+        " } ],"
+        "\"valid-lifetime\": 4000 }";
+
+    ConstElementPtr json;
+    ConstElementPtr x;
+    ASSERT_NO_THROW(json = parseDHCP4(config));
+    EXPECT_NO_THROW(x = configureDhcp4Server(*srv_, json));
+    checkResult(x, 0);
+    CfgMgr::instance().commit();
+
+    ConstCfgSubnets4Ptr current = CfgMgr::instance().getCurrentCfg()->getCfgSubnets4();
+    Subnet4Ptr subnet1 = current->getBySubnetId(1);
+    Subnet4Ptr subnet2 = current->getBySubnetId(2);
+    ASSERT_TRUE(subnet1);
+    ASSERT_TRUE(subnet2);
+
+    ASSERT_NO_THROW(json = parseDHCP4(config_changed));
+    EXPECT_NO_THROW(x = configureDhcp4Server(*srv_, json));
+    checkResult(x, 0);
+
+    // The unchanged subnet should be reused and the changed one should
+    // have been parsed again.
+    CfgSubnets4Ptr staging = CfgMgr::instance().getStagingCfg()->getCfgSubnets4();
+    ASSERT_EQ(2, staging->getAll()->size());
+    EXPECT_TRUE(staging->getBySubnetId(1) == subnet1);
+    ASSERT_TRUE(staging->getBySubnetId(2));
+    EXPECT_FALSE(staging->getBySubnetId(2) == subnet2);
+    EXPECT_TRUE(staging->getBySubnetId(2)->inPool(Lease::TYPE_V4,
+                                              IOAddress("192.0.3.200")));
+
+    // The reservation of the unchanged subnet should have been copied.
+    HostCollection hosts =
+        CfgMgr::instance().getStagingCfg()->getCfgHosts()->getAll4(SubnetID(1));
+    ASSERT_EQ(1, hosts.size());
+    EXPECT_EQ("192.0.2.10", hosts[0]->getIPv4Reservation().toText());
+}
+
+// This test verifies that no subnet is reused during reconfiguration when
+// a global parameter inherited by the subnets has changed.
+TEST_F(Dhcp4ParserTest, reconfigureChangedGlobals) {
+    string config = "{ " + genIfaceConfig() + "," +
+        "\"rebind-timer\": 2000, "
+        "\"renew-timer\": 1000, "
+        "\"subnet4\": [ { "
+        "    \"pools\": [ { \"pool\": \"192.0.2.1 - 192.0.2.100\" } ],"
+        "    \"subnet\": \"192.0.2.0/24\", "
+        "    \"id\": 1, "
+        "    \"reservations\": [ { "
+        "        \"hw-address\": \"01:02:03:04:05:06\", "
+        "        \"ip-address\": \"192.0.2.10\" } ]"
+        " } ],"
+        "\"valid-lifetime\": 4000 }";
+
+    ConstElementPtr json;
+    ConstElementPtr x;
+    ASSERT_NO_THROW(json = parseDHCP4(config));
+    EXPECT_NO_THROW(x = configureDhcp4Server(*srv_, json));
+    checkResult(x, 0);
+    CfgMgr::instance().commit();
+
+    Subnet4Ptr subnet1 = CfgMgr::instance().getCurrentCfg()->
+        getCfgSubnets4()->getBySubnetId(1);
+    ASSERT_TRUE(subnet1);
+
+    // Change the renew-timer inherited by the subnet.
+    config.replace(config.find("\"renew-timer\": 1000"), 20,
+                   "\"renew-timer\": 1500");
+    ASSERT_NO_THROW(json = parseDHCP4(config));
+    EXPECT_NO_THROW(x = configureDhcp4Server(*srv_, json));
+    checkResult(x, 0);
+
+    Subnet4Ptr staging = CfgMgr::instance().getStagingCfg()->
+        getCfgSubnets4()->getBySubnetId(1);
+    ASSERT_TRUE(staging);
+    EXPECT_FALSE(staging == subnet1);
+    EXPECT_EQ(1500, staging->getT1());
+
+    // The reservations don't depend on the timers, so they are still there.
+    EXPECT_EQ(1, CfgMgr::instance().getStagingCfg()->getCfgHosts()->
+              getAll4(SubnetID(1)).size());
+}
+
 // Checks if the next-server defined as global parameter is taken into
 // consideration.
 TEST_F(Dhcp4ParserTest, nextServerGlobal) {
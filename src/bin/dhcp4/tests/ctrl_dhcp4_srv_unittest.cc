@@ -294,11 +294,21 @@ TEST_F(CtrlChannelDhcpv4SrvTest, commandsRegistration) {
     ASSERT_TRUE(answer->get("arguments"));
     std::string command_list = answer->get("arguments")->str();
 
+    EXPECT_TRUE(command_list.find("\"lease-get-all\"") != string::npos);
+    EXPECT_TRUE(command_list.find("\"lease4-add\"") != string::npos);
+    EXPECT_TRUE(command_list.find("\"lease4-del\"") != string::npos);
+    EXPECT_TRUE(command_list.find("\"lease4-get\"") != string::npos);
+    EXPECT_TRUE(command_list.find("\"lease4-update\"") != string::npos);
     EXPECT_TRUE(command_list.find("\"list-commands\"") != string::npos);
+    EXPECT_TRUE(command_list.find("\"reservation-add\"") != string::npos);
+    EXPECT_TRUE(command_list.find("\"reservation-del\"") != string::npos);
+    EXPECT_TRUE(command_list.find("\"reservation-get\"") != string::npos);
     EXPECT_TRUE(command_list.find("\"statistic-get\"") != string::npos);
     EXPECT_TRUE(command_list.find("\"statistic-get-all\"") != string::npos);
     EXPECT_TRUE(command_list.find("\"statistic-remove\"") != string::npos);
     EXPECT_TRUE(command_list.find("\"statistic-remove-all\"") != string::npos);
+    EXPECT_TRUE(command_list.find("\"statistic-sample-age-set\"") != string::npos);
+    EXPECT_TRUE(command_list.find("\"statistic-sample-count-set\"") != string::npos);
     EXPECT_TRUE(command_list.find("\"statistic-reset\"") != string::npos);
     EXPECT_TRUE(command_list.find("\"statistic-reset-all\"") != string::npos);
 
@@ -1,4 +1,4 @@
-// Copyright (C) 2015-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -388,4 +388,51 @@ TEST_F(Dhcp4to6IpcTest, process) {
     EXPECT_EQ(1, pkt4_ack->getInteger().first);
 }
 
+
+// This test verifies that the DHCPv4 endpoint of the DHCPv4o6 IPC
+// processes all queued messages when the socket becomes readable.
+TEST_F(Dhcp4to6IpcTest, processBatch) {
+    // Create instance of the IPC endpoint under test.
+    Dhcp4to6Ipc& ipc = Dhcp4to6Ipc::instance();
+    // Create instance of the IPC endpoint being used as a source of messages.
+    TestIpc src_ipc(TEST_PORT, TestIpc::ENDPOINT_TYPE_V6);
+
+    // Open both endpoints.
+    ASSERT_NO_THROW(ipc.open());
+    ASSERT_NO_THROW(src_ipc.open());
+
+    // Send a few information requests before the server gets a chance
+    // to receive any of them.
+    const int64_t queries_num = 3;
+    for (int64_t i = 0; i < queries_num; ++i) {
+        Pkt4Ptr infreq(new Pkt4(DHCPINFORM, 1234 + i));
+        infreq->setHWAddr(generateHWAddr(6));
+        infreq->setCiaddr(IOAddress("192.0.1.2"));
+        infreq->pack();
+        OutputBuffer& output_buffer = infreq->getBuffer();
+        const uint8_t* data = static_cast<const uint8_t*>(output_buffer.getData());
+        OptionBuffer option_buffer(data, data + output_buffer.getLength());
+        OptionPtr opt_msg(new Option(Option::V6, D6O_DHCPV4_MSG, option_buffer));
+
+        Pkt6Ptr pkt(new Pkt6(DHCPV6_DHCPV4_QUERY, 1234 + i));
+        pkt->addOption(opt_msg);
+        pkt->setIface("eth0");
+        pkt->setRemoteAddr(IOAddress("2001:db8:1::123"));
+        ASSERT_NO_THROW(src_ipc.send(pkt));
+    }
+
+    // All queries should be processed at once.
+    ASSERT_NO_THROW(IfaceMgr::instance().receive6(1, 0));
+
+    // Verify statistics
+    StatsMgr& mgr = StatsMgr::instance();
+    ObservationPtr pkt4_snd = mgr.getObservation("pkt4-sent");
+    ObservationPtr ipc_rcvd = mgr.getObservation("dhcp4o6-ipc-received");
+    ASSERT_TRUE(pkt4_snd);
+    ASSERT_TRUE(ipc_rcvd);
+    EXPECT_EQ(queries_num, pkt4_snd->getInteger().first);
+    EXPECT_EQ(queries_num, ipc_rcvd->getInteger().first);
+    EXPECT_TRUE(mgr.getObservation("dhcp4o6-ipc-latency"));
+}
+
 } // end of anonymous namespace
@@ -10,6 +10,8 @@
 #include <dhcp/libdhcp++.h>
 #include <dhcpsrv/cfgmgr.h>
 #include <dhcpsrv/cfg_db_access.h>
+#include <dhcpsrv/host_cmds.h>
+#include <dhcpsrv/lease_cmds.h>
 #include <dhcp6/ctrl_dhcp6_srv.h>
 #include <dhcp6/dhcp6to4_ipc.h>
 #include <dhcp6/dhcp6_log.h>
@@ -227,6 +229,10 @@ ControlledDhcpv6Srv::processConfig(isc::data::ConstElementPtr config) {
         return (isc::config::createAnswer(1, err.str()));
     }
 
+    // Stop the thread reclaiming the expired leases, if it is running. It
+    // is started again if the new configuration enables it.
+    srv->reclamation_worker_.reset();
+
     ConstElementPtr answer = configureDhcp6Server(*srv, config);
 
     // Check that configuration was successful. If not, do not reopen sockets
@@ -300,12 +306,30 @@ ControlledDhcpv6Srv::processConfig(isc::data::ConstElementPtr config) {
     // of the interfaces.
     CfgMgr::instance().getStagingCfg()->getCfgIface()->openSockets(AF_INET6, srv->getPort());
 
+    // Reclaim the expired leases in the background thread, if enabled. The
+    // timers are used instead when the thread can't be started, e.g. for
+    // the memfile backend or when the reclamation callouts are installed.
+    CfgExpirationPtr cfg_expiration =
+        CfgMgr::instance().getStagingCfg()->getCfgExpiration();
+    if (cfg_expiration->getReclaimThread()) {
+        try {
+            LeaseReclamationWorkerPtr worker(new LeaseReclamationWorker(true,
+                srv->alloc_engine_, *cfg_expiration));
+            worker->start();
+            srv->reclamation_worker_ = worker;
+        } catch (const std::exception& ex) {
+            LOG_WARN(dhcp6_logger, DHCP6_RECLAIM_THREAD_FAILED).arg(ex.what());
+        }
+    }
+
     // Install the timers for handling leases reclamation.
     try {
-        CfgMgr::instance().getStagingCfg()->getCfgExpiration()->
-            setupTimers(&ControlledDhcpv6Srv::reclaimExpiredLeases,
-                        &ControlledDhcpv6Srv::deleteExpiredReclaimedLeases,
-                        server_);
+        if (!srv->reclamation_worker_) {
+            cfg_expiration->
+                setupTimers(&ControlledDhcpv6Srv::reclaimExpiredLeases,
+                            &ControlledDhcpv6Srv::deleteExpiredReclaimedLeases,
+                            server_);
+        }
 
     } catch (const std::exception& ex) {
         std::ostringstream err;
@@ -355,6 +379,32 @@ ControlledDhcpv6Srv::ControlledDhcpv6Srv(uint16_t port)
     CommandMgr::instance().registerCommand("leases-reclaim",
         boost::bind(&ControlledDhcpv6Srv::commandLeasesReclaimHandler, this, _1, _2));
 
+    // Register host reservation related commands
+    CommandMgr::instance().registerCommand("reservation-add",
+        boost::bind(&HostCmds::reservationAddHandler, AF_INET6, _1, _2));
+
+    CommandMgr::instance().registerCommand("reservation-get",
+        boost::bind(&HostCmds::reservationGetHandler, AF_INET6, _1, _2));
+
+    CommandMgr::instance().registerCommand("reservation-del",
+        boost::bind(&HostCmds::reservationDelHandler, AF_INET6, _1, _2));
+
+    // Register lease related commands
+    CommandMgr::instance().registerCommand("lease6-add",
+        boost::bind(&LeaseCmds::leaseAddHandler, AF_INET6, _1, _2));
+
+    CommandMgr::instance().registerCommand("lease6-get",
+        boost::bind(&LeaseCmds::leaseGetHandler, AF_INET6, _1, _2));
+
+    CommandMgr::instance().registerCommand("lease6-update",
+        boost::bind(&LeaseCmds::leaseUpdateHandler, AF_INET6, _1, _2));
+
+    CommandMgr::instance().registerCommand("lease6-del",
+        boost::bind(&LeaseCmds::leaseDelHandler, AF_INET6, _1, _2));
+
+    CommandMgr::instance().registerCommand("lease-get-all",
+        boost::bind(&LeaseCmds::leaseGetAllHandler, AF_INET6, _1, _2));
+
     // Register statistic related commands
     CommandMgr::instance().registerCommand("statistic-get",
         boost::bind(&StatsMgr::statisticGetHandler, _1, _2));
@@ -373,6 +423,12 @@ ControlledDhcpv6Srv::ControlledDhcpv6Srv(uint16_t port)
 
     CommandMgr::instance().registerCommand("statistic-remove-all",
         boost::bind(&StatsMgr::statisticRemoveAllHandler, _1, _2));
+
+    CommandMgr::instance().registerCommand("statistic-sample-age-set",
+        boost::bind(&StatsMgr::statisticSetMaxSampleAgeHandler, _1, _2));
+
+    CommandMgr::instance().registerCommand("statistic-sample-count-set",
+        boost::bind(&StatsMgr::statisticSetMaxSampleCountHandler, _1, _2));
 }
 
 void ControlledDhcpv6Srv::shutdown() {
@@ -384,6 +440,9 @@ ControlledDhcpv6Srv::~ControlledDhcpv6Srv() {
     try {
         cleanup();
 
+        // Stop the thread reclaiming the expired leases, if it is running.
+        reclamation_worker_.reset();
+
         // Stop worker thread running timers, if it is running. Then
         // unregister any timers.
         timer_mgr_->stopThread();
@@ -397,12 +456,22 @@ ControlledDhcpv6Srv::~ControlledDhcpv6Srv() {
         CommandMgr::instance().deregisterCommand("libreload");
         CommandMgr::instance().deregisterCommand("set-config");
         CommandMgr::instance().deregisterCommand("leases-reclaim");
+        CommandMgr::instance().deregisterCommand("reservation-add");
+        CommandMgr::instance().deregisterCommand("reservation-get");
+        CommandMgr::instance().deregisterCommand("reservation-del");
+        CommandMgr::instance().deregisterCommand("lease6-add");
+        CommandMgr::instance().deregisterCommand("lease6-get");
+        CommandMgr::instance().deregisterCommand("lease6-update");
+        CommandMgr::instance().deregisterCommand("lease6-del");
+        CommandMgr::instance().deregisterCommand("lease-get-all");
         CommandMgr::instance().deregisterCommand("statistic-get");
         CommandMgr::instance().deregisterCommand("statistic-reset");
         CommandMgr::instance().deregisterCommand("statistic-remove");
         CommandMgr::instance().deregisterCommand("statistic-get-all");
         CommandMgr::instance().deregisterCommand("statistic-reset-all");
         CommandMgr::instance().deregisterCommand("statistic-remove-all");
+        CommandMgr::instance().deregisterCommand("statistic-sample-age-set");
+        CommandMgr::instance().deregisterCommand("statistic-sample-count-set");
 
     } catch (...) {
         // Don't want to throw exceptions from the destructor. The server
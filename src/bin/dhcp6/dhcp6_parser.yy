@@ -125,6 +125,7 @@ using namespace std;
   MAX_RECLAIM_LEASES "max-reclaim-leases"
   MAX_RECLAIM_TIME "max-reclaim-time"
   UNWARNED_RECLAIM_CYCLES "unwarned-reclaim-cycles"
+  RECLAIM_THREAD "reclaim-thread"
 
   SERVER_ID "server-id"
   LLT "LLT"
@@ -692,6 +693,7 @@ expired_leases_param: reclaim_timer_wait_time
                     | max_reclaim_leases
                     | max_reclaim_time
                     | unwarned_reclaim_cycles
+                    | reclaim_thread
                     ;
 
 reclaim_timer_wait_time: RECLAIM_TIMER_WAIT_TIME COLON INTEGER {
@@ -724,6 +726,11 @@ unwarned_reclaim_cycles: UNWARNED_RECLAIM_CYCLES COLON INTEGER {
     ctx.stack_.back()->set("unwarned-reclaim-cycles", value);
 };
 
+reclaim_thread: RECLAIM_THREAD COLON BOOLEAN {
+    ElementPtr value(new BoolElement($3, ctx.loc2pos(@3)));
+    ctx.stack_.back()->set("reclaim-thread", value);
+};
+
 // --- subnet6 ------------------------------------------
 // This defines subnet6 as a list of maps.
 // "subnet6": [ ... ]
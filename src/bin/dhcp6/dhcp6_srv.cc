@@ -1,4 +1,4 @@
-// Copyright (C) 2011-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2011-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -892,16 +892,16 @@ Dhcpv6Srv::appendRequestedOptions(const Pkt6Ptr& question, Pkt6Ptr& answer,
     // Get the list of options that client requested.
     const std::vector<uint16_t>& requested_opts = option_oro->getValues();
 
-    BOOST_FOREACH(uint16_t opt, requested_opts) {
-        // Iterate on the configured option list
-        for (CfgOptionList::const_iterator copts = co_list.begin();
-             copts != co_list.end(); ++copts) {
-            OptionDescriptor desc = (*copts)->get(DHCP6_OPTION_SPACE, opt);
-            // Got it: add it and jump to the outer loop
-            if (desc.option_) {
-                answer->addOption(desc.option_);
-                break;
-            }
+    // Get the instances of the requested options. They are looked up and
+    // packed once for the given option list and requested codes.
+    ConstPackedOptionListPtr options =
+        requested_options_cache_.get(co_list, DHCP6_OPTION_SPACE,
+                                     requested_opts);
+    BOOST_FOREACH(const PackedOption& opt, *options) {
+        if (opt.wire_data_) {
+            answer->addPackedOption(opt.option_, opt.wire_data_);
+        } else {
+            answer->addOption(opt.option_);
         }
     }
 }
@@ -2147,6 +2147,10 @@ Dhcpv6Srv::releaseIA_NA(const DuidPtr& duid, const Pkt6Ptr& query,
 
     if (!skip) {
         success = LeaseMgrFactory::instance().deleteLease(lease->addr_);
+        if (success) {
+            alloc_engine_->invalidateLeaseLookupCache(lease->type_,
+                                                      lease->addr_);
+        }
     }
 
     // Here the success should be true if we removed lease successfully
@@ -2299,6 +2303,10 @@ Dhcpv6Srv::releaseIA_PD(const DuidPtr& duid, const Pkt6Ptr& query,
 
     if (!skip) {
         success = LeaseMgrFactory::instance().deleteLease(lease->addr_);
+        if (success) {
+            alloc_engine_->invalidateLeaseLookupCache(lease->type_,
+                                                      lease->addr_);
+        }
     } else {
         // Callouts decided to skip the next processing step. The next
         // processing step would to send the packet, so skip at this
@@ -1,4 +1,4 @@
-// Copyright (C) 2015-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -54,36 +54,45 @@ void Dhcp6to4Ipc::open() {
 
 void Dhcp6to4Ipc::handler() {
     Dhcp6to4Ipc& ipc = Dhcp6to4Ipc::instance();
-    Pkt6Ptr pkt;
 
-    try {
-        LOG_DEBUG(packet6_logger, DBG_DHCP6_DETAIL, DHCP6_DHCP4O6_RECEIVING);
-        // Receive message from IPC.
-        pkt = ipc.receive();
+    // Forward the messages queued on the socket. The number of messages
+    // is limited so the other sockets are not starved.
+    for (size_t i = 0; i < RECEIVE_BATCH_SIZE; ++i) {
+        Pkt6Ptr pkt;
+
+        try {
+            LOG_DEBUG(packet6_logger, DBG_DHCP6_DETAIL, DHCP6_DHCP4O6_RECEIVING);
+            // Receive message from IPC.
+            pkt = ipc.receive();
+
+            // No more queued messages.
+            if (!pkt) {
+                return;
+            }
 
-        if (pkt) {
             LOG_DEBUG(packet6_logger, DBG_DHCP6_BASIC, DHCP6_DHCP4O6_PACKET_RECEIVED)
                 .arg(static_cast<int>(pkt->getType()))
                 .arg(pkt->getRemoteAddr().toText())
                 .arg(pkt->getIface());
+        } catch (const std::exception& e) {
+            // The malformed message has been consumed: try the next one.
+            LOG_DEBUG(packet6_logger,DBG_DHCP6_DETAIL, DHCP6_DHCP4O6_RECEIVE_FAIL)
+                .arg(e.what());
+            continue;
         }
-    } catch (const std::exception& e) {
-        LOG_DEBUG(packet6_logger,DBG_DHCP6_DETAIL, DHCP6_DHCP4O6_RECEIVE_FAIL)
-            .arg(e.what());
-    }
 
-    if (!pkt) {
-        return;
+        sendResponse(pkt);
     }
+}
 
+void Dhcp6to4Ipc::sendResponse(Pkt6Ptr pkt) {
     // Should we check it is a DHCPV6_DHCPV4_RESPONSE?
 
-    // The received message has been unpacked by the receive() function. This
-    // method could have modified the message so it's better to pack() it
-    // again because we'll be forwarding it to a client.
+    // The IPC doesn't modify the message so it is forwarded to the client
+    // as it was packed by the DHCPv4 server, without packing it again.
     isc::util::OutputBuffer& buf = pkt->getBuffer();
     buf.clear();
-    pkt->pack();
+    buf.writeData(&pkt->data_[0], pkt->data_.size());
 
     // Don't use getType(): get the message type from the buffer as we
     // want to know if it is a relayed message (vs. internal message type).
@@ -1,4 +1,4 @@
-// Copyright (C) 2015-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -43,8 +43,16 @@ public:
 
     /// @brief On receive handler
     ///
-    /// The handler sends the DHCPv6 packet back to the remote address
+    /// The handler receives the DHCPv6 packets queued on the socket
+    /// (up to @c RECEIVE_BATCH_SIZE) and sends them back to the remote
+    /// address
     static void handler();
+
+private:
+    /// @brief Sends a DHCPv6 packet received over the IPC to the client
+    ///
+    /// @param pkt DHCPv4-response DHCPv6 packet received over the IPC
+    static void sendResponse(Pkt6Ptr pkt);
 };
 
 } // namespace isc
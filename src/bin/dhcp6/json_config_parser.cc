@@ -30,6 +30,7 @@
 #include <dhcpsrv/parsers/host_reservation_parser.h>
 #include <dhcpsrv/parsers/host_reservations_list_parser.h>
 #include <dhcpsrv/parsers/ifaces_config_parser.h>
+#include <dhcpsrv/parsers/parallel_host_reservations_parser.h>
 #include <log/logger_support.h>
 #include <util/encode/hex.h>
 #include <util/strutil.h>
@@ -347,9 +348,24 @@ public:
     /// @brief Constructor
     ///
     /// @param ignored first parameter
+    /// @param current_subnet Unchanged subnet from the current configuration
+    /// which should be used instead of parsing the subnet configuration.
+    /// If NULL, the subnet is parsed.
+    /// @param reuse_reservations Boolean flag indicating if the host
+    /// reservations for the subnet are unchanged and should be copied
+    /// from the current configuration rather than parsed.
+    /// @param hosts_parser Parser to which the host reservations of the
+    /// subnet are queued. If NULL, the reservations are parsed and added
+    /// to the configuration by this parser.
     /// stores global scope parameters, options, option definitions.
-    Subnet6ConfigParser(const std::string&)
-        :SubnetConfigParser("", globalContext(), IOAddress("::")) {
+    Subnet6ConfigParser(const std::string&,
+                        const Subnet6Ptr& current_subnet = Subnet6Ptr(),
+                        const bool reuse_reservations = false,
+                        ParallelHostReservationsParser* hosts_parser = NULL)
+        :SubnetConfigParser("", globalContext(), IOAddress("::")),
+         current_subnet_(current_subnet),
+         reuse_reservations_(reuse_reservations),
+         hosts_parser_(hosts_parser) {
     }
 
     /// @brief Parses a single IPv6 subnet configuration and adds to the
@@ -357,10 +373,15 @@ public:
     ///
     /// @param subnet A new subnet being configured.
     void build(ConstElementPtr subnet) {
-        SubnetConfigParser::build(subnet);
+        Subnet6Ptr sub6ptr = current_subnet_;
+        if (sub6ptr) {
+            LOG_DEBUG(dhcp6_logger, DBG_DHCP6_DETAIL, DHCP6_CONFIG_SUBNET_REUSED)
+                .arg(sub6ptr->toText()).arg(sub6ptr->getID());
 
-        if (subnet_) {
-            Subnet6Ptr sub6ptr = boost::dynamic_pointer_cast<Subnet6>(subnet_);
+        } else {
+            SubnetConfigParser::build(subnet);
+
+            sub6ptr = boost::dynamic_pointer_cast<Subnet6>(subnet_);
             if (!sub6ptr) {
                 // If we hit this, it is a programming error.
                 isc_throw(Unexpected,
@@ -371,22 +392,44 @@ public:
             if (relay_info_) {
                 sub6ptr->setRelayInfo(*relay_info_);
             }
+        }
 
-            // Adding a subnet to the Configuration Manager may fail if the
-            // subnet id is invalid (duplicate). Thus, we catch exceptions
-            // here to append a position in the configuration string.
-            try {
-                CfgMgr::instance().getStagingCfg()->getCfgSubnets6()->add(sub6ptr);
-            } catch (const std::exception& ex) {
-                isc_throw(DhcpConfigError, ex.what() << " ("
-                          << subnet->getPosition() << ")");
+        // Adding a subnet to the Configuration Manager may fail if the
+        // subnet id is invalid (duplicate). Thus, we catch exceptions
+        // here to append a position in the configuration string.
+        try {
+            CfgMgr::instance().getStagingCfg()->getCfgSubnets6()->add(sub6ptr);
+        } catch (const std::exception& ex) {
+            isc_throw(DhcpConfigError, ex.what() << " ("
+                      << subnet->getPosition() << ")");
+        }
+
+        if (reuse_reservations_) {
+            // Copy unchanged Host Reservations from the current configuration.
+            LOG_DEBUG(dhcp6_logger, DBG_DHCP6_DETAIL,
+                      DHCP6_CONFIG_RESERVATIONS_REUSED).arg(sub6ptr->getID());
+            ConstHostCollection hosts = CfgMgr::instance().getCurrentCfg()->
+                getCfgHosts()->getAll6(sub6ptr->getID());
+            if (hosts_parser_) {
+                hosts_parser_->add(hosts);
+                return;
+            }
+            CfgHostsPtr cfg_hosts = CfgMgr::instance().getStagingCfg()->getCfgHosts();
+            for (ConstHostCollection::const_iterator host = hosts.begin();
+                 host != hosts.end(); ++host) {
+                cfg_hosts->add(HostPtr(new Host(**host)));
             }
+            return;
+        }
 
-            // Parse Host Reservations for this subnet if any.
-            ConstElementPtr reservations = subnet->get("reservations");
-            if (reservations) {
+        // Parse Host Reservations for this subnet if any.
+        ConstElementPtr reservations = subnet->get("reservations");
+        if (reservations) {
+            if (hosts_parser_) {
+                hosts_parser_->add(sub6ptr->getID(), reservations);
+            } else {
                 HostReservationsListParser<HostReservationParser6> parser;
-                parser.parse(subnet_->getID(), reservations);
+                parser.parse(sub6ptr->getID(), reservations);
             }
         }
     }
@@ -536,6 +579,15 @@ protected:
         subnet_.reset(subnet6);
     }
 
+    /// @brief Unchanged subnet from the current configuration or NULL.
+    Subnet6Ptr current_subnet_;
+
+    /// @brief Indicates if the host reservations should be copied from
+    /// the current configuration.
+    bool reuse_reservations_;
+
+    /// @brief Parser to which the host reservations are queued.
+    ParallelHostReservationsParser* hosts_parser_;
 };
 
 
@@ -559,14 +611,66 @@ public:
     /// Iterates over all entries on the list and creates a Subnet6ConfigParser
     /// for each entry.
     ///
+    /// The subnets and host reservations which haven't changed since the
+    /// current configuration was applied are taken from the current
+    /// configuration rather than parsed again. This significantly reduces
+    /// the reconfiguration time for large configurations.
+    ///
+    /// The host reservations of all subnets are parsed by multiple threads
+    /// after the subnets are parsed. If parsing a subnet fails, the
+    /// reservations of the preceding subnets are parsed first, so as the
+    /// same error is reported as if the reservations were parsed along
+    /// with their subnets.
+    ///
     /// @param subnets_list pointer to a list of IPv6 subnets
     void build(ConstElementPtr subnets_list) {
+        ConstSrvConfigPtr current_cfg = CfgMgr::instance().getCurrentCfg();
+        const CfgIncremental& previous = *current_cfg->getCfgIncremental();
+        CfgIncrementalPtr incremental =
+            CfgMgr::instance().getStagingCfg()->getCfgIncremental();
+
+        // Nothing can be reused if any of the global parameters inherited
+        // by the subnets has changed.
+        std::map<SubnetID, Subnet6Ptr> current_subnets;
+        if (incremental->inheritedEquals(previous)) {
+            const Subnet6Collection* subnets = current_cfg->getCfgSubnets6()->getAll();
+            for (Subnet6Collection::const_iterator subnet = subnets->begin();
+                 subnet != subnets->end(); ++subnet) {
+                current_subnets[(*subnet)->getID()] = *subnet;
+            }
+        }
+
+        ParallelHostReservationsParser hosts_parser(&ParallelHostReservationsParser::
+                                                    parseHost<HostReservationParser6>);
+
         BOOST_FOREACH(ConstElementPtr subnet, subnets_list->listValue()) {
-            ParserPtr parser(new Subnet6ConfigParser("subnet"));
-            parser->build(subnet);
+            Subnet6Ptr current_subnet;
+            bool reuse_reservations = false;
+            std::map<SubnetID, Subnet6Ptr>::const_iterator current =
+                current_subnets.find(CfgIncremental::getSubnetId(subnet));
+            if (current != current_subnets.end()) {
+                if (previous.subnetEquals(subnet)) {
+                    current_subnet = current->second;
+                }
+                reuse_reservations = previous.reservationsEqual(subnet);
+            }
+
+            ParserPtr parser(new Subnet6ConfigParser("subnet", current_subnet,
+                                                     reuse_reservations,
+                                                     &hosts_parser));
+            try {
+                parser->build(subnet);
+            } catch (...) {
+                // Report the error in the reservations of the preceding
+                // subnets, if any.
+                hosts_parser.parse();
+                throw;
+            }
             subnets_.push_back(parser);
+            incremental->addSubnet(subnet);
         }
 
+        hosts_parser.parse();
     }
 
     /// @brief commits subnets definitions.
@@ -869,6 +973,13 @@ configureDhcp6Server(Dhcpv6Srv&, isc::data::ConstElementPtr config_set) {
 
         SimpleParser6::setAllDefaults(mutable_cfg);
 
+        // Remember the global parameters inherited by the subnets. The
+        // subnets can only be reused during the next reconfiguration if
+        // these parameters remain unchanged.
+        CfgMgr::instance().getStagingCfg()->getCfgIncremental()->
+            setInheritedParameters(mutable_cfg,
+                                   SimpleParser6::SUBNET6_PARSE_DEPENDENCIES);
+
         // Make parsers grouping.
         const std::map<std::string, ConstElementPtr>& values_map =
             mutable_cfg->mapValue();
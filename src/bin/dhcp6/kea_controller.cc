@@ -8,6 +8,7 @@
 
 #include <asiolink/asio_wrapper.h>
 #include <asiolink/asiolink.h>
+#include <cc/element_arena.h>
 #include <dhcpsrv/cfgmgr.h>
 #include <dhcpsrv/parsers/dhcp_config_parser.h>
 #include <dhcp6/json_config_parser.h>
@@ -52,6 +53,11 @@ void configure(const std::string& file_name) {
                       "use -c command line option.");
         }
 
+        // Allocate the elements created while the configuration is parsed
+        // and applied from the arena. The memory is released in large
+        // blocks when the parsed configuration is no longer used.
+        isc::data::ElementArena arena;
+
         // Read contents of the file and parse it as JSON
         Parser6Context parser;
         json = parser.parseFile(file_name, Parser6Context::PARSER_DHCP6);
@@ -1,4 +1,4 @@
-// Copyright (C) 2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2016-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -73,6 +73,23 @@ const ParamsList SimpleParser6::INHERIT_GLOBAL_TO_SUBNET6 = {
     "preferred-lifetime",
     "valid-lifetime"
 };
+
+/// @brief List of global parameters which affect parsing of the subnet6 scope.
+///
+/// This array lists the global parameters which are used by the parsers when
+/// the subnet configuration (including host reservations) is parsed, i.e.
+/// the values inherited by the subnets and the option definitions used for
+/// parsing the option data. A subnet from the current configuration can only
+/// be reused during the server reconfiguration if none of these parameters
+/// has changed.
+const ParamsList SimpleParser6::SUBNET6_PARSE_DEPENDENCIES = {
+    "renew-timer",
+    "rebind-timer",
+    "preferred-lifetime",
+    "valid-lifetime",
+    "option-def"
+};
+
 /// @}
 
 /// ---------------------------------------------------------------------------
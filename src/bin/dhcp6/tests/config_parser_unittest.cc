@@ -1091,6 +1091,131 @@ TEST_F(Dhcp6ParserTest, reconfigureRemoveSubnet) {
     EXPECT_EQ(4, subnets->at(2)->getID());
 }
 
+// This test verifies that the subnets and host reservations which haven't
+// changed are taken from the current configuration during reconfiguration
+// and that the changed ones are parsed again.
+TEST_F(Dhcp6ParserTest, reconfigureReuseUnchangedSubnets) {
+    string config = "{ " + genIfaceConfig() + ","
+        "\"preferred-lifetime\": 3000,"
+        "\"rebind-timer\": 2000, "
+        "\"renew-timer\": 1000, "
+        "\"subnet6\": [ { "
+        "    \"pools\": [ { \"pool\": \"2001:db8:1::/80\" } ],"
+        "    \"subnet\": \"2001:db8:1::/64\", "
+        "    \"id\": 1,"
+        "    \"reservations\": [ {"
+        "        \"duid\": \"01:02:03:04:05:06:07:08:09:0A\","
+        "        \"ip-addresses\": [ \"2001:db8:1::cafe\" ] } ]"
+        " },"
+        " {"
+        "    \"pools\": [ { \"pool\": \"2001:db8:2::/80\" } ],"
+        "    \"subnet\": \"2001:db8:2::/64\", "
+        "    \"id\": 2"
+        " } ],"
+        "\"valid-lifetime\": 4000 }";
+
+    // The second subnet has a different pool.
+    string config_changed = "{ " + genIfaceConfig() + ","
+        "\"preferred-lifetime\": 3000,"
+        "\"rebind-timer\": 2000, "
+        "\"renew-timer\": 1000, "
+        "\"subnet6\": [ { "
+        "    \"pools\": [ { \"pool\": \"2001:db8:1::/80\" } ],"
+        "    \"subnet\": \"2001:db8:1::/64\", "
+        "    \"id\": 1,"
+        "    \"reservations\": [ {"
+        "        \"duid\": \"01:02:03:04:05:06:07:08:09:0A\","
+        "        \"ip-addresses\": [ \"2001:db8:1::cafe\" ] } ]"
+        " },"
+        " {"
+        "    \"pools\": [ { \"pool\": \"2001:db8:2:0:1::/80\" } ],"
+        "    \"subnet\": \"2001:db8:2::/64\", "
+        "    \"id\": 2"
+        " } ],"
+        "\"valid-lifetime\": 4000 }";
+
+    ConstElementPtr json;
+    ConstElementPtr x;
+    ASSERT_NO_THROW(json = parseDHCP6(config));
+    EXPECT_NO_THROW(x = configureDhcp6Server(srv_, json));
+    checkResult(x, 0);
+    CfgMgr::instance().commit();
+
+    ConstCfgSubnets6Ptr current = CfgMgr::instance().getCurrentCfg()->getCfgSubnets6();
+    Subnet6Ptr subnet1 = current->getBySubnetId(1);
+    Subnet6Ptr subnet2 = current->getBySubnetId(2);
+    ASSERT_TRUE(subnet1);
+    ASSERT_TRUE(subnet2);
+
+    ASSERT_NO_THROW(json = parseDHCP6(config_changed));
+    EXPECT_NO_THROW(x = configureDhcp6Server(srv_, json));
+    checkResult(x, 0);
+
+    // The unchanged subnet should be reused and the changed one should
+    // have been parsed again.
+    CfgSubnets6Ptr staging = CfgMgr::instance().getStagingCfg()->getCfgSubnets6();
+    ASSERT_EQ(2, staging->getAll()->size());
+    EXPECT_TRUE(staging->getBySubnetId(1) == subnet1);
+    ASSERT_TRUE(staging->getBySubnetId(2));
+    EXPECT_FALSE(staging->getBySubnetId(2) == subnet2);
+    EXPECT_TRUE(staging->getBySubnetId(2)->inPool(Lease::TYPE_NA,
+                                                  IOAddress("2001:db8:2:0:1::1")));
+
+    // The reservation of the unchanged subnet should have been copied.
+    HostCollection hosts =
+        CfgMgr::instance().getStagingCfg()->getCfgHosts()->getAll6(SubnetID(1));
+    ASSERT_EQ(1, hosts.size());
+    IPv6ResrvRange resrv = hosts[0]->getIPv6Reservations(IPv6Resrv::TYPE_NA);
+    ASSERT_EQ(1, std::distance(resrv.first, resrv.second));
+    EXPECT_EQ("2001:db8:1::cafe", resrv.first->second.getPrefix().toText());
+}
+
+// This test verifies that no subnet is reused during reconfiguration when
+// a global parameter inherited by the subnets has changed.
+TEST_F(Dhcp6ParserTest, reconfigureChangedGlobals) {
+    string config = "{ " + genIfaceConfig() + ","
+        "\"preferred-lifetime\": 3000,"
+        "\"rebind-timer\": 2000, "
+        "\"renew-timer\": 1000, "
+        "\"subnet6\": [ { "
+        "    \"pools\": [ { \"pool\": \"2001:db8:1::/80\" } ],"
+        "    \"subnet\": \"2001:db8:1::/64\", "
+        "    \"id\": 1,"
+        "    \"reservations\": [ {"
+        "        \"duid\": \"01:02:03:04:05:06:07:08:09:0A\","
+        "        \"ip-addresses\": [ \"2001:db8:1::cafe\" ] } ]"
+        " } ],"
+        "\"valid-lifetime\": 4000 }";
+
+    ConstElementPtr json;
+    ConstElementPtr x;
+    ASSERT_NO_THROW(json = parseDHCP6(config));
+    EXPECT_NO_THROW(x = configureDhcp6Server(srv_, json));
+    checkResult(x, 0);
+    CfgMgr::instance().commit();
+
+    Subnet6Ptr subnet1 = CfgMgr::instance().getCurrentCfg()->
+        getCfgSubnets6()->getBySubnetId(1);
+    ASSERT_TRUE(subnet1);
+
+    // Change the preferred-lifetime inherited by the subnet.
+    config.replace(config.find("\"preferred-lifetime\": 3000"), 27,
+                   "\"preferred-lifetime\": 3500");
+    ASSERT_NO_THROW(json = parseDHCP6(config));
+    EXPECT_NO_THROW(x = configureDhcp6Server(srv_, json));
+    checkResult(x, 0);
+
+    Subnet6Ptr staging = CfgMgr::instance().getStagingCfg()->
+        getCfgSubnets6()->getBySubnetId(1);
+    ASSERT_TRUE(staging);
+    EXPECT_FALSE(staging == subnet1);
+    EXPECT_EQ(3500, staging->getPreferred());
+
+    // The reservations don't depend on the lifetimes, so they are still there.
+    EXPECT_EQ(1, CfgMgr::instance().getStagingCfg()->getCfgHosts()->
+              getAll6(SubnetID(1)).size());
+}
+
 
 
 // This test checks if it is possible to override global values
@@ -1,4 +1,4 @@
-// Copyright (C) 2012-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2012-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -18,6 +18,7 @@
 #include <dhcpsrv/lease.h>
 #include <dhcpsrv/lease_mgr_factory.h>
 #include <dhcpsrv/testutils/mysql_schema.h>
+#include <dhcpsrv/timer_mgr.h>
 #include <log/logger_support.h>
 #include <util/stopwatch.h>
 
@@ -61,6 +62,7 @@ public:
         isc::log::setDefaultLoggingOutput();
         static_cast<void>(remove(TEST_FILE));
         static_cast<void>(remove(TEST_INCLUDE));
+        static_cast<void>(remove(TEST_LEASE_FILE));
     };
 
     void writeFile(const std::string& file_name, const std::string& content) {
@@ -89,10 +91,12 @@ public:
 
     static const char* TEST_FILE;
     static const char* TEST_INCLUDE;
+    static const char* TEST_LEASE_FILE;
 };
 
 const char* JSONFileBackendTest::TEST_FILE = "test-config.json";
 const char* JSONFileBackendTest::TEST_INCLUDE = "test-include.json";
+const char* JSONFileBackendTest::TEST_LEASE_FILE = "test-leases6.csv";
 
 // This test checks if configuration can be read from a JSON file.
 TEST_F(JSONFileBackendTest, jsonFile) {
@@ -602,6 +606,101 @@ TEST_F(JSONFileBackendTest, defaultLeaseDbBackend) {
     EXPECT_NO_THROW(static_cast<void>(LeaseMgrFactory::instance()));
 }
 
+// This test verifies that the lease database backend is not recreated when
+// the server is reconfigured with unchanged lease database parameters and
+// that the backend installs its timers again.
+TEST_F(JSONFileBackendTest, reconfigureUnchangedLeaseDbBackend) {
+    string config =
+        "{ \"Dhcp6\": {"
+        "\"interfaces-config\": {"
+        "    \"interfaces\": [ ]"
+        "},"
+        "\"lease-database\": {"
+        "     \"type\": \"memfile\","
+        "     \"name\": \"" + string(TEST_LEASE_FILE) + "\","
+        "     \"lfc-interval\": 3600"
+        "},"
+        "\"rebind-timer\": 2000, "
+        "\"renew-timer\": 1000, \n"
+        "\"subnet6\": [ ],"
+        "\"preferred-lifetime\": 3000, "
+        "\"valid-lifetime\": 4000 }"
+        "}";
+    writeFile(TEST_FILE, config);
+
+    // Create an instance of the server and intialize it.
+    boost::scoped_ptr<NakedControlledDhcpv6Srv> srv;
+    ASSERT_NO_THROW(srv.reset(new NakedControlledDhcpv6Srv()));
+    srv->setConfigFile(TEST_FILE);
+    ASSERT_NO_THROW(srv->init(TEST_FILE));
+
+    LeaseMgr* lease_mgr = &LeaseMgrFactory::instance();
+    DuidPtr duid(new DUID(DUID::fromText("00:01:02:03:04:05:06").getDuid()));
+    Lease6Ptr lease(new Lease6(Lease::TYPE_NA, IOAddress("3000::1"), duid,
+                               1, 3000, 4000, 1000, 2000, SubnetID(1)));
+    ASSERT_NO_THROW(lease_mgr->addLease(lease));
+
+    // Remove the lease file. If the backend was recreated, the lease
+    // would be gone.
+    static_cast<void>(remove(TEST_LEASE_FILE));
+
+    // Reconfigure the server using the same configuration.
+    srv->signal_handler_(SIGHUP);
+
+    EXPECT_EQ(lease_mgr, &LeaseMgrFactory::instance());
+    EXPECT_TRUE(LeaseMgrFactory::instance().getLease6(Lease::TYPE_NA,
+                                                      IOAddress("3000::1")));
+
+    // The server unregisters all timers before the reconfiguration, so
+    // the presence of the LFC timer means that it was installed again.
+    ASSERT_NO_THROW(TimerMgr::instance()->stopThread());
+    EXPECT_NO_THROW(TimerMgr::instance()->unregisterTimer("memfile-lfc"));
+}
+
+// This test verifies that the lease database backend is recreated when
+// the lease database parameters change during reconfiguration.
+TEST_F(JSONFileBackendTest, reconfigureChangedLeaseDbBackend) {
+    string config =
+        "{ \"Dhcp6\": {"
+        "\"interfaces-config\": {"
+        "    \"interfaces\": [ ]"
+        "},"
+        "\"lease-database\": {"
+        "     \"type\": \"memfile\","
+        "     \"name\": \"" + string(TEST_LEASE_FILE) + "\","
+        "     \"lfc-interval\": 3600"
+        "},"
+        "\"rebind-timer\": 2000, "
+        "\"renew-timer\": 1000, \n"
+        "\"subnet6\": [ ],"
+        "\"preferred-lifetime\": 3000, "
+        "\"valid-lifetime\": 4000 }"
+        "}";
+    writeFile(TEST_FILE, config);
+
+    boost::scoped_ptr<NakedControlledDhcpv6Srv> srv;
+    ASSERT_NO_THROW(srv.reset(new NakedControlledDhcpv6Srv()));
+    srv->setConfigFile(TEST_FILE);
+    ASSERT_NO_THROW(srv->init(TEST_FILE));
+
+    DuidPtr duid(new DUID(DUID::fromText("00:01:02:03:04:05:06").getDuid()));
+    Lease6Ptr lease(new Lease6(Lease::TYPE_NA, IOAddress("3000::1"), duid,
+                               1, 3000, 4000, 1000, 2000, SubnetID(1)));
+    ASSERT_NO_THROW(LeaseMgrFactory::instance().addLease(lease));
+    static_cast<void>(remove(TEST_LEASE_FILE));
+
+    // Change the LFC interval. The backend should be recreated and the
+    // lease should be gone with the lease file.
+    config.replace(config.find("3600"), 4, "1800");
+    writeFile(TEST_FILE, config);
+    srv->signal_handler_(SIGHUP);
+
+    EXPECT_FALSE(LeaseMgrFactory::instance().getLease6(Lease::TYPE_NA,
+                                                       IOAddress("3000::1")));
+    ASSERT_NO_THROW(TimerMgr::instance()->stopThread());
+    EXPECT_NO_THROW(TimerMgr::instance()->unregisterTimer("memfile-lfc"));
+}
+
 // Starting tests which require MySQL backend availability. Those tests
 // will not be executed if Kea has been compiled without the
 // --with-dhcp-mysql.
@@ -1,4 +1,4 @@
-// Copyright (C) 2010-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2010-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -10,8 +10,10 @@
 #include <asiolink/io_error.h>
 #include <exceptions/exceptions.h>
 
+#include <boost/functional/hash.hpp>
 #include <boost/static_assert.hpp>
 
+#include <algorithm>
 #include <unistd.h>             // for some IPC/network system calls
 #include <stdint.h>
 #include <sys/socket.h>
@@ -46,6 +48,12 @@ IOAddress::IOAddress(uint32_t v4address):
 
 }
 
+IOAddress::IOAddress(const IPv6Value& v6address) {
+    ip::address_v6::bytes_type bytes;
+    v6address.toBytes(&bytes[0]);
+    asio_address_ = ip::address_v6(bytes);
+}
+
 string
 IOAddress::toText() const {
     return (asio_address_.to_string());
@@ -61,10 +69,16 @@ IOAddress::fromBytes(short family, const uint8_t* data) {
                   << "are supported");
     }
 
-    BOOST_STATIC_ASSERT(INET6_ADDRSTRLEN >= INET_ADDRSTRLEN);
-    char addr_str[INET6_ADDRSTRLEN];
-    inet_ntop(family, data, addr_str, INET6_ADDRSTRLEN);
-    return IOAddress(string(addr_str));
+    // Construct the address directly from the binary data rather than
+    // converting it to the textual form and parsing it.
+    if (family == AF_INET) {
+        ip::address_v4::bytes_type bytes;
+        std::copy(data, data + V4ADDRESS_LEN, bytes.begin());
+        return (IOAddress(ip::address(ip::address_v4(bytes))));
+    }
+    ip::address_v6::bytes_type bytes;
+    std::copy(data, data + V6ADDRESS_LEN, bytes.begin());
+    return (IOAddress(ip::address(ip::address_v6(bytes))));
 }
 
 std::vector<uint8_t>
@@ -117,6 +131,33 @@ IOAddress::toUint32() const {
     }
 }
 
+IPv6Value
+IOAddress::toV6Value() const {
+    if (!asio_address_.is_v6()) {
+        isc_throw(BadValue, "Can't convert " << toText()
+                  << " address to IPv6.");
+    }
+    const ip::address_v6::bytes_type bytes = asio_address_.to_v6().to_bytes();
+    return (IPv6Value::fromBytes(&bytes[0]));
+}
+
+size_t
+IOAddress::hash() const {
+    if (asio_address_.is_v4()) {
+        return (boost::hash_value(asio_address_.to_v4().to_ulong()));
+    }
+    const ip::address_v6::bytes_type bytes = asio_address_.to_v6().to_bytes();
+    return (boost::hash_range(bytes.begin(), bytes.end()));
+}
+
+size_t
+hash_value(const IPv6Value& value) {
+    size_t seed = 0;
+    boost::hash_combine(seed, value.getHigh());
+    boost::hash_combine(seed, value.getLow());
+    return (seed);
+}
+
 std::ostream&
 operator<<(std::ostream& os, const IOAddress& address) {
     os << address.toText();
@@ -131,45 +172,20 @@ IOAddress::subtract(const IOAddress& a, const IOAddress& b) {
     if (a.isV4()) {
         // Subtracting v4 is easy. We have a conversion function to uint32_t.
         return (IOAddress(a.toUint32() - b.toUint32()));
-    } else {
-        // v6 is more involved.
-
-        // Let's extract the raw data first.
-        vector<uint8_t> a_vec = a.toBytes();
-        vector<uint8_t> b_vec = b.toBytes();
-
-        // ... and prepare the result
-        vector<uint8_t> result(V6ADDRESS_LEN,0);
-
-        // Carry is a boolean, but to avoid its frequent casting, let's
-        // use uint8_t. Also, some would prefer to call it borrow, but I prefer
-        // carry. Somewhat relevant discussion here:
-        // http://en.wikipedia.org/wiki/Carry_flag#Carry_flag_vs._Borrow_flag
-        uint8_t carry = 0;
-
-        // Now perform subtraction with borrow.
-        for (int i = a_vec.size() - 1; i >= 0; --i) {
-            result[i] = a_vec[i] - b_vec[i] - carry;
-            carry = (a_vec[i] < b_vec[i] + carry);
-        }
-
-        return (fromBytes(AF_INET6, &result[0]));
     }
+    // The same applies to v6 using the 128-bit integers.
+    return (IOAddress(a.toV6Value() - b.toV6Value()));
 }
 
 IOAddress
 IOAddress::increase(const IOAddress& addr) {
-    std::vector<uint8_t> packed(addr.toBytes());
-
-    // Start increasing the least significant byte
-    for (int i = packed.size() - 1; i >= 0; --i) {
-        // if we haven't overflowed (0xff -> 0x0), than we are done
-        if (++packed[i] != 0) {
-            break;
-        }
+    // Both the uint32_t and the IPv6Value loop over to zero when
+    // increasing the maximum value.
+    if (addr.isV4()) {
+        return (IOAddress(addr.toUint32() + 1));
     }
-
-    return (IOAddress::fromBytes(addr.getFamily(), &packed[0]));
+    IPv6Value value = addr.toV6Value();
+    return (IOAddress(++value));
 }
 
 
@@ -1,4 +1,4 @@
-// Copyright (C) 2010-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2010-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -29,6 +29,8 @@ namespace asiolink {
     /// Defines length of IPv4 address.
     const static size_t V4ADDRESS_LEN = 4;
 
+class IPv6Value;
+
 /// \brief The \c IOAddress class represents an IP addresses (version
 /// agnostic)
 ///
@@ -74,6 +76,14 @@ public:
     /// @param v4address IPv4 address represnted by uint32_t
     IOAddress(uint32_t v4address);
 
+    /// @brief Constructor for ip::address_v6 object.
+    ///
+    /// This constructor is intended to be used when constructing IPv6
+    /// address out of the 128-bit integer, e.g. in the address arithmetic.
+    ///
+    /// @param v6address IPv6 address represented by @c IPv6Value.
+    explicit IOAddress(const IPv6Value& v6address);
+
     /// \brief Convert the address to a string.
     ///
     /// This method is basically expected to be exception free, but
@@ -186,14 +196,15 @@ public:
     /// Comparisons between v4 and v6 will allways return v4
     /// being smaller. This follows boost::boost::asio::ip implementation
     bool lessThan(const IOAddress& other) const {
-        if (this->getFamily() == other.getFamily()) {
-            if (this->getFamily() == AF_INET6) {
-                return (this->asio_address_.to_v6() < other.asio_address_.to_v6());
-            } else {
-                return (this->asio_address_.to_v4() < other.asio_address_.to_v4());
-            }
+        const bool v4 = asio_address_.is_v4();
+        if (v4 != other.asio_address_.is_v4()) {
+            return (v4);
         }
-        return (this->getFamily() < other.getFamily());
+        if (v4) {
+            return (asio_address_.to_v4().to_ulong() <
+                    other.asio_address_.to_v4().to_ulong());
+        }
+        return (asio_address_.to_v6() < other.asio_address_.to_v6());
     }
 
     /// \brief Checks if one address is smaller or equal than the other
@@ -287,6 +298,25 @@ public:
     ///         network byte order
     uint32_t toUint32() const;
 
+    /// @brief Converts IPv6 address to the 128-bit integer.
+    ///
+    /// This is the IPv6 counterpart of the @c toUint32. The returned
+    /// value is cheap to compare, increase and subtract, so it should
+    /// be used in the performance critical address arithmetic.
+    ///
+    /// @throw BadValue if the address is not an IPv6 address.
+    /// @return @c IPv6Value representing the address.
+    IPv6Value toV6Value() const;
+
+    /// @brief Returns a hash value of the address.
+    ///
+    /// The hash is computed directly from the binary form of the address
+    /// without any memory allocation, so it is suitable for use in the
+    /// hashed containers indexed by addresses.
+    ///
+    /// @return Hash value.
+    size_t hash() const;
+
     /// @name Methods returning @c IOAddress objects encapsulating typical addresses.
     ///
     //@{
@@ -314,6 +344,136 @@ private:
     boost::asio::ip::address asio_address_;
 };
 
+/// @brief Compact representation of an IPv6 address.
+///
+/// The address is held as a 128-bit unsigned integer made of two 64-bit
+/// halves in the host byte order. Unlike @c IOAddress, which wraps the
+/// protocol agnostic @c boost::asio::ip::address, this class is dedicated
+/// to the IPv6 addresses, so the comparisons and the arithmetic operations
+/// are performed on integers without checking the address family. The
+/// IPv4 counterpart of this class is a uint32_t returned by
+/// @c IOAddress::toUint32.
+///
+/// This class is used as a key of the containers holding large numbers of
+/// addresses and in the allocation engine. The @c IOAddress remains the
+/// type used in the APIs.
+class IPv6Value {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// @param high Most significant 64 bits of the address.
+    /// @param low Least significant 64 bits of the address.
+    explicit IPv6Value(const uint64_t high = 0, const uint64_t low = 0)
+        : high_(high), low_(low) {
+    }
+
+    /// @brief Creates the value from the address in the network byte order.
+    ///
+    /// @param data Pointer to the 16 bytes of the address.
+    /// @return Created value.
+    static IPv6Value fromBytes(const uint8_t* data) {
+        uint64_t high = 0;
+        uint64_t low = 0;
+        for (size_t i = 0; i < V6ADDRESS_LEN / 2; ++i) {
+            high = (high << 8) | data[i];
+            low = (low << 8) | data[i + V6ADDRESS_LEN / 2];
+        }
+        return (IPv6Value(high, low));
+    }
+
+    /// @brief Writes the value in the network byte order.
+    ///
+    /// @param [out] data Pointer to the 16 bytes buffer.
+    void toBytes(uint8_t* data) const {
+        for (size_t i = 0; i < V6ADDRESS_LEN / 2; ++i) {
+            const size_t shift = 8 * (V6ADDRESS_LEN / 2 - 1 - i);
+            data[i] = static_cast<uint8_t>(high_ >> shift);
+            data[i + V6ADDRESS_LEN / 2] = static_cast<uint8_t>(low_ >> shift);
+        }
+    }
+
+    /// @brief Returns the value with only the specified bit set.
+    ///
+    /// @param bit Number of the bit, from 0 (least significant) to 127.
+    /// @return 2 to the power of @c bit.
+    static IPv6Value powerOfTwo(const uint8_t bit) {
+        if (bit < 64) {
+            return (IPv6Value(0, static_cast<uint64_t>(1) << bit));
+        }
+        return (IPv6Value(static_cast<uint64_t>(1) << (bit - 64), 0));
+    }
+
+    /// @brief Returns the most significant 64 bits of the address.
+    uint64_t getHigh() const {
+        return (high_);
+    }
+
+    /// @brief Returns the least significant 64 bits of the address.
+    uint64_t getLow() const {
+        return (low_);
+    }
+
+    /// @brief Adds two values modulo 2^128.
+    ///
+    /// @param other Value to be added.
+    IPv6Value operator+(const IPv6Value& other) const {
+        const uint64_t low = low_ + other.low_;
+        return (IPv6Value(high_ + other.high_ + (low < low_ ? 1 : 0), low));
+    }
+
+    /// @brief Subtracts two values modulo 2^128.
+    ///
+    /// @param other Value to be subtracted.
+    IPv6Value operator-(const IPv6Value& other) const {
+        return (IPv6Value(high_ - other.high_ - (low_ < other.low_ ? 1 : 0),
+                          low_ - other.low_));
+    }
+
+    /// @brief Increases the value by one (modulo 2^128).
+    IPv6Value& operator++() {
+        if (++low_ == 0) {
+            ++high_;
+        }
+        return (*this);
+    }
+
+    /// @brief Compares values for equality.
+    bool operator==(const IPv6Value& other) const {
+        return ((high_ == other.high_) && (low_ == other.low_));
+    }
+
+    /// @brief Compares values for inequality.
+    bool operator!=(const IPv6Value& other) const {
+        return (!(*this == other));
+    }
+
+    /// @brief Checks if this value is smaller than the other.
+    bool operator<(const IPv6Value& other) const {
+        return ((high_ < other.high_) ||
+                ((high_ == other.high_) && (low_ < other.low_)));
+    }
+
+    /// @brief Checks if this value is smaller or equal than the other.
+    bool operator<=(const IPv6Value& other) const {
+        return (!(other < *this));
+    }
+
+private:
+
+    /// @brief Most significant 64 bits.
+    uint64_t high_;
+
+    /// @brief Least significant 64 bits.
+    uint64_t low_;
+};
+
+/// @brief Returns a hash value of the IPv6 address.
+///
+/// @param value Address to be hashed.
+/// @return Hash value.
+size_t hash_value(const IPv6Value& value);
+
 /// \brief Insert the IOAddress as a string into stream.
 ///
 /// This method converts the \c address into a string and inserts it
@@ -330,6 +490,19 @@ private:
 std::ostream&
 operator<<(std::ostream& os, const IOAddress& address);
 
+/// @brief Returns a hash value of the address.
+///
+/// This function is found by @c boost::hash, which makes it possible to
+/// use @c IOAddress as a key of the hashed indexes of the
+/// @c boost::multi_index_container.
+///
+/// @param address Address to be hashed.
+/// @return Hash value.
+inline size_t
+hash_value(const IOAddress& address) {
+    return (address.hash());
+}
+
 } // namespace asiolink
 } // namespace isc
 #endif // IO_ADDRESS_H
@@ -1,4 +1,4 @@
-// Copyright (C) 2011-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2011-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -11,6 +11,9 @@
 #include <asiolink/io_address.h>
 #include <exceptions/exceptions.h>
 
+#include <boost/functional/hash.hpp>
+#include <boost/type_traits/is_convertible.hpp>
+
 #include <algorithm>
 #include <cstring>
 #include <vector>
@@ -339,3 +342,80 @@ TEST(IOAddressTest, increaseAddr) {
     EXPECT_EQ(IOAddress("::1"), IOAddress::increase(any6));
     EXPECT_EQ(IOAddress("::"), IOAddress::increase(the_last_one));
 }
+
+// Tests that equal addresses have equal hash values and that the hash
+// function is usable with boost::hash.
+TEST(IOAddressTest, hash) {
+    boost::hash<IOAddress> hasher;
+
+    EXPECT_EQ(IOAddress("192.0.2.1").hash(), IOAddress("192.0.2.1").hash());
+    EXPECT_EQ(hasher(IOAddress("192.0.2.1")), IOAddress("192.0.2.1").hash());
+    EXPECT_NE(IOAddress("192.0.2.1").hash(), IOAddress("192.0.2.2").hash());
+
+    EXPECT_EQ(IOAddress("2001:db8::1").hash(),
+              IOAddress("2001:db8:0::1").hash());
+    EXPECT_EQ(hasher(IOAddress("2001:db8::1")), IOAddress("2001:db8::1").hash());
+    EXPECT_NE(IOAddress("2001:db8::1").hash(), IOAddress("2001:db8::2").hash());
+}
+
+// Checks that the IPv6 address can be converted to the 128-bit integer
+// and back.
+TEST(IOAddressTest, v6Value) {
+    IPv6Value value = IOAddress("2001:db8::1:ff").toV6Value();
+    EXPECT_EQ(0x20010db800000000ull, value.getHigh());
+    EXPECT_EQ(0x00000000000100ffull, value.getLow());
+    EXPECT_EQ("2001:db8::1:ff", IOAddress(value).toText());
+
+    value = IOAddress("ffff:ffff:ffff:ffff:ffff:ffff:ffff:ffff").toV6Value();
+    EXPECT_EQ(0xffffffffffffffffull, value.getHigh());
+    EXPECT_EQ(0xffffffffffffffffull, value.getLow());
+
+    EXPECT_EQ("::", IOAddress(IPv6Value()).toText());
+
+    // IPv4 addresses are converted using toUint32.
+    EXPECT_THROW(IOAddress("192.0.2.1").toV6Value(), isc::BadValue);
+}
+
+// Checks the arithmetic and the comparison of the IPv6 values.
+TEST(IOAddressTest, v6ValueArithmetic) {
+    const IPv6Value low_max(0, 0xffffffffffffffffull);
+
+    // Carry to the most significant part.
+    EXPECT_TRUE(IPv6Value(1, 0) == low_max + IPv6Value(0, 1));
+    EXPECT_TRUE(low_max == IPv6Value(1, 0) - IPv6Value(0, 1));
+
+    // Overflow and underflow.
+    const IPv6Value max(0xffffffffffffffffull, 0xffffffffffffffffull);
+    EXPECT_TRUE(IPv6Value() == max + IPv6Value(0, 1));
+    EXPECT_TRUE(max == IPv6Value() - IPv6Value(0, 1));
+
+    IPv6Value value = low_max;
+    EXPECT_TRUE(IPv6Value(1, 0) == ++value);
+    value = max;
+    EXPECT_TRUE(IPv6Value() == ++value);
+
+    EXPECT_TRUE(IPv6Value(0, 1) == IPv6Value::powerOfTwo(0));
+    EXPECT_TRUE(IPv6Value(0, 0x8000000000000000ull) ==
+                IPv6Value::powerOfTwo(63));
+    EXPECT_TRUE(IPv6Value(1, 0) == IPv6Value::powerOfTwo(64));
+    EXPECT_TRUE(IPv6Value(0x8000000000000000ull, 0) ==
+                IPv6Value::powerOfTwo(127));
+
+    EXPECT_TRUE(IPv6Value(0, 1) < IPv6Value(0, 2));
+    EXPECT_TRUE(low_max < IPv6Value(1, 0));
+    EXPECT_FALSE(IPv6Value(1, 0) < low_max);
+    EXPECT_TRUE(IPv6Value(1, 0) <= IPv6Value(1, 0));
+    EXPECT_FALSE(IPv6Value(1, 1) <= IPv6Value(1, 0));
+    EXPECT_TRUE(IPv6Value(1, 1) != IPv6Value(1, 0));
+
+    // The integers aren't silently converted to the values.
+    EXPECT_FALSE((boost::is_convertible<int, IPv6Value>::value));
+    EXPECT_FALSE((boost::is_convertible<uint64_t, IPv6Value>::value));
+
+    // The ordering must be the same as the ordering of the addresses.
+    EXPECT_TRUE(IOAddress("2001:db8::ffff").toV6Value() <
+                IOAddress("2001:db8:0:1::").toV6Value());
+
+    EXPECT_EQ(hash_value(IPv6Value(1, 2)), hash_value(IPv6Value(1, 2)));
+    EXPECT_NE(hash_value(IPv6Value(1, 2)), hash_value(IPv6Value(2, 1)));
+}
@@ -0,0 +1,249 @@
+// Copyright (C) 2017 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/// @file data_bench.cc
+///
+/// Measures the time of parsing JSON text into the @c isc::data::Element
+/// trees. The program parses:
+/// - the JSON payload of a typical name change request sent by the DHCP
+///   servers to the DHCP-DDNS server,
+/// - the configuration files given on the command line, or the example
+///   configuration files if none is given, with the comments removed
+///   the same way the servers remove them,
+/// - a generated configuration with many subnets and reservations, which
+///   size is similar to the size of the large production configurations,
+///   with the elements allocated from the heap and from the
+///   @c ElementArena. Each of them is parsed in a separate process, so as
+///   the peak memory usage can be reported.
+/// The average time of a single parse and the throughput are printed.
+
+#include <config.h>
+#include <cc/data.h>
+#include <cc/element_arena.h>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <sys/resource.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace isc::data;
+
+namespace {
+
+/// @brief Minimal number of operations performed for each input.
+const size_t OPERATIONS = 100000;
+
+/// @brief Minimal number of bytes parsed for each input.
+const size_t TOTAL_BYTES = 256 * 1024 * 1024;
+
+/// @brief Number of subnets in the generated configuration.
+const size_t SUBNETS = 10000;
+
+/// @brief Number of reservations per subnet in the generated configuration.
+const size_t RESERVATIONS = 16;
+
+/// @brief Example configuration files parsed when no file is specified.
+const char* EXAMPLES[] = {
+    "kea4/classify.json",
+    "kea4/multiple-options.json",
+    "kea4/reservations.json",
+    "kea4/several-subnets.json",
+    "kea6/classify.json",
+    "kea6/multiple-options.json",
+    "kea6/reservations.json",
+    "kea6/several-subnets.json",
+    "ddns/sample1.json"
+};
+
+/// @brief JSON payload of the name change request.
+const char* NCR =
+    "{\"change-type\":0,\"forward-change\":true,\"reverse-change\":false,"
+    "\"fqdn\":\"walah.walah.com.\",\"ip-address\":\"192.168.2.1\","
+    "\"dhcid\":\"010203040A7F8E3D\",\"lease-expires-on\":\"20130121132405\","
+    "\"lease-length\":1300}";
+
+/// @brief Creates the configuration with many subnets and reservations.
+std::string
+generateConfig() {
+    std::ostringstream s;
+    s << "{ \"Dhcp4\": {\n"
+      << "    \"valid-lifetime\": 4000,\n"
+      << "    \"subnet4\": [\n";
+    for (size_t i = 0; i < SUBNETS; ++i) {
+        const size_t a = (i >> 8) & 0xFF;
+        const size_t b = i & 0xFF;
+        s << (i > 0 ? ",\n" : "")
+          << "        {\n"
+          << "            \"id\": " << (i + 1) << ",\n"
+          << "            \"subnet\": \"10." << a << "." << b << ".0/24\",\n"
+          << "            \"pools\": [ { \"pool\": \"10." << a << "." << b
+          << ".100 - 10." << a << "." << b << ".200\" } ],\n"
+          << "            \"option-data\": [ { \"name\": \"routers\", "
+          << "\"data\": \"10." << a << "." << b << ".1\" } ],\n"
+          << "            \"reservations\": [\n";
+        for (size_t j = 0; j < RESERVATIONS; ++j) {
+            s << (j > 0 ? ",\n" : "")
+              << "                { \"hw-address\": \"1a:1b:1c:"
+              << std::hex << std::setfill('0') << std::setw(2) << a << ":"
+              << std::setw(2) << b << ":" << std::setw(2) << j << std::dec
+              << "\", \"ip-address\": \"10." << a << "." << b << "."
+              << (j + 10) << "\", \"hostname\": \"host-" << i << "-" << j
+              << ".example.org\" }";
+        }
+        s << "\n            ]\n"
+          << "        }";
+    }
+    s << "\n    ]\n"
+      << "} }\n";
+    return (s.str());
+}
+
+/// @brief Parses the JSON text repeatedly and prints the results.
+///
+/// @param name Name of the input.
+/// @param text JSON text.
+/// @param preproc Indicates if the comments should be removed.
+/// @param arena Indicates if the elements should be allocated from the
+/// @c ElementArena.
+void
+benchmark(const std::string& name, const std::string& text,
+          const bool preproc, const bool arena = false) {
+    size_t operations = TOTAL_BYTES / (text.size() + 1);
+    if (operations < 1) {
+        operations = 1;
+    } else if (operations > OPERATIONS) {
+        operations = OPERATIONS;
+    }
+
+    size_t elements = 0;
+    boost::posix_time::ptime start =
+        boost::posix_time::microsec_clock::universal_time();
+    try {
+        for (size_t i = 0; i < operations; ++i) {
+            boost::scoped_ptr<ElementArena> element_arena(arena ?
+                                                          new ElementArena() :
+                                                          0);
+            ConstElementPtr parsed = Element::fromJSON(text, preproc);
+            element_arena.reset();
+            elements += parsed->size();
+        }
+    } catch (const std::exception& ex) {
+        std::cout << "  " << name << ": " << ex.what() << std::endl;
+        return;
+    }
+    boost::posix_time::time_duration elapsed =
+        boost::posix_time::microsec_clock::universal_time() - start;
+
+    const double us = static_cast<double>(elapsed.total_microseconds());
+    std::cout << "  " << std::left << std::setw(28) << name
+              << std::right << std::setw(10) << text.size() << " bytes"
+              << std::setw(14) << std::fixed << std::setprecision(1)
+              << (us * 1000.0 / operations) << " ns/op"
+              << std::setw(10) << std::setprecision(1)
+              << (us > 0 ? text.size() * operations / us : 0.0) << " MB/s ("
+              << elements << ")" << std::endl;
+}
+
+/// @brief Parses the generated configuration in a child process.
+///
+/// The peak memory usage of the child process is printed.
+///
+/// @param name Name of the input.
+/// @param text JSON text.
+/// @param arena Indicates if the elements should be allocated from the
+/// @c ElementArena.
+void
+benchmarkChild(const std::string& name, const std::string& text,
+               const bool arena) {
+    std::cout.flush();
+    pid_t pid = fork();
+    if (pid < 0) {
+        std::cerr << "fork failed" << std::endl;
+        return;
+
+    } else if (pid == 0) {
+        benchmark(name, text, false, arena);
+        std::cout.flush();
+        _exit(EXIT_SUCCESS);
+    }
+
+    int status = 0;
+    struct rusage usage;
+    if (wait4(pid, &status, 0, &usage) == pid) {
+        std::cout << "  " << std::left << std::setw(28) << "" << std::right
+                  << std::setw(10) << usage.ru_maxrss << " kB peak RSS"
+                  << std::endl;
+    }
+}
+
+/// @brief Reads the file contents.
+///
+/// @param path Path to the file.
+/// @param [out] text File contents.
+///
+/// @return true if the file has been read, false otherwise.
+bool
+readFile(const std::string& path, std::string& text) {
+    std::ifstream f(path.c_str());
+    if (!f.good()) {
+        return (false);
+    }
+    std::ostringstream s;
+    s << f.rdbuf();
+    text = s.str();
+    return (true);
+}
+
+}
+
+int
+main(int argc, char* argv[]) {
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i) {
+        files.push_back(argv[i]);
+    }
+    if (files.empty()) {
+        for (size_t i = 0; i < sizeof(EXAMPLES) / sizeof(EXAMPLES[0]); ++i) {
+            files.push_back(std::string(EXAMPLES_DIR) + "/" + EXAMPLES[i]);
+        }
+    }
+
+    std::cout << "name change request:" << std::endl;
+    benchmark("ncr", NCR, false);
+
+    std::cout << "configuration files:" << std::endl;
+    for (std::vector<std::string>::const_iterator file = files.begin();
+         file != files.end(); ++file) {
+        std::string text;
+        if (!readFile(*file, text)) {
+            std::cerr << "unable to read " << *file << std::endl;
+            return (EXIT_FAILURE);
+        }
+        const size_t slash = file->find_last_of('/');
+        const size_t dir = (slash == std::string::npos || slash == 0 ?
+                            std::string::npos :
+                            file->find_last_of('/', slash - 1));
+        benchmark(dir == std::string::npos ? *file : file->substr(dir + 1),
+                  text, true);
+    }
+
+    std::cout << "generated configuration (" << SUBNETS << " subnets, "
+              << RESERVATIONS << " reservations each):" << std::endl;
+    const std::string generated = generateConfig();
+    benchmarkChild("generated", generated, false);
+    benchmarkChild("generated (arena)", generated, true);
+
+    return (EXIT_SUCCESS);
+}
@@ -7,6 +7,7 @@
 #include <config.h>
 
 #include <cc/data.h>
+#include <cc/element_arena.h>
 
 #include <cstring>
 #include <cassert>
@@ -21,8 +22,15 @@
 #include <cerrno>
 
 #include <boost/lexical_cast.hpp>
+#include <boost/make_shared.hpp>
 
+#include <cctype>
 #include <cmath>
+#include <iterator>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 using namespace std;
 
@@ -215,17 +223,29 @@ bool operator!=(const Element& a, const Element& b) {
     return (!a.equals(b));
 };
 
+void*
+Element::operator new(size_t size) {
+    return (ElementArena::allocate(size));
+}
+
+void
+Element::operator delete(void* ptr) {
+    ElementArena::deallocate(ptr);
+}
+
 //
 // factory functions
 //
 ElementPtr
 Element::create(const Position& pos) {
-    return (ElementPtr(new NullElement(pos)));
+    return (boost::allocate_shared<NullElement>(ElementAllocator<Element>(),
+                                                pos));
 }
 
 ElementPtr
 Element::create(const long long int i, const Position& pos) {
-    return (ElementPtr(new IntElement(static_cast<int64_t>(i), pos)));
+    return (boost::allocate_shared<IntElement>(ElementAllocator<Element>(),
+                                               static_cast<int64_t>(i), pos));
 }
 
 ElementPtr
@@ -240,17 +260,20 @@ Element::create(const long int i, const Position& pos) {
 
 ElementPtr
 Element::create(const double d, const Position& pos) {
-    return (ElementPtr(new DoubleElement(d, pos)));
+    return (boost::allocate_shared<DoubleElement>(ElementAllocator<Element>(),
+                                                  d, pos));
 }
 
 ElementPtr
 Element::create(const bool b, const Position& pos) {
-    return (ElementPtr(new BoolElement(b, pos)));
+    return (boost::allocate_shared<BoolElement>(ElementAllocator<Element>(),
+                                                b, pos));
 }
 
 ElementPtr
 Element::create(const std::string& s, const Position& pos) {
-    return (ElementPtr(new StringElement(s, pos)));
+    return (boost::allocate_shared<StringElement>(ElementAllocator<Element>(),
+                                                  s, pos));
 }
 
 ElementPtr
@@ -260,12 +283,14 @@ Element::create(const char *s, const Position& pos) {
 
 ElementPtr
 Element::createList(const Position& pos) {
-    return (ElementPtr(new ListElement(pos)));
+    return (boost::allocate_shared<ListElement>(ElementAllocator<Element>(),
+                                                pos));
 }
 
 ElementPtr
 Element::createMap(const Position& pos) {
-    return (ElementPtr(new MapElement(pos)));
+    return (boost::allocate_shared<MapElement>(ElementAllocator<Element>(),
+                                               pos));
 }
 
 
@@ -284,139 +309,308 @@ charIn(const int c, const char* chars) {
     return (false);
 }
 
-void
-skipChars(std::istream& in, const char* chars, int& line, int& pos) {
-    int c = in.peek();
-    while (charIn(c, chars) && c != EOF) {
-        if (c == '\n') {
-            ++line;
-            pos = 1;
-        } else {
-            ++pos;
-        }
-        in.ignore();
-        c = in.peek();
+/// @brief Checks if the character is one of the @c WHITESPACE.
+inline bool
+isWhitespace(const int c) {
+    switch (c) {
+    case ' ':
+    case '\b':
+    case '\f':
+    case '\n':
+    case '\r':
+    case '\t':
+        return (true);
+    default:
+        return (false);
     }
 }
 
-// skip on the input stream to one of the characters in chars
-// if another character is found this function throws JSONError
-// unless that character is specified in the optional may_skip
-//
-// It returns the found character (as an int value).
+/// @brief Returns the first double quote or backslash in the buffer.
+///
+/// The buffer is scanned 16 bytes at a time using SSE2 instructions
+/// when they are available.
+///
+/// @param begin Beginning of the buffer.
+/// @param end End of the buffer.
+///
+/// @return Pointer to the character found or @c end.
+const char*
+findStringDelimiter(const char* begin, const char* end) {
+#if defined(__SSE2__) && defined(__GNUC__)
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    while (end - begin >= 16) {
+        const __m128i data =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+        const int mask =
+            _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(data, quote),
+                                           _mm_cmpeq_epi8(data, backslash)));
+        if (mask != 0) {
+            return (begin + __builtin_ctz(mask));
+        }
+        begin += 16;
+    }
+#endif
+    while ((begin < end) && (*begin != '"') && (*begin != '\\')) {
+        ++begin;
+    }
+    return (begin);
+}
+
+/// @brief JSON parser operating on a buffer.
+///
+/// The parser creates the same elements and reports the same errors,
+/// including their positions, as parsing the stream character by
+/// character. It doesn't copy the data and scans the strings in bulk.
+class JSONParser {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// @param begin Beginning of the buffer holding JSON data.
+    /// @param end End of the buffer.
+    /// @param file The input file name.
+    /// @param line A reference to the int where the parser keeps track
+    /// of the current line.
+    /// @param pos A reference to the int where the parser keeps track
+    /// of the current position within the current line.
+    JSONParser(const char* begin, const char* end, const std::string& file,
+               int& line, int& pos)
+        : begin_(begin), cur_(begin), end_(end), file_(file), line_(line),
+          pos_(pos), eof_read_(false) {
+    }
+
+    /// @brief Parses the element at the current position.
+    ElementPtr parseElement();
+
+    /// @brief Skips whitespace at the current position.
+    void skipWhitespace() {
+        while (isWhitespace(peek())) {
+            if (*cur_ == '\n') {
+                ++line_;
+                pos_ = 1;
+            } else {
+                ++pos_;
+            }
+            ++cur_;
+        }
+    }
+
+    /// @brief Checks if all data has been parsed.
+    bool atEnd() const {
+        return (cur_ >= end_);
+    }
+
+    /// @brief Returns the number of characters parsed.
+    size_t getParsedLength() const {
+        return (cur_ - begin_);
+    }
+
+    /// @brief Checks if the parser has attempted to read past the end
+    /// of the buffer.
+    bool eofRead() const {
+        return (eof_read_);
+    }
+
+private:
+
+    /// @brief Returns the current character without consuming it.
+    int peek() {
+        if (cur_ < end_) {
+            return (static_cast<unsigned char>(*cur_));
+        }
+        eof_read_ = true;
+        return (EOF);
+    }
+
+    /// @brief Consumes and returns the current character.
+    int get() {
+        if (cur_ < end_) {
+            return (static_cast<unsigned char>(*cur_++));
+        }
+        eof_read_ = true;
+        return (EOF);
+    }
+
+    /// @brief Throws JSONError for the current line and position.
+    ///
+    /// @param error Error message.
+    void throwError(const std::string& error) const {
+        throwJSONError(error, file_, line_, pos_);
+    }
+
+    /// @brief Skips to one of the specified characters.
+    ///
+    /// If another character is found this function throws JSONError
+    /// unless that character is specified in the optional may_skip.
+    ///
+    /// @return the found character (as an int value).
+    int skipTo(const char* chars, const char* may_skip = "");
+
+    /// @brief Parses string at the current position.
+    std::string parseString();
+
+    /// @brief Parses a word consisting of letters.
+    std::string parseWord();
+
+    /// @brief Parses the characters which may constitute a number.
+    std::string parseNumberChars();
+
+    /// @brief Parses number element.
+    ElementPtr parseNumber();
+
+    /// @brief Parses boolean element.
+    ElementPtr parseBool();
+
+    /// @brief Parses null element.
+    ElementPtr parseNull();
+
+    /// @brief Parses string element.
+    ElementPtr parseStringElement();
+
+    /// @brief Parses list element, following the opening bracket.
+    ElementPtr parseList();
+
+    /// @brief Parses map element, following the opening curly bracket.
+    ElementPtr parseMap();
+
+    /// @brief Beginning of the buffer.
+    const char* begin_;
+
+    /// @brief Current position in the buffer.
+    const char* cur_;
+
+    /// @brief End of the buffer.
+    const char* end_;
+
+    /// @brief The input file name.
+    const std::string& file_;
+
+    /// @brief Current line.
+    int& line_;
+
+    /// @brief Current position within the current line.
+    int& pos_;
+
+    /// @brief Indicates if the parser has attempted to read past the end
+    /// of the buffer.
+    bool eof_read_;
+};
+
 int
-skipTo(std::istream& in, const std::string& file, int& line,
-       int& pos, const char* chars, const char* may_skip="")
-{
-    int c = in.get();
-    ++pos;
+JSONParser::skipTo(const char* chars, const char* may_skip) {
+    int c = get();
+    ++pos_;
     while (c != EOF) {
         if (c == '\n') {
-            pos = 1;
-            ++line;
+            pos_ = 1;
+            ++line_;
         }
         if (charIn(c, may_skip)) {
-            c = in.get();
-            ++pos;
+            c = get();
+            ++pos_;
         } else if (charIn(c, chars)) {
-            while (charIn(in.peek(), may_skip)) {
-                if (in.peek() == '\n') {
-                    pos = 1;
-                    ++line;
+            while (charIn(peek(), may_skip)) {
+                if (*cur_ == '\n') {
+                    pos_ = 1;
+                    ++line_;
                 } else {
-                    ++pos;
+                    ++pos_;
                 }
-                in.ignore();
+                ++cur_;
             }
             return (c);
         } else {
-            throwJSONError(std::string("'") + std::string(1, c) + "' read, one of \"" + chars + "\" expected", file, line, pos);
+            throwError(std::string("'") + std::string(1, c) + "' read, one of \"" + chars + "\" expected");
         }
     }
-    throwJSONError(std::string("EOF read, one of \"") + chars + "\" expected", file, line, pos);
+    throwError(std::string("EOF read, one of \"") + chars + "\" expected");
     return (c); // shouldn't reach here, but some compilers require it
 }
 
 // TODO: Should we check for all other official escapes here (and
 // error on the rest)?
 std::string
-strFromStringstream(std::istream& in, const std::string& file,
-                    const int line, int& pos) throw (JSONError)
-{
-    std::stringstream ss;
-    int c = in.get();
-    ++pos;
-    if (c == '"') {
-        c = in.get();
-        ++pos;
-    } else {
-        throwJSONError("String expected", file, line, pos);
+JSONParser::parseString() {
+    int c = get();
+    ++pos_;
+    if (c != '"') {
+        throwError("String expected");
     }
 
-    while (c != EOF && c != '"') {
-        if (c == '\\') {
-            // see the spec for allowed escape characters
-            switch (in.peek()) {
-            case '"':
-                c = '"';
-                break;
-            case '/':
-                c = '/';
-                break;
-            case '\\':
-                c = '\\';
-                break;
-            case 'b':
-                c = '\b';
-                break;
-            case 'f':
-                c = '\f';
-                break;
-            case 'n':
-                c = '\n';
-                break;
-            case 'r':
-                c = '\r';
-                break;
-            case 't':
-                c = '\t';
-                break;
-            default:
-                throwJSONError("Bad escape", file, line, pos);
-            }
-            // drop the escaped char
-            in.ignore();
-            ++pos;
+    std::string result;
+    for (;;) {
+        // Copy the characters up to the closing quote or escape at once.
+        const char* run_end = findStringDelimiter(cur_, end_);
+        result.append(cur_, run_end);
+        pos_ += run_end - cur_;
+        cur_ = run_end;
+
+        c = get();
+        ++pos_;
+        if (c == EOF) {
+            throwError("Unterminated string");
+        } else if (c == '"') {
+            return (result);
         }
-        ss.put(c);
-        c = in.get();
-        ++pos;
-    }
-    if (c == EOF) {
-        throwJSONError("Unterminated string", file, line, pos);
+
+        // see the spec for allowed escape characters
+        switch (peek()) {
+        case '"':
+            c = '"';
+            break;
+        case '/':
+            c = '/';
+            break;
+        case '\\':
+            c = '\\';
+            break;
+        case 'b':
+            c = '\b';
+            break;
+        case 'f':
+            c = '\f';
+            break;
+        case 'n':
+            c = '\n';
+            break;
+        case 'r':
+            c = '\r';
+            break;
+        case 't':
+            c = '\t';
+            break;
+        default:
+            throwError("Bad escape");
+        }
+        // drop the escaped char
+        ++cur_;
+        ++pos_;
+        result.push_back(static_cast<char>(c));
     }
-    return (ss.str());
 }
 
 std::string
-wordFromStringstream(std::istream& in, int& pos) {
-    std::stringstream ss;
-    while (isalpha(in.peek())) {
-        ss << (char) in.get();
+JSONParser::parseWord() {
+    const char* start = cur_;
+    while (isalpha(peek())) {
+        ++cur_;
     }
-    pos += ss.str().size();
-    return (ss.str());
+    pos_ += cur_ - start;
+    return (std::string(start, cur_));
 }
 
 std::string
-numberFromStringstream(std::istream& in, int& pos) {
-    std::stringstream ss;
-    while (isdigit(in.peek()) || in.peek() == '+' || in.peek() == '-' ||
-           in.peek() == '.' || in.peek() == 'e' || in.peek() == 'E') {
-        ss << (char) in.get();
+JSONParser::parseNumberChars() {
+    const char* start = cur_;
+    int c = peek();
+    while (isdigit(c) || c == '+' || c == '-' || c == '.' || c == 'e' ||
+           c == 'E') {
+        ++cur_;
+        c = peek();
     }
-    pos += ss.str().size();
-    return (ss.str());
+    pos_ += cur_ - start;
+    return (std::string(start, cur_));
 }
 
 // Should we change from IntElement and DoubleElement to NumberElement
@@ -424,137 +618,271 @@ numberFromStringstream(std::istream& in, int& pos) {
 // value is larger than an int can handle)
 //
 ElementPtr
-fromStringstreamNumber(std::istream& in, const std::string& file,
-                       const int& line, int& pos) {
+JSONParser::parseNumber() {
     // Remember position where the value starts. It will be set in the
     // Position structure of the Element to be created.
-    const uint32_t start_pos = pos;
+    const uint32_t start_pos = pos_;
     // This will move the pos to the end of the value.
-    const std::string number = numberFromStringstream(in, pos);
+    const std::string number = parseNumberChars();
 
     if (number.find_first_of(".eE") < number.size()) {
         try {
             return (Element::create(boost::lexical_cast<double>(number),
-                                    Element::Position(file, line, start_pos)));
+                                    Element::Position(file_, line_, start_pos)));
         } catch (const boost::bad_lexical_cast&) {
             throwJSONError(std::string("Number overflow: ") + number,
-                           file, line, start_pos);
+                           file_, line_, start_pos);
         }
     } else {
+        // Most of the numbers are short decimal integers which can be
+        // converted without the lexical cast.
+        const size_t sign = (number[0] == '-') ? 1 : 0;
+        if ((number.size() > sign) && (number.size() - sign <= 18) &&
+            (number.find_first_not_of("0123456789", sign) ==
+             std::string::npos)) {
+            int64_t value = 0;
+            for (size_t i = sign; i < number.size(); ++i) {
+                value = value * 10 + (number[i] - '0');
+            }
+            return (Element::create(static_cast<long long int>(sign ? -value : value),
+                                    Element::Position(file_, line_, start_pos)));
+        }
         try {
             return (Element::create(boost::lexical_cast<int64_t>(number),
-                                    Element::Position(file, line, start_pos)));
+                                    Element::Position(file_, line_, start_pos)));
         } catch (const boost::bad_lexical_cast&) {
-            throwJSONError(std::string("Number overflow: ") + number, file,
-                           line, start_pos);
+            throwJSONError(std::string("Number overflow: ") + number, file_,
+                           line_, start_pos);
         }
     }
     return (ElementPtr());
 }
 
 ElementPtr
-fromStringstreamBool(std::istream& in, const std::string& file,
-                     const int line, int& pos)
-{
+JSONParser::parseBool() {
     // Remember position where the value starts. It will be set in the
     // Position structure of the Element to be created.
-    const uint32_t start_pos = pos;
+    const uint32_t start_pos = pos_;
     // This will move the pos to the end of the value.
-    const std::string word = wordFromStringstream(in, pos);
+    const std::string word = parseWord();
 
     if (word == "true") {
-        return (Element::create(true, Element::Position(file, line,
+        return (Element::create(true, Element::Position(file_, line_,
                                                         start_pos)));
     } else if (word == "false") {
-        return (Element::create(false, Element::Position(file, line,
+        return (Element::create(false, Element::Position(file_, line_,
                                                          start_pos)));
     } else {
-        throwJSONError(std::string("Bad boolean value: ") + word, file,
-                       line, start_pos);
+        throwJSONError(std::string("Bad boolean value: ") + word, file_,
+                       line_, start_pos);
     }
     return (ElementPtr());
 }
 
 ElementPtr
-fromStringstreamNull(std::istream& in, const std::string& file,
-                     const int line, int& pos)
-{
+JSONParser::parseNull() {
     // Remember position where the value starts. It will be set in the
     // Position structure of the Element to be created.
-    const uint32_t start_pos = pos;
+    const uint32_t start_pos = pos_;
     // This will move the pos to the end of the value.
-    const std::string word = wordFromStringstream(in, pos);
+    const std::string word = parseWord();
     if (word == "null") {
-        return (Element::create(Element::Position(file, line, start_pos)));
+        return (Element::create(Element::Position(file_, line_, start_pos)));
     } else {
-        throwJSONError(std::string("Bad null value: ") + word, file,
-                       line, start_pos);
+        throwJSONError(std::string("Bad null value: ") + word, file_,
+                       line_, start_pos);
         return (ElementPtr());
     }
 }
 
 ElementPtr
-fromStringstreamString(std::istream& in, const std::string& file, int& line,
-                       int& pos)
-{
+JSONParser::parseStringElement() {
     // Remember position where the value starts. It will be set in the
     // Position structure of the Element to be created.
-    const uint32_t start_pos = pos;
+    const uint32_t start_pos = pos_;
     // This will move the pos to the end of the value.
-    const std::string string_value = strFromStringstream(in, file, line, pos);
-    return (Element::create(string_value, Element::Position(file, line,
+    const std::string string_value = parseString();
+    return (Element::create(string_value, Element::Position(file_, line_,
                                                             start_pos)));
 }
 
 ElementPtr
-fromStringstreamList(std::istream& in, const std::string& file, int& line,
-                     int& pos)
-{
+JSONParser::parseList() {
     int c = 0;
-    ElementPtr list = Element::createList(Element::Position(file, line, pos));
-    ElementPtr cur_list_element;
+    ElementPtr list = Element::createList(Element::Position(file_, line_, pos_));
 
-    skipChars(in, WHITESPACE, line, pos);
+    skipWhitespace();
     while (c != EOF && c != ']') {
-        if (in.peek() != ']') {
-            cur_list_element = Element::fromJSON(in, file, line, pos);
-            list->add(cur_list_element);
-            c = skipTo(in, file, line, pos, ",]", WHITESPACE);
+        if (peek() != ']') {
+            list->add(parseElement());
+            c = skipTo(",]", WHITESPACE);
         } else {
-            c = in.get();
-            ++pos;
+            c = get();
+            ++pos_;
         }
     }
     return (list);
 }
 
 ElementPtr
-fromStringstreamMap(std::istream& in, const std::string& file, int& line,
-                    int& pos)
-{
-    ElementPtr map = Element::createMap(Element::Position(file, line, pos));
-    skipChars(in, WHITESPACE, line, pos);
-    int c = in.peek();
+JSONParser::parseMap() {
+    ElementPtr map = Element::createMap(Element::Position(file_, line_, pos_));
+    skipWhitespace();
+    int c = peek();
     if (c == EOF) {
-        throwJSONError(std::string("Unterminated map, <string> or } expected"), file, line, pos);
+        throwError(std::string("Unterminated map, <string> or } expected"));
     } else if (c == '}') {
         // empty map, skip closing curly
-        in.ignore();
+        ++cur_;
     } else {
         while (c != EOF && c != '}') {
-            std::string key = strFromStringstream(in, file, line, pos);
+            std::string key = parseString();
 
-            skipTo(in, file, line, pos, ":", WHITESPACE);
+            skipTo(":", WHITESPACE);
             // skip the :
 
-            ConstElementPtr value = Element::fromJSON(in, file, line, pos);
+            ConstElementPtr value = parseElement();
             map->set(key, value);
 
-            c = skipTo(in, file, line, pos, ",}", WHITESPACE);
+            c = skipTo(",}", WHITESPACE);
         }
     }
     return (map);
 }
+
+ElementPtr
+JSONParser::parseElement() {
+    int c = 0;
+    ElementPtr element;
+    bool el_read = false;
+    skipWhitespace();
+    while (c != EOF && !el_read) {
+        c = get();
+        pos_++;
+        switch(c) {
+            case '1':
+            case '2':
+            case '3':
+            case '4':
+            case '5':
+            case '6':
+            case '7':
+            case '8':
+            case '9':
+            case '0':
+            case '-':
+            case '+':
+            case '.':
+                --cur_;
+                --pos_;
+                element = parseNumber();
+                el_read = true;
+                break;
+            case 't':
+            case 'f':
+                --cur_;
+                --pos_;
+                element = parseBool();
+                el_read = true;
+                break;
+            case 'n':
+                --cur_;
+                --pos_;
+                element = parseNull();
+                el_read = true;
+                break;
+            case '"':
+                --cur_;
+                --pos_;
+                element = parseStringElement();
+                el_read = true;
+                break;
+            case '[':
+                element = parseList();
+                el_read = true;
+                break;
+            case '{':
+                element = parseMap();
+                el_read = true;
+                break;
+            case EOF:
+                break;
+            default:
+                throwError(std::string("error: unexpected character ") + std::string(1, c));
+                break;
+        }
+    }
+    if (el_read) {
+        return (element);
+    } else {
+        isc_throw(JSONError, "nothing read");
+    }
+}
+
+/// @brief Reads the text of the next element from a stream.
+///
+/// This is used for the streams which can't be repositioned, e.g. the
+/// ones reading from a socket. The characters are read one by one until
+/// the end of the element, leaving the data following the element in
+/// the stream. The text isn't validated: this is left to the parser.
+///
+/// @param in The stream to read from.
+/// @param [out] text The leading whitespace and the element text.
+void
+readElementText(std::istream& in, std::string& text) {
+    int c = in.peek();
+    while (isWhitespace(c)) {
+        text.push_back(static_cast<char>(in.get()));
+        c = in.peek();
+    }
+    if (c == EOF) {
+        return;
+    }
+    if (isdigit(c) || c == '+' || c == '-' || c == '.') {
+        // Numbers end at the first character which can't be a part of them.
+        while (isdigit(c) || c == '+' || c == '-' || c == '.' || c == 'e' ||
+               c == 'E') {
+            text.push_back(static_cast<char>(in.get()));
+            c = in.peek();
+        }
+        return;
+    }
+    if (isalpha(c)) {
+        // true, false and null
+        while (isalpha(c)) {
+            text.push_back(static_cast<char>(in.get()));
+            c = in.peek();
+        }
+        return;
+    }
+    // Strings, lists and maps end with the matching closing character.
+    // Anything else is a single invalid character reported by the parser.
+    int depth = 0;
+    bool in_string = false;
+    bool escape = false;
+    while ((c = in.get()) != EOF) {
+        text.push_back(static_cast<char>(c));
+        if (in_string) {
+            if (escape) {
+                escape = false;
+            } else if (c == '\\') {
+                escape = true;
+            } else if (c == '"') {
+                in_string = false;
+            }
+        } else if (c == '"') {
+            in_string = true;
+        } else if ((c == '[') || (c == '{')) {
+            ++depth;
+        } else if ((c == ']') || (c == '}')) {
+            --depth;
+        }
+        if (!in_string && (depth <= 0)) {
+            return;
+        }
+    }
+}
+
 } // unnamed namespace
 
 std::string
@@ -636,87 +964,50 @@ ElementPtr
 Element::fromJSON(std::istream& in, const std::string& file, int& line,
                   int& pos) throw(JSONError)
 {
-    int c = 0;
-    ElementPtr element;
-    bool el_read = false;
-    skipChars(in, WHITESPACE, line, pos);
-    while (c != EOF && !el_read) {
-        c = in.get();
-        pos++;
-        switch(c) {
-            case '1':
-            case '2':
-            case '3':
-            case '4':
-            case '5':
-            case '6':
-            case '7':
-            case '8':
-            case '9':
-            case '0':
-            case '-':
-            case '+':
-            case '.':
-                in.putback(c);
-                --pos;
-                element = fromStringstreamNumber(in, file, line, pos);
-                el_read = true;
-                break;
-            case 't':
-            case 'f':
-                in.putback(c);
-                --pos;
-                element = fromStringstreamBool(in, file, line, pos);
-                el_read = true;
-                break;
-            case 'n':
-                in.putback(c);
-                --pos;
-                element = fromStringstreamNull(in, file, line, pos);
-                el_read = true;
-                break;
-            case '"':
-                in.putback('"');
-                --pos;
-                element = fromStringstreamString(in, file, line, pos);
-                el_read = true;
-                break;
-            case '[':
-                element = fromStringstreamList(in, file, line, pos);
-                el_read = true;
-                break;
-            case '{':
-                element = fromStringstreamMap(in, file, line, pos);
-                el_read = true;
-                break;
-            case EOF:
-                break;
-            default:
-                throwJSONError(std::string("error: unexpected character ") + std::string(1, c), file, line, pos);
-                break;
-        }
-    }
-    if (el_read) {
-        return (element);
+    // Remember where the element starts, so as the stream can be set to
+    // the end of the element after the remaining data are parsed.
+    const std::istream::pos_type start = in.tellg();
+    std::string data;
+    if (start != std::istream::pos_type(-1)) {
+        data.assign(std::istreambuf_iterator<char>(in),
+                    std::istreambuf_iterator<char>());
     } else {
-        isc_throw(JSONError, "nothing read");
+        // The stream can't be repositioned so only the element is read.
+        readElementText(in, data);
+    }
+
+    JSONParser parser(data.data(), data.data() + data.size(), file, line, pos);
+    ElementPtr element = parser.parseElement();
+
+    // Leave the data following the element in the stream.
+    // Otherwise it is already there.
+    if (start != std::istream::pos_type(-1)) {
+        in.clear();
+        in.seekg(start + static_cast<std::streamoff>(parser.getParsedLength()));
+        if (parser.eofRead()) {
+            in.setstate(std::ios::eofbit);
+        }
     }
+    return (element);
 }
 
 ElementPtr
 Element::fromJSON(const std::string& in, bool preproc) {
-    std::stringstream ss;
-    ss << in;
-
     int line = 1, pos = 1;
-    stringstream filtered;
     if (preproc) {
+        std::stringstream ss;
+        ss << in;
+        stringstream filtered;
         preprocess(ss, filtered);
+        return (fromJSON(filtered, "<string>", line, pos));
     }
-    ElementPtr result(fromJSON(preproc ? filtered : ss, "<string>", line, pos));
-    skipChars(ss, WHITESPACE, line, pos);
-    // ss must now be at end
-    if (ss.peek() != EOF) {
+
+    const std::string file("<string>");
+    JSONParser parser(in.data(), in.data() + in.size(), file, line, pos);
+    ElementPtr result(parser.parseElement());
+    parser.skipWhitespace();
+    // in must now be at end
+    if (!parser.atEnd()) {
         throwJSONError("Extra data", "<string>", line, pos);
     }
     return result;
@@ -1,4 +1,4 @@
-// Copyright (C) 2010-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2010-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -152,6 +152,19 @@ public:
     // base class; make dtor virtual
     virtual ~Element() {};
 
+    /// \brief Allocates memory for the element.
+    ///
+    /// The memory is allocated from the active \c ElementArena if there
+    /// is one, or from the heap otherwise.
+    ///
+    /// \param size Number of bytes to allocate.
+    static void* operator new(size_t size);
+
+    /// \brief Releases memory allocated for the element.
+    ///
+    /// \param ptr Pointer to the memory to be released.
+    static void operator delete(void* ptr);
+
     /// \return the type of this element
     int getType() const { return (type_); }
 
@@ -446,6 +459,12 @@ public:
     /// Creates an Element from the given input stream, where we keep
     /// track of the location in the stream for error reporting.
     ///
+    /// Only the element is consumed from the stream: the data following
+    /// it can be read by the caller, e.g. to parse the next element.
+    /// If the stream can be repositioned, the remaining data is read at
+    /// once and the stream is then set back to the end of the element.
+    /// Otherwise the element is read character by character.
+    ///
     /// \param in The string to parse the element from.
     /// \param file The input file name.
     /// \param line A reference to the int where the function keeps
@@ -0,0 +1,114 @@
+// Copyright (C) 2017 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <cc/element_arena.h>
+
+namespace {
+
+/// @brief Alignment of the allocated memory.
+const size_t ALIGNMENT = 16;
+
+/// @brief Size of the prefix preceding each allocated object.
+///
+/// The prefix holds the pointer to the block from which the object has
+/// been allocated or null if it has been allocated from the heap.
+const size_t PREFIX_SIZE = ALIGNMENT;
+
+/// @brief Rounds the size up to the multiple of the alignment.
+///
+/// @param size Size to be rounded.
+size_t
+align(const size_t size) {
+    return ((size + ALIGNMENT - 1) & ~(ALIGNMENT - 1));
+}
+
+}
+
+namespace isc {
+namespace data {
+
+const size_t ElementArena::BLOCK_SIZE;
+
+thread_local ElementArena* ElementArena::active_ = 0;
+
+ElementArena::ElementArena()
+    : previous_(active_), block_(0), offset_(0), blocks_num_(0),
+      allocated_bytes_(0) {
+    active_ = this;
+}
+
+ElementArena::~ElementArena() {
+    retireBlock();
+    active_ = previous_;
+}
+
+void*
+ElementArena::allocate(const size_t size) {
+    const size_t total = align(size) + PREFIX_SIZE;
+    char* ptr = 0;
+    if (isActive() && (total <= BLOCK_SIZE - align(sizeof(Block)))) {
+        ptr = static_cast<char*>(active_->allocateFromBlock(total));
+        *reinterpret_cast<Block**>(ptr) = active_->block_;
+
+    } else {
+        ptr = static_cast<char*>(::operator new(total));
+        *reinterpret_cast<Block**>(ptr) = 0;
+    }
+    return (ptr + PREFIX_SIZE);
+}
+
+void
+ElementArena::deallocate(void* ptr) {
+    if (!ptr) {
+        return;
+    }
+
+    char* prefix = static_cast<char*>(ptr) - PREFIX_SIZE;
+    Block* block = *reinterpret_cast<Block**>(prefix);
+    if (!block) {
+        ::operator delete(prefix);
+
+    } else {
+        unrefBlock(block);
+    }
+}
+
+void
+ElementArena::unrefBlock(Block* block) {
+    if (--block->refs_ == 0) {
+        block->~Block();
+        ::operator delete(block);
+    }
+}
+
+void*
+ElementArena::allocateFromBlock(const size_t size) {
+    if (!block_ || (offset_ + size > BLOCK_SIZE)) {
+        retireBlock();
+        block_ = new (::operator new(BLOCK_SIZE)) Block();
+        offset_ = align(sizeof(Block));
+        ++blocks_num_;
+    }
+
+    void* ptr = reinterpret_cast<char*>(block_) + offset_;
+    offset_ += size;
+    allocated_bytes_ += size;
+    ++block_->refs_;
+    return (ptr);
+}
+
+void
+ElementArena::retireBlock() {
+    if (block_) {
+        unrefBlock(block_);
+        block_ = 0;
+    }
+}
+
+} // end of isc::data namespace
+} // end of isc namespace
@@ -0,0 +1,237 @@
+// Copyright (C) 2017 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef ELEMENT_ARENA_H
+#define ELEMENT_ARENA_H
+
+#include <boost/noncopyable.hpp>
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <new>
+
+namespace isc {
+namespace data {
+
+/// @brief Monotonic memory arena for the @c Element trees.
+///
+/// Parsing a large configuration creates millions of small objects:
+/// the elements and the control blocks of the shared pointers pointing
+/// to them. Allocating each of them separately on the heap is slow and
+/// fragments the heap, which results in a high peak memory usage when
+/// the server is reconfigured.
+///
+/// When an instance of this class exists, the elements created with
+/// @c Element::create, @c Element::createList, @c Element::createMap,
+/// @c Element::fromJSON and with the @c new operator, e.g. by the
+/// configuration parsers, are allocated from large blocks of memory
+/// owned by the arena, by bumping a pointer. Releasing an element
+/// doesn't return the memory to the heap. Instead, each block counts
+/// the live objects allocated from it and the block is released as a
+/// whole when all of them are gone and the arena no longer allocates
+/// from it. Thus, the elements may safely outlive the arena, e.g.
+/// when some of them are stored in the server configuration, at the
+/// cost of keeping the blocks holding them.
+///
+/// The arena is activated by the constructor and deactivated by the
+/// destructor. The arenas may be nested, in which case the most
+/// recently created is used. The active arena is tracked per thread, so
+/// the arena is only used by the thread which has created it: the
+/// elements created by other threads at the same time are allocated from
+/// the heap or from their own arenas. The arena must be destroyed by the
+/// thread which has created it. The elements allocated from the
+/// arena may be released by any thread, e.g. when the configuration
+/// holding them is released by a worker thread.
+///
+/// Typical usage is:
+/// @code
+///     ConstElementPtr config;
+///     {
+///         ElementArena arena;
+///         config = parseConfiguration();
+///         applyConfiguration(config);
+///     }
+///     // The blocks are released when config is reset.
+/// @endcode
+class ElementArena : public boost::noncopyable {
+public:
+
+    /// @brief Size of the blocks of memory allocated by the arena.
+    static const size_t BLOCK_SIZE = 64 * 1024;
+
+    /// @brief Constructor.
+    ///
+    /// Activates the arena.
+    ElementArena();
+
+    /// @brief Destructor.
+    ///
+    /// Deactivates the arena, making the previously active arena (if any)
+    /// active again. Releases the current block if no objects allocated
+    /// from it are alive.
+    ~ElementArena();
+
+    /// @brief Allocates memory for an element.
+    ///
+    /// The memory is allocated from the active arena or, if there is no
+    /// arena active for the calling thread or the size is too large, from
+    /// the heap.
+    ///
+    /// @param size Number of bytes to allocate.
+    ///
+    /// @return Pointer to the allocated memory.
+    /// @throw std::bad_alloc if the memory can't be allocated.
+    static void* allocate(const size_t size);
+
+    /// @brief Releases the memory allocated with @c allocate.
+    ///
+    /// @param ptr Pointer returned by @c allocate. It may be null.
+    static void deallocate(void* ptr);
+
+    /// @brief Checks if there is an arena active for the calling thread.
+    static bool isActive() {
+        return (active_ != 0);
+    }
+
+    /// @brief Returns the number of blocks allocated by this arena.
+    ///
+    /// This includes the blocks which have been already released.
+    size_t getBlocksNum() const {
+        return (blocks_num_);
+    }
+
+    /// @brief Returns the number of bytes allocated from this arena.
+    size_t getAllocatedBytes() const {
+        return (allocated_bytes_);
+    }
+
+private:
+
+    /// @brief Header of the block of memory.
+    struct Block {
+        /// @brief Constructor.
+        ///
+        /// The block is initially referenced by the arena only.
+        Block() : refs_(1) {
+        }
+
+        /// @brief Number of the live objects allocated from the block,
+        /// plus one while the arena allocates from it.
+        ///
+        /// The objects may be released by other threads while the arena
+        /// allocates from the block, so the counter is atomic.
+        std::atomic<size_t> refs_;
+    };
+
+    /// @brief Drops a reference to the block.
+    ///
+    /// The block is released when the last reference is dropped.
+    ///
+    /// @param block Pointer to the block.
+    static void unrefBlock(Block* block);
+
+    /// @brief Allocates memory from this arena.
+    ///
+    /// @param size Number of bytes to allocate, including the prefix.
+    void* allocateFromBlock(const size_t size);
+
+    /// @brief Stops allocating from the current block.
+    ///
+    /// The block is released if no objects allocated from it are alive.
+    /// Otherwise it is released with the last of them.
+    void retireBlock();
+
+    /// @brief Arena previously active for the thread.
+    ElementArena* previous_;
+
+    /// @brief Block from which the memory is currently allocated.
+    Block* block_;
+
+    /// @brief Offset of the free memory in the current block.
+    size_t offset_;
+
+    /// @brief Number of blocks allocated by this arena.
+    size_t blocks_num_;
+
+    /// @brief Number of bytes allocated from this arena.
+    size_t allocated_bytes_;
+
+    /// @brief Arena active for the calling thread or null.
+    static thread_local ElementArena* active_;
+};
+
+/// @brief Allocator using the @c ElementArena.
+///
+/// It is used to allocate the elements along with the control blocks
+/// of the shared pointers pointing to them with a single allocation.
+///
+/// @tparam T Type of the allocated objects.
+template<typename T>
+class ElementAllocator {
+public:
+    typedef T value_type;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+
+    template<typename U>
+    struct rebind {
+        typedef ElementAllocator<U> other;
+    };
+
+    ElementAllocator() {
+    }
+
+    template<typename U>
+    ElementAllocator(const ElementAllocator<U>&) {
+    }
+
+    pointer address(reference x) const {
+        return (&x);
+    }
+
+    const_pointer address(const_reference x) const {
+        return (&x);
+    }
+
+    pointer allocate(size_type n, const void* = 0) {
+        return (static_cast<pointer>(ElementArena::allocate(n * sizeof(T))));
+    }
+
+    void deallocate(pointer p, size_type) {
+        ElementArena::deallocate(p);
+    }
+
+    size_type max_size() const {
+        return (std::numeric_limits<size_type>::max() / sizeof(T));
+    }
+
+    void construct(pointer p, const T& value) {
+        ::new (static_cast<void*>(p)) T(value);
+    }
+
+    void destroy(pointer p) {
+        p->~T();
+    }
+};
+
+template<typename T, typename U>
+bool operator==(const ElementAllocator<T>&, const ElementAllocator<U>&) {
+    return (true);
+}
+
+template<typename T, typename U>
+bool operator!=(const ElementAllocator<T>&, const ElementAllocator<U>&) {
+    return (false);
+}
+
+} // end of isc::data namespace
+} // end of isc namespace
+
+#endif // ELEMENT_ARENA_H
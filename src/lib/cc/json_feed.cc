@@ -0,0 +1,115 @@
+// Copyright (C) 2017 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <cc/json_feed.h>
+#include <ctype.h>
+
+namespace isc {
+namespace config {
+
+JSONFeed::JSONFeed()
+    : buffer_(), start_(0), pos_(0), end_(0), ready_(false), depth_(0),
+      in_string_(false), escaped_(false), in_comment_(false),
+      line_start_(true) {
+}
+
+void
+JSONFeed::postBuffer(const char* data, const size_t length) {
+    buffer_.append(data, length);
+    scan();
+}
+
+std::string
+JSONFeed::popElement() {
+    if (!ready_) {
+        return (std::string());
+    }
+
+    std::string element = buffer_.substr(start_, end_ - start_);
+    start_ = end_;
+    pos_ = end_;
+
+    // Remove the returned data when they make up most of the buffer, so as
+    // the buffer doesn't grow indefinitely and the elements following one
+    // another in the same chunk don't cause copying the rest each time.
+    if (start_ == buffer_.size()) {
+        buffer_.clear();
+        start_ = 0;
+        pos_ = 0;
+
+    } else if (start_ > buffer_.size() / 2) {
+        buffer_.erase(0, start_);
+        pos_ -= start_;
+        start_ = 0;
+    }
+
+    resetState();
+    scan();
+    return (element);
+}
+
+void
+JSONFeed::clear() {
+    buffer_.clear();
+    start_ = 0;
+    pos_ = 0;
+    resetState();
+}
+
+void
+JSONFeed::resetState() {
+    end_ = 0;
+    ready_ = false;
+    depth_ = 0;
+    in_string_ = false;
+    escaped_ = false;
+    in_comment_ = false;
+    line_start_ = true;
+}
+
+void
+JSONFeed::scan() {
+    for (; !ready_ && (pos_ < buffer_.size()); ++pos_) {
+        const char c = buffer_[pos_];
+        if (in_comment_) {
+            in_comment_ = (c != '\n');
+
+        } else if (in_string_) {
+            if (escaped_) {
+                escaped_ = false;
+            } else if (c == '\\') {
+                escaped_ = true;
+            } else if (c == '"') {
+                in_string_ = false;
+            }
+
+        } else if (line_start_ && (c == '#')) {
+            in_comment_ = true;
+
+        } else if (c == '"') {
+            in_string_ = true;
+
+        } else if ((c == '{') || (c == '[')) {
+            ++depth_;
+
+        } else if ((c == '}') || (c == ']')) {
+            if (--depth_ <= 0) {
+                end_ = (depth_ == 0 ? pos_ + 1 : buffer_.size());
+                ready_ = true;
+            }
+
+        } else if ((depth_ == 0) && !isspace(static_cast<unsigned char>(c))) {
+            end_ = buffer_.size();
+            ready_ = true;
+        }
+
+        line_start_ = (c == '\n');
+    }
+}
+
+} // end of isc::config namespace
+} // end of isc namespace
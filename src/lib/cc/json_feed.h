@@ -0,0 +1,115 @@
+// Copyright (C) 2017 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef JSON_FEED_H
+#define JSON_FEED_H
+
+#include <string>
+#include <stddef.h>
+
+namespace isc {
+namespace config {
+
+/// @brief Splits the JSON text received in chunks into the top level
+/// elements.
+///
+/// The commands and the responses exchanged over the control sockets are
+/// JSON maps or lists, which may be split by the transport and may be sent
+/// one after another over the same connection. This class accumulates the
+/// received data and finds the end of each top level map or list by
+/// matching the brackets outside of the strings. The data are scanned
+/// once, as they are received, so the scanning state (nesting depth,
+/// string and escape) is retained between the chunks. The elements are not
+/// parsed: the caller parses each complete element once it is available.
+///
+/// The elements may be preceded by whitespace and comment lines, i.e. the
+/// lines beginning with '#'. If anything else precedes the element, the
+/// data are malformed and all data received so far are returned as the
+/// next element, so as the JSON parser reports the error.
+class JSONFeed {
+public:
+
+    /// @brief Constructor.
+    JSONFeed();
+
+    /// @brief Appends the received data and scans them.
+    ///
+    /// @param data Pointer to the received data.
+    /// @param length Length of the received data.
+    void postBuffer(const char* data, const size_t length);
+
+    /// @brief Checks if a complete element has been received.
+    ///
+    /// @return true if @c popElement returns the complete element (or the
+    /// malformed data).
+    bool elementReady() const {
+        return (ready_);
+    }
+
+    /// @brief Returns the first complete element and removes it from the
+    /// received data.
+    ///
+    /// The data following the element are scanned for the next element.
+    ///
+    /// @return Text of the element or an empty string if no complete
+    /// element has been received.
+    std::string popElement();
+
+    /// @brief Returns the size of the received data which haven't been
+    /// returned by @c popElement yet.
+    size_t getPendingSize() const {
+        return (buffer_.size() - start_);
+    }
+
+    /// @brief Discards all received data and resets the scanning state.
+    void clear();
+
+private:
+
+    /// @brief Scans the received data until the end of the element.
+    void scan();
+
+    /// @brief Resets the scanning state for the next element.
+    void resetState();
+
+    /// @brief Received data.
+    ///
+    /// The data returned by @c popElement are removed lazily, so this
+    /// holds the data beginning at @c start_.
+    std::string buffer_;
+
+    /// @brief Position of the first element in the @c buffer_.
+    size_t start_;
+
+    /// @brief Position of the next byte to be scanned.
+    size_t pos_;
+
+    /// @brief Position following the end of the first element.
+    size_t end_;
+
+    /// @brief Indicates if the first element is complete.
+    bool ready_;
+
+    /// @brief Nesting depth of the maps and lists at @c pos_.
+    int depth_;
+
+    /// @brief Indicates if @c pos_ is within a string.
+    bool in_string_;
+
+    /// @brief Indicates if the previous byte of the string is a backslash.
+    bool escaped_;
+
+    /// @brief Indicates if @c pos_ is within a comment line.
+    bool in_comment_;
+
+    /// @brief Indicates if @c pos_ is at the beginning of a line.
+    bool line_start_;
+};
+
+} // end of isc::config namespace
+} // end of isc namespace
+
+#endif // JSON_FEED_H
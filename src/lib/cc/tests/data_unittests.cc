@@ -1,4 +1,4 @@
-// Copyright (C) 2009-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2009-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -1149,4 +1149,126 @@ TEST(Element, getPositionCommented) {
     EXPECT_EQ(14, level2_el->getPosition().pos_);
     EXPECT_EQ("kea.conf", level2_el->getPosition().file_);
 }
+
+/// @brief Stream buffer which can't be repositioned, e.g. like a socket.
+class NonSeekableBuf : public std::streambuf {
+public:
+    /// @brief Constructor.
+    ///
+    /// @param data Data returned by the buffer.
+    NonSeekableBuf(const std::string& data) : data_(data) {
+        char* begin = const_cast<char*>(data_.data());
+        setg(begin, begin, begin + data_.size());
+    }
+
+private:
+    /// @brief Data returned by the buffer.
+    std::string data_;
+};
+
+// Tests that the elements can be read one after another from a stream
+// and that the data following an element is left in the stream.
+TEST(Element, fromJSONStreamSeekBack) {
+    std::istringstream ss("{ \"a\": 1 } [ 2, 3 ]\n\"foo\" 4 true");
+    int line = 1, pos = 1;
+    EXPECT_EQ("{ \"a\": 1 }",
+              Element::fromJSON(ss, "<istream>", line, pos)->str());
+    EXPECT_EQ("[ 2, 3 ]", Element::fromJSON(ss, "<istream>", line, pos)->str());
+    EXPECT_EQ("\"foo\"", Element::fromJSON(ss, "<istream>", line, pos)->str());
+    EXPECT_EQ(2, line);
+    EXPECT_EQ("4", Element::fromJSON(ss, "<istream>", line, pos)->str());
+    EXPECT_FALSE(ss.eof());
+    std::string rest;
+    std::getline(ss, rest);
+    EXPECT_EQ(" true", rest);
+
+    // The last element ends with the stream.
+    std::istringstream last("[ 1 ] 2");
+    EXPECT_EQ("[ 1 ]", Element::fromJSON(last)->str());
+    EXPECT_FALSE(last.eof());
+    EXPECT_EQ("2", Element::fromJSON(last)->str());
+    EXPECT_TRUE(last.eof());
+}
+
+// Tests that the data following an element is left in a stream which
+// can't be repositioned.
+TEST(Element, fromJSONNonSeekableStream) {
+    NonSeekableBuf buf("{ \"a\": [ \"]}\\\"\", { } ] }\n 12 null \"x\" 3");
+    std::istream in(&buf);
+    ASSERT_EQ(std::istream::pos_type(-1), in.tellg());
+
+    int line = 1, pos = 1;
+    EXPECT_EQ("{ \"a\": [ \"]}\\\"\", {  } ] }",
+              Element::fromJSON(in, "<istream>", line, pos)->str());
+    EXPECT_EQ("12", Element::fromJSON(in, "<istream>", line, pos)->str());
+    EXPECT_EQ(2, line);
+    EXPECT_EQ("null", Element::fromJSON(in, "<istream>", line, pos)->str());
+    EXPECT_EQ("\"x\"", Element::fromJSON(in, "<istream>", line, pos)->str());
+    EXPECT_FALSE(in.eof());
+    std::string rest;
+    std::getline(in, rest);
+    EXPECT_EQ(" 3", rest);
+
+    // Errors are reported as for the other streams.
+    NonSeekableBuf truncated("{ \"a\": ");
+    std::istream truncated_in(&truncated);
+    EXPECT_THROW(Element::fromJSON(truncated_in), JSONError);
+    NonSeekableBuf empty("  ");
+    std::istream empty_in(&empty);
+    EXPECT_THROW(Element::fromJSON(empty_in), JSONError);
+}
+
+// Tests that quotes and escapes are found in strings regardless of their
+// position relative to the 16 bytes blocks scanned at once.
+TEST(Element, fromJSONStringBlocks) {
+    for (size_t i = 0; i < 40; ++i) {
+        const std::string prefix(i, 'a');
+        const std::string suffix(i % 17, 'b');
+
+        std::string json = "\"" + prefix + "\"";
+        ConstElementPtr el;
+        ASSERT_NO_THROW(el = Element::fromJSON(json)) << json;
+        EXPECT_EQ(prefix, el->stringValue());
+
+        json = "\"" + prefix + "\\n" + suffix + "\\\"\"";
+        ASSERT_NO_THROW(el = Element::fromJSON(json)) << json;
+        EXPECT_EQ(prefix + "\n" + suffix + "\"", el->stringValue());
+
+        // The string is followed by other data in the same buffer.
+        json = "[ \"" + prefix + "\", \"" + suffix + "\" ]";
+        ASSERT_NO_THROW(el = Element::fromJSON(json)) << json;
+        ASSERT_EQ(2, el->size());
+        EXPECT_EQ(prefix, el->get(0)->stringValue());
+        EXPECT_EQ(suffix, el->get(1)->stringValue());
+
+        json = "\"" + prefix;
+        EXPECT_THROW(Element::fromJSON(json), JSONError) << json;
+    }
+}
+
+// Tests that integers are converted the same way with and without
+// the conversion of up to 18 digits.
+TEST(Element, fromJSONIntegers) {
+    EXPECT_EQ(123456789012345678LL,
+              Element::fromJSON("123456789012345678")->intValue());
+    EXPECT_EQ(-123456789012345678LL,
+              Element::fromJSON("-123456789012345678")->intValue());
+    EXPECT_EQ(999999999999999999LL,
+              Element::fromJSON("999999999999999999")->intValue());
+    EXPECT_EQ(12, Element::fromJSON("000000000000000012")->intValue());
+    EXPECT_EQ(0, Element::fromJSON("-0")->intValue());
+    EXPECT_EQ(123, Element::fromJSON("+123")->intValue());
+
+    // 19 digits are converted with the lexical cast.
+    EXPECT_EQ(1234567890123456789LL,
+              Element::fromJSON("1234567890123456789")->intValue());
+    EXPECT_EQ(-1234567890123456789LL,
+              Element::fromJSON("-1234567890123456789")->intValue());
+    EXPECT_THROW(Element::fromJSON("9999999999999999999"), JSONError);
+    EXPECT_THROW(Element::fromJSON("-9223372036854775809"), JSONError);
+
+    // Not an integer.
+    EXPECT_THROW(Element::fromJSON("1-2"), JSONError);
+    EXPECT_THROW(Element::fromJSON("-"), JSONError);
+}
 }
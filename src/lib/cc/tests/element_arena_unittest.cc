@@ -0,0 +1,213 @@
+// Copyright (C) 2017 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <cc/data.h>
+#include <cc/element_arena.h>
+#include <util/threads/thread.h>
+#include <boost/bind.hpp>
+#include <gtest/gtest.h>
+#include <string>
+
+using namespace isc::data;
+using namespace isc::util::thread;
+
+namespace {
+
+/// @brief Configuration used in the tests.
+const char* CONFIG =
+    "{ \"Dhcp4\": { \"valid-lifetime\": 4000, \"subnet4\": ["
+    "  { \"subnet\": \"192.0.2.0/24\", \"id\": 1,"
+    "    \"pools\": [ { \"pool\": \"192.0.2.1 - 192.0.2.100\" } ],"
+    "    \"reservations\": [ { \"hw-address\": \"01:02:03:04:05:06\","
+    "                          \"ip-address\": \"192.0.2.201\" } ] } ],"
+    "  \"rebind-timer\": 2.5, \"echo-client-id\": true, \"foo\": null } }";
+
+// This test verifies that the elements are allocated from the heap when
+// there is no active arena.
+TEST(ElementArenaTest, noArena) {
+    EXPECT_FALSE(ElementArena::isActive());
+
+    ConstElementPtr config;
+    ASSERT_NO_THROW(config = Element::fromJSON(CONFIG));
+    ASSERT_TRUE(config);
+    EXPECT_EQ(1, config->size());
+
+    // The memory not allocated from the arena can be released.
+    void* ptr = ElementArena::allocate(10);
+    ASSERT_TRUE(ptr);
+    ElementArena::deallocate(ptr);
+    ElementArena::deallocate(0);
+}
+
+// This test verifies that the elements are allocated from the arena and
+// remain valid after the arena is destroyed.
+TEST(ElementArenaTest, allocate) {
+    ConstElementPtr expected = Element::fromJSON(CONFIG);
+
+    ConstElementPtr config;
+    ElementPtr map;
+    {
+        ElementArena arena;
+        EXPECT_TRUE(ElementArena::isActive());
+        EXPECT_EQ(0, arena.getBlocksNum());
+        EXPECT_EQ(0, arena.getAllocatedBytes());
+
+        ASSERT_NO_THROW(config = Element::fromJSON(CONFIG));
+        EXPECT_EQ(1, arena.getBlocksNum());
+        const size_t allocated = arena.getAllocatedBytes();
+        EXPECT_GT(allocated, 0);
+
+        // The elements created with the new operator, e.g. by the bison
+        // parsers, are also allocated from the arena.
+        map.reset(new MapElement());
+        map->set("int", Element::create(1));
+        map->set("list", ElementPtr(new ListElement()));
+        EXPECT_GT(arena.getAllocatedBytes(), allocated);
+    }
+    EXPECT_FALSE(ElementArena::isActive());
+
+    ASSERT_TRUE(config);
+    EXPECT_TRUE(config->equals(*expected));
+    EXPECT_EQ("{ \"int\": 1, \"list\": [  ] }", map->str());
+
+    // Part of the tree outlives the rest of it.
+    ConstElementPtr subnets = config->get("Dhcp4")->get("subnet4");
+    config.reset();
+    map.reset();
+    ASSERT_TRUE(subnets);
+    EXPECT_EQ(expected->get("Dhcp4")->get("subnet4")->str(), subnets->str());
+}
+
+// This test verifies that new blocks are allocated when needed and that
+// the large objects are allocated from the heap.
+TEST(ElementArenaTest, blocks) {
+    ElementArena arena;
+
+    // The object which doesn't fit into the block is allocated from the
+    // heap.
+    void* ptr = ElementArena::allocate(ElementArena::BLOCK_SIZE);
+    ASSERT_TRUE(ptr);
+    EXPECT_EQ(0, arena.getBlocksNum());
+    ElementArena::deallocate(ptr);
+
+    ElementPtr list = Element::createList();
+    for (size_t i = 0; i < ElementArena::BLOCK_SIZE / 16; ++i) {
+        list->add(Element::create(std::string("some string")));
+    }
+    EXPECT_GT(arena.getBlocksNum(), 1);
+    EXPECT_GT(arena.getAllocatedBytes(), ElementArena::BLOCK_SIZE);
+
+    // Release the elements while the arena is still active.
+    list.reset();
+    ConstElementPtr config = Element::fromJSON(CONFIG);
+    EXPECT_TRUE(config->equals(*Element::fromJSON(CONFIG)));
+}
+
+// This test verifies that the arenas can be nested.
+TEST(ElementArenaTest, nested) {
+    ElementArena outer;
+    ElementPtr outer_elem = Element::create(1);
+    EXPECT_EQ(1, outer.getBlocksNum());
+    {
+        ElementArena inner;
+        ElementPtr inner_elem = Element::create(2);
+        EXPECT_EQ(1, inner.getBlocksNum());
+        EXPECT_EQ(outer.getAllocatedBytes(), inner.getAllocatedBytes());
+        outer_elem = inner_elem;
+    }
+
+    // The outer arena is active again.
+    const size_t allocated = outer.getAllocatedBytes();
+    ElementPtr elem = Element::create(3);
+    EXPECT_GT(outer.getAllocatedBytes(), allocated);
+    EXPECT_EQ(2, outer_elem->intValue());
+}
+
+
+/// @brief Releases the elements of the list one by one.
+///
+/// @param list List holding the elements to release.
+void
+releaseElements(ElementPtr list) {
+    while (!list->empty()) {
+        list->remove(list->size() - 1);
+    }
+}
+
+// This test verifies that the elements allocated from the arena can be
+// released by another thread while the arena allocates new elements.
+TEST(ElementArenaTest, releaseInOtherThread) {
+    ElementArena arena;
+    ElementPtr released = Element::createList();
+    for (size_t i = 0; i < ElementArena::BLOCK_SIZE / 4; ++i) {
+        released->add(Element::create(static_cast<long long int>(i)));
+    }
+    const size_t blocks_num = arena.getBlocksNum();
+    EXPECT_GT(blocks_num, 1);
+
+    // The thread drops the references to the elements, including the ones
+    // allocated from the current block.
+    Thread thread(boost::bind(&releaseElements, released));
+    ElementPtr kept = Element::createList();
+    for (size_t i = 0; i < ElementArena::BLOCK_SIZE / 4; ++i) {
+        kept->add(Element::create(static_cast<long long int>(i)));
+    }
+    thread.wait();
+    EXPECT_TRUE(released->empty());
+    EXPECT_GT(arena.getBlocksNum(), blocks_num);
+    EXPECT_EQ(ElementArena::BLOCK_SIZE / 4, kept->size());
+    EXPECT_EQ(12, kept->get(12)->intValue());
+}
+
+/// @brief Parses the configuration using an arena created by the thread.
+///
+/// @param [out] active_before Indicates if an arena was active for the
+/// thread before it created its own arena.
+/// @param [out] allocated Number of bytes allocated from the arena.
+/// @param [out] config Parsed configuration.
+void
+parseInArena(bool* active_before, size_t* allocated, ConstElementPtr* config) {
+    *active_before = ElementArena::isActive();
+    ElementArena arena;
+    *config = Element::fromJSON(CONFIG);
+    *allocated = arena.getAllocatedBytes();
+}
+
+// This test verifies that each thread uses its own arena, and that the
+// threads creating and destroying the arenas at the same time don't
+// affect each other.
+TEST(ElementArenaTest, arenaPerThread) {
+    ElementArena arena;
+
+    bool active_before[2] = { true, true };
+    size_t allocated[2] = { 0, 0 };
+    ConstElementPtr configs[2];
+    Thread thread0(boost::bind(&parseInArena, &active_before[0],
+                               &allocated[0], &configs[0]));
+    Thread thread1(boost::bind(&parseInArena, &active_before[1],
+                               &allocated[1], &configs[1]));
+    ConstElementPtr config = Element::fromJSON(CONFIG);
+    thread0.wait();
+    thread1.wait();
+
+    for (int i = 0; i < 2; ++i) {
+        // The arena of the main thread is not used by the other threads.
+        EXPECT_FALSE(active_before[i]);
+        EXPECT_GT(allocated[i], 0);
+        ASSERT_TRUE(configs[i]);
+        EXPECT_TRUE(configs[i]->equals(*config));
+    }
+
+    // The arena of the main thread remains active.
+    EXPECT_TRUE(ElementArena::isActive());
+    const size_t allocated_main = arena.getAllocatedBytes();
+    EXPECT_GT(allocated_main, 0);
+    ElementPtr elem = Element::create(3);
+    EXPECT_GT(arena.getAllocatedBytes(), allocated_main);
+}
+
+}
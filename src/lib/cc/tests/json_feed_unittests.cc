@@ -0,0 +1,114 @@
+// Copyright (C) 2017 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <cc/json_feed.h>
+#include <gtest/gtest.h>
+#include <string>
+
+using namespace isc::config;
+
+namespace {
+
+/// @brief Posts the text to the feed.
+///
+/// @param feed Feed to which the text is posted.
+/// @param text Text to be posted.
+void
+post(JSONFeed& feed, const std::string& text) {
+    feed.postBuffer(text.data(), text.size());
+}
+
+// This test verifies that a single element is returned when it is
+// complete.
+TEST(JSONFeedTest, singleElement) {
+    JSONFeed feed;
+    EXPECT_FALSE(feed.elementReady());
+    EXPECT_EQ("", feed.popElement());
+
+    post(feed, "  { \"command\": \"list-commands\" }");
+    ASSERT_TRUE(feed.elementReady());
+    EXPECT_EQ("  { \"command\": \"list-commands\" }", feed.popElement());
+    EXPECT_FALSE(feed.elementReady());
+    EXPECT_EQ(0, feed.getPendingSize());
+}
+
+// This test verifies that the element split into many chunks is returned
+// when its last chunk is received, and that the brackets and quotes within
+// the strings are ignored.
+TEST(JSONFeedTest, chunks) {
+    const std::string text = "{ \"command\": \"foo\", \"arguments\":"
+        " { \"text\": \"}]{\\\"\\\\\", \"list\": [ 1, [ 2 ], { } ] } }";
+
+    JSONFeed feed;
+    for (size_t i = 0; i < text.size(); ++i) {
+        EXPECT_FALSE(feed.elementReady()) << "at " << i;
+        feed.postBuffer(&text[i], 1);
+    }
+    ASSERT_TRUE(feed.elementReady());
+    EXPECT_EQ(text, feed.popElement());
+}
+
+// This test verifies that the elements received together are returned
+// one after another and the incomplete element is retained.
+TEST(JSONFeedTest, multipleElements) {
+    JSONFeed feed;
+    post(feed, "{ \"command\": \"foo\" }[ 1, 2 ]\n{ \"command\": \"b");
+
+    ASSERT_TRUE(feed.elementReady());
+    EXPECT_EQ("{ \"command\": \"foo\" }", feed.popElement());
+    ASSERT_TRUE(feed.elementReady());
+    EXPECT_EQ("[ 1, 2 ]", feed.popElement());
+    EXPECT_FALSE(feed.elementReady());
+    EXPECT_EQ(16, feed.getPendingSize());
+
+    post(feed, "ar\" }");
+    ASSERT_TRUE(feed.elementReady());
+    EXPECT_EQ("\n{ \"command\": \"bar\" }", feed.popElement());
+    EXPECT_EQ(0, feed.getPendingSize());
+}
+
+// This test verifies that the comment lines preceding the element are
+// skipped.
+TEST(JSONFeedTest, comments) {
+    JSONFeed feed;
+    post(feed, "# comment with { and \"\n");
+    EXPECT_FALSE(feed.elementReady());
+    post(feed, "# another }\n{ \"command\": \"foo\" }");
+    ASSERT_TRUE(feed.elementReady());
+    EXPECT_EQ("# comment with { and \"\n# another }\n"
+              "{ \"command\": \"foo\" }", feed.popElement());
+}
+
+// This test verifies that all received data are returned when they don't
+// begin with a map or list.
+TEST(JSONFeedTest, malformed) {
+    JSONFeed feed;
+    post(feed, "  foo { }");
+    ASSERT_TRUE(feed.elementReady());
+    EXPECT_EQ("  foo { }", feed.popElement());
+
+    post(feed, "{ } ] { }");
+    ASSERT_TRUE(feed.elementReady());
+    EXPECT_EQ("{ }", feed.popElement());
+    ASSERT_TRUE(feed.elementReady());
+    EXPECT_EQ(" ] { }", feed.popElement());
+    EXPECT_EQ(0, feed.getPendingSize());
+}
+
+// This test verifies that the received data are discarded by clear.
+TEST(JSONFeedTest, clear) {
+    JSONFeed feed;
+    post(feed, "{ \"command\": \"");
+    feed.clear();
+    EXPECT_EQ(0, feed.getPendingSize());
+
+    post(feed, "{ }");
+    ASSERT_TRUE(feed.elementReady());
+    EXPECT_EQ("{ }", feed.popElement());
+}
+
+}
@@ -7,10 +7,20 @@
 #include <cc/command_interpreter.h>
 #include <config/base_command_mgr.h>
 #include <config/config_log.h>
+#include <util/stopwatch.h>
 #include <boost/bind.hpp>
 #include <set>
+#include <sstream>
 
 using namespace isc::data;
+using namespace isc::util;
+
+namespace {
+
+/// @brief Name of the envelope carrying multiple commands.
+const char* BATCH_COMMAND = "batch";
+
+}
 
 namespace isc {
 namespace config {
@@ -26,6 +36,11 @@ BaseCommandMgr::registerCommand(const std::string& cmd, CommandHandler handler)
         isc_throw(InvalidCommandHandler, "Specified command handler is NULL");
     }
 
+    if (cmd == BATCH_COMMAND) {
+        isc_throw(InvalidCommandName, "Can't install handler for the reserved"
+                  " command '" << cmd << "'");
+    }
+
     HandlerContainer::const_iterator it = handlers_.find(cmd);
     if (it != handlers_.end()) {
         isc_throw(InvalidCommandName, "Handler for command '" << cmd
@@ -77,7 +92,17 @@ BaseCommandMgr::processCommand(const isc::data::ConstElementPtr& cmd) {
 
         LOG_INFO(command_logger, COMMAND_RECEIVED).arg(name);
 
-        return (handleCommand(name, arg));
+        if (name == BATCH_COMMAND) {
+            return (processBatch(arg));
+        }
+
+        Stopwatch stopwatch;
+        ConstElementPtr answer = handleCommand(name, arg);
+        stopwatch.stop();
+        LOG_DEBUG(command_logger, DBG_COMMAND, COMMAND_PROCESSED).arg(name)
+            .arg(stopwatch.logFormatLastDuration());
+
+        return (answer);
 
     } catch (const Exception& e) {
         LOG_WARN(command_logger, COMMAND_PROCESS_ERROR2).arg(e.what());
@@ -87,6 +112,57 @@ BaseCommandMgr::processCommand(const isc::data::ConstElementPtr& cmd) {
     }
 }
 
+ConstElementPtr
+BaseCommandMgr::processBatch(const ConstElementPtr& params) {
+    ConstElementPtr commands = params ? params->get("commands") :
+        ConstElementPtr();
+    if (!commands || (commands->getType() != Element::list)) {
+        return (createAnswer(CONTROL_RESULT_ERROR, "'batch' command requires"
+                             " the 'commands' list argument"));
+    }
+
+    ElementPtr answers = Element::createList();
+    const std::vector<ElementPtr>& cmds = commands->listValue();
+    for (std::vector<ElementPtr>::const_iterator cmd = cmds.begin();
+         cmd != cmds.end(); ++cmd) {
+        Stopwatch stopwatch;
+        ConstElementPtr answer;
+
+        // Batches are not nested, so as the answers map one to one
+        // to the commands.
+        if (((*cmd)->getType() == Element::map) && (*cmd)->get("command") &&
+            ((*cmd)->get("command")->getType() == Element::string) &&
+            ((*cmd)->get("command")->stringValue() == BATCH_COMMAND)) {
+            answer = createAnswer(CONTROL_RESULT_ERROR, "'batch' command"
+                                  " can't be nested");
+        } else {
+            answer = processCommand(*cmd);
+        }
+        stopwatch.stop();
+
+        // Each answer is returned as a copy extended with the time taken
+        // to process the command.
+        ElementPtr entry = Element::createMap();
+        if (answer && (answer->getType() == Element::map)) {
+            entry->setValue(answer->mapValue());
+        } else {
+            entry->setValue(createAnswer(CONTROL_RESULT_ERROR, "no response"
+                                         " generated for the command")
+                            ->mapValue());
+        }
+        entry->set("execution-time",
+                   Element::create(stopwatch.getLastMicroseconds()));
+        answers->add(entry);
+    }
+
+    LOG_DEBUG(command_logger, DBG_COMMAND, COMMAND_BATCH_PROCESSED)
+        .arg(cmds.size());
+
+    std::ostringstream text;
+    text << cmds.size() << " command(s) processed";
+    return (createAnswer(CONTROL_RESULT_SUCCESS, text.str(), answers));
+}
+
 ConstElementPtr
 BaseCommandMgr::combineCommandsLists(const ConstElementPtr& response1,
                                      const ConstElementPtr& response2) const {
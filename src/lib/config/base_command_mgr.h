@@ -68,6 +68,28 @@ public:
 /// "list-commands") itself, but rather provides an interface
 /// (see @ref registerCommand, @ref deregisterCommand, @ref processCommand)
 /// for other components to use it.
+///
+/// Multiple commands can be sent at once within the "batch" command:
+///
+/// @code
+/// {
+///     "command": "batch",
+///     "arguments": {
+///         "commands": [
+///             { "command": "statistic-get", "arguments": { "name": "pkt4-received" } },
+///             { "command": "list-commands" }
+///         ]
+///     }
+/// }
+/// @endcode
+///
+/// The commands are processed in order, each one as if it was received
+/// alone, i.e. including the hook callouts. The answer to the batch carries
+/// the list of the answers to the commands, in the same order. Each of them
+/// is extended with the "execution-time" holding the time taken to process
+/// the command in microseconds. The "batch" is not a regular command: it
+/// can't be nested, registered or deregistered and it isn't returned by
+/// "list-commands".
 class BaseCommandMgr {
 public:
 
@@ -95,7 +117,7 @@ public:
     /// a single Element. See @ref BaseCommandMgr for description of its syntax.
     ///
     /// @param cmd Pointer to the data element representing command in JSON
-    /// format.
+    /// format. It may also be the "batch" of commands.
     isc::data::ConstElementPtr
     processCommand(const isc::data::ConstElementPtr& cmd);
 
@@ -103,6 +125,10 @@ public:
     ///
     /// @param cmd Name of the command to be handled.
     /// @param handler Pointer to the method that will handle the command.
+    ///
+    /// @throw InvalidCommandHandler if the handler is null.
+    /// @throw InvalidCommandName if the handler is already installed or
+    /// the command name is reserved.
     void registerCommand(const std::string& cmd, CommandHandler handler);
 
     /// @brief Deregisters specified command handler.
@@ -163,6 +189,15 @@ protected:
 
 private:
 
+    /// @brief Processes the commands carried in the "batch" command.
+    ///
+    /// @param params Arguments of the "batch" command, holding the
+    /// "commands" list.
+    ///
+    /// @return Answer holding the list of the answers to the commands.
+    isc::data::ConstElementPtr
+    processBatch(const isc::data::ConstElementPtr& params);
+
     /// @brief 'list-commands' command handler.
     ///
     /// This method implements command 'list-commands'. It returns a list of all
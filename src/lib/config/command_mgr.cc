@@ -11,10 +11,46 @@
 #include <dhcp/iface_mgr.h>
 #include <config/config_log.h>
 #include <boost/bind.hpp>
+#include <errno.h>
+#include <string.h>
 #include <unistd.h>
 
 using namespace isc::data;
 
+namespace {
+
+/// @brief Maximum size of a single command received over the connection.
+const size_t MAX_COMMAND_SIZE = 16 * 1024 * 1024;
+
+/// @brief Writes as much of the data to the non-blocking socket as it
+/// accepts without waiting.
+///
+/// @param fd Socket descriptor.
+/// @param data Pointer to the data to be sent.
+/// @param length Length of the data.
+///
+/// @return Number of bytes written or -1 on error, in which case the errno
+/// is set.
+ssize_t
+writeData(int fd, const char* data, const size_t length) {
+    size_t offset = 0;
+    while (offset < length) {
+        ssize_t rval = write(fd, data + offset, length - offset);
+        if (rval >= 0) {
+            offset += rval;
+
+        } else if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+            break;
+
+        } else if (errno != EINTR) {
+            return (-1);
+        }
+    }
+    return (static_cast<ssize_t>(offset));
+}
+
+}
+
 namespace isc {
 namespace config {
 
@@ -46,6 +82,13 @@ void CommandMgr::closeCommandSocket() {
         (*conn)->close();
     }
     connections_.clear();
+
+    // The responses which haven't been written yet are dropped.
+    for (std::map<int, PendingData>::const_iterator pending =
+             pending_data_.begin(); pending != pending_data_.end(); ++pending) {
+        isc::dhcp::IfaceMgr::instance().deleteExternalWriteSocket(pending->first);
+    }
+    pending_data_.clear();
 }
 
 
@@ -63,6 +106,8 @@ bool CommandMgr::closeConnection(int fd) {
         if ((*conn)->getFD() == fd) {
             (*conn)->close();
             connections_.erase(conn);
+            pending_data_.erase(fd);
+            isc::dhcp::IfaceMgr::instance().deleteExternalWriteSocket(fd);
             return (true);
         }
     }
@@ -79,12 +124,7 @@ CommandMgr::instance() {
 void
 CommandMgr::commandReader(int sockfd) {
 
-    /// @todo: We do not handle commands that are larger than 64K.
-
-    // We should not expect commands bigger than 64K.
     char buf[65536];
-    memset(buf, 0, sizeof(buf));
-    ConstElementPtr cmd, rsp;
 
     // Read incoming data.
     int rval = read(sockfd, buf, sizeof(buf));
@@ -103,6 +143,40 @@ CommandMgr::commandReader(int sockfd) {
         return;
     }
 
+    LOG_DEBUG(command_logger, DBG_COMMAND, COMMAND_SOCKET_READ).arg(rval).arg(sockfd);
+
+    // The data may complete the command received earlier and may carry
+    // more commands. The feed retains the scanning state, so the data are
+    // scanned only once.
+    CommandMgr& mgr = instance();
+    PendingData& pending = mgr.pending_data_[sockfd];
+    pending.received_.postBuffer(buf, static_cast<size_t>(rval));
+
+    // The commands are not processed while the previous response is being
+    // written. The client which keeps sending without reading the responses
+    // is disconnected.
+    if (!pending.response_.empty() &&
+        (pending.received_.getPendingSize() > MAX_COMMAND_SIZE)) {
+        LOG_ERROR(command_logger, COMMAND_SOCKET_COMMAND_TOOLARGE)
+            .arg(pending.received_.getPendingSize()).arg(sockfd);
+        mgr.closeConnection(sockfd);
+        return;
+    }
+
+    mgr.processCommands(sockfd);
+}
+
+void
+CommandMgr::commandWriter(int sockfd) {
+    CommandMgr& mgr = instance();
+    mgr.writeResponse(sockfd);
+
+    // Process the commands received while the response was being written.
+    mgr.processCommands(sockfd);
+}
+
+void
+CommandMgr::processCommands(int sockfd) {
     // Duplicate the connection's socket in the event, the command causes the
     // channel to close (like a reconfig).  This permits us to always have
     // a socket on which to respond. If for some reason  we can't fall back
@@ -116,62 +190,121 @@ CommandMgr::commandReader(int sockfd) {
         rsp_fd = sockfd;
     }
 
-    LOG_DEBUG(command_logger, DBG_COMMAND, COMMAND_SOCKET_READ).arg(rval).arg(sockfd);
+    for (;;) {
+        // The connection is gone if the previous command closed it. The
+        // next command is processed when the previous response is sent.
+        std::map<int, PendingData>::iterator pending =
+            pending_data_.find(sockfd);
+        if ((pending == pending_data_.end()) ||
+            !pending->second.response_.empty()) {
+            break;
+        }
 
-    // Ok, we received something. Let's see if we can make any sense of it.
-    try {
+        ConstElementPtr cmd, rsp;
+        JSONFeed& received = pending->second.received_;
+        if (!received.elementReady()) {
+            if (received.getPendingSize() <= MAX_COMMAND_SIZE) {
+                // Wait for the rest of the command.
+                break;
+            }
+            // The rest of the command can't be told apart from the next
+            // commands, so the connection is closed after the response.
+            LOG_ERROR(command_logger, COMMAND_SOCKET_COMMAND_TOOLARGE)
+                .arg(received.getPendingSize()).arg(sockfd);
+            closeConnection(sockfd);
+            rsp = createAnswer(CONTROL_RESULT_ERROR, "command is too large");
+
+        } else {
+            const std::string sbuf = received.popElement();
+
+            // Ok, we received something. Let's see if we can make any
+            // sense of it.
+            try {
+
+                // Try to interpret it as JSON.
+                cmd = Element::fromJSON(sbuf, true);
+
+                // If successful, then process it as a command.
+                rsp = processCommand(cmd);
+            } catch (const Exception& ex) {
+                LOG_WARN(command_logger, COMMAND_PROCESS_ERROR1).arg(ex.what());
+                rsp = createAnswer(CONTROL_RESULT_ERROR, std::string(ex.what()));
+            }
+        }
 
-        // Try to interpret it as JSON.
-        std::string sbuf(buf, static_cast<size_t>(rval));
-        cmd = Element::fromJSON(sbuf, true);
+        if (!rsp) {
+            LOG_WARN(command_logger, COMMAND_RESPONSE_ERROR);
+            continue;
+        }
 
-        // If successful, then process it as a command.
-        rsp = CommandMgr::instance().processCommand(cmd);
-    } catch (const Exception& ex) {
-        LOG_WARN(command_logger, COMMAND_PROCESS_ERROR1).arg(ex.what());
-        rsp = createAnswer(CONTROL_RESULT_ERROR, std::string(ex.what()));
-    }
+        // Let's convert JSON response to text and send it back over
+        // the socket. Note that at this stage the rsp pointer is always set.
+        std::string txt = rsp->str();
 
-    if (!rsp) {
-        LOG_WARN(command_logger, COMMAND_RESPONSE_ERROR);
-        // Only close the duped socket if it's different (should be)
-        if (rsp_fd != sockfd) {
-            close(rsp_fd);
+        pending = pending_data_.find(sockfd);
+        if (pending != pending_data_.end()) {
+            pending->second.response_.swap(txt);
+            pending->second.response_offset_ = 0;
+            writeResponse(sockfd);
+            continue;
         }
 
-        return;
+        // The command has closed the connection, so the rest of the response
+        // can't be sent later. Send as much as the socket accepts now.
+        ssize_t sent = writeData(rsp_fd, txt.c_str(), txt.length());
+        if (sent == static_cast<ssize_t>(txt.length())) {
+            LOG_DEBUG(command_logger, DBG_COMMAND, COMMAND_SOCKET_WRITE)
+                .arg(txt.length()).arg(sockfd);
+        } else {
+            LOG_ERROR(command_logger, COMMAND_SOCKET_WRITE_FAIL)
+                .arg(txt.length()).arg(sockfd)
+                .arg(sent < 0 ? strerror(errno) : "connection closed");
+        }
     }
 
-    // Let's convert JSON response to text. Note that at this stage
-    // the rsp pointer is always set.
-    std::string txt = rsp->str();
-    size_t len = txt.length();
-    if (len > 65535) {
-        // Hmm, our response is too large. Let's send the first
-        // 64KB and hope for the best.
-        LOG_ERROR(command_logger, COMMAND_SOCKET_RESPONSE_TOOLARGE).arg(len);
-
-        len = 65535;
+    // Only close the duped socket if it's different (should be)
+    if (rsp_fd != sockfd) {
+        close(rsp_fd);
     }
+}
 
-    // Send the data back over socket.
-    rval = write(rsp_fd, txt.c_str(), len);
-    int saverr = errno;
-
-    LOG_DEBUG(command_logger, DBG_COMMAND, COMMAND_SOCKET_WRITE).arg(len).arg(sockfd);
+void
+CommandMgr::writeResponse(int sockfd) {
+    std::map<int, PendingData>::iterator pending = pending_data_.find(sockfd);
+    if ((pending == pending_data_.end()) || pending->second.response_.empty()) {
+        isc::dhcp::IfaceMgr::instance().deleteExternalWriteSocket(sockfd);
+        return;
+    }
 
+    std::string& response = pending->second.response_;
+    size_t& offset = pending->second.response_offset_;
+    ssize_t rval = writeData(sockfd, response.c_str() + offset,
+                             response.length() - offset);
     if (rval < 0) {
-        // Response transmission failed. Since the response failed, it doesn't
-        // make sense to send any status codes. Let's log it and be done with
-        // it.
+        // Response transmission failed. Since the response failed, it
+        // doesn't make sense to send any status codes. Let's log it and
+        // be done with it.
         LOG_ERROR(command_logger, COMMAND_SOCKET_WRITE_FAIL)
-                  .arg(len).arg(sockfd).arg(strerror(saverr));
+            .arg(response.length()).arg(sockfd).arg(strerror(errno));
+        closeConnection(sockfd);
+        return;
     }
 
-    // Only close the duped socket if it's different (should be)
-    if (rsp_fd != sockfd) {
-        close(rsp_fd);
+    offset += rval;
+    if (offset < response.length()) {
+        // The client doesn't read fast enough. Send the rest when the
+        // socket becomes writable.
+        isc::dhcp::IfaceMgr::instance().addExternalWriteSocket(sockfd,
+            boost::bind(&CommandMgr::commandWriter, sockfd));
+        return;
     }
+
+    LOG_DEBUG(command_logger, DBG_COMMAND, COMMAND_SOCKET_WRITE)
+        .arg(response.length()).arg(sockfd);
+
+    isc::dhcp::IfaceMgr::instance().deleteExternalWriteSocket(sockfd);
+    response.clear();
+    offset = 0;
 }
 
 }; // end of isc::config
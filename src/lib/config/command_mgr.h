@@ -8,10 +8,13 @@
 #define COMMAND_MGR_H
 
 #include <cc/data.h>
+#include <cc/json_feed.h>
 #include <config/hooked_command_mgr.h>
 #include <config/command_socket.h>
 #include <boost/noncopyable.hpp>
 #include <list>
+#include <map>
+#include <string>
 
 namespace isc {
 namespace config {
@@ -56,9 +59,31 @@ public:
     /// method will close the socket and will uninstall itself from
     /// @ref isc::dhcp::IfaceMgr.
     ///
+    /// The connection may carry any number of commands sent one after
+    /// another, without waiting for the responses. A command may also span
+    /// multiple reads. The received data are appended to the buffer of the
+    /// connection and each complete command (JSON map or list) found in
+    /// the buffer is processed and responded to, in order. The incomplete
+    /// command is kept until the rest of it is received.
+    ///
+    /// The response is written without waiting for the client to read it.
+    /// The part of the response which the socket doesn't accept at once is
+    /// written by @ref commandWriter when the socket becomes writable, and
+    /// the next commands are processed when the whole response is written.
+    ///
     /// @param sockfd socket descriptor of a connected socket
     static void commandReader(int sockfd);
 
+    /// @brief Writes the rest of the response to a socket
+    ///
+    /// This callback is installed in the @ref isc::dhcp::IfaceMgr when the
+    /// socket doesn't accept the whole response at once and is uninstalled
+    /// when the response is written. It then processes the commands received
+    /// in the meantime.
+    ///
+    /// @param sockfd socket descriptor of a connected socket
+    static void commandWriter(int sockfd);
+
     /// @brief Adds an information about opened connection socket
     ///
     /// @param conn Connection socket to be stored
@@ -84,6 +109,41 @@ private:
     /// Registers internal 'list-commands' command.
     CommandMgr();
 
+    /// @brief Processes the commands received over the connection
+    ///
+    /// Processes the complete commands in order, until a response can't be
+    /// written at once or there are no more complete commands.
+    ///
+    /// @param sockfd socket descriptor of a connected socket
+    void processCommands(int sockfd);
+
+    /// @brief Writes as much of the pending response as the socket accepts
+    ///
+    /// Installs @ref commandWriter in the @ref isc::dhcp::IfaceMgr if the
+    /// response has not been written completely and uninstalls it otherwise.
+    /// The connection is closed if the write fails.
+    ///
+    /// @param sockfd socket descriptor of a connected socket
+    void writeResponse(int sockfd);
+
+    /// @brief Data exchanged over a connection which haven't been processed
+    /// yet
+    struct PendingData {
+        /// @brief Constructor
+        PendingData()
+            : received_(), response_(), response_offset_(0) {
+        }
+
+        /// @brief Received data holding the commands not processed yet
+        JSONFeed received_;
+
+        /// @brief Response which hasn't been written completely
+        std::string response_;
+
+        /// @brief Number of bytes of the response written so far
+        size_t response_offset_;
+    };
+
     /// @brief Control socket structure
     ///
     /// This is the socket that accepts incoming connections. There can be at
@@ -95,6 +155,12 @@ private:
     /// These are the sockets that are dedicated to handle a specific connection.
     /// Their number is equal to number of current control connections.
     std::list<CommandSocketPtr> connections_;
+
+    /// @brief Data exchanged over the connections and not processed yet
+    ///
+    /// This holds the commands not processed yet and the responses not
+    /// written yet, indexed by the socket descriptor of the connection.
+    std::map<int, PendingData> pending_data_;
 };
 
 }; // end of isc::config namespace
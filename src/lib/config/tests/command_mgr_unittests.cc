@@ -10,12 +10,17 @@
 #include <config/command_mgr.h>
 #include <config/hooked_command_mgr.h>
 #include <cc/command_interpreter.h>
+#include <dhcp/iface_mgr.h>
 #include <hooks/hooks_manager.h>
 #include <hooks/callout_handle.h>
 #include <hooks/library_handle.h>
 #include <string>
 #include <vector>
 
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
 using namespace isc::config;
 using namespace isc::data;
 using namespace isc::hooks;
@@ -63,6 +68,13 @@ public:
         return (createAnswer(123, "test error message"));
     }
 
+    /// @brief A command handler returning a response larger than the
+    /// socket buffers
+    static ConstElementPtr big_handler(const std::string& /*name*/,
+                                       const ConstElementPtr& /*params*/) {
+        return (createAnswer(0, std::string(1024 * 1024, 'x')));
+    }
+
     /// @brief A simple command handler used from within hook library.
     ///
     /// @param name Command name.
@@ -490,3 +502,208 @@ TEST_F(CommandMgrTest, modifyCommandArgsInHook) {
     EXPECT_EQ("response", callout_argument_names[1]);
 
 }
+
+// This test verifies that the commands carried in the batch are processed
+// in order and that the answers hold the execution time.
+TEST_F(CommandMgrTest, batch) {
+    EXPECT_NO_THROW(CommandMgr::instance().registerCommand("my-command",
+                                                           my_handler));
+
+    ConstElementPtr command = Element::fromJSON(
+        "{ \"command\": \"batch\", \"arguments\": { \"commands\": ["
+        "  { \"command\": \"my-command\", \"arguments\": [ 1 ] },"
+        "  { \"command\": \"bogus\" },"
+        "  { \"command\": \"batch\", \"arguments\": { \"commands\": [ ] } },"
+        "  \"not a command\","
+        "  { \"command\": \"list-commands\" }"
+        "] } }");
+
+    ConstElementPtr answer;
+    ASSERT_NO_THROW(answer = CommandMgr::instance().processCommand(command));
+    ASSERT_TRUE(answer);
+
+    int status_code;
+    ConstElementPtr answers = parseAnswer(status_code, answer);
+    EXPECT_EQ(CONTROL_RESULT_SUCCESS, status_code);
+    ASSERT_TRUE(answers);
+    ASSERT_EQ(Element::list, answers->getType());
+    ASSERT_EQ(5, answers->size());
+
+    // The handler has been called with the arguments of its command.
+    EXPECT_TRUE(handler_called);
+    EXPECT_EQ("my-command", handler_name);
+    ASSERT_TRUE(handler_params);
+    EXPECT_EQ("[ 1 ]", handler_params->str());
+
+    const int expected_codes[] = { 123, CONTROL_RESULT_ERROR,
+                                   CONTROL_RESULT_ERROR, CONTROL_RESULT_ERROR,
+                                   CONTROL_RESULT_SUCCESS };
+    for (unsigned i = 0; i < answers->size(); ++i) {
+        SCOPED_TRACE(answers->get(i)->str());
+        ConstElementPtr time = answers->get(i)->get("execution-time");
+        ASSERT_TRUE(time);
+        ASSERT_EQ(Element::integer, time->getType());
+        EXPECT_LE(0, time->intValue());
+
+        ASSERT_NO_THROW(parseAnswer(status_code, answers->get(i)));
+        EXPECT_EQ(expected_codes[i], status_code);
+    }
+
+    // The batch isn't nested.
+    EXPECT_EQ("'batch' command can't be nested",
+              answers->get(2)->get("text")->stringValue());
+
+    // The batch is not a regular command.
+    ConstElementPtr commands = parseAnswer(status_code,
+                                           answers->get(4));
+    ASSERT_TRUE(commands);
+    EXPECT_EQ("[ \"list-commands\", \"my-command\" ]", commands->str());
+}
+
+// This test verifies that the batch without the list of commands is
+// rejected and that the handler for the batch can't be installed.
+TEST_F(CommandMgrTest, batchInvalid) {
+    ConstElementPtr answer;
+    int status_code;
+
+    answer = CommandMgr::instance().processCommand(createCommand("batch"));
+    ASSERT_TRUE(answer);
+    parseAnswer(status_code, answer);
+    EXPECT_EQ(CONTROL_RESULT_ERROR, status_code);
+
+    answer = CommandMgr::instance().processCommand(
+        createCommand("batch", Element::fromJSON("{ \"commands\": 1 }")));
+    ASSERT_TRUE(answer);
+    parseAnswer(status_code, answer);
+    EXPECT_EQ(CONTROL_RESULT_ERROR, status_code);
+
+    EXPECT_THROW(CommandMgr::instance().registerCommand("batch", my_handler),
+                 InvalidCommandName);
+}
+
+// This test verifies that each command carried in the batch is passed
+// to the hook library.
+TEST_F(CommandMgrTest, batchDelegate) {
+    HooksManager::preCalloutsLibraryHandle().registerCallout(
+        "control_command_receive", control_command_receive_handle_callout);
+
+    ConstElementPtr command = Element::fromJSON(
+        "{ \"command\": \"batch\", \"arguments\": { \"commands\": ["
+        "  { \"command\": \"my-command\" }"
+        "] } }");
+
+    ConstElementPtr answer;
+    ASSERT_NO_THROW(answer = CommandMgr::instance().processCommand(command));
+    ASSERT_TRUE(answer);
+
+    int status_code;
+    ConstElementPtr answers = parseAnswer(status_code, answer);
+    EXPECT_EQ(CONTROL_RESULT_SUCCESS, status_code);
+    ASSERT_TRUE(answers);
+    ASSERT_EQ(1, answers->size());
+
+    // The command has been handled by the hook library.
+    parseAnswer(status_code, answers->get(0));
+    EXPECT_EQ(234, status_code);
+    EXPECT_FALSE(handler_called);
+}
+
+// This test verifies that multiple commands can be sent over the connection
+// without waiting for the responses and that the command may be split
+// between reads.
+TEST_F(CommandMgrTest, commandReaderPipelining) {
+    EXPECT_NO_THROW(CommandMgr::instance().registerCommand("my-command",
+                                                           my_handler));
+
+    int fds[2];
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+
+    // Two complete commands and a half of the third one.
+    const std::string cmd1 = "{ \"command\": \"my-command\" }";
+    const std::string cmd2 = "\n# comment with { \"\n"
+        "{ \"command\": \"my-command\", \"arguments\": [ \"}\" ] }";
+    const std::string cmd3 = " { \"command\": \"list-commands\" }";
+    std::string data = cmd1 + cmd2 + cmd3.substr(0, 10);
+    ASSERT_EQ(static_cast<ssize_t>(data.size()),
+              write(fds[1], data.c_str(), data.size()));
+
+    CommandMgr::commandReader(fds[0]);
+
+    const std::string rsp_error =
+        "{ \"result\": 123, \"text\": \"test error message\" }";
+    char buf[1024];
+    ssize_t len = read(fds[1], buf, sizeof(buf));
+    ASSERT_LT(0, len);
+    EXPECT_EQ(rsp_error + rsp_error, std::string(buf, len));
+    ASSERT_TRUE(handler_params);
+    EXPECT_EQ("[ \"}\" ]", handler_params->str());
+
+    // Complete the third command.
+    data = cmd3.substr(10);
+    ASSERT_EQ(static_cast<ssize_t>(data.size()),
+              write(fds[1], data.c_str(), data.size()));
+
+    CommandMgr::commandReader(fds[0]);
+
+    len = read(fds[1], buf, sizeof(buf));
+    ASSERT_LT(0, len);
+    EXPECT_EQ("{ \"arguments\": [ \"list-commands\", \"my-command\" ],"
+              " \"result\": 0 }", std::string(buf, len));
+
+    // Data which can't be a command are reported at once.
+    data = "utter nonsense";
+    ASSERT_EQ(static_cast<ssize_t>(data.size()),
+              write(fds[1], data.c_str(), data.size()));
+
+    CommandMgr::commandReader(fds[0]);
+
+    len = read(fds[1], buf, sizeof(buf));
+    ASSERT_LT(0, len);
+    EXPECT_EQ("{ \"result\": 1, \"text\": \"error: unexpected character u"
+              " in <string>:1:2\" }", std::string(buf, len));
+
+    close(fds[0]);
+    close(fds[1]);
+}
+
+// This test verifies that the response which the socket doesn't accept at
+// once is written when the socket becomes writable and that the next command
+// is processed after the response has been written.
+TEST_F(CommandMgrTest, commandWriter) {
+    EXPECT_NO_THROW(CommandMgr::instance().registerCommand("big-command",
+                                                           big_handler));
+    EXPECT_NO_THROW(CommandMgr::instance().registerCommand("my-command",
+                                                           my_handler));
+
+    int fds[2];
+    ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, fds));
+    ASSERT_EQ(0, fcntl(fds[0], F_SETFL, O_NONBLOCK));
+
+    const std::string data = "{ \"command\": \"big-command\" }"
+        "{ \"command\": \"my-command\" }";
+    ASSERT_EQ(static_cast<ssize_t>(data.size()),
+              write(fds[1], data.c_str(), data.size()));
+
+    CommandMgr::commandReader(fds[0]);
+
+    // The second command waits until the first response is written.
+    EXPECT_FALSE(handler_called);
+
+    const std::string expected = big_handler("", ConstElementPtr())->str() +
+        "{ \"result\": 123, \"text\": \"test error message\" }";
+    std::string received;
+    char buf[65536];
+    while (received.size() < expected.size()) {
+        ssize_t len = read(fds[1], buf, sizeof(buf));
+        ASSERT_LT(0, len);
+        received.append(buf, len);
+
+        // The IfaceMgr calls the CommandMgr when the socket is writable.
+        ASSERT_NO_THROW(isc::dhcp::IfaceMgr::instance().receive4(0, 1000));
+    }
+    EXPECT_TRUE(handler_called);
+    EXPECT_TRUE(received == expected);
+
+    close(fds[0]);
+    close(fds[1]);
+}
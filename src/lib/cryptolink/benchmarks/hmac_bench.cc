@@ -0,0 +1,143 @@
+// Copyright (C) 2017 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/// @file hmac_bench.cc
+///
+/// Measures the throughput of signing and verifying messages with HMAC,
+/// as done by TSIG for each DNS update and its response. For each hash
+/// algorithm, the program signs a message and verifies the signature:
+/// - with HMAC objects created from the secret with
+///   @c CryptoLink::createHMAC, as TSIG did for each message,
+/// - with HMAC objects cloned from a pre-keyed HMAC object using
+///   @c HMAC::clone, as TSIG does now.
+/// The number of sign and verify pairs per second is printed.
+
+#include <config.h>
+#include <cryptolink/cryptolink.h>
+#include <cryptolink/crypto_hmac.h>
+#include <util/buffer.h>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/shared_ptr.hpp>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace isc::cryptolink;
+using namespace isc::util;
+
+namespace {
+
+/// @brief Number of sign and verify pairs for each algorithm and method.
+const size_t OPERATIONS = 200000;
+
+/// @brief Size of the signed message, typical for a DNS update.
+const size_t MESSAGE_SIZE = 256;
+
+/// @brief Pointer to an HMAC object.
+typedef boost::shared_ptr<HMAC> HMACPtr;
+
+/// @brief Prints the number of operations per second.
+///
+/// @param name Name of the method.
+/// @param start Time when the operations started.
+/// @param result Number of the successful verifications, printed so as
+/// the compiler doesn't optimize the operations out.
+void
+report(const std::string& name, const boost::posix_time::ptime& start,
+       const size_t result) {
+    boost::posix_time::time_duration elapsed =
+        boost::posix_time::microsec_clock::universal_time() - start;
+    const double seconds = elapsed.total_microseconds() / 1000000.0;
+    std::cout << "  " << std::left << std::setw(10) << name
+              << std::right << std::setw(12) << std::fixed
+              << std::setprecision(0)
+              << (seconds > 0 ? OPERATIONS / seconds : 0)
+              << " sign+verify/s (" << result << ")" << std::endl;
+}
+
+/// @brief Runs the benchmark for the specified hash algorithm.
+///
+/// @param name Name of the algorithm.
+/// @param algorithm The hash algorithm.
+/// @param secret The secret.
+void
+benchmark(const std::string& name, const HashAlgorithm algorithm,
+          const std::string& secret) {
+    std::cout << name << ":" << std::endl;
+
+    std::vector<uint8_t> message(MESSAGE_SIZE);
+    for (size_t i = 0; i < message.size(); ++i) {
+        message[i] = static_cast<uint8_t>(random());
+    }
+
+    CryptoLink& crypto = CryptoLink::getCryptoLink();
+    OutputBuffer sig(0);
+
+    size_t result = 0;
+    boost::posix_time::ptime start =
+        boost::posix_time::microsec_clock::universal_time();
+    for (size_t i = 0; i < OPERATIONS; ++i) {
+        HMACPtr hmac_sign(crypto.createHMAC(secret.c_str(), secret.size(),
+                                            algorithm),
+                          deleteHMAC);
+        hmac_sign->update(&message[0], message.size());
+        sig.clear();
+        hmac_sign->sign(sig, hmac_sign->getOutputLength());
+
+        HMACPtr hmac_verify(crypto.createHMAC(secret.c_str(), secret.size(),
+                                              algorithm),
+                            deleteHMAC);
+        hmac_verify->update(&message[0], message.size());
+        if (hmac_verify->verify(sig.getData(), sig.getLength())) {
+            ++result;
+        }
+    }
+    report("create", start, result);
+
+    HMACPtr keyed(crypto.createHMAC(secret.c_str(), secret.size(),
+                                    algorithm),
+                  deleteHMAC);
+
+    result = 0;
+    start = boost::posix_time::microsec_clock::universal_time();
+    for (size_t i = 0; i < OPERATIONS; ++i) {
+        HMACPtr hmac_sign(keyed->clone(), deleteHMAC);
+        hmac_sign->update(&message[0], message.size());
+        sig.clear();
+        hmac_sign->sign(sig, hmac_sign->getOutputLength());
+
+        HMACPtr hmac_verify(keyed->clone(), deleteHMAC);
+        hmac_verify->update(&message[0], message.size());
+        if (hmac_verify->verify(sig.getData(), sig.getLength())) {
+            ++result;
+        }
+    }
+    report("clone", start, result);
+}
+
+}
+
+int
+main() {
+    // A secret of the size of the digest, as generated by the usual tools.
+    const std::string secret(64, 'k');
+
+    try {
+        benchmark("HMAC-MD5", MD5, secret.substr(0, 16));
+        benchmark("HMAC-SHA1", SHA1, secret.substr(0, 20));
+        benchmark("HMAC-SHA224", SHA224, secret.substr(0, 28));
+        benchmark("HMAC-SHA256", SHA256, secret.substr(0, 32));
+        benchmark("HMAC-SHA384", SHA384, secret.substr(0, 48));
+        benchmark("HMAC-SHA512", SHA512, secret);
+    } catch (const std::exception& ex) {
+        std::cerr << "benchmark failed: " << ex.what() << std::endl;
+        return (EXIT_FAILURE);
+    }
+
+    return (EXIT_SUCCESS);
+}
@@ -1,4 +1,4 @@
-// Copyright (C) 2011-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2011-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -35,7 +35,7 @@ public:
     /// @param hash_algorithm The hash algorithm
     explicit HMACImpl(const void* secret, size_t secret_len,
                       const HashAlgorithm hash_algorithm)
-    : hash_algorithm_(hash_algorithm), hmac_() {
+    : hash_algorithm_(hash_algorithm), hmac_(), key_() {
         Botan::HashFunction* hash;
         try {
             hash = Botan::get_hash(btn::getHashAlgorithmName(hash_algorithm));
@@ -64,19 +64,18 @@ public:
             size_t block_length = 0;
 #endif
             if (secret_len > block_length) {
-                Botan::SecureVector<Botan::byte> hashed_key =
-                    hash->process(static_cast<const Botan::byte*>(secret),
-                                  secret_len);
-                hmac_->set_key(hashed_key.begin(), hashed_key.size());
+                key_ = hash->process(static_cast<const Botan::byte*>(secret),
+                                     secret_len);
             } else {
                 // Botan 1.8 considers len 0 a bad key. 1.9 does not,
                 // but we won't accept it anyway, and fail early
                 if (secret_len == 0) {
                     isc_throw(BadKey, "Bad HMAC secret length: 0");
                 }
-                hmac_->set_key(static_cast<const Botan::byte*>(secret),
-                               secret_len);
+                key_.set(static_cast<const Botan::byte*>(secret),
+                         secret_len);
             }
+            hmac_->set_key(key_.begin(), key_.size());
         } catch (const Botan::Invalid_Key_Length& ikl) {
             isc_throw(BadKey, ikl.what());
         } catch (const Botan::Exception& exc) {
@@ -84,6 +83,24 @@ public:
         }
     }
 
+    /// @brief Copy constructor used by clone()
+    ///
+    /// Creates a new HMAC object for the hash function of the source and
+    /// keys it with the key of the source. This skips the hash function
+    /// lookup and the hashing of long secrets. The data added to the
+    /// source isn't carried over.
+    ///
+    /// @param source The object to copy
+    HMACImpl(const HMACImpl& source)
+    : hash_algorithm_(source.hash_algorithm_), hmac_(), key_(source.key_) {
+        try {
+            hmac_.reset(static_cast<Botan::HMAC*>(source.hmac_->clone()));
+            hmac_->set_key(key_.begin(), key_.size());
+        } catch (const Botan::Exception& exc) {
+            isc_throw(LibraryError, exc.what());
+        }
+    }
+
     /// @brief Destructor
     ~HMACImpl() {
     }
@@ -194,6 +211,13 @@ public:
         }
     }
 
+    /// @brief Create a copy of the object in its initial state
+    ///
+    /// See @ref isc::cryptolink::HMAC::clone() for details.
+    HMACImpl* clone() const {
+        return (new HMACImpl(*this));
+    }
+
 private:
     /// @brief The hash algorithm
     HashAlgorithm hash_algorithm_;
@@ -201,6 +225,9 @@ private:
     /// @brief The protected pointer to the Botan HMAC object
     boost::scoped_ptr<Botan::HMAC> hmac_;
 
+    /// @brief The key (the digest of the secret if it was too long)
+    Botan::SecureVector<Botan::byte> key_;
+
     /// @brief The digest cache for multiple verify
     Botan::SecureVector<Botan::byte> digest_;
 };
@@ -211,6 +238,9 @@ HMAC::HMAC(const void* secret, size_t secret_length,
     impl_ = new HMACImpl(secret, secret_length, hash_algorithm);
 }
 
+HMAC::HMAC(HMACImpl* impl) : impl_(impl) {
+}
+
 HMAC::~HMAC() {
     delete impl_;
 }
@@ -250,5 +280,10 @@ HMAC::verify(const void* sig, const size_t len) {
     return (impl_->verify(sig, len));
 }
 
+HMAC*
+HMAC::clone() const {
+    return (new HMAC(impl_->clone()));
+}
+
 } // namespace cryptolink
 } // namespace isc
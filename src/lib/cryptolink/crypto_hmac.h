@@ -1,4 +1,4 @@
-// Copyright (C) 2011-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2011-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -45,6 +45,14 @@ private:
     HMAC(const void* secret, size_t secret_len,
          const HashAlgorithm hash_algorithm);
 
+    /// \brief Constructor from an implementation object
+    ///
+    /// Used by clone(). The HMAC object takes the ownership of the
+    /// implementation object.
+    ///
+    /// \param impl The implementation object
+    explicit HMAC(HMACImpl* impl);
+
     friend HMAC* CryptoLink::createHMAC(const void*, size_t,
                                         const HashAlgorithm);
 
@@ -129,6 +137,25 @@ public:
     /// called multiple times with different signatures.
     bool verify(const void* sig, size_t len);
 
+    /// \brief Create a copy of the HMAC object in its initial state
+    ///
+    /// The returned object uses the same hash algorithm and secret as
+    /// this object, but none of the data added to this object with
+    /// update(). Cloning reuses the keyed state of this object, so it is
+    /// much cheaper than CryptoLink::createHMAC(), which looks up the
+    /// hash algorithm and derives the keyed state from the secret.
+    /// Callers signing many messages with the same secret should keep
+    /// one HMAC object and clone it for each message.
+    ///
+    /// The caller is responsible for deleting the returned object, e.g.
+    /// with deleteHMAC().
+    ///
+    /// \exception LibraryError if there was any unexpected exception
+    ///                         in the underlying library
+    ///
+    /// \return A pointer to the new HMAC object
+    HMAC* clone() const;
+
 private:
     HMACImpl* impl_;
 };
@@ -1,4 +1,4 @@
-// Copyright (C) 2014-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2014-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -52,6 +52,28 @@ public:
         }
     }
 
+    /// @brief Copy constructor used by clone()
+    ///
+    /// Copies the keyed context of the source and resets it to the
+    /// initial state so the data added to the source isn't carried over.
+    ///
+    /// @param source The object to copy
+    HMACImpl(const HMACImpl& source)
+    : hash_algorithm_(source.hash_algorithm_), md_(new HMAC_CTX) {
+        HMAC_CTX_init(md_.get());
+
+        if (!HMAC_CTX_copy(md_.get(), source.md_.get())) {
+            HMAC_CTX_cleanup(md_.get());
+            isc_throw(LibraryError, "HMAC_CTX_copy");
+        }
+
+        // With no key and no digest HMAC_Init_ex reuses the key.
+        if (!HMAC_Init_ex(md_.get(), NULL, 0, NULL, NULL)) {
+            HMAC_CTX_cleanup(md_.get());
+            isc_throw(LibraryError, "HMAC_Init_ex");
+        }
+    }
+
     /// @brief Destructor
     ~HMACImpl() {
         if (md_) {
@@ -158,6 +180,13 @@ public:
         return (digest.same(sig, len));
     }
 
+    /// @brief Create a copy of the object in its initial state
+    ///
+    /// See @ref isc::cryptolink::HMAC::clone() for details.
+    HMACImpl* clone() const {
+        return (new HMACImpl(*this));
+    }
+
 private:
     /// @brief The hash algorithm
     HashAlgorithm hash_algorithm_;
@@ -172,6 +201,9 @@ HMAC::HMAC(const void* secret, size_t secret_length,
     impl_ = new HMACImpl(secret, secret_length, hash_algorithm);
 }
 
+HMAC::HMAC(HMACImpl* impl) : impl_(impl) {
+}
+
 HMAC::~HMAC() {
     delete impl_;
 }
@@ -211,5 +243,10 @@ HMAC::verify(const void* sig, const size_t len) {
     return (impl_->verify(sig, len));
 }
 
+HMAC*
+HMAC::clone() const {
+    return (new HMAC(impl_->clone()));
+}
+
 } // namespace cryptolink
 } // namespace isc
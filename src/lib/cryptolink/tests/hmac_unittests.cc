@@ -1,4 +1,4 @@
-// Copyright (C) 2011-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2011-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -715,3 +715,51 @@ TEST(HMACTest, BadKey) {
                             hmac_sig.getLength()),
                             UnsupportedAlgorithm);
 }
+
+namespace {
+    /// @brief Check that a clone signs like a new HMAC object
+    /// @param alg Hash algorithm enum
+    /// @param secret Secret to sign with
+    void cloneCheck(HashAlgorithm alg, const std::string& secret) {
+        CryptoLink& crypto = CryptoLink::getCryptoLink();
+        boost::shared_ptr<HMAC> hmac(crypto.createHMAC(secret.c_str(),
+                                                       secret.size(), alg),
+                                     deleteHMAC);
+        boost::shared_ptr<HMAC> expected(crypto.createHMAC(secret.c_str(),
+                                                           secret.size(),
+                                                           alg),
+                                         deleteHMAC);
+        expected->update("data to sign", 12);
+        const std::vector<uint8_t> expected_sig =
+            expected->sign(expected->getOutputLength());
+        ASSERT_FALSE(expected_sig.empty());
+
+        // Data added to the original is not carried over to the clone.
+        hmac->update("some other data", 15);
+
+        boost::shared_ptr<HMAC> clone(hmac->clone(), deleteHMAC);
+        EXPECT_EQ(alg, clone->getHashAlgorithm());
+        EXPECT_EQ(hmac->getOutputLength(), clone->getOutputLength());
+        clone->update("data to sign", 12);
+        EXPECT_TRUE(expected_sig ==
+                    clone->sign(clone->getOutputLength()));
+
+        // The clone doesn't affect the original nor the other clones.
+        EXPECT_FALSE(hmac->verify(&expected_sig[0], expected_sig.size()));
+        boost::shared_ptr<HMAC> clone2(hmac->clone(), deleteHMAC);
+        clone2->update("data to sign", 12);
+        EXPECT_TRUE(clone2->verify(&expected_sig[0], expected_sig.size()));
+    }
+}
+
+TEST(HMACTest, Clone) {
+    std::string long_secret;
+    fillString(long_secret, 200, 0xaa);
+    HashAlgorithm algs[] = { MD5, SHA1, SHA256, SHA224, SHA384, SHA512 };
+    for (size_t i = 0; i < sizeof(algs) / sizeof(algs[0]); ++i) {
+        SCOPED_TRACE(lexical_cast<std::string>(static_cast<int>(algs[i])));
+        cloneCheck(algs[i], "asdf");
+        // Secrets longer than the block size are hashed first.
+        cloneCheck(algs[i], long_secret);
+    }
+}
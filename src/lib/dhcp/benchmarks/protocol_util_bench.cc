@@ -0,0 +1,174 @@
+// Copyright (C) 2017 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/// @file protocol_util_bench.cc
+///
+/// Measures the time of the operations performed when the DHCPv4 message
+/// is sent over the raw socket. The program:
+/// - calculates the checksum of the buffers of the typical DHCPv4 message
+///   sizes using @c calcChecksum and the word by word loop it replaced,
+/// - assembles the Ethernet, IP and UDP headers of the frame carrying the
+///   DHCPv4 message, with and without copying the message to the buffer
+///   holding the headers.
+/// The average time of a single operation is printed.
+
+#include <config.h>
+#include <asiolink/io_address.h>
+#include <dhcp/dhcp4.h>
+#include <dhcp/hwaddr.h>
+#include <dhcp/pkt4.h>
+#include <dhcp/protocol_util.h>
+#include <util/buffer.h>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using namespace isc::asiolink;
+using namespace isc::dhcp;
+using namespace isc::util;
+
+namespace {
+
+/// @brief Number of operations performed for each type of the operation.
+const size_t OPERATIONS = 1000000;
+
+/// @brief Calculates the checksum one word at a time.
+///
+/// This is the implementation of the @c calcChecksum prior to using
+/// the vector instructions.
+///
+/// @param buf buffer for which the checksum is calculated.
+/// @param buf_size size of the buffer.
+/// @param sum initial checksum value.
+uint16_t
+calcChecksumWords(const uint8_t* buf, const uint32_t buf_size, uint32_t sum) {
+    uint32_t i;
+    for (i = 0; i < (buf_size & ~1U); i += 2) {
+        uint16_t chunk = buf[i] << 8 | buf[i + 1];
+        sum += chunk;
+        if (sum > 0xFFFF) {
+            sum -= 0xFFFF;
+        }
+    }
+    if (i < buf_size) {
+        sum += buf[i] << 8;
+        if (sum > 0xFFFF) {
+            sum -= 0xFFFF;
+        }
+    }
+    return (sum);
+}
+
+/// @brief Prints the average time of a single operation.
+///
+/// @param name Name of the operation.
+/// @param start Time when the operations started.
+/// @param result Value accumulated from the results of the operations,
+/// printed so as the compiler doesn't optimize the operations out.
+void
+report(const std::string& name, const boost::posix_time::ptime& start,
+       const size_t result) {
+    boost::posix_time::time_duration elapsed =
+        boost::posix_time::microsec_clock::universal_time() - start;
+    std::cout << "  " << std::left << std::setw(24) << name
+              << std::right << std::setw(10) << std::fixed
+              << std::setprecision(1)
+              << (elapsed.total_microseconds() * 1000.0 / OPERATIONS)
+              << " ns/op (" << result << ")" << std::endl;
+}
+
+/// @brief Runs the benchmark for the specified message size.
+///
+/// @param size Size of the DHCPv4 message.
+void
+benchmark(const uint32_t size) {
+    std::cout << size << " bytes:" << std::endl;
+
+    std::vector<uint8_t> data(size);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<uint8_t>(random());
+    }
+
+    size_t result = 0;
+    boost::posix_time::ptime start =
+        boost::posix_time::microsec_clock::universal_time();
+    for (size_t i = 0; i < OPERATIONS; ++i) {
+        result += calcChecksumWords(&data[0], size, i & 0xFF);
+    }
+    report("checksum (words)", start, result);
+
+    result = 0;
+    start = boost::posix_time::microsec_clock::universal_time();
+    for (size_t i = 0; i < OPERATIONS; ++i) {
+        result += calcChecksum(&data[0], size, i & 0xFF);
+    }
+    report("checksum", start, result);
+
+    // The packet holds the message in its output buffer.
+    Pkt4Ptr pkt(new Pkt4(DHCPOFFER, 1234));
+    pkt->getBuffer().writeData(&data[0], data.size());
+    pkt->setLocalAddr(IOAddress("192.0.2.1"));
+    pkt->setRemoteAddr(IOAddress("192.0.2.10"));
+    pkt->setLocalPort(DHCP4_SERVER_PORT);
+    pkt->setRemotePort(DHCP4_CLIENT_PORT);
+    pkt->setLocalHWAddr(HWAddrPtr(new HWAddr(std::vector<uint8_t>(6, 1),
+                                             HTYPE_ETHER)));
+    pkt->setRemoteHWAddr(HWAddrPtr(new HWAddr(std::vector<uint8_t>(6, 2),
+                                              HTYPE_ETHER)));
+
+    OutputBuffer buf(ETHERNET_HEADER_LEN + MIN_IP_HEADER_LEN +
+                     UDP_HEADER_LEN + size);
+
+    result = 0;
+    start = boost::posix_time::microsec_clock::universal_time();
+    for (size_t i = 0; i < OPERATIONS; ++i) {
+        buf.clear();
+        writeEthernetHeader(pkt, buf);
+        writeIpUdpHeader(pkt, buf);
+        buf.writeData(pkt->getBuffer().getData(), pkt->getBuffer().getLength());
+        result += buf.getLength();
+    }
+    report("frame (copy)", start, result);
+
+    result = 0;
+    start = boost::posix_time::microsec_clock::universal_time();
+    for (size_t i = 0; i < OPERATIONS; ++i) {
+        buf.clear();
+        writeEthernetHeader(pkt, buf);
+        writeIpUdpHeader(pkt, buf);
+        result += buf.getLength() + pkt->getBuffer().getLength();
+    }
+    report("frame (headers only)", start, result);
+}
+
+}
+
+int
+main(int argc, char* argv[]) {
+    std::vector<uint32_t> sizes;
+    for (int i = 1; i < argc; ++i) {
+        sizes.push_back(static_cast<uint32_t>(strtoul(argv[i], NULL, 10)));
+    }
+    if (sizes.empty()) {
+        sizes.push_back(300);
+        sizes.push_back(576);
+        sizes.push_back(1472);
+    }
+
+    for (std::vector<uint32_t>::const_iterator size = sizes.begin();
+         size != sizes.end(); ++size) {
+        if ((*size == 0) || (*size > 65507)) {
+            std::cerr << "message size must be between 1 and 65507"
+                      << std::endl;
+            return (EXIT_FAILURE);
+        }
+        benchmark(*size);
+    }
+
+    return (EXIT_SUCCESS);
+}
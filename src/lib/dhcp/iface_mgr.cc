@@ -1,4 +1,4 @@
-// Copyright (C) 2011-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2011-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -262,6 +262,7 @@ Iface::countActive4() const {
 
 void IfaceMgr::closeSockets() {
     BOOST_FOREACH(IfacePtr iface, ifaces_) {
+        releaseSockets4(*iface);
         iface->closeSockets();
     }
 }
@@ -269,10 +270,22 @@ void IfaceMgr::closeSockets() {
 void
 IfaceMgr::closeSockets(const uint16_t family) {
     BOOST_FOREACH(IfacePtr iface, ifaces_) {
+        if (family == AF_INET) {
+            releaseSockets4(*iface);
+        }
         iface->closeSockets(family);
     }
 }
 
+void
+IfaceMgr::releaseSockets4(const Iface& iface) {
+    BOOST_FOREACH(SocketInfo sock, iface.getSockets()) {
+        if (sock.family_ == AF_INET) {
+            packet_filter_->releaseSocket(sock);
+        }
+    }
+}
+
 IfaceMgr::~IfaceMgr() {
     // control_buf_ is deleted automatically (scoped_ptr)
     control_buf_len_ = 0;
@@ -318,9 +331,41 @@ IfaceMgr::deleteExternalSocket(int socketfd) {
     }
 }
 
+void
+IfaceMgr::addExternalWriteSocket(int socketfd, SocketCallback callback) {
+    if (socketfd < 0) {
+        isc_throw(BadValue, "Attempted to install callback for invalid socket "
+                  << socketfd);
+    }
+    for (SocketCallbackInfoContainer::iterator s = write_callbacks_.begin();
+         s != write_callbacks_.end(); ++s) {
+        if (s->socket_ == socketfd) {
+            s->callback_ = callback;
+            return;
+        }
+    }
+
+    SocketCallbackInfo x;
+    x.socket_ = socketfd;
+    x.callback_ = callback;
+    write_callbacks_.push_back(x);
+}
+
+void
+IfaceMgr::deleteExternalWriteSocket(int socketfd) {
+    for (SocketCallbackInfoContainer::iterator s = write_callbacks_.begin();
+         s != write_callbacks_.end(); ++s) {
+        if (s->socket_ == socketfd) {
+            write_callbacks_.erase(s);
+            return;
+        }
+    }
+}
+
 void
 IfaceMgr::deleteAllExternalSockets() {
     callbacks_.clear();
+    write_callbacks_.clear();
 }
 
 void
@@ -921,6 +966,16 @@ Pkt4Ptr IfaceMgr::receive4(uint32_t timeout_sec, uint32_t timeout_usec /* = 0 */
         }
     }
 
+    // The external sockets waiting to become writable are watched as well.
+    fd_set write_sockets;
+    FD_ZERO(&write_sockets);
+    BOOST_FOREACH(SocketCallbackInfo s, write_callbacks_) {
+        FD_SET(s.socket_, &write_sockets);
+        if (maxfd < s.socket_) {
+            maxfd = s.socket_;
+        }
+    }
+
     struct timeval select_timeout;
     select_timeout.tv_sec = timeout_sec;
     select_timeout.tv_usec = timeout_usec;
@@ -928,7 +983,9 @@ Pkt4Ptr IfaceMgr::receive4(uint32_t timeout_sec, uint32_t timeout_usec /* = 0 */
     // zero out the errno to be safe
     errno = 0;
 
-    int result = select(maxfd + 1, &sockets, NULL, NULL, &select_timeout);
+    int result = select(maxfd + 1, &sockets,
+                        write_callbacks_.empty() ? NULL : &write_sockets,
+                        NULL, &select_timeout);
 
     if (result == 0) {
         // nothing received and timeout has been reached
@@ -949,6 +1006,20 @@ Pkt4Ptr IfaceMgr::receive4(uint32_t timeout_sec, uint32_t timeout_usec /* = 0 */
         }
     }
 
+    // Let the owner of the external socket send more data. The callback
+    // may delete the socket, so only one callback is called at a time.
+    BOOST_FOREACH(SocketCallbackInfo s, write_callbacks_) {
+        if (!FD_ISSET(s.socket_, &write_sockets)) {
+            continue;
+        }
+
+        if (s.callback_) {
+            s.callback_();
+        }
+
+        return (Pkt4Ptr());
+    }
+
     // Let's find out which socket has the data
     BOOST_FOREACH(SocketCallbackInfo s, callbacks_) {
         if (!FD_ISSET(s.socket_, &sockets)) {
@@ -1031,6 +1102,16 @@ Pkt6Ptr IfaceMgr::receive6(uint32_t timeout_sec, uint32_t timeout_usec /* = 0 */
         }
     }
 
+    // The external sockets waiting to become writable are watched as well.
+    fd_set write_sockets;
+    FD_ZERO(&write_sockets);
+    BOOST_FOREACH(SocketCallbackInfo s, write_callbacks_) {
+        FD_SET(s.socket_, &write_sockets);
+        if (maxfd < s.socket_) {
+            maxfd = s.socket_;
+        }
+    }
+
     struct timeval select_timeout;
     select_timeout.tv_sec = timeout_sec;
     select_timeout.tv_usec = timeout_usec;
@@ -1038,7 +1119,9 @@ Pkt6Ptr IfaceMgr::receive6(uint32_t timeout_sec, uint32_t timeout_usec /* = 0 */
     // zero out the errno to be safe
     errno = 0;
 
-    int result = select(maxfd + 1, &sockets, NULL, NULL, &select_timeout);
+    int result = select(maxfd + 1, &sockets,
+                        write_callbacks_.empty() ? NULL : &write_sockets,
+                        NULL, &select_timeout);
 
     if (result == 0) {
         // nothing received and timeout has been reached
@@ -1059,6 +1142,20 @@ Pkt6Ptr IfaceMgr::receive6(uint32_t timeout_sec, uint32_t timeout_usec /* = 0 */
         }
     }
 
+    // Let the owner of the external socket send more data. The callback
+    // may delete the socket, so only one callback is called at a time.
+    BOOST_FOREACH(SocketCallbackInfo s, write_callbacks_) {
+        if (!FD_ISSET(s.socket_, &write_sockets)) {
+            continue;
+        }
+
+        if (s.callback_) {
+            s.callback_();
+        }
+
+        return (Pkt6Ptr());
+    }
+
     // Let's find out which socket has the data
     BOOST_FOREACH(SocketCallbackInfo s, callbacks_) {
         if (!FD_ISSET(s.socket_, &sockets)) {
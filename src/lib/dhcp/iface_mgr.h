@@ -1,4 +1,4 @@
-// Copyright (C) 2011-2015 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2011-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -718,6 +718,8 @@ public:
     ///
     /// This method also checks if data arrived over registered external socket.
     /// This data may be of a different protocol family than AF_INET6.
+    /// It calls the callback of one of the external sockets which have
+    /// become writable, if any, instead of receiving the message.
     ///
     /// @param timeout_sec specifies integral part of the timeout (in seconds)
     /// @param timeout_usec specifies fractional part of the timeout
@@ -740,6 +742,8 @@ public:
     ///
     /// This method also checks if data arrived over registered external socket.
     /// This data may be of a different protocol family than AF_INET.
+    /// It calls the callback of one of the external sockets which have
+    /// become writable, if any, instead of receiving the message.
     ///
     /// @param timeout_sec specifies integral part of the timeout (in seconds)
     /// @param timeout_usec specifies fractional part of the timeout
@@ -990,7 +994,26 @@ public:
     /// @brief Deletes external socket
     void deleteExternalSocket(int socketfd);
 
+    /// @brief Adds external socket and a callback invoked when the socket
+    /// is writable.
+    ///
+    /// This is used by the owners of the non-blocking external sockets to
+    /// complete sending the data which the socket couldn't accept at once.
+    /// The callback is called by @c receive4 and @c receive6 until the
+    /// socket is deleted with @c deleteExternalWriteSocket.
+    ///
+    /// @param socketfd socket descriptor
+    /// @param callback callback function
+    void addExternalWriteSocket(int socketfd, SocketCallback callback);
+
+    /// @brief Deletes external socket waiting to become writable.
+    ///
+    /// @param socketfd socket descriptor
+    void deleteExternalWriteSocket(int socketfd);
+
     /// @brief Deletes all external sockets.
+    ///
+    /// This includes the sockets waiting to become writable.
     void deleteAllExternalSockets();
 
     /// @brief Set packet filter object to handle sending and receiving DHCPv4
@@ -1048,7 +1071,12 @@ public:
     /// @param direct_response_desired specifies whether the Packet Filter
     /// object being set should support direct traffic to the host
     /// not having address assigned.
-    void setMatchingPacketFilter(const bool direct_response_desired = false);
+    /// @param use_ring specifies whether the Packet Filter object should
+    /// use the memory mapped rings shared with the kernel to receive
+    /// and send packets. Currently, it is only supported on Linux and
+    /// it is ignored if the direct traffic is not desired.
+    void setMatchingPacketFilter(const bool direct_response_desired = false,
+                                 const bool use_ring = false);
 
     /// @brief Adds an interface to list of known interfaces.
     ///
@@ -1196,6 +1224,14 @@ private:
                              const uint16_t port,
                              IfaceMgrErrorMsgCallback error_handler = NULL);
 
+    /// @brief Releases the packet filter resources of the IPv4 sockets.
+    ///
+    /// This function calls @c PktFilter::releaseSocket for each IPv4 socket
+    /// open on the interface. It is called before the sockets are closed.
+    ///
+    /// @param iface Interface which sockets are going to be closed.
+    void releaseSockets4(const Iface& iface);
+
     /// Holds instance of a class derived from PktFilter, used by the
     /// IfaceMgr to open sockets and send/receive packets through these
     /// sockets. It is possible to supply custom object using
@@ -1215,6 +1251,10 @@ private:
     /// @brief Contains list of callbacks for external sockets
     SocketCallbackInfoContainer callbacks_;
 
+    /// @brief Contains list of callbacks for external sockets waiting
+    /// to become writable
+    SocketCallbackInfoContainer write_callbacks_;
+
     /// @brief Indicates if the IfaceMgr is in the test mode.
     bool test_mode_;
 };
@@ -1,4 +1,4 @@
-// Copyright (C) 2011-2015 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2011-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -122,7 +122,8 @@ void Iface::setFlags(uint64_t flags) {
 }
 
 void
-IfaceMgr::setMatchingPacketFilter(const bool direct_response_desired) {
+IfaceMgr::setMatchingPacketFilter(const bool direct_response_desired,
+                                  const bool /* use_ring */) {
     // If direct response is desired we have to use BPF. If the direct
     // response is not desired we use datagram socket supported by the
     // PktFilterInet class. Note however that on BSD systems binding the
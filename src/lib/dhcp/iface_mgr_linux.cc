@@ -1,4 +1,4 @@
-// Copyright (C) 2011-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2011-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -511,9 +511,10 @@ void Iface::setFlags(uint64_t flags) {
 }
 
 void
-IfaceMgr::setMatchingPacketFilter(const bool direct_response_desired) {
+IfaceMgr::setMatchingPacketFilter(const bool direct_response_desired,
+                                  const bool use_ring) {
     if (direct_response_desired) {
-        setPacketFilter(PktFilterPtr(new PktFilterLPF()));
+        setPacketFilter(PktFilterPtr(new PktFilterLPF(use_ring)));
 
     } else {
         setPacketFilter(PktFilterPtr(new PktFilterInet()));
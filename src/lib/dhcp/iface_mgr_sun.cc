@@ -1,4 +1,4 @@
-// Copyright (C) 2011-2015 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2011-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -124,7 +124,8 @@ void Iface::setFlags(uint64_t flags) {
 }
 
 void
-IfaceMgr::setMatchingPacketFilter(const bool /* direct_response_desired */) {
+IfaceMgr::setMatchingPacketFilter(const bool /* direct_response_desired */,
+                                  const bool /* use_ring */) {
     // @todo Currently we ignore the preference to use direct traffic
     // because it hasn't been implemented for Solaris.
     setPacketFilter(PktFilterPtr(new PktFilterInet()));
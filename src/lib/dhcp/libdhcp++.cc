@@ -1,4 +1,4 @@
-// Copyright (C) 2011-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2011-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -729,9 +729,43 @@ size_t LibDHCP::unpackVendorOptions4(const uint32_t vendor_id, const OptionBuffe
     return (offset);
 }
 
+namespace {
+
+/// @brief Stores the option in a buffer.
+///
+/// Copies the wire data of the option if it has been packed in advance.
+/// Otherwise, packs the option.
+///
+/// @param buf output buffer
+/// @param option option to be stored
+/// @param packed wire data of the options packed in advance
+void
+packOption(isc::util::OutputBuffer& buf, const OptionPtr& option,
+           const PackedOptionMap& packed) {
+    if (!packed.empty()) {
+        PackedOptionMap::const_iterator wire = packed.find(option);
+        if (wire != packed.end()) {
+            if (!wire->second->empty()) {
+                buf.writeData(&(*wire->second)[0], wire->second->size());
+            }
+            return;
+        }
+    }
+    option->pack(buf);
+}
+
+}
+
 void
 LibDHCP::packOptions4(isc::util::OutputBuffer& buf,
                      const OptionCollection& options) {
+    packOptions4(buf, options, PackedOptionMap());
+}
+
+void
+LibDHCP::packOptions4(isc::util::OutputBuffer& buf,
+                      const OptionCollection& options,
+                      const PackedOptionMap& packed) {
     OptionPtr agent;
     OptionPtr end;
     for (OptionCollection::const_iterator it = options.begin();
@@ -746,28 +780,35 @@ LibDHCP::packOptions4(isc::util::OutputBuffer& buf,
                 end = it->second;
                 break;
             default:
-                it->second->pack(buf);
+                packOption(buf, it->second, packed);
                 break;
         }
     }
 
     // Add the RAI option if it exists.
     if (agent) {
-       agent->pack(buf);
+       packOption(buf, agent, packed);
     }
 
     // And at the end the END option.
     if (end)  {
-       end->pack(buf);
+       packOption(buf, end, packed);
     }
 }
 
 void
 LibDHCP::packOptions6(isc::util::OutputBuffer& buf,
                       const OptionCollection& options) {
+    packOptions6(buf, options, PackedOptionMap());
+}
+
+void
+LibDHCP::packOptions6(isc::util::OutputBuffer& buf,
+                      const OptionCollection& options,
+                      const PackedOptionMap& packed) {
     for (OptionCollection::const_iterator it = options.begin();
          it != options.end(); ++it) {
-        it->second->pack(buf);
+        packOption(buf, it->second, packed);
     }
 }
 
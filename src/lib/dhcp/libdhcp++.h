@@ -1,4 +1,4 @@
-// Copyright (C) 2011-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2011-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -147,6 +147,20 @@ public:
     static void packOptions4(isc::util::OutputBuffer& buf,
                              const isc::dhcp::OptionCollection& options);
 
+    /// @brief Stores DHCPv4 options in a buffer using the wire data packed
+    /// in advance.
+    ///
+    /// This variant copies the wire data found in the @c packed map for
+    /// the options instead of packing them. The remaining options are
+    /// packed as usual.
+    ///
+    /// @param buf output buffer (assembled options will be stored here)
+    /// @param options collection of options to store to
+    /// @param packed wire data of the options packed in advance
+    static void packOptions4(isc::util::OutputBuffer& buf,
+                             const isc::dhcp::OptionCollection& options,
+                             const isc::dhcp::PackedOptionMap& packed);
+
     /// @brief Stores DHCPv6 options in a buffer.
     ///
     /// Stores all options defined in options containers in a on-wire
@@ -164,6 +178,20 @@ public:
     static void packOptions6(isc::util::OutputBuffer& buf,
                              const isc::dhcp::OptionCollection& options);
 
+    /// @brief Stores DHCPv6 options in a buffer using the wire data packed
+    /// in advance.
+    ///
+    /// This variant copies the wire data found in the @c packed map for
+    /// the options instead of packing them. The remaining options are
+    /// packed as usual.
+    ///
+    /// @param buf output buffer (assembled options will be stored here)
+    /// @param options collection of options to store to
+    /// @param packed wire data of the options packed in advance
+    static void packOptions6(isc::util::OutputBuffer& buf,
+                             const isc::dhcp::OptionCollection& options,
+                             const isc::dhcp::PackedOptionMap& packed);
+
     /// @brief Parses provided buffer as DHCPv6 options and creates
     /// Option objects.
     ///
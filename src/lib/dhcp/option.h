@@ -1,4 +1,4 @@
-// Copyright (C) 2011-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2011-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -42,6 +42,16 @@ typedef std::multimap<unsigned int, OptionPtr> OptionCollection;
 /// A pointer to an OptionCollection
 typedef boost::shared_ptr<OptionCollection> OptionCollectionPtr;
 
+/// pointer to a constant DHCP buffer
+typedef boost::shared_ptr<const OptionBuffer> ConstOptionBufferPtr;
+
+/// @brief A collection of options along with their wire data packed
+/// in advance.
+///
+/// The option pointer is used as a key, so as the wire data can be
+/// found for the option held in the @c OptionCollection.
+typedef std::map<OptionPtr, ConstOptionBufferPtr> PackedOptionMap;
+
 class Option {
 public:
     /// length of the usual DHCPv4 option header (there are exceptions)
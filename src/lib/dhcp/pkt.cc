@@ -1,4 +1,4 @@
-// Copyright (C) 2014-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2014-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -57,6 +57,13 @@ Pkt::addOption(const OptionPtr& opt) {
     options_.insert(std::pair<int, OptionPtr>(opt->getType(), opt));
 }
 
+void
+Pkt::addPackedOption(const OptionPtr& opt,
+                     const ConstOptionBufferPtr& wire_data) {
+    addOption(opt);
+    packed_options_[opt] = wire_data;
+}
+
 OptionPtr
 Pkt::getNonCopiedOption(const uint16_t type) const {
     OptionCollection::const_iterator x = options_.find(type);
@@ -84,6 +91,9 @@ Pkt::delOption(uint16_t type) {
 
     isc::dhcp::OptionCollection::iterator x = options_.find(type);
     if (x!=options_.end()) {
+        if (!packed_options_.empty()) {
+            packed_options_.erase(x->second);
+        }
         options_.erase(x);
         return (true); // delete successful
     } else {
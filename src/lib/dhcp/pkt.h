@@ -1,4 +1,4 @@
-// Copyright (C) 2014-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2014-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -181,6 +181,21 @@ public:
     /// @param opt option to be added.
     virtual void addOption(const OptionPtr& opt);
 
+    /// @brief Adds an option to this packet along with its wire data.
+    ///
+    /// The option is added using @c addOption, but the specified wire
+    /// data is copied to the output buffer when the packet is packed,
+    /// instead of packing the option. This avoids packing the same
+    /// configured options for each response sent by the server.
+    ///
+    /// @note The wire data must be the result of packing the option and
+    /// the option must not be modified after it has been added.
+    ///
+    /// @param opt option to be added.
+    /// @param wire_data wire data of the option, including option header.
+    void addPackedOption(const OptionPtr& opt,
+                         const ConstOptionBufferPtr& wire_data);
+
     /// @brief Attempts to delete first suboption of requested type.
     ///
     /// If there are several options of the same type present, only
@@ -733,6 +748,9 @@ protected:
     /// @see the documentation for @ref Pkt::setCopyRetrievedOptions.
     bool copy_retrieved_options_;
 
+    /// @brief Wire data of the options added with @ref addPackedOption.
+    PackedOptionMap packed_options_;
+
     /// packet timestamp
     boost::posix_time::ptime timestamp_;
 
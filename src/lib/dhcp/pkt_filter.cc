@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -14,6 +14,10 @@
 namespace isc {
 namespace dhcp {
 
+void
+PktFilter::releaseSocket(const SocketInfo&) {
+}
+
 int
 PktFilter::openFallbackSocket(const isc::asiolink::IOAddress& addr,
                               const uint16_t port) {
@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2015 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -103,6 +103,16 @@ public:
     virtual int send(const Iface& iface, uint16_t sockfd,
                      const Pkt4Ptr& pkt) = 0;
 
+    /// @brief Releases the resources associated with the socket.
+    ///
+    /// This method is called by the @c IfaceMgr before it closes the
+    /// primary and fallback sockets opened with @c openSocket. The
+    /// derived classes holding per socket resources should release them
+    /// here. The default implementation does nothing.
+    ///
+    /// @param socket_info Structure holding the socket information.
+    virtual void releaseSocket(const SocketInfo& socket_info);
+
 protected:
 
     /// @brief Default implementation to open a fallback socket.
@@ -1,4 +1,4 @@
-// Copyright (C) 2014-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2014-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -14,6 +14,7 @@
 #include <algorithm>
 #include <net/bpf.h>
 #include <netinet/if_ether.h>
+#include <sys/uio.h>
 
 namespace {
 
@@ -577,10 +578,15 @@ PktFilterBPF::send(const Iface& iface, uint16_t sockfd, const Pkt4Ptr& pkt) {
     // IP and UDP header
     writeIpUdpHeader(pkt, buf);
 
-    // DHCPv4 message
-    buf.writeData(pkt->getBuffer().getData(), pkt->getBuffer().getLength());
+    // The DHCPv4 message is written directly from the packet's output
+    // buffer, rather than copied to the buffer holding the headers.
+    iovec iov[2];
+    iov[0].iov_base = const_cast<void*>(buf.getData());
+    iov[0].iov_len = buf.getLength();
+    iov[1].iov_base = const_cast<void*>(pkt->getBuffer().getData());
+    iov[1].iov_len = pkt->getBuffer().getLength();
 
-    int result = write(sockfd, buf.getData(), buf.getLength());
+    int result = writev(sockfd, iov, 2);
     if (result < 0) {
         isc_throw(SocketWriteError, "failed to send DHCPv4 packet: "
                   << strerror(errno));
@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2015 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -11,11 +11,16 @@
 #include <dhcp/pkt_filter_lpf.h>
 #include <dhcp/protocol_util.h>
 #include <exceptions/exceptions.h>
+#include <boost/noncopyable.hpp>
+#include <cerrno>
 #include <fcntl.h>
 #include <linux/filter.h>
 #include <linux/if_ether.h>
 #include <linux/if_packet.h>
 #include <net/ethernet.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
 
 namespace {
 
@@ -121,6 +126,103 @@ struct sock_filter dhcp_sock_filter [] = {
     BPF_STMT(BPF_RET + BPF_K, 0),
 };
 
+/// Size of the block of the receive ring. It must be a multiple of the
+/// page size.
+const unsigned int RX_RING_BLOCK_SIZE = 1 << 16;
+
+/// Number of blocks in the receive ring.
+const unsigned int RX_RING_BLOCK_NUM = 64;
+
+/// Nominal size of the frame of the receive ring. The frames of the
+/// TPACKET_V3 receive ring have variable length, but the kernel requires
+/// that the frame size is specified.
+const unsigned int RX_RING_FRAME_SIZE = 2048;
+
+/// Time (in milliseconds) after which the kernel passes the block of the
+/// receive ring to the user space even if the block is not full. It is
+/// the maximum latency added by the ring to the reception of a packet.
+const unsigned int RX_RING_BLOCK_TIMEOUT = 2;
+
+/// Size of the frame of the transmit ring. It must be large enough to
+/// hold the frame header and the Ethernet frame carrying DHCP message.
+const unsigned int TX_RING_FRAME_SIZE = 2048;
+
+/// Size of the block of the transmit ring.
+const unsigned int TX_RING_BLOCK_SIZE = 1 << 16;
+
+/// Number of blocks in the transmit ring.
+const unsigned int TX_RING_BLOCK_NUM = 8;
+
+/// Maximum number of packets held in the transmit ring before they are
+/// sent.
+const size_t TX_RING_MAX_PENDING = 64;
+
+/// @brief Creates the DHCPv4 packet from the received Ethernet frame.
+///
+/// @param iface Interface on which the frame has been received.
+/// @param data Pointer to the frame.
+/// @param length Length of the frame.
+///
+/// @return Pointer to the packet.
+Pkt4Ptr
+decodePacket(Iface& iface, const uint8_t* data, const size_t length) {
+    isc::util::InputBuffer buf(data, length);
+
+    // @todo: This is awkward way to solve the chicken and egg problem
+    // whereby we don't know the offset where DHCP data start in the
+    // received buffer when we create the packet object. In general case,
+    // the IP header has variable length. The information about its length
+    // is stored in one of its fields. Therefore, we have to decode the
+    // packet to get the offset of the DHCP data. The dummy object is
+    // created so as we can pass it to the functions which decode IP stack
+    // and find actual offset of the DHCP data.
+    // Once we find the offset we can create another Pkt4 object from
+    // the reminder of the input buffer and set the IP addresses and
+    // ports from the dummy packet. We should consider doing it
+    // in some more elegant way.
+    Pkt4Ptr dummy_pkt = Pkt4Ptr(new Pkt4(DHCPDISCOVER, 0));
+
+    // Decode ethernet, ip and udp headers.
+    decodeEthernetHeader(buf, dummy_pkt);
+    decodeIpUdpHeader(buf, dummy_pkt);
+
+    // Decode DHCP data into the Pkt4 object. The data is copied, so the
+    // frame may be released as soon as this function returns.
+    Pkt4Ptr pkt = Pkt4Ptr(new Pkt4(data + buf.getPosition(),
+                                   buf.getLength() - buf.getPosition()));
+
+    // Set the appropriate packet members using data collected from
+    // the decoded headers.
+    pkt->setIndex(iface.getIndex());
+    pkt->setIface(iface.getName());
+    pkt->setLocalAddr(dummy_pkt->getLocalAddr());
+    pkt->setRemoteAddr(dummy_pkt->getRemoteAddr());
+    pkt->setLocalPort(dummy_pkt->getLocalPort());
+    pkt->setRemotePort(dummy_pkt->getRemotePort());
+    pkt->setLocalHWAddr(dummy_pkt->getLocalHWAddr());
+    pkt->setRemoteHWAddr(dummy_pkt->getRemoteHWAddr());
+
+    return (pkt);
+}
+
+/// @brief Drains the fallback socket.
+///
+/// The data received over the fallback socket is discarded but we don't
+/// want the socket buffer to bloat. We get the packets from the socket in
+/// loop but most of the time the loop will end after receiving one packet.
+/// The call to recv returns immediately when there is no data left on the
+/// socket because the socket is non-blocking.
+///
+/// @param fallbackfd Descriptor of the fallback socket.
+void
+drainFallbackSocket(const int fallbackfd) {
+    uint8_t raw_buf[IfaceMgr::RCVBUFSIZE];
+    int datalen;
+    do {
+        datalen = recv(fallbackfd, raw_buf, sizeof(raw_buf), 0);
+    } while (datalen > 0);
+}
+
 }
 
 using namespace isc::util;
@@ -128,6 +230,317 @@ using namespace isc::util;
 namespace isc {
 namespace dhcp {
 
+/// @brief Memory mapped TPACKET_V3 receive and transmit rings of the
+/// raw socket.
+///
+/// The receive ring consists of blocks holding variable number of frames.
+/// A block is owned by the user space when its status is
+/// @c TP_STATUS_USER. The frames are processed in order and the block is
+/// returned to the kernel when all its frames have been processed.
+///
+/// The transmit ring consists of fixed size frames. The frame owned by the
+/// user space (@c TP_STATUS_AVAILABLE) is filled with the packet and marked
+/// with @c TP_STATUS_SEND_REQUEST. The kernel sends all marked frames when
+/// @c flush is called.
+class PacketRing : public boost::noncopyable {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// Configures the socket to use TPACKET_V3 rings and maps them.
+    ///
+    /// @param sock Descriptor of the raw socket.
+    /// @param ifindex Index of the interface to which the socket is bound.
+    ///
+    /// @throw SocketConfigError if the receive ring can't be configured.
+    PacketRing(const int sock, const int ifindex)
+        : sock_(sock), map_(static_cast<uint8_t*>(MAP_FAILED)), map_size_(0),
+          rx_size_(0), rx_block_(0), rx_frame_(NULL), rx_frames_left_(0),
+          tx_frame_(0), tx_pending_(0) {
+        memset(&rx_req_, 0, sizeof(rx_req_));
+        memset(&tx_req_, 0, sizeof(tx_req_));
+
+        int version = TPACKET_V3;
+        if (setsockopt(sock_, SOL_PACKET, PACKET_VERSION, &version,
+                       sizeof(version)) < 0) {
+            isc_throw(SocketConfigError, "failed to set TPACKET_V3 version"
+                      " on the socket " << sock_);
+        }
+
+        rx_req_.tp_block_size = RX_RING_BLOCK_SIZE;
+        rx_req_.tp_block_nr = RX_RING_BLOCK_NUM;
+        rx_req_.tp_frame_size = RX_RING_FRAME_SIZE;
+        rx_req_.tp_frame_nr = (RX_RING_BLOCK_SIZE / RX_RING_FRAME_SIZE) *
+            RX_RING_BLOCK_NUM;
+        rx_req_.tp_retire_blk_tov = RX_RING_BLOCK_TIMEOUT;
+        if (setsockopt(sock_, SOL_PACKET, PACKET_RX_RING, &rx_req_,
+                       sizeof(rx_req_)) < 0) {
+            isc_throw(SocketConfigError, "failed to configure the receive"
+                      " ring on the socket " << sock_);
+        }
+        rx_size_ = rx_req_.tp_block_size * rx_req_.tp_block_nr;
+
+        // The transmit ring is supported for TPACKET_V3 since Linux 4.11.
+        // If it is not supported, the packets are sent with sendto.
+        tx_req_.tp_block_size = TX_RING_BLOCK_SIZE;
+        tx_req_.tp_block_nr = TX_RING_BLOCK_NUM;
+        tx_req_.tp_frame_size = TX_RING_FRAME_SIZE;
+        tx_req_.tp_frame_nr = (TX_RING_BLOCK_SIZE / TX_RING_FRAME_SIZE) *
+            TX_RING_BLOCK_NUM;
+        if (setsockopt(sock_, SOL_PACKET, PACKET_TX_RING, &tx_req_,
+                       sizeof(tx_req_)) < 0) {
+            memset(&tx_req_, 0, sizeof(tx_req_));
+        }
+
+        map_size_ = rx_size_ + tx_req_.tp_block_size * tx_req_.tp_block_nr;
+        void* map = mmap(NULL, map_size_, PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_LOCKED, sock_, 0);
+        if (map == MAP_FAILED) {
+            // Locking the memory requires privileges which we may lack.
+            map = mmap(NULL, map_size_, PROT_READ | PROT_WRITE, MAP_SHARED,
+                       sock_, 0);
+        }
+        if (map == MAP_FAILED) {
+            isc_throw(SocketConfigError, "failed to map the rings of the"
+                      " socket " << sock_);
+        }
+        map_ = static_cast<uint8_t*>(map);
+
+        memset(&tx_addr_, 0, sizeof(tx_addr_));
+        tx_addr_.sll_family = AF_PACKET;
+        tx_addr_.sll_ifindex = ifindex;
+        tx_addr_.sll_protocol = htons(ETH_P_IP);
+        tx_addr_.sll_halen = 6;
+    }
+
+    /// @brief Destructor.
+    ///
+    /// Unmaps the rings.
+    ~PacketRing() {
+        if (map_ != MAP_FAILED) {
+            munmap(map_, map_size_);
+        }
+    }
+
+    /// @brief Returns descriptor of the socket.
+    int getSocket() const {
+        return (sock_);
+    }
+
+    /// @brief Checks if there is a received frame ready for processing.
+    ///
+    /// If the previous block has been processed, this function checks if
+    /// the next block has been passed to the user space.
+    ///
+    /// @return true if the frame is available.
+    bool frameAvailable() {
+        while (rx_frame_ == NULL) {
+            tpacket_block_desc* desc = getBlock(rx_block_);
+            if ((desc->hdr.bh1.block_status & TP_STATUS_USER) == 0) {
+                return (false);
+            }
+            // Make sure that the block contents are read after its status.
+            __sync_synchronize();
+            rx_frames_left_ = desc->hdr.bh1.num_pkts;
+            if (rx_frames_left_ == 0) {
+                releaseBlock();
+                continue;
+            }
+            rx_frame_ = reinterpret_cast<tpacket3_hdr*>
+                (reinterpret_cast<uint8_t*>(desc) +
+                 desc->hdr.bh1.offset_to_first_pkt);
+        }
+        return (true);
+    }
+
+    /// @brief Returns pointer to the Ethernet frame of the current packet.
+    ///
+    /// It must only be called when @c frameAvailable returned true.
+    const uint8_t* getFrameData() const {
+        return (reinterpret_cast<const uint8_t*>(rx_frame_) +
+                rx_frame_->tp_mac);
+    }
+
+    /// @brief Returns length of the Ethernet frame of the current packet.
+    ///
+    /// It must only be called when @c frameAvailable returned true.
+    size_t getFrameLength() const {
+        return (rx_frame_->tp_snaplen);
+    }
+
+    /// @brief Moves to the next received frame.
+    ///
+    /// The block is returned to the kernel when all its frames have been
+    /// processed.
+    void nextFrame() {
+        if (--rx_frames_left_ > 0) {
+            rx_frame_ = reinterpret_cast<tpacket3_hdr*>
+                (reinterpret_cast<uint8_t*>(rx_frame_) +
+                 rx_frame_->tp_next_offset);
+        } else {
+            rx_frame_ = NULL;
+            releaseBlock();
+        }
+    }
+
+    /// @brief Checks if there are received frames which haven't been
+    /// processed yet.
+    bool hasPendingFrames() const {
+        return ((rx_frame_ != NULL) ||
+                ((getBlock(rx_block_)->hdr.bh1.block_status &
+                  TP_STATUS_USER) != 0));
+    }
+
+    /// @brief Checks if the transmit ring is used.
+    bool hasTxRing() const {
+        return (tx_req_.tp_frame_nr > 0);
+    }
+
+    /// @brief Copies the packet to the next frame of the transmit ring.
+    ///
+    /// The frame headers and the DHCP message are copied directly to
+    /// the ring frame.
+    ///
+    /// @param headers Pointer to the Ethernet, IP and UDP headers.
+    /// @param headers_len Length of the headers.
+    /// @param payload Pointer to the DHCP message.
+    /// @param payload_len Length of the DHCP message.
+    ///
+    /// @return true if the packet has been copied, false if there is no
+    /// free frame in the ring or the packet doesn't fit in the frame.
+    bool write(const uint8_t* headers, const size_t headers_len,
+               const uint8_t* payload, const size_t payload_len) {
+        const size_t offset = TPACKET3_HDRLEN - sizeof(sockaddr_ll);
+        const size_t length = headers_len + payload_len;
+        if (!hasTxRing() || (length > TX_RING_FRAME_SIZE - offset)) {
+            return (false);
+        }
+
+        tpacket3_hdr* hdr = getTxFrame(tx_frame_);
+        if ((hdr->tp_status != TP_STATUS_AVAILABLE) &&
+            (hdr->tp_status != TP_STATUS_WRONG_FORMAT)) {
+            // The kernel is still sending the frame.
+            flush();
+            if ((hdr->tp_status != TP_STATUS_AVAILABLE) &&
+                (hdr->tp_status != TP_STATUS_WRONG_FORMAT)) {
+                return (false);
+            }
+        }
+
+        uint8_t* frame = reinterpret_cast<uint8_t*>(hdr) + offset;
+        memcpy(frame, headers, headers_len);
+        if (payload_len > 0) {
+            memcpy(frame + headers_len, payload, payload_len);
+        }
+        hdr->tp_len = length;
+        hdr->tp_snaplen = length;
+        hdr->tp_next_offset = 0;
+        // Make sure that the frame is written before its status.
+        __sync_synchronize();
+        hdr->tp_status = TP_STATUS_SEND_REQUEST;
+
+        tx_frame_ = (tx_frame_ + 1) % tx_req_.tp_frame_nr;
+        ++tx_pending_;
+        return (true);
+    }
+
+    /// @brief Returns number of packets waiting in the transmit ring.
+    size_t getPendingTx() const {
+        return (tx_pending_);
+    }
+
+    /// @brief Sends all packets waiting in the transmit ring.
+    ///
+    /// @throw SocketWriteError if the packets can't be sent.
+    void flush() {
+        if (tx_pending_ == 0) {
+            return;
+        }
+        tx_pending_ = 0;
+        if ((sendto(sock_, NULL, 0, MSG_DONTWAIT,
+                    reinterpret_cast<const struct sockaddr*>(&tx_addr_),
+                    sizeof(tx_addr_)) < 0) &&
+            (errno != EAGAIN) && (errno != ENOBUFS)) {
+            isc_throw(SocketWriteError, "failed to send DHCPv4 packets"
+                      " from the transmit ring, errno=" << errno
+                      << " (check errno.h)");
+        }
+    }
+
+private:
+
+    /// @brief Returns the block of the receive ring.
+    ///
+    /// @param index Index of the block.
+    tpacket_block_desc* getBlock(const size_t index) const {
+        return (reinterpret_cast<tpacket_block_desc*>
+                (map_ + index * rx_req_.tp_block_size));
+    }
+
+    /// @brief Returns the frame of the transmit ring.
+    ///
+    /// @param index Index of the frame.
+    tpacket3_hdr* getTxFrame(const size_t index) const {
+        return (reinterpret_cast<tpacket3_hdr*>
+                (map_ + rx_size_ + index * tx_req_.tp_frame_size));
+    }
+
+    /// @brief Returns the current block to the kernel and moves to the
+    /// next one.
+    void releaseBlock() {
+        // Make sure that the block contents have been read before it is
+        // returned to the kernel.
+        __sync_synchronize();
+        getBlock(rx_block_)->hdr.bh1.block_status = TP_STATUS_KERNEL;
+        rx_block_ = (rx_block_ + 1) % rx_req_.tp_block_nr;
+    }
+
+    /// @brief Descriptor of the socket.
+    int sock_;
+
+    /// @brief Pointer to the mapped rings.
+    uint8_t* map_;
+
+    /// @brief Size of the mapped rings.
+    size_t map_size_;
+
+    /// @brief Configuration of the receive ring.
+    tpacket_req3 rx_req_;
+
+    /// @brief Configuration of the transmit ring.
+    tpacket_req3 tx_req_;
+
+    /// @brief Size of the receive ring.
+    size_t rx_size_;
+
+    /// @brief Index of the current block of the receive ring.
+    size_t rx_block_;
+
+    /// @brief Current frame of the receive ring or null if the current
+    /// block is not owned by the user space.
+    tpacket3_hdr* rx_frame_;
+
+    /// @brief Number of frames in the current block which haven't been
+    /// processed, including the current one.
+    uint32_t rx_frames_left_;
+
+    /// @brief Index of the next frame of the transmit ring.
+    size_t tx_frame_;
+
+    /// @brief Number of frames waiting to be sent.
+    size_t tx_pending_;
+
+    /// @brief Address used to send packets from the transmit ring.
+    sockaddr_ll tx_addr_;
+};
+
+PktFilterLPF::PktFilterLPF(const bool use_ring)
+    : use_ring_(use_ring), rings_(), send_buf_(IfaceMgr::RCVBUFSIZE) {
+}
+
+PktFilterLPF::~PktFilterLPF() {
+}
+
 SocketInfo
 PktFilterLPF::openSocket(Iface& iface,
                          const isc::asiolink::IOAddress& addr,
@@ -197,19 +610,34 @@ PktFilterLPF::openSocket(Iface& iface,
                   << "' to interface '" << iface.getName() << "'");
     }
 
+    if (use_ring_) {
+        try {
+            rings_[sock] = PacketRingPtr(new PacketRing(sock,
+                                                        iface.getIndex()));
+        } catch (...) {
+            rings_.erase(sock);
+            close(sock);
+            close(fallback);
+            throw;
+        }
+    }
+
     return (SocketInfo(addr, port, sock, fallback));
 
 }
 
 Pkt4Ptr
 PktFilterLPF::receive(Iface& iface, const SocketInfo& socket_info) {
+    if (use_ring_) {
+        std::map<int, PacketRingPtr>::const_iterator ring =
+            rings_.find(socket_info.sockfd_);
+        if (ring != rings_.end()) {
+            return (receiveFromRing(iface, socket_info, *ring->second));
+        }
+    }
+
     uint8_t raw_buf[IfaceMgr::RCVBUFSIZE];
-    // First let's get some data from the fallback socket. The data will be
-    // discarded but we don't want the socket buffer to bloat. We get the
-    // packets from the socket in loop but most of the time the loop will
-    // end after receiving one packet. The call to recv returns immediately
-    // when there is no data left on the socket because the socket is
-    // non-blocking.
+    // First let's get some data from the fallback socket.
     // @todo In the normal conditions, both the primary socket and the fallback
     // socket are in sync as they are set to receive packets on the same
     // address and port. The reception of packets on the fallback socket
@@ -218,10 +646,7 @@ PktFilterLPF::receive(Iface& iface, const SocketInfo& socket_info) {
     // bytes received on the fallback socket in a single round. Further
     // optimizations would include an asynchronous read from the fallback socket
     // when the DHCP server is idle.
-    int datalen;
-    do {
-        datalen = recv(socket_info.fallbackfd_, raw_buf, sizeof(raw_buf), 0);
-    } while (datalen > 0);
+    drainFallbackSocket(socket_info.fallbackfd_);
 
     // Now that we finished getting data from the fallback socket, we
     // have to get the data from the raw socket too.
@@ -235,51 +660,61 @@ PktFilterLPF::receive(Iface& iface, const SocketInfo& socket_info) {
         return Pkt4Ptr();
     }
 
-    InputBuffer buf(raw_buf, data_len);
-
-    // @todo: This is awkward way to solve the chicken and egg problem
-    // whereby we don't know the offset where DHCP data start in the
-    // received buffer when we create the packet object. In general case,
-    // the IP header has variable length. The information about its length
-    // is stored in one of its fields. Therefore, we have to decode the
-    // packet to get the offset of the DHCP data. The dummy object is
-    // created so as we can pass it to the functions which decode IP stack
-    // and find actual offset of the DHCP data.
-    // Once we find the offset we can create another Pkt4 object from
-    // the reminder of the input buffer and set the IP addresses and
-    // ports from the dummy packet. We should consider doing it
-    // in some more elegant way.
-    Pkt4Ptr dummy_pkt = Pkt4Ptr(new Pkt4(DHCPDISCOVER, 0));
+    return (decodePacket(iface, raw_buf, data_len));
+}
 
-    // Decode ethernet, ip and udp headers.
-    decodeEthernetHeader(buf, dummy_pkt);
-    decodeIpUdpHeader(buf, dummy_pkt);
+Pkt4Ptr
+PktFilterLPF::receiveFromRing(Iface& iface, const SocketInfo& socket_info,
+                              PacketRing& ring) {
+    // The responses to the previously received packets may still wait
+    // in the transmit rings.
+    flushRings();
+
+    // The fallback socket is drained once per block rather than for
+    // each packet.
+    if (!ring.hasPendingFrames()) {
+        drainFallbackSocket(socket_info.fallbackfd_);
+    }
 
-    // Read the DHCP data.
-    std::vector<uint8_t> dhcp_buf;
-    buf.readVector(dhcp_buf, buf.getLength() - buf.getPosition());
+    if (!ring.frameAvailable()) {
+        return (Pkt4Ptr());
+    }
 
-    // Decode DHCP data into the Pkt4 object.
-    Pkt4Ptr pkt = Pkt4Ptr(new Pkt4(&dhcp_buf[0], dhcp_buf.size()));
+    Pkt4Ptr pkt;
+    try {
+        pkt = decodePacket(iface, ring.getFrameData(), ring.getFrameLength());
+    } catch (...) {
+        // The malformed frame must not stay in the ring.
+        ring.nextFrame();
+        throw;
+    }
+    ring.nextFrame();
+    return (pkt);
+}
 
-    // Set the appropriate packet members using data collected from
-    // the decoded headers.
-    pkt->setIndex(iface.getIndex());
-    pkt->setIface(iface.getName());
-    pkt->setLocalAddr(dummy_pkt->getLocalAddr());
-    pkt->setRemoteAddr(dummy_pkt->getRemoteAddr());
-    pkt->setLocalPort(dummy_pkt->getLocalPort());
-    pkt->setRemotePort(dummy_pkt->getRemotePort());
-    pkt->setLocalHWAddr(dummy_pkt->getLocalHWAddr());
-    pkt->setRemoteHWAddr(dummy_pkt->getRemoteHWAddr());
+void
+PktFilterLPF::releaseSocket(const SocketInfo& socket_info) {
+    std::map<int, PacketRingPtr>::iterator ring =
+        rings_.find(socket_info.sockfd_);
+    if (ring != rings_.end()) {
+        ring->second->flush();
+        rings_.erase(ring);
+    }
+}
 
-    return (pkt);
+void
+PktFilterLPF::flushRings() {
+    for (std::map<int, PacketRingPtr>::const_iterator ring = rings_.begin();
+         ring != rings_.end(); ++ring) {
+        ring->second->flush();
+    }
 }
 
 int
 PktFilterLPF::send(const Iface& iface, uint16_t sockfd, const Pkt4Ptr& pkt) {
 
-    OutputBuffer buf(14);
+    OutputBuffer& buf = send_buf_;
+    buf.clear();
 
     // Some interfaces may have no HW address - e.g. loopback interface.
     // For these interfaces the HW address length is 0. If this is the case,
@@ -301,8 +736,27 @@ PktFilterLPF::send(const Iface& iface, uint16_t sockfd, const Pkt4Ptr& pkt) {
     // IP and UDP header
     writeIpUdpHeader(pkt, buf);
 
-    // DHCPv4 message
-    buf.writeData(pkt->getBuffer().getData(), pkt->getBuffer().getLength());
+    // The DHCPv4 message is not copied to the buffer holding the headers.
+    // It is written to the socket (or to the transmit ring) directly from
+    // the packet's output buffer.
+    const OutputBuffer& payload = pkt->getBuffer();
+
+    if (use_ring_) {
+        std::map<int, PacketRingPtr>::const_iterator ring = rings_.find(sockfd);
+        if ((ring != rings_.end()) &&
+            ring->second->write(static_cast<const uint8_t*>(buf.getData()),
+                                buf.getLength(),
+                                static_cast<const uint8_t*>(payload.getData()),
+                                payload.getLength())) {
+            // If there are more received packets to be processed, the
+            // packet will be sent together with the responses to them.
+            if (!ring->second->hasPendingFrames() ||
+                (ring->second->getPendingTx() >= TX_RING_MAX_PENDING)) {
+                ring->second->flush();
+            }
+            return (0);
+        }
+    }
 
     sockaddr_ll sa;
     sa.sll_family = AF_PACKET;
@@ -310,9 +764,20 @@ PktFilterLPF::send(const Iface& iface, uint16_t sockfd, const Pkt4Ptr& pkt) {
     sa.sll_protocol = htons(ETH_P_IP);
     sa.sll_halen = 6;
 
-    int result = sendto(sockfd, buf.getData(), buf.getLength(), 0,
-                        reinterpret_cast<const struct sockaddr*>(&sa),
-                        sizeof(sockaddr_ll));
+    iovec iov[2];
+    iov[0].iov_base = const_cast<void*>(buf.getData());
+    iov[0].iov_len = buf.getLength();
+    iov[1].iov_base = const_cast<void*>(payload.getData());
+    iov[1].iov_len = payload.getLength();
+
+    msghdr m;
+    memset(&m, 0, sizeof(m));
+    m.msg_name = &sa;
+    m.msg_namelen = sizeof(sockaddr_ll);
+    m.msg_iov = iov;
+    m.msg_iovlen = 2;
+
+    int result = sendmsg(sockfd, &m, 0);
     if (result < 0) {
         isc_throw(SocketWriteError, "failed to send DHCPv4 packet, errno="
                   << errno << " (check errno.h)");
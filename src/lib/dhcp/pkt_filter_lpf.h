@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2015 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -11,18 +11,57 @@
 
 #include <util/buffer.h>
 
+#include <boost/shared_ptr.hpp>
+
+#include <map>
+
 namespace isc {
 namespace dhcp {
 
+/// @brief Forward declaration of the memory mapped packet ring.
+class PacketRing;
+
+/// @brief Pointer to the memory mapped packet ring.
+typedef boost::shared_ptr<PacketRing> PacketRingPtr;
+
 /// @brief Packet handling class using Linux Packet Filtering
 ///
 /// This class provides methods to send and recive DHCPv4 messages using raw
 /// sockets and Linux Packet Filtering. It is used by @c isc::dhcp::IfaceMgr
 /// to send DHCPv4 messages to the hosts which don't have an IPv4 address
 /// assigned yet.
+///
+/// The class optionally uses the memory mapped TPACKET_V3 rings
+/// (PACKET_MMAP) shared with the kernel to receive and send packets. In
+/// this mode the kernel places the received frames in the blocks of the
+/// receive ring and the frames are processed directly from the shared
+/// memory. A block is returned to the kernel when all its frames have been
+/// processed, so there is no system call per received packet. The
+/// responses are written to the frames of the transmit ring. When there
+/// are more received frames waiting for processing, the transmission of
+/// the responses is deferred and they are sent in a batch with a single
+/// system call. The same filter program is attached to the socket in both
+/// modes. If the kernel doesn't support the transmit ring for TPACKET_V3
+/// (Linux kernels older than 4.11), the packets are sent with @c sendto.
 class PktFilterLPF : public PktFilter {
 public:
 
+    /// @brief Constructor.
+    ///
+    /// @param use_ring Indicates if the memory mapped rings should be used
+    /// to receive and send packets.
+    explicit PktFilterLPF(const bool use_ring = false);
+
+    /// @brief Destructor.
+    ///
+    /// Unmaps the rings of the sockets opened by this object.
+    virtual ~PktFilterLPF();
+
+    /// @brief Checks if the memory mapped rings are used.
+    bool isRingUsed() const {
+        return (use_ring_);
+    }
+
     /// @brief Check if packet can be sent to the host without address directly.
     ///
     /// This class supports direct responses to the host without address.
@@ -67,6 +106,40 @@ public:
     virtual int send(const Iface& iface, uint16_t sockfd,
                      const Pkt4Ptr& pkt);
 
+    /// @brief Unmaps the rings of the socket which is being closed.
+    ///
+    /// The packets pending in the transmit ring are sent first.
+    ///
+    /// @param socket_info Structure holding the socket information.
+    virtual void releaseSocket(const SocketInfo& socket_info);
+
+private:
+
+    /// @brief Receives packet from the memory mapped ring.
+    ///
+    /// @param iface interface
+    /// @param socket_info structure holding socket information
+    /// @param ring ring associated with the socket
+    ///
+    /// @return Received packet or null pointer if there is no packet
+    /// available in the ring.
+    Pkt4Ptr receiveFromRing(Iface& iface, const SocketInfo& socket_info,
+                            PacketRing& ring);
+
+    /// @brief Sends pending packets from the transmit rings.
+    void flushRings();
+
+    /// @brief Indicates if the memory mapped rings are used.
+    bool use_ring_;
+
+    /// @brief Rings associated with the primary sockets.
+    std::map<int, PacketRingPtr> rings_;
+
+    /// @brief Buffer holding the frame headers of the packet being sent.
+    ///
+    /// The buffer is reused by subsequent calls to @c send to avoid
+    /// allocating the memory for each packet.
+    isc::util::OutputBuffer send_buf_;
 };
 
 } // namespace isc::dhcp
@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -9,15 +9,128 @@
 #include <dhcp/dhcp6.h>
 #include <dhcp/protocol_util.h>
 #include <boost/static_assert.hpp>
+#include <algorithm>
+#include <cstring>
 // in_systm.h is required on some some BSD systems
 // complaining that n_time is undefined but used
 // in ip.h.
 #include <netinet/in_systm.h>
 #include <netinet/ip.h>
+#include <arpa/inet.h>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 using namespace isc::asiolink;
 using namespace isc::util;
 
+namespace {
+
+/// @brief Folds the sum of the 16-bit words to 16 bits.
+///
+/// @param sum sum of the 16-bit words.
+///
+/// @return ones' complement sum of the words.
+uint16_t
+foldChecksum(uint64_t sum) {
+    while (sum > 0xFFFF) {
+        sum = (sum & 0xFFFF) + (sum >> 16);
+    }
+    return (static_cast<uint16_t>(sum));
+}
+
+/// @brief Adds up the 16-bit words of the buffer in the host byte order.
+///
+/// The bulk of the buffer is summed using AVX2 or SSE2 instructions when
+/// they are enabled for the compiler, and the remaining bytes are summed
+/// 4 bytes at a time. If the buffer has an odd length, the last byte is
+/// padded with zero.
+///
+/// @param buf buffer holding the data.
+/// @param buf_size size of the buffer.
+///
+/// @return sum of the words, which has to be folded to 16 bits.
+uint64_t
+sumWords(const uint8_t* buf, uint32_t buf_size) {
+    uint64_t sum = 0;
+
+#if defined(__AVX2__) || defined(__SSE2__)
+    // Each iteration adds up to 0x1FFFE to a 32-bit lane, so the lanes
+    // are added to the sum at least every 32768 iterations.
+    const uint32_t max_blocks = 32768;
+#endif
+
+#if defined(__AVX2__)
+    const __m256i zero256 = _mm256_setzero_si256();
+    while (buf_size >= 32) {
+        const uint32_t blocks = std::min(buf_size / 32, max_blocks);
+        __m256i acc = _mm256_setzero_si256();
+        for (uint32_t i = 0; i < blocks; ++i) {
+            const __m256i data =
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(buf));
+            acc = _mm256_add_epi32(acc, _mm256_unpacklo_epi16(data, zero256));
+            acc = _mm256_add_epi32(acc, _mm256_unpackhi_epi16(data, zero256));
+            buf += 32;
+        }
+        buf_size -= blocks * 32;
+        uint32_t lanes[8];
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), acc);
+        for (unsigned i = 0; i < 8; ++i) {
+            sum += lanes[i];
+        }
+    }
+#endif
+
+#if defined(__SSE2__)
+    const __m128i zero128 = _mm_setzero_si128();
+    while (buf_size >= 16) {
+        const uint32_t blocks = std::min(buf_size / 16, max_blocks);
+        __m128i acc = _mm_setzero_si128();
+        for (uint32_t i = 0; i < blocks; ++i) {
+            const __m128i data =
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf));
+            acc = _mm_add_epi32(acc, _mm_unpacklo_epi16(data, zero128));
+            acc = _mm_add_epi32(acc, _mm_unpackhi_epi16(data, zero128));
+            buf += 16;
+        }
+        buf_size -= blocks * 16;
+        uint32_t lanes[4];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), acc);
+        for (unsigned i = 0; i < 4; ++i) {
+            sum += lanes[i];
+        }
+    }
+#endif
+
+    // Adding 32-bit words is equivalent to adding pairs of 16-bit words
+    // because the carries are folded eventually.
+    for (; buf_size >= 4; buf += 4, buf_size -= 4) {
+        uint32_t word;
+        memcpy(&word, buf, sizeof(word));
+        sum += word;
+    }
+    if (buf_size >= 2) {
+        uint16_t word;
+        memcpy(&word, buf, sizeof(word));
+        sum += word;
+        buf += 2;
+        buf_size -= 2;
+    }
+    // If one byte has left, it is the first byte of the last word.
+    if (buf_size > 0) {
+        uint16_t word = 0;
+        memcpy(&word, buf, 1);
+        sum += word;
+    }
+
+    return (sum);
+}
+
+}
+
 namespace isc {
 namespace dhcp {
 
@@ -212,24 +325,11 @@ writeIpUdpHeader(const Pkt4Ptr& pkt, util::OutputBuffer& out_buf) {
 
 uint16_t
 calcChecksum(const uint8_t* buf, const uint32_t buf_size, uint32_t sum) {
-    uint32_t i;
-    for (i = 0; i < (buf_size & ~1U); i += 2) {
-        uint16_t chunk = buf[i] << 8 | buf[i + 1];
-        sum += chunk;
-        if (sum > 0xFFFF) {
-            sum -= 0xFFFF;
-        }
-    }
-    // If one byte has left, we also need to add it to the checksum.
-    if (i < buf_size) {
-        sum += buf[i] << 8;
-        if (sum > 0xFFFF) {
-            sum -= 0xFFFF;
-        }
-    }
-
-    return (sum);
-
+    // The words are added up in the host byte order. The ones' complement
+    // sum doesn't depend on the byte order (RFC 1071), so it is sufficient
+    // to convert the folded sum to the network byte order.
+    const uint16_t words = ntohs(foldChecksum(sumWords(buf, buf_size)));
+    return (foldChecksum(static_cast<uint64_t>(words) + sum));
 }
 
 }
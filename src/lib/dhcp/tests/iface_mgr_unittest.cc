@@ -1,4 +1,4 @@
-// Copyright (C) 2011-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2011-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -125,7 +125,7 @@ public:
 
     /// Constructor
     TestPktFilter()
-        : open_socket_called_(false) {
+        : open_socket_called_(false), released_sockets_num_(0) {
     }
 
     virtual bool isDirectResponseSupported() const {
@@ -176,9 +176,17 @@ public:
         return (0);
     }
 
+    /// @brief Records that the socket has been released.
+    virtual void releaseSocket(const SocketInfo&) {
+        ++released_sockets_num_;
+    }
+
     /// Holds the information whether openSocket was called on this
     /// object after its creation.
     bool open_socket_called_;
+
+    /// Holds the number of the releaseSocket calls.
+    int released_sockets_num_;
 };
 
 class NakedIfaceMgr: public IfaceMgr {
@@ -1272,7 +1280,10 @@ TEST_F(IfaceMgrTest, setPacketFilter) {
                  PacketFilterChangeDenied);
 
     // So, let's close the open IPv4 sockets and retry. Now it should succeed.
+    // The packet filter should be told that the socket is being closed.
+    EXPECT_EQ(0, custom_packet_filter->released_sockets_num_);
     iface_mgr->closeSockets(AF_INET);
+    EXPECT_EQ(1, custom_packet_filter->released_sockets_num_);
     EXPECT_NO_THROW(iface_mgr->setPacketFilter(custom_packet_filter));
 }
 
@@ -1345,6 +1356,15 @@ TEST_F(IfaceMgrTest, setMatchingPacketFilter) {
     EXPECT_NO_THROW(iface_mgr->setMatchingPacketFilter(true));
     // This object should report that direct responses are supported.
     EXPECT_TRUE(iface_mgr->isDirectResponseSupported());
+
+    // The memory mapped rings are used on Linux and ignored on BSD.
+    // In both cases the direct responses are supported.
+    EXPECT_NO_THROW(iface_mgr->setMatchingPacketFilter(true, true));
+    EXPECT_TRUE(iface_mgr->isDirectResponseSupported());
+
+    // The rings are ignored when the direct responses are not desired.
+    EXPECT_NO_THROW(iface_mgr->setMatchingPacketFilter(false, true));
+    EXPECT_FALSE(iface_mgr->isDirectResponseSupported());
 }
 
 // This test checks that it is not possible to open two sockets: IP/UDP
@@ -2620,6 +2640,36 @@ TEST_F(IfaceMgrTest, DeleteExternalSockets4) {
     close(secondpipe[0]);
 }
 
+// Tests that the callback of the external socket waiting to become writable
+// is called by receive4() until the socket is deleted.
+TEST_F(IfaceMgrTest, ExternalWriteSocket4) {
+
+    callback_ok = false;
+
+    scoped_ptr<NakedIfaceMgr> ifacemgr(new NakedIfaceMgr());
+
+    // The write end of the empty pipe is writable.
+    int pipefd[2];
+    EXPECT_TRUE(pipe(pipefd) == 0);
+    EXPECT_NO_THROW(ifacemgr->addExternalWriteSocket(pipefd[1], my_callback));
+
+    Pkt4Ptr pkt4;
+    ASSERT_NO_THROW(pkt4 = ifacemgr->receive4(1));
+    EXPECT_FALSE(pkt4);
+    EXPECT_TRUE(callback_ok);
+
+    // The callback is not called after the socket has been deleted.
+    callback_ok = false;
+    EXPECT_NO_THROW(ifacemgr->deleteExternalWriteSocket(pipefd[1]));
+    ASSERT_NO_THROW(pkt4 = ifacemgr->receive4(0, 1000));
+    EXPECT_FALSE(pkt4);
+    EXPECT_FALSE(callback_ok);
+
+    // close both pipe ends
+    close(pipefd[1]);
+    close(pipefd[0]);
+}
+
 
 // Tests if a single external socket and its callback can be passed and
 // it is supported properly by receive6() method.
@@ -2789,6 +2839,36 @@ TEST_F(IfaceMgrTest, DeleteExternalSockets6) {
     close(secondpipe[0]);
 }
 
+// Tests that the callback of the external socket waiting to become writable
+// is called by receive6() until the socket is deleted.
+TEST_F(IfaceMgrTest, ExternalWriteSocket6) {
+
+    callback_ok = false;
+
+    scoped_ptr<NakedIfaceMgr> ifacemgr(new NakedIfaceMgr());
+
+    // The write end of the empty pipe is writable.
+    int pipefd[2];
+    EXPECT_TRUE(pipe(pipefd) == 0);
+    EXPECT_NO_THROW(ifacemgr->addExternalWriteSocket(pipefd[1], my_callback));
+
+    Pkt6Ptr pkt6;
+    ASSERT_NO_THROW(pkt6 = ifacemgr->receive6(1));
+    EXPECT_FALSE(pkt6);
+    EXPECT_TRUE(callback_ok);
+
+    // The callback is not called after the socket has been deleted.
+    callback_ok = false;
+    EXPECT_NO_THROW(ifacemgr->deleteExternalWriteSocket(pipefd[1]));
+    ASSERT_NO_THROW(pkt6 = ifacemgr->receive6(0, 1000));
+    EXPECT_FALSE(pkt6);
+    EXPECT_FALSE(callback_ok);
+
+    // close both pipe ends
+    close(pipefd[1]);
+    close(pipefd[0]);
+}
+
 
 // Test checks if the unicast sockets can be opened.
 // This test is now disabled, because there is no reliable way to test it. We
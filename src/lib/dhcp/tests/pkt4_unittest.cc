@@ -1,4 +1,4 @@
-// Copyright (C) 2011-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2011-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -593,6 +593,60 @@ TEST_F(Pkt4Test, options) {
     EXPECT_NO_THROW(pkt.reset());
 }
 
+// This test verifies that the wire data of the options added with
+// addPackedOption is used when the packet is packed.
+TEST_F(Pkt4Test, addPackedOption) {
+    Pkt4Ptr pkt(new Pkt4(DHCPOFFER, 0));
+
+    OptionPtr opt1(new Option(Option::V4, 12, OptionBuffer(3, 1)));
+    OptionPtr opt2(new Option(Option::V4, 14, OptionBuffer(3, 2)));
+
+    // The wire data intentionally differs from the option contents, to
+    // make sure that the option is not packed.
+    const uint8_t wire[] = { 12, 4, 5, 6, 7, 8 };
+    ConstOptionBufferPtr wire_data(new OptionBuffer(wire, wire + sizeof(wire)));
+    ASSERT_NO_THROW(pkt->addPackedOption(opt1, wire_data));
+    ASSERT_NO_THROW(pkt->addOption(opt2));
+
+    // The option is added to the packet as usual.
+    EXPECT_EQ(opt1, pkt->getOption(12));
+
+    // Options are unique in DHCPv4.
+    EXPECT_THROW(pkt->addPackedOption(opt1, wire_data), BadValue);
+
+    ASSERT_NO_THROW(pkt->pack());
+
+    // The packed options are followed by the option 14, the message
+    // type option and the END option.
+    const uint8_t packed[] = { 14, 3, 2, 2, 2,
+                               DHO_DHCP_MESSAGE_TYPE, 1, DHCPOFFER,
+                               DHO_END };
+    const OutputBuffer& buf = pkt->getBuffer();
+    ASSERT_EQ(static_cast<size_t>(Pkt4::DHCPV4_PKT_HDR_LEN) +
+              sizeof(DHCP_OPTIONS_COOKIE) + sizeof(wire) + sizeof(packed),
+              buf.getLength());
+
+    const uint8_t* ptr = static_cast<const uint8_t*>(buf.getData()) +
+        Pkt4::DHCPV4_PKT_HDR_LEN + sizeof(DHCP_OPTIONS_COOKIE);
+    EXPECT_EQ(0, memcmp(ptr, wire, sizeof(wire)));
+
+    EXPECT_EQ(0, memcmp(ptr + sizeof(wire), packed, sizeof(packed)));
+
+    // When the option is replaced, the new option is packed.
+    ASSERT_TRUE(pkt->delOption(12));
+    pkt->addOption(OptionPtr(new Option(Option::V4, 12, OptionBuffer(3, 1))));
+    ASSERT_NO_THROW(pkt->pack());
+    ptr = static_cast<const uint8_t*>(buf.getData()) +
+        Pkt4::DHCPV4_PKT_HDR_LEN + sizeof(DHCP_OPTIONS_COOKIE);
+    const uint8_t repacked[] = { 12, 3, 1, 1, 1, 14, 3, 2, 2, 2,
+                                 DHO_DHCP_MESSAGE_TYPE, 1, DHCPOFFER,
+                                 DHO_END };
+    ASSERT_EQ(static_cast<size_t>(Pkt4::DHCPV4_PKT_HDR_LEN) +
+              sizeof(DHCP_OPTIONS_COOKIE) + sizeof(repacked),
+              buf.getLength());
+    EXPECT_EQ(0, memcmp(ptr, repacked, sizeof(repacked)));
+}
+
 // This test verifies that it is possible to control whether a pointer
 // to an option or a pointer to a copy of an option is returned by the
 // packet object.
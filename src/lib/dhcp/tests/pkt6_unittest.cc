@@ -1,4 +1,4 @@
-// Copyright (C) 2011-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2011-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -481,6 +481,34 @@ TEST_F(Pkt6Test, addGetDelOptions) {
     EXPECT_EQ(0, options.size());
 }
 
+// This test verifies that the wire data of the options added with
+// addPackedOption is used when the packet is packed.
+TEST_F(Pkt6Test, addPackedOption) {
+    Pkt6Ptr pkt(new Pkt6(DHCPV6_REPLY, 0x020304));
+
+    OptionPtr opt1(new Option(Option::V6, 1, OptionBuffer(2, 1)));
+    OptionPtr opt2(new Option(Option::V6, 2, OptionBuffer(2, 2)));
+
+    // The wire data intentionally differs from the option contents, to
+    // make sure that the option is not packed.
+    const uint8_t wire[] = { 0, 2, 0, 3, 7, 8, 9 };
+    ConstOptionBufferPtr wire_data(new OptionBuffer(wire, wire + sizeof(wire)));
+    ASSERT_NO_THROW(pkt->addOption(opt1));
+    ASSERT_NO_THROW(pkt->addPackedOption(opt2, wire_data));
+    EXPECT_EQ(opt2, pkt->getOption(2));
+
+    ASSERT_NO_THROW(pkt->pack());
+
+    const uint8_t expected[] = {
+        DHCPV6_REPLY, 2, 3, 4,
+        0, 1, 0, 2, 1, 1,
+        0, 2, 0, 3, 7, 8, 9
+    };
+    const isc::util::OutputBuffer& buf = pkt->getBuffer();
+    ASSERT_EQ(sizeof(expected), buf.getLength());
+    EXPECT_EQ(0, memcmp(buf.getData(), expected, sizeof(expected)));
+}
+
 // Check that multiple options of the same type may be retrieved by using
 // Pkt6::getOptions or Pkt6::getNonCopiedOptions. In the former case, also
 // check that retrieved options are copied when Pkt6::setCopyRetrievedOptions
@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -13,10 +13,16 @@
 #include <dhcp/tests/pkt_filter_test_utils.h>
 #include <util/buffer.h>
 
+#include <boost/lexical_cast.hpp>
 #include <gtest/gtest.h>
 
 #include <linux/if_packet.h>
 #include <sys/socket.h>
+#include <sys/stat.h>
+
+#include <fstream>
+#include <sstream>
+#include <string>
 
 using namespace isc::asiolink;
 using namespace isc::dhcp;
@@ -29,6 +35,32 @@ const uint16_t PORT = 10067;
 /// Size of the buffer holding received packets.
 const size_t RECV_BUF_SIZE = 2048;
 
+/// @brief Checks if the packet socket is listed by the kernel.
+///
+/// @param inode Inode number of the socket.
+///
+/// @return true if the socket is listed in /proc/net/packet.
+bool
+packetSocketExists(const ino_t inode) {
+    std::ifstream packets("/proc/net/packet");
+    std::string line;
+    // Skip the header.
+    std::getline(packets, line);
+    while (std::getline(packets, line)) {
+        // The inode number is the last column.
+        std::istringstream columns(line);
+        std::string column;
+        std::string last;
+        while (columns >> column) {
+            last = column;
+        }
+        if (last == boost::lexical_cast<std::string>(inode)) {
+            return (true);
+        }
+    }
+    return (false);
+}
+
 // Test fixture class inherits from the class common for all packet
 // filter tests.
 class PktFilterLPFTest : public isc::dhcp::test::PktFilterTest {
@@ -44,6 +76,13 @@ TEST_F(PktFilterLPFTest, isDirectResponseSupported) {
     PktFilterLPF pkt_filter;
     // Must support direct responses.
     EXPECT_TRUE(pkt_filter.isDirectResponseSupported());
+    // The rings are not used by default.
+    EXPECT_FALSE(pkt_filter.isRingUsed());
+
+    // The memory mapped rings support direct responses too.
+    PktFilterLPF pkt_filter_ring(true);
+    EXPECT_TRUE(pkt_filter_ring.isDirectResponseSupported());
+    EXPECT_TRUE(pkt_filter_ring.isRingUsed());
 }
 
 // All tests below require root privileges to execute successfully. If
@@ -219,4 +258,112 @@ TEST_F(PktFilterLPFTest, DISABLED_filterOutUnicast) {
     ASSERT_LE(result, 0);
 }
 
+// This test verifies that the socket using memory mapped rings can be
+// opened and that it uses TPACKET_V3.
+TEST_F(PktFilterLPFTest, DISABLED_openSocketRing) {
+    Iface iface(ifname_, ifindex_);
+    IOAddress addr("127.0.0.1");
+
+    PktFilterLPF pkt_filter(true);
+    sock_info_ = pkt_filter.openSocket(iface, addr, PORT, false, false);
+    ASSERT_GE(sock_info_.sockfd_, 0);
+    ASSERT_GE(sock_info_.fallbackfd_, 0);
+
+    int version = 0;
+    socklen_t version_len = sizeof(version);
+    ASSERT_EQ(0, getsockopt(sock_info_.sockfd_, SOL_PACKET, PACKET_VERSION,
+                            &version, &version_len));
+    EXPECT_EQ(TPACKET_V3, version);
+}
+
+// This test verifies that the rings are unmapped when the socket is
+// released, so as the kernel socket is destroyed when it is closed.
+TEST_F(PktFilterLPFTest, DISABLED_releaseSocketRing) {
+    Iface iface(ifname_, ifindex_);
+    IOAddress addr("127.0.0.1");
+
+    PktFilterLPF pkt_filter(true);
+    sock_info_ = pkt_filter.openSocket(iface, addr, PORT, false, false);
+    ASSERT_GE(sock_info_.sockfd_, 0);
+
+    struct stat sock_stat;
+    ASSERT_EQ(0, fstat(sock_info_.sockfd_, &sock_stat));
+    EXPECT_TRUE(packetSocketExists(sock_stat.st_ino));
+
+    pkt_filter.releaseSocket(sock_info_);
+    close(sock_info_.sockfd_);
+    close(sock_info_.fallbackfd_);
+    sock_info_ = SocketInfo(addr, PORT, -1, -1);
+
+    EXPECT_FALSE(packetSocketExists(sock_stat.st_ino));
+}
+
+// This test verifies that multiple packets can be received from the
+// memory mapped ring.
+TEST_F(PktFilterLPFTest, DISABLED_receiveRing) {
+    Iface iface(ifname_, ifindex_);
+    IOAddress addr("127.0.0.1");
+
+    PktFilterLPF pkt_filter(true);
+    sock_info_ = pkt_filter.openSocket(iface, addr, PORT, false, false);
+    ASSERT_GE(sock_info_.sockfd_, 0);
+
+    // Send a couple of messages which are likely to be placed in the same
+    // block of the ring.
+    const unsigned int MESSAGES_NUM = 3;
+    for (unsigned int i = 0; i < MESSAGES_NUM; ++i) {
+        sendMessage();
+    }
+
+    for (unsigned int i = 0; i < MESSAGES_NUM; ++i) {
+        // The socket is readable when the block is passed to the user space
+        // and until all packets from the block have been processed.
+        fd_set readfds;
+        FD_ZERO(&readfds);
+        FD_SET(sock_info_.sockfd_, &readfds);
+        struct timeval timeout;
+        timeout.tv_sec = 5;
+        timeout.tv_usec = 0;
+        ASSERT_GT(select(sock_info_.sockfd_ + 1, &readfds, NULL, NULL,
+                         &timeout), 0);
+
+        Pkt4Ptr rcvd_pkt = pkt_filter.receive(iface, sock_info_);
+        ASSERT_TRUE(rcvd_pkt);
+        ASSERT_NO_THROW(rcvd_pkt->unpack());
+        testRcvdMessage(rcvd_pkt);
+        testRcvdMessageAddressPort(rcvd_pkt);
+    }
+}
+
+// This test verifies that the packet can be sent using the memory mapped
+// ring.
+TEST_F(PktFilterLPFTest, DISABLED_sendRing) {
+    Iface iface(ifname_, ifindex_);
+    IOAddress addr("127.0.0.1");
+
+    PktFilterLPF pkt_filter(true);
+    sock_info_ = pkt_filter.openSocket(iface, addr, PORT, false, false);
+    ASSERT_GE(sock_info_.sockfd_, 0);
+
+    // There are no received packets waiting for processing, so the
+    // packet is sent immediately.
+    ASSERT_NO_THROW(pkt_filter.send(iface, sock_info_.sockfd_, test_message_));
+
+    // The packet sent over the loopback interface is received by the
+    // same socket.
+    fd_set readfds;
+    FD_ZERO(&readfds);
+    FD_SET(sock_info_.sockfd_, &readfds);
+    struct timeval timeout;
+    timeout.tv_sec = 5;
+    timeout.tv_usec = 0;
+    ASSERT_GT(select(sock_info_.sockfd_ + 1, &readfds, NULL, NULL,
+                     &timeout), 0);
+
+    Pkt4Ptr rcvd_pkt = pkt_filter.receive(iface, sock_info_);
+    ASSERT_TRUE(rcvd_pkt);
+    ASSERT_NO_THROW(rcvd_pkt->unpack());
+    testRcvdMessage(rcvd_pkt);
+}
+
 } // anonymous namespace
@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2015 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -16,6 +16,8 @@
 // in ip.h.
 #include <netinet/in_systm.h>
 #include <netinet/ip.h>
+#include <cstdlib>
+#include <vector>
 
 using namespace isc;
 using namespace isc::asiolink;
@@ -59,6 +61,50 @@ TEST(ProtocolUtilTest, checksum) {
     EXPECT_EQ(0xb1e4, chksum);
 }
 
+/// @brief Calculates the checksum one word at a time.
+///
+/// It is used as a reference for the optimized implementation.
+///
+/// @param buf buffer for which the checksum is calculated.
+/// @param buf_size size of the buffer.
+/// @param sum initial checksum value.
+uint16_t
+calcChecksumReference(const uint8_t* buf, const uint32_t buf_size,
+                      uint32_t sum) {
+    for (uint32_t i = 0; i < buf_size; i += 2) {
+        sum += buf[i] << 8;
+        if (i + 1 < buf_size) {
+            sum += buf[i + 1];
+        }
+        while (sum > 0xFFFF) {
+            sum = (sum & 0xFFFF) + (sum >> 16);
+        }
+    }
+    return (sum);
+}
+
+/// The purpose of this test is to verify that the checksum is calculated
+/// correctly for the buffers of various lengths and alignments, i.e. the
+/// vectorized and scalar code paths are consistent.
+TEST(ProtocolUtilTest, checksumLengths) {
+    std::vector<uint8_t> data(2100);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<uint8_t>(random());
+    }
+    for (uint32_t offset = 0; offset < 4; ++offset) {
+        for (uint32_t len = 0; len + offset <= data.size(); len += 7) {
+            ASSERT_EQ(calcChecksumReference(&data[offset], len, 0x1234),
+                      calcChecksum(&data[offset], len, 0x1234))
+                << "offset " << offset << ", length " << len;
+        }
+    }
+
+    // The sum of all ones words must not be folded to zero.
+    std::vector<uint8_t> ones(1500, 0xFF);
+    EXPECT_EQ(0xFFFF, calcChecksum(&ones[0], ones.size()));
+    EXPECT_EQ(0, calcChecksum(&data[0], 0));
+}
+
 // The purpose of this test is to verify that the Ethernet frame header
 // can be decoded correctly. In particular it verifies that the source
 // HW address can be extracted from it.
@@ -1,4 +1,4 @@
-// Copyright (C) 2012-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2012-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -77,6 +77,28 @@ struct AllocEngineHooks {
 // module is called.
 AllocEngineHooks Hooks;
 
+/// @brief Updates the lease lookup cache after the address has been
+/// allocated.
+///
+/// @param cache Cache used in the current pass or null if all candidates
+/// are checked in the lease database.
+/// @param stale_cache Cache used in the previous pass or null.
+/// @param type Lease type.
+/// @param address Allocated address or prefix.
+void
+markAllocated(const LeaseLookupCachePtr& cache,
+              const LeaseLookupCachePtr& stale_cache,
+              const Lease::Type type, const IOAddress& address) {
+    if (cache) {
+        cache->markInUse(type, address);
+
+    } else if (stale_cache) {
+        // The address hasn't been found using the cache, so the leases of
+        // its pool have changed since the summary was loaded.
+        stale_cache->invalidate(type, address);
+    }
+}
+
 }; // anonymous namespace
 
 namespace isc {
@@ -94,52 +116,16 @@ AllocEngine::IterativeAllocator::increasePrefix(const isc::asiolink::IOAddress&
                   "increase prefix " << prefix << ")");
     }
 
-    // Get a buffer holding an address.
-    const std::vector<uint8_t>& vec = prefix.toBytes();
-
     if (prefix_len < 1 || prefix_len > 128) {
         isc_throw(BadValue, "Cannot increase prefix: invalid prefix length: "
                   << prefix_len);
     }
 
-    // Brief explanation what happens here:
-    // http://www.youtube.com/watch?v=NFQCYpIHLNQ
-
-    uint8_t n_bytes = (prefix_len - 1)/8;
-    uint8_t n_bits = 8 - (prefix_len - n_bytes*8);
-    uint8_t mask = 1 << n_bits;
-
-    // Longer explanation: n_bytes specifies number of full bytes that are
-    // in-prefix. They can also be used as an offset for the first byte that
-    // is not in prefix. n_bits specifies number of bits on the last byte that
-    // is (often partially) in prefix. For example for a /125 prefix, the values
-    // are 15 and 3, respectively. Mask is a bitmask that has the least
-    // significant bit from the prefix set.
-
-    uint8_t packed[V6ADDRESS_LEN];
-
-    // Copy the address. It must be V6, but we already checked that.
-    std::memcpy(packed, &vec[0], V6ADDRESS_LEN);
-
-    // Can we safely increase only the last byte in prefix without overflow?
-    if (packed[n_bytes] + uint16_t(mask) < 256u) {
-        packed[n_bytes] += mask;
-        return (IOAddress::fromBytes(AF_INET6, packed));
-    }
-
-    // Overflow (done on uint8_t, but the sum is greater than 255)
-    packed[n_bytes] += mask;
-
-    // Deal with the overflow. Start increasing the least significant byte
-    for (int i = n_bytes - 1; i >= 0; --i) {
-        ++packed[i];
-        // If we haven't overflowed (0xff->0x0) the next byte, then we are done
-        if (packed[i] != 0) {
-            break;
-        }
-    }
-
-    return (IOAddress::fromBytes(AF_INET6, packed));
+    // Increasing the prefix is adding the value of its least significant
+    // bit, i.e. 2^(128 - prefix_len), to the address. The 128-bit integer
+    // arithmetic loops over to zero like the byte-wise one used to.
+    return (IOAddress(prefix.toV6Value() +
+                      IPv6Value::powerOfTwo(128 - prefix_len)));
 }
 
 
@@ -247,7 +233,8 @@ AllocEngine::RandomAllocator::pickAddress(const SubnetPtr&,
 
 AllocEngine::AllocEngine(AllocType engine_type, uint64_t attempts,
                          bool ipv6)
-    : attempts_(attempts), incomplete_v4_reclamations_(0),
+    : attempts_(attempts), lookup_cache_(new LeaseLookupCache()),
+      lookup_cache_all_backends_(false), incomplete_v4_reclamations_(0),
       incomplete_v6_reclamations_(0) {
 
     // Choose the basic (normal address) lease type
@@ -304,6 +291,27 @@ AllocEngine::AllocatorPtr AllocEngine::getAllocator(Lease::Type type) {
     return (alloc->second);
 }
 
+LeaseLookupCachePtr
+AllocEngine::getLeaseLookupCache() const {
+    // The lookups in the memfile backend don't involve any round-trips.
+    // The Cassandra backend doesn't retrieve the leases in pages, which is
+    // needed to load the pool summaries.
+    const std::string type = LeaseMgrFactory::instance().getType();
+    if (!lookup_cache_ || (type == "cql") ||
+        (!lookup_cache_all_backends_ && (type == "memfile"))) {
+        return (LeaseLookupCachePtr());
+    }
+    return (lookup_cache_);
+}
+
+void
+AllocEngine::invalidateLeaseLookupCache(const Lease::Type type,
+                                        const IOAddress& address) const {
+    if (lookup_cache_) {
+        lookup_cache_->invalidate(type, address);
+    }
+}
+
 template<typename ContextType>
 void
 AllocEngine::findReservationInternal(ContextType& ctx,
@@ -394,6 +402,7 @@ void AllocEngine::findReservation(ClientContext6& ctx) {
 
 Lease6Collection
 AllocEngine::allocateLeases6(ClientContext6& ctx) {
+    isc::util::thread::Mutex::Locker lock(lease_mutex_);
 
     try {
         if (!ctx.subnet_) {
@@ -670,66 +679,108 @@ AllocEngine::allocateUnreservedLeases6(ClientContext6& ctx) {
     // - we exhaust number of tries
     uint64_t max_attempts = (attempts_ > 0 ? attempts_  :
                              ctx.subnet_->getPoolCapacity(ctx.currentIA().type_));
-    for (uint64_t i = 0; i < max_attempts; ++i)
-    {
-        IOAddress candidate = allocator->pickAddress(ctx.subnet_, ctx.duid_, hint);
 
-        /// In-pool reservations: Check if this address is reserved for someone
-        /// else. There is no need to check for whom it is reserved, because if
-        /// it has been reserved for us we would have already allocated a lease.
-        if (hr_mode == Subnet::HR_ALL &&
-            HostMgr::instance().get6(ctx.subnet_->getID(), candidate)) {
+    // The lease lookup cache is only used in the first pass. If no address
+    // is found with the cache, possibly because some leases have been
+    // released since the cache was refreshed, all candidates are checked
+    // in the lease database in the second pass. The pool summaries are
+    // retained, so as the exhausted pool isn't loaded again for the next
+    // allocation, unless the second pass finds the address which the cache
+    // reported in use. If the second pass finds no address either, it is
+    // skipped for the next allocations until the cache is refreshed.
+    LeaseLookupCachePtr cache = getLeaseLookupCache();
+    LeaseLookupCachePtr stale_cache;
+    if (cache) {
+        cache->startAllocation();
+    }
+    for (;;) {
+        for (uint64_t i = 0; i < max_attempts; ++i) {
+            IOAddress candidate = allocator->pickAddress(ctx.subnet_, ctx.duid_, hint);
+
+            /// In-pool reservations: Check if this address is reserved for someone
+            /// else. There is no need to check for whom it is reserved, because if
+            /// it has been reserved for us we would have already allocated a lease.
+            if (hr_mode == Subnet::HR_ALL &&
+                HostMgr::instance().get6(ctx.subnet_->getID(), candidate)) {
+
+                // Don't allocate.
+                continue;
+            }
 
-            // Don't allocate.
-            continue;
-        }
+            // Skip the address known to be in use without a round-trip to the
+            // lease database.
+            if (cache &&
+                (cache->getStatus(LeaseMgrFactory::instance(), ctx.subnet_,
+                                  ctx.currentIA().type_, candidate) ==
+                 LeaseLookupCache::IN_USE)) {
+                continue;
+            }
 
-        // The first step is to find out prefix length. It is 128 for
-        // non-PD leases.
-        uint8_t prefix_len = 128;
-        if (ctx.currentIA().type_ == Lease::TYPE_PD) {
-            pool = boost::dynamic_pointer_cast<Pool6>(
-                ctx.subnet_->getPool(ctx.currentIA().type_, candidate, false));
-            if (pool) {
-                prefix_len = pool->getLength();
+            // The first step is to find out prefix length. It is 128 for
+            // non-PD leases.
+            uint8_t prefix_len = 128;
+            if (ctx.currentIA().type_ == Lease::TYPE_PD) {
+                pool = boost::dynamic_pointer_cast<Pool6>(
+                    ctx.subnet_->getPool(ctx.currentIA().type_, candidate, false));
+                if (pool) {
+                    prefix_len = pool->getLength();
+                }
             }
-        }
 
-        Lease6Ptr existing = LeaseMgrFactory::instance().getLease6(ctx.currentIA().type_,
-                                                                   candidate);
-        if (!existing) {
+            Lease6Ptr existing = LeaseMgrFactory::instance().getLease6(ctx.currentIA().type_,
+                                                                       candidate);
+            if (!existing) {
 
-            // there's no existing lease for selected candidate, so it is
-            // free. Let's allocate it.
+                // there's no existing lease for selected candidate, so it is
+                // free. Let's allocate it.
 
-            Lease6Ptr lease = createLease6(ctx, candidate, prefix_len);
-            if (lease) {
-                // We are allocating a new lease (not renewing). So, the
-                // old lease should be NULL.
-                ctx.currentIA().old_leases_.clear();
+                Lease6Ptr lease = createLease6(ctx, candidate, prefix_len);
+                if (lease) {
+                    // We are allocating a new lease (not renewing). So, the
+                    // old lease should be NULL.
+                    ctx.currentIA().old_leases_.clear();
 
-                leases.push_back(lease);
-                return (leases);
-            }
+                    markAllocated(cache, stale_cache, ctx.currentIA().type_,
+                                  candidate);
+                    leases.push_back(lease);
+                    return (leases);
+                }
 
-            // Although the address was free just microseconds ago, it may have
-            // been taken just now. If the lease insertion fails, we continue
-            // allocation attempts.
-        } else {
-            if (existing->expired()) {
-                // Copy an existing, expired lease so as it can be returned
-                // to the caller.
-                Lease6Ptr old_lease(new Lease6(*existing));
-                ctx.currentIA().old_leases_.push_back(old_lease);
-
-                existing = reuseExpiredLease(existing,
-                                             ctx,
-                                             prefix_len);
-
-                leases.push_back(existing);
-                return (leases);
+                // Although the address was free just microseconds ago, it may have
+                // been taken just now. If the lease insertion fails, we continue
+                // allocation attempts.
+                if (cache) {
+                    cache->markInUse(ctx.currentIA().type_, candidate);
+                }
+            } else {
+                if (existing->expired()) {
+                    // Copy an existing, expired lease so as it can be returned
+                    // to the caller.
+                    Lease6Ptr old_lease(new Lease6(*existing));
+                    ctx.currentIA().old_leases_.push_back(old_lease);
+
+                    existing = reuseExpiredLease(existing,
+                                                 ctx,
+                                                 prefix_len);
+
+                    markAllocated(cache, stale_cache, ctx.currentIA().type_,
+                                  candidate);
+                    leases.push_back(existing);
+                    return (leases);
+
+                } else if (cache) {
+                    cache->markInUse(ctx.currentIA().type_, candidate);
+                }
             }
         }
+        if (!cache || cache->isExhausted(ctx.subnet_->getID(),
+                                         ctx.currentIA().type_)) {
+            break;
+        }
+        stale_cache.swap(cache);
+    }
+    if (stale_cache) {
+        stale_cache->markExhausted(ctx.subnet_->getID(), ctx.currentIA().type_);
     }
 
     // Unable to allocate an address, return an empty lease.
@@ -902,6 +953,7 @@ AllocEngine::removeNonmatchingReservedLeases6(ClientContext6& ctx,
         // Remove this lease from LeaseMgr as it is reserved to someone
         // else or doesn't belong to a pool.
         LeaseMgrFactory::instance().deleteLease(candidate->addr_);
+        invalidateLeaseLookupCache(candidate->type_, candidate->addr_);
 
         // Update DNS if needed.
         queueNCR(CHG_REMOVE, candidate);
@@ -969,6 +1021,7 @@ AllocEngine::removeNonreservedLeases6(ClientContext6& ctx,
 
             // Remove this lease from LeaseMgr
             LeaseMgrFactory::instance().deleteLease((*lease)->addr_);
+            invalidateLeaseLookupCache((*lease)->type_, (*lease)->addr_);
 
             // Update DNS if required.
             queueNCR(CHG_REMOVE, *lease);
@@ -1194,6 +1247,8 @@ Lease6Ptr AllocEngine::createLease6(ClientContext6& ctx,
 
 Lease6Collection
 AllocEngine::renewLeases6(ClientContext6& ctx) {
+    isc::util::thread::Mutex::Locker lock(lease_mutex_);
+
     try {
         if (!ctx.subnet_) {
             isc_throw(InvalidOperation, "Subnet is required for allocation");
@@ -1293,6 +1348,7 @@ AllocEngine::extendLease6(ClientContext6& ctx, Lease6Ptr lease) {
 
         // Remove this lease from LeaseMgr
         LeaseMgrFactory::instance().deleteLease(lease->addr_);
+        invalidateLeaseLookupCache(lease->type_, lease->addr_);
 
         // Updated DNS if required.
         queueNCR(CHG_REMOVE, lease);
@@ -1445,6 +1501,9 @@ void
 AllocEngine::reclaimExpiredLeases6(const size_t max_leases, const uint16_t timeout,
                                    const bool remove_lease,
                                    const uint16_t max_unwarned_cycles) {
+    // The leases may be concurrently reclaimed by the lease reclamation
+    // worker.
+    isc::util::thread::Mutex::Locker lock(lease_mutex_);
 
     LOG_DEBUG(alloc_engine_logger, ALLOC_ENGINE_DBG_TRACE,
               ALLOC_ENGINE_V6_LEASES_RECLAMATION_START)
@@ -1559,6 +1618,8 @@ AllocEngine::reclaimExpiredLeases6(const size_t max_leases, const uint16_t timeo
 
 void
 AllocEngine::deleteExpiredReclaimedLeases6(const uint32_t secs) {
+    isc::util::thread::Mutex::Locker lock(lease_mutex_);
+
     LOG_DEBUG(alloc_engine_logger, ALLOC_ENGINE_DBG_TRACE,
               ALLOC_ENGINE_V6_RECLAIMED_LEASES_DELETE)
         .arg(secs);
@@ -1584,6 +1645,9 @@ void
 AllocEngine::reclaimExpiredLeases4(const size_t max_leases, const uint16_t timeout,
                                    const bool remove_lease,
                                    const uint16_t max_unwarned_cycles) {
+    // The leases may be concurrently reclaimed by the lease reclamation
+    // worker.
+    isc::util::thread::Mutex::Locker lock(lease_mutex_);
 
     LOG_DEBUG(alloc_engine_logger, ALLOC_ENGINE_DBG_TRACE,
               ALLOC_ENGINE_V4_LEASES_RECLAMATION_START)
@@ -1780,32 +1844,7 @@ AllocEngine::reclaimExpiredLease(const Lease6Ptr& lease,
     }
 
     // Update statistics.
-
-    // Decrease number of assigned leases.
-    if (lease->type_ == Lease::TYPE_NA) {
-        // IA_NA
-        StatsMgr::instance().addValue(StatsMgr::generateName("subnet",
-                                                             lease->subnet_id_,
-                                                             "assigned-nas"),
-                                      int64_t(-1));
-
-    } else if (lease->type_ == Lease::TYPE_PD) {
-        // IA_PD
-        StatsMgr::instance().addValue(StatsMgr::generateName("subnet",
-                                                             lease->subnet_id_,
-                                                             "assigned-pds"),
-                                      int64_t(-1));
-
-    }
-
-    // Increase total number of reclaimed leases.
-    StatsMgr::instance().addValue("reclaimed-leases", int64_t(1));
-
-    // Increase number of reclaimed leases for a subnet.
-    StatsMgr::instance().addValue(StatsMgr::generateName("subnet",
-                                                         lease->subnet_id_,
-                                                         "reclaimed-leases"),
-                                  int64_t(1));
+    updateReclaimedLeaseStats(lease);
 }
 
 void
@@ -1870,7 +1909,77 @@ AllocEngine::reclaimExpiredLease(const Lease4Ptr& lease,
     }
 
     // Update statistics.
+    updateReclaimedLeaseStats(lease);
+}
+
+void
+AllocEngine::completeLeaseReclamation(const Lease6Ptr& lease) {
+    // Generate removal name change request for D2, if required.
+    queueNCR(CHG_REMOVE, lease);
+
+    // The declined lease has been removed from the database. This only
+    // logs and updates the statistics, as there are no lease6_recover
+    // callouts when the leases are reclaimed by the worker.
+    reclaimDeclined(lease);
+
+    updateReclaimedLeaseStats(lease);
+}
 
+void
+AllocEngine::completeLeaseReclamation(const Lease4Ptr& lease) {
+    // Generate removal name change request for D2, if required.
+    queueNCR(CHG_REMOVE, lease);
+
+    // The declined lease has been removed from the database. This only
+    // logs and updates the statistics, as there are no lease4_recover
+    // callouts when the leases are reclaimed by the worker.
+    reclaimDeclined(lease);
+
+    updateReclaimedLeaseStats(lease);
+}
+
+bool
+AllocEngine::reclamationCalloutsPresent(const bool ipv6) {
+    HooksManager& hooks_manager = HooksManager::getHooksManager();
+    if (ipv6) {
+        return (hooks_manager.calloutsPresent(Hooks.hook_index_lease6_expire_) ||
+                hooks_manager.calloutsPresent(Hooks.hook_index_lease6_recover_));
+    }
+    return (hooks_manager.calloutsPresent(Hooks.hook_index_lease4_expire_) ||
+            hooks_manager.calloutsPresent(Hooks.hook_index_lease4_recover_));
+}
+
+void
+AllocEngine::updateReclaimedLeaseStats(const Lease6Ptr& lease) const {
+    // Decrease number of assigned leases.
+    if (lease->type_ == Lease::TYPE_NA) {
+        // IA_NA
+        StatsMgr::instance().addValue(StatsMgr::generateName("subnet",
+                                                             lease->subnet_id_,
+                                                             "assigned-nas"),
+                                      int64_t(-1));
+
+    } else if (lease->type_ == Lease::TYPE_PD) {
+        // IA_PD
+        StatsMgr::instance().addValue(StatsMgr::generateName("subnet",
+                                                             lease->subnet_id_,
+                                                             "assigned-pds"),
+                                      int64_t(-1));
+
+    }
+
+    // Increase total number of reclaimed leases.
+    StatsMgr::instance().addValue("reclaimed-leases", int64_t(1));
+
+    // Increase number of reclaimed leases for a subnet.
+    StatsMgr::instance().addValue(StatsMgr::generateName("subnet",
+                                                         lease->subnet_id_,
+                                                         "reclaimed-leases"),
+                                  int64_t(1));
+}
+
+void
+AllocEngine::updateReclaimedLeaseStats(const Lease4Ptr& lease) const {
     // Decrease number of assigned addresses.
     StatsMgr::instance().addValue(StatsMgr::generateName("subnet",
                                                          lease->subnet_id_,
@@ -1889,6 +1998,8 @@ AllocEngine::reclaimExpiredLease(const Lease4Ptr& lease,
 
 void
 AllocEngine::deleteExpiredReclaimedLeases4(const uint32_t secs) {
+    isc::util::thread::Mutex::Locker lock(lease_mutex_);
+
     LOG_DEBUG(alloc_engine_logger, ALLOC_ENGINE_DBG_TRACE,
               ALLOC_ENGINE_V4_RECLAIMED_LEASES_DELETE)
         .arg(secs);
@@ -2206,6 +2317,8 @@ AllocEngine::ClientContext4::ClientContext4(const Subnet4Ptr& subnet,
 
 Lease4Ptr
 AllocEngine::allocateLease4(ClientContext4& ctx) {
+    isc::util::thread::Mutex::Locker lock(lease_mutex_);
+
     // The NULL pointer indicates that the old lease didn't exist. It may
     // be later set to non NULL value if existing lease is found in the
     // database.
@@ -2513,6 +2626,7 @@ AllocEngine::requestLease4(AllocEngine::ClientContext4& ctx) {
             .arg(client_lease->addr_.toText());
 
         lease_mgr.deleteLease(client_lease->addr_);
+        invalidateLeaseLookupCache(Lease::TYPE_V4, client_lease->addr_);
 
         // Need to decrease statistic for assigned addresses.
         StatsMgr::instance().addValue(
@@ -2830,19 +2944,58 @@ AllocEngine::allocateUnreservedLease4(ClientContext4& ctx) {
     AllocatorPtr allocator = getAllocator(Lease::TYPE_V4);
     const uint64_t max_attempts = (attempts_ > 0 ? attempts_ :
                                    ctx.subnet_->getPoolCapacity(Lease::TYPE_V4));
-    for (uint64_t i = 0; i < max_attempts; ++i) {
-        IOAddress candidate = allocator->pickAddress(ctx.subnet_, ctx.clientid_,
-                                                     ctx.requested_address_);
-        // If address is not reserved for another client, try to allocate it.
-        if (!addressReserved(candidate, ctx)) {
+
+    // The lease lookup cache is only used in the first pass. If no address
+    // is found with the cache, possibly because some leases have been
+    // released since the cache was refreshed, all candidates are checked
+    // in the lease database in the second pass. The pool summaries are
+    // retained, so as the exhausted pool isn't loaded again for the next
+    // allocation, unless the second pass finds the address which the cache
+    // reported in use. If the second pass finds no address either, it is
+    // skipped for the next allocations until the cache is refreshed.
+    LeaseLookupCachePtr cache = getLeaseLookupCache();
+    LeaseLookupCachePtr stale_cache;
+    if (cache) {
+        cache->startAllocation();
+    }
+    for (;;) {
+        for (uint64_t i = 0; i < max_attempts; ++i) {
+            IOAddress candidate = allocator->pickAddress(ctx.subnet_, ctx.clientid_,
+                                                         ctx.requested_address_);
+            // If address is not reserved for another client, try to allocate it.
+            if (addressReserved(candidate, ctx)) {
+                continue;
+            }
+
+            // Skip the address known to be in use without a round-trip to
+            // the lease database.
+            if (cache &&
+                (cache->getStatus(LeaseMgrFactory::instance(), ctx.subnet_,
+                                  Lease::TYPE_V4, candidate) ==
+                 LeaseLookupCache::IN_USE)) {
+                continue;
+            }
+
             // The call below will return the non-NULL pointer if we
             // successfully allocate this lease. This means that the
             // address is not in use by another client.
             new_lease = allocateOrReuseLease4(candidate, ctx);
             if (new_lease) {
+                markAllocated(cache, stale_cache, Lease::TYPE_V4, candidate);
                 return (new_lease);
             }
+            if (cache) {
+                cache->markInUse(Lease::TYPE_V4, candidate);
+            }
+        }
+        if (!cache || cache->isExhausted(ctx.subnet_->getID(),
+                                         Lease::TYPE_V4)) {
+            break;
         }
+        stale_cache.swap(cache);
+    }
+    if (stale_cache) {
+        stale_cache->markExhausted(ctx.subnet_->getID(), Lease::TYPE_V4);
     }
 
     // Unable to allocate an address, return an empty lease.
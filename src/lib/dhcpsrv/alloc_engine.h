@@ -1,4 +1,4 @@
-// Copyright (C) 2012-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2012-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -15,8 +15,10 @@
 #include <dhcp/option6_ia.h>
 #include <dhcpsrv/host.h>
 #include <dhcpsrv/subnet.h>
+#include <dhcpsrv/lease_lookup_cache.h>
 #include <dhcpsrv/lease_mgr.h>
 #include <hooks/callout_handle.h>
+#include <util/threads/sync.h>
 
 #include <boost/function.hpp>
 #include <boost/shared_ptr.hpp>
@@ -227,6 +229,34 @@ public:
     /// @return pointer to allocator handling a given resource types
     AllocatorPtr getAllocator(Lease::Type type);
 
+    /// @brief Sets the cache used to avoid checking each candidate address
+    /// in the lease database.
+    ///
+    /// By default, the engine uses the @c LeaseLookupCache with the default
+    /// parameters for the MySQL and PostgreSQL lease database backends. The
+    /// memfile backend holds the leases in memory, so the cache would only
+    /// add overhead. The Cassandra backend doesn't retrieve the leases in
+    /// pages, so the cache is never used with it.
+    ///
+    /// @param cache Pointer to the cache or null to disable the cache.
+    /// @param all_backends Indicates if the cache should also be used with
+    /// the memfile backend.
+    void setLeaseLookupCache(const LeaseLookupCachePtr& cache,
+                             const bool all_backends = false) {
+        lookup_cache_ = cache;
+        lookup_cache_all_backends_ = all_backends;
+    }
+
+    /// @brief Drops the state of the address held in the lease lookup cache.
+    ///
+    /// Called when the lease for the address is removed, either by the
+    /// engine or by the server releasing the lease.
+    ///
+    /// @param type Type of the removed lease.
+    /// @param address Address or prefix of the removed lease.
+    void invalidateLeaseLookupCache(const Lease::Type type,
+                                    const asiolink::IOAddress& address) const;
+
 private:
 
     /// @brief a pointer to currently used allocator
@@ -242,6 +272,19 @@ private:
     int hook_index_lease4_select_; ///< index for lease4_select hook
     int hook_index_lease6_select_; ///< index for lease6_select hook
 
+    /// @brief Returns the cache to be used for the allocation.
+    ///
+    /// @return Pointer to the cache or null if the cache should not be used
+    /// with the current lease database backend.
+    LeaseLookupCachePtr getLeaseLookupCache() const;
+
+    /// @brief Cache used to avoid checking each candidate address in the
+    /// lease database.
+    LeaseLookupCachePtr lookup_cache_;
+
+    /// @brief Indicates if the cache is also used with the memfile backend.
+    bool lookup_cache_all_backends_;
+
 public:
 
     /// @brief Defines a single hint (an address + prefix-length).
@@ -695,6 +738,49 @@ public:
     /// deleted.
     void deleteExpiredReclaimedLeases4(const uint32_t secs);
 
+    /// @brief Completes the reclamation of the IPv6 lease which has been
+    /// already reclaimed in the lease database by another thread.
+    ///
+    /// This method is called by the @c LeaseReclamationWorker in the main
+    /// thread. It removes the DNS records for the lease and updates the
+    /// statistics of the assigned, declined and reclaimed leases.
+    ///
+    /// @param lease Pointer to the lease as it was before the reclamation.
+    void completeLeaseReclamation(const Lease6Ptr& lease);
+
+    /// @brief Completes the reclamation of the IPv4 lease which has been
+    /// already reclaimed in the lease database by another thread.
+    ///
+    /// This method is called by the @c LeaseReclamationWorker in the main
+    /// thread. It removes the DNS records for the lease and updates the
+    /// statistics of the assigned, declined and reclaimed leases.
+    ///
+    /// @param lease Pointer to the lease as it was before the reclamation.
+    void completeLeaseReclamation(const Lease4Ptr& lease);
+
+    /// @brief Checks if any callouts are installed for the hook points
+    /// invoked during the reclamation of the expired leases.
+    ///
+    /// The leases can be reclaimed by the @c LeaseReclamationWorker only
+    /// if there are no such callouts, because the hooks libraries are not
+    /// thread safe.
+    ///
+    /// @param ipv6 Indicates if the DHCPv6 or DHCPv4 hook points should
+    /// be checked.
+    ///
+    /// @return true if any of the lease4_expire and lease4_recover, or
+    /// lease6_expire and lease6_recover callouts are installed.
+    static bool reclamationCalloutsPresent(const bool ipv6);
+
+    /// @brief Returns the mutex serializing the updates of the leases.
+    ///
+    /// The mutex is held by the allocation engine while it allocates,
+    /// renews or reclaims the leases. The @c LeaseReclamationWorker holds
+    /// it while it reclaims a lease in the lease database, so as it
+    /// doesn't reclaim a lease being reused by the allocation engine.
+    isc::util::thread::Mutex& getLeaseMutex() {
+        return (lease_mutex_);
+    }
 
     /// @anchor findReservationDecl
     /// @brief Attempts to find appropriate host reservation.
@@ -1012,6 +1098,18 @@ private:
     ///         to keep it)
     bool reclaimDeclined(const Lease6Ptr& lease);
 
+    /// @brief Updates the statistics of the assigned and reclaimed leases
+    /// upon the reclamation of the DHCPv6 lease.
+    ///
+    /// @param lease Pointer to the reclaimed lease.
+    void updateReclaimedLeaseStats(const Lease6Ptr& lease) const;
+
+    /// @brief Updates the statistics of the assigned and reclaimed leases
+    /// upon the reclamation of the DHCPv4 lease.
+    ///
+    /// @param lease Pointer to the reclaimed lease.
+    void updateReclaimedLeaseStats(const Lease4Ptr& lease) const;
+
 public:
 
     /// @brief Context information for the DHCPv4 lease allocation.
@@ -1474,6 +1572,9 @@ private:
     /// which there are still expired leases in the database.
     uint16_t incomplete_v6_reclamations_;
 
+    /// @brief Mutex serializing the updates of the leases.
+    isc::util::thread::Mutex lease_mutex_;
+
 };
 
 /// @brief A pointer to the @c AllocEngine object.
@@ -1,4 +1,4 @@
-// Copyright (C) 2014-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2014-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -247,6 +247,57 @@ public:
     /// @param host Pointer to the new @c Host object being added.
     virtual void add(const HostPtr& host) = 0;
 
+    /// @brief Attempts to delete a host by (subnet-id, address).
+    ///
+    /// This method supports both v4 and v6.
+    ///
+    /// @param subnet_id subnet identifier.
+    /// @param addr specified address.
+    ///
+    /// @return true if deletion was successful, false if the host was not
+    /// there.
+    /// @throw various exceptions in case of errors.
+    virtual bool del(const SubnetID& subnet_id,
+                     const asiolink::IOAddress& addr) = 0;
+
+    /// @brief Attempts to delete a host by (subnet4-id, identifier type,
+    /// identifier).
+    ///
+    /// This method supports v4 hosts only.
+    ///
+    /// @param subnet_id IPv4 subnet identifier.
+    /// @param identifier_type Identifier type.
+    /// @param identifier_begin Pointer to a begining of a buffer containing
+    /// an identifier.
+    /// @param identifier_len Identifier length.
+    ///
+    /// @return true if deletion was successful, false if the host was not
+    /// there.
+    /// @throw various exceptions in case of errors.
+    virtual bool del4(const SubnetID& subnet_id,
+                      const Host::IdentifierType& identifier_type,
+                      const uint8_t* identifier_begin,
+                      const size_t identifier_len) = 0;
+
+    /// @brief Attempts to delete a host by (subnet6-id, identifier type,
+    /// identifier).
+    ///
+    /// This method supports v6 hosts only.
+    ///
+    /// @param subnet_id IPv6 subnet identifier.
+    /// @param identifier_type Identifier type.
+    /// @param identifier_begin Pointer to a begining of a buffer containing
+    /// an identifier.
+    /// @param identifier_len Identifier length.
+    ///
+    /// @return true if deletion was successful, false if the host was not
+    /// there.
+    /// @throw various exceptions in case of errors.
+    virtual bool del6(const SubnetID& subnet_id,
+                      const Host::IdentifierType& identifier_type,
+                      const uint8_t* identifier_begin,
+                      const size_t identifier_len) = 0;
+
     /// @brief Return backend type
     ///
     /// Returns the type of the backend (e.g. "mysql", "memfile" etc.)
@@ -0,0 +1,208 @@
+// Copyright (C) 2017 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/// @file address_bench.cc
+///
+/// Measures the time of the address arithmetic performed by the allocation
+/// engine and of the lease lookups by address in the in-memory lease
+/// storage. The program:
+/// - picks addresses and prefixes from subnets with 256 pools using the
+///   iterative allocator, which checks which pool the last allocated
+///   address belongs to and increases it,
+/// - for each number of leases given on the command line (10000, 100000
+///   and 1000000 by default) populates @c Lease4Storage and
+///   @c Lease6Storage and looks the leases up by address in a random
+///   order.
+/// The average time of a single operation is printed.
+
+#include <config.h>
+#include <asiolink/io_address.h>
+#include <dhcpsrv/alloc_engine.h>
+#include <dhcpsrv/memfile_lease_storage.h>
+#include <dhcpsrv/pool.h>
+#include <dhcpsrv/subnet.h>
+#include <log/logger_support.h>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using namespace isc::asiolink;
+using namespace isc::dhcp;
+
+namespace {
+
+/// @brief Number of operations performed for each type of the operation.
+const size_t OPERATIONS = 1000000;
+
+/// @brief Number of pools in the subnets used by the allocator.
+const uint32_t POOLS = 256;
+
+/// @brief Exposes the iterative allocator of the allocation engine.
+class BenchAllocEngine : public AllocEngine {
+public:
+    using AllocEngine::IterativeAllocator;
+};
+
+/// @brief Creates the IPv6 address for the specified index.
+///
+/// @param index Index of the address.
+IOAddress
+makeAddress6(const uint32_t index) {
+    return (IOAddress(IPv6Value(0x20010db800000000ull, index)));
+}
+
+/// @brief Prints the average time of a single operation.
+///
+/// @param name Name of the operation.
+/// @param start Time when the operations started.
+/// @param found Number of the successful operations.
+void
+report(const std::string& name, const boost::posix_time::ptime& start,
+       const size_t found) {
+    boost::posix_time::time_duration elapsed =
+        boost::posix_time::microsec_clock::universal_time() - start;
+    std::cout << "  " << std::left << std::setw(24) << name
+              << std::right << std::setw(10) << std::fixed
+              << std::setprecision(1)
+              << (elapsed.total_microseconds() * 1000.0 / OPERATIONS)
+              << " ns/op (" << found << " found)" << std::endl;
+}
+
+/// @brief Runs the allocation benchmark.
+void
+benchmarkAllocation() {
+    std::cout << "allocation from " << POOLS << " pools:" << std::endl;
+
+    Subnet4Ptr subnet4(new Subnet4(IOAddress("10.0.0.0"), 8, 1000, 2000,
+                                   3000, 1));
+    Subnet6Ptr subnet6(new Subnet6(IOAddress("2001:db8::"), 32, 1000, 2000,
+                                   3000, 4000, 1));
+    Subnet6Ptr subnet6_pd(new Subnet6(IOAddress("3000::"), 16, 1000, 2000,
+                                      3000, 4000, 2));
+    for (uint32_t i = 0; i < POOLS; ++i) {
+        subnet4->addPool(Pool4Ptr(new Pool4(IOAddress(0x0A000000 + (i << 8)),
+                                            24)));
+        subnet6->addPool(Pool6Ptr(new Pool6(Lease::TYPE_NA,
+                                            IOAddress(IPv6Value(0x20010db800000000ull + i, 0)),
+                                            64)));
+        subnet6_pd->addPool(Pool6Ptr(new Pool6(Lease::TYPE_PD,
+                                               IOAddress(IPv6Value(0x3000000000000000ull +
+                                                                   (static_cast<uint64_t>(i) << 24),
+                                                                   0)),
+                                               40, 56)));
+    }
+
+    DuidPtr duid(new DUID(std::vector<uint8_t>(8, 1)));
+
+    BenchAllocEngine::IterativeAllocator alloc4(Lease::TYPE_V4);
+    size_t found = 0;
+    boost::posix_time::ptime start =
+        boost::posix_time::microsec_clock::universal_time();
+    for (size_t i = 0; i < OPERATIONS; ++i) {
+        found += (alloc4.pickAddress(subnet4, duid,
+                                     IOAddress::IPV4_ZERO_ADDRESS()).isV4() ? 1 : 0);
+    }
+    report("pick IPv4 address", start, found);
+
+    BenchAllocEngine::IterativeAllocator alloc6(Lease::TYPE_NA);
+    found = 0;
+    start = boost::posix_time::microsec_clock::universal_time();
+    for (size_t i = 0; i < OPERATIONS; ++i) {
+        found += (alloc6.pickAddress(subnet6, duid,
+                                     IOAddress::IPV6_ZERO_ADDRESS()).isV6() ? 1 : 0);
+    }
+    report("pick IPv6 address", start, found);
+
+    BenchAllocEngine::IterativeAllocator alloc_pd(Lease::TYPE_PD);
+    found = 0;
+    start = boost::posix_time::microsec_clock::universal_time();
+    for (size_t i = 0; i < OPERATIONS; ++i) {
+        found += (alloc_pd.pickAddress(subnet6_pd, duid,
+                                       IOAddress::IPV6_ZERO_ADDRESS()).isV6() ? 1 : 0);
+    }
+    report("pick IPv6 prefix", start, found);
+}
+
+/// @brief Runs the lookup benchmark for the specified number of leases.
+///
+/// @param leases_num Number of leases.
+void
+benchmarkLookup(const uint32_t leases_num) {
+    std::cout << leases_num << " leases:" << std::endl;
+
+    HWAddrPtr hwaddr(new HWAddr(std::vector<uint8_t>(6, 1), HTYPE_ETHER));
+    DuidPtr duid(new DUID(std::vector<uint8_t>(8, 1)));
+
+    Lease4Storage storage4;
+    Lease6Storage storage6;
+    for (uint32_t i = 0; i < leases_num; ++i) {
+        storage4.insert(Lease4Ptr(new Lease4(IOAddress(0x0A000000 + i), hwaddr,
+                                             0, 0, 3000, 1000, 2000, 0, 1)));
+        storage6.insert(Lease6Ptr(new Lease6(Lease::TYPE_NA, makeAddress6(i),
+                                             duid, i, 3000, 4000, 1000, 2000,
+                                             1)));
+    }
+
+    // Look up the leases in a random order, so as the results are not
+    // skewed by the CPU cache.
+    std::vector<IOAddress> addresses4(OPERATIONS, IOAddress::IPV4_ZERO_ADDRESS());
+    std::vector<IOAddress> addresses6(OPERATIONS, IOAddress::IPV6_ZERO_ADDRESS());
+    for (size_t i = 0; i < OPERATIONS; ++i) {
+        const uint32_t index = static_cast<uint32_t>(random()) % leases_num;
+        addresses4[i] = IOAddress(0x0A000000 + index);
+        addresses6[i] = makeAddress6(index);
+    }
+
+    size_t found = 0;
+    boost::posix_time::ptime start =
+        boost::posix_time::microsec_clock::universal_time();
+    for (size_t i = 0; i < OPERATIONS; ++i) {
+        found += (storage4.find(Lease4AddressExtractor::fromAddress(addresses4[i])) !=
+                  storage4.end() ? 1 : 0);
+    }
+    report("find IPv4 lease", start, found);
+
+    found = 0;
+    start = boost::posix_time::microsec_clock::universal_time();
+    for (size_t i = 0; i < OPERATIONS; ++i) {
+        found += (storage6.find(Lease6AddressExtractor::fromAddress(addresses6[i])) !=
+                  storage6.end() ? 1 : 0);
+    }
+    report("find IPv6 lease", start, found);
+}
+
+}
+
+int
+main(int argc, char* argv[]) {
+    isc::log::initLogger("address-bench", isc::log::WARN);
+
+    std::vector<uint32_t> sizes;
+    for (int i = 1; i < argc; ++i) {
+        sizes.push_back(static_cast<uint32_t>(strtoul(argv[i], NULL, 10)));
+    }
+    if (sizes.empty()) {
+        sizes.push_back(10000);
+        sizes.push_back(100000);
+        sizes.push_back(1000000);
+    }
+
+    benchmarkAllocation();
+
+    for (std::vector<uint32_t>::const_iterator size = sizes.begin();
+         size != sizes.end(); ++size) {
+        if (*size == 0) {
+            std::cerr << "number of leases must be greater than 0"
+                      << std::endl;
+            return (EXIT_FAILURE);
+        }
+        benchmarkLookup(*size);
+    }
+
+    return (EXIT_SUCCESS);
+}
@@ -0,0 +1,190 @@
+// Copyright (C) 2017 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/// @file cfg_hosts_bench.cc
+///
+/// Measures the time of the @c CfgHosts::get4 and @c CfgHosts::get6 lookups.
+/// No configuration file is used: for each number of reservations given on
+/// the command line (10000, 100000 and 1000000 by default) the program
+/// generates the IPv4 reservations by hardware address and the IPv6
+/// reservations by DUID, all belonging to a single subnet, and adds them to
+/// a @c CfgHosts object. It then performs 1000000 lookups of each kind, by
+/// identifier and by reserved address, for randomly chosen hosts. The
+/// average time of a single lookup in nanoseconds is printed.
+
+#include <config.h>
+#include <asiolink/io_address.h>
+#include <dhcpsrv/cfg_hosts.h>
+#include <log/logger_support.h>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+using namespace isc::asiolink;
+using namespace isc::dhcp;
+
+namespace {
+
+/// @brief Identifier of the subnet holding all reservations.
+const SubnetID SUBNET_ID = 1;
+
+/// @brief Number of lookups performed for each type of the lookup.
+const size_t LOOKUPS = 1000000;
+
+/// @brief Creates an identifier for the specified host.
+///
+/// @param index Index of the host.
+/// @param len Length of the identifier.
+///
+/// @return Identifier in the binary form.
+std::vector<uint8_t>
+makeIdentifier(const uint32_t index, const size_t len) {
+    std::vector<uint8_t> id(len, 0);
+    id[len - 4] = static_cast<uint8_t>(index >> 24);
+    id[len - 3] = static_cast<uint8_t>(index >> 16);
+    id[len - 2] = static_cast<uint8_t>(index >> 8);
+    id[len - 1] = static_cast<uint8_t>(index);
+    return (id);
+}
+
+/// @brief Creates the IPv4 address reserved for the specified host.
+///
+/// @param index Index of the host.
+IOAddress
+makeAddress4(const uint32_t index) {
+    return (IOAddress(0x0A000000 + index));
+}
+
+/// @brief Creates the IPv6 address reserved for the specified host.
+///
+/// @param index Index of the host.
+IOAddress
+makeAddress6(const uint32_t index) {
+    std::vector<uint8_t> bytes = makeIdentifier(index, V6ADDRESS_LEN);
+    bytes[0] = 0x20;
+    bytes[1] = 0x01;
+    bytes[2] = 0x0d;
+    bytes[3] = 0xb8;
+    return (IOAddress::fromBytes(AF_INET6, &bytes[0]));
+}
+
+/// @brief Prints the average time of a single lookup.
+///
+/// @param name Name of the lookup.
+/// @param start Time when the lookups started.
+/// @param found Number of the hosts found.
+void
+report(const std::string& name, const boost::posix_time::ptime& start,
+       const size_t found) {
+    boost::posix_time::time_duration elapsed =
+        boost::posix_time::microsec_clock::universal_time() - start;
+    std::cout << "  " << std::left << std::setw(24) << name
+              << std::right << std::setw(10) << std::fixed
+              << std::setprecision(1)
+              << (elapsed.total_microseconds() * 1000.0 / LOOKUPS)
+              << " ns/lookup (" << found << " found)" << std::endl;
+}
+
+/// @brief Runs the benchmark for the specified number of reservations.
+///
+/// @param hosts_num Number of reservations.
+void
+benchmark(const uint32_t hosts_num) {
+    std::cout << hosts_num << " reservations:" << std::endl;
+
+    CfgHosts cfg;
+    for (uint32_t i = 0; i < hosts_num; ++i) {
+        std::vector<uint8_t> hwaddr = makeIdentifier(i, 6);
+        cfg.add(HostPtr(new Host(&hwaddr[0], hwaddr.size(), Host::IDENT_HWADDR,
+                                 SUBNET_ID, 0, makeAddress4(i))));
+
+        std::vector<uint8_t> duid = makeIdentifier(i, 10);
+        HostPtr host(new Host(&duid[0], duid.size(), Host::IDENT_DUID,
+                              0, SUBNET_ID, IOAddress::IPV4_ZERO_ADDRESS()));
+        host->addReservation(IPv6Resrv(IPv6Resrv::TYPE_NA, makeAddress6(i)));
+        cfg.add(host);
+    }
+
+    // Look up the hosts in a random order, so as the results are not
+    // skewed by the CPU cache.
+    std::vector<uint32_t> indexes(LOOKUPS);
+    for (size_t i = 0; i < LOOKUPS; ++i) {
+        indexes[i] = static_cast<uint32_t>(random()) % hosts_num;
+    }
+    std::vector<std::vector<uint8_t> > hwaddrs(LOOKUPS);
+    std::vector<std::vector<uint8_t> > duids(LOOKUPS);
+    std::vector<IOAddress> addresses4(LOOKUPS, IOAddress::IPV4_ZERO_ADDRESS());
+    std::vector<IOAddress> addresses6(LOOKUPS, IOAddress::IPV6_ZERO_ADDRESS());
+    for (size_t i = 0; i < LOOKUPS; ++i) {
+        hwaddrs[i] = makeIdentifier(indexes[i], 6);
+        duids[i] = makeIdentifier(indexes[i], 10);
+        addresses4[i] = makeAddress4(indexes[i]);
+        addresses6[i] = makeAddress6(indexes[i]);
+    }
+
+    size_t found = 0;
+    boost::posix_time::ptime start =
+        boost::posix_time::microsec_clock::universal_time();
+    for (size_t i = 0; i < LOOKUPS; ++i) {
+        found += (cfg.get4(SUBNET_ID, Host::IDENT_HWADDR, &hwaddrs[i][0],
+                           hwaddrs[i].size()) ? 1 : 0);
+    }
+    report("get4 by hw-address", start, found);
+
+    found = 0;
+    start = boost::posix_time::microsec_clock::universal_time();
+    for (size_t i = 0; i < LOOKUPS; ++i) {
+        found += (cfg.get4(SUBNET_ID, addresses4[i]) ? 1 : 0);
+    }
+    report("get4 by address", start, found);
+
+    found = 0;
+    start = boost::posix_time::microsec_clock::universal_time();
+    for (size_t i = 0; i < LOOKUPS; ++i) {
+        found += (cfg.get6(SUBNET_ID, Host::IDENT_DUID, &duids[i][0],
+                           duids[i].size()) ? 1 : 0);
+    }
+    report("get6 by duid", start, found);
+
+    found = 0;
+    start = boost::posix_time::microsec_clock::universal_time();
+    for (size_t i = 0; i < LOOKUPS; ++i) {
+        found += (cfg.get6(SUBNET_ID, addresses6[i]) ? 1 : 0);
+    }
+    report("get6 by address", start, found);
+}
+
+}
+
+int
+main(int argc, char* argv[]) {
+    isc::log::initLogger("cfg-hosts-bench", isc::log::WARN);
+
+    std::vector<uint32_t> sizes;
+    for (int i = 1; i < argc; ++i) {
+        sizes.push_back(static_cast<uint32_t>(strtoul(argv[i], NULL, 10)));
+    }
+    if (sizes.empty()) {
+        sizes.push_back(10000);
+        sizes.push_back(100000);
+        sizes.push_back(1000000);
+    }
+
+    for (std::vector<uint32_t>::const_iterator size = sizes.begin();
+         size != sizes.end(); ++size) {
+        if (*size == 0) {
+            std::cerr << "number of reservations must be greater than 0"
+                      << std::endl;
+            return (EXIT_FAILURE);
+        }
+        benchmark(*size);
+    }
+
+    return (EXIT_SUCCESS);
+}
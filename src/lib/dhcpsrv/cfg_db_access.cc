@@ -1,4 +1,4 @@
-// Copyright (C) 2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2016-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -33,9 +33,20 @@ CfgDbAccess::getHostDbAccessString() const {
 
 void
 CfgDbAccess::createManagers() const {
-    // Recreate lease manager.
-    LeaseMgrFactory::destroy();
-    LeaseMgrFactory::create(getLeaseDbAccessString());
+    // Recreate lease manager only if the access string has changed.
+    // Recreating the lease manager is expensive, e.g. the Memfile backend
+    // reloads all leases from the lease file.
+    std::string lease_db_access = getLeaseDbAccessString();
+    if (LeaseMgrFactory::haveInstance() &&
+        (LeaseMgrFactory::getDbAccessString() == lease_db_access)) {
+        // The server has unregistered all timers prior to the
+        // reconfiguration, so the backend must install them again.
+        LeaseMgrFactory::instance().reinstallTimers();
+
+    } else {
+        LeaseMgrFactory::destroy();
+        LeaseMgrFactory::create(lease_db_access);
+    }
 
     // Recreate host data source.
     HostDataSourceFactory::destroy();
@@ -1,4 +1,4 @@
-// Copyright (C) 2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2016-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -61,6 +61,9 @@ public:
 
     /// @brief Creates instance of lease manager and host data source
     /// according to the configuration specified.
+    ///
+    /// The existing lease manager instance is preserved if it has been
+    /// created using the same lease database access string.
     void createManagers() const;
 
 private:
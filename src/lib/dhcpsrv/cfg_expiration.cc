@@ -1,4 +1,4 @@
-// Copyright (C) 2015 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -46,7 +46,7 @@ CfgExpiration::CfgExpiration(const bool test_mode)
       max_reclaim_leases_(DEFAULT_MAX_RECLAIM_LEASES),
       max_reclaim_time_(DEFAULT_MAX_RECLAIM_TIME),
       unwarned_reclaim_cycles_(DEFAULT_UNWARNED_RECLAIM_CYCLES),
-      timer_mgr_(TimerMgr::instance()),
+      reclaim_thread_(false), timer_mgr_(TimerMgr::instance()),
       test_mode_(test_mode) {
 }
 
@@ -1,4 +1,4 @@
-// Copyright (C) 2015 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -54,6 +54,10 @@ namespace dhcp {
 ///   there are still expired leases in the database. If this value is 0,
 ///   the warning is never issued.
 ///
+/// - reclaim-thread - indicates if the expired leases should be reclaimed
+///   by the @c LeaseReclamationWorker thread rather than by the timers
+///   run by the main thread.
+///
 /// The @c CfgExpiration class provides a collection of accessors and
 /// modifiers to manage the data. Each accessor checks if the given value
 /// is in range allowed for this value.
@@ -187,6 +191,25 @@ public:
     /// @param unwarned_reclaim_cycles New value.
     void setUnwarnedReclaimCycles(const int64_t unwarned_reclaim_cycles);
 
+    /// @brief Returns reclaim-thread.
+    bool getReclaimThread() const {
+        return (reclaim_thread_);
+    }
+
+    /// @brief Sets reclaim-thread.
+    ///
+    /// @param reclaim_thread New value.
+    void setReclaimThread(const bool reclaim_thread) {
+        reclaim_thread_ = reclaim_thread;
+    }
+
+    /// @brief Indicates if the instance is in the test mode.
+    ///
+    /// In the test mode the intervals are expressed in milliseconds.
+    bool getTestMode() const {
+        return (test_mode_);
+    }
+
     /// @brief Setup timers for the reclamation of expired leases according
     /// to the configuration parameters.
     ///
@@ -256,6 +279,9 @@ private:
     /// @brief unwarned-reclaim-cycles.
     uint16_t unwarned_reclaim_cycles_;
 
+    /// @brief reclaim-thread.
+    bool reclaim_thread_;
+
     /// @brief Pointer to the instance of the Timer Manager.
     TimerMgrPtr timer_mgr_;
 
@@ -1,4 +1,4 @@
-// Copyright (C) 2014-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2014-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -8,10 +8,38 @@
 #include <dhcpsrv/cfg_hosts.h>
 #include <dhcpsrv/hosts_log.h>
 #include <exceptions/exceptions.h>
+#include <algorithm>
 #include <ostream>
 
 using namespace isc::asiolink;
 
+namespace {
+
+/// @brief Orders hosts by the IPv4 and IPv6 subnet identifiers.
+///
+/// The hashed index of the @c HostContainer doesn't preserve the order in
+/// which hosts having the same identifier were added. This functor is used
+/// to return such hosts in a deterministic order.
+struct HostSubnetIdLess {
+
+    /// @brief Compares two hosts.
+    ///
+    /// @param host1 First host.
+    /// @param host2 Second host.
+    ///
+    /// @return true if the first host belongs to the subnet with a lower
+    /// identifier than the second host.
+    template<typename HostPointer>
+    bool operator()(const HostPointer& host1, const HostPointer& host2) const {
+        if (host1->getIPv4SubnetID() != host2->getIPv4SubnetID()) {
+            return (host1->getIPv4SubnetID() < host2->getIPv4SubnetID());
+        }
+        return (host1->getIPv6SubnetID() < host2->getIPv6SubnetID());
+    }
+};
+
+}
+
 namespace isc {
 namespace dhcp {
 
@@ -92,6 +120,34 @@ CfgHosts::getAll6(const IOAddress& address) {
     return (collection);
 }
 
+ConstHostCollection
+CfgHosts::getAll4(const SubnetID& subnet_id) const {
+    ConstHostCollection collection;
+    getAllInternalSubnet<ConstHostCollection>(subnet_id, false, collection);
+    return (collection);
+}
+
+HostCollection
+CfgHosts::getAll4(const SubnetID& subnet_id) {
+    HostCollection collection;
+    getAllInternalSubnet<HostCollection>(subnet_id, false, collection);
+    return (collection);
+}
+
+ConstHostCollection
+CfgHosts::getAll6(const SubnetID& subnet_id) const {
+    ConstHostCollection collection;
+    getAllInternalSubnet<ConstHostCollection>(subnet_id, true, collection);
+    return (collection);
+}
+
+HostCollection
+CfgHosts::getAll6(const SubnetID& subnet_id) {
+    HostCollection collection;
+    getAllInternalSubnet<HostCollection>(subnet_id, true, collection);
+    return (collection);
+}
+
 template<typename Storage>
 void
 CfgHosts::getAllInternal(const Host::IdentifierType& identifier_type,
@@ -100,23 +156,27 @@ CfgHosts::getAllInternal(const Host::IdentifierType& identifier_type,
                          Storage& storage) const {
 
     // Convert host identifier into textual format for logging purposes.
-    // This conversion is exception free.
-    std::string identifier_text = Host::getIdentifierAsText(identifier_type,
-                                                            identifier,
-                                                            identifier_len);
+    // This conversion is exception free. It is skipped when debug logging
+    // is disabled because this method is called for each processed packet.
+    // All messages logged below use HOSTS_DBG_TRACE or higher debug level.
+    std::string identifier_text;
+    if (hosts_logger.isDebugEnabled(HOSTS_DBG_TRACE)) {
+        identifier_text = Host::getIdentifierAsText(identifier_type, identifier,
+                                                    identifier_len);
+    }
     LOG_DEBUG(hosts_logger, HOSTS_DBG_TRACE, HOSTS_CFG_GET_ALL_IDENTIFIER)
         .arg(identifier_text);
 
-    // Use the identifier and identifier type as a composite key.
+    // Use the identifier and identifier type as a key. The key refers to
+    // the caller's buffer, so the identifier is not copied.
     const HostContainerIndex0& idx = hosts_.get<0>();
-    boost::tuple<const std::vector<uint8_t>, const Host::IdentifierType> t =
-        boost::make_tuple(std::vector<uint8_t>(identifier,
-                                               identifier + identifier_len),
-                                               identifier_type);
 
     // Append each Host object to the storage.
-    for (HostContainerIndex0::iterator host = idx.lower_bound(t);
-         host != idx.upper_bound(t);
+    const size_t initial_size = storage.size();
+    HostContainerIndex0Range r =
+        idx.equal_range(HostIdentifierKey(identifier, identifier_len,
+                                          identifier_type));
+    for (HostContainerIndex0::iterator host = r.first; host != r.second;
          ++host) {
         LOG_DEBUG(hosts_logger, HOSTS_DBG_TRACE_DETAIL_DATA,
                   HOSTS_CFG_GET_ALL_IDENTIFIER_HOST)
@@ -124,6 +184,7 @@ CfgHosts::getAllInternal(const Host::IdentifierType& identifier_type,
             .arg((*host)->toText());
         storage.push_back(*host);
     }
+    std::sort(storage.begin() + initial_size, storage.end(), HostSubnetIdLess());
 
     // Log how many hosts have been found.
     LOG_DEBUG(hosts_logger, HOSTS_DBG_RESULTS, HOSTS_CFG_GET_ALL_IDENTIFIER_COUNT)
@@ -209,6 +270,31 @@ CfgHosts::getAllInternal6(const IOAddress& address, Storage& storage) const {
         .arg(storage.size());
 }
 
+template<typename Storage>
+void
+CfgHosts::getAllInternalSubnet(const SubnetID& subnet_id, const bool subnet6,
+                               Storage& storage) const {
+    LOG_DEBUG(hosts_logger, HOSTS_DBG_TRACE, HOSTS_CFG_GET_ALL_SUBNET_ID)
+        .arg(subnet6 ? "IPv6" : "IPv4")
+        .arg(subnet_id);
+
+    if (subnet6) {
+        const HostContainerIndex3& idx = hosts_.get<3>();
+        HostContainerIndex3Range r = idx.equal_range(subnet_id);
+        storage.insert(storage.end(), r.first, r.second);
+
+    } else {
+        const HostContainerIndex2& idx = hosts_.get<2>();
+        HostContainerIndex2Range r = idx.equal_range(subnet_id);
+        storage.insert(storage.end(), r.first, r.second);
+    }
+
+    LOG_DEBUG(hosts_logger, HOSTS_DBG_RESULTS, HOSTS_CFG_GET_ALL_SUBNET_ID_COUNT)
+        .arg(subnet6 ? "IPv6" : "IPv4")
+        .arg(subnet_id)
+        .arg(storage.size());
+}
+
 ConstHostPtr
 CfgHosts::get4(const SubnetID& subnet_id, const HWAddrPtr& hwaddr,
                const DuidPtr& duid) const {
@@ -414,8 +500,7 @@ CfgHosts::getHostInternal6(const asiolink::IOAddress& prefix,
 
     // Let's get all reservations that match subnet_id, address.
     const HostContainer6Index0& idx = hosts6_.get<0>();
-    HostContainer6Index0Range r = make_pair(idx.lower_bound(prefix),
-                                            idx.upper_bound(prefix));
+    HostContainer6Index0Range r = idx.equal_range(prefix);
     for (HostContainer6Index0::iterator resrv = r.first; resrv != r.second;
          ++resrv) {
         if (resrv->resrv_.getPrefixLen() == prefix_len) {
@@ -451,8 +536,8 @@ CfgHosts::getAllInternal6(const SubnetID& subnet_id,
 
     // Let's get all reservations that match subnet_id, address.
     const HostContainer6Index1& idx = hosts6_.get<1>();
-    HostContainer6Index1Range r = make_pair(idx.lower_bound(boost::make_tuple(subnet_id, address)),
-                                            idx.upper_bound(boost::make_tuple(subnet_id, address)));
+    HostContainer6Index1Range r =
+        idx.equal_range(boost::make_tuple(subnet_id, address));
 
     // For each IPv6 reservation, add the host to the results list. Fortunately,
     // in all sane cases, there will be only one such host. (Each host can have
@@ -562,7 +647,68 @@ CfgHosts::add(const HostPtr& host) {
 
     add4(host);
 
-    add6(host);
+    try {
+        add6(host);
+
+    } catch (...) {
+        // Remove what has been added for this host so far, so as the
+        // collections remain consistent.
+        delInternal(host);
+        throw;
+    }
+}
+
+bool
+CfgHosts::del(const SubnetID& subnet_id, const asiolink::IOAddress& addr) {
+    LOG_DEBUG(hosts_logger, HOSTS_DBG_TRACE, HOSTS_CFG_DEL)
+        .arg(subnet_id).arg(addr.toText());
+
+    HostPtr host;
+    if (addr.isV4()) {
+        HostCollection hosts = getAll4(addr);
+        for (HostCollection::const_iterator host_it = hosts.begin();
+             host_it != hosts.end(); ++host_it) {
+            if ((*host_it)->getIPv4SubnetID() == subnet_id) {
+                host = *host_it;
+                break;
+            }
+        }
+
+    } else {
+        host = get6(subnet_id, addr);
+    }
+
+    return (host && delInternal(host));
+}
+
+bool
+CfgHosts::del4(const SubnetID& subnet_id,
+               const Host::IdentifierType& identifier_type,
+               const uint8_t* identifier_begin,
+               const size_t identifier_len) {
+    LOG_DEBUG(hosts_logger, HOSTS_DBG_TRACE, HOSTS_CFG_DEL4)
+        .arg(subnet_id)
+        .arg(Host::getIdentifierAsText(identifier_type, identifier_begin,
+                                       identifier_len));
+
+    HostPtr host = getHostInternal(subnet_id, false, identifier_type,
+                                   identifier_begin, identifier_len);
+    return (host && delInternal(host));
+}
+
+bool
+CfgHosts::del6(const SubnetID& subnet_id,
+               const Host::IdentifierType& identifier_type,
+               const uint8_t* identifier_begin,
+               const size_t identifier_len) {
+    LOG_DEBUG(hosts_logger, HOSTS_DBG_TRACE, HOSTS_CFG_DEL6)
+        .arg(subnet_id)
+        .arg(Host::getIdentifierAsText(identifier_type, identifier_begin,
+                                       identifier_len));
+
+    HostPtr host = getHostInternal(subnet_id, true, identifier_type,
+                                   identifier_begin, identifier_len);
+    return (host && delInternal(host));
 }
 
 void
@@ -667,5 +813,41 @@ CfgHosts::add6(const HostPtr& host) {
     }
 }
 
+bool
+CfgHosts::delInternal(const HostPtr& host) {
+    bool deleted = false;
+
+    // Remove the host from the main collection. There may be multiple
+    // hosts using the same identifier, so we have to find this particular
+    // instance.
+    HostContainerIndex0& idx = hosts_.get<0>();
+    HostContainerIndex0Range r =
+        idx.equal_range(HostIdentifierKeyExtractor()(*host));
+    for (HostContainerIndex0::iterator host_it = r.first;
+         host_it != r.second; ++host_it) {
+        if (*host_it == host) {
+            idx.erase(host_it);
+            deleted = true;
+            break;
+        }
+    }
+
+    // Remove (address, host) tuples for all IPv6 reservations of this host.
+    HostContainer6Index1& idx6 = hosts6_.get<1>();
+    IPv6ResrvRange reservations = host->getIPv6Reservations();
+    for (IPv6ResrvIterator resrv = reservations.first;
+         resrv != reservations.second; ++resrv) {
+        HostContainer6Index1::iterator resrv_it =
+            idx6.find(boost::make_tuple(host->getIPv6SubnetID(),
+                                        resrv->second.getPrefix()));
+        if ((resrv_it != idx6.end()) && (resrv_it->host_ == host)) {
+            idx6.erase(resrv_it);
+            deleted = true;
+        }
+    }
+
+    return (deleted);
+}
+
 } // end of namespace isc::dhcp
 } // end of namespace isc
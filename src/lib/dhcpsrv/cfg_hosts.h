@@ -1,4 +1,4 @@
-// Copyright (C) 2014-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2014-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -147,6 +147,38 @@ public:
     virtual HostCollection
     getAll6(const asiolink::IOAddress& address);
 
+    /// @brief Returns a collection of hosts connected to the IPv4 subnet.
+    ///
+    /// @param subnet_id IPv4 subnet identifier.
+    ///
+    /// @return Collection of const @c Host objects.
+    virtual ConstHostCollection
+    getAll4(const SubnetID& subnet_id) const;
+
+    /// @brief Returns a collection of hosts connected to the IPv4 subnet.
+    ///
+    /// @param subnet_id IPv4 subnet identifier.
+    ///
+    /// @return Collection of non-const @c Host objects.
+    virtual HostCollection
+    getAll4(const SubnetID& subnet_id);
+
+    /// @brief Returns a collection of hosts connected to the IPv6 subnet.
+    ///
+    /// @param subnet_id IPv6 subnet identifier.
+    ///
+    /// @return Collection of const @c Host objects.
+    virtual ConstHostCollection
+    getAll6(const SubnetID& subnet_id) const;
+
+    /// @brief Returns a collection of hosts connected to the IPv6 subnet.
+    ///
+    /// @param subnet_id IPv6 subnet identifier.
+    ///
+    /// @return Collection of non-const @c Host objects.
+    virtual HostCollection
+    getAll6(const SubnetID& subnet_id);
+
     /// @brief Returns a host connected to the IPv4 subnet and matching
     /// specified identifiers.
     ///
@@ -320,6 +352,48 @@ public:
     /// has already been added to the IPv4 or IPv6 subnet.
     virtual void add(const HostPtr& host);
 
+    /// @brief Attempts to delete a host by (subnet-id, address).
+    ///
+    /// This method supports both v4 and v6. The host is removed from all
+    /// indexes of the configuration, including the index of the IPv6
+    /// reservations.
+    ///
+    /// @param subnet_id subnet identifier.
+    /// @param addr specified address.
+    ///
+    /// @return true if the host was deleted, false if it was not found.
+    virtual bool del(const SubnetID& subnet_id, const asiolink::IOAddress& addr);
+
+    /// @brief Attempts to delete a host by (subnet4-id, identifier type,
+    /// identifier).
+    ///
+    /// @param subnet_id IPv4 subnet identifier.
+    /// @param identifier_type Identifier type.
+    /// @param identifier_begin Pointer to a begining of a buffer containing
+    /// an identifier.
+    /// @param identifier_len Identifier length.
+    ///
+    /// @return true if the host was deleted, false if it was not found.
+    virtual bool del4(const SubnetID& subnet_id,
+                      const Host::IdentifierType& identifier_type,
+                      const uint8_t* identifier_begin,
+                      const size_t identifier_len);
+
+    /// @brief Attempts to delete a host by (subnet6-id, identifier type,
+    /// identifier).
+    ///
+    /// @param subnet_id IPv6 subnet identifier.
+    /// @param identifier_type Identifier type.
+    /// @param identifier_begin Pointer to a begining of a buffer containing
+    /// an identifier.
+    /// @param identifier_len Identifier length.
+    ///
+    /// @return true if the host was deleted, false if it was not found.
+    virtual bool del6(const SubnetID& subnet_id,
+                      const Host::IdentifierType& identifier_type,
+                      const uint8_t* identifier_begin,
+                      const size_t identifier_len);
+
     /// @brief Return backend type
     ///
     /// Returns the type of the backend (e.g. "mysql", "memfile" etc.)
@@ -335,7 +409,8 @@ private:
     ///
     /// This private method is called by the @c CfgHosts::getAllInternal
     /// method which finds the @c Host objects using specified identifier.
-    /// The retrieved objects are appended to the @c storage container.
+    /// The retrieved objects are appended to the @c storage container,
+    /// ordered by the IPv4 and IPv6 subnet identifiers.
     ///
     /// @param identifier_type The type of the supplied identifier.
     /// @param identifier Pointer to a first byte of the identifier.
@@ -394,6 +469,23 @@ private:
     void getAllInternal6(const asiolink::IOAddress& address,
                          Storage& storage) const;
 
+    /// @brief Returns @c Host objects connected to the specified subnet.
+    ///
+    /// This private method is called by the @c CfgHosts::getAll4 and
+    /// @c CfgHosts::getAll6 methods to retrieve all @c Host objects
+    /// connected to the IPv4 or IPv6 subnet. The retrieved objects are
+    /// appended to the @c storage container.
+    ///
+    /// @param subnet_id IPv4 or IPv6 subnet identifier.
+    /// @param subnet6 A boolean flag which indicates if the subnet identifier
+    /// points to a IPv4 (if false) or IPv6 subnet (if true).
+    /// @param [out] storage Container to which the retrieved objects are
+    /// appended.
+    /// @tparam One of the @c ConstHostCollection or @c HostCollection.
+    template<typename Storage>
+    void getAllInternalSubnet(const SubnetID& subnet_id, const bool subnet6,
+                              Storage& storage) const;
+
 
     /// @brief Returns @c Host objects for the specified (Subnet-id,IPv6 address) tuple.
     ///
@@ -477,6 +569,16 @@ private:
     /// the IPv6 subnet.
     virtual void add6(const HostPtr& host);
 
+    /// @brief Removes the specified host from the v4 and v6 collections.
+    ///
+    /// This is an internal method called by public @ref del methods and
+    /// by @ref add to remove a partially added host.
+    ///
+    /// @param host Pointer to the @c Host object held in the collections.
+    ///
+    /// @return true if the host has been found and removed.
+    bool delInternal(const HostPtr& host);
+
     /// @brief Multi-index container holding @c Host objects.
     ///
     /// It can be used for finding hosts by the following criteria:
@@ -1,4 +1,4 @@
-// Copyright (C) 2014-2015 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2014-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -70,8 +70,9 @@ CfgIface::openSockets(const uint16_t family, const uint16_t port,
     // sockets. However, this may be unsupported on some operating
     // systems, so there is no guarantee.
     if ((family == AF_INET) && (!IfaceMgr::instance().isTestMode())) {
-        iface_mgr.setMatchingPacketFilter(socket_type_ == SOCKET_RAW);
-        if ((socket_type_ == SOCKET_RAW) &&
+        iface_mgr.setMatchingPacketFilter(socket_type_ != SOCKET_UDP,
+                                          socket_type_ == SOCKET_RAW_MMAP);
+        if ((socket_type_ != SOCKET_UDP) &&
             !iface_mgr.isDirectResponseSupported()) {
             LOG_WARN(dhcpsrv_logger, DHCPSRV_CFGMGR_SOCKET_RAW_UNSUPPORTED);
         }
@@ -132,7 +133,7 @@ CfgIface::openSockets(const uint16_t family, const uint16_t port,
     if (family == AF_INET) {
         // Use broadcast only if we're using raw sockets. For the UDP sockets,
         // we only handle the relayed (unicast) traffic.
-        const bool can_use_bcast = use_bcast && (socket_type_ == SOCKET_RAW);
+        const bool can_use_bcast = use_bcast && (socket_type_ != SOCKET_UDP);
         // Opening multiple raw sockets handling brodcast traffic on the single
         // interface may lead to processing the same message multiple times.
         // We don't prohibit such configuration because raw sockets can as well
@@ -204,6 +205,9 @@ CfgIface::socketTypeToText() const {
     case SOCKET_UDP:
         return ("udp");
 
+    case SOCKET_RAW_MMAP:
+        return ("raw-mmap");
+
     default:
         ;
     }
@@ -219,6 +223,9 @@ CfgIface::textToSocketType(const std::string& socket_type_name) const {
     } else if (socket_type_name == "raw") {
         return (SOCKET_RAW);
 
+    } else if (socket_type_name == "raw-mmap") {
+        return (SOCKET_RAW_MMAP);
+
     } else {
         isc_throw(InvalidSocketType, "unsupported socket type '"
                   << socket_type_name << "'");
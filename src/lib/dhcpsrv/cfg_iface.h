@@ -1,4 +1,4 @@
-// Copyright (C) 2014-2015 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2014-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -133,7 +133,10 @@ public:
         /// Raw socket, used for direct DHCPv4 traffic.
         SOCKET_RAW,
         /// Datagram socket, i.e. IP/UDP socket.
-        SOCKET_UDP
+        SOCKET_UDP,
+        /// Raw socket using memory mapped rings to receive and send
+        /// packets, used for direct DHCPv4 traffic.
+        SOCKET_RAW_MMAP
     };
 
     /// @brief Keyword used to enable all interfaces.
@@ -198,6 +201,7 @@ public:
     /// Supported socket types for DHCPv4 are:
     /// - @c SOCKET_RAW
     /// - @c SOCKET_UDP
+    /// - @c SOCKET_RAW_MMAP
     ///
     /// @param family Address family (AF_INET or AF_INET6).
     /// @param socket_type Socket type.
@@ -213,6 +217,7 @@ public:
     /// can be passed in the @c socket_type parameter:
     /// - raw - for raw sockets,
     /// - udp - for the IP/UDP datagram sockets,
+    /// - raw-mmap - for raw sockets using memory mapped rings,
     ///
     /// @param family Address family (AF_INET or AF_INET6)
     /// @param socket_type_name Socket type in the textual format.
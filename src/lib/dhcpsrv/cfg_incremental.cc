@@ -0,0 +1,141 @@
+// Copyright (C) 2017 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <dhcpsrv/cfg_incremental.h>
+#include <boost/foreach.hpp>
+#include <string>
+
+using namespace isc::data;
+
+namespace {
+
+/// @brief Name of the subnet parameter holding host reservations.
+const std::string RESERVATIONS = "reservations";
+
+/// @brief Compares two maps excluding host reservations.
+///
+/// @param first First map.
+/// @param second Second map.
+///
+/// @return true if the maps hold equal values for all keys other than
+/// "reservations".
+bool
+equalsExceptReservations(const ConstElementPtr& first,
+                         const ConstElementPtr& second) {
+    const std::map<std::string, ConstElementPtr>& first_map = first->mapValue();
+    const std::map<std::string, ConstElementPtr>& second_map = second->mapValue();
+
+    // Both maps are sorted by keys, so they can be walked in parallel.
+    std::map<std::string, ConstElementPtr>::const_iterator it1 = first_map.begin();
+    std::map<std::string, ConstElementPtr>::const_iterator it2 = second_map.begin();
+    for (;;) {
+        if ((it1 != first_map.end()) && (it1->first == RESERVATIONS)) {
+            ++it1;
+        }
+        if ((it2 != second_map.end()) && (it2->first == RESERVATIONS)) {
+            ++it2;
+        }
+        if ((it1 == first_map.end()) || (it2 == second_map.end())) {
+            break;
+        }
+        if ((it1->first != it2->first) || !it1->second->equals(*it2->second)) {
+            return (false);
+        }
+        ++it1;
+        ++it2;
+    }
+    return ((it1 == first_map.end()) && (it2 == second_map.end()));
+}
+
+}
+
+namespace isc {
+namespace dhcp {
+
+CfgIncremental::CfgIncremental()
+    : inherited_(), subnets_() {
+}
+
+void
+CfgIncremental::setInheritedParameters(const ConstElementPtr& global_cfg,
+                                       const ParamsList& names) {
+    ElementPtr inherited = Element::createMap();
+    BOOST_FOREACH(std::string name, names) {
+        ConstElementPtr value = global_cfg->get(name);
+        if (value) {
+            inherited->set(name, value);
+        }
+    }
+    inherited_ = inherited;
+}
+
+bool
+CfgIncremental::inheritedEquals(const CfgIncremental& other) const {
+    return (inherited_ && other.inherited_ &&
+            inherited_->equals(*other.inherited_));
+}
+
+void
+CfgIncremental::addSubnet(const ConstElementPtr& subnet_cfg) {
+    SubnetID subnet_id = getSubnetId(subnet_cfg);
+    if (subnet_id != 0) {
+        subnets_[subnet_id] = subnet_cfg;
+    }
+}
+
+void
+CfgIncremental::removeSubnet(const SubnetID& subnet_id) {
+    subnets_.erase(subnet_id);
+}
+
+bool
+CfgIncremental::subnetEquals(const ConstElementPtr& subnet_cfg) const {
+    ConstElementPtr remembered = getSubnet(subnet_cfg);
+    return (remembered && equalsExceptReservations(remembered, subnet_cfg));
+}
+
+bool
+CfgIncremental::reservationsEqual(const ConstElementPtr& subnet_cfg) const {
+    ConstElementPtr remembered = getSubnet(subnet_cfg);
+    if (!remembered) {
+        return (false);
+    }
+    ConstElementPtr remembered_reservations = remembered->get(RESERVATIONS);
+    ConstElementPtr reservations = subnet_cfg->get(RESERVATIONS);
+    if (!remembered_reservations || !reservations) {
+        return (!remembered_reservations && !reservations);
+    }
+    return (remembered_reservations->equals(*reservations));
+}
+
+SubnetID
+CfgIncremental::getSubnetId(const ConstElementPtr& subnet_cfg) {
+    if (!subnet_cfg || (subnet_cfg->getType() != Element::map)) {
+        return (0);
+    }
+    ConstElementPtr id = subnet_cfg->get("id");
+    if (!id || (id->getType() != Element::integer) || (id->intValue() <= 0)) {
+        return (0);
+    }
+    return (static_cast<SubnetID>(id->intValue()));
+}
+
+ConstElementPtr
+CfgIncremental::getSubnet(const ConstElementPtr& subnet_cfg) const {
+    SubnetID subnet_id = getSubnetId(subnet_cfg);
+    if (subnet_id != 0) {
+        std::map<SubnetID, ConstElementPtr>::const_iterator subnet =
+            subnets_.find(subnet_id);
+        if (subnet != subnets_.end()) {
+            return (subnet->second);
+        }
+    }
+    return (ConstElementPtr());
+}
+
+}
+}
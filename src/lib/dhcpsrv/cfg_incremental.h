@@ -0,0 +1,142 @@
+// Copyright (C) 2017 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef CFG_INCREMENTAL_H
+#define CFG_INCREMENTAL_H
+
+#include <cc/data.h>
+#include <cc/simple_parser.h>
+#include <dhcpsrv/subnet_id.h>
+#include <boost/shared_ptr.hpp>
+#include <map>
+
+namespace isc {
+namespace dhcp {
+
+/// @brief Holds the configuration elements from which the subnets of
+/// the server configuration have been created.
+///
+/// Parsing the complete list of subnets and host reservations is
+/// expensive for large configurations. When the server is reconfigured,
+/// most of the subnets are typically left unchanged. This class remembers
+/// the configuration elements of the subnets and of the global parameters
+/// inherited by the subnets, so as the parsers can determine which subnets
+/// and host reservations of the current configuration may be reused in the
+/// new configuration, rather than created from scratch.
+///
+/// Only the subnets for which the identifier has been explicitly specified
+/// are remembered. The autogenerated identifiers depend on the position
+/// of the subnet on the list, so such subnets can't be reliably matched
+/// with the subnets in the new configuration.
+class CfgIncremental {
+public:
+
+    /// @brief Constructor.
+    CfgIncremental();
+
+    /// @brief Remembers the global parameters inherited by the subnets.
+    ///
+    /// @param global_cfg Global configuration map.
+    /// @param names Names of the global parameters which are inherited by
+    /// the subnets, i.e. which affect the result of parsing a subnet.
+    void setInheritedParameters(const data::ConstElementPtr& global_cfg,
+                                const data::ParamsList& names);
+
+    /// @brief Checks if the inherited global parameters are equal to those
+    /// remembered in other configuration.
+    ///
+    /// @param other Other configuration, typically the current one.
+    ///
+    /// @return true if the inherited global parameters have been specified
+    /// for both configurations and are equal, false otherwise.
+    bool inheritedEquals(const CfgIncremental& other) const;
+
+    /// @brief Remembers the configuration of a subnet.
+    ///
+    /// This is a no-op if the subnet identifier has not been explicitly
+    /// specified.
+    ///
+    /// @param subnet_cfg Subnet configuration map.
+    void addSubnet(const data::ConstElementPtr& subnet_cfg);
+
+    /// @brief Forgets the configuration of a subnet.
+    ///
+    /// This is called when the subnet has been modified at runtime, e.g.
+    /// its host reservations have been added or deleted using the control
+    /// commands. Such a subnet is parsed from scratch during the next
+    /// reconfiguration.
+    ///
+    /// @param subnet_id Identifier of the subnet.
+    void removeSubnet(const SubnetID& subnet_id);
+
+    /// @brief Checks if the subnet configuration equals the remembered
+    /// configuration of the subnet having the same identifier.
+    ///
+    /// The host reservations are excluded from the comparison. Use
+    /// @c CfgIncremental::reservationsEqual to compare them.
+    ///
+    /// @param subnet_cfg Subnet configuration map.
+    ///
+    /// @return true if the configuration of the subnet with the same
+    /// identifier has been remembered and is equal to the specified one.
+    bool subnetEquals(const data::ConstElementPtr& subnet_cfg) const;
+
+    /// @brief Checks if the host reservations specified for the subnet
+    /// equal the remembered reservations for the subnet having the same
+    /// identifier.
+    ///
+    /// @param subnet_cfg Subnet configuration map.
+    ///
+    /// @return true if the configuration of the subnet with the same
+    /// identifier has been remembered and it comprises the same host
+    /// reservations.
+    bool reservationsEqual(const data::ConstElementPtr& subnet_cfg) const;
+
+    /// @brief Returns the number of remembered subnets.
+    size_t getSubnetsCount() const {
+        return (subnets_.size());
+    }
+
+    /// @brief Returns the identifier explicitly specified for a subnet.
+    ///
+    /// @param subnet_cfg Subnet configuration map.
+    ///
+    /// @return Subnet identifier or 0 if the identifier hasn't been
+    /// specified, which means that it will be autogenerated.
+    static SubnetID getSubnetId(const data::ConstElementPtr& subnet_cfg);
+
+private:
+
+    /// @brief Returns remembered configuration of a subnet.
+    ///
+    /// @param subnet_cfg Configuration of the subnet having the same
+    /// identifier as the subnet to be returned.
+    ///
+    /// @return Pointer to the remembered configuration or NULL if not found.
+    data::ConstElementPtr getSubnet(const data::ConstElementPtr& subnet_cfg) const;
+
+    /// @brief Global parameters inherited by the subnets.
+    data::ConstElementPtr inherited_;
+
+    /// @brief Configurations of the subnets indexed by subnet identifiers.
+    std::map<SubnetID, data::ConstElementPtr> subnets_;
+
+};
+
+/// @name Pointers to the @c CfgIncremental objects.
+//@{
+/// @brief Pointer to the Non-const object.
+typedef boost::shared_ptr<CfgIncremental> CfgIncrementalPtr;
+
+/// @brief Pointer to the const object.
+typedef boost::shared_ptr<const CfgIncremental> ConstCfgIncrementalPtr;
+
+//@}
+
+}
+}
+
+#endif // CFG_INCREMENTAL_H
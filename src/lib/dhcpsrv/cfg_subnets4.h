@@ -1,4 +1,4 @@
-// Copyright (C) 2014-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2014-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -47,6 +47,13 @@ public:
         return (&subnets_);
     }
 
+    /// @brief Returns the subnet with the specified identifier.
+    ///
+    /// @param subnet_id Identifier of the subnet.
+    ///
+    /// @return Pointer to the subnet or NULL if there is no such subnet.
+    Subnet4Ptr getBySubnetId(const SubnetID& subnet_id) const;
+
     /// @brief Returns a pointer to the selected subnet.
     ///
     /// This method tries to retrieve the subnet for the client using various
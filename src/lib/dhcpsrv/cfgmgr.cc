@@ -200,6 +200,18 @@ CfgMgr::getCurrentCfg() {
     return (configuration_);
 }
 
+CfgHostsPtr
+CfgMgr::getCurrentCfgHosts() {
+    ensureCurrentAllocated();
+    return (configuration_->getCfgHosts());
+}
+
+CfgIncrementalPtr
+CfgMgr::getCurrentCfgIncremental() {
+    ensureCurrentAllocated();
+    return (configuration_->getCfgIncremental());
+}
+
 SrvConfigPtr
 CfgMgr::getStagingCfg() {
     ensureCurrentAllocated();
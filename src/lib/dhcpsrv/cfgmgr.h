@@ -255,6 +255,31 @@ public:
     /// @return Non-null const pointer to the current configuration.
     ConstSrvConfigPtr getCurrentCfg();
 
+    /// @brief Returns a pointer to the host reservations held in the
+    /// current configuration.
+    ///
+    /// In contrast to the other parts of the current configuration, the
+    /// host reservations may be modified while the server is running,
+    /// i.e. when host reservations are added or deleted using the control
+    /// commands. This function returns non-const pointer to the host
+    /// reservations, so as they can be modified in place, without the
+    /// need to reconfigure the server.
+    ///
+    /// @return Non-null pointer to the host reservations in the current
+    /// configuration.
+    CfgHostsPtr getCurrentCfgHosts();
+
+    /// @brief Returns a pointer to the subnet configurations remembered
+    /// for the current configuration.
+    ///
+    /// When the host reservations of a subnet are modified at runtime, the
+    /// remembered configuration of this subnet no longer reflects the state
+    /// of the server and must be discarded, so as the subnet is not reused
+    /// during the next reconfiguration.
+    ///
+    /// @return Non-null pointer to the remembered subnet configurations.
+    CfgIncrementalPtr getCurrentCfgIncremental();
+
     /// @brief Returns a pointer to the staging configuration.
     ///
     /// The staging configuration is used by the configuration parsers to
@@ -1596,6 +1596,30 @@ CqlLeaseMgr::getExpiredLeases4(Lease4Collection& expired_leases,
     getExpiredLeasesCommon(expired_leases, max_leases, GET_LEASE4_EXPIRE);
 }
 
+Lease4Collection
+CqlLeaseMgr::getLeases4(const asiolink::IOAddress& lower_bound_address,
+                        const size_t page_size) const {
+    /// This function is currently not implemented because the leases are
+    /// partitioned by address in Cassandra, so the range queries ordered
+    /// by address would require scanning all partitions.
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_CQL_GET_PAGE4)
+        .arg(page_size).arg(lower_bound_address.toText());
+
+    isc_throw(NotImplemented, "The CqlLeaseMgr::getLeases4 function was"
+              " called, but it is not implemented");
+}
+
+Lease6Collection
+CqlLeaseMgr::getLeases6(const asiolink::IOAddress& lower_bound_address,
+                        const size_t page_size) const {
+    /// See the comment in the @c getLeases4.
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_CQL_GET_PAGE6)
+        .arg(page_size).arg(lower_bound_address.toText());
+
+    isc_throw(NotImplemented, "The CqlLeaseMgr::getLeases6 function was"
+              " called, but it is not implemented");
+}
+
 template<typename LeaseCollection>
 void
 CqlLeaseMgr::getExpiredLeasesCommon(LeaseCollection& expired_leases,
@@ -324,6 +324,28 @@ public:
     virtual void getExpiredLeases4(Lease4Collection& ,
                                    const size_t ) const;
 
+    /// @brief Returns a page of DHCPv4 leases.
+    ///
+    /// @param lower_bound_address IPv4 address used as a cursor. Leases
+    /// with addresses greater than this address are returned.
+    /// @param page_size Maximum number of leases to be returned.
+    ///
+    /// @return Collection of leases in the ascending order of addresses.
+    virtual Lease4Collection
+    getLeases4(const asiolink::IOAddress& lower_bound_address,
+               const size_t page_size) const;
+
+    /// @brief Returns a page of DHCPv6 leases.
+    ///
+    /// @param lower_bound_address IPv6 address used as a cursor. Leases
+    /// with addresses greater than this address are returned.
+    /// @param page_size Maximum number of leases to be returned.
+    ///
+    /// @return Collection of leases in the ascending order of addresses.
+    virtual Lease6Collection
+    getLeases6(const asiolink::IOAddress& lower_bound_address,
+               const size_t page_size) const;
+
     /// @brief Updates IPv4 lease.
     ///
     /// Updates the record of the lease in the database (as identified by the
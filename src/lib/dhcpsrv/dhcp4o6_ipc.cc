@@ -1,4 +1,4 @@
-// Copyright (C) 2015-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -6,29 +6,47 @@
 
 #include <config.h>
 
-#include <dhcp/dhcp6.h>
 #include <dhcp/iface_mgr.h>
-#include <dhcp/option6_addrlst.h>
-#include <dhcp/option_custom.h>
-#include <dhcp/option_string.h>
-#include <dhcp/option_vendor.h>
 #include <dhcpsrv/dhcp4o6_ipc.h>
 #include <dhcpsrv/dhcpsrv_log.h>
+#include <stats/stats_mgr.h>
+#include <util/io_utilities.h>
 
-#include <boost/pointer_cast.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
 
+#include <algorithm>
 #include <errno.h>
 #include <netinet/in.h>
+#include <sstream>
 #include <sys/fcntl.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
 #include <string>
+#include <vector>
 
 using namespace isc::asiolink;
+using namespace isc::stats;
 using namespace isc::util;
+using namespace boost::posix_time;
 using namespace std;
 
+namespace {
+
+/// @brief Returns the current time in microseconds since the epoch.
+int64_t getMicroseconds() {
+    static const ptime epoch(boost::gregorian::date(1970, 1, 1));
+    return ((microsec_clock::universal_time() - epoch).total_microseconds());
+}
+
+}
+
 namespace isc {
 namespace dhcp {
 
+const uint8_t Dhcp4o6IpcBase::HEADER_VERSION;
+const size_t Dhcp4o6IpcBase::HEADER_SIZE;
+const size_t Dhcp4o6IpcBase::RECEIVE_BATCH_SIZE;
+
 Dhcp4o6IpcBase::Dhcp4o6IpcBase() : port_(0), socket_fd_(-1) {}
 
 Dhcp4o6IpcBase::~Dhcp4o6IpcBase() {
@@ -127,84 +145,78 @@ Pkt6Ptr Dhcp4o6IpcBase::receive() {
     uint8_t buf[65536];
     ssize_t cc = recv(socket_fd_, buf, sizeof(buf), 0);
     if (cc < 0) {
+        if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+            // All queued messages have been received.
+            return (Pkt6Ptr());
+        }
         isc_throw(Dhcp4o6IpcError, "Failed to receive on DHCP4o6 socket.");
     }
-    Pkt6Ptr pkt = Pkt6Ptr(new Pkt6(buf, cc));
-    pkt->updateTimestamp();
+    const size_t length = static_cast<size_t>(cc);
 
-    // Get interface name and remote address
-    pkt->unpack();
-
-    // Vendor option is initially NULL. If we find the instance of the vendor
-    // option with the ISC enterprise id this pointer will point to it.
-    OptionVendorPtr option_vendor;
-
-    // Get all vendor option and look for the one with the ISC enterprise id.
-    OptionCollection vendor_options = pkt->getOptions(D6O_VENDOR_OPTS);
-    for (OptionCollection::const_iterator opt = vendor_options.begin();
-         opt != vendor_options.end(); ++opt) {
-        option_vendor = boost::dynamic_pointer_cast<OptionVendor>(opt->second);
-        if (option_vendor) {
-            if (option_vendor->getVendorId() == ENTERPRISE_ID_ISC) {
-                break;
-            }
-            option_vendor.reset();
-        }
+    // Check the header.
+    if (length < HEADER_SIZE) {
+        LOG_WARN(dhcpsrv_logger, DHCPSRV_DHCP4O6_RECEIVED_BAD_PACKET)
+            .arg("truncated header");
+        isc_throw(Dhcp4o6IpcError, "malformed packet (truncated header)");
     }
-         
-    // Vendor option must exist.
-    if (!option_vendor) {
+
+    if (buf[0] != HEADER_VERSION) {
+        std::ostringstream s;
+        s << "unsupported header version " << static_cast<int>(buf[0]);
         LOG_WARN(dhcpsrv_logger, DHCPSRV_DHCP4O6_RECEIVED_BAD_PACKET)
-            .arg("no ISC vendor option");
-        isc_throw(Dhcp4o6IpcError, "malformed packet (no ISC vendor option)");
+            .arg(s.str());
+        isc_throw(Dhcp4o6IpcError, "malformed packet (" << s.str() << ")");
     }
 
-    // The option carrying interface name is required.
-    OptionStringPtr ifname = boost::dynamic_pointer_cast<
-        OptionString>(option_vendor->getOption(ISC_V6_4O6_INTERFACE));
-    if (!ifname) {
+    const size_t name_len = buf[1];
+    if ((name_len == 0) || (length < HEADER_SIZE + name_len)) {
         LOG_WARN(dhcpsrv_logger, DHCPSRV_DHCP4O6_RECEIVED_BAD_PACKET)
-            .arg("no interface suboption");
+            .arg("invalid interface name length");
         isc_throw(Dhcp4o6IpcError,
-                  "malformed packet (interface suboption missing "
-                  "or has incorrect type)");
+                  "malformed packet (invalid interface name length)");
     }
 
     // Check if this interface is present in the system.
-    IfacePtr iface = IfaceMgr::instance().getIface(ifname->getValue());
+    const std::string ifname(reinterpret_cast<const char*>(buf + HEADER_SIZE),
+                             name_len);
+    IfacePtr iface = IfaceMgr::instance().getIface(ifname);
     if (!iface) {
         LOG_WARN(dhcpsrv_logger, DHCPSRV_DHCP4O6_RECEIVED_BAD_PACKET)
-            .arg("can't get interface " + ifname->getValue());
+            .arg("can't get interface " + ifname);
         isc_throw(Dhcp4o6IpcError,
-                  "malformed packet (unknown interface "
-                  + ifname->getValue() + ")");
+                  "malformed packet (unknown interface " + ifname + ")");
     }
 
-    // Get the option holding source IPv6 address.
-    OptionCustomPtr srcs = boost::dynamic_pointer_cast<
-        OptionCustom>(option_vendor->getOption(ISC_V6_4O6_SRC_ADDRESS));
-    if (!srcs) {
+    // The DHCPv6 message follows the header.
+    const size_t offset = HEADER_SIZE + name_len;
+    Pkt6Ptr pkt = Pkt6Ptr(new Pkt6(buf + offset, length - offset));
+    pkt->updateTimestamp();
+    try {
+        pkt->unpack();
+    } catch (const std::exception& ex) {
         LOG_WARN(dhcpsrv_logger, DHCPSRV_DHCP4O6_RECEIVED_BAD_PACKET)
-            .arg("no source address suboption");
-        isc_throw(Dhcp4o6IpcError,
-                  "malformed packet (source address suboption missing "
-                  "or has incorrect type)");
+            .arg(std::string("unable to unpack message: ") + ex.what());
+        isc_throw(Dhcp4o6IpcError, "malformed packet (unable to unpack "
+                  "message: " << ex.what() << ")");
     }
 
     // Update the packet.
-    pkt->setRemoteAddr(srcs->readAddress());
+    pkt->setRemoteAddr(IOAddress::fromBytes(AF_INET6, buf + 4));
     pkt->setIface(iface->getName());
     pkt->setIndex(iface->getIndex());
 
-    // Remove options that have been added by the IPC sender.
-    static_cast<void>(option_vendor->delOption(ISC_V6_4O6_INTERFACE));
-    static_cast<void>(option_vendor->delOption(ISC_V6_4O6_SRC_ADDRESS));
-
-    // If there are no more options, the IPC sender has probably created the
-    // vendor option, in which case we should remove it here.
-    if (option_vendor->getOptions().empty()) {
-        static_cast<void>(pkt->delOption(D6O_VENDOR_OPTS));
+    // Update statistics. The servers run on the same host so the send
+    // time set by the sender can be compared with the local clock.
+    const int64_t sent = (static_cast<uint64_t>(readUint32(buf + 20, 4)) << 32) |
+        readUint32(buf + 24, 4);
+    int64_t latency = getMicroseconds() - sent;
+    if (latency < 0) {
+        latency = 0;
     }
+    StatsMgr::instance().addValue("dhcp4o6-ipc-received",
+                                  static_cast<int64_t>(1));
+    StatsMgr::instance().setValue("dhcp4o6-ipc-latency",
+                                  StatsDuration(microseconds(latency)));
 
     return (pkt);
 }
@@ -223,37 +235,56 @@ void Dhcp4o6IpcBase::send(const Pkt6Ptr& pkt) {
                   " IPC socket is closed");
     }
 
-    // Check if vendor option exists.
-    OptionVendorPtr option_vendor = boost::dynamic_pointer_cast<
-        OptionVendor>(pkt->getOption(D6O_VENDOR_OPTS));
-
-    // If vendor option doesn't exist or its enterprise id is not ISC's
-    // enterprise id, let's create it.
-    if (!option_vendor ||
-        (option_vendor->getVendorId() != ENTERPRISE_ID_ISC)) {
-        option_vendor.reset(new OptionVendor(Option::V6, ENTERPRISE_ID_ISC));
-        pkt->addOption(option_vendor);
+    const std::string& ifname = pkt->getIface();
+    if (ifname.empty() || (ifname.size() > 255)) {
+        isc_throw(Dhcp4o6IpcError, "unable to send DHCP4o6 message because"
+                  " the interface name '" << ifname << "' has invalid length");
+    }
 
+    const IOAddress& remote_addr = pkt->getRemoteAddr();
+    if (!remote_addr.isV6()) {
+        isc_throw(Dhcp4o6IpcError, "unable to send DHCP4o6 message because"
+                  " the remote address " << remote_addr << " is not an IPv6"
+                  " address");
     }
 
-    // Push interface name and source address in it
-    option_vendor->addOption(OptionStringPtr(new OptionString(Option::V6,
-                                                       ISC_V6_4O6_INTERFACE,
-                                                       pkt->getIface())));
-    option_vendor->addOption(Option6AddrLstPtr(new Option6AddrLst(
-                                                       ISC_V6_4O6_SRC_ADDRESS,
-                                                       pkt->getRemoteAddr())));
+    // Build the header.
+    std::vector<uint8_t> header(HEADER_SIZE + ifname.size(), 0);
+    header[0] = HEADER_VERSION;
+    header[1] = static_cast<uint8_t>(ifname.size());
+    const std::vector<uint8_t> addr = remote_addr.toBytes();
+    std::copy(addr.begin(), addr.end(), header.begin() + 4);
+    const uint64_t now = static_cast<uint64_t>(getMicroseconds());
+    writeUint32(static_cast<uint32_t>(now >> 32), &header[20], 4);
+    writeUint32(static_cast<uint32_t>(now), &header[24], 4);
+    std::copy(ifname.begin(), ifname.end(), header.begin() + HEADER_SIZE);
+
     // Get packet content
     OutputBuffer& buf = pkt->getBuffer();
     buf.clear();
     pkt->pack();
 
+    // Send the header and the message in one datagram without copying
+    // them into a single buffer.
+    struct iovec iov[2];
+    iov[0].iov_base = &header[0];
+    iov[0].iov_len = header.size();
+    iov[1].iov_base = const_cast<void*>(buf.getData());
+    iov[1].iov_len = buf.getLength();
+
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = iov;
+    msg.msg_iovlen = 2;
+
     // Try to send the message.
-   if (::send(socket_fd_, buf.getData(), buf.getLength(), 0) < 0) {
-       isc_throw(Dhcp4o6IpcError,
-                 "failed to send DHCP4o6 message over the IPC: "
-                 << strerror(errno));
-   }
+    if (sendmsg(socket_fd_, &msg, 0) < 0) {
+        isc_throw(Dhcp4o6IpcError,
+                  "failed to send DHCP4o6 message over the IPC: "
+                  << strerror(errno));
+    }
+
+    StatsMgr::instance().addValue("dhcp4o6-ipc-sent", static_cast<int64_t>(1));
 }
 
 };  // namespace dhcp
@@ -1,4 +1,4 @@
-// Copyright (C) 2015-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -53,11 +53,42 @@ public:
 /// requires information about the interface and the source address of
 /// the original DHCPv4 query message sent by the client. This
 /// information is known by the DHCPv6 server and needs to be conveyed
-/// to the DHCPv4 server. The IPC conveys it in the
-/// @c ISC_V6_4O6_INTERFACE and @c ISC_V6_4O6_SRC_ADDRESS options
-/// within the Vendor Specific Information option, with ISC
-/// enterprise id. These options are added by the IPC sender and removed
-/// by the IPC receiver.
+/// to the DHCPv4 server. The IPC conveys it in a compact header which
+/// precedes the DHCPv6 message in each datagram, so the message itself
+/// is sent as it is packed and it doesn't have to be modified by the
+/// sender and the receiver. The header has the following format (all
+/// numbers in network byte order):
+///
+/// @code
+///  0                   1                   2                   3
+///  0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
+/// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+/// |    version    |  name length  |           reserved            |
+/// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+/// |                                                               |
+/// |              remote IPv6 address (16 octets)                  |
+/// |                                                               |
+/// |                                                               |
+/// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+/// |             send time in microseconds (8 octets)              |
+/// |                                                               |
+/// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+/// |         interface name (name length octets) ...               |
+/// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+/// |         DHCPv6 message ...                                    |
+/// +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+/// @endcode
+///
+/// The send time is used by the receiver to compute the IPC latency,
+/// which is reported with the other IPC statistics:
+/// - dhcp4o6-ipc-sent: number of messages sent over the IPC,
+/// - dhcp4o6-ipc-received: number of messages received over the IPC,
+/// - dhcp4o6-ipc-latency: time between sending and receiving the last
+///   message received over the IPC.
+///
+/// The socket is non-blocking so the handler invoked when the socket
+/// is readable can call @c receive repeatedly to process all queued
+/// messages (up to @c RECEIVE_BATCH_SIZE) at once.
 class Dhcp4o6IpcBase : public boost::noncopyable {
 public:
 
@@ -67,6 +98,16 @@ public:
         ENDPOINT_TYPE_V6 = 6
     };
 
+    /// @brief Version of the IPC message header.
+    static const uint8_t HEADER_VERSION = 1;
+
+    /// @brief Size of the fixed part of the IPC message header.
+    static const size_t HEADER_SIZE = 28;
+
+    /// @brief Maximum number of messages received by the handler
+    /// each time the socket becomes readable.
+    static const size_t RECEIVE_BATCH_SIZE = 32;
+
 protected:
     /// @brief Constructor
     ///
@@ -97,19 +138,21 @@ public:
 
     /// @brief Receive message over IPC.
     ///
+    /// The message is unpacked and its interface and remote address are
+    /// set from the IPC message header.
+    ///
     /// @return a pointer to a DHCPv6 message with interface and remote
-    /// address set from the IPC message
+    /// address set from the IPC message or null if there is no message
+    /// to receive.
     /// @throw isc::dhcp::Dhcp4o6IpcError on system call error or
     /// malformed packets.
     Pkt6Ptr receive();
 
     /// @brief Send message over IPC.
     ///
-    /// The IPC uses @c ISC_V6_4O6_INTERFACE and @c ISC_V6_4O6_SRC_ADDRESS
-    /// options conveyed within the Vendor Specific Information option, with
-    /// ISC enterprise id, to communicate the client remote address and the
-    /// interface on which the DHCPv4 query was received. These options will
-    /// be removed by the receiver.
+    /// The message is packed and sent after the IPC message header holding
+    /// the client remote address and the interface on which the DHCPv4
+    /// query was received.
     ///
     /// @param pkt Pointer to a DHCPv6 message with interface and remote
     /// address.
@@ -0,0 +1,464 @@
+// Copyright (C) 2017 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <asiolink/io_address.h>
+#include <cc/command_interpreter.h>
+#include <dhcpsrv/cfgmgr.h>
+#include <dhcpsrv/host_cmds.h>
+#include <dhcpsrv/host_mgr.h>
+#include <dhcpsrv/parsers/host_reservation_parser.h>
+#include <util/encode/hex.h>
+#include <util/strutil.h>
+#include <boost/foreach.hpp>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <sys/socket.h>
+#include <vector>
+
+using namespace isc::asiolink;
+using namespace isc::config;
+using namespace isc::data;
+
+namespace {
+
+/// @brief Holds the arguments of the reservation-get and reservation-del
+/// commands.
+struct HostParameters {
+
+    /// @brief Constructor.
+    HostParameters()
+        : subnet_id_(0), addr_(IOAddress::IPV4_ZERO_ADDRESS()),
+          identifier_type_(isc::dhcp::Host::IDENT_HWADDR), identifier_(),
+          by_address_(false) {
+    }
+
+    /// @brief Identifier of the subnet.
+    isc::dhcp::SubnetID subnet_id_;
+
+    /// @brief Reserved address or prefix (if @c by_address_ is true).
+    IOAddress addr_;
+
+    /// @brief Host identifier type (if @c by_address_ is false).
+    isc::dhcp::Host::IdentifierType identifier_type_;
+
+    /// @brief Host identifier value (if @c by_address_ is false).
+    std::vector<uint8_t> identifier_;
+
+    /// @brief Indicates if the host is identified by the reserved address.
+    bool by_address_;
+};
+
+/// @brief Returns the subnet identifier specified in the command arguments.
+///
+/// @param params Map holding the "subnet-id" parameter.
+///
+/// @return Subnet identifier.
+/// @throw isc::BadValue if the subnet identifier is missing or invalid.
+isc::dhcp::SubnetID
+getSubnetId(const ConstElementPtr& params) {
+    ConstElementPtr subnet_id = params->get("subnet-id");
+    if (!subnet_id) {
+        isc_throw(isc::BadValue, "'subnet-id' parameter not specified");
+    }
+    if ((subnet_id->getType() != Element::integer) ||
+        (subnet_id->intValue() <= 0)) {
+        isc_throw(isc::BadValue, "'subnet-id' parameter must be a positive"
+                  " integer");
+    }
+    return (static_cast<isc::dhcp::SubnetID>(subnet_id->intValue()));
+}
+
+/// @brief Checks if the subnet exists in the current configuration.
+///
+/// @param family Protocol family, i.e. AF_INET or AF_INET6.
+/// @param subnet_id Identifier of the subnet.
+///
+/// @throw isc::BadValue if there is no such subnet.
+void
+checkSubnetExists(const uint16_t family, const isc::dhcp::SubnetID& subnet_id) {
+    isc::dhcp::ConstSrvConfigPtr cfg = isc::dhcp::CfgMgr::instance().getCurrentCfg();
+    bool exists = (family == AF_INET ?
+                   static_cast<bool>(cfg->getCfgSubnets4()->getBySubnetId(subnet_id)) :
+                   static_cast<bool>(cfg->getCfgSubnets6()->getBySubnetId(subnet_id)));
+    if (!exists) {
+        isc_throw(isc::BadValue, "subnet with id " << subnet_id
+                  << " does not exist");
+    }
+}
+
+/// @brief Parses the arguments of the reservation-get and reservation-del
+/// commands.
+///
+/// @param family Protocol family, i.e. AF_INET or AF_INET6.
+/// @param params Command arguments.
+///
+/// @return Parsed arguments.
+/// @throw isc::BadValue if the arguments are invalid.
+HostParameters
+parseHostParameters(const uint16_t family, const ConstElementPtr& params) {
+    if (!params || (params->getType() != Element::map)) {
+        isc_throw(isc::BadValue, "parameters missing or are not a map");
+    }
+
+    HostParameters x;
+    x.subnet_id_ = getSubnetId(params);
+
+    ConstElementPtr address = params->get("ip-address");
+    ConstElementPtr identifier_type = params->get("identifier-type");
+    ConstElementPtr identifier = params->get("identifier");
+
+    if (address) {
+        if (identifier_type || identifier) {
+            isc_throw(isc::BadValue, "'ip-address' must not be specified"
+                      " together with 'identifier-type' and 'identifier'");
+        }
+        if (address->getType() != Element::string) {
+            isc_throw(isc::BadValue, "'ip-address' is not a string");
+        }
+        x.addr_ = IOAddress(address->stringValue());
+        if ((family == AF_INET) != x.addr_.isV4()) {
+            isc_throw(isc::BadValue, "invalid address family of '"
+                      << x.addr_ << "'");
+        }
+        x.by_address_ = true;
+        return (x);
+    }
+
+    if (!identifier_type || !identifier) {
+        isc_throw(isc::BadValue, "either 'ip-address' or 'identifier-type'"
+                  " and 'identifier' must be specified");
+    }
+    if ((identifier_type->getType() != Element::string) ||
+        (identifier->getType() != Element::string)) {
+        isc_throw(isc::BadValue, "'identifier-type' and 'identifier' must"
+                  " be strings");
+    }
+    x.identifier_type_ =
+        isc::dhcp::Host::getIdentifierType(identifier_type->stringValue());
+    isc::util::str::decodeFormattedHexString(identifier->stringValue(),
+                                             x.identifier_);
+    if (x.identifier_.empty()) {
+        isc_throw(isc::BadValue, "'identifier' must not be empty");
+    }
+    return (x);
+}
+
+/// @brief Converts binary identifier to the colon separated hexadecimal
+/// format used in the configuration.
+///
+/// @param identifier Identifier in the binary format.
+///
+/// @return Identifier in the textual format, e.g. "01:02:03".
+std::string
+formatIdentifier(const std::vector<uint8_t>& identifier) {
+    std::ostringstream s;
+    s << std::hex << std::setfill('0');
+    for (std::vector<uint8_t>::const_iterator it = identifier.begin();
+         it != identifier.end(); ++it) {
+        if (it != identifier.begin()) {
+            s << ":";
+        }
+        s << std::setw(2) << static_cast<unsigned int>(*it);
+    }
+    return (s.str());
+}
+
+/// @brief Converts client classes to a list of strings.
+///
+/// @param classes Client classes.
+///
+/// @return List of class names.
+ElementPtr
+classesToElement(const isc::dhcp::ClientClasses& classes) {
+    ElementPtr list = Element::createList();
+    BOOST_FOREACH(isc::dhcp::ClientClass cclass, classes) {
+        list->add(Element::create(cclass));
+    }
+    return (list);
+}
+
+/// @brief Converts options held in the host reservation to the
+/// "option-data" list.
+///
+/// The options specified in the textual format are returned as such.
+/// Other options are returned as hexadecimal strings.
+///
+/// @param cfg_option Options to be converted.
+///
+/// @return List of options.
+ElementPtr
+optionsToElement(const isc::dhcp::ConstCfgOptionPtr& cfg_option) {
+    ElementPtr list = Element::createList();
+    std::list<std::string> spaces = cfg_option->getOptionSpaceNames();
+    BOOST_FOREACH(std::string space, spaces) {
+        isc::dhcp::OptionContainerPtr options = cfg_option->getAll(space);
+        for (isc::dhcp::OptionContainer::const_iterator desc = options->begin();
+             desc != options->end(); ++desc) {
+            if (!desc->option_) {
+                continue;
+            }
+            ElementPtr option = Element::createMap();
+            option->set("code", Element::create(desc->option_->getType()));
+            option->set("space", Element::create(space));
+            if (!desc->formatted_value_.empty()) {
+                option->set("csv-format", Element::create(true));
+                option->set("data", Element::create(desc->formatted_value_));
+            } else {
+                option->set("csv-format", Element::create(false));
+                option->set("data", Element::create(isc::util::encode::
+                            encodeHex(desc->option_->toBinary(false))));
+            }
+            list->add(option);
+        }
+    }
+    return (list);
+}
+
+}
+
+namespace isc {
+namespace dhcp {
+
+ConstElementPtr
+HostCmds::reservationAddHandler(const uint16_t family, const std::string&,
+                                const ConstElementPtr& params) {
+    try {
+        if (!params || (params->getType() != Element::map)) {
+            isc_throw(BadValue, "parameters missing or are not a map");
+        }
+
+        ConstElementPtr reservation = params->get("reservation");
+        if (!reservation || (reservation->getType() != Element::map)) {
+            isc_throw(BadValue, "'reservation' parameter missing or is not"
+                      " a map");
+        }
+
+        SubnetID subnet_id = getSubnetId(reservation);
+        checkSubnetExists(family, subnet_id);
+
+        // The "subnet-id" is not a valid parameter of the reservation in
+        // the server configuration, so it has to be removed before the
+        // reservation is parsed.
+        ElementPtr host_cfg = Element::createMap(reservation->getPosition());
+        const std::map<std::string, ConstElementPtr>& values =
+            reservation->mapValue();
+        for (std::map<std::string, ConstElementPtr>::const_iterator value =
+                 values.begin(); value != values.end(); ++value) {
+            if (value->first != "subnet-id") {
+                host_cfg->set(value->first, value->second);
+            }
+        }
+
+        // The options are resolved using the option definitions of the
+        // running server. The staging configuration must not be used by
+        // the commands.
+        ConstCfgOptionDefPtr cfg_option_def =
+            CfgMgr::instance().getCurrentCfg()->getCfgOptionDef();
+        HostPtr host;
+        if (family == AF_INET) {
+            HostReservationParser4 parser;
+            host = parser.parseHost(subnet_id, host_cfg, cfg_option_def);
+        } else {
+            HostReservationParser6 parser;
+            host = parser.parseHost(subnet_id, host_cfg, cfg_option_def);
+        }
+
+        CfgHostsPtr cfg_hosts = CfgMgr::instance().getCurrentCfgHosts();
+        cfg_hosts->add(host);
+
+        HostDataSourcePtr source = HostMgr::instance().getHostDataSource();
+        if (source) {
+            try {
+                source->add(host);
+
+            } catch (...) {
+                // Keep the in-memory reservations in sync with the
+                // database.
+                const std::vector<uint8_t>& id = host->getIdentifier();
+                if (family == AF_INET) {
+                    cfg_hosts->del4(subnet_id, host->getIdentifierType(),
+                                    &id[0], id.size());
+                } else {
+                    cfg_hosts->del6(subnet_id, host->getIdentifierType(),
+                                    &id[0], id.size());
+                }
+                throw;
+            }
+        }
+
+        // The reservations of this subnet no longer match the configuration
+        // from which they have been created.
+        CfgMgr::instance().getCurrentCfgIncremental()->removeSubnet(subnet_id);
+
+    } catch (const std::exception& ex) {
+        return (createAnswer(CONTROL_RESULT_ERROR, ex.what()));
+    }
+
+    return (createAnswer(CONTROL_RESULT_SUCCESS, "Host added."));
+}
+
+ConstElementPtr
+HostCmds::reservationGetHandler(const uint16_t family, const std::string&,
+                                const ConstElementPtr& params) {
+    ConstHostPtr host;
+    try {
+        HostParameters x = parseHostParameters(family, params);
+        HostMgr& host_mgr = HostMgr::instance();
+        if (x.by_address_) {
+            host = (family == AF_INET ? host_mgr.get4(x.subnet_id_, x.addr_) :
+                    host_mgr.get6(x.subnet_id_, x.addr_));
+
+        } else if (family == AF_INET) {
+            host = host_mgr.get4(x.subnet_id_, x.identifier_type_,
+                                 &x.identifier_[0], x.identifier_.size());
+
+        } else {
+            host = host_mgr.get6(x.subnet_id_, x.identifier_type_,
+                                 &x.identifier_[0], x.identifier_.size());
+        }
+
+        if (!host) {
+            return (createAnswer(CONTROL_RESULT_EMPTY, "Host not found."));
+        }
+
+        return (createAnswer(CONTROL_RESULT_SUCCESS, "Host found.",
+                             hostToElement(family, host)));
+
+    } catch (const std::exception& ex) {
+        return (createAnswer(CONTROL_RESULT_ERROR, ex.what()));
+    }
+}
+
+ConstElementPtr
+HostCmds::reservationDelHandler(const uint16_t family, const std::string&,
+                                const ConstElementPtr& params) {
+    bool deleted = false;
+    try {
+        HostParameters x = parseHostParameters(family, params);
+        CfgHostsPtr cfg_hosts = CfgMgr::instance().getCurrentCfgHosts();
+        HostDataSourcePtr source = HostMgr::instance().getHostDataSource();
+
+        // The host is removed from the database first, so that it doesn't
+        // remain in the database if it has been removed from memory and
+        // the database operation fails.
+        if (x.by_address_) {
+            if (source) {
+                deleted = source->del(x.subnet_id_, x.addr_);
+            }
+            deleted = cfg_hosts->del(x.subnet_id_, x.addr_) || deleted;
+
+        } else if (family == AF_INET) {
+            if (source) {
+                deleted = source->del4(x.subnet_id_, x.identifier_type_,
+                                       &x.identifier_[0], x.identifier_.size());
+            }
+            deleted = cfg_hosts->del4(x.subnet_id_, x.identifier_type_,
+                                      &x.identifier_[0],
+                                      x.identifier_.size()) || deleted;
+
+        } else {
+            if (source) {
+                deleted = source->del6(x.subnet_id_, x.identifier_type_,
+                                       &x.identifier_[0], x.identifier_.size());
+            }
+            deleted = cfg_hosts->del6(x.subnet_id_, x.identifier_type_,
+                                      &x.identifier_[0],
+                                      x.identifier_.size()) || deleted;
+        }
+
+        if (deleted) {
+            CfgMgr::instance().getCurrentCfgIncremental()->
+                removeSubnet(x.subnet_id_);
+        }
+
+    } catch (const std::exception& ex) {
+        return (createAnswer(CONTROL_RESULT_ERROR, ex.what()));
+    }
+
+    if (!deleted) {
+        return (createAnswer(CONTROL_RESULT_EMPTY,
+                             "Host not deleted (not found)."));
+    }
+    return (createAnswer(CONTROL_RESULT_SUCCESS, "Host deleted."));
+}
+
+ElementPtr
+HostCmds::hostToElement(const uint16_t family, const ConstHostPtr& host) {
+    ElementPtr map = Element::createMap();
+
+    map->set(Host::getIdentifierName(host->getIdentifierType()),
+             Element::create(formatIdentifier(host->getIdentifier())));
+
+    if (!host->getHostname().empty()) {
+        map->set("hostname", Element::create(host->getHostname()));
+    }
+
+    if (family == AF_INET) {
+        map->set("subnet-id", Element::create(static_cast<long int>
+                                              (host->getIPv4SubnetID())));
+        if (!host->getIPv4Reservation().isV4Zero()) {
+            map->set("ip-address",
+                     Element::create(host->getIPv4Reservation().toText()));
+        }
+        if (!host->getNextServer().isV4Zero()) {
+            map->set("next-server",
+                     Element::create(host->getNextServer().toText()));
+        }
+        if (!host->getServerHostname().empty()) {
+            map->set("server-hostname",
+                     Element::create(host->getServerHostname()));
+        }
+        if (!host->getBootFileName().empty()) {
+            map->set("boot-file-name",
+                     Element::create(host->getBootFileName()));
+        }
+        if (!host->getClientClasses4().empty()) {
+            map->set("client-classes",
+                     classesToElement(host->getClientClasses4()));
+        }
+        if (!host->getCfgOption4()->empty()) {
+            map->set("option-data", optionsToElement(host->getCfgOption4()));
+        }
+
+    } else {
+        map->set("subnet-id", Element::create(static_cast<long int>
+                                              (host->getIPv6SubnetID())));
+        ElementPtr addresses = Element::createList();
+        ElementPtr prefixes = Element::createList();
+        IPv6ResrvRange reservations = host->getIPv6Reservations();
+        for (IPv6ResrvIterator resrv = reservations.first;
+             resrv != reservations.second; ++resrv) {
+            if (resrv->second.getType() == IPv6Resrv::TYPE_NA) {
+                addresses->add(Element::create(resrv->second.getPrefix().toText()));
+            } else {
+                std::ostringstream s;
+                s << resrv->second.getPrefix().toText() << "/"
+                  << static_cast<int>(resrv->second.getPrefixLen());
+                prefixes->add(Element::create(s.str()));
+            }
+        }
+        if (!addresses->empty()) {
+            map->set("ip-addresses", addresses);
+        }
+        if (!prefixes->empty()) {
+            map->set("prefixes", prefixes);
+        }
+        if (!host->getClientClasses6().empty()) {
+            map->set("client-classes",
+                     classesToElement(host->getClientClasses6()));
+        }
+        if (!host->getCfgOption6()->empty()) {
+            map->set("option-data", optionsToElement(host->getCfgOption6()));
+        }
+    }
+
+    return (map);
+}
+
+}
+}
@@ -0,0 +1,117 @@
+// Copyright (C) 2017 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef HOST_CMDS_H
+#define HOST_CMDS_H
+
+#include <cc/data.h>
+#include <dhcpsrv/host.h>
+#include <string>
+
+namespace isc {
+namespace dhcp {
+
+/// @brief Implements the control commands which manage host reservations
+/// of the running server.
+///
+/// The commands modify the host reservations held in the current server
+/// configuration in place, i.e. by inserting to or removing from the
+/// indexes of the @c CfgHosts, so as the server doesn't need to be
+/// reconfigured when the reservation is added or deleted. If the alternate
+/// host data source (MySQL or PostgreSQL database) is configured, the
+/// changes are also persisted in this data source.
+///
+/// All methods are static, so as they can be registered in the
+/// @c isc::config::CommandMgr using @c boost::bind with the protocol
+/// family being bound to the first argument.
+class HostCmds {
+public:
+
+    /// @brief Handles reservation-add command.
+    ///
+    /// This command adds a new host reservation to the specified subnet.
+    /// The reservation is specified in the same format as in the server
+    /// configuration, with the additional "subnet-id" parameter.
+    ///
+    /// Example params structure:
+    /// {
+    ///     "reservation": {
+    ///         "subnet-id": 1,
+    ///         "hw-address": "1a:1b:1c:1d:1e:1f",
+    ///         "ip-address": "192.0.2.202"
+    ///     }
+    /// }
+    ///
+    /// @param family Protocol family, i.e. AF_INET or AF_INET6.
+    /// @param name Name of the command (ignored, should be "reservation-add").
+    /// @param params Command arguments.
+    ///
+    /// @return Answer indicating whether the reservation has been added.
+    static isc::data::ConstElementPtr
+    reservationAddHandler(const uint16_t family, const std::string& name,
+                          const isc::data::ConstElementPtr& params);
+
+    /// @brief Handles reservation-get command.
+    ///
+    /// The reservation is identified by the subnet identifier and either
+    /// the reserved address or the host identifier.
+    ///
+    /// Example params structures:
+    /// {
+    ///     "subnet-id": 1,
+    ///     "ip-address": "192.0.2.202"
+    /// }
+    ///
+    /// {
+    ///     "subnet-id": 1,
+    ///     "identifier-type": "hw-address",
+    ///     "identifier": "1a:1b:1c:1d:1e:1f"
+    /// }
+    ///
+    /// @param family Protocol family, i.e. AF_INET or AF_INET6.
+    /// @param name Name of the command (ignored, should be "reservation-get").
+    /// @param params Command arguments.
+    ///
+    /// @return Answer holding the reservation or the status code
+    /// @c isc::config::CONTROL_RESULT_EMPTY if the reservation doesn't
+    /// exist.
+    static isc::data::ConstElementPtr
+    reservationGetHandler(const uint16_t family, const std::string& name,
+                          const isc::data::ConstElementPtr& params);
+
+    /// @brief Handles reservation-del command.
+    ///
+    /// The arguments are the same as for the reservation-get command.
+    ///
+    /// @param family Protocol family, i.e. AF_INET or AF_INET6.
+    /// @param name Name of the command (ignored, should be "reservation-del").
+    /// @param params Command arguments.
+    ///
+    /// @return Answer indicating whether the reservation has been deleted
+    /// or the status code @c isc::config::CONTROL_RESULT_EMPTY if the
+    /// reservation doesn't exist.
+    static isc::data::ConstElementPtr
+    reservationDelHandler(const uint16_t family, const std::string& name,
+                          const isc::data::ConstElementPtr& params);
+
+    /// @brief Converts the host reservation to the structure returned
+    /// by the reservation-get command.
+    ///
+    /// The returned structure uses the format of the reservations in the
+    /// server configuration, with the additional "subnet-id" parameter.
+    ///
+    /// @param family Protocol family, i.e. AF_INET or AF_INET6.
+    /// @param host Pointer to the host reservation.
+    ///
+    /// @return Map holding the host reservation.
+    static isc::data::ElementPtr
+    hostToElement(const uint16_t family, const ConstHostPtr& host);
+};
+
+}
+}
+
+#endif // HOST_CMDS_H
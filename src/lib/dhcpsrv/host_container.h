@@ -1,4 +1,4 @@
-// Copyright (C) 2014-2015 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2014-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -11,14 +11,93 @@
 #include <dhcpsrv/subnet_id.h>
 #include <boost/multi_index_container.hpp>
 #include <boost/multi_index/composite_key.hpp>
+#include <boost/multi_index/hashed_index.hpp>
 #include <boost/multi_index/mem_fun.hpp>
 #include <boost/multi_index/member.hpp>
 #include <boost/multi_index/ordered_index.hpp>
-#include <boost/multi_index/hashed_index.hpp>
+#include <boost/functional/hash.hpp>
+#include <cstring>
 
 namespace isc {
 namespace dhcp {
 
+/// @brief Key of the host identifier index of the @c HostContainer.
+///
+/// The key refers to the identifier held by the @c Host object or to the
+/// identifier buffer supplied by the caller of the lookup function, so the
+/// identifier is not copied when the key is created.
+struct HostIdentifierKey {
+
+    /// @brief Constructor.
+    ///
+    /// @param identifier Pointer to the binary identifier.
+    /// @param identifier_len Identifier length.
+    /// @param identifier_type Identifier type.
+    HostIdentifierKey(const uint8_t* identifier, const size_t identifier_len,
+                      const Host::IdentifierType& identifier_type)
+        : identifier_(identifier), identifier_len_(identifier_len),
+          identifier_type_(identifier_type) {
+    }
+
+    /// @brief Compares two keys.
+    ///
+    /// @param other Key to compare to.
+    ///
+    /// @return true if the identifiers and their types are equal.
+    bool operator==(const HostIdentifierKey& other) const {
+        return ((identifier_type_ == other.identifier_type_) &&
+                (identifier_len_ == other.identifier_len_) &&
+                ((identifier_len_ == 0) ||
+                 (memcmp(identifier_, other.identifier_, identifier_len_) == 0)));
+    }
+
+    /// @brief Pointer to the binary identifier.
+    const uint8_t* identifier_;
+
+    /// @brief Identifier length.
+    size_t identifier_len_;
+
+    /// @brief Identifier type.
+    Host::IdentifierType identifier_type_;
+};
+
+/// @brief Hashes the host identifier key.
+///
+/// @param key Key to be hashed.
+///
+/// @return Hash of the identifier and its type.
+inline size_t
+hash_value(const HostIdentifierKey& key) {
+    size_t seed = boost::hash_range(key.identifier_,
+                                    key.identifier_ + key.identifier_len_);
+    boost::hash_combine(seed, static_cast<int>(key.identifier_type_));
+    return (seed);
+}
+
+/// @brief Extracts the @c HostIdentifierKey from the @c Host object.
+struct HostIdentifierKeyExtractor {
+
+    /// @brief Type of the extracted key.
+    typedef HostIdentifierKey result_type;
+
+    /// @brief Returns the key of the host.
+    ///
+    /// @param host Host object.
+    result_type operator()(const Host& host) const {
+        const std::vector<uint8_t>& identifier = host.getIdentifier();
+        return (HostIdentifierKey(identifier.empty() ? 0 : &identifier[0],
+                                  identifier.size(),
+                                  host.getIdentifierType()));
+    }
+
+    /// @brief Returns the key of the host.
+    ///
+    /// @param host Pointer to the host object.
+    result_type operator()(const HostPtr& host) const {
+        return (operator()(*host));
+    }
+};
+
 /// @brief Multi-index container holding host reservations.
 ///
 /// This container holds a collection of @c Host objects which can be retrieved
@@ -38,35 +117,40 @@ typedef boost::multi_index_container<
         // First index is used to search for the host using one of the
         // identifiers, i.e. HW address or DUID. The elements of this
         // index are non-unique because there may be multiple reservations
-        // for the same host belonging to a different subnets.
-        boost::multi_index::ordered_non_unique<
+        // for the same host belonging to a different subnets. The index
+        // is only used for exact match lookups, so it is hashed to avoid
+        // comparing identifiers on each level of the tree.
+        boost::multi_index::hashed_non_unique<
             // The index comprises actual identifier (HW address or DUID) in
             // a binary form and a type of the identifier which indicates
-            // that it is HW address or DUID.
-            boost::multi_index::composite_key<
-                // Composite key uses members of the Host class.
-                Host,
-                // Binary identifier is retrieved from the Host class using
-                // a getIdentifier method.
-                boost::multi_index::const_mem_fun<
-                    Host, const std::vector<uint8_t>&,
-                    &Host::getIdentifier
-                >,
-                // Identifier type is retrieved from the Host class using
-                // a getIdentifierType method.
-                boost::multi_index::const_mem_fun<
-                    Host, Host::IdentifierType,
-                    &Host::getIdentifierType
-                >
-            >
+            // that it is HW address or DUID. The key refers to the
+            // identifier rather than copying it, so the lookups don't
+            // allocate memory.
+            HostIdentifierKeyExtractor
         >,
 
         // Second index is used to search for the host using reserved IPv4
-        // address.
-        boost::multi_index::ordered_non_unique<
+        // address. Only exact match lookups are performed.
+        boost::multi_index::hashed_non_unique<
             // Index using values returned by the @c Host::getIPv4Resrvation.
             boost::multi_index::const_mem_fun<Host, const asiolink::IOAddress&,
                                                &Host::getIPv4Reservation>
+        >,
+
+        // Third index is used to search for all hosts belonging to the
+        // particular IPv4 subnet.
+        boost::multi_index::ordered_non_unique<
+            // Index using values returned by the @c Host::getIPv4SubnetID.
+            boost::multi_index::const_mem_fun<Host, SubnetID,
+                                               &Host::getIPv4SubnetID>
+        >,
+
+        // Fourth index is used to search for all hosts belonging to the
+        // particular IPv6 subnet.
+        boost::multi_index::ordered_non_unique<
+            // Index using values returned by the @c Host::getIPv6SubnetID.
+            boost::multi_index::const_mem_fun<Host, SubnetID,
+                                               &Host::getIPv6SubnetID>
         >
     >
 > HostContainer;
@@ -74,7 +158,7 @@ typedef boost::multi_index_container<
 /// @brief First index type in the @c HostContainer.
 ///
 /// This index allows for searching for @c Host objects using an
-/// identifier + identifier type tuple.
+/// identifier + identifier type key, i.e. @c HostIdentifierKey.
 typedef HostContainer::nth_index<0>::type HostContainerIndex0;
 
 /// @brief Results range returned using the @c HostContainerIndex0.
@@ -91,6 +175,26 @@ typedef HostContainer::nth_index<1>::type HostContainerIndex1;
 typedef std::pair<HostContainerIndex1::iterator,
                   HostContainerIndex1::iterator> HostContainerIndex1Range;
 
+/// @brief Third index type in the @c HostContainer.
+///
+/// This index allows for searching for @c Host objects using an
+/// IPv4 subnet identifier.
+typedef HostContainer::nth_index<2>::type HostContainerIndex2;
+
+/// @brief Results range returned using the @c HostContainerIndex2.
+typedef std::pair<HostContainerIndex2::iterator,
+                  HostContainerIndex2::iterator> HostContainerIndex2Range;
+
+/// @brief Fourth index type in the @c HostContainer.
+///
+/// This index allows for searching for @c Host objects using an
+/// IPv6 subnet identifier.
+typedef HostContainer::nth_index<3>::type HostContainerIndex3;
+
+/// @brief Results range returned using the @c HostContainerIndex3.
+typedef std::pair<HostContainerIndex3::iterator,
+                  HostContainerIndex3::iterator> HostContainerIndex3Range;
+
 /// @brief Defines one entry for the Host Container for v6 hosts
 ///
 /// It's essentially a pair of (IPv6 reservation, Host pointer).
@@ -135,8 +239,9 @@ typedef boost::multi_index_container<
     // Start specification of indexes here.
     boost::multi_index::indexed_by<
 
-        // First index is used to search by an address.
-        boost::multi_index::ordered_non_unique<
+        // First index is used to search by an address. Only exact match
+        // lookups are performed.
+        boost::multi_index::hashed_non_unique<
 
             // Address is extracted by calling IPv6Resrv::getPrefix()
             // and it will return an IOAddress object.
@@ -145,8 +250,8 @@ typedef boost::multi_index_container<
         >,
 
         // Second index is used to search by (subnet_id, address) pair.
-        // This is
-        boost::multi_index::ordered_unique<
+        // Only exact match lookups are performed.
+        boost::multi_index::hashed_unique<
 
             /// This is a composite key. It uses two keys: subnet-id and
             /// IPv6 address reservation.
@@ -0,0 +1,634 @@
+// Copyright (C) 2017 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <asiolink/io_address.h>
+#include <cc/command_interpreter.h>
+#include <dhcp/duid.h>
+#include <dhcp/hwaddr.h>
+#include <dhcpsrv/cfgmgr.h>
+#include <dhcpsrv/lease_cmds.h>
+#include <dhcpsrv/lease_mgr_factory.h>
+#include <stats/stats_mgr.h>
+#include <ctime>
+#include <string>
+#include <sys/socket.h>
+
+using namespace isc::asiolink;
+using namespace isc::config;
+using namespace isc::data;
+using namespace isc::dhcp;
+using namespace isc::stats;
+
+namespace {
+
+/// @brief Checks that the command arguments are a map.
+///
+/// @param params Command arguments.
+///
+/// @throw isc::BadValue if the arguments are missing or aren't a map.
+void
+checkMap(const ConstElementPtr& params) {
+    if (!params || (params->getType() != Element::map)) {
+        isc_throw(isc::BadValue, "parameters missing or are not a map");
+    }
+}
+
+/// @brief Returns the string parameter.
+///
+/// @param params Map holding the parameter.
+/// @param name Name of the parameter.
+/// @param required Indicates if the parameter is mandatory.
+///
+/// @return Value of the parameter or empty string if the optional
+/// parameter is not specified.
+/// @throw isc::BadValue if the parameter is invalid or missing.
+std::string
+getString(const ConstElementPtr& params, const std::string& name,
+          const bool required = true) {
+    ConstElementPtr value = params->get(name);
+    if (!value) {
+        if (required) {
+            isc_throw(isc::BadValue, "'" << name << "' parameter not specified");
+        }
+        return ("");
+    }
+    if (value->getType() != Element::string) {
+        isc_throw(isc::BadValue, "'" << name << "' parameter is not a string");
+    }
+    return (value->stringValue());
+}
+
+/// @brief Returns the non-negative integer parameter.
+///
+/// @param params Map holding the parameter.
+/// @param name Name of the parameter.
+/// @param default_value Value returned if the parameter is not specified.
+///
+/// @return Value of the parameter.
+/// @throw isc::BadValue if the parameter is invalid.
+int64_t
+getInteger(const ConstElementPtr& params, const std::string& name,
+           const int64_t default_value) {
+    ConstElementPtr value = params->get(name);
+    if (!value) {
+        return (default_value);
+    }
+    if ((value->getType() != Element::integer) || (value->intValue() < 0)) {
+        isc_throw(isc::BadValue, "'" << name << "' parameter must be a"
+                  " non-negative integer");
+    }
+    return (value->intValue());
+}
+
+/// @brief Returns the mandatory non-negative integer parameter.
+///
+/// @param params Map holding the parameter.
+/// @param name Name of the parameter.
+///
+/// @return Value of the parameter.
+/// @throw isc::BadValue if the parameter is invalid or missing.
+int64_t
+getInteger(const ConstElementPtr& params, const std::string& name) {
+    if (!params->get(name)) {
+        isc_throw(isc::BadValue, "'" << name << "' parameter not specified");
+    }
+    return (getInteger(params, name, 0));
+}
+
+/// @brief Returns the boolean parameter.
+///
+/// @param params Map holding the parameter.
+/// @param name Name of the parameter.
+///
+/// @return Value of the parameter or false if it is not specified.
+/// @throw isc::BadValue if the parameter is not a boolean.
+bool
+getBoolean(const ConstElementPtr& params, const std::string& name) {
+    ConstElementPtr value = params->get(name);
+    if (!value) {
+        return (false);
+    }
+    if (value->getType() != Element::boolean) {
+        isc_throw(isc::BadValue, "'" << name << "' parameter is not a boolean");
+    }
+    return (value->boolValue());
+}
+
+/// @brief Converts the address to @c IOAddress and checks its family.
+///
+/// @param family Protocol family, i.e. AF_INET or AF_INET6.
+/// @param text Address in the textual format.
+///
+/// @return Converted address.
+/// @throw isc::BadValue if the address is of the wrong family.
+IOAddress
+toAddress(const uint16_t family, const std::string& text) {
+    IOAddress addr(text);
+    if ((family == AF_INET) != addr.isV4()) {
+        isc_throw(isc::BadValue, "invalid address family of '" << addr << "'");
+    }
+    return (addr);
+}
+
+/// @brief Returns the address specified with the "ip-address" parameter.
+///
+/// @param family Protocol family, i.e. AF_INET or AF_INET6.
+/// @param params Map holding the parameter.
+///
+/// @return Lease address.
+/// @throw isc::BadValue if the address is missing or invalid.
+IOAddress
+getAddress(const uint16_t family, const ConstElementPtr& params) {
+    return (toAddress(family, getString(params, "ip-address")));
+}
+
+/// @brief Returns the lease type specified with the "type" parameter.
+///
+/// @param params Map holding the parameter.
+///
+/// @return Lease type, @c Lease::TYPE_NA if not specified.
+/// @throw isc::BadValue if the lease type is invalid.
+Lease::Type
+getLeaseType(const ConstElementPtr& params) {
+    std::string type = getString(params, "type", false);
+    if (type.empty() || (type == Lease::typeToText(Lease::TYPE_NA))) {
+        return (Lease::TYPE_NA);
+
+    } else if (type == Lease::typeToText(Lease::TYPE_TA)) {
+        return (Lease::TYPE_TA);
+
+    } else if (type == Lease::typeToText(Lease::TYPE_PD)) {
+        return (Lease::TYPE_PD);
+    }
+    isc_throw(isc::BadValue, "invalid lease type '" << type << "', expected"
+              " IA_NA, IA_TA or IA_PD");
+}
+
+/// @brief Returns the subnet specified with the "subnet-id" parameter.
+///
+/// @param family Protocol family, i.e. AF_INET or AF_INET6.
+/// @param params Map holding the parameter.
+///
+/// @return Pointer to the subnet.
+/// @throw isc::BadValue if the subnet identifier is invalid or there is
+/// no such subnet.
+SubnetPtr
+getSubnet(const uint16_t family, const ConstElementPtr& params) {
+    SubnetID subnet_id = static_cast<SubnetID>(getInteger(params, "subnet-id"));
+    ConstSrvConfigPtr cfg = CfgMgr::instance().getCurrentCfg();
+    SubnetPtr subnet;
+    if (family == AF_INET) {
+        subnet = cfg->getCfgSubnets4()->getBySubnetId(subnet_id);
+    } else {
+        subnet = cfg->getCfgSubnets6()->getBySubnetId(subnet_id);
+    }
+    if (!subnet) {
+        isc_throw(isc::BadValue, "subnet with id " << subnet_id
+                  << " does not exist");
+    }
+    return (subnet);
+}
+
+/// @brief Returns the optional hardware address.
+///
+/// @param params Map holding the "hw-address" parameter.
+/// @param required Indicates if the parameter is mandatory.
+///
+/// @return Pointer to the hardware address or null pointer.
+HWAddrPtr
+getHWAddr(const ConstElementPtr& params, const bool required) {
+    std::string text = getString(params, "hw-address", required);
+    if (text.empty()) {
+        return (HWAddrPtr());
+    }
+    return (HWAddrPtr(new HWAddr(HWAddr::fromText(text))));
+}
+
+/// @brief Creates the DHCPv4 lease from the command arguments.
+///
+/// @param params Command arguments.
+///
+/// @return Pointer to the lease.
+/// @throw isc::BadValue if the arguments are invalid.
+Lease4Ptr
+parseLease4(const ConstElementPtr& params) {
+    checkMap(params);
+    IOAddress addr = getAddress(AF_INET, params);
+    SubnetPtr subnet = getSubnet(AF_INET, params);
+    if (!subnet->inRange(addr)) {
+        isc_throw(isc::BadValue, "address " << addr << " does not belong to"
+                  " the subnet " << subnet->toText());
+    }
+
+    ClientIdPtr client_id;
+    std::string client_id_text = getString(params, "client-id", false);
+    if (!client_id_text.empty()) {
+        client_id = ClientId::fromText(client_id_text);
+    }
+
+    Lease4Ptr lease(new Lease4(addr, getHWAddr(params, true), client_id,
+                               getInteger(params, "valid-lft",
+                                          subnet->getValid()),
+                               subnet->getT1(), subnet->getT2(),
+                               getInteger(params, "cltt", time(NULL)),
+                               subnet->getID(),
+                               getBoolean(params, "fqdn-fwd"),
+                               getBoolean(params, "fqdn-rev"),
+                               getString(params, "hostname", false)));
+    lease->state_ = getInteger(params, "state", Lease::STATE_DEFAULT);
+    return (lease);
+}
+
+/// @brief Creates the DHCPv6 lease from the command arguments.
+///
+/// @param params Command arguments.
+///
+/// @return Pointer to the lease.
+/// @throw isc::BadValue if the arguments are invalid.
+Lease6Ptr
+parseLease6(const ConstElementPtr& params) {
+    checkMap(params);
+    IOAddress addr = getAddress(AF_INET6, params);
+    Lease::Type type = getLeaseType(params);
+    SubnetPtr subnet = getSubnet(AF_INET6, params);
+    Subnet6Ptr subnet6 = boost::dynamic_pointer_cast<Subnet6>(subnet);
+
+    int64_t prefix_len = 128;
+    if (type == Lease::TYPE_PD) {
+        prefix_len = getInteger(params, "prefix-len");
+        if ((prefix_len == 0) || (prefix_len > 128)) {
+            isc_throw(isc::BadValue, "'prefix-len' must be in the range"
+                      " of 1 to 128");
+        }
+
+    } else if (!subnet->inRange(addr)) {
+        isc_throw(isc::BadValue, "address " << addr << " does not belong to"
+                  " the subnet " << subnet->toText());
+    }
+
+    DuidPtr duid(new DUID(DUID::fromText(getString(params, "duid"))));
+    Lease6Ptr lease(new Lease6(type, addr, duid, getInteger(params, "iaid"),
+                               getInteger(params, "preferred-lft",
+                                          subnet6->getPreferred()),
+                               getInteger(params, "valid-lft",
+                                          subnet->getValid()),
+                               subnet->getT1(), subnet->getT2(),
+                               subnet->getID(),
+                               getBoolean(params, "fqdn-fwd"),
+                               getBoolean(params, "fqdn-rev"),
+                               getString(params, "hostname", false),
+                               getHWAddr(params, false),
+                               static_cast<uint8_t>(prefix_len)));
+    lease->cltt_ = getInteger(params, "cltt", time(NULL));
+    lease->state_ = getInteger(params, "state", Lease::STATE_DEFAULT);
+    return (lease);
+}
+
+/// @brief Finds the DHCPv6 lease for the address specified in the command
+/// arguments.
+///
+/// If the lease type is not specified, the leases of all types are
+/// checked.
+///
+/// @param params Command arguments.
+///
+/// @return Pointer to the lease or null pointer if there is no such lease.
+/// @throw isc::BadValue if the arguments are invalid.
+Lease6Ptr
+findLease6(const ConstElementPtr& params) {
+    IOAddress addr = getAddress(AF_INET6, params);
+    LeaseMgr& lease_mgr = LeaseMgrFactory::instance();
+    if (params->get("type")) {
+        return (lease_mgr.getLease6(getLeaseType(params), addr));
+    }
+
+    Lease6Ptr lease = lease_mgr.getLease6(Lease::TYPE_NA, addr);
+    if (!lease) {
+        lease = lease_mgr.getLease6(Lease::TYPE_PD, addr);
+    }
+    if (!lease) {
+        lease = lease_mgr.getLease6(Lease::TYPE_TA, addr);
+    }
+    return (lease);
+}
+
+/// @brief Updates the statistics of the assigned and declined leases.
+///
+/// The statistics are updated in the same way as the allocation engine
+/// and the server do it when the leases are allocated, declined and
+/// reclaimed: the reclaimed leases are not counted as assigned and the
+/// declined leases are counted as both assigned and declined.
+///
+/// @param lease Lease added to or removed from the lease database.
+/// @param type Lease type, @c Lease::TYPE_V4 for the DHCPv4 lease.
+/// @param value Value to be added to the statistics, i.e. 1 for the added
+/// lease and -1 for the removed lease.
+void
+updateStats(const Lease& lease, const Lease::Type& type, const int64_t value) {
+    if (lease.stateExpiredReclaimed()) {
+        return;
+    }
+
+    std::string name = "assigned-addresses";
+    if (type == Lease::TYPE_NA) {
+        name = "assigned-nas";
+    } else if (type == Lease::TYPE_PD) {
+        name = "assigned-pds";
+    }
+    StatsMgr& stats_mgr = StatsMgr::instance();
+    stats_mgr.addValue(StatsMgr::generateName("subnet", lease.subnet_id_, name),
+                       value);
+
+    if (lease.stateDeclined()) {
+        stats_mgr.addValue(StatsMgr::generateName("subnet", lease.subnet_id_,
+                                                  "declined-addresses"),
+                           value);
+        stats_mgr.addValue("declined-addresses", value);
+    }
+}
+
+/// @brief Sets parameters common for DHCPv4 and DHCPv6 leases in the map.
+///
+/// @param lease Lease to be converted.
+/// @param [out] map Map to which the parameters are added.
+void
+commonToElement(const Lease& lease, const ElementPtr& map) {
+    map->set("ip-address", Element::create(lease.addr_.toText()));
+    map->set("subnet-id", Element::create(static_cast<long int>(lease.subnet_id_)));
+    map->set("valid-lft", Element::create(static_cast<long int>(lease.valid_lft_)));
+    map->set("cltt", Element::create(static_cast<long int>(lease.cltt_)));
+    map->set("fqdn-fwd", Element::create(lease.fqdn_fwd_));
+    map->set("fqdn-rev", Element::create(lease.fqdn_rev_));
+    map->set("hostname", Element::create(lease.hostname_));
+    map->set("state", Element::create(static_cast<long int>(lease.state_)));
+    if (lease.hwaddr_) {
+        map->set("hw-address", Element::create(lease.hwaddr_->toText(false)));
+    }
+}
+
+}
+
+namespace isc {
+namespace dhcp {
+
+const size_t LeaseCmds::DEFAULT_PAGE_SIZE;
+const size_t LeaseCmds::MAX_PAGE_SIZE;
+
+ConstElementPtr
+LeaseCmds::leaseAddHandler(const uint16_t family, const std::string&,
+                           const ConstElementPtr& params) {
+    try {
+        bool added = false;
+        if (family == AF_INET) {
+            Lease4Ptr lease = parseLease4(params);
+            added = LeaseMgrFactory::instance().addLease(lease);
+            if (added) {
+                updateStats(*lease, Lease::TYPE_V4, 1);
+            }
+        } else {
+            Lease6Ptr lease = parseLease6(params);
+            added = LeaseMgrFactory::instance().addLease(lease);
+            if (added) {
+                updateStats(*lease, lease->type_, 1);
+            }
+        }
+        if (!added) {
+            return (createAnswer(CONTROL_RESULT_ERROR, "lease for address "
+                                 + getString(params, "ip-address")
+                                 + " already exists"));
+        }
+
+    } catch (const std::exception& ex) {
+        return (createAnswer(CONTROL_RESULT_ERROR, ex.what()));
+    }
+
+    return (createAnswer(CONTROL_RESULT_SUCCESS, "Lease added."));
+}
+
+ConstElementPtr
+LeaseCmds::leaseGetHandler(const uint16_t family, const std::string&,
+                           const ConstElementPtr& params) {
+    try {
+        checkMap(params);
+        LeaseMgr& lease_mgr = LeaseMgrFactory::instance();
+        ElementPtr lease_map;
+
+        if (params->get("ip-address")) {
+            IOAddress addr = getAddress(family, params);
+            if (family == AF_INET) {
+                Lease4Ptr lease = lease_mgr.getLease4(addr);
+                if (lease) {
+                    lease_map = leaseToElement(lease);
+                }
+            } else {
+                Lease6Ptr lease = lease_mgr.getLease6(getLeaseType(params), addr);
+                if (lease) {
+                    lease_map = leaseToElement(lease);
+                }
+            }
+
+        } else {
+            std::string identifier_type = getString(params, "identifier-type");
+            std::string identifier = getString(params, "identifier");
+            SubnetID subnet_id = static_cast<SubnetID>(getInteger(params,
+                                                                  "subnet-id"));
+            Lease4Ptr lease4;
+            if ((family == AF_INET) && (identifier_type == "hw-address")) {
+                lease4 = lease_mgr.getLease4(HWAddr::fromText(identifier),
+                                             subnet_id);
+
+            } else if ((family == AF_INET) && (identifier_type == "client-id")) {
+                lease4 = lease_mgr.getLease4(*ClientId::fromText(identifier),
+                                             subnet_id);
+
+            } else if ((family == AF_INET6) && (identifier_type == "duid")) {
+                Lease6Ptr lease6 =
+                    lease_mgr.getLease6(getLeaseType(params),
+                                        DUID::fromText(identifier),
+                                        getInteger(params, "iaid"), subnet_id);
+                if (lease6) {
+                    lease_map = leaseToElement(lease6);
+                }
+
+            } else {
+                isc_throw(BadValue, "unsupported identifier type '"
+                          << identifier_type << "'");
+            }
+            if (lease4) {
+                lease_map = leaseToElement(lease4);
+            }
+        }
+
+        if (!lease_map) {
+            return (createAnswer(CONTROL_RESULT_EMPTY, "Lease not found."));
+        }
+        return (createAnswer(CONTROL_RESULT_SUCCESS, "Lease found.", lease_map));
+
+    } catch (const std::exception& ex) {
+        return (createAnswer(CONTROL_RESULT_ERROR, ex.what()));
+    }
+}
+
+ConstElementPtr
+LeaseCmds::leaseUpdateHandler(const uint16_t family, const std::string&,
+                              const ConstElementPtr& params) {
+    try {
+        LeaseMgr& lease_mgr = LeaseMgrFactory::instance();
+        if (family == AF_INET) {
+            Lease4Ptr lease = parseLease4(params);
+            Lease4Ptr old_lease = lease_mgr.getLease4(lease->addr_);
+            if (!old_lease) {
+                isc_throw(BadValue, "lease for address " << lease->addr_
+                          << " does not exist");
+            }
+            lease_mgr.updateLease4(lease);
+            updateStats(*old_lease, Lease::TYPE_V4, -1);
+            updateStats(*lease, Lease::TYPE_V4, 1);
+
+        } else {
+            Lease6Ptr lease = parseLease6(params);
+            Lease6Ptr old_lease = lease_mgr.getLease6(lease->type_, lease->addr_);
+            if (!old_lease) {
+                isc_throw(BadValue, "lease for address " << lease->addr_
+                          << " does not exist");
+            }
+            lease_mgr.updateLease6(lease);
+            updateStats(*old_lease, lease->type_, -1);
+            updateStats(*lease, lease->type_, 1);
+        }
+
+    } catch (const std::exception& ex) {
+        return (createAnswer(CONTROL_RESULT_ERROR, ex.what()));
+    }
+
+    return (createAnswer(CONTROL_RESULT_SUCCESS, "Lease updated."));
+}
+
+ConstElementPtr
+LeaseCmds::leaseDelHandler(const uint16_t family, const std::string&,
+                           const ConstElementPtr& params) {
+    try {
+        checkMap(params);
+        // The lease is needed to update the statistics.
+        LeaseMgr& lease_mgr = LeaseMgrFactory::instance();
+        bool deleted = false;
+        if (family == AF_INET) {
+            Lease4Ptr lease = lease_mgr.getLease4(getAddress(family, params));
+            deleted = (lease && lease_mgr.deleteLease(lease->addr_));
+            if (deleted) {
+                updateStats(*lease, Lease::TYPE_V4, -1);
+            }
+        } else {
+            Lease6Ptr lease = findLease6(params);
+            deleted = (lease && lease_mgr.deleteLease(lease->addr_));
+            if (deleted) {
+                updateStats(*lease, lease->type_, -1);
+            }
+        }
+        if (!deleted) {
+            return (createAnswer(CONTROL_RESULT_EMPTY,
+                                 "Lease not deleted (not found)."));
+        }
+
+    } catch (const std::exception& ex) {
+        return (createAnswer(CONTROL_RESULT_ERROR, ex.what()));
+    }
+
+    return (createAnswer(CONTROL_RESULT_SUCCESS, "Lease deleted."));
+}
+
+ConstElementPtr
+LeaseCmds::leaseGetAllHandler(const uint16_t family, const std::string&,
+                              const ConstElementPtr& params) {
+    try {
+        checkMap(params);
+
+        std::string from = getString(params, "from");
+        IOAddress lower_bound = (family == AF_INET ?
+                                 IOAddress::IPV4_ZERO_ADDRESS() :
+                                 IOAddress::IPV6_ZERO_ADDRESS());
+        if (from != "start") {
+            lower_bound = toAddress(family, from);
+        }
+
+        int64_t limit = getInteger(params, "limit", DEFAULT_PAGE_SIZE);
+        if ((limit == 0) || (limit > static_cast<int64_t>(MAX_PAGE_SIZE))) {
+            isc_throw(BadValue, "'limit' must be in the range of 1 to "
+                      << MAX_PAGE_SIZE);
+        }
+
+        ElementPtr leases = Element::createList();
+        std::string next;
+        LeaseMgr& lease_mgr = LeaseMgrFactory::instance();
+        if (family == AF_INET) {
+            Lease4Collection page = lease_mgr.getLeases4(lower_bound, limit);
+            for (Lease4Collection::const_iterator lease = page.begin();
+                 lease != page.end(); ++lease) {
+                leases->add(leaseToElement(*lease));
+            }
+            if (page.size() == static_cast<size_t>(limit)) {
+                next = page.back()->addr_.toText();
+            }
+
+        } else {
+            Lease6Collection page = lease_mgr.getLeases6(lower_bound, limit);
+            for (Lease6Collection::const_iterator lease = page.begin();
+                 lease != page.end(); ++lease) {
+                leases->add(leaseToElement(*lease));
+            }
+            if (page.size() == static_cast<size_t>(limit)) {
+                next = page.back()->addr_.toText();
+            }
+        }
+
+        if (leases->empty()) {
+            return (createAnswer(CONTROL_RESULT_EMPTY, "No more leases."));
+        }
+
+        ElementPtr args = Element::createMap();
+        args->set("leases", leases);
+        args->set("count", Element::create(static_cast<long int>(leases->size())));
+        if (!next.empty()) {
+            args->set("next", Element::create(next));
+        }
+        return (createAnswer(CONTROL_RESULT_SUCCESS, "Leases found.", args));
+
+    } catch (const std::exception& ex) {
+        return (createAnswer(CONTROL_RESULT_ERROR, ex.what()));
+    }
+}
+
+ElementPtr
+LeaseCmds::leaseToElement(const Lease4Ptr& lease) {
+    ElementPtr map = Element::createMap();
+    commonToElement(*lease, map);
+    if (lease->client_id_) {
+        map->set("client-id", Element::create(lease->client_id_->toText()));
+    }
+    return (map);
+}
+
+ElementPtr
+LeaseCmds::leaseToElement(const Lease6Ptr& lease) {
+    ElementPtr map = Element::createMap();
+    commonToElement(*lease, map);
+    map->set("type", Element::create(Lease::typeToText(lease->type_)));
+    if (lease->duid_) {
+        map->set("duid", Element::create(lease->duid_->toText()));
+    }
+    map->set("iaid", Element::create(static_cast<long int>(lease->iaid_)));
+    map->set("preferred-lft",
+             Element::create(static_cast<long int>(lease->preferred_lft_)));
+    if (lease->type_ == Lease::TYPE_PD) {
+        map->set("prefix-len",
+                 Element::create(static_cast<long int>(lease->prefixlen_)));
+    }
+    return (map);
+}
+
+}
+}
@@ -0,0 +1,191 @@
+// Copyright (C) 2017 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef LEASE_CMDS_H
+#define LEASE_CMDS_H
+
+#include <cc/data.h>
+#include <dhcpsrv/lease.h>
+#include <string>
+
+namespace isc {
+namespace dhcp {
+
+/// @brief Implements the control commands which query and modify the
+/// leases held by the lease database of the running server.
+///
+/// The commands operate on the lease manager returned by
+/// @c LeaseMgrFactory::instance, so they work with any of the lease
+/// database backends. The leases are converted to and from maps with
+/// the following parameters: "ip-address", "subnet-id", "valid-lft",
+/// "cltt", "fqdn-fwd", "fqdn-rev", "hostname", "state" and "hw-address".
+/// The DHCPv4 leases additionally hold "client-id". The DHCPv6 leases
+/// additionally hold "type", "duid", "iaid", "preferred-lft" and
+/// "prefix-len".
+///
+/// All methods are static, so as they can be registered in the
+/// @c isc::config::CommandMgr using @c boost::bind with the protocol
+/// family being bound to the first argument.
+class LeaseCmds {
+public:
+
+    /// @brief Default number of leases returned by the lease-get-all
+    /// command if the "limit" is not specified.
+    static const size_t DEFAULT_PAGE_SIZE = 100;
+
+    /// @brief Maximum number of leases returned by a single lease-get-all
+    /// command.
+    ///
+    /// This bounds the memory used to build the response and the time
+    /// during which the server doesn't process packets.
+    static const size_t MAX_PAGE_SIZE = 10000;
+
+    /// @brief Handles lease4-add and lease6-add commands.
+    ///
+    /// Example params structure:
+    /// {
+    ///     "ip-address": "192.0.2.202",
+    ///     "subnet-id": 1,
+    ///     "hw-address": "1a:1b:1c:1d:1e:1f"
+    /// }
+    ///
+    /// The "ip-address" and "subnet-id" are mandatory. The DHCPv4 lease
+    /// also requires "hw-address". The DHCPv6 lease requires "duid" and
+    /// "iaid", and "prefix-len" if the "type" is "IA_PD". The lifetimes
+    /// default to the values configured for the subnet and the "cltt"
+    /// defaults to the current time.
+    ///
+    /// The statistics of the assigned addresses (or prefixes) of the
+    /// lease's subnet are updated like for the lease allocated by the
+    /// server.
+    ///
+    /// @param family Protocol family, i.e. AF_INET or AF_INET6.
+    /// @param name Name of the command.
+    /// @param params Command arguments.
+    ///
+    /// @return Answer indicating whether the lease has been added.
+    static isc::data::ConstElementPtr
+    leaseAddHandler(const uint16_t family, const std::string& name,
+                    const isc::data::ConstElementPtr& params);
+
+    /// @brief Handles lease4-get and lease6-get commands.
+    ///
+    /// The lease is identified by its address (and "type" in case of
+    /// DHCPv6) or by the client identifier and the subnet identifier.
+    ///
+    /// Example params structures:
+    /// {
+    ///     "ip-address": "192.0.2.202"
+    /// }
+    ///
+    /// {
+    ///     "identifier-type": "hw-address",
+    ///     "identifier": "1a:1b:1c:1d:1e:1f",
+    ///     "subnet-id": 1
+    /// }
+    ///
+    /// The supported identifier types are "hw-address" and "client-id" for
+    /// DHCPv4, and "duid" for DHCPv6. The DHCPv6 lease identified by the
+    /// DUID also requires "iaid".
+    ///
+    /// @param family Protocol family, i.e. AF_INET or AF_INET6.
+    /// @param name Name of the command.
+    /// @param params Command arguments.
+    ///
+    /// @return Answer holding the lease or the status code
+    /// @c isc::config::CONTROL_RESULT_EMPTY if the lease doesn't exist.
+    static isc::data::ConstElementPtr
+    leaseGetHandler(const uint16_t family, const std::string& name,
+                    const isc::data::ConstElementPtr& params);
+
+    /// @brief Handles lease4-update and lease6-update commands.
+    ///
+    /// The arguments are the same as for the lease4-add and lease6-add
+    /// commands. The lease having the specified address must exist.
+    /// The statistics are moved from the old to the new lease's subnet
+    /// and state.
+    ///
+    /// @param family Protocol family, i.e. AF_INET or AF_INET6.
+    /// @param name Name of the command.
+    /// @param params Command arguments.
+    ///
+    /// @return Answer indicating whether the lease has been updated.
+    static isc::data::ConstElementPtr
+    leaseUpdateHandler(const uint16_t family, const std::string& name,
+                       const isc::data::ConstElementPtr& params);
+
+    /// @brief Handles lease4-del and lease6-del commands.
+    ///
+    /// The lease is identified by its address, e.g.
+    /// {
+    ///     "ip-address": "192.0.2.202"
+    /// }
+    ///
+    /// The DHCPv6 lease type may be specified with the "type" parameter.
+    /// If it is not specified, the lease of any type is deleted.
+    ///
+    /// The statistics of the assigned addresses (or prefixes) of the
+    /// lease's subnet are updated like for the lease removed by the
+    /// server.
+    ///
+    /// @param family Protocol family, i.e. AF_INET or AF_INET6.
+    /// @param name Name of the command.
+    /// @param params Command arguments.
+    ///
+    /// @return Answer indicating whether the lease has been deleted or the
+    /// status code @c isc::config::CONTROL_RESULT_EMPTY if the lease
+    /// doesn't exist.
+    static isc::data::ConstElementPtr
+    leaseDelHandler(const uint16_t family, const std::string& name,
+                    const isc::data::ConstElementPtr& params);
+
+    /// @brief Handles lease-get-all command.
+    ///
+    /// Returns one page of leases in the order of their addresses. The
+    /// page starts after the address specified with the "from" parameter,
+    /// or at the first lease if "from" is "start". The "limit" specifies
+    /// the maximum number of leases returned.
+    ///
+    /// Example params structure:
+    /// {
+    ///     "from": "192.0.2.202",
+    ///     "limit": 100
+    /// }
+    ///
+    /// The returned arguments hold the "leases" list and the "count" of
+    /// the leases returned. Unless the last page has been returned, they
+    /// also hold the "next" parameter which should be used as "from" to
+    /// get the next page.
+    ///
+    /// @param family Protocol family, i.e. AF_INET or AF_INET6.
+    /// @param name Name of the command (ignored, should be "lease-get-all").
+    /// @param params Command arguments.
+    ///
+    /// @return Answer holding the leases or the status code
+    /// @c isc::config::CONTROL_RESULT_EMPTY if there are no more leases.
+    static isc::data::ConstElementPtr
+    leaseGetAllHandler(const uint16_t family, const std::string& name,
+                       const isc::data::ConstElementPtr& params);
+
+    /// @brief Converts the DHCPv4 lease to the map returned by the commands.
+    ///
+    /// @param lease Pointer to the lease.
+    ///
+    /// @return Map holding the lease.
+    static isc::data::ElementPtr leaseToElement(const Lease4Ptr& lease);
+
+    /// @brief Converts the DHCPv6 lease to the map returned by the commands.
+    ///
+    /// @param lease Pointer to the lease.
+    ///
+    /// @return Map holding the lease.
+    static isc::data::ElementPtr leaseToElement(const Lease6Ptr& lease);
+};
+
+}
+}
+
+#endif // LEASE_CMDS_H
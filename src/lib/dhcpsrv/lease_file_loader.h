@@ -1,4 +1,4 @@
-// Copyright (C) 2015-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -124,7 +124,7 @@ public:
 
                 // Check if this lease exists.
                 typename StorageType::iterator lease_it =
-                    storage.find(lease->addr_);
+                    storage.find(storage.key_extractor()(lease));
                 // The lease doesn't exist yet. Insert the lease if
                 // it has a positive valid lifetime.
                 if (lease_it == storage.end()) {
@@ -0,0 +1,316 @@
+// Copyright (C) 2017 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <dhcpsrv/dhcpsrv_log.h>
+#include <dhcpsrv/lease_lookup_cache.h>
+#include <exceptions/exceptions.h>
+#include <vector>
+#include <time.h>
+
+using namespace isc::asiolink;
+
+namespace {
+
+/// @brief Returns the address preceding the specified address.
+///
+/// The zero address is returned unchanged.
+///
+/// @param address IPv4 or IPv6 address.
+IOAddress
+decreaseAddress(const IOAddress& address) {
+    std::vector<uint8_t> bytes = address.toBytes();
+    for (int i = bytes.size() - 1; i >= 0; --i) {
+        if (bytes[i] > 0) {
+            --bytes[i];
+            return (IOAddress::fromBytes(address.getFamily(), &bytes[0]));
+        }
+        bytes[i] = 0xff;
+    }
+    return (address);
+}
+
+/// @brief Retrieves a page of the IPv4 leases.
+///
+/// @param lease_mgr Lease manager.
+/// @param lower_bound Address preceding the first returned lease.
+/// @param page_size Maximum number of leases.
+/// @param [out] leases Retrieved leases.
+void
+getPage(const isc::dhcp::LeaseMgr& lease_mgr, const IOAddress& lower_bound,
+        const size_t page_size, isc::dhcp::Lease4Collection& leases) {
+    leases = lease_mgr.getLeases4(lower_bound, page_size);
+}
+
+/// @brief Retrieves a page of the IPv6 leases.
+///
+/// @param lease_mgr Lease manager.
+/// @param lower_bound Address preceding the first returned lease.
+/// @param page_size Maximum number of leases.
+/// @param [out] leases Retrieved leases.
+void
+getPage(const isc::dhcp::LeaseMgr& lease_mgr, const IOAddress& lower_bound,
+        const size_t page_size, isc::dhcp::Lease6Collection& leases) {
+    leases = lease_mgr.getLeases6(lower_bound, page_size);
+}
+
+/// @brief Checks if the IPv4 lease has the specified type.
+bool
+hasType(const isc::dhcp::Lease4Ptr&, const isc::dhcp::Lease::Type type) {
+    return (type == isc::dhcp::Lease::TYPE_V4);
+}
+
+/// @brief Checks if the IPv6 lease has the specified type.
+bool
+hasType(const isc::dhcp::Lease6Ptr& lease, const isc::dhcp::Lease::Type type) {
+    return (lease->type_ == type);
+}
+
+}
+
+namespace isc {
+namespace dhcp {
+
+const long LeaseLookupCache::DEFAULT_POOL_REFRESH_TIME;
+const long LeaseLookupCache::DEFAULT_CANDIDATE_TTL;
+const size_t LeaseLookupCache::MAX_POOL_LEASES;
+const size_t LeaseLookupCache::MAX_CANDIDATES;
+const size_t LeaseLookupCache::PAGE_SIZE;
+const size_t LeaseLookupCache::MAX_LOAD_PAGES;
+
+LeaseLookupCache::LeaseLookupCache(const long pool_refresh_time,
+                                   const long candidate_ttl)
+    : pool_refresh_time_(pool_refresh_time), candidate_ttl_(candidate_ttl),
+      pages_left_(MAX_LOAD_PAGES) {
+    if ((pool_refresh_time < 0) || (candidate_ttl < 0)) {
+        isc_throw(BadValue, "times used by the lease lookup cache must not"
+                  " be negative");
+    }
+}
+
+LeaseLookupCache::Status
+LeaseLookupCache::getStatus(const LeaseMgr& lease_mgr, const SubnetPtr& subnet,
+                            const Lease::Type type, const IOAddress& address) {
+    const time_t now = time(NULL);
+
+    // The addresses recently found in use take precedence over the summary.
+    std::map<Key, time_t>::iterator candidate =
+        candidates_.find(Key(type, address));
+    if (candidate != candidates_.end()) {
+        if (candidate->second > now) {
+            return (IN_USE);
+        }
+        candidates_.erase(candidate);
+    }
+
+    PoolPtr pool = subnet ? subnet->getPool(type, address, false) : PoolPtr();
+    if (!pool) {
+        return (UNKNOWN);
+    }
+
+    const PoolSummary* summary = getPoolSummary(lease_mgr, pool, type, now);
+    if (!summary) {
+        return (UNKNOWN);
+    }
+
+    std::map<IOAddress, int64_t>::const_iterator lease =
+        summary->in_use_.find(address);
+    if (lease != summary->in_use_.end()) {
+        // The lease which has expired since the summary was loaded may
+        // be reused, so it must be fetched from the database.
+        return (lease->second > now ? IN_USE : UNKNOWN);
+    }
+    if (summary->expired_.count(address) > 0) {
+        return (UNKNOWN);
+    }
+    return (FREE);
+}
+
+void
+LeaseLookupCache::markInUse(const Lease::Type type, const IOAddress& address) {
+    if (candidate_ttl_ == 0) {
+        return;
+    }
+
+    const time_t now = time(NULL);
+    if (candidates_.size() >= MAX_CANDIDATES) {
+        // Remove the addresses remembered long enough and start over if
+        // all of them are still remembered.
+        for (std::map<Key, time_t>::iterator candidate = candidates_.begin();
+             candidate != candidates_.end();) {
+            if (candidate->second <= now) {
+                candidates_.erase(candidate++);
+            } else {
+                ++candidate;
+            }
+        }
+        if (candidates_.size() >= MAX_CANDIDATES) {
+            candidates_.clear();
+        }
+    }
+    candidates_[Key(type, address)] = now + candidate_ttl_;
+}
+
+void
+LeaseLookupCache::invalidate(const Lease::Type type, const IOAddress& address) {
+    candidates_.erase(Key(type, address));
+    exhausted_.clear();
+
+    // The summary of the pool which the address belongs to is the last one
+    // beginning at or before the address.
+    std::map<Key, PoolSummary>::iterator summary =
+        pools_.upper_bound(Key(type, address));
+    if (summary == pools_.begin()) {
+        return;
+    }
+    --summary;
+    if ((summary->first.first == type) && !(summary->second.last_ < address)) {
+        pools_.erase(summary);
+    }
+}
+
+void
+LeaseLookupCache::markExhausted(const SubnetID& subnet_id,
+                                const Lease::Type type) {
+    exhausted_[std::make_pair(subnet_id, type)] = time(NULL);
+}
+
+bool
+LeaseLookupCache::isExhausted(const SubnetID& subnet_id,
+                              const Lease::Type type) const {
+    std::map<std::pair<SubnetID, Lease::Type>, time_t>::const_iterator
+        subnet = exhausted_.find(std::make_pair(subnet_id, type));
+    return ((subnet != exhausted_.end()) &&
+            (time(NULL) - subnet->second < pool_refresh_time_));
+}
+
+void
+LeaseLookupCache::clear() {
+    pools_.clear();
+    candidates_.clear();
+    exhausted_.clear();
+}
+
+size_t
+LeaseLookupCache::getPoolLeasesNum(const Lease::Type type,
+                                   const IOAddress& first) const {
+    std::map<Key, PoolSummary>::const_iterator summary =
+        pools_.find(Key(type, first));
+    if ((summary == pools_.end()) || !summary->second.complete_) {
+        return (0);
+    }
+    return (summary->second.in_use_.size() + summary->second.expired_.size());
+}
+
+const LeaseLookupCache::PoolSummary*
+LeaseLookupCache::getPoolSummary(const LeaseMgr& lease_mgr, const PoolPtr& pool,
+                                 const Lease::Type type, const time_t now) {
+    // The SQL backends order the IPv6 addresses as text, so the pages of
+    // the leases don't follow the address order.
+    if ((type != Lease::TYPE_V4) && (lease_mgr.getType() != "memfile")) {
+        return (0);
+    }
+
+    PoolSummary& summary = pools_[Key(type, pool->getFirstAddress())];
+    if (summary.last_ != pool->getLastAddress()) {
+        summary = PoolSummary();
+        summary.last_ = pool->getLastAddress();
+    }
+
+    if (!summary.loading_ &&
+        (now - summary.load_started_ >= pool_refresh_time_)) {
+        summary.loading_ = true;
+        summary.load_started_ = now;
+        summary.lower_bound_ = decreaseAddress(pool->getFirstAddress());
+        summary.loaded_in_use_.clear();
+        summary.loaded_expired_.clear();
+    }
+
+    if (summary.loading_ && (pages_left_ > 0)) {
+        try {
+            if (type == Lease::TYPE_V4) {
+                loadPool<Lease4Collection>(lease_mgr, pool, type, summary);
+            } else {
+                loadPool<Lease6Collection>(lease_mgr, pool, type, summary);
+            }
+
+        } catch (const std::exception& ex) {
+            summary.complete_ = false;
+            summary.in_use_.clear();
+            summary.expired_.clear();
+            summary.loading_ = false;
+            summary.loaded_in_use_.clear();
+            summary.loaded_expired_.clear();
+            LOG_WARN(dhcpsrv_logger, DHCPSRV_LEASE_LOOKUP_CACHE_LOAD_FAILED)
+                .arg(pool->toText()).arg(ex.what());
+        }
+    }
+
+    // The previous summary is used while the new one is being loaded,
+    // unless it has become too old.
+    if (!summary.complete_ ||
+        (now - summary.refreshed_ > 2 * pool_refresh_time_)) {
+        return (0);
+    }
+    return (&summary);
+}
+
+template<typename LeaseCollectionType>
+void
+LeaseLookupCache::loadPool(const LeaseMgr& lease_mgr, const PoolPtr& pool,
+                           const Lease::Type type, PoolSummary& summary) {
+    const IOAddress& last = pool->getLastAddress();
+    while (pages_left_ > 0) {
+        --pages_left_;
+        LeaseCollectionType leases;
+        getPage(lease_mgr, summary.lower_bound_, PAGE_SIZE, leases);
+        bool done = (leases.size() < PAGE_SIZE);
+        for (typename LeaseCollectionType::const_iterator lease = leases.begin();
+             lease != leases.end(); ++lease) {
+            if (last < (*lease)->addr_) {
+                done = true;
+                break;
+            }
+            if (!hasType(*lease, type)) {
+                continue;
+            }
+            if ((*lease)->expired()) {
+                summary.loaded_expired_.insert((*lease)->addr_);
+            } else {
+                summary.loaded_in_use_[(*lease)->addr_] =
+                    (*lease)->getExpirationTime();
+            }
+
+            // Don't retain the summary of a heavily used pool.
+            if (summary.loaded_in_use_.size() +
+                summary.loaded_expired_.size() > MAX_POOL_LEASES) {
+                summary.complete_ = false;
+                summary.in_use_.clear();
+                summary.expired_.clear();
+                summary.loading_ = false;
+                summary.loaded_in_use_.clear();
+                summary.loaded_expired_.clear();
+                return;
+            }
+        }
+
+        if (done) {
+            summary.complete_ = true;
+            summary.refreshed_ = summary.load_started_;
+            summary.in_use_.swap(summary.loaded_in_use_);
+            summary.expired_.swap(summary.loaded_expired_);
+            summary.loading_ = false;
+            summary.loaded_in_use_.clear();
+            summary.loaded_expired_.clear();
+            return;
+        }
+        summary.lower_bound_ = leases.back()->addr_;
+    }
+}
+
+} // end of isc::dhcp namespace
+} // end of isc namespace
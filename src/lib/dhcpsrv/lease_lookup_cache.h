@@ -0,0 +1,284 @@
+// Copyright (C) 2017 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef LEASE_LOOKUP_CACHE_H
+#define LEASE_LOOKUP_CACHE_H
+
+#include <asiolink/io_address.h>
+#include <dhcpsrv/lease.h>
+#include <dhcpsrv/lease_mgr.h>
+#include <dhcpsrv/subnet.h>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <map>
+#include <set>
+#include <utility>
+
+namespace isc {
+namespace dhcp {
+
+/// @brief Cache of the lease database state used by the allocation engine.
+///
+/// When the allocation engine searches a pool for a free address, it checks
+/// each candidate address returned by the allocator in the lease database.
+/// For the SQL backends, each check is a round-trip to the database server,
+/// and most of the checks either find that the address is in use (in the
+/// densely used pools) or that there is no lease for it (in the sparsely
+/// used pools).
+///
+/// This cache holds the summary of the leases in each pool used by the
+/// allocation engine, loaded from the lease database in pages and refreshed
+/// when it is older than the configured refresh time. Loading the summary
+/// of a large pool takes many round-trips, so at most @c MAX_LOAD_PAGES
+/// pages are loaded for each allocation, see @c startAllocation, and the
+/// summary is loaded over several allocations. The previous summary is
+/// used until the new one has been loaded, as long as it isn't older than
+/// twice the refresh time. The cache also holds the addresses recently found
+/// in use by the allocation engine, for the configured time.
+///
+/// The allocation engine skips the addresses which the cache reports as
+/// in use. The addresses which the cache reports as free are still looked
+/// up in the lease database, because the summary may be stale. The cache
+/// doesn't know about the leases released by other servers since it was
+/// refreshed, so the allocation engine checks the whole pool again in the
+/// database when it finds no free address using the cache. If no address
+/// is found either, the subnet is remembered as exhausted and the allocation
+/// engine doesn't check the pool in the database again for the refresh
+/// time. The summary of the pool is only dropped before the refresh time
+/// when its leases are known to have changed, see @c invalidate.
+///
+/// The summary of the pool holding more than @c MAX_POOL_LEASES leases is
+/// not retained, because loading it would take more time than it saves.
+///
+/// The summaries of the IPv6 pools are only loaded from the memfile
+/// backend. The SQL backends hold the IPv6 addresses as text, so the pages
+/// of the IPv6 leases are ordered as text rather than by the addresses and
+/// the leases of a pool can't be retrieved by the address range. The
+/// addresses recently found in use are remembered for all lease types.
+class LeaseLookupCache : public boost::noncopyable {
+public:
+
+    /// @brief Status of the address known to the cache.
+    enum Status {
+        /// The address must be checked in the lease database.
+        UNKNOWN,
+        /// There is no lease for the address in the pool summary. The
+        /// address must still be confirmed in the lease database, because
+        /// the summary may be stale.
+        FREE,
+        /// The address is leased and the lease hasn't expired.
+        IN_USE
+    };
+
+    /// @brief Default time in seconds after which the pool summary is
+    /// refreshed.
+    static const long DEFAULT_POOL_REFRESH_TIME = 10;
+
+    /// @brief Default time in seconds for which the addresses found in use
+    /// are remembered.
+    static const long DEFAULT_CANDIDATE_TTL = 2;
+
+    /// @brief Maximum number of leases in the pool summary.
+    static const size_t MAX_POOL_LEASES = 65536;
+
+    /// @brief Maximum number of the remembered addresses.
+    static const size_t MAX_CANDIDATES = 4096;
+
+    /// @brief Number of leases retrieved from the lease database at once.
+    static const size_t PAGE_SIZE = 1024;
+
+    /// @brief Maximum number of pages of leases loaded for an allocation.
+    static const size_t MAX_LOAD_PAGES = 4;
+
+    /// @brief Constructor.
+    ///
+    /// @param pool_refresh_time Time in seconds after which the pool summary
+    /// is refreshed.
+    /// @param candidate_ttl Time in seconds for which the addresses found
+    /// in use are remembered.
+    ///
+    /// @throw isc::BadValue if any of the times is negative.
+    LeaseLookupCache(const long pool_refresh_time = DEFAULT_POOL_REFRESH_TIME,
+                     const long candidate_ttl = DEFAULT_CANDIDATE_TTL);
+
+    /// @brief Allows loading more pages of leases.
+    ///
+    /// Called by the allocation engine before each allocation. Until the
+    /// next call, at most @c MAX_LOAD_PAGES pages are loaded.
+    void startAllocation() {
+        pages_left_ = MAX_LOAD_PAGES;
+    }
+
+    /// @brief Returns the status of the address.
+    ///
+    /// Continues loading the summary of the pool which the address belongs
+    /// to from the lease database if it hasn't been loaded yet or it is older
+    /// than the refresh time.
+    ///
+    /// @param lease_mgr Lease manager from which the pool summary is loaded.
+    /// @param subnet Subnet which the address belongs to.
+    /// @param type Type of the lease.
+    /// @param address Address or delegated prefix.
+    ///
+    /// @return Status of the address.
+    Status getStatus(const LeaseMgr& lease_mgr, const SubnetPtr& subnet,
+                     const Lease::Type type,
+                     const asiolink::IOAddress& address);
+
+    /// @brief Remembers that the address is in use.
+    ///
+    /// The address is reported in use for the candidate TTL time, even if
+    /// the pool summary is refreshed in the meantime.
+    ///
+    /// @param type Type of the lease.
+    /// @param address Address or delegated prefix.
+    void markInUse(const Lease::Type type, const asiolink::IOAddress& address);
+
+    /// @brief Drops the cached state of the address.
+    ///
+    /// Called when the lease for the address has been removed or allocated
+    /// while the cache reported it in use. The summary of the pool which
+    /// the address belongs to is dropped and loaded again when needed. No
+    /// subnet is reported exhausted until it is found exhausted again.
+    ///
+    /// @param type Type of the lease.
+    /// @param address Address or delegated prefix.
+    void invalidate(const Lease::Type type, const asiolink::IOAddress& address);
+
+    /// @brief Remembers that no address can be allocated in the subnet.
+    ///
+    /// The subnet is reported exhausted for the refresh time, unless any
+    /// address is invalidated in the meantime.
+    ///
+    /// @param subnet_id Identifier of the subnet.
+    /// @param type Type of the lease.
+    void markExhausted(const SubnetID& subnet_id, const Lease::Type type);
+
+    /// @brief Checks if the subnet has been recently found exhausted.
+    ///
+    /// @param subnet_id Identifier of the subnet.
+    /// @param type Type of the lease.
+    ///
+    /// @return true if the subnet has been marked exhausted within the
+    /// refresh time.
+    bool isExhausted(const SubnetID& subnet_id, const Lease::Type type) const;
+
+    /// @brief Removes all pool summaries, remembered addresses and
+    /// exhausted subnets.
+    void clear();
+
+    /// @brief Returns the number of leases in the summary of the pool.
+    ///
+    /// @param type Type of the lease.
+    /// @param first First address of the pool.
+    ///
+    /// @return Number of leases or 0 if the summary is not retained.
+    size_t getPoolLeasesNum(const Lease::Type type,
+                            const asiolink::IOAddress& first) const;
+
+private:
+
+    /// @brief Key of the pool summaries and remembered addresses.
+    typedef std::pair<Lease::Type, asiolink::IOAddress> Key;
+
+    /// @brief Summary of the leases in a pool.
+    struct PoolSummary {
+        /// @brief Constructor.
+        PoolSummary()
+            : last_(asiolink::IOAddress::IPV4_ZERO_ADDRESS()), refreshed_(0),
+              complete_(false), load_started_(0), loading_(false),
+              lower_bound_(asiolink::IOAddress::IPV4_ZERO_ADDRESS()) {
+        }
+
+        /// @brief Last address of the pool.
+        asiolink::IOAddress last_;
+
+        /// @brief Time when the loading of the held leases started.
+        time_t refreshed_;
+
+        /// @brief Indicates if the summary holds all leases in the pool.
+        bool complete_;
+
+        /// @brief Expiration times of the valid leases by addresses.
+        std::map<asiolink::IOAddress, int64_t> in_use_;
+
+        /// @brief Addresses of the expired leases.
+        std::set<asiolink::IOAddress> expired_;
+
+        /// @brief Time when the last loading of the summary started.
+        time_t load_started_;
+
+        /// @brief Indicates if the summary is being loaded.
+        bool loading_;
+
+        /// @brief Address of the last lease loaded so far.
+        asiolink::IOAddress lower_bound_;
+
+        /// @brief Valid leases loaded so far.
+        std::map<asiolink::IOAddress, int64_t> loaded_in_use_;
+
+        /// @brief Expired leases loaded so far.
+        std::set<asiolink::IOAddress> loaded_expired_;
+    };
+
+    /// @brief Returns the summary of the pool, continuing to load it if
+    /// necessary.
+    ///
+    /// @param lease_mgr Lease manager from which the pool summary is loaded.
+    /// @param pool Pool.
+    /// @param type Type of the lease.
+    /// @param now Current time.
+    ///
+    /// @return Pointer to the summary or null if it is not complete.
+    const PoolSummary* getPoolSummary(const LeaseMgr& lease_mgr,
+                                      const PoolPtr& pool,
+                                      const Lease::Type type,
+                                      const time_t now);
+
+    /// @brief Loads the next pages of the leases in the pool from the lease
+    /// database.
+    ///
+    /// The summary is replaced with the loaded leases when all leases in
+    /// the pool have been loaded.
+    ///
+    /// @param lease_mgr Lease manager from which the leases are loaded.
+    /// @param pool Pool.
+    /// @param type Type of the lease.
+    /// @param [out] summary Summary being loaded.
+    ///
+    /// @tparam LeaseCollectionType One of the @c Lease4Collection or
+    /// @c Lease6Collection.
+    template<typename LeaseCollectionType>
+    void loadPool(const LeaseMgr& lease_mgr, const PoolPtr& pool,
+                  const Lease::Type type, PoolSummary& summary);
+
+    /// @brief Time in seconds after which the pool summary is refreshed.
+    long pool_refresh_time_;
+
+    /// @brief Time in seconds for which the addresses are remembered.
+    long candidate_ttl_;
+
+    /// @brief Pool summaries by first addresses of the pools.
+    std::map<Key, PoolSummary> pools_;
+
+    /// @brief Times until which the addresses are remembered in use.
+    std::map<Key, time_t> candidates_;
+
+    /// @brief Times when the subnets have been found exhausted.
+    std::map<std::pair<SubnetID, Lease::Type>, time_t> exhausted_;
+
+    /// @brief Number of pages which may still be loaded for the current
+    /// allocation.
+    size_t pages_left_;
+};
+
+/// @brief Pointer to the @c LeaseLookupCache.
+typedef boost::shared_ptr<LeaseLookupCache> LeaseLookupCachePtr;
+
+} // end of isc::dhcp namespace
+} // end of isc namespace
+
+#endif // LEASE_LOOKUP_CACHE_H
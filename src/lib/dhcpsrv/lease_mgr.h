@@ -1,4 +1,4 @@
-// Copyright (C) 2012-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2012-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -439,6 +439,37 @@ public:
     virtual void getExpiredLeases4(Lease4Collection& expired_leases,
                                    const size_t max_leases) const = 0;
 
+    /// @brief Returns a page of DHCPv4 leases.
+    ///
+    /// The leases are returned in the ascending order of addresses, starting
+    /// from the first address greater than @c lower_bound_address. All leases
+    /// in the database may be retrieved in pages of a bounded size by using
+    /// the address of the last lease returned as the lower bound for the next
+    /// call, until an empty collection is returned.
+    ///
+    /// @param lower_bound_address IPv4 address used as a cursor. Use 0.0.0.0
+    /// to retrieve the first page.
+    /// @param page_size Maximum number of leases to be returned.
+    ///
+    /// @return Collection of leases, empty if there are no more leases.
+    virtual Lease4Collection
+    getLeases4(const asiolink::IOAddress& lower_bound_address,
+               const size_t page_size) const = 0;
+
+    /// @brief Returns a page of DHCPv6 leases.
+    ///
+    /// This method works in the same way as @c getLeases4, but for the
+    /// DHCPv6 leases of all types.
+    ///
+    /// @param lower_bound_address IPv6 address used as a cursor. Use ::
+    /// to retrieve the first page.
+    /// @param page_size Maximum number of leases to be returned.
+    ///
+    /// @return Collection of leases, empty if there are no more leases.
+    virtual Lease6Collection
+    getLeases6(const asiolink::IOAddress& lower_bound_address,
+               const size_t page_size) const = 0;
+
     /// @brief Updates IPv4 lease.
     ///
     /// @param lease4 The lease to be updated.
@@ -589,6 +620,17 @@ public:
     /// support transactions, this is a no-op.
     virtual void rollback() = 0;
 
+    /// @brief Re-installs timers used by the backend.
+    ///
+    /// The server unregisters all timers when it is being reconfigured.
+    /// If the lease manager instance is preserved during the reconfiguration
+    /// because the lease database access string hasn't changed, this method
+    /// is called to install the timers used by the backend again, e.g.
+    /// the timer triggering the Lease File Cleanup in the Memfile backend.
+    ///
+    /// The default implementation is no-op.
+    virtual void reinstallTimers() { }
+
     /// @todo: Add host management here
     /// As host reservation is outside of scope for 2012, support for hosts
     /// is currently postponed.
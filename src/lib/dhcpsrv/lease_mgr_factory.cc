@@ -1,4 +1,4 @@
-// Copyright (C) 2012-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2012-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -40,8 +40,40 @@ LeaseMgrFactory::getLeaseMgrPtr() {
     return (leaseMgrPtr);
 }
 
+std::string&
+LeaseMgrFactory::getDbAccessStringRef() {
+    static std::string db_access_string;
+    return (db_access_string);
+}
+
 void
 LeaseMgrFactory::create(const std::string& dbaccess) {
+    // The access string is only remembered when the lease manager has been
+    // successfully created.
+    getDbAccessStringRef().clear();
+
+    getLeaseMgrPtr().reset(createLeaseMgr(dbaccess));
+    getDbAccessStringRef() = dbaccess;
+}
+
+boost::shared_ptr<LeaseMgr>
+LeaseMgrFactory::createConnection() {
+    if (!haveInstance()) {
+        isc_throw(NoLeaseManager, "no current lease manager is available");
+    }
+
+    // The memfile backend holds the leases in the memory of the current
+    // lease manager, so the new instance wouldn't share them.
+    if (instance().getType() == "memfile") {
+        isc_throw(NotImplemented, "the memfile lease database backend doesn't"
+                  " support multiple connections");
+    }
+
+    return (boost::shared_ptr<LeaseMgr>(createLeaseMgr(getDbAccessString())));
+}
+
+LeaseMgr*
+LeaseMgrFactory::createLeaseMgr(const std::string& dbaccess) {
     const std::string type = "type";
 
     // Parse the access string and create a redacted string for logging.
@@ -60,28 +92,24 @@ LeaseMgrFactory::create(const std::string& dbaccess) {
 #ifdef HAVE_MYSQL
     if (parameters[type] == string("mysql")) {
         LOG_INFO(dhcpsrv_logger, DHCPSRV_MYSQL_DB).arg(redacted);
-        getLeaseMgrPtr().reset(new MySqlLeaseMgr(parameters));
-        return;
+        return (new MySqlLeaseMgr(parameters));
     }
 #endif
 #ifdef HAVE_PGSQL
     if (parameters[type] == string("postgresql")) {
         LOG_INFO(dhcpsrv_logger, DHCPSRV_PGSQL_DB).arg(redacted);
-        getLeaseMgrPtr().reset(new PgSqlLeaseMgr(parameters));
-        return;
+        return (new PgSqlLeaseMgr(parameters));
     }
 #endif
 #ifdef HAVE_CQL
     if (parameters[type] == string("cql")) {
         LOG_INFO(dhcpsrv_logger, DHCPSRV_CQL_DB).arg(redacted);
-        getLeaseMgrPtr().reset(new CqlLeaseMgr(parameters));
-        return;
+        return (new CqlLeaseMgr(parameters));
     }
 #endif
     if (parameters[type] == string("memfile")) {
         LOG_INFO(dhcpsrv_logger, DHCPSRV_MEMFILE_DB).arg(redacted);
-        getLeaseMgrPtr().reset(new Memfile_LeaseMgr(parameters));
-        return;
+        return (new Memfile_LeaseMgr(parameters));
     }
 
     // Get here on no match
@@ -99,6 +127,7 @@ LeaseMgrFactory::destroy() {
             .arg(getLeaseMgrPtr()->getType());
     }
     getLeaseMgrPtr().reset();
+    getDbAccessStringRef().clear();
 }
 
 bool 
@@ -106,6 +135,11 @@ LeaseMgrFactory::haveInstance() {
     return (getLeaseMgrPtr().get());
 }
 
+const std::string&
+LeaseMgrFactory::getDbAccessString() {
+    return (getDbAccessStringRef());
+}
+
 LeaseMgr&
 LeaseMgrFactory::instance() {
     LeaseMgr* lmptr = getLeaseMgrPtr().get();
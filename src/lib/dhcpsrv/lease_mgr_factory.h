@@ -1,4 +1,4 @@
-// Copyright (C) 2012-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2012-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -12,6 +12,7 @@
 #include <exceptions/exceptions.h>
 
 #include <boost/scoped_ptr.hpp>
+#include <boost/shared_ptr.hpp>
 
 #include <string>
 
@@ -90,7 +91,37 @@ public:
     /// @return True if the lease manager instance exists, false otherwise.
     static bool haveInstance();
 
+    /// @brief Returns the access string used to create the current lease
+    /// manager.
+    ///
+    /// @return Database access string or an empty string if the lease
+    /// manager hasn't been created.
+    static const std::string& getDbAccessString();
+
+    /// @brief Opens another connection to the current lease database.
+    ///
+    /// The returned lease manager is not the current lease manager. It is
+    /// used by the threads which must not share the connection with the
+    /// main thread, e.g. the thread reclaiming the expired leases.
+    ///
+    /// @return Pointer to the new lease manager.
+    /// @throw isc::dhcp::NoLeaseManager No lease manager is available.
+    /// @throw isc::NotImplemented The current lease manager is the memfile
+    ///        backend, which holds the leases in its own memory.
+    static boost::shared_ptr<LeaseMgr> createConnection();
+
 private:
+    /// @brief Creates the lease manager for the access string.
+    ///
+    /// @param dbaccess Database access parameters.
+    ///
+    /// @return Pointer to the new lease manager owned by the caller.
+    /// @throw isc::InvalidParameter dbaccess string does not contain the "type"
+    ///        keyword.
+    /// @throw isc::dhcp::InvalidType The "type" keyword in dbaccess does not
+    ///        identify a supported backend.
+    static LeaseMgr* createLeaseMgr(const std::string& dbaccess);
+
     /// @brief Hold pointer to lease manager
     ///
     /// Holds a pointer to the singleton lease manager.  The singleton
@@ -98,6 +129,12 @@ private:
     /// fiasco" if defined in an external static variable.
     static boost::scoped_ptr<LeaseMgr>& getLeaseMgrPtr();
 
+    /// @brief Holds the access string used to create the lease manager.
+    ///
+    /// The string is encapsulated in this method for the same reason
+    /// as the pointer to the lease manager.
+    static std::string& getDbAccessStringRef();
+
 };
 
 }; // end of isc::dhcp namespace
@@ -0,0 +1,611 @@
+// Copyright (C) 2017 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <dhcp/iface_mgr.h>
+#include <dhcpsrv/alloc_engine_log.h>
+#include <dhcpsrv/dhcpsrv_log.h>
+#include <dhcpsrv/lease_reclamation_worker.h>
+#include <stats/stats_mgr.h>
+#include <util/stopwatch.h>
+#include <boost/bind.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/foreach.hpp>
+#include <algorithm>
+#include <cerrno>
+#include <sys/select.h>
+
+using namespace isc::stats;
+using namespace isc::util;
+using namespace isc::util::thread;
+using namespace boost::posix_time;
+
+namespace {
+
+/// @name Family specific lease database operations used by the worker.
+//@{
+
+/// @brief Retrieves the expired IPv4 leases.
+void
+getExpiredLeases(isc::dhcp::LeaseMgr& lease_mgr,
+                 isc::dhcp::Lease4Collection& leases,
+                 const size_t max_leases) {
+    lease_mgr.getExpiredLeases4(leases, max_leases);
+}
+
+/// @brief Retrieves the expired IPv6 leases.
+void
+getExpiredLeases(isc::dhcp::LeaseMgr& lease_mgr,
+                 isc::dhcp::Lease6Collection& leases,
+                 const size_t max_leases) {
+    lease_mgr.getExpiredLeases6(leases, max_leases);
+}
+
+/// @brief Retrieves the current version of the IPv4 lease.
+isc::dhcp::Lease4Ptr
+getLease(isc::dhcp::LeaseMgr& lease_mgr, const isc::dhcp::Lease4Ptr& lease) {
+    return (lease_mgr.getLease4(lease->addr_));
+}
+
+/// @brief Retrieves the current version of the IPv6 lease.
+isc::dhcp::Lease6Ptr
+getLease(isc::dhcp::LeaseMgr& lease_mgr, const isc::dhcp::Lease6Ptr& lease) {
+    return (lease_mgr.getLease6(lease->type_, lease->addr_));
+}
+
+/// @brief Updates the IPv4 lease.
+void
+updateLease(isc::dhcp::LeaseMgr& lease_mgr, const isc::dhcp::Lease4Ptr& lease) {
+    lease_mgr.updateLease4(lease);
+}
+
+/// @brief Updates the IPv6 lease.
+void
+updateLease(isc::dhcp::LeaseMgr& lease_mgr, const isc::dhcp::Lease6Ptr& lease) {
+    lease_mgr.updateLease6(lease);
+}
+
+/// @brief Checks if the address of the reclaimed lease has been allocated
+/// again since the lease has been reclaimed.
+///
+/// The worker leaves the reclaimed lease in the expired-reclaimed state
+/// or removes it, so any other lease found for the address belongs to
+/// a client which has been allocated this address in the meantime.
+///
+/// @param lease Pointer to the lease as it was before the reclamation.
+/// @tparam LeasePtrType One of the @c Lease4Ptr or @c Lease6Ptr.
+template<typename LeasePtrType>
+bool
+isLeaseReused(const LeasePtrType& lease) {
+    if (!isc::dhcp::LeaseMgrFactory::haveInstance()) {
+        return (false);
+    }
+    LeasePtrType current = getLease(isc::dhcp::LeaseMgrFactory::instance(),
+                                    lease);
+    return (current && (!current->stateExpiredReclaimed() ||
+                        (current->cltt_ != lease->cltt_)));
+}
+
+/// @brief Creates a copy of the IPv4 lease.
+isc::dhcp::Lease4Ptr
+copyLease(const isc::dhcp::Lease4Ptr& lease) {
+    return (isc::dhcp::Lease4Ptr(new isc::dhcp::Lease4(*lease)));
+}
+
+/// @brief Creates a copy of the IPv6 lease.
+isc::dhcp::Lease6Ptr
+copyLease(const isc::dhcp::Lease6Ptr& lease) {
+    return (isc::dhcp::Lease6Ptr(new isc::dhcp::Lease6(*lease)));
+}
+
+//@}
+
+}
+
+namespace isc {
+namespace dhcp {
+
+const size_t LeaseReclamationWorker::MAX_PENDING_LEASES;
+const long LeaseReclamationWorker::PENDING_LEASES_WAIT_TIME;
+
+LeaseReclamationWorker::
+LeaseReclamationWorker(const bool ipv6, const AllocEnginePtr& alloc_engine,
+                       const CfgExpiration& cfg_expiration,
+                       const ConnectionFactory& connection_factory)
+    : ipv6_(ipv6), alloc_engine_(alloc_engine),
+      connection_factory_(connection_factory), lease_mgr_(),
+      reclaim_interval_(0), flush_interval_(0),
+      hold_reclaimed_time_(cfg_expiration.getHoldReclaimedTime()),
+      max_reclaim_leases_(cfg_expiration.getMaxReclaimLeases()),
+      max_reclaim_time_(cfg_expiration.getMaxReclaimTime()),
+      unwarned_reclaim_cycles_(cfg_expiration.getUnwarnedReclaimCycles()),
+      incomplete_cycles_(0), thread_(), mutex_(), started_cond_(),
+      started_(false), start_error_(), stopping_(false), reclaimed4_(),
+      reclaimed6_(), cycles_(0), backlog_(0), notified_(false),
+      ready_socket_(), wakeup_socket_() {
+    if (!alloc_engine_) {
+        isc_throw(BadValue, "allocation engine must not be null");
+    }
+
+    if (connection_factory_.empty()) {
+        isc_throw(BadValue, "lease database connection factory must be"
+                  " specified");
+    }
+
+    if (AllocEngine::reclamationCalloutsPresent(ipv6_)) {
+        isc_throw(InvalidOperation, "the expired leases can't be reclaimed by"
+                  " the thread when callouts are installed for the lease"
+                  " expire or recover hook points");
+    }
+
+    // In the test mode the intervals are expressed in milliseconds.
+    const long multiplier = cfg_expiration.getTestMode() ? 1 : 1000;
+    reclaim_interval_ = multiplier * cfg_expiration.getReclaimTimerWaitTime();
+    flush_interval_ = multiplier *
+        cfg_expiration.getFlushReclaimedTimerWaitTime();
+}
+
+LeaseReclamationWorker::~LeaseReclamationWorker() {
+    try {
+        stop();
+    } catch (...) {
+        // Destructors must not throw.
+    }
+}
+
+void
+LeaseReclamationWorker::start() {
+    if (thread_) {
+        isc_throw(InvalidOperation, "the thread reclaiming expired leases"
+                  " is already running");
+    }
+
+    // The loggers are lazily initialized on the first use, which is not
+    // thread safe. Make sure they are initialized before the thread starts.
+    alloc_engine_logger.isDebugEnabled();
+    dhcpsrv_logger.isDebugEnabled();
+
+    {
+        Mutex::Locker lock(mutex_);
+        started_ = false;
+        start_error_.clear();
+        stopping_ = false;
+    }
+
+    IfaceMgr::instance().addExternalSocket(ready_socket_.getSelectFd(),
+        boost::bind(&LeaseReclamationWorker::processReclaimedLeases, this));
+
+    std::string error;
+    try {
+        thread_.reset(new Thread(boost::bind(&LeaseReclamationWorker::run,
+                                             this)));
+
+        // Wait for the thread to open the connection to the lease database.
+        Mutex::Locker lock(mutex_);
+        while (!started_) {
+            started_cond_.wait(mutex_);
+        }
+        error = start_error_;
+
+    } catch (const std::exception& ex) {
+        error = ex.what();
+    }
+
+    if (!error.empty()) {
+        if (thread_) {
+            thread_->wait();
+            thread_.reset();
+        }
+        IfaceMgr::instance().deleteExternalSocket(ready_socket_.getSelectFd());
+        isc_throw(Unexpected, "failed to start the thread reclaiming expired"
+                  " leases: " << error);
+    }
+
+    LOG_INFO(dhcpsrv_logger, DHCPSRV_RECLAMATION_THREAD_STARTED);
+}
+
+void
+LeaseReclamationWorker::stop() {
+    if (!thread_) {
+        return;
+    }
+
+    {
+        Mutex::Locker lock(mutex_);
+        stopping_ = true;
+    }
+    wakeup_socket_.markReady();
+    thread_->wait();
+    thread_.reset();
+    wakeup_socket_.clearReady();
+
+    IfaceMgr::instance().deleteExternalSocket(ready_socket_.getSelectFd());
+
+    // Complete the reclamation of the leases the thread has handed over.
+    processReclaimedLeases();
+
+    LOG_INFO(dhcpsrv_logger, DHCPSRV_RECLAMATION_THREAD_STOPPED);
+}
+
+void
+LeaseReclamationWorker::processReclaimedLeases() {
+    Lease4Collection leases4;
+    Lease6Collection leases6;
+    int64_t cycles = 0;
+    int64_t backlog = 0;
+    {
+        Mutex::Locker lock(mutex_);
+        leases4.swap(reclaimed4_);
+        leases6.swap(reclaimed6_);
+        cycles = cycles_;
+        cycles_ = 0;
+        backlog = backlog_;
+        if (notified_) {
+            ready_socket_.clearReady();
+            notified_ = false;
+        }
+    }
+
+    // The main thread is the only one allocating the leases, so the
+    // addresses can't be allocated again while they are processed here.
+    BOOST_FOREACH(Lease4Ptr lease, leases4) {
+        try {
+            suppressReusedNCR(lease);
+            alloc_engine_->completeLeaseReclamation(lease);
+        } catch (const std::exception& ex) {
+            LOG_ERROR(alloc_engine_logger, ALLOC_ENGINE_V4_LEASE_RECLAMATION_FAILED)
+                .arg(lease->addr_.toText())
+                .arg(ex.what());
+        }
+    }
+
+    BOOST_FOREACH(Lease6Ptr lease, leases6) {
+        try {
+            suppressReusedNCR(lease);
+            alloc_engine_->completeLeaseReclamation(lease);
+        } catch (const std::exception& ex) {
+            LOG_ERROR(alloc_engine_logger, ALLOC_ENGINE_V6_LEASE_RECLAMATION_FAILED)
+                .arg(lease->addr_.toText())
+                .arg(ex.what());
+        }
+    }
+
+    if (cycles > 0) {
+        StatsMgr::instance().addValue("reclaim-cycles", cycles);
+        StatsMgr::instance().setValue("reclaim-backlog", backlog);
+    }
+}
+
+template<typename LeasePtrType>
+void
+LeaseReclamationWorker::suppressReusedNCR(const LeasePtrType& lease) {
+    if (isLeaseReused(lease)) {
+        LOG_DEBUG(alloc_engine_logger, ALLOC_ENGINE_DBG_TRACE,
+                  ALLOC_ENGINE_RECLAIMED_LEASE_REUSED)
+            .arg(lease->addr_.toText());
+        // The lease is the worker's copy, so it can be modified.
+        lease->fqdn_fwd_ = false;
+        lease->fqdn_rev_ = false;
+    }
+}
+
+size_t
+LeaseReclamationWorker::getPendingLeasesNum() {
+    Mutex::Locker lock(mutex_);
+    return (reclaimed4_.size() + reclaimed6_.size());
+}
+
+void
+LeaseReclamationWorker::run() {
+    // Open the connection in this thread, as some database client
+    // libraries require that the connection is used by the thread
+    // which has opened it.
+    try {
+        lease_mgr_ = connection_factory_();
+        if (!lease_mgr_) {
+            isc_throw(Unexpected, "no lease database connection");
+        }
+
+    } catch (const std::exception& ex) {
+        LOG_ERROR(dhcpsrv_logger, DHCPSRV_RECLAMATION_THREAD_FAILED)
+            .arg(ex.what());
+        Mutex::Locker lock(mutex_);
+        start_error_ = ex.what();
+        started_ = true;
+        started_cond_.signal();
+        return;
+    }
+
+    {
+        Mutex::Locker lock(mutex_);
+        started_ = true;
+        started_cond_.signal();
+    }
+
+    try {
+        runCycles();
+
+    } catch (const std::exception& ex) {
+        LOG_ERROR(dhcpsrv_logger, DHCPSRV_RECLAMATION_THREAD_FAILED)
+            .arg(ex.what());
+    }
+
+    // Close the connection in this thread too.
+    lease_mgr_.reset();
+}
+
+void
+LeaseReclamationWorker::runCycles() {
+    ptime now = microsec_clock::universal_time();
+    ptime next_reclaim(not_a_date_time);
+    if (reclaim_interval_ > 0) {
+        next_reclaim = now + milliseconds(reclaim_interval_);
+    }
+    ptime next_flush(not_a_date_time);
+    if (flush_interval_ > 0) {
+        next_flush = now + milliseconds(flush_interval_);
+    }
+
+    for (;;) {
+        // Wait until the earliest of the scheduled operations.
+        ptime next = next_reclaim;
+        if (next.is_not_a_date_time() ||
+            (!next_flush.is_not_a_date_time() && (next_flush < next))) {
+            next = next_flush;
+        }
+        long timeout = -1;
+        if (!next.is_not_a_date_time()) {
+            timeout = std::max((next - now).total_milliseconds(),
+                               static_cast<int64_t>(0));
+        }
+        if (!waitForWork(timeout)) {
+            return;
+        }
+
+        now = microsec_clock::universal_time();
+        if (!next_flush.is_not_a_date_time() && (now >= next_flush)) {
+            deleteExpiredReclaimedLeases();
+            now = microsec_clock::universal_time();
+            next_flush = now + milliseconds(flush_interval_);
+        }
+
+        if (next_reclaim.is_not_a_date_time() || (now < next_reclaim)) {
+            continue;
+        }
+
+        // Don't reclaim more leases while the main thread is busy with
+        // the leases reclaimed so far.
+        if (getPendingLeasesNum() >= MAX_PENDING_LEASES) {
+            next_reclaim = now + milliseconds(PENDING_LEASES_WAIT_TIME);
+            continue;
+        }
+
+        long lock_wait_time = 0;
+        const bool incomplete = ipv6_ ?
+            reclaimLeases<Lease6Collection>(lock_wait_time) :
+            reclaimLeases<Lease4Collection>(lock_wait_time);
+
+        // If there are still expired leases, continue after yielding to the
+        // packet processing for the time the worker has been delayed by it.
+        now = microsec_clock::universal_time();
+        next_reclaim = now + milliseconds(incomplete ?
+                                          std::min(lock_wait_time,
+                                                   reclaim_interval_) :
+                                          reclaim_interval_);
+    }
+}
+
+bool
+LeaseReclamationWorker::waitForWork(const long timeout) {
+    const int fd = wakeup_socket_.getSelectFd();
+    fd_set sockets;
+    FD_ZERO(&sockets);
+    FD_SET(fd, &sockets);
+
+    struct timeval select_timeout;
+    struct timeval* select_timeout_ptr = 0;
+    if (timeout >= 0) {
+        select_timeout.tv_sec = timeout / 1000;
+        select_timeout.tv_usec = (timeout % 1000) * 1000;
+        select_timeout_ptr = &select_timeout;
+    }
+
+    // An interrupted call is not an error. The caller checks the time
+    // and calls this method again if needed.
+    if ((select(fd + 1, &sockets, 0, 0, select_timeout_ptr) < 0) &&
+        (errno != EINTR)) {
+        isc_throw(Unexpected, "select() failed while waiting for the next"
+                  " reclamation cycle: " << strerror(errno));
+    }
+
+    Mutex::Locker lock(mutex_);
+    return (!stopping_);
+}
+
+template<typename LeaseCollectionType>
+bool
+LeaseReclamationWorker::reclaimLeases(long& lock_wait_time) {
+    LOG_DEBUG(alloc_engine_logger, ALLOC_ENGINE_DBG_TRACE,
+              ipv6_ ? ALLOC_ENGINE_V6_LEASES_RECLAMATION_START :
+              ALLOC_ENGINE_V4_LEASES_RECLAMATION_START)
+        .arg(max_reclaim_leases_)
+        .arg(max_reclaim_time_);
+
+    Stopwatch stopwatch;
+
+    // Obtain one lease more than will be processed to see if there will
+    // be still leases left after this cycle.
+    LeaseCollectionType leases;
+    getExpiredLeases(*lease_mgr_, leases, max_reclaim_leases_ > 0 ?
+                     max_reclaim_leases_ + 1 : 0);
+    const size_t expired_num = leases.size();
+    bool incomplete_reclamation = false;
+    if ((max_reclaim_leases_ > 0) && (leases.size() > max_reclaim_leases_)) {
+        leases.pop_back();
+        incomplete_reclamation = true;
+    }
+
+    size_t leases_processed = 0;
+    for (typename LeaseCollectionType::const_iterator lease = leases.begin();
+         lease != leases.end(); ++lease) {
+        try {
+            // The lease is modified when it is reclaimed. Keep the copy
+            // for the main thread, which needs the FQDN information.
+            typename LeaseCollectionType::value_type
+                reclaimed_lease = copyLease(*lease);
+            if (reclaimLease(*lease, lock_wait_time)) {
+                pushReclaimedLease(reclaimed_lease);
+            }
+            ++leases_processed;
+
+        } catch (const std::exception& ex) {
+            LOG_ERROR(alloc_engine_logger,
+                      ipv6_ ? ALLOC_ENGINE_V6_LEASE_RECLAMATION_FAILED :
+                      ALLOC_ENGINE_V4_LEASE_RECLAMATION_FAILED)
+                .arg((*lease)->addr_.toText())
+                .arg(ex.what());
+        }
+
+        if ((max_reclaim_time_ > 0) &&
+            (stopwatch.getTotalMilliseconds() >= max_reclaim_time_)) {
+            if (leases_processed < leases.size()) {
+                incomplete_reclamation = true;
+            }
+            LOG_DEBUG(alloc_engine_logger, ALLOC_ENGINE_DBG_TRACE,
+                      ipv6_ ? ALLOC_ENGINE_V6_LEASES_RECLAMATION_TIMEOUT :
+                      ALLOC_ENGINE_V4_LEASES_RECLAMATION_TIMEOUT)
+                .arg(max_reclaim_time_);
+            break;
+        }
+    }
+
+    stopwatch.stop();
+
+    LOG_DEBUG(alloc_engine_logger, ALLOC_ENGINE_DBG_TRACE,
+              ipv6_ ? ALLOC_ENGINE_V6_LEASES_RECLAMATION_COMPLETE :
+              ALLOC_ENGINE_V4_LEASES_RECLAMATION_COMPLETE)
+        .arg(leases_processed)
+        .arg(stopwatch.logFormatTotalDuration());
+
+    if (incomplete_reclamation) {
+        ++incomplete_cycles_;
+        if ((unwarned_reclaim_cycles_ > 0) &&
+            (incomplete_cycles_ > unwarned_reclaim_cycles_)) {
+            LOG_WARN(alloc_engine_logger,
+                     ipv6_ ? ALLOC_ENGINE_V6_LEASES_RECLAMATION_SLOW :
+                     ALLOC_ENGINE_V4_LEASES_RECLAMATION_SLOW)
+                .arg(unwarned_reclaim_cycles_);
+            incomplete_cycles_ = 0;
+        }
+
+    } else {
+        incomplete_cycles_ = 0;
+        LOG_DEBUG(alloc_engine_logger, ALLOC_ENGINE_DBG_TRACE,
+                  ipv6_ ? ALLOC_ENGINE_V6_NO_MORE_EXPIRED_LEASES :
+                  ALLOC_ENGINE_V4_NO_MORE_EXPIRED_LEASES);
+    }
+
+    // Report the progress to the main thread.
+    Mutex::Locker lock(mutex_);
+    ++cycles_;
+    backlog_ = (incomplete_reclamation ? expired_num - leases_processed : 0);
+    notify();
+
+    return (incomplete_reclamation);
+}
+
+template<typename LeasePtrType>
+bool
+LeaseReclamationWorker::reclaimLease(const LeasePtrType& lease,
+                                     long& lock_wait_time) {
+    Stopwatch lock_stopwatch;
+    Mutex::Locker lock(alloc_engine_->getLeaseMutex());
+    lock_stopwatch.stop();
+    lock_wait_time += lock_stopwatch.getTotalMilliseconds();
+
+    // The allocation engine may have reused or reclaimed the lease since
+    // it has been retrieved.
+    LeasePtrType current = getLease(*lease_mgr_, lease);
+    if (!current || !current->expired() || current->stateExpiredReclaimed() ||
+        (current->cltt_ != lease->cltt_) ||
+        (current->valid_lft_ != lease->valid_lft_)) {
+        return (false);
+    }
+
+    // The declined leases are always removed, as they don't hold any
+    // client information.
+    if ((flush_interval_ == 0) || (lease->state_ == Lease::STATE_DECLINED)) {
+        lease_mgr_->deleteLease(lease->addr_);
+
+    } else {
+        // The name change request removing the DNS records is sent by
+        // the main thread, using the copy of the lease.
+        lease->hostname_.clear();
+        lease->fqdn_fwd_ = false;
+        lease->fqdn_rev_ = false;
+        lease->state_ = Lease::STATE_EXPIRED_RECLAIMED;
+        updateLease(*lease_mgr_, lease);
+    }
+
+    LOG_DEBUG(alloc_engine_logger, ALLOC_ENGINE_DBG_TRACE,
+              ALLOC_ENGINE_LEASE_RECLAIMED)
+        .arg(lease->addr_.toText());
+
+    return (true);
+}
+
+void
+LeaseReclamationWorker::deleteExpiredReclaimedLeases() {
+    LOG_DEBUG(alloc_engine_logger, ALLOC_ENGINE_DBG_TRACE,
+              ipv6_ ? ALLOC_ENGINE_V6_RECLAIMED_LEASES_DELETE :
+              ALLOC_ENGINE_V4_RECLAIMED_LEASES_DELETE)
+        .arg(hold_reclaimed_time_);
+
+    uint64_t deleted_leases = 0;
+    try {
+        Mutex::Locker lock(alloc_engine_->getLeaseMutex());
+        deleted_leases = ipv6_ ?
+            lease_mgr_->deleteExpiredReclaimedLeases6(hold_reclaimed_time_) :
+            lease_mgr_->deleteExpiredReclaimedLeases4(hold_reclaimed_time_);
+
+    } catch (const std::exception& ex) {
+        LOG_ERROR(alloc_engine_logger,
+                  ipv6_ ? ALLOC_ENGINE_V6_RECLAIMED_LEASES_DELETE_FAILED :
+                  ALLOC_ENGINE_V4_RECLAIMED_LEASES_DELETE_FAILED)
+            .arg(ex.what());
+    }
+
+    LOG_DEBUG(alloc_engine_logger, ALLOC_ENGINE_DBG_TRACE,
+              ipv6_ ? ALLOC_ENGINE_V6_RECLAIMED_LEASES_DELETE_COMPLETE :
+              ALLOC_ENGINE_V4_RECLAIMED_LEASES_DELETE_COMPLETE)
+        .arg(deleted_leases);
+}
+
+void
+LeaseReclamationWorker::pushReclaimedLease(const Lease4Ptr& lease) {
+    Mutex::Locker lock(mutex_);
+    reclaimed4_.push_back(lease);
+    notify();
+}
+
+void
+LeaseReclamationWorker::pushReclaimedLease(const Lease6Ptr& lease) {
+    Mutex::Locker lock(mutex_);
+    reclaimed6_.push_back(lease);
+    notify();
+}
+
+void
+LeaseReclamationWorker::notify() {
+    if (!notified_) {
+        ready_socket_.markReady();
+        notified_ = true;
+    }
+}
+
+} // end of isc::dhcp namespace
+} // end of isc namespace
@@ -0,0 +1,302 @@
+// Copyright (C) 2017 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef LEASE_RECLAMATION_WORKER_H
+#define LEASE_RECLAMATION_WORKER_H
+
+#include <dhcpsrv/alloc_engine.h>
+#include <dhcpsrv/cfg_expiration.h>
+#include <dhcpsrv/lease.h>
+#include <dhcpsrv/lease_mgr.h>
+#include <dhcpsrv/lease_mgr_factory.h>
+#include <util/threads/sync.h>
+#include <util/threads/thread.h>
+#include <util/watch_socket.h>
+#include <boost/function.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/shared_ptr.hpp>
+#include <stdint.h>
+#include <string>
+
+namespace isc {
+namespace dhcp {
+
+/// @brief Reclaims expired leases in a dedicated thread.
+///
+/// By default, the expired leases are reclaimed by the @c AllocEngine
+/// from the timers' callbacks run by the main thread, between processing
+/// the received packets. When many leases expire at the same time, this
+/// either delays the packet processing or the reclamation falls behind.
+///
+/// If the "reclaim-thread" parameter is enabled, the server uses this
+/// class instead of the timers. The worker thread periodically retrieves
+/// the expired leases and reclaims them in the lease database, using its
+/// own connection to the database. The remaining reclamation steps, i.e.
+/// sending the name change requests to remove the DNS records and updating
+/// the statistics, aren't thread safe. The worker hands the reclaimed
+/// leases over to the main thread, which performs these steps when the
+/// @c IfaceMgr detects that the @c util::WatchSocket of the worker is
+/// marked ready. If the address of a reclaimed lease has been allocated
+/// again by then, the DNS records are not removed. The worker also
+/// removes the "expired-reclaimed" leases from the database, according to
+/// the "flush-reclaimed-timer-wait-time" and "hold-reclaimed-time"
+/// parameters.
+///
+/// The worker reclaims a lease while holding the mutex returned by the
+/// @c AllocEngine::getLeaseMutex. Before reclaiming the lease, it fetches
+/// the lease from the database again and leaves it alone if the lease has
+/// been reused or reclaimed by the allocation engine in the meantime.
+///
+/// The reclamation adapts to the load of the server. If a cycle doesn't
+/// reclaim all expired leases, the next cycle is started after the time
+/// the worker has waited for the allocation engine to release the mutex,
+/// so the worker yields to the packet processing as much as it has been
+/// delayed by it. The worker doesn't start the next cycle while the main
+/// thread hasn't processed @c MAX_PENDING_LEASES reclaimed leases.
+///
+/// The callouts for the lease4_expire, lease4_recover, lease6_expire and
+/// lease6_recover hook points can't be invoked by the worker. The worker
+/// can't be created when any such callouts are installed.
+///
+/// The progress of the reclamation is exported in the "reclaim-cycles"
+/// statistic, holding the number of the reclamation cycles run by the
+/// worker, and the "reclaim-backlog" statistic, holding the number of the
+/// expired leases known to be left after the last cycle.
+class LeaseReclamationWorker : public boost::noncopyable {
+public:
+
+    /// @brief Type of the function opening the connection to the lease
+    /// database used by the worker.
+    typedef boost::function<boost::shared_ptr<LeaseMgr>()> ConnectionFactory;
+
+    /// @brief Maximum number of the reclaimed leases waiting for the main
+    /// thread, above which the next reclamation cycle is delayed.
+    static const size_t MAX_PENDING_LEASES = 1000;
+
+    /// @brief Time in milliseconds for which the next reclamation cycle is
+    /// delayed when there are too many reclaimed leases waiting for the main
+    /// thread.
+    static const long PENDING_LEASES_WAIT_TIME = 10;
+
+    /// @brief Constructor.
+    ///
+    /// @param ipv6 Indicates if the DHCPv6 or DHCPv4 leases are reclaimed.
+    /// @param alloc_engine Allocation engine completing the reclamation.
+    /// @param cfg_expiration Configuration of the leases' reclamation.
+    /// @param connection_factory Function opening the connection to the
+    /// lease database, invoked by the worker thread.
+    ///
+    /// @throw isc::BadValue if the allocation engine or the connection
+    /// factory is not specified.
+    /// @throw isc::InvalidOperation if there are callouts installed for
+    /// the hook points invoked during the leases' reclamation.
+    LeaseReclamationWorker(const bool ipv6, const AllocEnginePtr& alloc_engine,
+                           const CfgExpiration& cfg_expiration,
+                           const ConnectionFactory& connection_factory =
+                           &LeaseMgrFactory::createConnection);
+
+    /// @brief Destructor.
+    ///
+    /// Stops the worker thread if it is running.
+    ~LeaseReclamationWorker();
+
+    /// @brief Starts the worker thread.
+    ///
+    /// Registers the @c util::WatchSocket of the worker in the @c IfaceMgr
+    /// and starts the thread. This method returns when the thread has
+    /// opened its connection to the lease database.
+    ///
+    /// @throw isc::InvalidOperation if the thread is already running.
+    /// @throw isc::Unexpected if the thread failed to open the connection
+    /// to the lease database.
+    void start();
+
+    /// @brief Stops the worker thread.
+    ///
+    /// Waits for the thread to terminate, unregisters the socket from the
+    /// @c IfaceMgr and completes the reclamation of the leases reclaimed
+    /// by the thread so far. This is no-op if the thread is not running.
+    void stop();
+
+    /// @brief Indicates if the worker thread is running.
+    bool isRunning() const {
+        return (static_cast<bool>(thread_));
+    }
+
+    /// @brief Completes the reclamation of the leases reclaimed by the
+    /// worker thread.
+    ///
+    /// This method is invoked by the main thread when the @c IfaceMgr
+    /// detects that the socket of the worker is marked ready. It calls
+    /// @c AllocEngine::completeLeaseReclamation for each reclaimed lease
+    /// and updates the statistics of the reclamation progress.
+    void processReclaimedLeases();
+
+    /// @brief Returns the number of the reclaimed leases waiting for the
+    /// main thread.
+    size_t getPendingLeasesNum();
+
+private:
+
+    /// @brief Main function of the worker thread.
+    void run();
+
+    /// @brief Runs the reclamation cycles and removes the reclaimed leases
+    /// until the worker is stopped.
+    void runCycles();
+
+    /// @brief Waits until the timeout elapses or the worker is stopped.
+    ///
+    /// @param timeout Timeout in milliseconds.
+    ///
+    /// @return false if the worker has been stopped, true otherwise.
+    bool waitForWork(const long timeout);
+
+    /// @brief Runs a single reclamation cycle.
+    ///
+    /// @param [out] lock_wait_time Time in milliseconds the worker has
+    /// waited for the allocation engine to release the lease mutex.
+    ///
+    /// @tparam LeaseCollectionType One of the @c Lease4Collection or
+    /// @c Lease6Collection.
+    /// @return true if there are still expired leases after this cycle.
+    template<typename LeaseCollectionType>
+    bool reclaimLeases(long& lock_wait_time);
+
+    /// @brief Reclaims the lease in the lease database.
+    ///
+    /// The lease is removed or put into the "expired-reclaimed" state,
+    /// unless it has been reused or reclaimed in the meantime.
+    ///
+    /// @param lease Pointer to the expired lease.
+    /// @param [in,out] lock_wait_time Time in milliseconds the worker has
+    /// waited for the allocation engine to release the lease mutex,
+    /// increased by the time waited by this method.
+    ///
+    /// @tparam LeasePtrType One of the @c Lease4Ptr or @c Lease6Ptr.
+    /// @return true if the lease has been reclaimed.
+    template<typename LeasePtrType>
+    bool reclaimLease(const LeasePtrType& lease, long& lock_wait_time);
+
+    /// @brief Removes the leases held in the "expired-reclaimed" state
+    /// longer than the "hold-reclaimed-time".
+    void deleteExpiredReclaimedLeases();
+
+    /// @brief Hands the reclaimed lease over to the main thread.
+    ///
+    /// @param lease Pointer to the lease as it was before the reclamation.
+    void pushReclaimedLease(const Lease4Ptr& lease);
+
+    /// @brief Hands the reclaimed lease over to the main thread.
+    ///
+    /// @param lease Pointer to the lease as it was before the reclamation.
+    void pushReclaimedLease(const Lease6Ptr& lease);
+
+    /// @brief Prevents the removal of the DNS records for the reclaimed
+    /// lease if its address has been allocated again.
+    ///
+    /// The main thread completes the reclamation after the worker has
+    /// released the lease, so the allocation engine may have allocated
+    /// the address to a client in the meantime. The DNS records may
+    /// belong to that client now, so they are left alone.
+    ///
+    /// @param lease Pointer to the lease as it was before the reclamation.
+    ///
+    /// @tparam LeasePtrType One of the @c Lease4Ptr or @c Lease6Ptr.
+    template<typename LeasePtrType>
+    void suppressReusedNCR(const LeasePtrType& lease);
+
+    /// @brief Marks the socket ready for the main thread.
+    ///
+    /// The @c mutex_ must be held by the caller.
+    void notify();
+
+    /// @brief Indicates if the DHCPv6 or DHCPv4 leases are reclaimed.
+    bool ipv6_;
+
+    /// @brief Allocation engine completing the reclamation.
+    AllocEnginePtr alloc_engine_;
+
+    /// @brief Function opening the connection to the lease database.
+    ConnectionFactory connection_factory_;
+
+    /// @brief Connection to the lease database used by the worker thread.
+    boost::shared_ptr<LeaseMgr> lease_mgr_;
+
+    /// @brief Interval between the reclamation cycles in milliseconds.
+    long reclaim_interval_;
+
+    /// @brief Interval between removals of the reclaimed leases in
+    /// milliseconds.
+    long flush_interval_;
+
+    /// @brief Time in seconds for which the reclaimed leases are held.
+    uint32_t hold_reclaimed_time_;
+
+    /// @brief Maximum number of leases reclaimed in a single cycle.
+    size_t max_reclaim_leases_;
+
+    /// @brief Maximum time in milliseconds of a single cycle.
+    uint16_t max_reclaim_time_;
+
+    /// @brief Number of incomplete cycles after which a warning is issued.
+    uint16_t unwarned_reclaim_cycles_;
+
+    /// @brief Number of consecutive incomplete cycles.
+    uint16_t incomplete_cycles_;
+
+    /// @brief Worker thread.
+    boost::scoped_ptr<isc::util::thread::Thread> thread_;
+
+    /// @brief Mutex protecting the state shared with the worker thread.
+    isc::util::thread::Mutex mutex_;
+
+    /// @brief Condition variable signalled when the thread has opened the
+    /// connection to the lease database.
+    isc::util::thread::CondVar started_cond_;
+
+    /// @brief Indicates if the thread has tried to open the connection.
+    bool started_;
+
+    /// @brief Error opening the connection to the lease database.
+    std::string start_error_;
+
+    /// @brief Indicates if the thread should terminate.
+    bool stopping_;
+
+    /// @brief Reclaimed IPv4 leases waiting for the main thread.
+    Lease4Collection reclaimed4_;
+
+    /// @brief Reclaimed IPv6 leases waiting for the main thread.
+    Lease6Collection reclaimed6_;
+
+    /// @brief Number of cycles run since the main thread last processed
+    /// the reclaimed leases.
+    int64_t cycles_;
+
+    /// @brief Number of expired leases left after the last cycle.
+    int64_t backlog_;
+
+    /// @brief Indicates if the @c ready_socket_ is marked ready.
+    bool notified_;
+
+    /// @brief Socket marked ready when there are reclaimed leases for the
+    /// main thread.
+    util::WatchSocket ready_socket_;
+
+    /// @brief Socket marked ready to wake up the worker thread when it is
+    /// being stopped.
+    util::WatchSocket wakeup_socket_;
+};
+
+/// @brief Pointer to the @c LeaseReclamationWorker.
+typedef boost::shared_ptr<LeaseReclamationWorker> LeaseReclamationWorkerPtr;
+
+} // end of isc::dhcp namespace
+} // end of isc namespace
+
+#endif // LEASE_RECLAMATION_WORKER_H
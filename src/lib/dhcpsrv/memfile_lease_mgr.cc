@@ -1,4 +1,4 @@
-// Copyright (C) 2012-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2012-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -630,8 +630,14 @@ Memfile_LeaseMgr::getLease4(const isc::asiolink::IOAddress& addr) const {
     LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL,
               DHCPSRV_MEMFILE_GET_ADDR4).arg(addr.toText());
 
+    // The IPv6 address can't be converted to the index key.
+    if (!addr.isV4()) {
+        return (Lease4Ptr());
+    }
+
     const Lease4StorageAddressIndex& idx = storage4_.get<AddressIndexTag>();
-    Lease4StorageAddressIndex::iterator l = idx.find(addr);
+    Lease4StorageAddressIndex::iterator l =
+        idx.find(Lease4AddressExtractor::fromAddress(addr));
     if (l == idx.end()) {
         return (Lease4Ptr());
     } else {
@@ -751,7 +757,13 @@ Memfile_LeaseMgr::getLease6(Lease::Type type,
               DHCPSRV_MEMFILE_GET_ADDR6)
         .arg(addr.toText())
         .arg(Lease::typeToText(type));
-    Lease6Storage::iterator l = storage6_.find(addr);
+    // The IPv4 address can't be converted to the index key.
+    if (!addr.isV6()) {
+        return (Lease6Ptr());
+    }
+
+    Lease6Storage::iterator l =
+        storage6_.find(Lease6AddressExtractor::fromAddress(addr));
     if (l == storage6_.end() || !(*l) || ((*l)->type_ != type)) {
         return (Lease6Ptr());
     } else {
@@ -862,6 +874,50 @@ Memfile_LeaseMgr::getExpiredLeases4(Lease4Collection& expired_leases,
     }
 }
 
+Lease4Collection
+Memfile_LeaseMgr::getLeases4(const asiolink::IOAddress& lower_bound_address,
+                             const size_t page_size) const {
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_MEMFILE_GET_PAGE4)
+        .arg(page_size).arg(lower_bound_address.toText());
+
+    if (!lower_bound_address.isV4()) {
+        isc_throw(BadValue, "expected IPv4 address while"
+                  " retrieving leases from the lease database, got "
+                  << lower_bound_address);
+    }
+
+    Lease4Collection collection;
+    const Lease4StorageAddressIndex& idx = storage4_.get<AddressIndexTag>();
+    for (Lease4StorageAddressIndex::const_iterator lease =
+             idx.upper_bound(Lease4AddressExtractor::fromAddress(lower_bound_address));
+         (lease != idx.end()) && (collection.size() < page_size); ++lease) {
+        collection.push_back(Lease4Ptr(new Lease4(**lease)));
+    }
+    return (collection);
+}
+
+Lease6Collection
+Memfile_LeaseMgr::getLeases6(const asiolink::IOAddress& lower_bound_address,
+                             const size_t page_size) const {
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_MEMFILE_GET_PAGE6)
+        .arg(page_size).arg(lower_bound_address.toText());
+
+    if (!lower_bound_address.isV6()) {
+        isc_throw(BadValue, "expected IPv6 address while"
+                  " retrieving leases from the lease database, got "
+                  << lower_bound_address);
+    }
+
+    Lease6Collection collection;
+    const Lease6StorageAddressIndex& idx = storage6_.get<AddressIndexTag>();
+    for (Lease6StorageAddressIndex::const_iterator lease =
+             idx.upper_bound(Lease6AddressExtractor::fromAddress(lower_bound_address));
+         (lease != idx.end()) && (collection.size() < page_size); ++lease) {
+        collection.push_back(Lease6Ptr(new Lease6(**lease)));
+    }
+    return (collection);
+}
+
 void
 Memfile_LeaseMgr::updateLease4(const Lease4Ptr& lease) {
     LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL,
@@ -871,7 +927,8 @@ Memfile_LeaseMgr::updateLease4(const Lease4Ptr& lease) {
     Lease4StorageAddressIndex& index = storage4_.get<AddressIndexTag>();
 
     // Lease must exist if it is to be updated.
-    Lease4StorageAddressIndex::const_iterator lease_it = index.find(lease->addr_);
+    Lease4StorageAddressIndex::const_iterator lease_it =
+        index.find(index.key_extractor()(lease));
     if (lease_it == index.end()) {
         isc_throw(NoSuchLease, "failed to update the lease with address "
                   << lease->addr_ << " - no such lease");
@@ -897,7 +954,8 @@ Memfile_LeaseMgr::updateLease6(const Lease6Ptr& lease) {
     Lease6StorageAddressIndex& index = storage6_.get<AddressIndexTag>();
 
     // Lease must exist if it is to be updated.
-    Lease6StorageAddressIndex::const_iterator lease_it = index.find(lease->addr_);
+    Lease6StorageAddressIndex::const_iterator lease_it =
+        index.find(index.key_extractor()(lease));
     if (lease_it == index.end()) {
         isc_throw(NoSuchLease, "failed to update the lease with address "
                   << lease->addr_ << " - no such lease");
@@ -920,7 +978,8 @@ Memfile_LeaseMgr::deleteLease(const isc::asiolink::IOAddress& addr) {
               DHCPSRV_MEMFILE_DELETE_ADDR).arg(addr.toText());
     if (addr.isV4()) {
         // v4 lease
-        Lease4Storage::iterator l = storage4_.find(addr);
+        Lease4Storage::iterator l =
+            storage4_.find(Lease4AddressExtractor::fromAddress(addr));
         if (l == storage4_.end()) {
             // No such lease
             return (false);
@@ -940,7 +999,8 @@ Memfile_LeaseMgr::deleteLease(const isc::asiolink::IOAddress& addr) {
 
     } else {
         // v6 lease
-        Lease6Storage::iterator l = storage6_.find(addr);
+        Lease6Storage::iterator l =
+            storage6_.find(Lease6AddressExtractor::fromAddress(addr));
         if (l == storage6_.end()) {
             // No such lease
             return (false);
@@ -1060,6 +1120,14 @@ Memfile_LeaseMgr::rollback() {
               DHCPSRV_MEMFILE_ROLLBACK);
 }
 
+void
+Memfile_LeaseMgr::reinstallTimers() {
+    // The LFC is only set up when the leases are persisted.
+    if (persistLeases(V4) || persistLeases(V6)) {
+        lfcSetup();
+    }
+}
+
 std::string
 Memfile_LeaseMgr::appendSuffix(const std::string& file_name,
                                const LFCFileType& file_type) {
@@ -1,4 +1,4 @@
-// Copyright (C) 2012-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2012-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -286,6 +286,28 @@ public:
     virtual void getExpiredLeases4(Lease4Collection& expired_leases,
                                    const size_t max_leases) const;
 
+    /// @brief Returns a page of DHCPv4 leases.
+    ///
+    /// @param lower_bound_address IPv4 address used as a cursor. Leases
+    /// with addresses greater than this address are returned.
+    /// @param page_size Maximum number of leases to be returned.
+    ///
+    /// @return Collection of leases in the ascending order of addresses.
+    virtual Lease4Collection
+    getLeases4(const asiolink::IOAddress& lower_bound_address,
+               const size_t page_size) const;
+
+    /// @brief Returns a page of DHCPv6 leases.
+    ///
+    /// @param lower_bound_address IPv6 address used as a cursor. Leases
+    /// with addresses greater than this address are returned.
+    /// @param page_size Maximum number of leases to be returned.
+    ///
+    /// @return Collection of leases in the ascending order of addresses.
+    virtual Lease6Collection
+    getLeases6(const asiolink::IOAddress& lower_bound_address,
+               const size_t page_size) const;
+
     /// @brief Updates IPv4 lease.
     ///
     /// @warning This function does not validate the pointer to the lease.
@@ -414,6 +436,12 @@ public:
     /// support transactions, this is a no-op.
     virtual void rollback();
 
+    /// @brief Re-installs the timer triggering the Lease File Cleanup.
+    ///
+    /// This method is called when the lease manager instance is preserved
+    /// during the server reconfiguration, which unregisters all timers.
+    virtual void reinstallTimers();
+
     //@}
 
     /// @name Public type and method used to determine file names for LFC.
@@ -1,4 +1,4 @@
-// Copyright (C) 2015-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -42,6 +42,55 @@ struct ClientIdSubnetIdIndexTag { };
 /// @brief Tag for indexes by client id, HW address and subnet id.
 struct ClientIdHWAddressSubnetIdIndexTag { };
 
+/// @brief Key extractor returning the IPv4 address of the lease as a
+/// 32-bit integer.
+///
+/// Comparing integers is much faster than comparing @c IOAddress objects,
+/// which check the address family and copy the underlying addresses
+/// for every comparison.
+/// The key is computed from the @c Lease::addr_ on each call rather than
+/// held in the lease, so as it can't go stale when the address is
+/// modified.
+struct Lease4AddressExtractor {
+    /// @brief Type of the key.
+    typedef uint32_t result_type;
+
+    /// @brief Returns the key for the lease.
+    ///
+    /// @param lease Pointer to the lease.
+    result_type operator()(const Lease4Ptr& lease) const {
+        return (lease->addr_.toUint32());
+    }
+
+    /// @brief Converts an address to the key used for the lookups.
+    ///
+    /// @param address IPv4 address.
+    static result_type fromAddress(const isc::asiolink::IOAddress& address) {
+        return (address.toUint32());
+    }
+};
+
+/// @brief Key extractor returning the IPv6 address of the lease as a
+/// 128-bit integer.
+struct Lease6AddressExtractor {
+    /// @brief Type of the key.
+    typedef isc::asiolink::IPv6Value result_type;
+
+    /// @brief Returns the key for the lease.
+    ///
+    /// @param lease Pointer to the lease.
+    result_type operator()(const Lease6Ptr& lease) const {
+        return (lease->addr_.toV6Value());
+    }
+
+    /// @brief Converts an address to the key used for the lookups.
+    ///
+    /// @param address IPv6 address.
+    static result_type fromAddress(const isc::asiolink::IOAddress& address) {
+        return (address.toV6Value());
+    }
+};
+
 /// @name Multi index containers holding DHCPv4 and DHCPv6 leases.
 ///
 //@{
@@ -63,10 +112,10 @@ typedef boost::multi_index_container<
     boost::multi_index::indexed_by<
         // Specification of the first index starts here.
         // This index sorts leases by IPv6 addresses represented as
-        // IOAddress objects.
+        // 128-bit integers.
         boost::multi_index::ordered_unique<
             boost::multi_index::tag<AddressIndexTag>,
-            boost::multi_index::member<Lease, isc::asiolink::IOAddress, &Lease::addr_>
+            Lease6AddressExtractor
         >,
 
         // Specification of the second index starts here.
@@ -127,12 +176,12 @@ typedef boost::multi_index_container<
     boost::multi_index::indexed_by<
         // Specification of the first index starts here.
         // This index sorts leases by IPv4 addresses represented as
-        // IOAddress objects.
+        // 32-bit integers.
         boost::multi_index::ordered_unique<
             boost::multi_index::tag<AddressIndexTag>,
             // The IPv4 address are held in addr_ members that belong to
             // Lease class.
-            boost::multi_index::member<Lease, isc::asiolink::IOAddress, &Lease::addr_>
+            Lease4AddressExtractor
         >,
 
         // Specification of the second index starts here.
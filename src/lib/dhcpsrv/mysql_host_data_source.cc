@@ -1,4 +1,4 @@
-// Copyright (C) 2015-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -1763,6 +1763,10 @@ public:
         INSERT_V6_RESRV,        // Insert v6 reservation
         INSERT_V4_OPTION,       // Insert DHCPv4 option
         INSERT_V6_OPTION,       // Insert DHCPv6 option
+        DEL_HOST_V4_OPTIONS,    // Delete DHCPv4 options of a host
+        DEL_HOST_V6_OPTIONS,    // Delete DHCPv6 options of a host
+        DEL_HOST_V6_RESRV,      // Delete IPv6 reservations of a host
+        DEL_HOST,               // Delete host
         NUM_STATEMENTS          // Number of statements
     };
 
@@ -1821,6 +1825,23 @@ public:
     void addOptions(const StatementIndex& stindex, const ConstCfgOptionPtr& options_cfg,
                     const uint64_t host_id);
 
+    /// @brief Executes statement which deletes rows associated with the
+    /// particular host.
+    ///
+    /// @param stindex Index of a statement being executed.
+    /// @param host_id Identifier of the host in the database.
+    ///
+    /// @return Number of deleted rows.
+    uint64_t delStatement(const StatementIndex& stindex, const HostID& host_id);
+
+    /// @brief Deletes the host along with its IPv6 reservations and options.
+    ///
+    /// @param host Pointer to the host retrieved from the database or NULL.
+    ///
+    /// @return true if the host has been deleted, false if the host is
+    /// NULL or it no longer exists in the database.
+    bool delHost(const ConstHostPtr& host);
+
     /// @brief Check Error and Throw Exception
     ///
     /// This method invokes @ref MySqlConnection::checkError.
@@ -2101,7 +2122,23 @@ TaggedStatementArray tagged_statements = { {
     {MySqlHostDataSourceImpl::INSERT_V6_OPTION,
          "INSERT INTO dhcp6_options(option_id, code, value, formatted_value, space, "
             "persistent, dhcp_client_class, dhcp6_subnet_id, host_id, scope_id) "
-         " VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, 3)"}}
+         " VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, 3)"},
+
+    // Deletes all DHCPv4 options associated with the host.
+    {MySqlHostDataSourceImpl::DEL_HOST_V4_OPTIONS,
+         "DELETE FROM dhcp4_options WHERE host_id = ?"},
+
+    // Deletes all DHCPv6 options associated with the host.
+    {MySqlHostDataSourceImpl::DEL_HOST_V6_OPTIONS,
+         "DELETE FROM dhcp6_options WHERE host_id = ?"},
+
+    // Deletes all IPv6 reservations associated with the host.
+    {MySqlHostDataSourceImpl::DEL_HOST_V6_RESRV,
+         "DELETE FROM ipv6_reservations WHERE host_id = ?"},
+
+    // Deletes a host from the 'hosts' table.
+    {MySqlHostDataSourceImpl::DEL_HOST,
+         "DELETE FROM hosts WHERE host_id = ?"}}
 };
 
 MySqlHostDataSourceImpl::
@@ -2234,6 +2271,51 @@ MySqlHostDataSourceImpl::addOptions(const StatementIndex& stindex,
     }
 }
 
+uint64_t
+MySqlHostDataSourceImpl::delStatement(const StatementIndex& stindex,
+                                      const HostID& host_id) {
+    // Set up the WHERE clause value
+    MYSQL_BIND inbind[1];
+    memset(inbind, 0, sizeof(inbind));
+
+    uint32_t id = static_cast<uint32_t>(host_id);
+    inbind[0].buffer_type = MYSQL_TYPE_LONG;
+    inbind[0].buffer = reinterpret_cast<char*>(&id);
+    inbind[0].is_unsigned = MLM_TRUE;
+
+    // Bind the parameters to the statement
+    int status = mysql_stmt_bind_param(conn_.statements_[stindex], inbind);
+    checkError(status, stindex, "unable to bind parameters");
+
+    // Execute the statement
+    status = mysql_stmt_execute(conn_.statements_[stindex]);
+    checkError(status, stindex, "unable to execute");
+
+    // See how many rows were affected.
+    return (static_cast<uint64_t>(mysql_stmt_affected_rows(conn_.statements_[stindex])));
+}
+
+bool
+MySqlHostDataSourceImpl::delHost(const ConstHostPtr& host) {
+    if (!host) {
+        return (false);
+    }
+
+    // The host information is held in multiple tables, so the rows have
+    // to be deleted within a single transaction. The options tables are
+    // not cleaned up by the database triggers, so we do it explicitly.
+    MySqlTransaction transaction(conn_);
+
+    delStatement(DEL_HOST_V4_OPTIONS, host->getHostId());
+    delStatement(DEL_HOST_V6_OPTIONS, host->getHostId());
+    delStatement(DEL_HOST_V6_RESRV, host->getHostId());
+    bool deleted = (delStatement(DEL_HOST, host->getHostId()) > 0);
+
+    transaction.commit();
+
+    return (deleted);
+}
+
 void
 MySqlHostDataSourceImpl::
 checkError(const int status, const StatementIndex index,
@@ -2412,6 +2494,42 @@ MySqlHostDataSource::add(const HostPtr& host) {
     transaction.commit();
 }
 
+bool
+MySqlHostDataSource::del(const SubnetID& subnet_id,
+                         const asiolink::IOAddress& addr) {
+    // If operating in read-only mode, throw exception.
+    impl_->checkReadOnly();
+
+    // Find the host to obtain its identifier in the database.
+    ConstHostPtr host = (addr.isV4() ? get4(subnet_id, addr) :
+                         get6(subnet_id, addr));
+    return (impl_->delHost(host));
+}
+
+bool
+MySqlHostDataSource::del4(const SubnetID& subnet_id,
+                          const Host::IdentifierType& identifier_type,
+                          const uint8_t* identifier_begin,
+                          const size_t identifier_len) {
+    // If operating in read-only mode, throw exception.
+    impl_->checkReadOnly();
+
+    return (impl_->delHost(get4(subnet_id, identifier_type, identifier_begin,
+                                identifier_len)));
+}
+
+bool
+MySqlHostDataSource::del6(const SubnetID& subnet_id,
+                          const Host::IdentifierType& identifier_type,
+                          const uint8_t* identifier_begin,
+                          const size_t identifier_len) {
+    // If operating in read-only mode, throw exception.
+    impl_->checkReadOnly();
+
+    return (impl_->delHost(get6(subnet_id, identifier_type, identifier_begin,
+                                identifier_len)));
+}
+
 ConstHostCollection
 MySqlHostDataSource::getAll(const HWAddrPtr& hwaddr,
                             const DuidPtr& duid) const {
@@ -1,4 +1,4 @@
-// Copyright (C) 2012-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2012-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -17,6 +17,7 @@
 #include <boost/static_assert.hpp>
 #include <mysqld_error.h>
 
+#include <algorithm>
 #include <iostream>
 #include <iomanip>
 #include <limits.h>
@@ -140,6 +141,15 @@ tagged_statements = { {
                             "WHERE state != ? AND expire < ? "
                             "ORDER BY expire ASC "
                             "LIMIT ?"},
+    {MySqlLeaseMgr::GET_LEASE4_PAGE,
+                    "SELECT address, hwaddr, client_id, "
+                        "valid_lifetime, expire, subnet_id, "
+                        "fqdn_fwd, fqdn_rev, hostname, "
+                        "state "
+                            "FROM lease4 "
+                            "WHERE address > ? "
+                            "ORDER BY address "
+                            "LIMIT ?"},
     {MySqlLeaseMgr::GET_LEASE6_ADDR,
                     "SELECT address, duid, valid_lifetime, "
                         "expire, subnet_id, pref_lifetime, "
@@ -179,6 +189,17 @@ tagged_statements = { {
                             "WHERE state != ? AND expire < ? "
                             "ORDER BY expire ASC "
                             "LIMIT ?"},
+    {MySqlLeaseMgr::GET_LEASE6_PAGE,
+                    "SELECT address, duid, valid_lifetime, "
+                        "expire, subnet_id, pref_lifetime, "
+                        "lease_type, iaid, prefix_len, "
+                        "fqdn_fwd, fqdn_rev, hostname, "
+                        "hwaddr, hwtype, hwaddr_source, "
+                        "state "
+                            "FROM lease6 "
+                            "WHERE address > ? "
+                            "ORDER BY address "
+                            "LIMIT ?"},
     {MySqlLeaseMgr::GET_VERSION,
                     "SELECT version, minor FROM schema_version"},
     {MySqlLeaseMgr::INSERT_LEASE4,
@@ -1878,6 +1899,80 @@ MySqlLeaseMgr::getExpiredLeases4(Lease4Collection& expired_leases,
     getExpiredLeasesCommon(expired_leases, max_leases, GET_LEASE4_EXPIRE);
 }
 
+Lease4Collection
+MySqlLeaseMgr::getLeases4(const asiolink::IOAddress& lower_bound_address,
+                          const size_t page_size) const {
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_MYSQL_GET_PAGE4)
+        .arg(page_size).arg(lower_bound_address.toText());
+
+    if (!lower_bound_address.isV4()) {
+        isc_throw(BadValue, "expected IPv4 address while retrieving leases"
+                  " from the lease database, got " << lower_bound_address);
+    }
+
+    // Set up the WHERE clause value
+    MYSQL_BIND inbind[2];
+    memset(inbind, 0, sizeof(inbind));
+
+    uint32_t lb_address = lower_bound_address.toUint32();
+    inbind[0].buffer_type = MYSQL_TYPE_LONG;
+    inbind[0].buffer = reinterpret_cast<char*>(&lb_address);
+    inbind[0].is_unsigned = MLM_TRUE;
+
+    uint32_t limit = static_cast<uint32_t>(std::min(page_size, static_cast<size_t>
+        (std::numeric_limits<uint32_t>::max())));
+    inbind[1].buffer_type = MYSQL_TYPE_LONG;
+    inbind[1].buffer = reinterpret_cast<char*>(&limit);
+    inbind[1].is_unsigned = MLM_TRUE;
+
+    // Get the data
+    Lease4Collection result;
+    getLeaseCollection(GET_LEASE4_PAGE, inbind, result);
+
+    return (result);
+}
+
+Lease6Collection
+MySqlLeaseMgr::getLeases6(const asiolink::IOAddress& lower_bound_address,
+                          const size_t page_size) const {
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_MYSQL_GET_PAGE6)
+        .arg(page_size).arg(lower_bound_address.toText());
+
+    if (!lower_bound_address.isV6()) {
+        isc_throw(BadValue, "expected IPv6 address while retrieving leases"
+                  " from the lease database, got " << lower_bound_address);
+    }
+
+    // Set up the WHERE clause value
+    MYSQL_BIND inbind[2];
+    memset(inbind, 0, sizeof(inbind));
+
+    // IPv6 addresses are stored in the textual form, so they are ordered
+    // lexicographically rather than numerically. This doesn't matter for
+    // walking over the leases because the same order is used for the
+    // cursor and for sorting. The "::" doesn't sort before other addresses,
+    // so the first page is retrieved using an empty string.
+    std::string lb_address = (lower_bound_address.isV6Zero() ? "" :
+                              lower_bound_address.toText());
+    unsigned long lb_address_length = lb_address.size();
+    inbind[0].buffer_type = MYSQL_TYPE_STRING;
+    inbind[0].buffer = const_cast<char*>(lb_address.c_str());
+    inbind[0].buffer_length = lb_address_length;
+    inbind[0].length = &lb_address_length;
+
+    uint32_t limit = static_cast<uint32_t>(std::min(page_size, static_cast<size_t>
+        (std::numeric_limits<uint32_t>::max())));
+    inbind[1].buffer_type = MYSQL_TYPE_LONG;
+    inbind[1].buffer = reinterpret_cast<char*>(&limit);
+    inbind[1].is_unsigned = MLM_TRUE;
+
+    // Get the data
+    Lease6Collection result;
+    getLeaseCollection(GET_LEASE6_PAGE, inbind, result);
+
+    return (result);
+}
+
 template<typename LeaseCollection>
 void
 MySqlLeaseMgr::getExpiredLeasesCommon(LeaseCollection& expired_leases,
@@ -0,0 +1,129 @@
+// Copyright (C) 2017 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <dhcpsrv/cfgmgr.h>
+#include <dhcpsrv/packed_option_cache.h>
+#include <util/buffer.h>
+#include <boost/functional/hash.hpp>
+#include <algorithm>
+#include <exception>
+
+using namespace isc::util;
+
+namespace isc {
+namespace dhcp {
+
+const size_t PackedOptionCache::MAX_ENTRIES;
+
+PackedOptionCache::PackedOptionCache()
+    : entries_(), sequence_(0) {
+}
+
+ConstPackedOptionListPtr
+PackedOptionCache::get(const CfgOptionList& co_list,
+                       const std::string& option_space,
+                       const std::vector<uint16_t>& codes) {
+    checkSequence();
+
+    const size_t key = hash(co_list, option_space, codes);
+    std::pair<std::multimap<size_t, Entry>::const_iterator,
+              std::multimap<size_t, Entry>::const_iterator> range =
+        entries_.equal_range(key);
+    for (std::multimap<size_t, Entry>::const_iterator entry = range.first;
+         entry != range.second; ++entry) {
+        if (entry->second.matches(co_list, option_space, codes)) {
+            return (entry->second.options_);
+        }
+    }
+
+    // Don't let the cache grow indefinitely.
+    if (entries_.size() >= MAX_ENTRIES) {
+        entries_.clear();
+    }
+
+    Entry entry;
+    entry.co_list_.assign(co_list.begin(), co_list.end());
+    entry.option_space_ = option_space;
+    entry.codes_ = codes;
+    entry.options_ = createOptions(co_list, option_space, codes);
+    entries_.insert(std::make_pair(key, entry));
+    return (entry.options_);
+}
+
+void
+PackedOptionCache::clear() {
+    entries_.clear();
+}
+
+bool
+PackedOptionCache::Entry::matches(const CfgOptionList& co_list,
+                                  const std::string& option_space,
+                                  const std::vector<uint16_t>& codes) const {
+    if ((co_list.size() != co_list_.size()) || (codes != codes_) ||
+        (option_space != option_space_)) {
+        return (false);
+    }
+    return (std::equal(co_list.begin(), co_list.end(), co_list_.begin()));
+}
+
+size_t
+PackedOptionCache::hash(const CfgOptionList& co_list,
+                        const std::string& option_space,
+                        const std::vector<uint16_t>& codes) {
+    size_t seed = 0;
+    for (CfgOptionList::const_iterator copts = co_list.begin();
+         copts != co_list.end(); ++copts) {
+        boost::hash_combine(seed, copts->get());
+    }
+    boost::hash_combine(seed, option_space);
+    boost::hash_range(seed, codes.begin(), codes.end());
+    return (seed);
+}
+
+ConstPackedOptionListPtr
+PackedOptionCache::createOptions(const CfgOptionList& co_list,
+                                 const std::string& option_space,
+                                 const std::vector<uint16_t>& codes) {
+    boost::shared_ptr<PackedOptionList> options(new PackedOptionList());
+    for (std::vector<uint16_t>::const_iterator code = codes.begin();
+         code != codes.end(); ++code) {
+        // Iterate on the configured option list
+        for (CfgOptionList::const_iterator copts = co_list.begin();
+             copts != co_list.end(); ++copts) {
+            OptionDescriptor desc = (*copts)->get(option_space, *code);
+            // Got it: pack it and jump to the outer loop
+            if (desc.option_) {
+                ConstOptionBufferPtr wire_data;
+                try {
+                    OutputBuffer buf(desc.option_->len());
+                    desc.option_->pack(buf);
+                    const uint8_t* data =
+                        static_cast<const uint8_t*>(buf.getData());
+                    wire_data.reset(new OptionBuffer(data,
+                                                     data + buf.getLength()));
+                } catch (const std::exception&) {
+                    // Leave it to the response packing to report the error.
+                }
+                options->push_back(PackedOption(desc.option_, wire_data));
+                break;
+            }
+        }
+    }
+    return (options);
+}
+
+void
+PackedOptionCache::checkSequence() {
+    const uint32_t sequence = CfgMgr::instance().getCurrentCfg()->getSequence();
+    if (sequence != sequence_) {
+        entries_.clear();
+        sequence_ = sequence;
+    }
+}
+
+}
+}
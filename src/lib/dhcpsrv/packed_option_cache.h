@@ -0,0 +1,176 @@
+// Copyright (C) 2017 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef PACKED_OPTION_CACHE_H
+#define PACKED_OPTION_CACHE_H
+
+#include <dhcp/option.h>
+#include <dhcpsrv/cfg_option.h>
+#include <boost/shared_ptr.hpp>
+#include <map>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace isc {
+namespace dhcp {
+
+/// @brief Configured option along with its wire data.
+struct PackedOption {
+
+    /// @brief Constructor.
+    ///
+    /// @param option Pointer to the configured option.
+    /// @param wire_data Wire data of the option or null pointer if the
+    /// option could not be packed.
+    PackedOption(const OptionPtr& option,
+                 const ConstOptionBufferPtr& wire_data)
+        : option_(option), wire_data_(wire_data) {
+    }
+
+    /// @brief Pointer to the configured option.
+    OptionPtr option_;
+
+    /// @brief Wire data of the option, including option header.
+    ///
+    /// It is null if the option could not be packed. In this case the
+    /// option should be packed along with the response, so as the error
+    /// is reported when the response is packed.
+    ConstOptionBufferPtr wire_data_;
+};
+
+/// @brief List of configured options along with their wire data.
+typedef std::vector<PackedOption> PackedOptionList;
+
+/// @brief Pointer to the constant list of the packed options.
+typedef boost::shared_ptr<const PackedOptionList> ConstPackedOptionListPtr;
+
+/// @brief Cache of the packed options returned to the clients.
+///
+/// The server appends the options requested by a client, using PRL or
+/// ORO option, to the response. For each requested option code it looks
+/// up the option in the configured option containers: host reservation,
+/// subnet, client classes and global, in this order. The options are
+/// then packed into the response. The clients belonging to the same
+/// subnet and classes typically request the same options, so both the
+/// lookups and the packing produce the same results for many responses.
+///
+/// This class caches the results of the lookups along with the wire data
+/// of the options found. The cache entry is identified by the list of the
+/// configured option containers, the option space and the list of the
+/// requested option codes. The entry is created when it is used for the
+/// first time. The wire data should be added to the response using
+/// @c Pkt::addPackedOption, so as it is copied to the output buffer
+/// instead of packing the options again.
+///
+/// The entries refer to the option containers of the current server
+/// configuration. The cache is cleared when the configuration is changed,
+/// i.e. the sequence number of the current configuration returned by the
+/// @c CfgMgr is different from the one for which the entries have been
+/// created. The configured options must not be modified after they have
+/// been committed.
+class PackedOptionCache {
+public:
+
+    /// @brief Maximum number of the cache entries.
+    ///
+    /// The cache is cleared when the number of entries reaches this
+    /// value, so as the clients requesting many different combinations
+    /// of options don't cause unbounded growth of the cache.
+    static const size_t MAX_ENTRIES = 4096;
+
+    /// @brief Constructor.
+    PackedOptionCache();
+
+    /// @brief Returns the configured options for the requested codes.
+    ///
+    /// For each requested option code, the option is taken from the
+    /// first option container in the @c co_list which holds the option
+    /// with this code. The codes for which no option is configured are
+    /// skipped. The options are returned in the order of the requested
+    /// codes.
+    ///
+    /// @param co_list List of the configured option containers in the
+    /// order of their precedence.
+    /// @param option_space Name of the option space.
+    /// @param codes Requested option codes.
+    ///
+    /// @return Pointer to the list of the options found along with their
+    /// wire data.
+    ConstPackedOptionListPtr get(const CfgOptionList& co_list,
+                                 const std::string& option_space,
+                                 const std::vector<uint16_t>& codes);
+
+    /// @brief Removes all entries from the cache.
+    void clear();
+
+    /// @brief Returns the number of the cache entries.
+    size_t size() const {
+        return (entries_.size());
+    }
+
+private:
+
+    /// @brief Cache entry.
+    struct Entry {
+
+        /// @brief Checks if the entry has been created for the specified
+        /// parameters.
+        ///
+        /// @param co_list List of the configured option containers.
+        /// @param option_space Name of the option space.
+        /// @param codes Requested option codes.
+        bool matches(const CfgOptionList& co_list,
+                     const std::string& option_space,
+                     const std::vector<uint16_t>& codes) const;
+
+        /// @brief Configured option containers.
+        std::vector<ConstCfgOptionPtr> co_list_;
+
+        /// @brief Name of the option space.
+        std::string option_space_;
+
+        /// @brief Requested option codes.
+        std::vector<uint16_t> codes_;
+
+        /// @brief Options found along with their wire data.
+        ConstPackedOptionListPtr options_;
+    };
+
+    /// @brief Computes the hash of the parameters identifying the entry.
+    ///
+    /// @param co_list List of the configured option containers.
+    /// @param option_space Name of the option space.
+    /// @param codes Requested option codes.
+    static size_t hash(const CfgOptionList& co_list,
+                       const std::string& option_space,
+                       const std::vector<uint16_t>& codes);
+
+    /// @brief Looks up the options and packs them.
+    ///
+    /// @param co_list List of the configured option containers.
+    /// @param option_space Name of the option space.
+    /// @param codes Requested option codes.
+    static ConstPackedOptionListPtr
+    createOptions(const CfgOptionList& co_list,
+                  const std::string& option_space,
+                  const std::vector<uint16_t>& codes);
+
+    /// @brief Clears the cache if the configuration has been changed.
+    void checkSequence();
+
+    /// @brief Cache entries by hash of the parameters identifying them.
+    std::multimap<size_t, Entry> entries_;
+
+    /// @brief Sequence number of the configuration for which the entries
+    /// have been created.
+    uint32_t sequence_;
+};
+
+}
+}
+
+#endif // PACKED_OPTION_CACHE_H
@@ -355,8 +355,9 @@ HooksLibrariesParser::getLibraries(isc::hooks::HookLibsCollection& libraries) {
 }
 
 // **************************** OptionDataParser *************************
-OptionDataParser::OptionDataParser(const uint16_t address_family)
-    : address_family_(address_family) {
+OptionDataParser::OptionDataParser(const uint16_t address_family,
+                                   const ConstCfgOptionDefPtr& cfg_option_def)
+    : address_family_(address_family), cfg_option_def_(cfg_option_def) {
 }
 
 std::pair<OptionDescriptor, std::string>
@@ -515,8 +516,11 @@ OptionDataParser::findOptionDefinition(const std::string& option_space,
 
     if (!def) {
         // Check if this is an option specified by a user.
-        def = CfgMgr::instance().getStagingCfg()->getCfgOptionDef()
-            ->get(option_space, search_key);
+        ConstCfgOptionDefPtr cfg_option_def = cfg_option_def_;
+        if (!cfg_option_def) {
+            cfg_option_def = CfgMgr::instance().getStagingCfg()->getCfgOptionDef();
+        }
+        def = cfg_option_def->get(option_space, search_key);
     }
 
     return (def);
@@ -655,14 +659,15 @@ OptionDataParser::createOption(ConstElementPtr option_data) {
 // **************************** OptionDataListParser *************************
 OptionDataListParser::OptionDataListParser(//const std::string&,
                                            //const CfgOptionPtr& cfg,
-                                           const uint16_t address_family)
-    : address_family_(address_family) {
+                                           const uint16_t address_family,
+                                           const ConstCfgOptionDefPtr& cfg_option_def)
+    : address_family_(address_family), cfg_option_def_(cfg_option_def) {
 }
 
 
 void OptionDataListParser::parse(const CfgOptionPtr& cfg,
                                  isc::data::ConstElementPtr option_data_list) {
-    OptionDataParser option_parser(address_family_);
+    OptionDataParser option_parser(address_family_, cfg_option_def_);
     BOOST_FOREACH(ConstElementPtr data, option_data_list->listValue()) {
         std::pair<OptionDescriptor, std::string> option =
             option_parser.parse(data);
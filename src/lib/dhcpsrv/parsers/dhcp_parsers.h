@@ -528,7 +528,12 @@ public:
     /// @brief Constructor.
     ///
     /// @param address_family Address family: @c AF_INET or @c AF_INET6.
-    OptionDataParser(const uint16_t address_family);
+    /// @param cfg_option_def Option definitions used to find definitions
+    /// of the options which aren't standard options. If not specified,
+    /// the definitions held in the staging configuration are used.
+    OptionDataParser(const uint16_t address_family,
+                     const ConstCfgOptionDefPtr& cfg_option_def =
+                     ConstCfgOptionDefPtr());
 
     /// @brief Parses ElementPtr containing option definition
     ///
@@ -627,6 +632,9 @@ private:
 
     /// @brief Address family: @c AF_INET or @c AF_INET6.
     uint16_t address_family_;
+
+    /// @brief Option definitions to be used instead of the staging ones.
+    ConstCfgOptionDefPtr cfg_option_def_;
 };
 
 ///@brief Function pointer for OptionDataParser factory methods
@@ -644,7 +652,12 @@ public:
     /// @brief Constructor.
     ///
     /// @param address_family Address family: @c AF_INET or AF_INET6
-    OptionDataListParser(const uint16_t address_family);
+    /// @param cfg_option_def Option definitions used to find definitions
+    /// of the options which aren't standard options. If not specified,
+    /// the definitions held in the staging configuration are used.
+    OptionDataListParser(const uint16_t address_family,
+                         const ConstCfgOptionDefPtr& cfg_option_def =
+                         ConstCfgOptionDefPtr());
 
     /// @brief Parses a list of options, instantiates them and stores in cfg
     ///
@@ -659,6 +672,9 @@ public:
 private:
     /// @brief Address family: @c AF_INET or @c AF_INET6
     uint16_t address_family_;
+
+    /// @brief Option definitions to be used instead of the staging ones.
+    ConstCfgOptionDefPtr cfg_option_def_;
 };
 
 typedef std::pair<isc::dhcp::OptionDefinitionPtr, std::string> OptionDefinitionTuple;
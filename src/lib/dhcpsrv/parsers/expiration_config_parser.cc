@@ -46,6 +46,9 @@ ExpirationConfigParser::parse(ConstElementPtr expiration_config) {
             } else if (param_name == "unwarned-reclaim-cycles") {
                 cfg->setUnwarnedReclaimCycles(param_value->intValue());
 
+            } else if (param_name == "reclaim-thread") {
+                cfg->setReclaimThread(param_value->boolValue());
+
             } else {
                 isc_throw(DhcpConfigError, "unsupported parameter '"
                           << param_name << "'");
@@ -21,39 +21,48 @@ using namespace isc::data;
 
 namespace {
 
+/// @brief Creates the set of parameters.
+///
+/// @param first Pointer to the first parameter name.
+/// @param last Pointer past the last parameter name.
+/// @param base Set of parameters to which the parameters are added.
+std::set<std::string>
+createParamsSet(const char* const* first, const char* const* last,
+                const std::set<std::string>& base = std::set<std::string>()) {
+    std::set<std::string> params_set(base);
+    params_set.insert(first, last);
+    return (params_set);
+}
+
 /// @brief Returns set of the supported parameters for DHCPv4.
 ///
 /// This function returns the set of supported parameters for
 /// host reservation in DHCPv4.
 ///
+/// The sets are initialized when the function is called for the first
+/// time, which is thread safe, so as the reservations can be parsed by
+/// multiple threads.
+///
 /// @param identifiers_only Indicates if the function should only
 /// return supported host identifiers (if true) or all supported
 /// parameters (if false).
 const std::set<std::string>&
 getSupportedParams4(const bool identifiers_only = false) {
+    static const char* const identifiers[] = {
+        "hw-address", "duid", "circuit-id", "client-id"
+    };
+    static const char* const params[] = {
+        "hostname", "ip-address", "option-data", "next-server",
+        "server-hostname", "boot-file-name", "client-classes"
+    };
     // Holds set of host identifiers.
-    static std::set<std::string> identifiers_set;
+    static const std::set<std::string> identifiers_set =
+        createParamsSet(identifiers, identifiers + sizeof(identifiers) /
+                        sizeof(identifiers[0]));
     // Holds set of all supported parameters, including identifiers.
-    static std::set<std::string> params_set;
-    // If this is first execution of this function, we need
-    // to initialize the set.
-    if (identifiers_set.empty()) {
-        identifiers_set.insert("hw-address");
-        identifiers_set.insert("duid");
-        identifiers_set.insert("circuit-id");
-        identifiers_set.insert("client-id");
-    }
-    // Copy identifiers and add all other parameters.
-    if (params_set.empty()) {
-        params_set = identifiers_set;
-        params_set.insert("hostname");
-        params_set.insert("ip-address");
-        params_set.insert("option-data");
-        params_set.insert("next-server");
-        params_set.insert("server-hostname");
-        params_set.insert("boot-file-name");
-        params_set.insert("client-classes");
-    }
+    static const std::set<std::string> params_set =
+        createParamsSet(params, params + sizeof(params) / sizeof(params[0]),
+                        identifiers_set);
     return (identifiers_only ? identifiers_set : params_set);
 }
 
@@ -62,30 +71,30 @@ getSupportedParams4(const bool identifiers_only = false) {
 /// This function returns the set of supported parameters for
 /// host reservation in DHCPv6.
 ///
+/// The sets are initialized when the function is called for the first
+/// time, which is thread safe, so as the reservations can be parsed by
+/// multiple threads.
+///
 /// @param identifiers_only Indicates if the function should only
 /// return supported host identifiers (if true) or all supported
 /// parameters (if false).
 const std::set<std::string>&
 getSupportedParams6(const bool identifiers_only = false) {
+    static const char* const identifiers[] = {
+        "hw-address", "duid"
+    };
+    static const char* const params[] = {
+        "hostname", "ip-addresses", "prefixes", "option-data",
+        "client-classes"
+    };
     // Holds set of host identifiers.
-    static std::set<std::string> identifiers_set;
+    static const std::set<std::string> identifiers_set =
+        createParamsSet(identifiers, identifiers + sizeof(identifiers) /
+                        sizeof(identifiers[0]));
     // Holds set of all supported parameters, including identifiers.
-    static std::set<std::string> params_set;
-    // If this is first execution of this function, we need
-    // to initialize the set.
-    if (identifiers_set.empty()) {
-        identifiers_set.insert("hw-address");
-        identifiers_set.insert("duid");
-    }
-    // Copy identifiers and add all other parameters.
-    if (params_set.empty()) {
-        params_set = identifiers_set;
-        params_set.insert("hostname");
-        params_set.insert("ip-addresses");
-        params_set.insert("prefixes");
-        params_set.insert("option-data");
-        params_set.insert("client-classes");
-    }
+    static const std::set<std::string> params_set =
+        createParamsSet(params, params + sizeof(params) / sizeof(params[0]),
+                        identifiers_set);
     return (identifiers_only ? identifiers_set : params_set);
 }
 
@@ -98,6 +107,18 @@ void
 HostReservationParser::parse(const SubnetID& subnet_id,
                              isc::data::ConstElementPtr reservation_data) {
     parseInternal(subnet_id, reservation_data);
+
+    // This may fail, but the addHost function will handle this on its own.
+    addHost(reservation_data);
+}
+
+HostPtr
+HostReservationParser::parseHost(const SubnetID& subnet_id,
+                                 isc::data::ConstElementPtr reservation_data,
+                                 const ConstCfgOptionDefPtr& cfg_option_def) {
+    cfg_option_def_ = cfg_option_def;
+    parseInternal(subnet_id, reservation_data);
+    return (host_);
 }
 
 void
@@ -200,7 +221,7 @@ HostReservationParser4::parseInternal(const SubnetID& subnet_id,
             // This parser is converted to SimpleParser already. It
             // parses the Element structure immediately, there's no need
             // to go through build/commit phases.
-            OptionDataListParser parser(AF_INET);
+            OptionDataListParser parser(AF_INET, cfg_option_def_);
             parser.parse(cfg_option, element.second);
 
        // Everything else should be surrounded with try-catch to append
@@ -233,8 +254,6 @@ HostReservationParser4::parseInternal(const SubnetID& subnet_id,
             }
         }
     }
-
-    addHost(reservation_data);
 }
 
 const std::set<std::string>&
@@ -260,7 +279,7 @@ HostReservationParser6::parseInternal(const SubnetID& subnet_id,
             // This parser is converted to SimpleParser already. It
             // parses the Element structure immediately, there's no need
             // to go through build/commit phases.
-            OptionDataListParser parser(AF_INET6);
+            OptionDataListParser parser(AF_INET6, cfg_option_def_);
             parser.parse(cfg_option, element.second);
 
         } else if (element.first == "ip-addresses" || element.first == "prefixes") {
@@ -341,9 +360,6 @@ HostReservationParser6::parseInternal(const SubnetID& subnet_id,
             }
         }
     }
-
-    // This may fail, but the addHost function will handle this on its own.
-    addHost(reservation_data);
 }
 
 const std::set<std::string>&
@@ -9,6 +9,7 @@
 
 #include <cc/data.h>
 #include <cc/simple_parser.h>
+#include <dhcpsrv/cfg_option_def.h>
 #include <dhcpsrv/host.h>
 
 namespace isc {
@@ -28,10 +29,36 @@ public:
     /// @param reservation_data Data element holding map with a host
     /// reservation configuration.
     ///
+    /// The parsed host is inserted into the staging configuration.
+    ///
     /// @throw DhcpConfigError If the configuration is invalid.
     void parse(const SubnetID& subnet_id,
                isc::data::ConstElementPtr reservation_data);
 
+    /// @brief Parses a single entry for host reservation and returns
+    /// the resulting host.
+    ///
+    /// In contrast to @ref parse, this method doesn't insert the host
+    /// into the staging configuration. It is also used by the commands
+    /// which add host reservations to the running server. These must
+    /// not use the staging configuration at all, so they specify the
+    /// option definitions of the current configuration.
+    ///
+    /// @param subnet_id Identifier of the subnet that the host is
+    /// connected to.
+    /// @param reservation_data Data element holding map with a host
+    /// reservation configuration.
+    /// @param cfg_option_def Option definitions used to parse the
+    /// options included in the reservation. If not specified, the
+    /// option definitions of the staging configuration are used.
+    ///
+    /// @return Pointer to the parsed host.
+    /// @throw DhcpConfigError If the configuration is invalid.
+    HostPtr parseHost(const SubnetID& subnet_id,
+                      isc::data::ConstElementPtr reservation_data,
+                      const ConstCfgOptionDefPtr& cfg_option_def =
+                      ConstCfgOptionDefPtr());
+
 protected:
 
     /// @brief Parses a single entry for host reservation.
@@ -50,8 +77,8 @@ protected:
 
     /// @brief Inserts @c host_ object to the staging configuration.
     ///
-    /// This method should be called by derived classes to insert the fully
-    /// parsed host reservation configuration to the @c CfgMgr.
+    /// This method is called by @ref parse to insert the fully parsed
+    /// host reservation configuration to the @c CfgMgr.
     ///
     /// @param reservation_data Data element holding host reservation. It
     /// used by this method to append the line number to the error string.
@@ -88,6 +115,12 @@ protected:
     /// host reservation configuration.
     HostPtr host_;
 
+    /// @brief Option definitions used to parse options.
+    ///
+    /// If null, the option definitions of the staging configuration
+    /// are used.
+    ConstCfgOptionDefPtr cfg_option_def_;
+
 };
 
 /// @brief Parser for a single host reservation for DHCPv4.
@@ -0,0 +1,220 @@
+// Copyright (C) 2017 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <dhcp/dhcp6.h>
+#include <dhcp/docsis3_option_defs.h>
+#include <dhcp/libdhcp++.h>
+#include <dhcp/option_space.h>
+#include <dhcpsrv/cfg_hosts.h>
+#include <dhcpsrv/cfgmgr.h>
+#include <dhcpsrv/parsers/dhcp_config_parser.h>
+#include <dhcpsrv/parsers/parallel_host_reservations_parser.h>
+#include <util/threads/thread.h>
+#include <boost/bind.hpp>
+#include <boost/foreach.hpp>
+#include <boost/shared_ptr.hpp>
+#include <algorithm>
+#include <stdexcept>
+#include <unistd.h>
+
+using namespace isc::data;
+using namespace isc::util::thread;
+
+namespace {
+
+/// @brief Number of the reservations taken by a thread at once.
+const size_t CHUNK_SIZE = 32;
+
+/// @brief Pointer to the thread.
+typedef boost::shared_ptr<Thread> ThreadPtr;
+
+/// @brief Waits for the threads to terminate.
+///
+/// @param threads Threads to wait for.
+void
+waitThreads(std::vector<ThreadPtr>& threads) {
+    for (std::vector<ThreadPtr>::const_iterator thread = threads.begin();
+         thread != threads.end(); ++thread) {
+        (*thread)->wait();
+    }
+    threads.clear();
+}
+
+}
+
+namespace isc {
+namespace dhcp {
+
+const size_t ParallelHostReservationsParser::MIN_PARALLEL_RESERVATIONS;
+const size_t ParallelHostReservationsParser::MAX_THREADS;
+
+ParallelHostReservationsParser::
+ParallelHostReservationsParser(const HostParser& parser,
+                               const size_t threads_num)
+    : parser_(parser), threads_num_(threads_num), entries_(), next_(0),
+      first_failed_(0), mutex_() {
+    if (threads_num_ == 0) {
+        const long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        threads_num_ = (cpus > 0 ? static_cast<size_t>(cpus) : 1);
+        threads_num_ = std::min(threads_num_, MAX_THREADS);
+    }
+}
+
+void
+ParallelHostReservationsParser::add(const SubnetID& subnet_id,
+                                    ConstElementPtr hr_list) {
+    BOOST_FOREACH(ConstElementPtr reservation, hr_list->listValue()) {
+        entries_.push_back(Entry(subnet_id, reservation));
+    }
+}
+
+void
+ParallelHostReservationsParser::add(const ConstHostCollection& hosts) {
+    for (ConstHostCollection::const_iterator host = hosts.begin();
+         host != hosts.end(); ++host) {
+        entries_.push_back(Entry(SubnetID(0), ConstElementPtr(),
+                                 HostPtr(new Host(**host))));
+    }
+}
+
+void
+ParallelHostReservationsParser::parse() {
+    // Empty the queue, whatever the result is.
+    try {
+        parseQueued();
+
+    } catch (...) {
+        entries_.clear();
+        throw;
+    }
+    entries_.clear();
+}
+
+void
+ParallelHostReservationsParser::parseQueued() {
+    if (entries_.empty()) {
+        return;
+    }
+
+    next_ = 0;
+    first_failed_ = entries_.size();
+
+    if ((threads_num_ > 1) && (entries_.size() >= MIN_PARALLEL_RESERVATIONS)) {
+        initOptionDefs();
+
+        // The calling thread is one of the parsing threads. If any of the
+        // threads can't be created, the reservations are parsed by the
+        // threads created so far.
+        boost::function<void()> main =
+            boost::bind(&ParallelHostReservationsParser::parseEntries, this);
+        std::vector<ThreadPtr> threads;
+        try {
+            for (size_t i = 1; i < threads_num_; ++i) {
+                threads.push_back(ThreadPtr(new Thread(main)));
+            }
+        } catch (const std::exception&) {
+        }
+
+        try {
+            parseEntries();
+        } catch (...) {
+            waitThreads(threads);
+            throw;
+        }
+        waitThreads(threads);
+
+    } else {
+        parseEntries();
+    }
+
+    // Add the hosts to the configuration in the order of the reservations.
+    CfgHostsPtr cfg_hosts = CfgMgr::instance().getStagingCfg()->getCfgHosts();
+    for (std::vector<Entry>::const_iterator entry = entries_.begin();
+         entry != entries_.end(); ++entry) {
+        if (entry->failed_) {
+            if (entry->isc_error_) {
+                isc_throw(DhcpConfigError, entry->error_);
+            }
+            // Not an isc::Exception, e.g. bad_cast.
+            throw std::runtime_error(entry->error_);
+        }
+
+        try {
+            cfg_hosts->add(entry->host_);
+
+        } catch (const std::exception& ex) {
+            if (!entry->data_) {
+                throw;
+            }
+            // Append line number to the exception string.
+            isc_throw(DhcpConfigError, ex.what() << " ("
+                      << entry->data_->getPosition() << ")");
+        }
+    }
+}
+
+void
+ParallelHostReservationsParser::parseEntries() {
+    for (;;) {
+        size_t begin = 0;
+        size_t end = 0;
+        {
+            Mutex::Locker lock(mutex_);
+            // Stop if all reservations have been taken or any of the
+            // reservations preceding the remaining ones failed to parse.
+            if ((next_ >= entries_.size()) || (next_ > first_failed_)) {
+                return;
+            }
+            begin = next_;
+            end = std::min(begin + CHUNK_SIZE, entries_.size());
+            next_ = end;
+        }
+
+        for (size_t i = begin; i < end; ++i) {
+            parseEntry(entries_[i]);
+            if (entries_[i].failed_) {
+                Mutex::Locker lock(mutex_);
+                first_failed_ = std::min(first_failed_, i);
+                break;
+            }
+        }
+    }
+}
+
+void
+ParallelHostReservationsParser::parseEntry(Entry& entry) const {
+    if (entry.host_) {
+        return;
+    }
+
+    try {
+        entry.host_ = parser_(entry.subnet_id_, entry.data_);
+        return;
+
+    } catch (const isc::Exception& ex) {
+        entry.error_ = ex.what();
+        entry.isc_error_ = true;
+
+    } catch (const std::exception& ex) {
+        entry.error_ = ex.what();
+
+    } catch (...) {
+        entry.error_ = "unknown error";
+    }
+    entry.failed_ = true;
+}
+
+void
+ParallelHostReservationsParser::initOptionDefs() {
+    LibDHCP::getOptionDefs(DHCP4_OPTION_SPACE);
+    LibDHCP::getVendorOption4Defs(VENDOR_ID_CABLE_LABS);
+    LibDHCP::getVendorOption6Defs(VENDOR_ID_CABLE_LABS);
+    LibDHCP::getVendorOption6Defs(ENTERPRISE_ID_ISC);
+}
+
+}
+}
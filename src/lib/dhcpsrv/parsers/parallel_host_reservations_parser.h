@@ -0,0 +1,200 @@
+// Copyright (C) 2017 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef PARALLEL_HOST_RESERVATIONS_PARSER_H
+#define PARALLEL_HOST_RESERVATIONS_PARSER_H
+
+#include <cc/data.h>
+#include <dhcpsrv/host.h>
+#include <dhcpsrv/subnet_id.h>
+#include <util/threads/sync.h>
+#include <boost/function.hpp>
+#include <boost/noncopyable.hpp>
+#include <string>
+#include <vector>
+
+namespace isc {
+namespace dhcp {
+
+/// @brief Parser for the host reservations of many subnets using multiple
+/// threads.
+///
+/// The host reservations of each subnet are parsed independently from the
+/// other subnets and reservations. The only shared state is the collection
+/// of the hosts in the staging configuration, which the parsed hosts are
+/// added to. This parser takes advantage of it, parsing the reservations
+/// by a pool of threads and adding the parsed hosts to the staging
+/// configuration in the order in which they have been specified.
+///
+/// The subnets parsers queue the lists of the reservations to be parsed
+/// and the unchanged hosts to be copied from the current configuration,
+/// using the @c add methods. The @c parse method parses the queued
+/// reservations and adds the hosts to the @c CfgHosts of the staging
+/// configuration. If parsing or adding any of the hosts fails, the error
+/// of the first host in the configuration order is reported and the
+/// hosts following it are not added, i.e. the result is the same as if the
+/// reservations were parsed sequentially.
+///
+/// The reservations are parsed by the calling thread if there are only
+/// few of them or if the system has only one CPU.
+class ParallelHostReservationsParser : public boost::noncopyable {
+public:
+
+    /// @brief Type of the function parsing a single host reservation.
+    ///
+    /// The function must not modify the server configuration and it must
+    /// not use any state shared with the other threads, other than the
+    /// read only access to the staging configuration and the option
+    /// definitions.
+    typedef boost::function<HostPtr(const SubnetID&,
+                                    isc::data::ConstElementPtr)> HostParser;
+
+    /// @brief Minimal number of the queued reservations for which the
+    /// threads are used.
+    static const size_t MIN_PARALLEL_RESERVATIONS = 256;
+
+    /// @brief Maximal number of threads parsing the reservations.
+    static const size_t MAX_THREADS = 16;
+
+    /// @brief Constructor.
+    ///
+    /// @param parser Function parsing a single host reservation.
+    /// @param threads_num Number of threads parsing the reservations,
+    /// including the calling thread. If 0, the number of online CPUs,
+    /// limited by @c MAX_THREADS, is used.
+    ParallelHostReservationsParser(const HostParser& parser,
+                                   const size_t threads_num = 0);
+
+    /// @brief Parses a single host reservation using the specified parser.
+    ///
+    /// This function is used to create the @c HostParser functions
+    /// for the specific parsers, e.g.
+    /// @c parseHost<HostReservationParser4>.
+    ///
+    /// @param subnet_id Identifier of the subnet the reservation belongs to.
+    /// @param reservation_data Data element holding the reservation.
+    ///
+    /// @tparam HostReservationParserType Type of the parser.
+    /// @return Pointer to the parsed host.
+    template<typename HostReservationParserType>
+    static HostPtr parseHost(const SubnetID& subnet_id,
+                             isc::data::ConstElementPtr reservation_data) {
+        HostReservationParserType parser;
+        return (parser.parseHost(subnet_id, reservation_data));
+    }
+
+    /// @brief Queues the list of the host reservations for the subnet.
+    ///
+    /// @param subnet_id Identifier of the subnet.
+    /// @param hr_list Data element holding a list of host reservations.
+    void add(const SubnetID& subnet_id, isc::data::ConstElementPtr hr_list);
+
+    /// @brief Queues the hosts to be copied to the staging configuration.
+    ///
+    /// @param hosts Hosts, typically taken from the current configuration.
+    void add(const ConstHostCollection& hosts);
+
+    /// @brief Returns the number of the queued hosts.
+    size_t size() const {
+        return (entries_.size());
+    }
+
+    /// @brief Parses the queued reservations and adds the hosts to the
+    /// staging configuration.
+    ///
+    /// The queue is empty when this method returns.
+    ///
+    /// @throw DhcpConfigError if any of the reservations is invalid or
+    /// the host can't be added to the configuration. The error message
+    /// is the same as if the reservations were parsed sequentially.
+    void parse();
+
+    /// @brief Returns the number of threads parsing the reservations.
+    size_t getThreadsNum() const {
+        return (threads_num_);
+    }
+
+private:
+
+    /// @brief Queued host.
+    struct Entry {
+
+        /// @brief Constructor.
+        ///
+        /// @param subnet_id Identifier of the subnet.
+        /// @param data Data element holding the reservation or null
+        /// pointer if the host has been already parsed.
+        /// @param host Pointer to the host if it has been already parsed.
+        Entry(const SubnetID& subnet_id, isc::data::ConstElementPtr data,
+              const HostPtr& host = HostPtr())
+            : subnet_id_(subnet_id), data_(data), host_(host), error_(),
+              failed_(false), isc_error_(false) {
+        }
+
+        /// @brief Identifier of the subnet.
+        SubnetID subnet_id_;
+
+        /// @brief Data element holding the reservation.
+        isc::data::ConstElementPtr data_;
+
+        /// @brief Parsed host.
+        HostPtr host_;
+
+        /// @brief Error message if parsing the reservation failed.
+        std::string error_;
+
+        /// @brief Indicates if parsing the reservation failed.
+        bool failed_;
+
+        /// @brief Indicates if the error is an @c isc::Exception.
+        bool isc_error_;
+    };
+
+    /// @brief Parses the queued reservations and adds the hosts to the
+    /// staging configuration.
+    ///
+    /// This method implements @c parse, which empties the queue.
+    void parseQueued();
+
+    /// @brief Parses the queued reservations until there are none left.
+    ///
+    /// This is the main function of each thread.
+    void parseEntries();
+
+    /// @brief Parses a single queued reservation.
+    ///
+    /// The exceptions are stored in the entry.
+    ///
+    /// @param entry Queued reservation.
+    void parseEntry(Entry& entry) const;
+
+    /// @brief Initializes the option definitions, so as they are not
+    /// initialized concurrently by the threads.
+    static void initOptionDefs();
+
+    /// @brief Function parsing a single host reservation.
+    HostParser parser_;
+
+    /// @brief Number of threads parsing the reservations.
+    size_t threads_num_;
+
+    /// @brief Queued hosts.
+    std::vector<Entry> entries_;
+
+    /// @brief Index of the next entry to be parsed.
+    size_t next_;
+
+    /// @brief Index of the first entry which failed to parse.
+    size_t first_failed_;
+
+    /// @brief Mutex protecting @c next_ and @c first_failed_.
+    isc::util::thread::Mutex mutex_;
+};
+
+}
+}
+
+#endif // PARALLEL_HOST_RESERVATIONS_PARSER_H
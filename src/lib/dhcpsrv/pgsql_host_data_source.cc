@@ -1,4 +1,4 @@
-// Copyright (C) 2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2016-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -21,6 +21,7 @@
 #include <boost/algorithm/string/split.hpp>
 #include <boost/algorithm/string/classification.hpp>
 #include <boost/array.hpp>
+#include <boost/lexical_cast.hpp>
 #include <boost/pointer_cast.hpp>
 #include <boost/static_assert.hpp>
 
@@ -1180,6 +1181,7 @@ public:
         INSERT_V6_RESRV,        // Insert v6 reservation
         INSERT_V4_HOST_OPTION,  // Insert DHCPv4 option
         INSERT_V6_HOST_OPTION,  // Insert DHCPv6 option
+        DEL_HOST,               // Delete host
         NUM_STATEMENTS          // Number of statements
     };
 
@@ -1249,6 +1251,17 @@ public:
                     const ConstCfgOptionPtr& options_cfg,
                     const uint64_t host_id);
 
+    /// @brief Deletes the host along with its IPv6 reservations and options.
+    ///
+    /// The IPv6 reservations and options are deleted by the database
+    /// because of the ON DELETE CASCADE clause of their foreign keys.
+    ///
+    /// @param host Pointer to the host retrieved from the database or NULL.
+    ///
+    /// @return true if the host has been deleted, false if the host is
+    /// NULL or it no longer exists in the database.
+    bool delHost(const ConstHostPtr& host);
+
     /// @brief Creates collection of @ref Host objects with associated
     /// information such as IPv6 reservations and/or DHCP options.
     ///
@@ -1561,6 +1574,15 @@ TaggedStatementArray tagged_statements = { {
      "INSERT INTO dhcp6_options(code, value, formatted_value, space, "
      "  persistent, host_id, scope_id) "
      "VALUES ($1, $2, $3, $4, $5, $6, 3)"
+    },
+
+    // PgSqlHostDataSourceImpl::DEL_HOST
+    // Deletes a host from the 'hosts' table. The IPv6 reservations and
+    // options are deleted by cascade.
+    {1,
+     { OID_INT8 },
+     "del_host",
+     "DELETE FROM hosts WHERE host_id = $1"
     }
 }
 };
@@ -1634,6 +1656,29 @@ PgSqlHostDataSourceImpl::addStatement(StatementIndex stindex,
 
 }
 
+bool
+PgSqlHostDataSourceImpl::delHost(const ConstHostPtr& host) {
+    if (!host) {
+        return (false);
+    }
+
+    // Set up the WHERE clause value
+    PsqlBindArray bind_array;
+    std::string host_id_str = boost::lexical_cast<std::string>(host->getHostId());
+    bind_array.add(host_id_str);
+
+    PgSqlResult r(PQexecPrepared(conn_, tagged_statements[DEL_HOST].name,
+                                 tagged_statements[DEL_HOST].nbparams,
+                                 &bind_array.values_[0],
+                                 &bind_array.lengths_[0],
+                                 &bind_array.formats_[0], 0));
+
+    conn_.checkStatementError(r, tagged_statements[DEL_HOST]);
+    int affected_rows = boost::lexical_cast<int>(PQcmdTuples(r));
+
+    return (affected_rows > 0);
+}
+
 void
 PgSqlHostDataSourceImpl::addResv(const IPv6Resrv& resv,
                                  const HostID& id) {
@@ -1821,6 +1866,42 @@ PgSqlHostDataSource::add(const HostPtr& host) {
     transaction.commit();
 }
 
+bool
+PgSqlHostDataSource::del(const SubnetID& subnet_id,
+                         const asiolink::IOAddress& addr) {
+    // If operating in read-only mode, throw exception.
+    impl_->checkReadOnly();
+
+    // Find the host to obtain its identifier in the database.
+    ConstHostPtr host = (addr.isV4() ? get4(subnet_id, addr) :
+                         get6(subnet_id, addr));
+    return (impl_->delHost(host));
+}
+
+bool
+PgSqlHostDataSource::del4(const SubnetID& subnet_id,
+                          const Host::IdentifierType& identifier_type,
+                          const uint8_t* identifier_begin,
+                          const size_t identifier_len) {
+    // If operating in read-only mode, throw exception.
+    impl_->checkReadOnly();
+
+    return (impl_->delHost(get4(subnet_id, identifier_type, identifier_begin,
+                                identifier_len)));
+}
+
+bool
+PgSqlHostDataSource::del6(const SubnetID& subnet_id,
+                          const Host::IdentifierType& identifier_type,
+                          const uint8_t* identifier_begin,
+                          const size_t identifier_len) {
+    // If operating in read-only mode, throw exception.
+    impl_->checkReadOnly();
+
+    return (impl_->delHost(get6(subnet_id, identifier_type, identifier_begin,
+                                identifier_len)));
+}
+
 ConstHostCollection
 PgSqlHostDataSource::getAll(const HWAddrPtr& hwaddr,
                             const DuidPtr& duid) const {
@@ -1,4 +1,4 @@
-// Copyright (C) 2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2016-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -251,6 +251,50 @@ public:
     /// violation
     virtual void add(const HostPtr& host);
 
+    /// @brief Attempts to delete a host by (subnet-id, address).
+    ///
+    /// This method supports both v4 and v6. The host is deleted along with
+    /// its IPv6 reservations and DHCP options.
+    ///
+    /// @param subnet_id subnet identifier.
+    /// @param addr specified address.
+    ///
+    /// @return true if the host was deleted, false if it was not found.
+    /// @throw ReadOnlyDb if the backend operates in read only mode.
+    virtual bool del(const SubnetID& subnet_id, const asiolink::IOAddress& addr);
+
+    /// @brief Attempts to delete a host by (subnet4-id, identifier type,
+    /// identifier).
+    ///
+    /// @param subnet_id IPv4 subnet identifier.
+    /// @param identifier_type Identifier type.
+    /// @param identifier_begin Pointer to a begining of a buffer containing
+    /// an identifier.
+    /// @param identifier_len Identifier length.
+    ///
+    /// @return true if the host was deleted, false if it was not found.
+    /// @throw ReadOnlyDb if the backend operates in read only mode.
+    virtual bool del4(const SubnetID& subnet_id,
+                      const Host::IdentifierType& identifier_type,
+                      const uint8_t* identifier_begin,
+                      const size_t identifier_len);
+
+    /// @brief Attempts to delete a host by (subnet6-id, identifier type,
+    /// identifier).
+    ///
+    /// @param subnet_id IPv6 subnet identifier.
+    /// @param identifier_type Identifier type.
+    /// @param identifier_begin Pointer to a begining of a buffer containing
+    /// an identifier.
+    /// @param identifier_len Identifier length.
+    ///
+    /// @return true if the host was deleted, false if it was not found.
+    /// @throw ReadOnlyDb if the backend operates in read only mode.
+    virtual bool del6(const SubnetID& subnet_id,
+                      const Host::IdentifierType& identifier_type,
+                      const uint8_t* identifier_begin,
+                      const size_t identifier_len);
+
     /// @brief Return backend type
     ///
     /// Returns the type of database as the string "postgresql".  This is
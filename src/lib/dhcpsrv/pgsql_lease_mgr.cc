@@ -1,4 +1,4 @@
-// Copyright (C) 2014-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2014-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -111,6 +111,17 @@ PgSqlTaggedStatement tagged_statements[] = {
               "ORDER BY expire "
               "LIMIT $3"},
 
+    // GET_LEASE4_PAGE
+    { 2, { OID_INT8, OID_INT8 },
+      "get_lease4_page",
+      "SELECT address, hwaddr, client_id, "
+          "valid_lifetime, extract(epoch from expire)::bigint, subnet_id, "
+          "fqdn_fwd, fqdn_rev, hostname, state "
+              "FROM lease4 "
+              "WHERE address > $1 "
+              "ORDER BY address "
+              "LIMIT $2"},
+
     // GET_LEASE6_ADDR
     { 2, { OID_VARCHAR, OID_INT2 },
       "get_lease6_addr",
@@ -155,6 +166,18 @@ PgSqlTaggedStatement tagged_statements[] = {
               "ORDER BY expire "
               "LIMIT $3"},
 
+    // GET_LEASE6_PAGE
+    { 2, { OID_VARCHAR, OID_INT8 },
+      "get_lease6_page",
+      "SELECT address, duid, valid_lifetime, "
+          "extract(epoch from expire)::bigint, subnet_id, pref_lifetime, "
+          "lease_type, iaid, prefix_len, fqdn_fwd, fqdn_rev, hostname, "
+          "state "
+              "FROM lease6 "
+              "WHERE address > $1 "
+              "ORDER BY address "
+              "LIMIT $2"},
+
     // GET_VERSION
     { 0, { OID_NONE },
       "get_version",
@@ -1171,6 +1194,70 @@ PgSqlLeaseMgr::getExpiredLeases4(Lease4Collection& expired_leases,
     getExpiredLeasesCommon(expired_leases, max_leases, GET_LEASE4_EXPIRE);
 }
 
+Lease4Collection
+PgSqlLeaseMgr::getLeases4(const asiolink::IOAddress& lower_bound_address,
+                          const size_t page_size) const {
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_PGSQL_GET_PAGE4)
+        .arg(page_size).arg(lower_bound_address.toText());
+
+    if (!lower_bound_address.isV4()) {
+        isc_throw(BadValue, "expected IPv4 address while retrieving leases"
+                  " from the lease database, got " << lower_bound_address);
+    }
+
+    // Set up the WHERE clause value
+    PsqlBindArray bind_array;
+
+    // LOWER BOUND ADDRESS
+    std::string lb_address_str = boost::lexical_cast<std::string>
+                                 (lower_bound_address.toUint32());
+    bind_array.add(lb_address_str);
+
+    // PAGE SIZE
+    std::string page_size_str = boost::lexical_cast<std::string>(page_size);
+    bind_array.add(page_size_str);
+
+    // Get the data
+    Lease4Collection result;
+    getLeaseCollection(GET_LEASE4_PAGE, bind_array, result);
+
+    return (result);
+}
+
+Lease6Collection
+PgSqlLeaseMgr::getLeases6(const asiolink::IOAddress& lower_bound_address,
+                          const size_t page_size) const {
+    LOG_DEBUG(dhcpsrv_logger, DHCPSRV_DBG_TRACE_DETAIL, DHCPSRV_PGSQL_GET_PAGE6)
+        .arg(page_size).arg(lower_bound_address.toText());
+
+    if (!lower_bound_address.isV6()) {
+        isc_throw(BadValue, "expected IPv6 address while retrieving leases"
+                  " from the lease database, got " << lower_bound_address);
+    }
+
+    // Set up the WHERE clause value
+    PsqlBindArray bind_array;
+
+    // LOWER BOUND ADDRESS. IPv6 addresses are stored in the textual form,
+    // so they are ordered lexicographically. The same order is used for
+    // the cursor and for sorting, so all leases are still walked over.
+    // The "::" doesn't sort before other addresses, so the first page
+    // is retrieved using an empty string.
+    std::string lb_address_str = (lower_bound_address.isV6Zero() ? "" :
+                                  lower_bound_address.toText());
+    bind_array.add(lb_address_str);
+
+    // PAGE SIZE
+    std::string page_size_str = boost::lexical_cast<std::string>(page_size);
+    bind_array.add(page_size_str);
+
+    // Get the data
+    Lease6Collection result;
+    getLeaseCollection(GET_LEASE6_PAGE, bind_array, result);
+
+    return (result);
+}
+
 template<typename LeaseCollection>
 void
 PgSqlLeaseMgr::getExpiredLeasesCommon(LeaseCollection& expired_leases,
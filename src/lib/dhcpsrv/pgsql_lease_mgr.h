@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -262,6 +262,28 @@ public:
     virtual void getExpiredLeases4(Lease4Collection& expired_leases,
                                    const size_t max_leases) const;
 
+    /// @brief Returns a page of DHCPv4 leases.
+    ///
+    /// @param lower_bound_address IPv4 address used as a cursor. Leases
+    /// with addresses greater than this address are returned.
+    /// @param page_size Maximum number of leases to be returned.
+    ///
+    /// @return Collection of leases in the ascending order of addresses.
+    virtual Lease4Collection
+    getLeases4(const asiolink::IOAddress& lower_bound_address,
+               const size_t page_size) const;
+
+    /// @brief Returns a page of DHCPv6 leases.
+    ///
+    /// @param lower_bound_address IPv6 address used as a cursor. Leases
+    /// with addresses greater than this address are returned.
+    /// @param page_size Maximum number of leases to be returned.
+    ///
+    /// @return Collection of leases in the ascending order of addresses.
+    virtual Lease6Collection
+    getLeases6(const asiolink::IOAddress& lower_bound_address,
+               const size_t page_size) const;
+
     /// @brief Updates IPv4 lease.
     ///
     /// Updates the record of the lease in the database (as identified by the
@@ -396,10 +418,12 @@ public:
         GET_LEASE4_HWADDR,          // Get lease4 by HW address
         GET_LEASE4_HWADDR_SUBID,    // Get lease4 by HW address & subnet ID
         GET_LEASE4_EXPIRE,          // Get expired lease4
+        GET_LEASE4_PAGE,            // Get page of lease4 by address
         GET_LEASE6_ADDR,            // Get lease6 by address
         GET_LEASE6_DUID_IAID,       // Get lease6 by DUID and IAID
         GET_LEASE6_DUID_IAID_SUBID, // Get lease6 by DUID, IAID and subnet ID
         GET_LEASE6_EXPIRE,          // Get expired lease6
+        GET_LEASE6_PAGE,            // Get page of lease6 by address
         GET_VERSION,                // Obtain version number
         INSERT_LEASE4,              // Add entry to lease4 table
         INSERT_LEASE6,              // Add entry to lease6 table
@@ -1,4 +1,4 @@
-// Copyright (C) 2012-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2012-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -18,10 +18,39 @@ Pool::Pool(Lease::Type type, const isc::asiolink::IOAddress& first,
            const isc::asiolink::IOAddress& last)
     :id_(getNextID()), first_(first), last_(last), type_(type),
      capacity_(0), cfg_option_(new CfgOption()) {
+    updateRangeValues();
+}
+
+void
+Pool::updateRangeValues() {
+    if (first_.isV4()) {
+        first_value_ = IPv6Value(0, first_.toUint32());
+        last_value_ = IPv6Value(0, last_.isV4() ? last_.toUint32() : 0);
+    } else {
+        first_value_ = first_.toV6Value();
+        last_value_ = last_.isV6() ? last_.toV6Value() : IPv6Value();
+    }
 }
 
 bool Pool::inRange(const isc::asiolink::IOAddress& addr) const {
-    return (first_.smallerEqual(addr) && addr.smallerEqual(last_));
+    // Compare the integer representations of the addresses rather than
+    // the IOAddress objects, as this is called for each candidate
+    // address by the allocation engine. The pool boundaries have been
+    // converted when the pool was created.
+    if (first_.isV4()) {
+        if (!addr.isV4()) {
+            return (false);
+        }
+        const uint64_t value = addr.toUint32();
+        return ((first_value_.getLow() <= value) &&
+                (value <= last_value_.getLow()));
+    }
+
+    if (!addr.isV6()) {
+        return (false);
+    }
+    const IPv6Value value = addr.toV6Value();
+    return ((first_value_ <= value) && (value <= last_value_));
 }
 
 std::string
@@ -66,6 +95,7 @@ Pool4::Pool4( const isc::asiolink::IOAddress& prefix, uint8_t prefix_len)
 
     // Let's now calculate the last address in defined pool
     last_ = lastAddrInPrefix(prefix, prefix_len);
+    updateRangeValues();
 
     // This is IPv4 pool, which only has one type. We can calculate
     // the number of theoretically possible leases in it. As there's 2^32
@@ -220,6 +250,7 @@ Pool6::init(const Lease::Type& type,
 
     // Let's now calculate the last address in defined pool
     last_ = lastAddrInPrefix(prefix, prefix_len);
+    updateRangeValues();
 
     // Let's calculate the theoretical number of leases in this pool.
     // For addresses, we could use addrsInRange(prefix, last_), but it's
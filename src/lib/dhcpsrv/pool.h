@@ -140,6 +140,21 @@ protected:
     /// @brief The last address in a pool
     isc::asiolink::IOAddress last_;
 
+    /// @brief Sets the integer values of the first and last address.
+    ///
+    /// It must be called whenever @c first_ or @c last_ is modified.
+    void updateRangeValues();
+
+    /// @brief The first address in a pool as an integer.
+    ///
+    /// The IPv4 address is held in the least significant 32 bits. The
+    /// pool boundaries are stored as integers, so that @c inRange doesn't
+    /// convert them for each checked address.
+    isc::asiolink::IPv6Value first_value_;
+
+    /// @brief The last address in a pool as an integer.
+    isc::asiolink::IPv6Value last_value_;
+
     /// @brief Comments field
     ///
     /// @todo: This field is currently not used.
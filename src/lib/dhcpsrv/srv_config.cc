@@ -28,6 +28,7 @@ SrvConfig::SrvConfig()
       cfg_db_access_(new CfgDbAccess()),
       cfg_host_operations4_(CfgHostOperations::createConfig4()),
       cfg_host_operations6_(CfgHostOperations::createConfig6()),
+      cfg_incremental_(new CfgIncremental()),
       class_dictionary_(new ClientClassDictionary()),
       decline_timer_(0), dhcp4o6_port_(0),
       d2_client_config_(new D2ClientConfig()) {
@@ -42,6 +43,7 @@ SrvConfig::SrvConfig(const uint32_t sequence)
       cfg_db_access_(new CfgDbAccess()),
       cfg_host_operations4_(CfgHostOperations::createConfig4()),
       cfg_host_operations6_(CfgHostOperations::createConfig6()),
+      cfg_incremental_(new CfgIncremental()),
       class_dictionary_(new ClientClassDictionary()),
       decline_timer_(0), dhcp4o6_port_(0),
       d2_client_config_(new D2ClientConfig()) {
@@ -12,6 +12,7 @@
 #include <dhcpsrv/cfg_expiration.h>
 #include <dhcpsrv/cfg_host_operations.h>
 #include <dhcpsrv/cfg_hosts.h>
+#include <dhcpsrv/cfg_incremental.h>
 #include <dhcpsrv/cfg_iface.h>
 #include <dhcpsrv/cfg_option.h>
 #include <dhcpsrv/cfg_option_def.h>
@@ -317,6 +318,18 @@ public:
         return (cfg_host_operations6_);
     }
 
+    /// @brief Returns pointer to the object holding configuration elements
+    /// used for the incremental reconfiguration of the subnets.
+    CfgIncrementalPtr getCfgIncremental() {
+        return (cfg_incremental_);
+    }
+
+    /// @brief Returns const pointer to the object holding configuration
+    /// elements used for the incremental reconfiguration of the subnets.
+    ConstCfgIncrementalPtr getCfgIncremental() const {
+        return (cfg_incremental_);
+    }
+
     //@}
 
     /// @brief Returns non-const reference to an array that stores
@@ -570,6 +583,10 @@ private:
     /// DHCPv6.
     CfgHostOperationsPtr cfg_host_operations6_;
 
+    /// @brief Pointer to the configuration elements from which the subnets
+    /// have been created.
+    CfgIncrementalPtr cfg_incremental_;
+
     /// @brief Pointer to the control-socket information
     isc::data::ConstElementPtr control_socket_;
 
@@ -1,4 +1,4 @@
-// Copyright (C) 2015-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -1825,6 +1825,114 @@ TEST_F(AllocEngine4Test, reservedAddressExistingLeaseStat) {
     EXPECT_FALSE(ctx.fake_allocation_);
 }
 
+// This test verifies that the allocation engine skips the addresses which
+// the lease lookup cache reports in use, and checks all addresses in the
+// lease database when the cache is stale.
+TEST_F(AllocEngine4Test, leaseLookupCache) {
+    AllocEngine engine(AllocEngine::ALLOC_ITERATIVE, 0, false);
+    LeaseLookupCachePtr cache(new LeaseLookupCache());
+    engine.setLeaseLookupCache(cache, true);
+
+    // Lease all addresses in the pool but the last one to another client.
+    HWAddrPtr other_hwaddr(new HWAddr(std::vector<uint8_t>(6, 0x77),
+                                      HTYPE_ETHER));
+    for (uint32_t i = 0; i < 9; ++i) {
+        Lease4Ptr lease(new Lease4(IOAddress(0xC0000264 + i), other_hwaddr,
+                                   0, 0, 500, 100, 200, time(NULL),
+                                   subnet_->getID()));
+        ASSERT_TRUE(LeaseMgrFactory::instance().addLease(lease));
+    }
+
+    AllocEngine::ClientContext4 ctx(subnet_, clientid_, hwaddr_,
+                                    IOAddress("0.0.0.0"), false, false,
+                                    "", false);
+    ctx.query_.reset(new Pkt4(DHCPREQUEST, 1234));
+    Lease4Ptr lease = engine.allocateLease4(ctx);
+    ASSERT_TRUE(lease);
+    EXPECT_EQ("192.0.2.109", lease->addr_.toText());
+    EXPECT_EQ(9, cache->getPoolLeasesNum(Lease::TYPE_V4,
+                                         IOAddress("192.0.2.100")));
+
+    // The cache doesn't know that the lease has been removed, but the
+    // address is found when the addresses are checked in the database.
+    ASSERT_TRUE(LeaseMgrFactory::instance().deleteLease(IOAddress("192.0.2.100")));
+    AllocEngine::ClientContext4 ctx2(subnet_, clientid2_, hwaddr2_,
+                                     IOAddress("0.0.0.0"), false, false,
+                                     "", false);
+    ctx2.query_.reset(new Pkt4(DHCPREQUEST, 1234));
+    lease = engine.allocateLease4(ctx2);
+    ASSERT_TRUE(lease);
+    EXPECT_EQ("192.0.2.100", lease->addr_.toText());
+
+    // The summary of the pool has been dropped, because it missed the
+    // free address.
+    EXPECT_EQ(0, cache->getPoolLeasesNum(Lease::TYPE_V4,
+                                         IOAddress("192.0.2.100")));
+
+    // The pool is exhausted now. The summary loaded for the next client is
+    // retained after all addresses have been checked in the database, so
+    // as it isn't loaded again for each client.
+    HWAddrPtr hwaddr3(new HWAddr(std::vector<uint8_t>(6, 0x55), HTYPE_ETHER));
+    AllocEngine::ClientContext4 ctx3(subnet_, ClientIdPtr(), hwaddr3,
+                                     IOAddress("0.0.0.0"), false, false,
+                                     "", false);
+    ctx3.query_.reset(new Pkt4(DHCPREQUEST, 1234));
+    EXPECT_FALSE(engine.allocateLease4(ctx3));
+    EXPECT_EQ(10, cache->getPoolLeasesNum(Lease::TYPE_V4,
+                                          IOAddress("192.0.2.100")));
+
+    // The pool is not checked in the database again for the next clients.
+    EXPECT_TRUE(cache->isExhausted(subnet_->getID(), Lease::TYPE_V4));
+
+    // Until a lease is released.
+    ASSERT_TRUE(LeaseMgrFactory::instance().deleteLease(IOAddress("192.0.2.105")));
+    engine.invalidateLeaseLookupCache(Lease::TYPE_V4, IOAddress("192.0.2.105"));
+    EXPECT_FALSE(cache->isExhausted(subnet_->getID(), Lease::TYPE_V4));
+    lease = engine.allocateLease4(ctx3);
+    ASSERT_TRUE(lease);
+    EXPECT_EQ("192.0.2.105", lease->addr_.toText());
+}
+
+// This test verifies that the address which the lease lookup cache reports
+// free is looked up in the lease database before it is offered, so as the
+// lease created for it since the cache was loaded is reused when it has
+// expired.
+TEST_F(AllocEngine4Test, leaseLookupCacheStaleFree) {
+    AllocEngine engine(AllocEngine::ALLOC_ITERATIVE, 0, false);
+    LeaseLookupCachePtr cache(new LeaseLookupCache());
+    engine.setLeaseLookupCache(cache, true);
+
+    AllocEngine::ClientContext4 ctx(subnet_, clientid_, hwaddr_,
+                                    IOAddress("0.0.0.0"), false, false,
+                                    "", false);
+    ctx.query_.reset(new Pkt4(DHCPREQUEST, 1234));
+    Lease4Ptr lease = engine.allocateLease4(ctx);
+    ASSERT_TRUE(lease);
+    EXPECT_EQ("192.0.2.100", lease->addr_.toText());
+
+    // Add the expired lease for the next address behind the back of the
+    // cache.
+    HWAddrPtr other_hwaddr(new HWAddr(std::vector<uint8_t>(6, 0x77),
+                                      HTYPE_ETHER));
+    Lease4Ptr other_lease(new Lease4(IOAddress("192.0.2.101"), other_hwaddr,
+                                     0, 0, 500, 100, 200, time(NULL) - 1000,
+                                     subnet_->getID()));
+    ASSERT_TRUE(LeaseMgrFactory::instance().addLease(other_lease));
+    ASSERT_EQ(LeaseLookupCache::FREE,
+              cache->getStatus(LeaseMgrFactory::instance(), subnet_,
+                               Lease::TYPE_V4, IOAddress("192.0.2.101")));
+
+    AllocEngine::ClientContext4 ctx2(subnet_, clientid2_, hwaddr2_,
+                                     IOAddress("0.0.0.0"), false, false,
+                                     "", true);
+    ctx2.query_.reset(new Pkt4(DHCPDISCOVER, 1234));
+    lease = engine.allocateLease4(ctx2);
+    ASSERT_TRUE(lease);
+    EXPECT_EQ("192.0.2.101", lease->addr_.toText());
+    ASSERT_TRUE(ctx2.old_lease_);
+    EXPECT_TRUE(*ctx2.old_lease_->hwaddr_ == *other_hwaddr);
+}
+
 }; // namespace test
 }; // namespace dhcp
 }; // namespace isc
@@ -71,6 +71,36 @@ TEST(CfgDbAccessTest, createLeaseMgr) {
     });
 }
 
+// Tests that the lease manager instance is preserved when the lease
+// database access string is unchanged and is recreated otherwise.
+TEST(CfgDbAccessTest, reuseLeaseMgr) {
+    CfgDbAccess cfg;
+    ASSERT_NO_THROW(cfg.setLeaseDbAccessString("type=memfile persist=false universe=4"));
+    ASSERT_NO_THROW(cfg.createManagers());
+    LeaseMgr* lease_mgr = &LeaseMgrFactory::instance();
+    EXPECT_EQ("type=memfile persist=false universe=4",
+              LeaseMgrFactory::getDbAccessString());
+
+    // Creating managers with the same access string should preserve
+    // the existing instance.
+    CfgDbAccess cfg_same;
+    ASSERT_NO_THROW(cfg_same.setLeaseDbAccessString("type=memfile persist=false universe=4"));
+    ASSERT_NO_THROW(cfg_same.createManagers());
+    EXPECT_TRUE(lease_mgr == &LeaseMgrFactory::instance());
+
+    // Different access string should cause the lease manager to be
+    // recreated.
+    CfgDbAccess cfg_other;
+    ASSERT_NO_THROW(cfg_other.setLeaseDbAccessString("type=memfile persist=false universe=6"));
+    ASSERT_NO_THROW(cfg_other.createManagers());
+    EXPECT_EQ("type=memfile persist=false universe=6",
+              LeaseMgrFactory::getDbAccessString());
+    EXPECT_EQ("memfile", LeaseMgrFactory::instance().getType());
+
+    LeaseMgrFactory::destroy();
+    EXPECT_TRUE(LeaseMgrFactory::getDbAccessString().empty());
+}
+
 // The following tests require MySQL enabled.
 #if defined HAVE_MYSQL
 
@@ -1,4 +1,4 @@
-// Copyright (C) 2015 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -111,6 +111,7 @@ TEST(CfgExpirationTest, defaults) {
               cfg.getMaxReclaimTime());
     EXPECT_EQ(CfgExpiration::DEFAULT_UNWARNED_RECLAIM_CYCLES,
               cfg.getUnwarnedReclaimCycles());
+    EXPECT_FALSE(cfg.getReclaimThread());
 }
 
 // Test the {get,set}ReclaimTimerWaitTime.
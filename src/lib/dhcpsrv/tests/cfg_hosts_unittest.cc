@@ -1,4 +1,4 @@
-// Copyright (C) 2014-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2014-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -200,6 +200,25 @@ TEST_F(CfgHostsTest, getAllRepeatingHosts) {
     }
 }
 
+// This test checks that the hosts having the same identifier are returned
+// in the order of subnet identifiers, regardless of the order in which they
+// have been added.
+TEST_F(CfgHostsTest, getAllOrderedBySubnetId) {
+    CfgHosts cfg;
+    const SubnetID subnet_ids[] = { 3, 1, 2 };
+    for (int i = 0; i < 3; ++i) {
+        cfg.add(HostPtr(new Host(hwaddrs_[0]->toText(false), "hw-address",
+                                 subnet_ids[i], SubnetID(0),
+                                 IOAddress::IPV4_ZERO_ADDRESS())));
+    }
+
+    HostCollection hosts = cfg.getAll(hwaddrs_[0]);
+    ASSERT_EQ(3, hosts.size());
+    EXPECT_EQ(1, hosts[0]->getIPv4SubnetID());
+    EXPECT_EQ(2, hosts[1]->getIPv4SubnetID());
+    EXPECT_EQ(3, hosts[2]->getIPv4SubnetID());
+}
+
 // This test checks that all reservations for the specified IPv4 address can
 // be retrieved.
 TEST_F(CfgHostsTest, getAll4ByAddress) {
@@ -229,6 +248,42 @@ TEST_F(CfgHostsTest, getAll4ByAddress) {
     EXPECT_EQ(25, *subnet_ids.rbegin());
 }
 
+// This test checks that all reservations for the specified IPv4 and IPv6
+// subnet can be retrieved.
+TEST_F(CfgHostsTest, getAllBySubnetId) {
+    CfgHosts cfg;
+    // Add hosts.
+    for (int i = 0; i < 25; ++i) {
+        // Add host identified by the HW address.
+        cfg.add(HostPtr(new Host(hwaddrs_[i]->toText(false),
+                                 "hw-address",
+                                 SubnetID(1 + i % 2), SubnetID(10 + i % 3),
+                                 increase(IOAddress("192.0.2.5"), i))));
+    }
+
+    // Subnet 1 holds hosts with even indexes.
+    HostCollection hosts = cfg.getAll4(SubnetID(1));
+    ASSERT_EQ(13, hosts.size());
+    for (HostCollection::const_iterator host = hosts.begin(); host != hosts.end();
+         ++host) {
+        EXPECT_EQ(1, (*host)->getIPv4SubnetID());
+    }
+    EXPECT_EQ(12, cfg.getAll4(SubnetID(2)).size());
+    EXPECT_TRUE(cfg.getAll4(SubnetID(3)).empty());
+
+    // The same for the IPv6 subnets.
+    const CfgHosts& const_cfg = cfg;
+    ConstHostCollection const_hosts = const_cfg.getAll6(SubnetID(10));
+    ASSERT_EQ(9, const_hosts.size());
+    for (ConstHostCollection::const_iterator host = const_hosts.begin();
+         host != const_hosts.end(); ++host) {
+        EXPECT_EQ(10, (*host)->getIPv6SubnetID());
+    }
+    EXPECT_EQ(8, const_cfg.getAll6(SubnetID(11)).size());
+    EXPECT_EQ(8, const_cfg.getAll6(SubnetID(12)).size());
+    EXPECT_TRUE(const_cfg.getAll6(SubnetID(1)).empty());
+}
+
 // This test checks that the reservations can be retrieved for the particular
 // host connected to the specific IPv4 subnet (by subnet id).
 TEST_F(CfgHostsTest, get4) {
@@ -453,6 +508,102 @@ TEST_F(CfgHostsTest, add6Invalid2Hosts) {
     EXPECT_THROW(cfg.add(host2), isc::dhcp::DuplicateHost);
 }
 
+// Checks that a host with a failing IPv6 reservation is not partially
+// added to the configuration.
+TEST_F(CfgHostsTest, add6Rollback) {
+    CfgHosts cfg;
+
+    HostPtr host1 = HostPtr(new Host(duids_[0]->toText(), "duid",
+                                     SubnetID(0), SubnetID(1),
+                                     IOAddress("0.0.0.0")));
+    host1->addReservation(IPv6Resrv(IPv6Resrv::TYPE_NA,
+                                    IOAddress("2001:db8::1")));
+    ASSERT_NO_THROW(cfg.add(host1));
+
+    // The second reservation of this host conflicts with the first host.
+    HostPtr host2 = HostPtr(new Host(duids_[1]->toText(), "duid",
+                                     SubnetID(0), SubnetID(1),
+                                     IOAddress("0.0.0.0")));
+    host2->addReservation(IPv6Resrv(IPv6Resrv::TYPE_NA,
+                                    IOAddress("2001:db8::")));
+    host2->addReservation(IPv6Resrv(IPv6Resrv::TYPE_NA,
+                                    IOAddress("2001:db8::1")));
+    ASSERT_THROW(cfg.add(host2), isc::dhcp::DuplicateHost);
+
+    // Nothing should be left of the second host.
+    EXPECT_FALSE(cfg.get6(SubnetID(1), Host::IDENT_DUID,
+                          &duids_[1]->getDuid()[0],
+                          duids_[1]->getDuid().size()));
+    EXPECT_FALSE(cfg.get6(SubnetID(1), IOAddress("2001:db8::")));
+    EXPECT_EQ(host1, cfg.get6(SubnetID(1), IOAddress("2001:db8::1")));
+}
+
+// Checks that IPv4 reservations can be deleted.
+TEST_F(CfgHostsTest, del4) {
+    CfgHosts cfg;
+
+    for (unsigned i = 0; i < 3; ++i) {
+        cfg.add(HostPtr(new Host(hwaddrs_[i]->toText(false), "hw-address",
+                                 SubnetID(1), SubnetID(0), addressesa_[i])));
+    }
+
+    // Delete by address.
+    EXPECT_TRUE(cfg.del(SubnetID(1), addressesa_[0]));
+    EXPECT_FALSE(cfg.get4(SubnetID(1), addressesa_[0]));
+    EXPECT_FALSE(cfg.get4(SubnetID(1), hwaddrs_[0]));
+    EXPECT_FALSE(cfg.del(SubnetID(1), addressesa_[0]));
+
+    // The subnet must match.
+    EXPECT_FALSE(cfg.del(SubnetID(2), addressesa_[1]));
+
+    // Delete by identifier.
+    EXPECT_TRUE(cfg.del4(SubnetID(1), Host::IDENT_HWADDR,
+                         &hwaddrs_[1]->hwaddr_[0], hwaddrs_[1]->hwaddr_.size()));
+    EXPECT_FALSE(cfg.get4(SubnetID(1), addressesa_[1]));
+    EXPECT_FALSE(cfg.del4(SubnetID(1), Host::IDENT_HWADDR,
+                          &hwaddrs_[1]->hwaddr_[0], hwaddrs_[1]->hwaddr_.size()));
+
+    // The remaining host is intact.
+    EXPECT_TRUE(cfg.get4(SubnetID(1), addressesa_[2]));
+    EXPECT_EQ(1, cfg.getAll4(SubnetID(1)).size());
+
+    // The deleted host can be added again.
+    EXPECT_NO_THROW(cfg.add(HostPtr(new Host(hwaddrs_[0]->toText(false),
+                                             "hw-address", SubnetID(1),
+                                             SubnetID(0), addressesa_[0]))));
+}
+
+// Checks that IPv6 reservations can be deleted.
+TEST_F(CfgHostsTest, del6) {
+    CfgHosts cfg;
+
+    HostPtr host = HostPtr(new Host(duids_[0]->toText(), "duid",
+                                    SubnetID(0), SubnetID(1),
+                                    IOAddress("0.0.0.0")));
+    host->addReservation(IPv6Resrv(IPv6Resrv::TYPE_NA,
+                                   IOAddress("2001:db8::1")));
+    host->addReservation(IPv6Resrv(IPv6Resrv::TYPE_PD,
+                                   IOAddress("3000::"), 64));
+    ASSERT_NO_THROW(cfg.add(host));
+
+    EXPECT_FALSE(cfg.del6(SubnetID(2), Host::IDENT_DUID,
+                          &duids_[0]->getDuid()[0],
+                          duids_[0]->getDuid().size()));
+    EXPECT_TRUE(cfg.del6(SubnetID(1), Host::IDENT_DUID,
+                         &duids_[0]->getDuid()[0],
+                         duids_[0]->getDuid().size()));
+    EXPECT_FALSE(cfg.get6(SubnetID(1), IOAddress("2001:db8::1")));
+    EXPECT_FALSE(cfg.get6(IOAddress("3000::"), 64));
+
+    // Add the host again and delete it by prefix.
+    ASSERT_NO_THROW(cfg.add(host));
+    EXPECT_TRUE(cfg.del(SubnetID(1), IOAddress("3000::")));
+    EXPECT_FALSE(cfg.get6(SubnetID(1), Host::IDENT_DUID,
+                          &duids_[0]->getDuid()[0],
+                          duids_[0]->getDuid().size()));
+    EXPECT_FALSE(cfg.get6(SubnetID(1), IOAddress("2001:db8::1")));
+}
+
 // Check that error is reported when trying to add a host with subnet
 // ids equal to zero.
 TEST_F(CfgHostsTest, zeroSubnetIDs) {
@@ -1,4 +1,4 @@
-// Copyright (C) 2014-2015 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2014-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -389,6 +389,12 @@ TEST(CfgIfaceNoStubTest, useSocketType) {
     ASSERT_NO_THROW(cfg.openSockets(AF_INET, 10067, true));
     ASSERT_TRUE(IfaceMgr::instance().isDirectResponseSupported());
 
+    // Select raw sockets using memory mapped rings.
+    ASSERT_NO_THROW(cfg.useSocketType(AF_INET, "raw-mmap"));
+    EXPECT_EQ("raw-mmap", cfg.socketTypeToText());
+    ASSERT_NO_THROW(cfg.openSockets(AF_INET, 10067, true));
+    ASSERT_TRUE(IfaceMgr::instance().isDirectResponseSupported());
+
     // Test invalid values.
     EXPECT_THROW(cfg.useSocketType(AF_INET, "default"),
         InvalidSocketType);
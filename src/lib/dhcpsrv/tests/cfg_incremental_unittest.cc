@@ -0,0 +1,145 @@
+// Copyright (C) 2017 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <cc/data.h>
+#include <dhcpsrv/cfg_incremental.h>
+#include <gtest/gtest.h>
+
+using namespace isc;
+using namespace isc::data;
+using namespace isc::dhcp;
+
+namespace {
+
+/// @brief Names of the global parameters used in the tests.
+const ParamsList INHERITED = { "renew-timer", "valid-lifetime" };
+
+// This test verifies that the subnet identifier is only returned when
+// it has been explicitly specified.
+TEST(CfgIncrementalTest, getSubnetId) {
+    EXPECT_EQ(0, CfgIncremental::getSubnetId(ConstElementPtr()));
+    EXPECT_EQ(0, CfgIncremental::getSubnetId(Element::fromJSON("[ 1 ]")));
+    EXPECT_EQ(0, CfgIncremental::getSubnetId(Element::fromJSON(
+        "{ \"subnet\": \"192.0.2.0/24\" }")));
+    EXPECT_EQ(0, CfgIncremental::getSubnetId(Element::fromJSON(
+        "{ \"id\": 0 }")));
+    EXPECT_EQ(0, CfgIncremental::getSubnetId(Element::fromJSON(
+        "{ \"id\": \"5\" }")));
+    EXPECT_EQ(5, CfgIncremental::getSubnetId(Element::fromJSON(
+        "{ \"id\": 5 }")));
+}
+
+// This test verifies that the inherited global parameters are compared.
+TEST(CfgIncrementalTest, inheritedEquals) {
+    CfgIncremental cfg1;
+    CfgIncremental cfg2;
+
+    // Nothing has been remembered so there is nothing to compare.
+    EXPECT_FALSE(cfg1.inheritedEquals(cfg2));
+
+    ConstElementPtr global = Element::fromJSON(
+        "{ \"renew-timer\": 1000, \"valid-lifetime\": 4000,"
+        "  \"interfaces-config\": { } }");
+    cfg1.setInheritedParameters(global, INHERITED);
+    EXPECT_FALSE(cfg1.inheritedEquals(cfg2));
+    EXPECT_FALSE(cfg2.inheritedEquals(cfg1));
+
+    // Parameters which aren't inherited should not matter.
+    global = Element::fromJSON(
+        "{ \"renew-timer\": 1000, \"valid-lifetime\": 4000 }");
+    cfg2.setInheritedParameters(global, INHERITED);
+    EXPECT_TRUE(cfg1.inheritedEquals(cfg2));
+    EXPECT_TRUE(cfg2.inheritedEquals(cfg1));
+
+    // Modification of the inherited parameter should be detected.
+    global = Element::fromJSON(
+        "{ \"renew-timer\": 1001, \"valid-lifetime\": 4000 }");
+    cfg2.setInheritedParameters(global, INHERITED);
+    EXPECT_FALSE(cfg1.inheritedEquals(cfg2));
+}
+
+// This test verifies that the subnet configurations are remembered and
+// compared with and without reservations.
+TEST(CfgIncrementalTest, subnetEquals) {
+    CfgIncremental cfg;
+
+    // Subnet without an identifier is not remembered.
+    ConstElementPtr subnet = Element::fromJSON(
+        "{ \"subnet\": \"192.0.2.0/24\" }");
+    cfg.addSubnet(subnet);
+    EXPECT_EQ(0, cfg.getSubnetsCount());
+    EXPECT_FALSE(cfg.subnetEquals(subnet));
+    EXPECT_FALSE(cfg.reservationsEqual(subnet));
+
+    subnet = Element::fromJSON(
+        "{ \"id\": 1, \"subnet\": \"192.0.2.0/24\","
+        "  \"reservations\": [ { \"hw-address\": \"01:02:03:04:05:06\" } ] }");
+    cfg.addSubnet(subnet);
+    cfg.addSubnet(Element::fromJSON(
+        "{ \"id\": 2, \"subnet\": \"10.0.0.0/8\" }"));
+    EXPECT_EQ(2, cfg.getSubnetsCount());
+
+    // The same configuration.
+    EXPECT_TRUE(cfg.subnetEquals(subnet));
+    EXPECT_TRUE(cfg.reservationsEqual(subnet));
+
+    // Modified reservations.
+    subnet = Element::fromJSON(
+        "{ \"id\": 1, \"subnet\": \"192.0.2.0/24\","
+        "  \"reservations\": [ { \"hw-address\": \"01:02:03:04:05:07\" } ] }");
+    EXPECT_TRUE(cfg.subnetEquals(subnet));
+    EXPECT_FALSE(cfg.reservationsEqual(subnet));
+
+    // Removed reservations.
+    subnet = Element::fromJSON(
+        "{ \"id\": 1, \"subnet\": \"192.0.2.0/24\" }");
+    EXPECT_TRUE(cfg.subnetEquals(subnet));
+    EXPECT_FALSE(cfg.reservationsEqual(subnet));
+
+    // Modified subnet parameter.
+    subnet = Element::fromJSON(
+        "{ \"id\": 1, \"subnet\": \"192.0.3.0/24\","
+        "  \"reservations\": [ { \"hw-address\": \"01:02:03:04:05:06\" } ] }");
+    EXPECT_FALSE(cfg.subnetEquals(subnet));
+    EXPECT_TRUE(cfg.reservationsEqual(subnet));
+
+    // Added subnet parameter.
+    subnet = Element::fromJSON(
+        "{ \"id\": 2, \"subnet\": \"10.0.0.0/8\", \"renew-timer\": 10 }");
+    EXPECT_FALSE(cfg.subnetEquals(subnet));
+    EXPECT_TRUE(cfg.reservationsEqual(subnet));
+
+    // Unknown subnet.
+    subnet = Element::fromJSON(
+        "{ \"id\": 3, \"subnet\": \"10.0.0.0/8\" }");
+    EXPECT_FALSE(cfg.subnetEquals(subnet));
+    EXPECT_FALSE(cfg.reservationsEqual(subnet));
+}
+
+// This test verifies that the remembered subnet configuration can be
+// discarded.
+TEST(CfgIncrementalTest, removeSubnet) {
+    CfgIncremental cfg;
+
+    ConstElementPtr subnet = Element::fromJSON(
+        "{ \"id\": 1, \"subnet\": \"192.0.2.0/24\" }");
+    cfg.addSubnet(subnet);
+    cfg.addSubnet(Element::fromJSON(
+        "{ \"id\": 2, \"subnet\": \"10.0.0.0/8\" }"));
+    ASSERT_TRUE(cfg.subnetEquals(subnet));
+
+    cfg.removeSubnet(1);
+    EXPECT_EQ(1, cfg.getSubnetsCount());
+    EXPECT_FALSE(cfg.subnetEquals(subnet));
+    EXPECT_FALSE(cfg.reservationsEqual(subnet));
+
+    // Removing non-existing subnet is a no-op.
+    EXPECT_NO_THROW(cfg.removeSubnet(3));
+    EXPECT_EQ(1, cfg.getSubnetsCount());
+}
+
+} // end of anonymous namespace
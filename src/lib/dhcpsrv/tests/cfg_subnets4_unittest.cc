@@ -1,4 +1,4 @@
-// Copyright (C) 2014-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2014-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -21,6 +21,23 @@ using namespace isc::dhcp::test;
 
 namespace {
 
+// This test verifies that the subnet can be retrieved by its identifier.
+TEST(CfgSubnets4Test, getBySubnetId) {
+    CfgSubnets4 cfg;
+
+    Subnet4Ptr subnet1(new Subnet4(IOAddress("192.0.2.0"), 26, 1, 2, 3, 5));
+    Subnet4Ptr subnet2(new Subnet4(IOAddress("192.0.2.64"), 26, 1, 2, 3, 8));
+
+    EXPECT_FALSE(cfg.getBySubnetId(5));
+
+    cfg.add(subnet1);
+    cfg.add(subnet2);
+
+    EXPECT_EQ(subnet1, cfg.getBySubnetId(5));
+    EXPECT_EQ(subnet2, cfg.getBySubnetId(8));
+    EXPECT_FALSE(cfg.getBySubnetId(6));
+}
+
 // This test verifies that it is possible to retrieve a subnet using an
 // IP address.
 TEST(CfgSubnets4Test, selectSubnetByCiaddr) {
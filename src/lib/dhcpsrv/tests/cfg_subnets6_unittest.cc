@@ -1,4 +1,4 @@
-// Copyright (C) 2014-2015 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2014-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -30,6 +30,23 @@ generateInterfaceId(const std::string& text) {
     return OptionPtr(new Option(Option::V6, D6O_INTERFACE_ID, buffer));
 }
 
+// This test verifies that the subnet can be retrieved by its identifier.
+TEST(CfgSubnets6Test, getBySubnetId) {
+    CfgSubnets6 cfg;
+
+    Subnet6Ptr subnet1(new Subnet6(IOAddress("2001:db8:1::"), 48, 1, 2, 3, 4, 5));
+    Subnet6Ptr subnet2(new Subnet6(IOAddress("2001:db8:2::"), 48, 1, 2, 3, 4, 8));
+
+    EXPECT_FALSE(cfg.getBySubnetId(5));
+
+    cfg.add(subnet1);
+    cfg.add(subnet2);
+
+    EXPECT_EQ(subnet1, cfg.getBySubnetId(5));
+    EXPECT_EQ(subnet2, cfg.getBySubnetId(8));
+    EXPECT_FALSE(cfg.getBySubnetId(6));
+}
+
 // This test checks that the subnet can be selected using a relay agent's
 // link address.
 TEST(CfgSubnets6Test, selectSubnetByRelayAddress) {
@@ -1,4 +1,4 @@
-// Copyright (C) 2015-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -9,20 +9,23 @@
 #include <dhcp/option_vendor.h>
 #include <dhcp/pkt6.h>
 #include <dhcp/tests/iface_mgr_test_config.h>
-#include <dhcp/option6_addrlst.h>
-#include <dhcp/option_string.h>
 #include <dhcp/option_vendor.h>
 #include <dhcpsrv/dhcp4o6_ipc.h>
 #include <dhcpsrv/testutils/dhcp4o6_test_ipc.h>
+#include <stats/stats_mgr.h>
 #include <boost/bind.hpp>
 #include <boost/function.hpp>
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <sstream>
 #include <string>
+#include <sys/select.h>
+#include <vector>
 
 using namespace isc::asiolink;
 using namespace isc::dhcp;
 using namespace isc::dhcp::test;
+using namespace isc::stats;
 using namespace isc::util;
 
 namespace {
@@ -130,10 +133,21 @@ protected:
                          TestIpc::EndpointType dest,
                          const CreateMsgFun& create_msg_fun);
 
+    /// @brief Creates the wire format of the IPC message.
+    ///
+    /// The IPC message comprises the IPC message header and the packed
+    /// DHCPv4-query DHCPv6 message.
+    ///
+    /// @param version Version of the header.
+    /// @param ifname Name of the interface.
+    /// @return Buffer holding the IPC message.
+    static std::vector<uint8_t> createIpcMessage(uint8_t version,
+                                                 const std::string& ifname);
+
     /// @brief Tests that error is reported when invalid message is received.
     ///
-    /// @param pkt Pointer to the invalid message.
-    void testReceiveError(const Pkt6Ptr& pkt);
+    /// @param data Buffer holding the invalid IPC message.
+    void testReceiveError(const std::vector<uint8_t>& data);
 
 private:
 
@@ -309,8 +323,30 @@ Dhcp4o6IpcBaseTest::testSendReceive(uint16_t iterations_num,
     }
 }
 
+std::vector<uint8_t>
+Dhcp4o6IpcBaseTest::createIpcMessage(uint8_t version,
+                                     const std::string& ifname) {
+    // Create the DHCPv4o6 message.
+    Pkt6Ptr pkt(new Pkt6(DHCPV6_DHCPV4_QUERY, 0));
+    pkt->addOption(createDHCPv4MsgOption(TestIpc::ENDPOINT_TYPE_V6));
+    pkt->pack();
+    const uint8_t* msg = static_cast<const uint8_t*>(pkt->getBuffer().getData());
+
+    // Create the header.
+    std::vector<uint8_t> data(TestIpc::HEADER_SIZE, 0);
+    data[0] = version;
+    data[1] = static_cast<uint8_t>(ifname.size());
+    const std::vector<uint8_t> addr = IOAddress("2001:db8:1::1").toBytes();
+    std::copy(addr.begin(), addr.end(), data.begin() + 4);
+    data.insert(data.end(), ifname.begin(), ifname.end());
+
+    // Append the DHCPv4o6 message.
+    data.insert(data.end(), msg, msg + pkt->getBuffer().getLength());
+    return (data);
+}
+
 void
-Dhcp4o6IpcBaseTest::testReceiveError(const Pkt6Ptr& pkt) {
+Dhcp4o6IpcBaseTest::testReceiveError(const std::vector<uint8_t>& data) {
     TestIpc ipc_src(TEST_PORT, TestIpc::ENDPOINT_TYPE_V6);
     TestIpc ipc_dest(TEST_PORT, TestIpc::ENDPOINT_TYPE_V4);
 
@@ -318,16 +354,7 @@ Dhcp4o6IpcBaseTest::testReceiveError(const Pkt6Ptr& pkt) {
     ASSERT_NO_THROW(ipc_src.open());
     ASSERT_NO_THROW(ipc_dest.open());
 
-    pkt->setIface("eth0");
-    pkt->setRemoteAddr(IOAddress("2001:db8:1::1"));
-    pkt->addOption(createDHCPv4MsgOption(TestIpc::ENDPOINT_TYPE_V6));
-
-    OutputBuffer& buf = pkt->getBuffer();
-    buf.clear();
-    ASSERT_NO_THROW(pkt->pack());
-
-    ASSERT_NE(-1, ::send(ipc_src.getSocketFd(), buf.getData(),
-                         buf.getLength(), 0));
+    ASSERT_NE(-1, ::send(ipc_src.getSocketFd(), &data[0], data.size(), 0));
 
     // Call receive with a timeout. The data should appear on the socket
     // within this time.
@@ -442,77 +469,136 @@ TEST_F(Dhcp4o6IpcBaseTest, openError) {
     EXPECT_EQ(TEST_PORT + 10, ipc.getPort());
 }
 
-// This test verifies that receiving packet over the IPC fails when there
-// is no vendor option present.
-TEST_F(Dhcp4o6IpcBaseTest, receiveWithoutVendorOption) {
-    Pkt6Ptr pkt(new Pkt6(DHCPV6_DHCPV4_QUERY, 0));
-    testReceiveError(pkt);
+// This test verifies that the message sent in the IPC message built by
+// the test is received, so the tests below check the right thing.
+TEST_F(Dhcp4o6IpcBaseTest, receiveIpcMessage) {
+    TestIpc ipc_src(TEST_PORT, TestIpc::ENDPOINT_TYPE_V6);
+    TestIpc ipc_dest(TEST_PORT, TestIpc::ENDPOINT_TYPE_V4);
+    ASSERT_NO_THROW(ipc_src.open());
+    ASSERT_NO_THROW(ipc_dest.open());
+
+    std::vector<uint8_t> data = createIpcMessage(TestIpc::HEADER_VERSION,
+                                                 "eth0");
+    ASSERT_NE(-1, ::send(ipc_src.getSocketFd(), &data[0], data.size(), 0));
+    ASSERT_NO_THROW(IfaceMgr::instance().receive6(1, 0));
+
+    Pkt6Ptr pkt_received = ipc_dest.popPktReceived();
+    ASSERT_TRUE(pkt_received);
+    EXPECT_EQ(DHCPV6_DHCPV4_QUERY, pkt_received->getType());
+    EXPECT_EQ("eth0", pkt_received->getIface());
+    EXPECT_EQ("2001:db8:1::1", pkt_received->getRemoteAddr().toText());
+    EXPECT_TRUE(pkt_received->getOption(D6O_DHCPV4_MSG));
 }
 
-// This test verifies that receving packet over the IPC fails when the
-// enterprise ID carried in the vendor option is invalid.
-TEST_F(Dhcp4o6IpcBaseTest, receiveInvalidEnterpriseId) {
-    Pkt6Ptr pkt(new Pkt6(DHCPV6_DHCPV4_QUERY, 0));
-    OptionVendorPtr option_vendor(new OptionVendor(Option::V6, 1));
-    option_vendor->addOption(
-        OptionStringPtr(new OptionString(Option::V6, ISC_V6_4O6_INTERFACE,
-                                         "eth0")));
-    option_vendor->addOption(
-        Option6AddrLstPtr(new Option6AddrLst(ISC_V6_4O6_SRC_ADDRESS,
-                                             IOAddress("2001:db8:1::1")))
-    );
+// This test verifies that receiving packet over the IPC fails when the
+// header is truncated.
+TEST_F(Dhcp4o6IpcBaseTest, receiveTruncatedHeader) {
+    std::vector<uint8_t> data = createIpcMessage(TestIpc::HEADER_VERSION,
+                                                 "eth0");
+    data.resize(TestIpc::HEADER_SIZE - 1);
+    testReceiveError(data);
+}
 
-    pkt->addOption(option_vendor);
-    testReceiveError(pkt);
+// This test verifies that receiving packet over the IPC fails when the
+// header version is not supported.
+TEST_F(Dhcp4o6IpcBaseTest, receiveInvalidVersion) {
+    testReceiveError(createIpcMessage(TestIpc::HEADER_VERSION + 1, "eth0"));
 }
 
 // This test verifies that receiving packet over the IPC fails when the
-// interface option is not present.
-TEST_F(Dhcp4o6IpcBaseTest, receiveWithoutInterfaceOption) {
-    Pkt6Ptr pkt(new Pkt6(DHCPV6_DHCPV4_QUERY, 0));
-    OptionVendorPtr option_vendor(new OptionVendor(Option::V6,
-                                                   ENTERPRISE_ID_ISC));
-    option_vendor->addOption(
-        Option6AddrLstPtr(new Option6AddrLst(ISC_V6_4O6_SRC_ADDRESS,
-                                             IOAddress("2001:db8:1::1")))
-    );
+// interface name is not present.
+TEST_F(Dhcp4o6IpcBaseTest, receiveWithoutInterfaceName) {
+    testReceiveError(createIpcMessage(TestIpc::HEADER_VERSION, ""));
+}
 
-    pkt->addOption(option_vendor);
-    testReceiveError(pkt);
+// This test verifies that receiving packet over the IPC fails when the
+// interface name length exceeds the message.
+TEST_F(Dhcp4o6IpcBaseTest, receiveTruncatedInterfaceName) {
+    std::vector<uint8_t> data = createIpcMessage(TestIpc::HEADER_VERSION,
+                                                 "eth0");
+    data.resize(TestIpc::HEADER_SIZE + 2);
+    testReceiveError(data);
 }
 
 // This test verifies that receiving packet over the IPC fails when the
-// interface which name is carried in the option is not present in the
+// interface which name is carried in the header is not present in the
 // system.
 TEST_F(Dhcp4o6IpcBaseTest, receiveWithInvalidInterface) {
-    Pkt6Ptr pkt(new Pkt6(DHCPV6_DHCPV4_QUERY, 0));
-    OptionVendorPtr option_vendor(new OptionVendor(Option::V6,
-                                                   ENTERPRISE_ID_ISC));
-    option_vendor->addOption(
-        OptionStringPtr(new OptionString(Option::V6, ISC_V6_4O6_INTERFACE,
-                                         "ethX")));
-    option_vendor->addOption(
-        Option6AddrLstPtr(new Option6AddrLst(ISC_V6_4O6_SRC_ADDRESS,
-                                             IOAddress("2001:db8:1::1")))
-    );
+    testReceiveError(createIpcMessage(TestIpc::HEADER_VERSION, "ethX"));
+}
 
-    pkt->addOption(option_vendor);
-    testReceiveError(pkt);
+// This test verifies that receiving packet over the IPC fails when the
+// DHCPv6 message is truncated.
+TEST_F(Dhcp4o6IpcBaseTest, receiveTruncatedMessage) {
+    std::vector<uint8_t> data = createIpcMessage(TestIpc::HEADER_VERSION,
+                                                 "eth0");
+    data.resize(TestIpc::HEADER_SIZE + 4 + 2);
+    testReceiveError(data);
 }
 
+// This test verifies that receive returns null when there is no message
+// to receive.
+TEST_F(Dhcp4o6IpcBaseTest, receiveNothing) {
+    TestIpc ipc(TEST_PORT, TestIpc::ENDPOINT_TYPE_V4);
+    ASSERT_NO_THROW(ipc.open());
 
-// This test verifies that receving packet over the IPC fails when the
-// source address option is not present.
-TEST_F(Dhcp4o6IpcBaseTest, receiveWithoutSourceAddressOption) {
-    Pkt6Ptr pkt(new Pkt6(DHCPV6_DHCPV4_QUERY, 0));
-    OptionVendorPtr option_vendor(new OptionVendor(Option::V6,
-                                                   ENTERPRISE_ID_ISC));
-    option_vendor->addOption(
-        OptionStringPtr(new OptionString(Option::V6, ISC_V6_4O6_INTERFACE,
-                                         "eth0")));
+    Pkt6Ptr pkt;
+    ASSERT_NO_THROW(pkt = ipc.receive());
+    EXPECT_FALSE(pkt);
+}
 
-    pkt->addOption(option_vendor);
-    testReceiveError(pkt);
+// This test verifies that the messages queued on the socket can be
+// received one after another until the queue is drained.
+TEST_F(Dhcp4o6IpcBaseTest, receiveQueued) {
+    TestIpc ipc_src(TEST_PORT, TestIpc::ENDPOINT_TYPE_V6);
+    TestIpc ipc_dest(TEST_PORT, TestIpc::ENDPOINT_TYPE_V4);
+    ASSERT_NO_THROW(ipc_src.open());
+    ASSERT_NO_THROW(ipc_dest.open());
+
+    for (uint16_t i = 1; i <= TEST_ITERATIONS; ++i) {
+        ASSERT_NO_THROW(ipc_src.send(createDHCPv4o6Message(DHCPV6_DHCPV4_QUERY,
+                                                           i)));
+    }
+
+    // Wait for the messages.
+    fd_set sockets;
+    FD_ZERO(&sockets);
+    FD_SET(ipc_dest.getSocketFd(), &sockets);
+    struct timeval timeout = { 1, 0 };
+    ASSERT_EQ(1, select(ipc_dest.getSocketFd() + 1, &sockets, NULL, NULL,
+                        &timeout));
+
+    for (uint16_t i = 1; i <= TEST_ITERATIONS; ++i) {
+        Pkt6Ptr pkt;
+        ASSERT_NO_THROW(pkt = ipc_dest.receive());
+        ASSERT_TRUE(pkt) << "no message for iteration " << i;
+        EXPECT_EQ(concatenate("2001:db8:1::", i), pkt->getRemoteAddr().toText());
+    }
+
+    Pkt6Ptr pkt;
+    ASSERT_NO_THROW(pkt = ipc_dest.receive());
+    EXPECT_FALSE(pkt);
+}
+
+// This test verifies that the IPC statistics are updated.
+TEST_F(Dhcp4o6IpcBaseTest, statistics) {
+    StatsMgr& mgr = StatsMgr::instance();
+    mgr.removeAll();
+
+    testSendReceive(TEST_ITERATIONS, TestIpc::ENDPOINT_TYPE_V6,
+                    TestIpc::ENDPOINT_TYPE_V4, &createDHCPv4o6Message);
+
+    ObservationPtr sent = mgr.getObservation("dhcp4o6-ipc-sent");
+    ObservationPtr received = mgr.getObservation("dhcp4o6-ipc-received");
+    ObservationPtr latency = mgr.getObservation("dhcp4o6-ipc-latency");
+    ASSERT_TRUE(sent);
+    ASSERT_TRUE(received);
+    ASSERT_TRUE(latency);
+    EXPECT_EQ(TEST_ITERATIONS, sent->getInteger().first);
+    EXPECT_EQ(TEST_ITERATIONS, received->getInteger().first);
+    EXPECT_FALSE(latency->getDuration().first.is_negative());
+
+    mgr.removeAll();
 }
 
 // This test verifies that send method throws exception when the packet
@@ -258,4 +258,19 @@ TEST_F(ExpirationConfigParserTest, notNumberValue) {
     EXPECT_THROW(parser.parse(config_element), DhcpConfigError);
 }
 
+// This test verifies that the reclamation in the background thread can
+// be enabled and that the value must be a boolean.
+TEST_F(ExpirationConfigParserTest, reclaimThread) {
+    CfgExpirationPtr cfg = CfgMgr::instance().getStagingCfg()->getCfgExpiration();
+    ASSERT_FALSE(cfg->getReclaimThread());
+
+    ElementPtr config_element = Element::fromJSON("{ \"reclaim-thread\": true }");
+    ExpirationConfigParser parser;
+    ASSERT_NO_THROW(parser.parse(config_element));
+    EXPECT_TRUE(cfg->getReclaimThread());
+
+    config_element = Element::fromJSON("{ \"reclaim-thread\": 1 }");
+    EXPECT_THROW(parser.parse(config_element), DhcpConfigError);
+}
+
 } // end of anonymous namespace
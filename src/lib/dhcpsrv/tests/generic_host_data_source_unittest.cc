@@ -1,4 +1,4 @@
-// Copyright (C) 2015-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -1463,6 +1463,85 @@ GenericHostDataSourceTest::testMessageFields4() {
     ASSERT_NO_FATAL_FAILURE(compareHosts(host, from_hds));
 }
 
+void
+GenericHostDataSourceTest::testDeleteByAddr4() {
+    // Make sure we have a pointer to the host data source.
+    ASSERT_TRUE(hdsptr_);
+
+    HostPtr host1 = initializeHost4("192.0.2.1", Host::IDENT_HWADDR);
+    HostPtr host2 = initializeHost4("192.0.2.2", Host::IDENT_HWADDR);
+    ASSERT_NO_THROW(hdsptr_->add(host1));
+    ASSERT_NO_THROW(hdsptr_->add(host2));
+
+    SubnetID subnet_id = host1->getIPv4SubnetID();
+    ASSERT_TRUE(hdsptr_->get4(subnet_id, IOAddress("192.0.2.1")));
+
+    // Delete the first host and make sure the second is intact.
+    EXPECT_TRUE(hdsptr_->del(subnet_id, IOAddress("192.0.2.1")));
+    EXPECT_FALSE(hdsptr_->get4(subnet_id, IOAddress("192.0.2.1")));
+    EXPECT_TRUE(hdsptr_->get4(host2->getIPv4SubnetID(), IOAddress("192.0.2.2")));
+
+    // Second attempt should return false.
+    EXPECT_FALSE(hdsptr_->del(subnet_id, IOAddress("192.0.2.1")));
+}
+
+void
+GenericHostDataSourceTest::testDeleteById4() {
+    // Make sure we have a pointer to the host data source.
+    ASSERT_TRUE(hdsptr_);
+
+    HostPtr host = initializeHost4("192.0.2.1", Host::IDENT_DUID);
+    ASSERT_NO_THROW(addTestOptions(host, false, DHCP4_ONLY));
+    ASSERT_NO_THROW(hdsptr_->add(host));
+
+    SubnetID subnet_id = host->getIPv4SubnetID();
+    const std::vector<uint8_t>& id = host->getIdentifier();
+
+    EXPECT_TRUE(hdsptr_->del4(subnet_id, host->getIdentifierType(),
+                              &id[0], id.size()));
+    EXPECT_FALSE(hdsptr_->get4(subnet_id, host->getIdentifierType(),
+                               &id[0], id.size()));
+    EXPECT_FALSE(hdsptr_->del4(subnet_id, host->getIdentifierType(),
+                               &id[0], id.size()));
+
+    // The host can be added again, which means that no options have
+    // been left behind.
+    ASSERT_NO_THROW(hdsptr_->add(host));
+    ConstHostPtr from_hds = hdsptr_->get4(subnet_id, host->getIdentifierType(),
+                                          &id[0], id.size());
+    ASSERT_TRUE(from_hds);
+    ASSERT_NO_FATAL_FAILURE(compareHosts(host, from_hds));
+}
+
+void
+GenericHostDataSourceTest::testDeleteById6() {
+    // Make sure we have a pointer to the host data source.
+    ASSERT_TRUE(hdsptr_);
+
+    HostPtr host = initializeHost6("2001:db8::1", Host::IDENT_DUID, false);
+    ASSERT_NO_THROW(addTestOptions(host, false, DHCP6_ONLY));
+    ASSERT_NO_THROW(hdsptr_->add(host));
+
+    SubnetID subnet_id = host->getIPv6SubnetID();
+    const std::vector<uint8_t>& id = host->getIdentifier();
+
+    EXPECT_TRUE(hdsptr_->del6(subnet_id, host->getIdentifierType(),
+                              &id[0], id.size()));
+    EXPECT_FALSE(hdsptr_->get6(subnet_id, host->getIdentifierType(),
+                               &id[0], id.size()));
+    EXPECT_FALSE(hdsptr_->get6(subnet_id, IOAddress("2001:db8::1")));
+    EXPECT_FALSE(hdsptr_->del6(subnet_id, host->getIdentifierType(),
+                               &id[0], id.size()));
+
+    // The host can be added again, which means that no reservations or
+    // options have been left behind.
+    ASSERT_NO_THROW(hdsptr_->add(host));
+    ConstHostPtr from_hds = hdsptr_->get6(subnet_id, host->getIdentifierType(),
+                                          &id[0], id.size());
+    ASSERT_TRUE(from_hds);
+    ASSERT_NO_FATAL_FAILURE(compareHosts(host, from_hds));
+}
+
 }; // namespace test
 }; // namespace dhcp
 }; // namespace isc
@@ -1,4 +1,4 @@
-// Copyright (C) 2015-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -525,6 +525,24 @@ public:
     ///
     void testMessageFields4();
 
+    /// @brief Tests that the IPv4 host can be deleted by subnet id and
+    /// the reserved address.
+    ///
+    /// Uses gtest macros to report failures.
+    void testDeleteByAddr4();
+
+    /// @brief Tests that the IPv4 host, along with its options, can be
+    /// deleted by subnet id and the identifier.
+    ///
+    /// Uses gtest macros to report failures.
+    void testDeleteById4();
+
+    /// @brief Tests that the IPv6 host, along with its reservations and
+    /// options, can be deleted by subnet id and the identifier.
+    ///
+    /// Uses gtest macros to report failures.
+    void testDeleteById6();
+
     /// @brief Returns DUID with identical content as specified HW address
     ///
     /// This method does not have any sense in real life and is only useful
@@ -1,4 +1,4 @@
-// Copyright (C) 2014-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2014-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -17,6 +17,7 @@
 
 #include <gtest/gtest.h>
 
+#include <set>
 #include <sstream>
 
 using namespace std;
@@ -1653,6 +1654,75 @@ GenericLeaseMgrTest::testVersion(int major, int minor) {
     EXPECT_EQ(minor, lmptr_->getVersion().second);
 }
 
+void
+GenericLeaseMgrTest::testGetLeases4Paged() {
+    // Get the leases to be used for the test and add them to the database.
+    vector<Lease4Ptr> leases = createLeases4();
+    for (size_t i = 0; i < leases.size(); ++i) {
+        ASSERT_TRUE(lmptr_->addLease(leases[i]));
+    }
+
+    // Walk over all leases using pages of 3 leases.
+    std::set<IOAddress> returned;
+    IOAddress lower_bound = IOAddress("0.0.0.0");
+    for (size_t pages = 0; pages <= leases.size(); ++pages) {
+        Lease4Collection page;
+        ASSERT_NO_THROW(page = lmptr_->getLeases4(lower_bound, 3));
+        ASSERT_LE(page.size(), 3);
+        if (page.empty()) {
+            break;
+        }
+        for (Lease4Collection::const_iterator lease = page.begin();
+             lease != page.end(); ++lease) {
+            EXPECT_TRUE(lower_bound < (*lease)->addr_);
+            EXPECT_TRUE(returned.insert((*lease)->addr_).second)
+                << "lease " << (*lease)->addr_ << " returned twice";
+            lower_bound = (*lease)->addr_;
+        }
+    }
+    EXPECT_EQ(leases.size(), returned.size());
+
+    // There should be nothing after the last lease.
+    EXPECT_TRUE(lmptr_->getLeases4(lower_bound, 3).empty());
+
+    // Only IPv4 address can be used as a cursor.
+    EXPECT_THROW(lmptr_->getLeases4(IOAddress("2001:db8::1"), 3),
+                 isc::BadValue);
+}
+
+void
+GenericLeaseMgrTest::testGetLeases6Paged() {
+    // Get the leases to be used for the test and add them to the database.
+    vector<Lease6Ptr> leases = createLeases6();
+    for (size_t i = 0; i < leases.size(); ++i) {
+        ASSERT_TRUE(lmptr_->addLease(leases[i]));
+    }
+
+    // Walk over all leases using pages of 3 leases. The order of the IPv6
+    // addresses depends on the backend, so it is not checked.
+    std::set<IOAddress> returned;
+    IOAddress lower_bound = IOAddress("::");
+    for (size_t pages = 0; pages <= leases.size(); ++pages) {
+        Lease6Collection page;
+        ASSERT_NO_THROW(page = lmptr_->getLeases6(lower_bound, 3));
+        ASSERT_LE(page.size(), 3);
+        if (page.empty()) {
+            break;
+        }
+        for (Lease6Collection::const_iterator lease = page.begin();
+             lease != page.end(); ++lease) {
+            EXPECT_TRUE(returned.insert((*lease)->addr_).second)
+                << "lease " << (*lease)->addr_ << " returned twice";
+        }
+        lower_bound = page.back()->addr_;
+    }
+    EXPECT_EQ(leases.size(), returned.size());
+
+    // Only IPv6 address can be used as a cursor.
+    EXPECT_THROW(lmptr_->getLeases6(IOAddress("192.0.2.1"), 3),
+                 isc::BadValue);
+}
+
 void
 GenericLeaseMgrTest::testGetExpiredLeases4() {
     // Get the leases to be used for the test.
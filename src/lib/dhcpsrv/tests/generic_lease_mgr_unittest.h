@@ -1,4 +1,4 @@
-// Copyright (C) 2014-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2014-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -324,6 +324,23 @@ public:
     /// - reclaimed leases are not returned.
     void testGetExpiredLeases6();
 
+    /// @brief Checks that all DHCPv4 leases can be retrieved in pages.
+    ///
+    /// This test checks the following:
+    /// - each page holds at most the requested number of leases
+    /// - leases are returned in the ascending order of addresses
+    /// - each lease is returned exactly once
+    /// - IPv6 address can't be used as a cursor.
+    void testGetLeases4Paged();
+
+    /// @brief Checks that all DHCPv6 leases can be retrieved in pages.
+    ///
+    /// This test checks the following:
+    /// - each page holds at most the requested number of leases
+    /// - each lease is returned exactly once
+    /// - IPv4 address can't be used as a cursor.
+    void testGetLeases6Paged();
+
     /// @brief Checks that declined IPv4 leases that have expired can be retrieved.
     ///
     /// This test checks that the following:
@@ -0,0 +1,270 @@
+// Copyright (C) 2017 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <asiolink/io_address.h>
+#include <cc/command_interpreter.h>
+#include <cc/data.h>
+#include <dhcp/option_definition.h>
+#include <dhcp/option_int.h>
+#include <dhcpsrv/cfgmgr.h>
+#include <dhcpsrv/host_cmds.h>
+#include <dhcpsrv/host_mgr.h>
+#include <gtest/gtest.h>
+#include <sys/socket.h>
+#include <string>
+
+using namespace isc;
+using namespace isc::asiolink;
+using namespace isc::config;
+using namespace isc::data;
+using namespace isc::dhcp;
+
+namespace {
+
+/// @brief Test fixture class for @c HostCmds.
+class HostCmdsTest : public ::testing::Test {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// Configures the server with one IPv4 subnet (id 1) and one IPv6
+    /// subnet (id 2).
+    HostCmdsTest() {
+        CfgMgr::instance().clear();
+        HostMgr::create();
+
+        SrvConfigPtr cfg = CfgMgr::instance().getStagingCfg();
+        cfg->getCfgSubnets4()->add(Subnet4Ptr(new Subnet4(IOAddress("192.0.2.0"),
+                                                          24, 1, 2, 3, 1)));
+        cfg->getCfgSubnets6()->add(Subnet6Ptr(new Subnet6(IOAddress("2001:db8:1::"),
+                                                          64, 1, 2, 3, 4, 2)));
+        CfgMgr::instance().commit();
+    }
+
+    /// @brief Destructor.
+    virtual ~HostCmdsTest() {
+        CfgMgr::instance().clear();
+    }
+
+    /// @brief Checks the status code of the answer.
+    ///
+    /// @param answer Answer returned by the command handler.
+    /// @param expected_status Expected status code.
+    /// @param expected_text Expected text, ignored if empty.
+    void checkAnswer(const ConstElementPtr& answer, const int expected_status,
+                     const std::string& expected_text = "") {
+        ASSERT_TRUE(answer);
+        int status = -1;
+        ConstElementPtr text = parseAnswer(status, answer);
+        EXPECT_EQ(expected_status, status) << answer->str();
+        if (!expected_text.empty()) {
+            ASSERT_TRUE(text);
+            EXPECT_EQ(expected_text, text->stringValue());
+        }
+    }
+};
+
+// This test verifies that the IPv4 reservation can be added, retrieved
+// and deleted using the commands.
+TEST_F(HostCmdsTest, reservation4) {
+    ConstElementPtr params = Element::fromJSON(
+        "{ \"reservation\": {"
+        "    \"subnet-id\": 1,"
+        "    \"hw-address\": \"01:02:03:04:05:06\","
+        "    \"ip-address\": \"192.0.2.100\","
+        "    \"hostname\": \"foo.example.org\""
+        "} }");
+    checkAnswer(HostCmds::reservationAddHandler(AF_INET, "reservation-add",
+                                                params),
+                CONTROL_RESULT_SUCCESS, "Host added.");
+
+    // The host is available to the server without reconfiguration.
+    ConstHostPtr host = HostMgr::instance().get4(1, IOAddress("192.0.2.100"));
+    ASSERT_TRUE(host);
+    EXPECT_EQ("foo.example.org", host->getHostname());
+
+    // Adding the same reservation again should fail.
+    checkAnswer(HostCmds::reservationAddHandler(AF_INET, "reservation-add",
+                                                params),
+                CONTROL_RESULT_ERROR);
+
+    // Retrieve the host by address.
+    params = Element::fromJSON("{ \"subnet-id\": 1,"
+                               "  \"ip-address\": \"192.0.2.100\" }");
+    ConstElementPtr answer = HostCmds::reservationGetHandler(AF_INET,
+                                                             "reservation-get",
+                                                             params);
+    checkAnswer(answer, CONTROL_RESULT_SUCCESS, "Host found.");
+    ConstElementPtr args = answer->get(CONTROL_ARGUMENTS);
+    ASSERT_TRUE(args);
+    EXPECT_TRUE(args->equals(*Element::fromJSON(
+        "{ \"subnet-id\": 1,"
+        "  \"hw-address\": \"01:02:03:04:05:06\","
+        "  \"ip-address\": \"192.0.2.100\","
+        "  \"hostname\": \"foo.example.org\" }"))) << args->str();
+
+    // Retrieve the host by identifier.
+    params = Element::fromJSON("{ \"subnet-id\": 1,"
+                               "  \"identifier-type\": \"hw-address\","
+                               "  \"identifier\": \"01:02:03:04:05:06\" }");
+    checkAnswer(HostCmds::reservationGetHandler(AF_INET, "reservation-get",
+                                                params),
+                CONTROL_RESULT_SUCCESS);
+
+    // Delete the host and make sure it is gone.
+    checkAnswer(HostCmds::reservationDelHandler(AF_INET, "reservation-del",
+                                                params),
+                CONTROL_RESULT_SUCCESS, "Host deleted.");
+    EXPECT_FALSE(HostMgr::instance().get4(1, IOAddress("192.0.2.100")));
+    checkAnswer(HostCmds::reservationGetHandler(AF_INET, "reservation-get",
+                                                params),
+                CONTROL_RESULT_EMPTY);
+    checkAnswer(HostCmds::reservationDelHandler(AF_INET, "reservation-del",
+                                                params),
+                CONTROL_RESULT_EMPTY);
+}
+
+// This test verifies that the IPv6 reservation can be added, retrieved
+// and deleted using the commands.
+TEST_F(HostCmdsTest, reservation6) {
+    ConstElementPtr params = Element::fromJSON(
+        "{ \"reservation\": {"
+        "    \"subnet-id\": 2,"
+        "    \"duid\": \"01:02:03:04:05:06:07:08\","
+        "    \"ip-addresses\": [ \"2001:db8:1::100\" ],"
+        "    \"prefixes\": [ \"3000:1::/64\" ]"
+        "} }");
+    checkAnswer(HostCmds::reservationAddHandler(AF_INET6, "reservation-add",
+                                                params),
+                CONTROL_RESULT_SUCCESS);
+
+    params = Element::fromJSON("{ \"subnet-id\": 2,"
+                               "  \"ip-address\": \"2001:db8:1::100\" }");
+    ConstElementPtr answer = HostCmds::reservationGetHandler(AF_INET6,
+                                                             "reservation-get",
+                                                             params);
+    checkAnswer(answer, CONTROL_RESULT_SUCCESS);
+    ConstElementPtr args = answer->get(CONTROL_ARGUMENTS);
+    ASSERT_TRUE(args);
+    EXPECT_TRUE(args->equals(*Element::fromJSON(
+        "{ \"subnet-id\": 2,"
+        "  \"duid\": \"01:02:03:04:05:06:07:08\","
+        "  \"ip-addresses\": [ \"2001:db8:1::100\" ],"
+        "  \"prefixes\": [ \"3000:1::/64\" ] }"))) << args->str();
+
+    // Delete by address. Both the address and the prefix should no longer
+    // be reserved.
+    checkAnswer(HostCmds::reservationDelHandler(AF_INET6, "reservation-del",
+                                                params),
+                CONTROL_RESULT_SUCCESS);
+    EXPECT_FALSE(HostMgr::instance().get6(2, IOAddress("2001:db8:1::100")));
+    EXPECT_FALSE(HostMgr::instance().get6(IOAddress("3000:1::"), 64));
+}
+
+// This test verifies that invalid arguments are rejected.
+TEST_F(HostCmdsTest, invalidArguments) {
+    // No arguments.
+    checkAnswer(HostCmds::reservationAddHandler(AF_INET, "reservation-add",
+                                                ConstElementPtr()),
+                CONTROL_RESULT_ERROR);
+    checkAnswer(HostCmds::reservationGetHandler(AF_INET, "reservation-get",
+                                                ConstElementPtr()),
+                CONTROL_RESULT_ERROR);
+
+    // Non-existing subnet.
+    checkAnswer(HostCmds::reservationAddHandler(AF_INET, "reservation-add",
+        Element::fromJSON("{ \"reservation\": {"
+                          "    \"subnet-id\": 5,"
+                          "    \"hw-address\": \"01:02:03:04:05:06\","
+                          "    \"ip-address\": \"192.0.2.100\" } }")),
+                CONTROL_RESULT_ERROR, "subnet with id 5 does not exist");
+
+    // IPv4 subnet used with the DHCPv6 server.
+    checkAnswer(HostCmds::reservationAddHandler(AF_INET6, "reservation-add",
+        Element::fromJSON("{ \"reservation\": {"
+                          "    \"subnet-id\": 1,"
+                          "    \"duid\": \"01:02:03:04:05:06\" } }")),
+                CONTROL_RESULT_ERROR);
+
+    // Unsupported reservation parameter.
+    checkAnswer(HostCmds::reservationAddHandler(AF_INET, "reservation-add",
+        Element::fromJSON("{ \"reservation\": {"
+                          "    \"subnet-id\": 1,"
+                          "    \"hw-address\": \"01:02:03:04:05:06\","
+                          "    \"ip-addresses\": [ \"2001:db8:1::1\" ] } }")),
+                CONTROL_RESULT_ERROR);
+
+    // Address of the wrong family.
+    checkAnswer(HostCmds::reservationGetHandler(AF_INET, "reservation-get",
+        Element::fromJSON("{ \"subnet-id\": 1,"
+                          "  \"ip-address\": \"2001:db8:1::1\" }")),
+                CONTROL_RESULT_ERROR);
+
+    // Missing identifier.
+    checkAnswer(HostCmds::reservationDelHandler(AF_INET, "reservation-del",
+        Element::fromJSON("{ \"subnet-id\": 1,"
+                          "  \"identifier-type\": \"hw-address\" }")),
+                CONTROL_RESULT_ERROR);
+
+    // Invalid identifier type.
+    checkAnswer(HostCmds::reservationDelHandler(AF_INET, "reservation-del",
+        Element::fromJSON("{ \"subnet-id\": 1,"
+                          "  \"identifier-type\": \"foo\","
+                          "  \"identifier\": \"01:02\" }")),
+                CONTROL_RESULT_ERROR);
+}
+
+// This test verifies that the options included in the added reservation
+// are parsed using the option definitions of the current configuration.
+TEST_F(HostCmdsTest, reservationAddCustomOption) {
+    // Replace the current configuration with one holding the custom
+    // option definition.
+    SrvConfigPtr cfg = CfgMgr::instance().getStagingCfg();
+    cfg->getCfgSubnets4()->add(Subnet4Ptr(new Subnet4(IOAddress("192.0.2.0"),
+                                                      24, 1, 2, 3, 1)));
+    OptionDefinitionPtr def(new OptionDefinition("foo", 222, "uint32"));
+    cfg->getCfgOptionDef()->add(def, "dhcp4");
+    CfgMgr::instance().commit();
+
+    checkAnswer(HostCmds::reservationAddHandler(AF_INET, "reservation-add",
+        Element::fromJSON("{ \"reservation\": {"
+                          "    \"subnet-id\": 1,"
+                          "    \"hw-address\": \"01:02:03:04:05:06\","
+                          "    \"ip-address\": \"192.0.2.100\","
+                          "    \"option-data\": [ {"
+                          "        \"name\": \"foo\","
+                          "        \"data\": \"123\" } ] } }")),
+                CONTROL_RESULT_SUCCESS);
+
+    ConstHostPtr host = HostMgr::instance().get4(1, IOAddress("192.0.2.100"));
+    ASSERT_TRUE(host);
+    OptionDescriptor desc = host->getCfgOption4()->get("dhcp4", 222);
+    OptionUint32Ptr option = boost::dynamic_pointer_cast<
+        OptionUint32>(desc.option_);
+    ASSERT_TRUE(option);
+    EXPECT_EQ(123, option->getValue());
+}
+
+// This test verifies that the subnet whose reservations have been modified
+// at runtime is no longer considered for reuse during reconfiguration.
+TEST_F(HostCmdsTest, forgetModifiedSubnet) {
+    ConstElementPtr subnet = Element::fromJSON(
+        "{ \"id\": 1, \"subnet\": \"192.0.2.0/24\" }");
+    CfgMgr::instance().getCurrentCfgIncremental()->addSubnet(subnet);
+    ASSERT_EQ(1, CfgMgr::instance().getCurrentCfgIncremental()->getSubnetsCount());
+
+    checkAnswer(HostCmds::reservationAddHandler(AF_INET, "reservation-add",
+        Element::fromJSON("{ \"reservation\": {"
+                          "    \"subnet-id\": 1,"
+                          "    \"hw-address\": \"01:02:03:04:05:06\","
+                          "    \"ip-address\": \"192.0.2.100\" } }")),
+                CONTROL_RESULT_SUCCESS);
+
+    EXPECT_EQ(0, CfgMgr::instance().getCurrentCfgIncremental()->getSubnetsCount());
+}
+
+} // end of anonymous namespace
@@ -352,6 +352,29 @@ TEST_F(HostReservationParserTest, dhcp4MessageFields) {
     EXPECT_EQ("/tmp/some-file.efi", hosts[0]->getBootFileName());
 }
 
+// This test verifies that the parsed host is returned without being added
+// to the staging configuration.
+TEST_F(HostReservationParserTest, dhcp4ParseHost) {
+    std::string config = "{ \"hw-address\": \"1:2:3:4:5:6\","
+        "\"ip-address\": \"192.0.2.112\","
+        "\"hostname\": \"foo.example.com\" }";
+
+    ElementPtr config_element = Element::fromJSON(config);
+
+    HostReservationParser4 parser;
+    HostPtr host;
+    ASSERT_NO_THROW(host = parser.parseHost(SubnetID(10), config_element));
+    ASSERT_TRUE(host);
+
+    EXPECT_EQ(10, host->getIPv4SubnetID());
+    EXPECT_EQ("192.0.2.112", host->getIPv4Reservation().toText());
+    EXPECT_EQ("foo.example.com", host->getHostname());
+
+    CfgHostsPtr cfg_hosts = CfgMgr::instance().getStagingCfg()->getCfgHosts();
+    EXPECT_TRUE(cfg_hosts->getAll(Host::IDENT_HWADDR, &hwaddr_->hwaddr_[0],
+                                  hwaddr_->hwaddr_.size()).empty());
+}
+
 // This test verifies that the invalid value of the next server is rejected.
 TEST_F(HostReservationParserTest, invalidNextServer) {
     // Invalid IPv4 address.
@@ -0,0 +1,409 @@
+// Copyright (C) 2017 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <asiolink/io_address.h>
+#include <cc/command_interpreter.h>
+#include <cc/data.h>
+#include <dhcpsrv/cfgmgr.h>
+#include <dhcpsrv/lease_cmds.h>
+#include <dhcpsrv/lease_mgr_factory.h>
+#include <stats/stats_mgr.h>
+#include <gtest/gtest.h>
+#include <sys/socket.h>
+#include <sstream>
+#include <string>
+
+using namespace isc;
+using namespace isc::asiolink;
+using namespace isc::config;
+using namespace isc::data;
+using namespace isc::dhcp;
+using namespace isc::stats;
+
+namespace {
+
+/// @brief Test fixture class for @c LeaseCmds.
+class LeaseCmdsTest : public ::testing::Test {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// Configures the server with one IPv4 subnet (id 1) and one IPv6
+    /// subnet (id 2).
+    LeaseCmdsTest() {
+        CfgMgr::instance().clear();
+        StatsMgr::instance().removeAll();
+        SrvConfigPtr cfg = CfgMgr::instance().getStagingCfg();
+        cfg->getCfgSubnets4()->add(Subnet4Ptr(new Subnet4(IOAddress("192.0.2.0"),
+                                                          24, 1, 2, 3, 1)));
+        cfg->getCfgSubnets6()->add(Subnet6Ptr(new Subnet6(IOAddress("2001:db8:1::"),
+                                                          64, 1, 2, 3, 4, 2)));
+        CfgMgr::instance().commit();
+    }
+
+    /// @brief Destructor.
+    virtual ~LeaseCmdsTest() {
+        LeaseMgrFactory::destroy();
+        CfgMgr::instance().clear();
+        StatsMgr::instance().removeAll();
+    }
+
+    /// @brief Creates in-memory lease database for the given universe.
+    ///
+    /// @param universe 4 or 6.
+    void startBackend(const int universe) {
+        std::ostringstream s;
+        s << "type=memfile persist=false universe=" << universe;
+        LeaseMgrFactory::create(s.str());
+    }
+
+    /// @brief Returns the value of the statistic.
+    ///
+    /// @param name Statistic name.
+    ///
+    /// @return Value of the statistic or 0 if it doesn't exist.
+    int64_t getStatistic(const std::string& name) {
+        ObservationPtr obs = StatsMgr::instance().getObservation(name);
+        return (obs ? obs->getInteger().first : 0);
+    }
+
+    /// @brief Checks the status code of the answer.
+    ///
+    /// @param answer Answer returned by the command handler.
+    /// @param expected_status Expected status code.
+    /// @param expected_text Expected text, ignored if empty.
+    void checkAnswer(const ConstElementPtr& answer, const int expected_status,
+                     const std::string& expected_text = "") {
+        ASSERT_TRUE(answer);
+        int status = -1;
+        ConstElementPtr text = parseAnswer(status, answer);
+        EXPECT_EQ(expected_status, status) << answer->str();
+        if (!expected_text.empty()) {
+            ASSERT_TRUE(text);
+            EXPECT_EQ(expected_text, text->stringValue());
+        }
+    }
+};
+
+// This test verifies that the DHCPv4 lease can be added, retrieved, updated
+// and deleted using the commands.
+TEST_F(LeaseCmdsTest, lease4) {
+    startBackend(4);
+
+    ConstElementPtr params = Element::fromJSON(
+        "{ \"ip-address\": \"192.0.2.100\","
+        "  \"subnet-id\": 1,"
+        "  \"hw-address\": \"01:02:03:04:05:06\","
+        "  \"valid-lft\": 1000,"
+        "  \"cltt\": 12345 }");
+    checkAnswer(LeaseCmds::leaseAddHandler(AF_INET, "lease4-add", params),
+                CONTROL_RESULT_SUCCESS, "Lease added.");
+    Lease4Ptr lease = LeaseMgrFactory::instance().getLease4(IOAddress("192.0.2.100"));
+    ASSERT_TRUE(lease);
+    EXPECT_EQ(1000, lease->valid_lft_);
+
+    // The lease already exists.
+    checkAnswer(LeaseCmds::leaseAddHandler(AF_INET, "lease4-add", params),
+                CONTROL_RESULT_ERROR);
+
+    // Retrieve the lease by address.
+    ConstElementPtr answer = LeaseCmds::leaseGetHandler(AF_INET, "lease4-get",
+        Element::fromJSON("{ \"ip-address\": \"192.0.2.100\" }"));
+    checkAnswer(answer, CONTROL_RESULT_SUCCESS, "Lease found.");
+    ConstElementPtr args = answer->get(CONTROL_ARGUMENTS);
+    ASSERT_TRUE(args);
+    EXPECT_TRUE(args->equals(*Element::fromJSON(
+        "{ \"ip-address\": \"192.0.2.100\","
+        "  \"subnet-id\": 1,"
+        "  \"hw-address\": \"01:02:03:04:05:06\","
+        "  \"valid-lft\": 1000,"
+        "  \"cltt\": 12345,"
+        "  \"fqdn-fwd\": false,"
+        "  \"fqdn-rev\": false,"
+        "  \"hostname\": \"\","
+        "  \"state\": 0 }"))) << args->str();
+
+    // Retrieve the lease by hardware address.
+    checkAnswer(LeaseCmds::leaseGetHandler(AF_INET, "lease4-get",
+        Element::fromJSON("{ \"identifier-type\": \"hw-address\","
+                          "  \"identifier\": \"01:02:03:04:05:06\","
+                          "  \"subnet-id\": 1 }")),
+                CONTROL_RESULT_SUCCESS);
+
+    // Update the lease.
+    params = Element::fromJSON(
+        "{ \"ip-address\": \"192.0.2.100\","
+        "  \"subnet-id\": 1,"
+        "  \"hw-address\": \"01:02:03:04:05:06\","
+        "  \"hostname\": \"foo.example.org\" }");
+    checkAnswer(LeaseCmds::leaseUpdateHandler(AF_INET, "lease4-update", params),
+                CONTROL_RESULT_SUCCESS, "Lease updated.");
+    lease = LeaseMgrFactory::instance().getLease4(IOAddress("192.0.2.100"));
+    ASSERT_TRUE(lease);
+    EXPECT_EQ("foo.example.org", lease->hostname_);
+
+    // Delete the lease.
+    params = Element::fromJSON("{ \"ip-address\": \"192.0.2.100\" }");
+    checkAnswer(LeaseCmds::leaseDelHandler(AF_INET, "lease4-del", params),
+                CONTROL_RESULT_SUCCESS, "Lease deleted.");
+    checkAnswer(LeaseCmds::leaseDelHandler(AF_INET, "lease4-del", params),
+                CONTROL_RESULT_EMPTY);
+    checkAnswer(LeaseCmds::leaseGetHandler(AF_INET, "lease4-get", params),
+                CONTROL_RESULT_EMPTY);
+
+    // Non-existing lease can't be updated.
+    checkAnswer(LeaseCmds::leaseUpdateHandler(AF_INET, "lease4-update",
+        Element::fromJSON("{ \"ip-address\": \"192.0.2.100\","
+                          "  \"subnet-id\": 1,"
+                          "  \"hw-address\": \"01:02:03:04:05:06\" }")),
+                CONTROL_RESULT_ERROR);
+}
+
+// This test verifies that the DHCPv6 lease can be added, retrieved and
+// deleted using the commands.
+TEST_F(LeaseCmdsTest, lease6) {
+    startBackend(6);
+
+    checkAnswer(LeaseCmds::leaseAddHandler(AF_INET6, "lease6-add",
+        Element::fromJSON("{ \"ip-address\": \"3000:1::\","
+                          "  \"type\": \"IA_PD\","
+                          "  \"prefix-len\": 64,"
+                          "  \"subnet-id\": 2,"
+                          "  \"duid\": \"01:02:03:04:05:06:07:08\","
+                          "  \"iaid\": 1234 }")),
+                CONTROL_RESULT_SUCCESS);
+
+    Lease6Ptr lease = LeaseMgrFactory::instance().getLease6(Lease::TYPE_PD,
+                                                            IOAddress("3000:1::"));
+    ASSERT_TRUE(lease);
+    EXPECT_EQ(64, static_cast<int>(lease->prefixlen_));
+    EXPECT_EQ(1234, lease->iaid_);
+    // Lifetimes are taken from the subnet.
+    EXPECT_EQ(3, lease->preferred_lft_);
+    EXPECT_EQ(4, lease->valid_lft_);
+
+    // Retrieve by DUID and IAID.
+    ConstElementPtr answer = LeaseCmds::leaseGetHandler(AF_INET6, "lease6-get",
+        Element::fromJSON("{ \"identifier-type\": \"duid\","
+                          "  \"identifier\": \"01:02:03:04:05:06:07:08\","
+                          "  \"iaid\": 1234,"
+                          "  \"type\": \"IA_PD\","
+                          "  \"subnet-id\": 2 }"));
+    checkAnswer(answer, CONTROL_RESULT_SUCCESS);
+    ConstElementPtr args = answer->get(CONTROL_ARGUMENTS);
+    ASSERT_TRUE(args);
+    ASSERT_TRUE(args->get("prefix-len"));
+    EXPECT_EQ(64, args->get("prefix-len")->intValue());
+
+    // The address is not in the subnet.
+    checkAnswer(LeaseCmds::leaseAddHandler(AF_INET6, "lease6-add",
+        Element::fromJSON("{ \"ip-address\": \"2001:db8:2::1\","
+                          "  \"subnet-id\": 2,"
+                          "  \"duid\": \"01:02:03:04:05:06:07:08\","
+                          "  \"iaid\": 1234 }")),
+                CONTROL_RESULT_ERROR);
+
+    checkAnswer(LeaseCmds::leaseDelHandler(AF_INET6, "lease6-del",
+        Element::fromJSON("{ \"ip-address\": \"3000:1::\" }")),
+                CONTROL_RESULT_SUCCESS);
+}
+
+// This test verifies that the commands update the statistics of the
+// assigned and declined DHCPv4 leases.
+TEST_F(LeaseCmdsTest, lease4Statistics) {
+    startBackend(4);
+
+    checkAnswer(LeaseCmds::leaseAddHandler(AF_INET, "lease4-add",
+        Element::fromJSON("{ \"ip-address\": \"192.0.2.100\","
+                          "  \"subnet-id\": 1,"
+                          "  \"hw-address\": \"01:02:03:04:05:06\" }")),
+                CONTROL_RESULT_SUCCESS);
+    EXPECT_EQ(1, getStatistic("subnet[1].assigned-addresses"));
+
+    // Declined lease is both assigned and declined.
+    ConstElementPtr declined = Element::fromJSON(
+        "{ \"ip-address\": \"192.0.2.101\","
+        "  \"subnet-id\": 1,"
+        "  \"hw-address\": \"01:02:03:04:05:07\","
+        "  \"state\": 1 }");
+    checkAnswer(LeaseCmds::leaseAddHandler(AF_INET, "lease4-add", declined),
+                CONTROL_RESULT_SUCCESS);
+    EXPECT_EQ(2, getStatistic("subnet[1].assigned-addresses"));
+    EXPECT_EQ(1, getStatistic("subnet[1].declined-addresses"));
+    EXPECT_EQ(1, getStatistic("declined-addresses"));
+
+    // Adding the existing lease doesn't change the statistics.
+    checkAnswer(LeaseCmds::leaseAddHandler(AF_INET, "lease4-add", declined),
+                CONTROL_RESULT_ERROR);
+    EXPECT_EQ(2, getStatistic("subnet[1].assigned-addresses"));
+
+    // Reclaimed lease is not assigned.
+    checkAnswer(LeaseCmds::leaseUpdateHandler(AF_INET, "lease4-update",
+        Element::fromJSON("{ \"ip-address\": \"192.0.2.101\","
+                          "  \"subnet-id\": 1,"
+                          "  \"hw-address\": \"01:02:03:04:05:07\","
+                          "  \"state\": 2 }")),
+                CONTROL_RESULT_SUCCESS);
+    EXPECT_EQ(1, getStatistic("subnet[1].assigned-addresses"));
+    EXPECT_EQ(0, getStatistic("subnet[1].declined-addresses"));
+    EXPECT_EQ(0, getStatistic("declined-addresses"));
+
+    checkAnswer(LeaseCmds::leaseDelHandler(AF_INET, "lease4-del",
+        Element::fromJSON("{ \"ip-address\": \"192.0.2.101\" }")),
+                CONTROL_RESULT_SUCCESS);
+    EXPECT_EQ(1, getStatistic("subnet[1].assigned-addresses"));
+
+    checkAnswer(LeaseCmds::leaseDelHandler(AF_INET, "lease4-del",
+        Element::fromJSON("{ \"ip-address\": \"192.0.2.100\" }")),
+                CONTROL_RESULT_SUCCESS);
+    EXPECT_EQ(0, getStatistic("subnet[1].assigned-addresses"));
+
+    // Deleting non-existing lease doesn't change the statistics.
+    checkAnswer(LeaseCmds::leaseDelHandler(AF_INET, "lease4-del",
+        Element::fromJSON("{ \"ip-address\": \"192.0.2.100\" }")),
+                CONTROL_RESULT_EMPTY);
+    EXPECT_EQ(0, getStatistic("subnet[1].assigned-addresses"));
+}
+
+// This test verifies that the commands update the statistics of the
+// assigned DHCPv6 addresses and prefixes.
+TEST_F(LeaseCmdsTest, lease6Statistics) {
+    startBackend(6);
+
+    checkAnswer(LeaseCmds::leaseAddHandler(AF_INET6, "lease6-add",
+        Element::fromJSON("{ \"ip-address\": \"2001:db8:1::1\","
+                          "  \"subnet-id\": 2,"
+                          "  \"duid\": \"01:02:03:04:05:06:07:08\","
+                          "  \"iaid\": 1234 }")),
+                CONTROL_RESULT_SUCCESS);
+    checkAnswer(LeaseCmds::leaseAddHandler(AF_INET6, "lease6-add",
+        Element::fromJSON("{ \"ip-address\": \"3000:1::\","
+                          "  \"type\": \"IA_PD\","
+                          "  \"prefix-len\": 64,"
+                          "  \"subnet-id\": 2,"
+                          "  \"duid\": \"01:02:03:04:05:06:07:08\","
+                          "  \"iaid\": 1234 }")),
+                CONTROL_RESULT_SUCCESS);
+    EXPECT_EQ(1, getStatistic("subnet[2].assigned-nas"));
+    EXPECT_EQ(1, getStatistic("subnet[2].assigned-pds"));
+
+    // The prefix is found without specifying the lease type.
+    checkAnswer(LeaseCmds::leaseDelHandler(AF_INET6, "lease6-del",
+        Element::fromJSON("{ \"ip-address\": \"3000:1::\" }")),
+                CONTROL_RESULT_SUCCESS);
+    EXPECT_EQ(1, getStatistic("subnet[2].assigned-nas"));
+    EXPECT_EQ(0, getStatistic("subnet[2].assigned-pds"));
+
+    // The lease type doesn't match.
+    checkAnswer(LeaseCmds::leaseDelHandler(AF_INET6, "lease6-del",
+        Element::fromJSON("{ \"ip-address\": \"2001:db8:1::1\","
+                          "  \"type\": \"IA_PD\" }")),
+                CONTROL_RESULT_EMPTY);
+    EXPECT_EQ(1, getStatistic("subnet[2].assigned-nas"));
+
+    checkAnswer(LeaseCmds::leaseDelHandler(AF_INET6, "lease6-del",
+        Element::fromJSON("{ \"ip-address\": \"2001:db8:1::1\","
+                          "  \"type\": \"IA_NA\" }")),
+                CONTROL_RESULT_SUCCESS);
+    EXPECT_EQ(0, getStatistic("subnet[2].assigned-nas"));
+}
+
+// This test verifies that invalid arguments are rejected.
+TEST_F(LeaseCmdsTest, invalidArguments) {
+    startBackend(4);
+
+    checkAnswer(LeaseCmds::leaseAddHandler(AF_INET, "lease4-add",
+                                           ConstElementPtr()),
+                CONTROL_RESULT_ERROR);
+
+    // Non-existing subnet.
+    checkAnswer(LeaseCmds::leaseAddHandler(AF_INET, "lease4-add",
+        Element::fromJSON("{ \"ip-address\": \"192.0.2.100\","
+                          "  \"subnet-id\": 5,"
+                          "  \"hw-address\": \"01:02:03:04:05:06\" }")),
+                CONTROL_RESULT_ERROR, "subnet with id 5 does not exist");
+
+    // Missing hardware address.
+    checkAnswer(LeaseCmds::leaseAddHandler(AF_INET, "lease4-add",
+        Element::fromJSON("{ \"ip-address\": \"192.0.2.100\","
+                          "  \"subnet-id\": 1 }")),
+                CONTROL_RESULT_ERROR, "'hw-address' parameter not specified");
+
+    // Address of the wrong family.
+    checkAnswer(LeaseCmds::leaseGetHandler(AF_INET, "lease4-get",
+        Element::fromJSON("{ \"ip-address\": \"2001:db8:1::1\" }")),
+                CONTROL_RESULT_ERROR);
+
+    // Unsupported identifier type.
+    checkAnswer(LeaseCmds::leaseGetHandler(AF_INET, "lease4-get",
+        Element::fromJSON("{ \"identifier-type\": \"duid\","
+                          "  \"identifier\": \"01:02:03\","
+                          "  \"subnet-id\": 1 }")),
+                CONTROL_RESULT_ERROR);
+
+    // Invalid page size.
+    checkAnswer(LeaseCmds::leaseGetAllHandler(AF_INET, "lease-get-all",
+        Element::fromJSON("{ \"from\": \"start\", \"limit\": 0 }")),
+                CONTROL_RESULT_ERROR);
+    checkAnswer(LeaseCmds::leaseGetAllHandler(AF_INET, "lease-get-all",
+        Element::fromJSON("{ \"from\": \"start\", \"limit\": 1000000 }")),
+                CONTROL_RESULT_ERROR);
+}
+
+// This test verifies that all leases can be retrieved in pages.
+TEST_F(LeaseCmdsTest, leaseGetAll) {
+    startBackend(4);
+
+    for (int i = 10; i < 15; ++i) {
+        std::ostringstream s;
+        s << "{ \"ip-address\": \"192.0.2." << i << "\","
+          << "  \"subnet-id\": 1,"
+          << "  \"hw-address\": \"01:02:03:04:05:" << i << "\" }";
+        checkAnswer(LeaseCmds::leaseAddHandler(AF_INET, "lease4-add",
+                                               Element::fromJSON(s.str())),
+                    CONTROL_RESULT_SUCCESS);
+    }
+
+    std::string from = "start";
+    std::vector<std::string> addresses;
+    for (int pages = 0; pages < 5; ++pages) {
+        ElementPtr params = Element::createMap();
+        params->set("from", Element::create(from));
+        params->set("limit", Element::create(2));
+        ConstElementPtr answer = LeaseCmds::leaseGetAllHandler(AF_INET,
+                                                               "lease-get-all",
+                                                               params);
+        int status = -1;
+        parseAnswer(status, answer);
+        if (status == CONTROL_RESULT_EMPTY) {
+            break;
+        }
+        ASSERT_EQ(CONTROL_RESULT_SUCCESS, status) << answer->str();
+
+        ConstElementPtr args = answer->get(CONTROL_ARGUMENTS);
+        ASSERT_TRUE(args);
+        ConstElementPtr leases = args->get("leases");
+        ASSERT_TRUE(leases);
+        ASSERT_LE(leases->size(), 2);
+        EXPECT_EQ(leases->size(), args->get("count")->intValue());
+        for (size_t i = 0; i < leases->size(); ++i) {
+            addresses.push_back(leases->get(i)->get("ip-address")->stringValue());
+        }
+
+        // The last page doesn't hold the cursor.
+        if (!args->get("next")) {
+            break;
+        }
+        from = args->get("next")->stringValue();
+    }
+
+    ASSERT_EQ(5, addresses.size());
+    EXPECT_EQ("192.0.2.10", addresses[0]);
+    EXPECT_EQ("192.0.2.14", addresses[4]);
+}
+
+} // end of anonymous namespace
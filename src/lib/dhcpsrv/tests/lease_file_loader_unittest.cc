@@ -1,4 +1,4 @@
-// Copyright (C) 2015 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -62,7 +62,8 @@ public:
         // Both Lease4Storage and Lease6Storage use index 0 to retrieve the
         // lease using an IP address.
         const SearchIndex& idx = storage.template get<0>();
-        typename SearchIndex::iterator lease = idx.find(IOAddress(address));
+        typename SearchIndex::iterator lease =
+            idx.find(idx.key_extractor().fromAddress(IOAddress(address)));
         // Lease found. Return it.
         if (lease != idx.end()) {
             return (*lease);
@@ -0,0 +1,321 @@
+// Copyright (C) 2017 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <asiolink/io_address.h>
+#include <dhcp/duid.h>
+#include <dhcp/hwaddr.h>
+#include <dhcpsrv/lease_lookup_cache.h>
+#include <dhcpsrv/memfile_lease_mgr.h>
+#include <dhcpsrv/pool.h>
+#include <dhcpsrv/subnet.h>
+#include <exceptions/exceptions.h>
+#include <boost/scoped_ptr.hpp>
+#include <gtest/gtest.h>
+#include <time.h>
+#include <vector>
+
+using namespace isc;
+using namespace isc::asiolink;
+using namespace isc::dhcp;
+
+namespace {
+
+/// @brief Test fixture class for the @c LeaseLookupCache.
+class LeaseLookupCacheTest : public ::testing::Test {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// Creates the lease managers and the subnets with a single pool each.
+    LeaseLookupCacheTest()
+        : subnet4_(new Subnet4(IOAddress("192.0.2.0"), 24, 1, 2, 3, 1)),
+          subnet6_(new Subnet6(IOAddress("2001:db8:1::"), 64, 1, 2, 3, 4, 1)) {
+        subnet4_->addPool(Pool4Ptr(new Pool4(IOAddress("192.0.2.100"),
+                                             IOAddress("192.0.2.199"))));
+        subnet6_->addPool(Pool6Ptr(new Pool6(Lease::TYPE_NA,
+                                             IOAddress("2001:db8:1::10"),
+                                             IOAddress("2001:db8:1::20"))));
+
+        DatabaseConnection::ParameterMap parameters;
+        parameters["type"] = "memfile";
+        parameters["universe"] = "4";
+        parameters["persist"] = "false";
+        lease_mgr4_.reset(new Memfile_LeaseMgr(parameters));
+        parameters["universe"] = "6";
+        lease_mgr6_.reset(new Memfile_LeaseMgr(parameters));
+    }
+
+    /// @brief Adds the IPv4 lease.
+    ///
+    /// @param address Leased address.
+    /// @param expired Indicates if the lease should be expired.
+    void addLease4(const std::string& address, const bool expired = false) {
+        HWAddrPtr hwaddr(new HWAddr(std::vector<uint8_t>(6, 1), HTYPE_ETHER));
+        Lease4Ptr lease(new Lease4(IOAddress(address), hwaddr, 0, 0, 60, 30,
+                                   45, time(NULL) - (expired ? 100 : 0),
+                                   SubnetID(1)));
+        ASSERT_TRUE(lease_mgr4_->addLease(lease));
+    }
+
+    /// @brief Adds the IPv6 lease.
+    ///
+    /// @param type Lease type.
+    /// @param address Leased address or prefix.
+    void addLease6(const Lease::Type type, const std::string& address) {
+        DuidPtr duid(new DUID(std::vector<uint8_t>(8, 1)));
+        Lease6Ptr lease(new Lease6(type, IOAddress(address), duid, 1, 30, 60,
+                                   10, 20, SubnetID(1), HWAddrPtr(),
+                                   type == Lease::TYPE_PD ? 64 : 128));
+        ASSERT_TRUE(lease_mgr6_->addLease(lease));
+    }
+
+    /// @brief IPv4 subnet.
+    Subnet4Ptr subnet4_;
+
+    /// @brief IPv6 subnet.
+    Subnet6Ptr subnet6_;
+
+    /// @brief IPv4 lease manager.
+    boost::scoped_ptr<Memfile_LeaseMgr> lease_mgr4_;
+
+    /// @brief IPv6 lease manager.
+    boost::scoped_ptr<Memfile_LeaseMgr> lease_mgr6_;
+};
+
+// This test verifies that the constructor validates its arguments.
+TEST_F(LeaseLookupCacheTest, constructor) {
+    EXPECT_THROW(LeaseLookupCache(-1, 1), BadValue);
+    EXPECT_THROW(LeaseLookupCache(1, -1), BadValue);
+    EXPECT_NO_THROW(LeaseLookupCache(0, 0));
+}
+
+// This test verifies that the status of the IPv4 addresses is determined
+// from the pool summary.
+TEST_F(LeaseLookupCacheTest, status4) {
+    ASSERT_NO_FATAL_FAILURE(addLease4("192.0.2.50"));
+    ASSERT_NO_FATAL_FAILURE(addLease4("192.0.2.100"));
+    ASSERT_NO_FATAL_FAILURE(addLease4("192.0.2.150", true));
+    ASSERT_NO_FATAL_FAILURE(addLease4("192.0.2.199"));
+
+    LeaseLookupCache cache;
+    EXPECT_EQ(LeaseLookupCache::IN_USE,
+              cache.getStatus(*lease_mgr4_, subnet4_, Lease::TYPE_V4,
+                              IOAddress("192.0.2.100")));
+    EXPECT_EQ(LeaseLookupCache::IN_USE,
+              cache.getStatus(*lease_mgr4_, subnet4_, Lease::TYPE_V4,
+                              IOAddress("192.0.2.199")));
+    EXPECT_EQ(LeaseLookupCache::FREE,
+              cache.getStatus(*lease_mgr4_, subnet4_, Lease::TYPE_V4,
+                              IOAddress("192.0.2.101")));
+
+    // The expired lease may be reused, so it must be looked up.
+    EXPECT_EQ(LeaseLookupCache::UNKNOWN,
+              cache.getStatus(*lease_mgr4_, subnet4_, Lease::TYPE_V4,
+                              IOAddress("192.0.2.150")));
+
+    // The address outside of the pool is unknown.
+    EXPECT_EQ(LeaseLookupCache::UNKNOWN,
+              cache.getStatus(*lease_mgr4_, subnet4_, Lease::TYPE_V4,
+                              IOAddress("192.0.2.50")));
+
+    // The lease outside of the pool is not in the summary.
+    EXPECT_EQ(3, cache.getPoolLeasesNum(Lease::TYPE_V4,
+                                        IOAddress("192.0.2.100")));
+}
+
+// This test verifies that the pool summary is refreshed after the
+// configured time.
+TEST_F(LeaseLookupCacheTest, refresh) {
+    LeaseLookupCache cache;
+    EXPECT_EQ(LeaseLookupCache::FREE,
+              cache.getStatus(*lease_mgr4_, subnet4_, Lease::TYPE_V4,
+                              IOAddress("192.0.2.120")));
+
+    // The summary is stale.
+    ASSERT_NO_FATAL_FAILURE(addLease4("192.0.2.120"));
+    EXPECT_EQ(LeaseLookupCache::FREE,
+              cache.getStatus(*lease_mgr4_, subnet4_, Lease::TYPE_V4,
+                              IOAddress("192.0.2.120")));
+
+    // The summary is loaded again after being cleared.
+    cache.clear();
+    EXPECT_EQ(LeaseLookupCache::IN_USE,
+              cache.getStatus(*lease_mgr4_, subnet4_, Lease::TYPE_V4,
+                              IOAddress("192.0.2.120")));
+
+    // The summary is loaded for each lookup when the refresh time is 0.
+    LeaseLookupCache cache0(0, 0);
+    EXPECT_EQ(LeaseLookupCache::FREE,
+              cache0.getStatus(*lease_mgr4_, subnet4_, Lease::TYPE_V4,
+                               IOAddress("192.0.2.121")));
+    ASSERT_NO_FATAL_FAILURE(addLease4("192.0.2.121"));
+    EXPECT_EQ(LeaseLookupCache::IN_USE,
+              cache0.getStatus(*lease_mgr4_, subnet4_, Lease::TYPE_V4,
+                               IOAddress("192.0.2.121")));
+}
+
+// This test verifies that the addresses marked in use are reported in use
+// regardless of the pool summary.
+TEST_F(LeaseLookupCacheTest, markInUse) {
+    LeaseLookupCache cache;
+    EXPECT_EQ(LeaseLookupCache::FREE,
+              cache.getStatus(*lease_mgr4_, subnet4_, Lease::TYPE_V4,
+                              IOAddress("192.0.2.130")));
+    cache.markInUse(Lease::TYPE_V4, IOAddress("192.0.2.130"));
+    EXPECT_EQ(LeaseLookupCache::IN_USE,
+              cache.getStatus(*lease_mgr4_, subnet4_, Lease::TYPE_V4,
+                              IOAddress("192.0.2.130")));
+
+    // The addresses are not remembered when the TTL is 0.
+    LeaseLookupCache cache0(LeaseLookupCache::DEFAULT_POOL_REFRESH_TIME, 0);
+    cache0.markInUse(Lease::TYPE_V4, IOAddress("192.0.2.130"));
+    EXPECT_EQ(LeaseLookupCache::FREE,
+              cache0.getStatus(*lease_mgr4_, subnet4_, Lease::TYPE_V4,
+                               IOAddress("192.0.2.130")));
+}
+
+// This test verifies that the summary of the pool and the remembered
+// address are dropped when the address is invalidated.
+TEST_F(LeaseLookupCacheTest, invalidate) {
+    ASSERT_NO_FATAL_FAILURE(addLease4("192.0.2.100"));
+    ASSERT_NO_FATAL_FAILURE(addLease4("192.0.2.150"));
+
+    LeaseLookupCache cache;
+    cache.markInUse(Lease::TYPE_V4, IOAddress("192.0.2.101"));
+    EXPECT_EQ(LeaseLookupCache::IN_USE,
+              cache.getStatus(*lease_mgr4_, subnet4_, Lease::TYPE_V4,
+                              IOAddress("192.0.2.150")));
+    EXPECT_EQ(2, cache.getPoolLeasesNum(Lease::TYPE_V4,
+                                        IOAddress("192.0.2.100")));
+
+    // The address outside of the pool doesn't affect the summary.
+    cache.invalidate(Lease::TYPE_V4, IOAddress("192.0.2.200"));
+    EXPECT_EQ(2, cache.getPoolLeasesNum(Lease::TYPE_V4,
+                                        IOAddress("192.0.2.100")));
+
+    ASSERT_TRUE(lease_mgr4_->deleteLease(IOAddress("192.0.2.150")));
+    cache.invalidate(Lease::TYPE_V4, IOAddress("192.0.2.150"));
+    EXPECT_EQ(0, cache.getPoolLeasesNum(Lease::TYPE_V4,
+                                        IOAddress("192.0.2.100")));
+    EXPECT_EQ(LeaseLookupCache::FREE,
+              cache.getStatus(*lease_mgr4_, subnet4_, Lease::TYPE_V4,
+                              IOAddress("192.0.2.150")));
+    EXPECT_EQ(1, cache.getPoolLeasesNum(Lease::TYPE_V4,
+                                        IOAddress("192.0.2.100")));
+
+    // The remembered address is dropped too.
+    EXPECT_EQ(LeaseLookupCache::IN_USE,
+              cache.getStatus(*lease_mgr4_, subnet4_, Lease::TYPE_V4,
+                              IOAddress("192.0.2.101")));
+    cache.invalidate(Lease::TYPE_V4, IOAddress("192.0.2.101"));
+    EXPECT_EQ(LeaseLookupCache::FREE,
+              cache.getStatus(*lease_mgr4_, subnet4_, Lease::TYPE_V4,
+                              IOAddress("192.0.2.101")));
+}
+
+// This test verifies that the pool summary holds only the leases of the
+// type of the pool.
+TEST_F(LeaseLookupCacheTest, status6) {
+    ASSERT_NO_FATAL_FAILURE(addLease6(Lease::TYPE_NA, "2001:db8:1::10"));
+    ASSERT_NO_FATAL_FAILURE(addLease6(Lease::TYPE_TA, "2001:db8:1::11"));
+    ASSERT_NO_FATAL_FAILURE(addLease6(Lease::TYPE_NA, "2001:db8:1::20"));
+
+    LeaseLookupCache cache;
+    EXPECT_EQ(LeaseLookupCache::IN_USE,
+              cache.getStatus(*lease_mgr6_, subnet6_, Lease::TYPE_NA,
+                              IOAddress("2001:db8:1::10")));
+    EXPECT_EQ(LeaseLookupCache::FREE,
+              cache.getStatus(*lease_mgr6_, subnet6_, Lease::TYPE_NA,
+                              IOAddress("2001:db8:1::11")));
+    EXPECT_EQ(LeaseLookupCache::IN_USE,
+              cache.getStatus(*lease_mgr6_, subnet6_, Lease::TYPE_NA,
+                              IOAddress("2001:db8:1::20")));
+    EXPECT_EQ(2, cache.getPoolLeasesNum(Lease::TYPE_NA,
+                                        IOAddress("2001:db8:1::10")));
+}
+
+// This test verifies that the pool summary spanning multiple pages of
+// leases is loaded.
+TEST_F(LeaseLookupCacheTest, multiplePages) {
+    Subnet4Ptr subnet(new Subnet4(IOAddress("10.0.0.0"), 8, 1, 2, 3, 2));
+    subnet->addPool(Pool4Ptr(new Pool4(IOAddress("10.0.0.0"), 8)));
+
+    const uint32_t leases_num = LeaseLookupCache::PAGE_SIZE * 2 + 10;
+    for (uint32_t i = 0; i < leases_num; ++i) {
+        ASSERT_NO_FATAL_FAILURE(addLease4(IOAddress(0x0A000001 + i).toText()));
+    }
+
+    LeaseLookupCache cache;
+    EXPECT_EQ(LeaseLookupCache::IN_USE,
+              cache.getStatus(*lease_mgr4_, subnet, Lease::TYPE_V4,
+                              IOAddress(0x0A000001 + leases_num - 1)));
+    EXPECT_EQ(LeaseLookupCache::FREE,
+              cache.getStatus(*lease_mgr4_, subnet, Lease::TYPE_V4,
+                              IOAddress(0x0A000001 + leases_num)));
+    EXPECT_EQ(leases_num, cache.getPoolLeasesNum(Lease::TYPE_V4,
+                                                 IOAddress("10.0.0.0")));
+}
+
+// This test verifies that the summary of a large pool is loaded over
+// several allocations.
+TEST_F(LeaseLookupCacheTest, loadLimit) {
+    Subnet4Ptr subnet(new Subnet4(IOAddress("10.0.0.0"), 8, 1, 2, 3, 2));
+    subnet->addPool(Pool4Ptr(new Pool4(IOAddress("10.0.0.0"), 8)));
+
+    const uint32_t leases_num = LeaseLookupCache::PAGE_SIZE *
+        LeaseLookupCache::MAX_LOAD_PAGES + 10;
+    for (uint32_t i = 0; i < leases_num; ++i) {
+        ASSERT_NO_FATAL_FAILURE(addLease4(IOAddress(0x0A000001 + i).toText()));
+    }
+
+    // The address must be looked up until the summary is loaded.
+    LeaseLookupCache cache;
+    cache.startAllocation();
+    EXPECT_EQ(LeaseLookupCache::UNKNOWN,
+              cache.getStatus(*lease_mgr4_, subnet, Lease::TYPE_V4,
+                              IOAddress(0x0A000001)));
+    EXPECT_EQ(LeaseLookupCache::UNKNOWN,
+              cache.getStatus(*lease_mgr4_, subnet, Lease::TYPE_V4,
+                              IOAddress(0x0A000001)));
+    EXPECT_EQ(0, cache.getPoolLeasesNum(Lease::TYPE_V4,
+                                        IOAddress("10.0.0.0")));
+
+    // The remaining leases are loaded for the next allocation.
+    cache.startAllocation();
+    EXPECT_EQ(LeaseLookupCache::IN_USE,
+              cache.getStatus(*lease_mgr4_, subnet, Lease::TYPE_V4,
+                              IOAddress(0x0A000001)));
+    EXPECT_EQ(leases_num, cache.getPoolLeasesNum(Lease::TYPE_V4,
+                                                 IOAddress("10.0.0.0")));
+}
+
+// This test verifies that the subnet is reported exhausted for the refresh
+// time, until any address is invalidated.
+TEST_F(LeaseLookupCacheTest, exhausted) {
+    LeaseLookupCache cache;
+    EXPECT_FALSE(cache.isExhausted(SubnetID(1), Lease::TYPE_V4));
+
+    cache.markExhausted(SubnetID(1), Lease::TYPE_V4);
+    EXPECT_TRUE(cache.isExhausted(SubnetID(1), Lease::TYPE_V4));
+    EXPECT_FALSE(cache.isExhausted(SubnetID(2), Lease::TYPE_V4));
+    EXPECT_FALSE(cache.isExhausted(SubnetID(1), Lease::TYPE_NA));
+
+    cache.invalidate(Lease::TYPE_V4, IOAddress("192.0.2.100"));
+    EXPECT_FALSE(cache.isExhausted(SubnetID(1), Lease::TYPE_V4));
+
+    cache.markExhausted(SubnetID(1), Lease::TYPE_V4);
+    cache.clear();
+    EXPECT_FALSE(cache.isExhausted(SubnetID(1), Lease::TYPE_V4));
+
+    // The subnet is not reported exhausted when the refresh time is 0.
+    LeaseLookupCache cache0(0, 0);
+    cache0.markExhausted(SubnetID(1), Lease::TYPE_V4);
+    EXPECT_FALSE(cache0.isExhausted(SubnetID(1), Lease::TYPE_V4));
+}
+
+}
@@ -1,4 +1,4 @@
-// Copyright (C) 2012-2015 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2012-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -179,6 +179,22 @@ public:
                   " implemented");
     }
 
+    /// @brief Returns a page of DHCPv4 leases.
+    ///
+    /// This method is not implemented.
+    virtual Lease4Collection getLeases4(const IOAddress&, const size_t) const {
+        isc_throw(NotImplemented, "ConcreteLeaseMgr::getLeases4 is not"
+                  " implemented");
+    }
+
+    /// @brief Returns a page of DHCPv6 leases.
+    ///
+    /// This method is not implemented.
+    virtual Lease6Collection getLeases6(const IOAddress&, const size_t) const {
+        isc_throw(NotImplemented, "ConcreteLeaseMgr::getLeases6 is not"
+                  " implemented");
+    }
+
     /// @brief Updates IPv4 lease.
     ///
     /// @param lease4 The lease to be updated.
@@ -0,0 +1,302 @@
+// Copyright (C) 2017 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <asiolink/io_address.h>
+#include <dhcp/duid.h>
+#include <dhcp/hwaddr.h>
+#include <dhcpsrv/alloc_engine.h>
+#include <dhcpsrv/cfg_expiration.h>
+#include <dhcpsrv/cfgmgr.h>
+#include <dhcpsrv/d2_client_mgr.h>
+#include <dhcpsrv/lease_mgr_factory.h>
+#include <dhcpsrv/lease_reclamation_worker.h>
+#include <dhcpsrv/memfile_lease_mgr.h>
+#include <exceptions/exceptions.h>
+#include <stats/stats_mgr.h>
+#include <boost/bind.hpp>
+#include <boost/shared_ptr.hpp>
+#include <gtest/gtest.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+
+using namespace isc;
+using namespace isc::asiolink;
+using namespace isc::dhcp;
+using namespace isc::stats;
+
+namespace {
+
+/// @brief Number of leases used in the tests.
+const uint16_t LEASES_NUM = 20;
+
+/// @brief Test fixture class for the @c LeaseReclamationWorker.
+class LeaseReclamationWorkerTest : public ::testing::Test {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// Creates the lease manager used by the main thread, the allocation
+    /// engine and the lease manager used by the worker.
+    LeaseReclamationWorkerTest()
+        : cfg_expiration_(true) {
+        StatsMgr::instance().removeAll();
+        LeaseMgrFactory::create("type=memfile universe=4 persist=false");
+        alloc_engine_.reset(new AllocEngine(AllocEngine::ALLOC_ITERATIVE, 100,
+                                            false));
+
+        DatabaseConnection::ParameterMap parameters;
+        parameters["type"] = "memfile";
+        parameters["universe"] = "4";
+        parameters["persist"] = "false";
+        worker_lease_mgr_.reset(new Memfile_LeaseMgr(parameters));
+
+        // Run the reclamation cycles every 1 ms.
+        cfg_expiration_.setReclaimTimerWaitTime(1);
+        cfg_expiration_.setFlushReclaimedTimerWaitTime(0);
+        cfg_expiration_.setMaxReclaimLeases(5);
+        cfg_expiration_.setMaxReclaimTime(0);
+    }
+
+    /// @brief Destructor.
+    virtual ~LeaseReclamationWorkerTest() {
+        D2ClientMgr& mgr = CfgMgr::instance().getD2ClientMgr();
+        if (mgr.amSending()) {
+            mgr.stopSender();
+            mgr.clearQueue();
+        }
+        D2ClientConfigPtr cfg(new D2ClientConfig());
+        CfgMgr::instance().setD2ClientConfig(cfg);
+        LeaseMgrFactory::destroy();
+        StatsMgr::instance().removeAll();
+    }
+
+    /// @brief Returns the lease manager used by the worker.
+    boost::shared_ptr<LeaseMgr> getConnection() {
+        return (worker_lease_mgr_);
+    }
+
+    /// @brief Throws an exception instead of opening the connection.
+    static boost::shared_ptr<LeaseMgr> failConnection() {
+        isc_throw(Unexpected, "unable to connect");
+    }
+
+    /// @brief Adds the leases to the lease database used by the worker.
+    ///
+    /// @param expired Indicates if the leases should be expired.
+    void addLeases(const bool expired) {
+        for (uint16_t i = 0; i < LEASES_NUM; ++i) {
+            std::vector<uint8_t> hwaddr_vec(6, static_cast<uint8_t>(i));
+            HWAddrPtr hwaddr(new HWAddr(hwaddr_vec, HTYPE_ETHER));
+            Lease4Ptr lease(new Lease4(IOAddress(0xC0000200 + i + 1), hwaddr,
+                                       0, 0, 60, 30, 45,
+                                       time(NULL) - (expired ? 100 : 0),
+                                       SubnetID(1), true, true,
+                                       "host.example.org."));
+            ASSERT_TRUE(worker_lease_mgr_->addLease(lease));
+        }
+    }
+
+    /// @brief Enables the DNS updates and starts the D2 client.
+    void enableDDNS() const {
+        D2ClientMgr& mgr = CfgMgr::instance().getD2ClientMgr();
+        D2ClientConfigPtr cfg(new D2ClientConfig());
+        cfg->enableUpdates(true);
+        mgr.setD2ClientConfig(cfg);
+        mgr.startSender(boost::bind(&LeaseReclamationWorkerTest::d2ErrorHandler,
+                                    _1, _2));
+    }
+
+    /// @brief No-op error handler for the D2 client.
+    static void d2ErrorHandler(const dhcp_ddns::NameChangeSender::Result,
+                               dhcp_ddns::NameChangeRequestPtr&) {
+    }
+
+    /// @brief Waits until the number of the leases reclaimed by the worker
+    /// and waiting for the main thread reaches the specified value.
+    ///
+    /// @param worker Worker to be checked.
+    /// @param leases_num Expected number of leases.
+    void waitForPendingLeases(LeaseReclamationWorker& worker,
+                              const size_t leases_num) {
+        for (int i = 0; (i < 1000) &&
+                 (worker.getPendingLeasesNum() < leases_num); ++i) {
+            usleep(1000);
+        }
+    }
+
+    /// @brief Returns the value of the integer statistic.
+    ///
+    /// @param name Name of the statistic.
+    int64_t getStat(const std::string& name) const {
+        ObservationPtr observation = StatsMgr::instance().getObservation(name);
+        return (observation ? observation->getInteger().first : 0);
+    }
+
+    /// @brief Allocation engine.
+    AllocEnginePtr alloc_engine_;
+
+    /// @brief Lease manager used by the worker.
+    boost::shared_ptr<LeaseMgr> worker_lease_mgr_;
+
+    /// @brief Configuration of the leases' reclamation.
+    CfgExpiration cfg_expiration_;
+};
+
+// This test verifies that the constructor validates its arguments.
+TEST_F(LeaseReclamationWorkerTest, constructor) {
+    EXPECT_THROW(LeaseReclamationWorker(false, AllocEnginePtr(),
+                                        cfg_expiration_),
+                 BadValue);
+    EXPECT_THROW(LeaseReclamationWorker(false, alloc_engine_, cfg_expiration_,
+                                        LeaseReclamationWorker::
+                                        ConnectionFactory()),
+                 BadValue);
+    EXPECT_NO_THROW(LeaseReclamationWorker(false, alloc_engine_,
+                                           cfg_expiration_));
+}
+
+// This test verifies that the memfile backend doesn't support additional
+// connections to the lease database.
+TEST_F(LeaseReclamationWorkerTest, memfileConnection) {
+    EXPECT_THROW(LeaseMgrFactory::createConnection(), NotImplemented);
+}
+
+// This test verifies that the failure to open the connection to the lease
+// database is reported by the start method.
+TEST_F(LeaseReclamationWorkerTest, connectionFailure) {
+    LeaseReclamationWorker worker(false, alloc_engine_, cfg_expiration_,
+                                  &LeaseReclamationWorkerTest::failConnection);
+    EXPECT_THROW(worker.start(), Unexpected);
+    EXPECT_FALSE(worker.isRunning());
+}
+
+// This test verifies that the expired leases are reclaimed by the worker
+// and the reclamation is completed by the main thread.
+TEST_F(LeaseReclamationWorkerTest, reclaimLeases) {
+    ASSERT_NO_FATAL_FAILURE(addLeases(true));
+
+    LeaseReclamationWorker worker(false, alloc_engine_, cfg_expiration_,
+        boost::bind(&LeaseReclamationWorkerTest::getConnection, this));
+    ASSERT_NO_THROW(worker.start());
+    EXPECT_TRUE(worker.isRunning());
+    EXPECT_THROW(worker.start(), InvalidOperation);
+
+    // The leases are reclaimed in at least 4 cycles of 5 leases.
+    waitForPendingLeases(worker, LEASES_NUM);
+    ASSERT_EQ(LEASES_NUM, worker.getPendingLeasesNum());
+
+    // The statistics are updated by the main thread.
+    EXPECT_EQ(0, getStat("reclaimed-leases"));
+    ASSERT_NO_THROW(worker.processReclaimedLeases());
+    EXPECT_EQ(0, worker.getPendingLeasesNum());
+    EXPECT_EQ(LEASES_NUM, getStat("reclaimed-leases"));
+    EXPECT_EQ(LEASES_NUM, getStat("subnet[1].reclaimed-leases"));
+    EXPECT_GE(getStat("reclaim-cycles"), LEASES_NUM / 5);
+    EXPECT_EQ(0, getStat("reclaim-backlog"));
+
+    worker.stop();
+    EXPECT_FALSE(worker.isRunning());
+
+    // The leases have been removed, because the flush timer is disabled.
+    Lease4Collection leases;
+    worker_lease_mgr_->getExpiredLeases4(leases, 0);
+    EXPECT_TRUE(leases.empty());
+    for (uint16_t i = 0; i < LEASES_NUM; ++i) {
+        EXPECT_FALSE(worker_lease_mgr_->getLease4(IOAddress(0xC0000200 + i + 1)));
+    }
+}
+
+// This test verifies that the DNS records are not removed for the leases
+// whose addresses have been allocated again before the main thread has
+// completed their reclamation.
+TEST_F(LeaseReclamationWorkerTest, reusedAddresses) {
+    ASSERT_NO_FATAL_FAILURE(addLeases(true));
+    ASSERT_NO_THROW(enableDDNS());
+
+    LeaseReclamationWorker worker(false, alloc_engine_, cfg_expiration_,
+        boost::bind(&LeaseReclamationWorkerTest::getConnection, this));
+    ASSERT_NO_THROW(worker.start());
+    waitForPendingLeases(worker, LEASES_NUM);
+    ASSERT_EQ(LEASES_NUM, worker.getPendingLeasesNum());
+
+    // Allocate every other address to a new client. The lease manager
+    // used by the main thread stands for the shared lease database.
+    for (uint16_t i = 0; i < LEASES_NUM; i += 2) {
+        std::vector<uint8_t> hwaddr_vec(6, 0xFF);
+        HWAddrPtr hwaddr(new HWAddr(hwaddr_vec, HTYPE_ETHER));
+        Lease4Ptr lease(new Lease4(IOAddress(0xC0000200 + i + 1), hwaddr,
+                                   0, 0, 3600, 1800, 2700, time(NULL),
+                                   SubnetID(1), true, true,
+                                   "host.example.org."));
+        ASSERT_TRUE(LeaseMgrFactory::instance().addLease(lease));
+    }
+
+    ASSERT_NO_THROW(worker.processReclaimedLeases());
+    worker.stop();
+
+    // All leases have been reclaimed, but the DNS records are removed
+    // only for the addresses which are not in use.
+    EXPECT_EQ(LEASES_NUM, getStat("reclaimed-leases"));
+    D2ClientMgr& mgr = CfgMgr::instance().getD2ClientMgr();
+    ASSERT_EQ(LEASES_NUM / 2, mgr.getQueueSize());
+    for (size_t i = 0; i < mgr.getQueueSize(); ++i) {
+        dhcp_ddns::NameChangeRequestPtr ncr = mgr.peekAt(i);
+        ASSERT_TRUE(ncr);
+        EXPECT_EQ(dhcp_ddns::CHG_REMOVE, ncr->getChangeType());
+        EXPECT_EQ(0, (IOAddress(ncr->getIpAddress()).toUint32() -
+                      0xC0000200) % 2) << ncr->getIpAddress();
+    }
+}
+
+// This test verifies that the reclaimed leases are kept in the database
+// in the expired-reclaimed state when the flush timer is enabled.
+TEST_F(LeaseReclamationWorkerTest, updateLeases) {
+    ASSERT_NO_FATAL_FAILURE(addLeases(true));
+    cfg_expiration_.setFlushReclaimedTimerWaitTime(1000);
+    cfg_expiration_.setHoldReclaimedTime(3600);
+
+    LeaseReclamationWorker worker(false, alloc_engine_, cfg_expiration_,
+        boost::bind(&LeaseReclamationWorkerTest::getConnection, this));
+    ASSERT_NO_THROW(worker.start());
+    waitForPendingLeases(worker, LEASES_NUM);
+    worker.stop();
+
+    // Stopping the worker completes the reclamation.
+    EXPECT_EQ(0, worker.getPendingLeasesNum());
+    EXPECT_EQ(LEASES_NUM, getStat("reclaimed-leases"));
+
+    for (uint16_t i = 0; i < LEASES_NUM; ++i) {
+        Lease4Ptr lease = worker_lease_mgr_->getLease4(IOAddress(0xC0000200 + i + 1));
+        ASSERT_TRUE(lease);
+        EXPECT_TRUE(lease->stateExpiredReclaimed());
+        EXPECT_TRUE(lease->hostname_.empty());
+        EXPECT_FALSE(lease->fqdn_fwd_);
+        EXPECT_FALSE(lease->fqdn_rev_);
+    }
+}
+
+// This test verifies that the leases which are not expired are left alone.
+TEST_F(LeaseReclamationWorkerTest, validLeases) {
+    ASSERT_NO_FATAL_FAILURE(addLeases(false));
+
+    LeaseReclamationWorker worker(false, alloc_engine_, cfg_expiration_,
+        boost::bind(&LeaseReclamationWorkerTest::getConnection, this));
+    ASSERT_NO_THROW(worker.start());
+    usleep(20000);
+    worker.stop();
+
+    EXPECT_EQ(0, getStat("reclaimed-leases"));
+    for (uint16_t i = 0; i < LEASES_NUM; ++i) {
+        Lease4Ptr lease = worker_lease_mgr_->getLease4(IOAddress(0xC0000200 + i + 1));
+        ASSERT_TRUE(lease);
+        EXPECT_EQ(Lease::STATE_DEFAULT, lease->state_);
+    }
+}
+
+}
@@ -0,0 +1,195 @@
+// Copyright (C) 2017 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <dhcp/dhcp4.h>
+#include <dhcp/option.h>
+#include <dhcp/option_space.h>
+#include <dhcpsrv/cfg_option.h>
+#include <dhcpsrv/cfgmgr.h>
+#include <dhcpsrv/packed_option_cache.h>
+#include <util/buffer.h>
+#include <gtest/gtest.h>
+#include <vector>
+
+using namespace isc;
+using namespace isc::dhcp;
+using namespace isc::util;
+
+namespace {
+
+/// @brief Test fixture class for @c PackedOptionCache.
+class PackedOptionCacheTest : public ::testing::Test {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// Creates the configured option containers: the "subnet" container
+    /// holding options 1 and 2 and the "global" container holding
+    /// options 2 and 3.
+    PackedOptionCacheTest()
+        : subnet_(new CfgOption()), global_(new CfgOption()) {
+        CfgMgr::instance().clear();
+
+        subnet_->add(createOption(1, 0x11), false, DHCP4_OPTION_SPACE);
+        subnet_->add(createOption(2, 0x12), false, DHCP4_OPTION_SPACE);
+        global_->add(createOption(2, 0x22), false, DHCP4_OPTION_SPACE);
+        global_->add(createOption(3, 0x23), false, DHCP4_OPTION_SPACE);
+
+        co_list_.push_back(subnet_);
+        co_list_.push_back(global_);
+    }
+
+    /// @brief Destructor.
+    virtual ~PackedOptionCacheTest() {
+        CfgMgr::instance().clear();
+    }
+
+    /// @brief Creates an option with a single byte of data.
+    ///
+    /// @param code Option code.
+    /// @param value Option data.
+    OptionPtr createOption(const uint16_t code, const uint8_t value) const {
+        return (OptionPtr(new Option(Option::V4, code,
+                                     OptionBuffer(1, value))));
+    }
+
+    /// @brief Checks that the wire data of the option is correct.
+    ///
+    /// @param option Option along with its wire data.
+    /// @param code Expected option code.
+    /// @param value Expected option data.
+    void checkOption(const PackedOption& option, const uint8_t code,
+                     const uint8_t value) const {
+        ASSERT_TRUE(option.option_);
+        EXPECT_EQ(code, option.option_->getType());
+        ASSERT_TRUE(option.wire_data_);
+        ASSERT_EQ(3, option.wire_data_->size());
+        EXPECT_EQ(code, (*option.wire_data_)[0]);
+        EXPECT_EQ(1, (*option.wire_data_)[1]);
+        EXPECT_EQ(value, (*option.wire_data_)[2]);
+    }
+
+    /// @brief Creates the vector of option codes.
+    ///
+    /// @param first First code.
+    /// @param second Second code.
+    /// @param third Third code.
+    std::vector<uint16_t> codes(const uint16_t first, const uint16_t second,
+                                const uint16_t third) const {
+        std::vector<uint16_t> result;
+        result.push_back(first);
+        result.push_back(second);
+        result.push_back(third);
+        return (result);
+    }
+
+    /// @brief Subnet specific options.
+    CfgOptionPtr subnet_;
+
+    /// @brief Global options.
+    CfgOptionPtr global_;
+
+    /// @brief List of the option containers.
+    CfgOptionList co_list_;
+};
+
+// This test verifies that the options are taken from the first container
+// holding them, in the order of the requested codes.
+TEST_F(PackedOptionCacheTest, get) {
+    PackedOptionCache cache;
+    ConstPackedOptionListPtr options;
+    ASSERT_NO_THROW(options = cache.get(co_list_, DHCP4_OPTION_SPACE,
+                                        codes(3, 4, 2)));
+    ASSERT_TRUE(options);
+
+    // The option 4 is not configured.
+    ASSERT_EQ(2, options->size());
+    checkOption((*options)[0], 3, 0x23);
+    // The subnet specific option takes precedence.
+    checkOption((*options)[1], 2, 0x12);
+    EXPECT_EQ(subnet_->get(DHCP4_OPTION_SPACE, 2).option_,
+              (*options)[1].option_);
+
+    // The wire data match the packed option.
+    OutputBuffer buf(0);
+    (*options)[1].option_->pack(buf);
+    ASSERT_EQ(buf.getLength(), (*options)[1].wire_data_->size());
+    EXPECT_EQ(0, memcmp(buf.getData(), &(*(*options)[1].wire_data_)[0],
+                        buf.getLength()));
+
+    // No options found in the other option space.
+    ASSERT_NO_THROW(options = cache.get(co_list_, "foo", codes(1, 2, 3)));
+    ASSERT_TRUE(options);
+    EXPECT_TRUE(options->empty());
+}
+
+// This test verifies that the entries are reused for the same parameters.
+TEST_F(PackedOptionCacheTest, reuse) {
+    PackedOptionCache cache;
+    ConstPackedOptionListPtr options1 = cache.get(co_list_, DHCP4_OPTION_SPACE,
+                                                  codes(1, 2, 3));
+    EXPECT_EQ(1, cache.size());
+
+    // The same entry is returned for the same parameters.
+    EXPECT_EQ(options1, cache.get(co_list_, DHCP4_OPTION_SPACE,
+                                  codes(1, 2, 3)));
+    EXPECT_EQ(1, cache.size());
+
+    // The different order of codes results in a different entry.
+    ConstPackedOptionListPtr options2 = cache.get(co_list_, DHCP4_OPTION_SPACE,
+                                                  codes(3, 2, 1));
+    EXPECT_NE(options1, options2);
+    EXPECT_EQ(2, cache.size());
+
+    // The different list of the containers results in a different entry.
+    CfgOptionList co_list;
+    co_list.push_back(global_);
+    co_list.push_back(subnet_);
+    ConstPackedOptionListPtr options3 = cache.get(co_list, DHCP4_OPTION_SPACE,
+                                                  codes(1, 2, 3));
+    EXPECT_NE(options1, options3);
+    EXPECT_EQ(3, cache.size());
+    ASSERT_EQ(3, options3->size());
+    checkOption((*options3)[1], 2, 0x22);
+
+    cache.clear();
+    EXPECT_EQ(0, cache.size());
+    EXPECT_NE(options1, cache.get(co_list_, DHCP4_OPTION_SPACE,
+                                  codes(1, 2, 3)));
+}
+
+// This test verifies that the cache is cleared when the configuration
+// is committed.
+TEST_F(PackedOptionCacheTest, reconfigure) {
+    PackedOptionCache cache;
+    ConstPackedOptionListPtr options = cache.get(co_list_, DHCP4_OPTION_SPACE,
+                                                 codes(1, 2, 3));
+    cache.get(co_list_, DHCP4_OPTION_SPACE, codes(1, 2, 2));
+    EXPECT_EQ(2, cache.size());
+
+    // Create the new configuration and commit it.
+    ASSERT_TRUE(CfgMgr::instance().getStagingCfg());
+    CfgMgr::instance().commit();
+
+    EXPECT_NE(options, cache.get(co_list_, DHCP4_OPTION_SPACE,
+                                 codes(1, 2, 3)));
+    EXPECT_EQ(1, cache.size());
+}
+
+// This test verifies that the number of entries is limited.
+TEST_F(PackedOptionCacheTest, maxEntries) {
+    PackedOptionCache cache;
+    for (size_t i = 0; i < PackedOptionCache::MAX_ENTRIES; ++i) {
+        cache.get(co_list_, DHCP4_OPTION_SPACE, codes(1, 2, 1000 + i));
+    }
+    EXPECT_EQ(PackedOptionCache::MAX_ENTRIES, cache.size());
+
+    cache.get(co_list_, DHCP4_OPTION_SPACE, codes(1, 2, 3));
+    EXPECT_EQ(1, cache.size());
+}
+
+}
@@ -0,0 +1,282 @@
+// Copyright (C) 2017 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <cc/data.h>
+#include <dhcpsrv/cfgmgr.h>
+#include <dhcpsrv/cfg_hosts.h>
+#include <dhcpsrv/host.h>
+#include <dhcpsrv/subnet_id.h>
+#include <dhcpsrv/parsers/dhcp_config_parser.h>
+#include <dhcpsrv/parsers/host_reservation_parser.h>
+#include <dhcpsrv/parsers/host_reservations_list_parser.h>
+#include <dhcpsrv/parsers/parallel_host_reservations_parser.h>
+#include <gtest/gtest.h>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace isc::data;
+using namespace isc::dhcp;
+
+namespace {
+
+/// @brief Number of subnets used in the tests.
+const SubnetID SUBNETS_NUM = 8;
+
+/// @brief Number of reservations per subnet used in the tests.
+const size_t RESERVATIONS_NUM = 200;
+
+/// @brief Test fixture class for @c ParallelHostReservationsParser.
+class ParallelHostReservationsParserTest : public ::testing::Test {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// Clears the configuration in the @c CfgMgr.
+    ParallelHostReservationsParserTest() {
+        CfgMgr::instance().clear();
+    }
+
+    /// @brief Destructor.
+    ///
+    /// Clears the configuration in the @c CfgMgr.
+    virtual ~ParallelHostReservationsParserTest() {
+        CfgMgr::instance().clear();
+    }
+
+    /// @brief Creates the list of the IPv4 reservations for the subnet.
+    ///
+    /// Every fourth reservation includes an option.
+    ///
+    /// @param subnet_id Identifier of the subnet.
+    /// @param invalid Index of the reservation with invalid address or
+    /// a value greater than the number of reservations.
+    /// @param duplicate Index of the reservation using the same HW address
+    /// as the first reservation or 0.
+    ElementPtr createReservations4(const SubnetID& subnet_id,
+                                   const size_t invalid = RESERVATIONS_NUM,
+                                   const size_t duplicate = 0) const {
+        std::ostringstream s;
+        s << "[";
+        for (size_t i = 0; i < RESERVATIONS_NUM; ++i) {
+            const size_t hw = (i == duplicate ? 0 : i);
+            s << (i > 0 ? ", " : "")
+              << "{ \"hw-address\": \"01:02:" << std::hex << std::setfill('0')
+              << std::setw(2) << subnet_id << ":" << std::setw(2) << (hw >> 8)
+              << ":" << std::setw(2) << (hw & 0xFF) << ":06\"" << std::dec
+              << ", \"ip-address\": \"";
+            if (i == invalid) {
+                s << "foo";
+            } else {
+                s << "10." << subnet_id << "." << (i >> 8) << "." << (i & 0xFF);
+            }
+            s << "\", \"hostname\": \"host" << i << ".example.org\"";
+            if (i % 4 == 0) {
+                s << ", \"option-data\": [ { \"name\": \"domain-name-servers\","
+                  << " \"data\": \"192.0.2." << (i % 250) << "\" } ]";
+            }
+            s << " }";
+        }
+        s << "]";
+        return (Element::fromJSON(s.str()));
+    }
+
+    /// @brief Creates the list of the IPv6 reservations for the subnet.
+    ///
+    /// @param subnet_id Identifier of the subnet.
+    ElementPtr createReservations6(const SubnetID& subnet_id) const {
+        std::ostringstream s;
+        s << "[";
+        for (size_t i = 0; i < RESERVATIONS_NUM; ++i) {
+            s << (i > 0 ? ", " : "")
+              << "{ \"duid\": \"01:02:03:" << std::hex << std::setfill('0')
+              << std::setw(2) << subnet_id << ":" << std::setw(2) << (i >> 8)
+              << ":" << std::setw(2) << (i & 0xFF) << "\""
+              << ", \"ip-addresses\": [ \"2001:db8:" << subnet_id << "::" << i
+              << "\" ], \"prefixes\": [ \"3000:" << subnet_id << ":" << i
+              << "::/64\" ]" << std::dec
+              << ", \"option-data\": [ { \"name\": \"dns-servers\","
+              << " \"data\": \"2001:db8::1\" } ] }";
+        }
+        s << "]";
+        return (Element::fromJSON(s.str()));
+    }
+
+    /// @brief Returns textual representation of the hosts in the staging
+    /// configuration, in the order in which they have been added.
+    ///
+    /// @param v4 Indicates if the IPv4 or IPv6 subnets should be checked.
+    std::vector<std::string> getHosts(const bool v4) const {
+        std::vector<std::string> hosts_text;
+        CfgHostsPtr cfg_hosts = CfgMgr::instance().getStagingCfg()->getCfgHosts();
+        for (SubnetID subnet_id = 1; subnet_id <= SUBNETS_NUM; ++subnet_id) {
+            HostCollection hosts = (v4 ? cfg_hosts->getAll4(subnet_id) :
+                                    cfg_hosts->getAll6(subnet_id));
+            for (HostCollection::const_iterator host = hosts.begin();
+                 host != hosts.end(); ++host) {
+                hosts_text.push_back((*host)->toText());
+            }
+        }
+        return (hosts_text);
+    }
+
+    /// @brief Parses the reservations sequentially and in parallel and
+    /// checks that the results are the same.
+    ///
+    /// @param lists Lists of reservations, one per subnet.
+    /// @param [out] error Error reported by the parsers or empty string.
+    void checkParse(const std::vector<ElementPtr>& lists, std::string& error) {
+        std::string sequential_error;
+        try {
+            for (size_t i = 0; i < lists.size(); ++i) {
+                HostReservationsListParser<HostReservationParser4> parser;
+                parser.parse(SubnetID(i + 1), lists[i]);
+            }
+        } catch (const DhcpConfigError& ex) {
+            sequential_error = ex.what();
+        }
+        std::vector<std::string> sequential_hosts = getHosts(true);
+
+        CfgMgr::instance().clear();
+
+        ParallelHostReservationsParser parser(&ParallelHostReservationsParser::
+                                              parseHost<HostReservationParser4>,
+                                              4);
+        for (size_t i = 0; i < lists.size(); ++i) {
+            parser.add(SubnetID(i + 1), lists[i]);
+        }
+        EXPECT_EQ(lists.size() * RESERVATIONS_NUM, parser.size());
+
+        error.clear();
+        try {
+            parser.parse();
+        } catch (const DhcpConfigError& ex) {
+            error = ex.what();
+        }
+        EXPECT_EQ(0, parser.size());
+        EXPECT_EQ(sequential_error, error);
+        EXPECT_TRUE(sequential_hosts == getHosts(true));
+    }
+};
+
+// This test verifies that the IPv4 reservations are parsed and added to
+// the configuration in the same order as by the sequential parser.
+TEST_F(ParallelHostReservationsParserTest, parse4) {
+    std::vector<ElementPtr> lists;
+    for (SubnetID subnet_id = 1; subnet_id <= SUBNETS_NUM; ++subnet_id) {
+        lists.push_back(createReservations4(subnet_id));
+    }
+    std::string error;
+    ASSERT_NO_FATAL_FAILURE(checkParse(lists, error));
+    EXPECT_TRUE(error.empty()) << error;
+    EXPECT_EQ(SUBNETS_NUM * RESERVATIONS_NUM, getHosts(true).size());
+}
+
+// This test verifies that the IPv6 reservations are parsed.
+TEST_F(ParallelHostReservationsParserTest, parse6) {
+    ParallelHostReservationsParser parser(&ParallelHostReservationsParser::
+                                          parseHost<HostReservationParser6>,
+                                          4);
+    for (SubnetID subnet_id = 1; subnet_id <= SUBNETS_NUM; ++subnet_id) {
+        parser.add(subnet_id, createReservations6(subnet_id));
+    }
+    ASSERT_NO_THROW(parser.parse());
+
+    std::vector<std::string> hosts = getHosts(false);
+    ASSERT_EQ(SUBNETS_NUM * RESERVATIONS_NUM, hosts.size());
+    EXPECT_NE(std::string::npos, hosts[0].find("2001:db8:1::"));
+    EXPECT_NE(std::string::npos, hosts.back().find("3000:8:c7::/64"));
+}
+
+// This test verifies that the error of the first invalid reservation is
+// reported and the reservations following it are not added.
+TEST_F(ParallelHostReservationsParserTest, invalidReservation) {
+    std::vector<ElementPtr> lists;
+    for (SubnetID subnet_id = 1; subnet_id <= SUBNETS_NUM; ++subnet_id) {
+        lists.push_back(createReservations4(subnet_id,
+                                            subnet_id == 3 ? 150 :
+                                            (subnet_id == 6 ? 10 :
+                                             RESERVATIONS_NUM)));
+    }
+    std::string error;
+    ASSERT_NO_FATAL_FAILURE(checkParse(lists, error));
+    EXPECT_NE(std::string::npos, error.find("foo")) << error;
+    EXPECT_EQ(2 * RESERVATIONS_NUM + 150, getHosts(true).size());
+}
+
+// This test verifies that the error of adding the duplicated host is
+// reported.
+TEST_F(ParallelHostReservationsParserTest, duplicatedReservation) {
+    std::vector<ElementPtr> lists;
+    for (SubnetID subnet_id = 1; subnet_id <= SUBNETS_NUM; ++subnet_id) {
+        lists.push_back(createReservations4(subnet_id, RESERVATIONS_NUM,
+                                            subnet_id == 5 ? 100 : 0));
+    }
+    std::string error;
+    ASSERT_NO_FATAL_FAILURE(checkParse(lists, error));
+    EXPECT_FALSE(error.empty());
+    EXPECT_EQ(4 * RESERVATIONS_NUM + 100, getHosts(true).size());
+}
+
+// This test verifies that the queued hosts are copied to the configuration
+// in order with the parsed reservations.
+TEST_F(ParallelHostReservationsParserTest, addHosts) {
+    // Parse the reservations for the subnet 2 and take the hosts.
+    HostReservationsListParser<HostReservationParser4> list_parser;
+    ASSERT_NO_THROW(list_parser.parse(SubnetID(2), createReservations4(2)));
+    HostCollection parsed = CfgMgr::instance().getStagingCfg()->
+        getCfgHosts()->getAll4(SubnetID(2));
+    ConstHostCollection hosts(parsed.begin(), parsed.end());
+    ASSERT_EQ(RESERVATIONS_NUM, hosts.size());
+    CfgMgr::instance().clear();
+
+    ParallelHostReservationsParser parser(&ParallelHostReservationsParser::
+                                          parseHost<HostReservationParser4>,
+                                          4);
+    parser.add(SubnetID(1), createReservations4(1));
+    parser.add(hosts);
+    parser.add(SubnetID(3), createReservations4(3));
+    ASSERT_NO_THROW(parser.parse());
+
+    HostCollection copied = CfgMgr::instance().getStagingCfg()->
+        getCfgHosts()->getAll4(SubnetID(2));
+    ASSERT_EQ(hosts.size(), copied.size());
+    for (size_t i = 0; i < hosts.size(); ++i) {
+        // The hosts are copied.
+        EXPECT_NE(hosts[i], copied[i]);
+        EXPECT_EQ(hosts[i]->toText(), copied[i]->toText());
+    }
+    EXPECT_EQ(3 * RESERVATIONS_NUM,
+              CfgMgr::instance().getStagingCfg()->getCfgHosts()->
+              getAll4(SubnetID(1)).size() + copied.size() +
+              CfgMgr::instance().getStagingCfg()->getCfgHosts()->
+              getAll4(SubnetID(3)).size());
+}
+
+// This test verifies that the number of threads is set.
+TEST_F(ParallelHostReservationsParserTest, threadsNum) {
+    ParallelHostReservationsParser parser(&ParallelHostReservationsParser::
+                                          parseHost<HostReservationParser4>);
+    EXPECT_GE(parser.getThreadsNum(), 1);
+    EXPECT_LE(parser.getThreadsNum(),
+              ParallelHostReservationsParser::MAX_THREADS);
+
+    // Few reservations are parsed by the calling thread.
+    ElementPtr list = Element::fromJSON("[ { \"hw-address\": \"01:02:03:04:05:06\","
+                                        " \"ip-address\": \"192.0.2.1\" } ]");
+    parser.add(SubnetID(1), list);
+    ASSERT_NO_THROW(parser.parse());
+    EXPECT_EQ(1, CfgMgr::instance().getStagingCfg()->getCfgHosts()->
+              getAll4(SubnetID(1)).size());
+
+    // Nothing to do if there is nothing queued.
+    EXPECT_NO_THROW(parser.parse());
+}
+
+}
@@ -1,4 +1,4 @@
-// Copyright (C) 2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2016-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -487,4 +487,19 @@ TEST_F(PgSqlHostDataSourceTest, messageFields) {
     testMessageFields4();
 }
 
+// This test checks that the IPv4 host can be deleted by address.
+TEST_F(PgSqlHostDataSourceTest, deleteByAddr4) {
+    testDeleteByAddr4();
+}
+
+// This test checks that the IPv4 host can be deleted by identifier.
+TEST_F(PgSqlHostDataSourceTest, deleteById4) {
+    testDeleteById4();
+}
+
+// This test checks that the IPv6 host can be deleted by identifier.
+TEST_F(PgSqlHostDataSourceTest, deleteById6) {
+    testDeleteById6();
+}
+
 }; // Of anonymous namespace
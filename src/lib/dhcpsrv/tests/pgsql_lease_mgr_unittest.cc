@@ -1,4 +1,4 @@
-// Copyright (C) 2014-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2014-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -402,6 +402,16 @@ TEST_F(PgSqlLeaseMgrTest, getExpiredLeases6) {
     testGetExpiredLeases6();
 }
 
+/// @brief Checks that all DHCPv4 leases can be retrieved in pages.
+TEST_F(PgSqlLeaseMgrTest, getLeases4Paged) {
+    testGetLeases4Paged();
+}
+
+/// @brief Checks that all DHCPv6 leases can be retrieved in pages.
+TEST_F(PgSqlLeaseMgrTest, getLeases6Paged) {
+    testGetLeases6Paged();
+}
+
 // Verifies that IPv4 lease statistics can be recalculated.
 TEST_F(PgSqlLeaseMgrTest, recountLeaseStats4) {
     testRecountLeaseStats4();
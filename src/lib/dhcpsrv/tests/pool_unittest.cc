@@ -1,4 +1,4 @@
-// Copyright (C) 2012-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2012-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -74,6 +74,10 @@ TEST(Pool4Test, in_range) {
    EXPECT_FALSE(pool1.inRange(IOAddress("192.0.2.255")));
    EXPECT_FALSE(pool1.inRange(IOAddress("255.255.255.255")));
    EXPECT_FALSE(pool1.inRange(IOAddress("0.0.0.0")));
+
+   // Addresses of the other family are never in range.
+   EXPECT_FALSE(pool1.inRange(IOAddress("::")));
+   EXPECT_FALSE(pool1.inRange(IOAddress("2001:db8::1")));
 }
 
 // Checks if the number of possible leases in range is reported correctly.
@@ -179,6 +183,18 @@ TEST(Pool6Test, in_range) {
    EXPECT_TRUE(pool1.inRange(IOAddress("2001:db8:1::f")));
    EXPECT_FALSE(pool1.inRange(IOAddress("2001:db8:1::10")));
    EXPECT_FALSE(pool1.inRange(IOAddress("::")));
+
+   // Addresses of the other family are never in range.
+   EXPECT_FALSE(pool1.inRange(IOAddress("0.0.0.1")));
+   EXPECT_FALSE(pool1.inRange(IOAddress("255.255.255.255")));
+
+   // The range spanning both 64-bit halves of the address.
+   Pool6 pool2(Lease::TYPE_NA, IOAddress("2001:db8:1::ffff:ffff:ffff:fff0"),
+               IOAddress("2001:db8:1:1::f"));
+   EXPECT_TRUE(pool2.inRange(IOAddress("2001:db8:1:0:ffff:ffff:ffff:ffff")));
+   EXPECT_TRUE(pool2.inRange(IOAddress("2001:db8:1:1::")));
+   EXPECT_FALSE(pool2.inRange(IOAddress("2001:db8:1::ffff:ffff:ffff:ffef")));
+   EXPECT_FALSE(pool2.inRange(IOAddress("2001:db8:1:1::10")));
 }
 
 // Checks that Prefix Delegation pools are handled properly
@@ -1,4 +1,4 @@
-// Copyright (C) 2010-2015 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2010-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -11,14 +11,18 @@
 #include <exceptions/exceptions.h>
 
 #include <cryptolink/cryptolink.h>
+#include <cryptolink/crypto_hmac.h>
 
 #include <dns/tsigkey.h>
 
 #include <dns/tests/unittest_util.h>
 #include <util/unittests/wiredata.h>
 
+#include <boost/shared_ptr.hpp>
+
 using namespace std;
 using namespace isc::dns;
+using namespace isc::cryptolink;
 using isc::UnitTestUtil;
 using isc::util::unittests::matchWireData;
 
@@ -155,6 +159,38 @@ TEST_F(TSIGKeyTest, assignment) {
     compareTSIGKeys(original, copy);
 }
 
+TEST_F(TSIGKeyTest, createHMAC) {
+    const TSIGKey key(key_name, TSIGKey::HMACSHA256_NAME(),
+                      secret.c_str(), secret.size());
+
+    boost::shared_ptr<HMAC> expected(
+        CryptoLink::getCryptoLink().createHMAC(secret.c_str(), secret.size(),
+                                               SHA256),
+        deleteHMAC);
+    expected->update("some data", 9);
+    const vector<uint8_t> expected_sig =
+        expected->sign(expected->getOutputLength());
+
+    // Each HMAC object starts from the keyed state, including the ones
+    // of the copies of the key.
+    for (int i = 0; i < 2; ++i) {
+        boost::shared_ptr<HMAC> hmac(key.createHMAC(), deleteHMAC);
+        EXPECT_EQ(SHA256, hmac->getHashAlgorithm());
+        hmac->update("some data", 9);
+        EXPECT_TRUE(expected_sig == hmac->sign(hmac->getOutputLength()));
+    }
+    const TSIGKey copy(key);
+    boost::shared_ptr<HMAC> hmac(copy.createHMAC(), deleteHMAC);
+    hmac->update("some data", 9);
+    EXPECT_TRUE(hmac->verify(&expected_sig[0], expected_sig.size()));
+
+    // A key without a secret can't sign.
+    const TSIGKey empty_key(key_name, TSIGKey::HMACSHA256_NAME(), NULL, 0);
+    EXPECT_THROW(empty_key.createHMAC(), BadKey);
+    const TSIGKey unknown_key(key_name, Name("unknown-alg"), NULL, 0);
+    EXPECT_THROW(unknown_key.createHMAC(), UnsupportedAlgorithm);
+}
+
 class TSIGKeyRingTest : public ::testing::Test {
 protected:
     TSIGKeyRingTest() :
@@ -1,4 +1,4 @@
-// Copyright (C) 2011-2015 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2011-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -67,10 +67,7 @@ struct TSIGContext::TSIGContextImpl {
             // it at this moment; a subsequent sign/verify operation will try
             // to create the HMAC, which would also fail.
             try {
-                hmac_.reset(CryptoLink::getCryptoLink().createHMAC(
-                                key_.getSecret(), key_.getSecretLength(),
-                                key_.getAlgorithm()),
-                                deleteHMAC);
+                hmac_.reset(key_.createHMAC(), deleteHMAC);
             } catch (const isc::Exception&) {
                 return;
             }
@@ -117,17 +114,15 @@ struct TSIGContext::TSIGContextImpl {
     // has been successfully created in the constructor, return it; otherwise
     // create a new one and return it.  In the former case, the ownership is
     // transferred to the caller; the stored HMAC will be reset after the
-    // call.
+    // call.  The new objects are cloned from the pre-keyed HMAC object of
+    // the key, which is much cheaper than deriving them from the secret.
     HMACPtr createHMAC() {
         if (hmac_) {
             HMACPtr ret = HMACPtr();
             ret.swap(hmac_);
             return (ret);
         }
-        return (HMACPtr(CryptoLink::getCryptoLink().createHMAC(
-                            key_.getSecret(), key_.getSecretLength(),
-                            key_.getAlgorithm()),
-                        deleteHMAC));
+        return (HMACPtr(key_.createHMAC(), deleteHMAC));
     }
 
     // The following three are helper methods to compute the digest for
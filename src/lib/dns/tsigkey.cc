@@ -1,4 +1,4 @@
-// Copyright (C) 2010-2015 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2010-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -12,12 +12,14 @@
 #include <exceptions/exceptions.h>
 
 #include <cryptolink/cryptolink.h>
+#include <cryptolink/crypto_hmac.h>
 
 #include <dns/name.h>
 #include <util/encode/base64.h>
 #include <dns/tsigkey.h>
 
 #include <boost/lexical_cast.hpp>
+#include <boost/shared_ptr.hpp>
 
 using namespace std;
 using namespace isc::cryptolink;
@@ -61,7 +63,7 @@ TSIGKey::TSIGKeyImpl {
 
         key_name_(key_name), algorithm_name_(algorithm_name),
         algorithm_(algorithm), digestbits_(digestbits),
-        secret_()
+        secret_(), hmac_()
     {
         // Convert the key and algorithm names to the canonical form.
         key_name_.downcase();
@@ -78,7 +80,8 @@ TSIGKey::TSIGKeyImpl {
         key_name_(key_name), algorithm_name_(algorithm_name),
         algorithm_(algorithm), digestbits_(digestbits),
         secret_(static_cast<const uint8_t*>(secret),
-                static_cast<const uint8_t*>(secret) + secret_len)
+                static_cast<const uint8_t*>(secret) + secret_len),
+        hmac_()
     {
         // Convert the key and algorithm names to the canonical form.
         key_name_.downcase();
@@ -86,12 +89,26 @@ TSIGKey::TSIGKeyImpl {
             algorithm_name_ = TSIGKey::HMACMD5_NAME();
         }
         algorithm_name_.downcase();
+
+        // Pre-create the keyed HMAC object which createHMAC() clones.
+        // If it fails (e.g. the algorithm is not supported by the crypto
+        // library) createHMAC() creates the object from the secret and
+        // the caller gets the exception then.
+        try {
+            hmac_.reset(CryptoLink::getCryptoLink().createHMAC(
+                            &secret_[0], secret_.size(), algorithm_),
+                        deleteHMAC);
+        } catch (const isc::Exception&) {
+            hmac_.reset();
+        }
     }
     Name key_name_;
     Name algorithm_name_;
     const isc::cryptolink::HashAlgorithm algorithm_;
     size_t digestbits_;
     const vector<uint8_t> secret_;
+    // The keyed HMAC object cloned by createHMAC(), shared by the copies.
+    boost::shared_ptr<const HMAC> hmac_;
 };
 
 TSIGKey::TSIGKey(const Name& key_name, const Name& algorithm_name,
@@ -256,6 +273,16 @@ TSIGKey::toText() const {
     }
 }
 
+HMAC*
+TSIGKey::createHMAC() const {
+    if (impl_->hmac_) {
+        return (impl_->hmac_->clone());
+    }
+    return (CryptoLink::getCryptoLink().createHMAC(getSecret(),
+                                                   getSecretLength(),
+                                                   getAlgorithm()));
+}
+
 const
 Name& TSIGKey::HMACMD5_NAME() {
     static Name alg_name("hmac-md5.sig-alg.reg.int");
@@ -1,4 +1,4 @@
-// Copyright (C) 2010-2015 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2010-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -202,6 +202,32 @@ public:
     /// \return The string representation of the given TSIGKey.
     std::string toText() const;
 
+    /// \brief Create an HMAC object to sign or verify a message.
+    ///
+    /// The returned object is keyed with the secret of this key and is
+    /// ready to be fed the data to sign or verify.
+    ///
+    /// The key creates an HMAC object when it is constructed and returns
+    /// a clone of it (see \c isc::cryptolink::HMAC::clone()), so the
+    /// hash algorithm lookup and the derivation of the keyed state from
+    /// the secret are done once per key rather than once per message.
+    /// The copies of a key share that object.  If it couldn't be created,
+    /// e.g. because the secret is empty, a new HMAC object is created with
+    /// \c isc::cryptolink::CryptoLink::createHMAC(), which throws the
+    /// appropriate exception.
+    ///
+    /// The caller is responsible for deleting the returned object with
+    /// \c isc::cryptolink::deleteHMAC().
+    ///
+    /// \exception isc::cryptolink::UnsupportedAlgorithm if the algorithm
+    /// of the key is unknown or not supported by the crypto library
+    /// \exception isc::cryptolink::BadKey if the secret is empty
+    /// \exception isc::cryptolink::LibraryError if there was any
+    /// unexpected exception in the crypto library
+    ///
+    /// \return A pointer to the new HMAC object
+    isc::cryptolink::HMAC* createHMAC() const;
+
     ///
     /// \name Well known algorithm names as defined in RFC2845 and RFC4635.
     ///
@@ -0,0 +1,119 @@
+// Copyright (C) 2017 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+/// @file request_parser_bench.cc
+///
+/// Measures the throughput of the @c HttpRequestParser for the HTTP POST
+/// requests carrying JSON commands:
+/// - a small request, typical for most of the control commands,
+/// - a large request, typical for the config-set command carrying the
+///   configuration of a big deployment.
+/// The request is delivered to the parser in chunks of the size read by
+/// the @c HttpConnection from the socket. The body is not interpreted as
+/// JSON, so as only the parser is measured. The number of requests and
+/// megabytes parsed per second is printed.
+
+#include <config.h>
+#include <http/post_request.h>
+#include <http/request_parser.h>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/lexical_cast.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+using namespace isc::http;
+
+namespace {
+
+/// @brief Size of the chunks in which the request is delivered.
+const size_t CHUNK_SIZE = 4096;
+
+/// @brief Creates a HTTP POST request with the JSON body.
+///
+/// @param body_size Approximate size of the body.
+/// @return Text of the request.
+std::string
+createRequest(const size_t body_size) {
+    std::string body = "{ \"command\": \"config-set\", \"arguments\": [ ";
+    for (size_t i = 0; body.size() < body_size; ++i) {
+        body += (i > 0 ? ", " : "");
+        body += "{ \"subnet\": \"192.0." + boost::lexical_cast<std::string>(i % 256)
+            + ".0/24\", \"id\": " + boost::lexical_cast<std::string>(i) + " }";
+    }
+    body += " ] }";
+
+    return ("POST /foo/bar HTTP/1.1\r\n"
+            "Host: 127.0.0.1:8000\r\n"
+            "User-Agent: kea-bench\r\n"
+            "Accept: application/json\r\n"
+            "Content-Type: application/json\r\n"
+            "Content-Length: " + boost::lexical_cast<std::string>(body.size()) +
+            "\r\n\r\n" + body);
+}
+
+/// @brief Parses the request delivered in chunks.
+///
+/// @param request_text Text of the request.
+/// @return true if the request was parsed successfully.
+bool
+parse(const std::string& request_text) {
+    PostHttpRequest request;
+    HttpRequestParser parser(request);
+    parser.initModel();
+    for (size_t pos = 0; pos < request_text.size(); pos += CHUNK_SIZE) {
+        parser.postBuffer(request_text.c_str() + pos,
+                          std::min(CHUNK_SIZE, request_text.size() - pos));
+        parser.poll();
+    }
+    return (parser.httpParseOk());
+}
+
+/// @brief Runs the benchmark for the request.
+///
+/// @param name Name of the benchmark.
+/// @param request_text Text of the request.
+/// @param requests Number of requests to parse.
+void
+benchmark(const std::string& name, const std::string& request_text,
+          const size_t requests) {
+    size_t result = 0;
+    boost::posix_time::ptime start =
+        boost::posix_time::microsec_clock::universal_time();
+    for (size_t i = 0; i < requests; ++i) {
+        if (parse(request_text)) {
+            ++result;
+        }
+    }
+    boost::posix_time::time_duration elapsed =
+        boost::posix_time::microsec_clock::universal_time() - start;
+    const double seconds = elapsed.total_microseconds() / 1000000.0;
+    const double megabytes = (request_text.size() * requests) / 1048576.0;
+
+    std::cout << std::left << std::setw(8) << name << std::right
+              << std::setw(10) << request_text.size() << " bytes"
+              << std::setw(12) << std::fixed << std::setprecision(1)
+              << (seconds > 0 ? requests / seconds : 0) << " requests/s"
+              << std::setw(10) << (seconds > 0 ? megabytes / seconds : 0)
+              << " MB/s (" << result << ")" << std::endl;
+}
+
+}
+
+int
+main() {
+    try {
+        benchmark("small", createRequest(100), 100000);
+        benchmark("large", createRequest(16 * 1024 * 1024), 5);
+    } catch (const std::exception& ex) {
+        std::cerr << "benchmark failed: " << ex.what() << std::endl;
+        return (EXIT_FAILURE);
+    }
+
+    return (EXIT_SUCCESS);
+}
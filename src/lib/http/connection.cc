@@ -0,0 +1,390 @@
+// Copyright (C) 2017 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <asiolink/asio_wrapper.h>
+#include <http/connection.h>
+#include <http/connection_pool.h>
+#include <http/http_log.h>
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/bind.hpp>
+
+using namespace isc::asiolink;
+
+namespace isc {
+namespace http {
+
+void
+HttpConnection::
+SocketCallback::operator()(boost::system::error_code ec, size_t length) {
+    if (ec.value() == boost::asio::error::operation_aborted) {
+        return;
+    }
+    callback_(ec, length);
+}
+
+HttpConnection::HttpConnection(asiolink::IOService& io_service,
+                                HttpAcceptor& acceptor,
+                                HttpConnectionPool& connection_pool,
+                                const HttpResponseCreatorPtr& response_creator,
+                                const HttpAcceptorCallback& callback,
+                                const long request_timeout,
+                                const long idle_timeout,
+                                const size_t max_request_size)
+    : request_timer_(io_service),
+      request_timeout_(request_timeout),
+      idle_timeout_(idle_timeout),
+      max_request_size_(max_request_size),
+      socket_(io_service),
+      acceptor_(acceptor),
+      connection_pool_(connection_pool),
+      response_creator_(response_creator),
+      request_(),
+      parser_(),
+      acceptor_callback_(callback),
+      input_buf_(),
+      output_buf_(),
+      request_size_(0),
+      request_started_(false),
+      keep_alive_(false) {
+}
+
+HttpConnection::~HttpConnection() {
+    close();
+}
+
+void
+HttpConnection::close() {
+    request_timer_.cancel();
+    socket_.close();
+}
+
+void
+HttpConnection::stopThisConnection() {
+    try {
+        LOG_DEBUG(http_logger, HTTP_DBG_TRACE_DETAIL,
+                  HTTP_CONNECTION_STOP)
+            .arg(getRemoteEndpointAddressAsText());
+        connection_pool_.stop(shared_from_this());
+    } catch (...) {
+        LOG_ERROR(http_logger, HTTP_CONNECTION_STOP_FAILED);
+    }
+}
+
+void
+HttpConnection::asyncAccept() {
+    HttpAcceptorCallback cb = boost::bind(&HttpConnection::acceptorCallback,
+                                          shared_from_this(),
+                                          boost::asio::placeholders::error);
+    try {
+        acceptor_.asyncAccept(socket_, cb);
+
+    } catch (const std::exception& ex) {
+        isc_throw(HttpConnectionError, "unable to start accepting TCP "
+                  "connections: " << ex.what());
+    }
+}
+
+void
+HttpConnection::doRead() {
+    try {
+        TCPEndpoint endpoint;
+        SocketCallback cb(boost::bind(&HttpConnection::socketReadCallback,
+                                      shared_from_this(),
+                                      boost::asio::placeholders::error,
+                                      boost::asio::placeholders::bytes_transferred));
+        socket_.asyncReceive(static_cast<void*>(input_buf_.data()),
+                             input_buf_.size(), 0, &endpoint, cb);
+
+    } catch (const std::exception& ex) {
+        stopThisConnection();
+    }
+}
+
+void
+HttpConnection::doWrite() {
+    try {
+        if (!output_buf_.empty()) {
+            SocketCallback cb(boost::bind(&HttpConnection::socketWriteCallback,
+                                          shared_from_this(),
+                                          boost::asio::placeholders::error,
+                                          boost::asio::placeholders::bytes_transferred));
+            socket_.asyncSend(output_buf_.data(), output_buf_.length(), cb);
+        }
+    } catch (const std::exception& ex) {
+        stopThisConnection();
+    }
+}
+
+void
+HttpConnection::acceptorCallback(const boost::system::error_code& ec) {
+    // The acceptor is closed when the listener is stopped. Don't touch it.
+    if ((ec.value() == boost::asio::error::operation_aborted) ||
+        !acceptor_.isOpen()) {
+        return;
+    }
+
+    if (ec) {
+        stopThisConnection();
+    }
+
+    // Let the listener accept the next connection.
+    acceptor_callback_(ec);
+
+    if (!ec) {
+        LOG_DEBUG(http_logger, HTTP_DBG_TRACE_DETAIL,
+                  HTTP_CONNECTION_ACCEPTED)
+            .arg(getRemoteEndpointAddressAsText());
+        startRequest(std::string());
+    }
+}
+
+void
+HttpConnection::startRequest(const std::string& data) {
+    request_ = response_creator_->createNewHttpRequest();
+    parser_.reset(new HttpRequestParser(*request_));
+    parser_->initModel();
+    request_size_ = 0;
+    request_started_ = false;
+    keep_alive_ = false;
+
+    if (data.empty()) {
+        setupIdleTimer();
+        doRead();
+
+    } else {
+        // The client has sent the beginning of this request together with
+        // the previous one.
+        processData(data.data(), data.size());
+    }
+}
+
+void
+HttpConnection::processData(const char* data, const size_t length) {
+    if (!request_started_) {
+        request_started_ = true;
+        setupRequestTimer();
+    }
+
+    request_size_ += length;
+    if ((max_request_size_ > 0) && (request_size_ > max_request_size_)) {
+        LOG_DEBUG(http_logger, HTTP_DBG_TRACE,
+                  HTTP_REQUEST_TOO_LARGE)
+            .arg(getRemoteEndpointAddressAsText())
+            .arg(max_request_size_);
+        sendStockResponse(HttpStatusCode::REQUEST_ENTITY_TOO_LARGE);
+        return;
+    }
+
+    parser_->postBuffer(static_cast<const void*>(data), length);
+    parser_->poll();
+
+    // Continue reading the request if it is incomplete.
+    if (parser_->needData()) {
+        doRead();
+        return;
+    }
+
+    request_timer_.cancel();
+
+    if (parser_->httpParseOk()) {
+        LOG_DEBUG(http_logger, HTTP_DBG_TRACE,
+                  HTTP_REQUEST_RECEIVED)
+            .arg(getRemoteEndpointAddressAsText());
+
+    } else {
+        LOG_DEBUG(http_logger, HTTP_DBG_TRACE,
+                  HTTP_BAD_REQUEST_RECEIVED)
+            .arg(getRemoteEndpointAddressAsText())
+            .arg(parser_->getErrorMessage());
+    }
+
+    // We don't know where the next request begins if this one couldn't
+    // be parsed, so close the connection in such case.
+    keep_alive_ = parser_->httpParseOk() && isKeepAlive();
+
+    // The response creator may need to wait for other events to create
+    // the response. Other connections are served in the meantime.
+    try {
+        response_creator_->
+            asyncCreateHttpResponse(request_,
+                                    boost::bind(&HttpConnection::responseCallback,
+                                                shared_from_this(), _1));
+
+    } catch (const std::exception& ex) {
+        LOG_ERROR(http_logger, HTTP_RESPONSE_CREATE_FAILED)
+            .arg(getRemoteEndpointAddressAsText())
+            .arg(ex.what());
+        stopThisConnection();
+    }
+}
+
+void
+HttpConnection::responseCallback(const HttpResponsePtr& response) {
+    // The connection may have been stopped while the response was created.
+    if (!socket_.getASIOSocket().is_open()) {
+        return;
+    }
+
+    if (!response) {
+        LOG_ERROR(http_logger, HTTP_RESPONSE_CREATE_FAILED)
+            .arg(getRemoteEndpointAddressAsText())
+            .arg("no response created");
+        stopThisConnection();
+        return;
+    }
+
+    asyncSendResponse(response);
+}
+
+bool
+HttpConnection::isKeepAlive() const {
+    std::string connection;
+    try {
+        connection = request_->getHeaderValue("Connection");
+
+    } catch (const std::exception&) {
+        // No "Connection" header.
+    }
+
+    // HTTP/1.1 connections are persistent by default, earlier versions
+    // require the client to ask for it.
+    if (request_->getHttpVersion() < HttpVersion(1, 1)) {
+        return (boost::iequals(connection, "keep-alive"));
+    }
+
+    return (!boost::iequals(connection, "close"));
+}
+
+void
+HttpConnection::asyncSendResponse(const HttpResponsePtr& response) {
+    if (!keep_alive_) {
+        response->addHeader("Connection", "close");
+
+    } else if (request_->getHttpVersion() < HttpVersion(1, 1)) {
+        response->addHeader("Connection", "keep-alive");
+    }
+
+    output_buf_ = response->toString();
+    doWrite();
+}
+
+void
+HttpConnection::sendStockResponse(const HttpStatusCode& status_code) {
+    request_timer_.cancel();
+    keep_alive_ = false;
+
+    HttpResponsePtr response;
+    try {
+        response = response_creator_->createStockHttpResponse(request_,
+                                                              status_code);
+
+    } catch (const std::exception& ex) {
+        LOG_ERROR(http_logger, HTTP_RESPONSE_CREATE_FAILED)
+            .arg(getRemoteEndpointAddressAsText())
+            .arg(ex.what());
+        stopThisConnection();
+        return;
+    }
+
+    asyncSendResponse(response);
+}
+
+void
+HttpConnection::socketReadCallback(boost::system::error_code ec, size_t length) {
+    if (ec) {
+        // The client has closed the connection or an error occurred.
+        stopThisConnection();
+        return;
+    }
+
+    processData(input_buf_.data(), length);
+}
+
+void
+HttpConnection::socketWriteCallback(boost::system::error_code ec,
+                                    size_t length) {
+    if (ec) {
+        LOG_DEBUG(http_logger, HTTP_DBG_TRACE,
+                  HTTP_RESPONSE_SEND_FAILED)
+            .arg(getRemoteEndpointAddressAsText())
+            .arg(ec.message());
+        stopThisConnection();
+        return;
+    }
+
+    // The socket may send only a part of the data. Send the rest.
+    if (length < output_buf_.length()) {
+        output_buf_.erase(0, length);
+        doWrite();
+        return;
+    }
+
+    output_buf_.clear();
+
+    if (!keep_alive_) {
+        stopThisConnection();
+        return;
+    }
+
+    // Parse the data received beyond the end of the previous request,
+    // if any, as the beginning of the next request.
+    startRequest(parser_->getUnparsedData());
+}
+
+void
+HttpConnection::setupIdleTimer() {
+    request_timer_.setup(boost::bind(&HttpConnection::idleTimeoutCallback,
+                                     this),
+                         idle_timeout_, IntervalTimer::ONE_SHOT);
+}
+
+void
+HttpConnection::setupRequestTimer() {
+    request_timer_.setup(boost::bind(&HttpConnection::requestTimeoutCallback,
+                                     this),
+                         request_timeout_, IntervalTimer::ONE_SHOT);
+}
+
+void
+HttpConnection::requestTimeoutCallback() {
+    LOG_DEBUG(http_logger, HTTP_DBG_TRACE_DETAIL,
+              HTTP_REQUEST_TIMEOUT_OCCURRED)
+        .arg(getRemoteEndpointAddressAsText());
+
+    // Hold the reference to this connection until the response is sent.
+    HttpConnectionPtr self = shared_from_this();
+
+    // Abort the pending read. Its callback is not invoked.
+    socket_.cancel();
+    sendStockResponse(HttpStatusCode::REQUEST_TIMEOUT);
+}
+
+void
+HttpConnection::idleTimeoutCallback() {
+    LOG_DEBUG(http_logger, HTTP_DBG_TRACE_DETAIL,
+              HTTP_CONNECTION_IDLE_TIMEOUT)
+        .arg(getRemoteEndpointAddressAsText());
+
+    // Hold the reference to this connection until the callback returns.
+    HttpConnectionPtr self = shared_from_this();
+    stopThisConnection();
+}
+
+std::string
+HttpConnection::getRemoteEndpointAddressAsText() const {
+    try {
+        if (socket_.getASIOSocket().is_open()) {
+            return (socket_.getASIOSocket().remote_endpoint().address().to_string());
+        }
+    } catch (...) {
+    }
+    return ("(unknown address)");
+}
+
+} // end of namespace isc::http
+} // end of namespace isc
@@ -0,0 +1,324 @@
+// Copyright (C) 2017 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef HTTP_CONNECTION_H
+#define HTTP_CONNECTION_H
+
+#include <asiolink/interval_timer.h>
+#include <http/http_acceptor.h>
+#include <http/request_parser.h>
+#include <http/response_creator.h>
+#include <boost/array.hpp>
+#include <boost/enable_shared_from_this.hpp>
+#include <boost/system/error_code.hpp>
+#include <boost/shared_ptr.hpp>
+#include <string>
+
+namespace isc {
+namespace http {
+
+/// @brief Generic error reported within @ref HttpConnection class.
+class HttpConnectionError : public Exception {
+public:
+    HttpConnectionError(const char* file, size_t line, const char* what) :
+        isc::Exception(file, line, what) { };
+};
+
+/// @brief Forward declaration to the @ref HttpConnectionPool.
+///
+/// This declaration is needed because we don't include the header file
+/// declaring @ref HttpConnectionPool to avoid circular inclusion.
+class HttpConnectionPool;
+
+class HttpConnection;
+/// @brief Pointer to the @ref HttpConnection.
+typedef boost::shared_ptr<HttpConnection> HttpConnectionPtr;
+
+/// @brief Accepts and handles a single HTTP connection.
+///
+/// The connection is persistent, i.e. it is used for subsequent requests
+/// from the client until the client or the server closes it. The HTTP/1.1
+/// connections are persistent unless the client sends the
+/// "Connection: close" header. The HTTP/1.0 connections are persistent
+/// only if the client sends the "Connection: keep-alive" header. The server
+/// closes the connection after sending the response if the connection is
+/// not persistent, if the request couldn't be parsed, or if an error occurred.
+///
+/// The client may send the next request before receiving the response to
+/// the previous one (pipelining). The data received beyond the end of the
+/// request are retained and parsed as the beginning of the next request
+/// after the response has been sent.
+///
+/// The connection uses two timeouts:
+/// - idle timeout, i.e. maximum time between accepting the connection or
+///   sending a response and receiving the first byte of the next request.
+///   The server closes the idle connection when this timeout elapses,
+/// - request timeout, i.e. maximum time between receiving the first byte
+///   of the request and receiving the whole request. The server sends
+///   HTTP 408 and closes the connection when this timeout elapses.
+///
+/// The server sends HTTP 413 and closes the connection when the request
+/// is larger than the configured limit.
+class HttpConnection : public boost::enable_shared_from_this<HttpConnection> {
+private:
+
+    /// @brief Type of the function implementing a callback invoked by the
+    /// @c SocketCallback functor.
+    typedef boost::function<void(boost::system::error_code ec, size_t length)>
+    SocketCallbackFunction;
+
+    /// @brief Functor associated with the socket object.
+    ///
+    /// This functor calls a callback function specified in the constructor.
+    class SocketCallback {
+    public:
+
+        /// @brief Constructor.
+        ///
+        /// @param socket_callback Callback to be invoked by the functor upon
+        /// an event associated with the socket.
+        SocketCallback(SocketCallbackFunction socket_callback)
+            : callback_(socket_callback) {
+        }
+
+        /// @brief Operator called when event associated with a socket occurs.
+        ///
+        /// This operator returns immediately when received error code is
+        /// @c boost::system::error_code is equal to
+        /// @c boost::asio::error::operation_aborted, i.e. the callback is not
+        /// invoked.
+        ///
+        /// @param ec Error code.
+        /// @param length Data length.
+        void operator()(boost::system::error_code ec, size_t length = 0);
+
+    private:
+        /// @brief Supplied callback.
+        SocketCallbackFunction callback_;
+    };
+
+public:
+
+    /// @brief Constructor.
+    ///
+    /// @param io_service IO service to be used by the connection.
+    /// @param acceptor Reference to the TCP acceptor object used to listen for
+    /// new HTTP connections.
+    /// @param connection_pool Connection pool in which this connection is
+    /// stored.
+    /// @param response_creator Pointer to the response creator object used to
+    /// create HTTP responses from the HTTP requests received over this
+    /// connection.
+    /// @param callback Callback invoked when new connection is accepted.
+    /// @param request_timeout Configured timeout for a HTTP request in
+    /// milliseconds.
+    /// @param idle_timeout Configured timeout for an idle persistent
+    /// connection in milliseconds.
+    /// @param max_request_size Maximum size of the HTTP request in bytes.
+    /// The value of 0 means that the size is not limited.
+    HttpConnection(asiolink::IOService& io_service,
+                   HttpAcceptor& acceptor,
+                   HttpConnectionPool& connection_pool,
+                   const HttpResponseCreatorPtr& response_creator,
+                   const HttpAcceptorCallback& callback,
+                   const long request_timeout,
+                   const long idle_timeout,
+                   const size_t max_request_size);
+
+    /// @brief Destructor.
+    ///
+    /// Closes current connection.
+    ~HttpConnection();
+
+    /// @brief Asynchronously accepts new connection.
+    ///
+    /// When the connection is established successfully, the timeout timer is
+    /// setup and the asynchronous read from the socket is started.
+    void asyncAccept();
+
+    /// @brief Closes the socket.
+    void close();
+
+    /// @brief Starts asynchronous read from the socket.
+    ///
+    /// The data received over the socket are supplied to the HTTP parser until
+    /// the parser signals that the entire request has been received or until
+    /// the parser signals an error. In the former case the server creates an
+    /// HTTP response using supplied response creator object.
+    ///
+    /// In case of error the connection is stopped.
+    void doRead();
+
+private:
+
+    /// @brief Starts receiving a new request over the connection.
+    ///
+    /// Creates a new request object and a new parser. If the data are not
+    /// empty, they are parsed as the beginning of the request. Otherwise,
+    /// the idle timer is started and the data are read from the socket.
+    ///
+    /// @param data Data received with the previous request, which belong
+    /// to the new request.
+    void startRequest(const std::string& data);
+
+    /// @brief Supplies the received data to the parser.
+    ///
+    /// Starts the request timer when the data are the first data of the
+    /// request. Starts creating the response when the parser has completed.
+    /// Otherwise, continues reading the request.
+    ///
+    /// @param data Pointer to the received data.
+    /// @param length Length of the received data.
+    void processData(const char* data, const size_t length);
+
+    /// @brief Callback invoked when the response to the current request
+    /// has been created.
+    ///
+    /// Sends the response unless the connection has been stopped in the
+    /// meantime.
+    ///
+    /// @param response Pointer to the created response.
+    void responseCallback(const HttpResponsePtr& response);
+
+    /// @brief Checks if the connection should be kept open after sending
+    /// the response to the current request.
+    ///
+    /// @return true if the connection is persistent.
+    bool isKeepAlive() const;
+
+    /// @brief Sends the specified response asynchronously.
+    ///
+    /// Adds the "Connection" header to the response when the connection is
+    /// to be closed after sending the response or when it is a persistent
+    /// HTTP/1.0 connection.
+    ///
+    /// @param response Pointer to the response to be sent.
+    void asyncSendResponse(const HttpResponsePtr& response);
+
+    /// @brief Sends a stock response with the specified status code and
+    /// closes the connection after sending it.
+    ///
+    /// @param status_code Status code of the response.
+    void sendStockResponse(const HttpStatusCode& status_code);
+
+    /// @brief Starts asynchronous write to the socket.
+    ///
+    /// The @c output_buf_ must contain the data to be sent.
+    ///
+    /// In case of error the connection is stopped.
+    void doWrite();
+
+    /// @brief Local callback invoked when new connection is accepted.
+    ///
+    /// It invokes external (supplied via constructor) acceptor callback. If
+    /// the acceptor is not opened it returns immediately. If the connection
+    /// is accepted successfully the @ref HttpConnection::startRequest is
+    /// called.
+    ///
+    /// @param ec Error code.
+    void acceptorCallback(const boost::system::error_code& ec);
+
+    /// @brief Callback invoked when new data is received over the socket.
+    ///
+    /// This callback supplies the data to the HTTP parser and continues
+    /// parsing. When the parser signals end of the HTTP request the callback
+    /// prepares a response and starts asynchronous send over the socket.
+    ///
+    /// @param ec Error code.
+    /// @param length Length of the received data.
+    void socketReadCallback(boost::system::error_code ec, size_t length);
+
+    /// @brief Callback invoked when data is sent over the socket.
+    ///
+    /// Sends the remaining data, if any. When the whole response has been
+    /// sent, it either closes the connection or starts receiving the next
+    /// request.
+    ///
+    /// @param ec Error code.
+    /// @param length Length of the data sent.
+    void socketWriteCallback(boost::system::error_code ec, size_t length);
+
+    /// @brief Starts the timer guarding the time between the end of the
+    /// previous request and the beginning of the next request.
+    void setupIdleTimer();
+
+    /// @brief Starts the timer guarding the time of receiving the request.
+    void setupRequestTimer();
+
+    /// @brief Callback invoked when the HTTP request timeout occurs.
+    ///
+    /// This callback creates HTTP response with Request Timeout error code
+    /// and sends it to the client.
+    void requestTimeoutCallback();
+
+    /// @brief Callback invoked when the persistent connection has been idle
+    /// for too long.
+    ///
+    /// This callback closes the connection.
+    void idleTimeoutCallback();
+
+    /// @brief Stops current connection.
+    void stopThisConnection();
+
+    /// @brief returns remote address in textual form
+    std::string getRemoteEndpointAddressAsText() const;
+
+    /// @brief Timer used to detect the request and the idle timeouts.
+    asiolink::IntervalTimer request_timer_;
+
+    /// @brief Configured request timeout in milliseconds.
+    long request_timeout_;
+
+    /// @brief Configured idle timeout in milliseconds.
+    long idle_timeout_;
+
+    /// @brief Configured maximum request size in bytes (0 means unlimited).
+    size_t max_request_size_;
+
+    /// @brief Socket used by this connection.
+    asiolink::TCPSocket<SocketCallback> socket_;
+
+    /// @brief Reference to the TCP acceptor used to accept new connections.
+    HttpAcceptor& acceptor_;
+
+    /// @brief Connection pool holding this connection.
+    HttpConnectionPool& connection_pool_;
+
+    /// @brief Pointer to the @ref HttpResponseCreator object used to create
+    /// HTTP responses.
+    HttpResponseCreatorPtr response_creator_;
+
+    /// @brief Pointer to the request received over this connection.
+    HttpRequestPtr request_;
+
+    /// @brief Pointer to the HTTP request parser.
+    boost::shared_ptr<HttpRequestParser> parser_;
+
+    /// @brief External TCP acceptor callback.
+    HttpAcceptorCallback acceptor_callback_;
+
+    /// @brief Buffer for received data.
+    boost::array<char, 4096> input_buf_;
+
+    /// @brief Buffer used for outbound data.
+    std::string output_buf_;
+
+    /// @brief Number of bytes received for the current request.
+    size_t request_size_;
+
+    /// @brief Indicates if any data of the current request has been
+    /// received.
+    bool request_started_;
+
+    /// @brief Indicates if the connection is kept open after sending the
+    /// current response.
+    bool keep_alive_;
+};
+
+} // end of namespace isc::http
+} // end of namespace isc
+
+#endif
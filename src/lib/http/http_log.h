@@ -1,4 +1,4 @@
-// Copyright (C) 2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2016-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -14,6 +14,18 @@
 namespace isc {
 namespace http {
 
+/// @brief HTTP debug logging levels
+///
+/// Defines the levels used to output debug messages in the libkea-http
+/// library. Note that higher numbers equate to more verbose (and detailed)
+/// output.
+
+// The first level traces the requests and the responses.
+const int HTTP_DBG_TRACE = DBGLVL_TRACE_BASIC;
+
+// The next level traces the connections.
+const int HTTP_DBG_TRACE_DETAIL = DBGLVL_TRACE_DETAIL;
+
 /// Define the loggers used within libkea-http library.
 extern isc::log::Logger http_logger;
 
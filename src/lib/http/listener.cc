@@ -0,0 +1,228 @@
+// Copyright (C) 2017 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <asiolink/asio_wrapper.h>
+#include <asiolink/tcp_endpoint.h>
+#include <http/connection.h>
+#include <http/connection_pool.h>
+#include <http/http_acceptor.h>
+#include <http/listener.h>
+#include <boost/bind.hpp>
+#include <boost/scoped_ptr.hpp>
+
+using namespace isc::asiolink;
+
+namespace isc {
+namespace http {
+
+/// @brief Implementation of the @ref HttpListener.
+class HttpListenerImpl {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// See @ref HttpListener::HttpListener for the parameters.
+    ///
+    /// @throw HttpListenerError when any of the specified parameters is
+    /// invalid.
+    HttpListenerImpl(IOService& io_service,
+                     const asiolink::IOAddress& server_address,
+                     const unsigned short server_port,
+                     const HttpResponseCreatorFactoryPtr& creator_factory,
+                     const long request_timeout,
+                     const long idle_timeout,
+                     const size_t max_request_size);
+
+    /// @brief Returns reference to the current listener endpoint.
+    const TCPEndpoint& getEndpoint() const;
+
+    /// @brief Starts accepting new connections.
+    ///
+    /// @throw HttpListenerError if an error occurred.
+    void start();
+
+    /// @brief Stops all active connections and shuts down the service.
+    void stop();
+
+private:
+
+    /// @brief Creates @ref HttpConnection instance and adds it to the
+    /// pool of active connections.
+    ///
+    /// The next accepted connection will be handled by this instance.
+    void accept();
+
+    /// @brief Callback invoked when the new connection is accepted.
+    ///
+    /// It calls @ref HttpListener::accept to create new instance of the
+    /// @ref HttpConnection. The new connection will be used to handle the
+    /// next connection accepted by the acceptor.
+    ///
+    /// @param ec Error code passed to the handler. This is currently ignored.
+    void acceptHandler(const boost::system::error_code& ec);
+
+    /// @brief Reference to the IO service.
+    IOService& io_service_;
+
+    /// @brief Acceptor instance.
+    HttpAcceptor acceptor_;
+
+    /// @brief Pointer to the endpoint representing IP address and port on
+    /// which the service is running.
+    boost::scoped_ptr<TCPEndpoint> endpoint_;
+
+    /// @brief Pool of active connections.
+    HttpConnectionPool connections_;
+
+    /// @brief Pointer to the @ref HttpResponseCreatorFactory.
+    HttpResponseCreatorFactoryPtr creator_factory_;
+
+    /// @brief Timeout for HTTP Request Timeout desired.
+    long request_timeout_;
+
+    /// @brief Timeout for the idle persistent connections.
+    long idle_timeout_;
+
+    /// @brief Maximum size of the request (0 means unlimited).
+    size_t max_request_size_;
+};
+
+HttpListenerImpl::HttpListenerImpl(IOService& io_service,
+                                   const asiolink::IOAddress& server_address,
+                                   const unsigned short server_port,
+                                   const HttpResponseCreatorFactoryPtr& creator_factory,
+                                   const long request_timeout,
+                                   const long idle_timeout,
+                                   const size_t max_request_size)
+    : io_service_(io_service), acceptor_(io_service),
+      endpoint_(), connections_(), creator_factory_(creator_factory),
+      request_timeout_(request_timeout), idle_timeout_(idle_timeout),
+      max_request_size_(max_request_size) {
+    // Try creating an endpoint. This may cause exceptions.
+    try {
+        endpoint_.reset(new TCPEndpoint(server_address, server_port));
+
+    } catch (...) {
+        isc_throw(HttpListenerError, "unable to create TCP endpoint for "
+                  << server_address << ":" << server_port);
+    }
+
+    // The factory must not be null.
+    if (!creator_factory_) {
+        isc_throw(HttpListenerError, "HttpResponseCreatorFactory must not"
+                  " be null");
+    }
+
+    // Request timeout is signed and must be greater than 0.
+    if (request_timeout_ <= 0) {
+        isc_throw(HttpListenerError, "Invalid desired HTTP request timeout "
+                  << request_timeout_);
+    }
+
+    // Idle timeout is signed and must be greater than 0.
+    if (idle_timeout_ <= 0) {
+        isc_throw(HttpListenerError, "Invalid desired HTTP idle timeout "
+                  << idle_timeout_);
+    }
+}
+
+const TCPEndpoint&
+HttpListenerImpl::getEndpoint() const {
+    return (*endpoint_);
+}
+
+void
+HttpListenerImpl::start() {
+    try {
+        acceptor_.open(*endpoint_);
+        acceptor_.setOption(HttpAcceptor::ReuseAddress(true));
+        acceptor_.bind(*endpoint_);
+        acceptor_.listen();
+
+    } catch (const boost::system::system_error& ex) {
+        stop();
+        isc_throw(HttpListenerError, "unable to setup TCP acceptor for "
+                  "listening to the incoming HTTP requests: " << ex.what());
+    }
+
+    accept();
+}
+
+void
+HttpListenerImpl::stop() {
+    connections_.stopAll();
+    if (acceptor_.isOpen()) {
+        acceptor_.close();
+    }
+}
+
+void
+HttpListenerImpl::accept() {
+    // In some cases we may need HttpResponseCreator instance per connection.
+    // But, the listener is not really intended to be aware of this. It merely
+    // calls create() on the factory and the factory may return the same
+    // instance for each connection.
+    HttpResponseCreatorPtr response_creator = creator_factory_->create();
+    HttpAcceptorCallback acceptor_callback =
+        boost::bind(&HttpListenerImpl::acceptHandler, this, _1);
+    HttpConnectionPtr conn(new HttpConnection(io_service_, acceptor_,
+                                              connections_,
+                                              response_creator,
+                                              acceptor_callback,
+                                              request_timeout_,
+                                              idle_timeout_,
+                                              max_request_size_));
+    // Add this new connection to the pool.
+    connections_.start(conn);
+}
+
+void
+HttpListenerImpl::acceptHandler(const boost::system::error_code&) {
+    // The new connection has arrived. Set the acceptor to continue
+    // accepting new connections.
+    accept();
+}
+
+HttpListener::HttpListener(IOService& io_service,
+                           const asiolink::IOAddress& server_address,
+                           const unsigned short server_port,
+                           const HttpResponseCreatorFactoryPtr& creator_factory,
+                           const long request_timeout,
+                           const long idle_timeout,
+                           const size_t max_request_size)
+    : impl_(new HttpListenerImpl(io_service, server_address, server_port,
+                                 creator_factory, request_timeout,
+                                 idle_timeout, max_request_size)) {
+}
+
+HttpListener::~HttpListener() {
+    stop();
+}
+
+IOAddress
+HttpListener::getLocalAddress() const {
+    return (impl_->getEndpoint().getAddress());
+}
+
+uint16_t
+HttpListener::getLocalPort() const {
+    return (impl_->getEndpoint().getPort());
+}
+
+void
+HttpListener::start() {
+    impl_->start();
+}
+
+void
+HttpListener::stop() {
+    impl_->stop();
+}
+
+} // end of namespace isc::http
+} // end of namespace isc
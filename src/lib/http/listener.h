@@ -0,0 +1,119 @@
+// Copyright (C) 2017 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef HTTP_LISTENER_H
+#define HTTP_LISTENER_H
+
+#include <asiolink/io_address.h>
+#include <asiolink/io_service.h>
+#include <exceptions/exceptions.h>
+#include <http/response_creator_factory.h>
+#include <boost/shared_ptr.hpp>
+#include <stdint.h>
+
+namespace isc {
+namespace http {
+
+/// @brief A generic error raised by the @ref HttpListener class.
+class HttpListenerError : public Exception {
+public:
+    HttpListenerError(const char* file, size_t line, const char* what) :
+        isc::Exception(file, line, what) { };
+};
+
+/// @brief Implementation of the @ref HttpListener.
+class HttpListenerImpl;
+
+/// @brief HTTP listener.
+///
+/// This class is an entry point to the use of HTTP services in Kea.
+/// It creates a TCP acceptor service on the specified address and
+/// port and listens to the incoming HTTP connections. The requests
+/// received over the connections are parsed and the responses are
+/// created using the response creators returned by the specified
+/// factory.
+///
+/// The connections are persistent, see @ref HttpConnection for details.
+/// Many connections can be handled at the same time. Each connection
+/// is handled asynchronously by the IO service which the listener is
+/// using, so a slow client doesn't delay the responses to other clients.
+///
+/// The listener must be started with @ref HttpListener::start and
+/// stopped with @ref HttpListener::stop. Stopping the listener closes
+/// all the connections.
+class HttpListener {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// This constructor creates new server endpoint using the specified IP
+    /// address and port. It also validates other specified parameters.
+    ///
+    /// This constructor does not start accepting new connections! To start
+    /// accepting connections run @ref HttpListener::start.
+    ///
+    /// @param io_service IO service to be used by the listener.
+    /// @param server_address Address on which the HTTP service should run.
+    /// @param server_port Port number on which the HTTP service should run.
+    /// @param creator_factory Pointer to the caller-defined
+    /// @ref HttpResponseCreatorFactory derivation which should be used to
+    /// create @ref HttpResponseCreator instances.
+    /// @param request_timeout Timeout after which the HTTP Request Timeout
+    /// is generated, in milliseconds.
+    /// @param idle_timeout Timeout after which the persistent connection
+    /// waiting for a new request is closed, in milliseconds.
+    /// @param max_request_size Maximum size of the request in bytes. The
+    /// value of 0 means that the size is not limited.
+    ///
+    /// @throw HttpListenerError when any of the specified parameters is
+    /// invalid.
+    HttpListener(asiolink::IOService& io_service,
+                 const asiolink::IOAddress& server_address,
+                 const unsigned short server_port,
+                 const HttpResponseCreatorFactoryPtr& creator_factory,
+                 const long request_timeout,
+                 const long idle_timeout,
+                 const size_t max_request_size = 0);
+
+    /// @brief Destructor.
+    ///
+    /// Stops all active connections and closes TCP acceptor service.
+    ~HttpListener();
+
+    /// @brief Returns the address on which the listener is listening.
+    asiolink::IOAddress getLocalAddress() const;
+
+    /// @brief Returns the port on which the listener is listening.
+    uint16_t getLocalPort() const;
+
+    /// @brief Starts accepting new connections.
+    ///
+    /// This method starts accepting and handling new HTTP connections on
+    /// the IP address and port number specified in the constructor.
+    ///
+    /// If the method is invoked successfully, it must not be invoked again
+    /// until @ref HttpListener::stop is called.
+    ///
+    /// @throw HttpListenerError if an error occurred.
+    void start();
+
+    /// @brief Stops all active connections and shuts down the service.
+    void stop();
+
+private:
+
+    /// @brief Pointer to the implementation of the @ref HttpListener.
+    boost::shared_ptr<HttpListenerImpl> impl_;
+
+};
+
+/// @brief Pointer to the @ref HttpListener.
+typedef boost::shared_ptr<HttpListener> HttpListenerPtr;
+
+} // end of namespace isc::http
+} // end of namespace isc
+
+#endif
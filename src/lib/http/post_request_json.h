@@ -1,4 +1,4 @@
-// Copyright (C) 2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2016-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -10,6 +10,7 @@
 #include <cc/data.h>
 #include <exceptions/exceptions.h>
 #include <http/post_request.h>
+#include <boost/shared_ptr.hpp>
 #include <string>
 
 namespace isc {
@@ -47,7 +48,7 @@ public:
     ///
     /// @return Pointer to the root element of the JSON structure.
     /// @throw HttpRequestJsonError if an error occurred.
-    data::ConstElementPtr getBodyAsJson();
+    data::ConstElementPtr getBodyAsJson() const;
 
     /// @brief Retrieves a single JSON element.
     ///
@@ -58,7 +59,7 @@ public:
     /// @return Pointer to the specified element or NULL if such element
     /// doesn't exist.
     /// @throw HttpRequestJsonError if an error occurred.
-    data::ConstElementPtr getJsonElement(const std::string& element_name);
+    data::ConstElementPtr getJsonElement(const std::string& element_name) const;
 
 protected:
 
@@ -69,6 +70,12 @@ protected:
 
 };
 
+/// @brief Pointer to @ref PostHttpRequestJson.
+typedef boost::shared_ptr<PostHttpRequestJson> PostHttpRequestJsonPtr;
+
+/// @brief Pointer to const @ref PostHttpRequestJson.
+typedef boost::shared_ptr<const PostHttpRequestJson> ConstPostHttpRequestJsonPtr;
+
 } // namespace http
 } // namespace isc
 
@@ -1,4 +1,4 @@
-// Copyright (C) 2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2016-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -6,7 +6,9 @@
 
 #include <http/request_parser.h>
 #include <boost/bind.hpp>
+#include <algorithm>
 #include <cctype>
+#include <cstring>
 #include <iostream>
 
 using namespace isc::util;
@@ -45,8 +47,8 @@ const int HttpRequestParser::HTTP_PARSE_OK_EVT;
 const int HttpRequestParser::HTTP_PARSE_FAILED_EVT;
 
 HttpRequestParser::HttpRequestParser(HttpRequest& request)
-    : StateModel(), buffer_(), request_(request),
-      context_(request_.context()), error_message_() {
+    : StateModel(), buffer_(), buffer_pos_(0), body_length_(0),
+      request_(request), context_(request_.context()), error_message_() {
 }
 
 void
@@ -97,11 +99,21 @@ HttpRequestParser::postBuffer(const void* buf, const size_t buf_size) {
         if (getNextEvent() == NEED_MORE_DATA_EVT) {
             transition(getCurrState(), MORE_DATA_PROVIDED_EVT);
         }
-        buffer_.insert(buffer_.end(), static_cast<const char*>(buf),
-                       static_cast<const char*>(buf) + buf_size);
+        // Drop the consumed data before appending so as the buffer doesn't
+        // grow beyond the size of the unparsed data.
+        if (buffer_pos_ > 0) {
+            buffer_.erase(0, buffer_pos_);
+            buffer_pos_ = 0;
+        }
+        buffer_.append(static_cast<const char*>(buf), buf_size);
     }
 }
 
+std::string
+HttpRequestParser::getUnparsedData() const {
+    return (buffer_.substr(buffer_pos_));
+}
+
 void
 HttpRequestParser::defineEvents() {
     StateModel::defineEvents();
@@ -330,9 +342,10 @@ HttpRequestParser::httpMethodHandler() {
                          " in HTTP method name");
 
         } else {
-            // Still parsing the method. Append the next character to the
-            // method name.
+            // Still parsing the method. Append the next character and
+            // the following ones to the method name.
             context_->method_.push_back(c);
+            appendRun(context_->method_, ' ', true);
             transition(getCurrState(), DATA_READ_OK_EVT);
         }
     });
@@ -349,9 +362,10 @@ HttpRequestParser::uriHandler() {
             parseFailure("control character found in HTTP URI");
 
         } else {
-            // Still parsing the URI. Append the next character to the
-            // method name.
+            // Still parsing the URI. Append the next character and the
+            // following ones to the URI.
             context_->uri_.push_back(c);
+            appendRun(context_->uri_, ' ', false);
             transition(HTTP_URI_ST, DATA_READ_OK_EVT);
         }
     });
@@ -415,6 +429,7 @@ HttpRequestParser::versionNumberHandler(const char following_character,
         } else if (isdigit(c)) {
             // Current character is a digit, so update the version number.
             *storage = *storage * 10 + c - '0';
+            transition(getCurrState(), DATA_READ_OK_EVT);
 
         } else {
             parseFailure("expected digit in HTTP version, found " +
@@ -444,6 +459,9 @@ HttpRequestParser::expectingNewLineHandler(const unsigned int next_state) {
                         request_.getHeaderValueAsUint64("Content-Length");
                     if (content_length > 0) {
                         // There is body in this request, so let's parse it.
+                        // Remember its length so as the header needn't be
+                        // parsed again while the body is being read.
+                        body_length_ = content_length;
                         transition(HTTP_BODY_ST, DATA_READ_OK_EVT);
                     }
                 } catch (const std::exception& ex) {
@@ -491,6 +509,7 @@ HttpRequestParser::headerLineStartHandler() {
             // Update header name with the parse letter.
             context_->headers_.push_back(HttpHeaderContext());
             context_->headers_.back().name_.push_back(c);
+            appendRun(context_->headers_.back().name_, ':', true);
             transition(HEADER_NAME_ST, DATA_READ_OK_EVT);
         }
     });
@@ -516,6 +535,7 @@ HttpRequestParser::headerLwsHandler() {
         } else {
             // We're parsing header value, so let's update it.
             context_->headers_.back().value_.push_back(c);
+            appendRun(context_->headers_.back().value_, '\r', false);
             transition(HEADER_VALUE_ST, DATA_READ_OK_EVT);
         }
     });
@@ -535,6 +555,7 @@ HttpRequestParser::headerNameHandler() {
         } else {
             // Parsing a header name, so update it.
             context_->headers_.back().name_.push_back(c);
+            appendRun(context_->headers_.back().name_, ':', true);
             transition(getCurrState(), DATA_READ_OK_EVT);
         }
     });
@@ -559,6 +580,7 @@ HttpRequestParser::spaceBeforeHeaderValueHandler() {
         } else {
             // Still parsing the value, so let's update it.
             context_->headers_.back().value_.push_back(c);
+            appendRun(context_->headers_.back().value_, '\r', false);
             transition(HEADER_VALUE_ST, DATA_READ_OK_EVT);
         }
     });
@@ -579,6 +601,7 @@ HttpRequestParser::headerValueHandler() {
         } else {
             // Still parsing the value, so let's update it.
             context_->headers_.back().value_.push_back(c);
+            appendRun(context_->headers_.back().value_, '\r', false);
             transition(HEADER_VALUE_ST, DATA_READ_OK_EVT);
         }
     });
@@ -588,10 +611,17 @@ void
 HttpRequestParser::bodyHandler() {
     stateWithReadHandler("bodyHandler", [this](const char c) {
         // We don't validate the body at this stage. Simply record the
-        // number of characters specified within "Content-Length".
+        // number of characters specified within "Content-Length". Copy
+        // as much of the body as is available in the buffer at once.
         context_->body_.push_back(c);
-        if (context_->body_.length() <
-            request_.getHeaderValueAsUint64("Content-Length")) {
+        const uint64_t remaining = body_length_ - context_->body_.length();
+        const size_t len = static_cast<size_t>(std::min<uint64_t>(remaining,
+                                                                  buffer_.size() -
+                                                                  buffer_pos_));
+        context_->body_.append(buffer_, buffer_pos_, len);
+        buffer_pos_ += len;
+
+        if (context_->body_.length() < body_length_) {
             transition(HTTP_BODY_ST, DATA_READ_OK_EVT);
         } else {
             transition(HTTP_PARSE_OK_ST, HTTP_PARSE_OK_EVT);
@@ -619,14 +649,44 @@ HttpRequestParser::parseEndedHandler() {
 bool
 HttpRequestParser::popNextFromBuffer(char& next) {
     // If there are any characters in the buffer, pop next.
-    if (!buffer_.empty()) {
-        next = buffer_.front();
-        buffer_.pop_front();
+    if (buffer_pos_ < buffer_.size()) {
+        next = buffer_[buffer_pos_++];
         return (true);
     }
     return (false);
 }
 
+void
+HttpRequestParser::appendRun(std::string& dest, const char delimiter,
+                             const bool token_only) {
+    const char* begin = buffer_.data() + buffer_pos_;
+    const size_t available = buffer_.size() - buffer_pos_;
+
+    // Find the delimiter first. The characters beyond it are not part
+    // of the run.
+    const char* end = static_cast<const char*>(memchr(begin, delimiter,
+                                                      available));
+    if (end == NULL) {
+        end = begin + available;
+    }
+
+    // The run also ends at the first character which is not allowed in it.
+    // The handler processes this character and reports the error.
+    const char* pos = begin;
+    if (token_only) {
+        while ((pos < end) && isChar(*pos) && !isCtl(*pos) && !isSpecial(*pos)) {
+            ++pos;
+        }
+    } else {
+        while ((pos < end) && !isCtl(*pos)) {
+            ++pos;
+        }
+    }
+
+    dest.append(begin, pos - begin);
+    buffer_pos_ += pos - begin;
+}
+
 
 bool
 HttpRequestParser::isChar(const char c) const {
@@ -1,4 +1,4 @@
-// Copyright (C) 2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2016-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -11,7 +11,6 @@
 #include <http/request.h>
 #include <util/state_model.h>
 #include <boost/function.hpp>
-#include <list>
 #include <stdint.h>
 #include <string>
 
@@ -85,6 +84,14 @@ public:
 /// @ref HttpRequestParser::httpParseOk to determine whether parsing has
 /// completed.
 ///
+/// The parser processes the request line and the headers one character at a
+/// time only around the delimiters. The runs of characters forming URI, header
+/// names and values are consumed at once (see
+/// @ref HttpRequestParser::appendRun). When the headers have been parsed,
+/// the body is copied from the buffer in bulk, up to the length specified
+/// in the "Content-Length" header. The parser may still be interrupted at any
+/// point when it runs out of data.
+///
 /// The @ref util::StateModel::runModel must not be used to run the
 /// @ref HttpRequestParser state machine, thus it is made private method.
 class HttpRequestParser : public util::StateModel {
@@ -243,6 +250,15 @@ public:
     /// @param buf_size Size of the data within the buffer.
     void postBuffer(const void* buf, const size_t buf_size);
 
+    /// @brief Returns the data provided to the parser but not parsed.
+    ///
+    /// When the parsing completes, this method returns the data following
+    /// the parsed request, e.g. the beginning of the next request sent by
+    /// the client over the persistent connection.
+    ///
+    /// @return Unparsed data (may be empty).
+    std::string getUnparsedData() const;
+
 private:
 
     /// @brief Make @ref runModel private to make sure that the caller uses
@@ -437,8 +453,35 @@ private:
     /// @return true, if specified value is a special character.
     bool isSpecial(const char c) const;
 
+    /// @brief Appends the characters following in the buffer to the string.
+    ///
+    /// Used by the handlers of the states consuming long runs of characters,
+    /// e.g. URI, header name or value, to consume the run at once instead of
+    /// processing each character in the state machine. The run ends at the
+    /// first character which the state handler must process itself: the
+    /// delimiter terminating the run or the character not allowed in the
+    /// run. This character is left in the buffer so it is processed by the
+    /// handler and the parser remains in the current state until then.
+    ///
+    /// @param [out] dest String to which the characters are appended.
+    /// @param delimiter Character terminating the run.
+    /// @param token_only Indicates if the run consists of token characters
+    /// (i.e. method or header name). Otherwise, the run ends at the control
+    /// character.
+    void appendRun(std::string& dest, const char delimiter,
+                   const bool token_only);
+
     /// @brief Internal buffer from which parser reads data.
-    std::list<char> buffer_;
+    ///
+    /// The data are consumed from the @c buffer_pos_ position. The consumed
+    /// data are removed when more data are provided.
+    std::string buffer_;
+
+    /// @brief Position of the next character to be read from the buffer.
+    size_t buffer_pos_;
+
+    /// @brief Length of the body specified in the "Content-Length" header.
+    uint64_t body_length_;
 
     /// @brief Reference to the request object specified in the constructor.
     HttpRequest& request_;
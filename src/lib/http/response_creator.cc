@@ -1,4 +1,4 @@
-// Copyright (C) 2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2016-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -19,7 +19,8 @@ HttpResponseCreator::createHttpResponse(const ConstHttpRequestPtr& request) {
 
     // If not finalized, the request parsing failed. Generate HTTP 400.
     if (!request->isFinalized()) {
-        return (createStockBadRequest(request));
+        return (createStockHttpResponse(request,
+                                        HttpStatusCode::BAD_REQUEST));
     }
 
     // Message has been successfully parsed. Create implementation specific
@@ -27,5 +28,27 @@ HttpResponseCreator::createHttpResponse(const ConstHttpRequestPtr& request) {
     return (createDynamicHttpResponse(request));
 }
 
+void
+HttpResponseCreator::asyncCreateHttpResponse(const ConstHttpRequestPtr& request,
+                                             const HttpResponseHandler& handler) {
+    if (!request) {
+        isc_throw(HttpResponseError, "internal server error: HTTP request is null");
+    }
+
+    if (!request->isFinalized()) {
+        handler(createStockHttpResponse(request, HttpStatusCode::BAD_REQUEST));
+        return;
+    }
+
+    asyncCreateDynamicHttpResponse(request, handler);
+}
+
+void
+HttpResponseCreator::
+asyncCreateDynamicHttpResponse(const ConstHttpRequestPtr& request,
+                               const HttpResponseHandler& handler) {
+    handler(createDynamicHttpResponse(request));
+}
+
 }
 }
@@ -9,10 +9,16 @@
 
 #include <http/request.h>
 #include <http/response.h>
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
 
 namespace isc {
 namespace http {
 
+/// @brief Type of the callback receiving the HTTP response created
+/// asynchronously.
+typedef boost::function<void(const HttpResponsePtr&)> HttpResponseHandler;
+
 /// @brief Specifies an interface for classes creating HTTP responses
 /// from HTTP requests.
 ///
@@ -37,6 +43,17 @@ public:
     /// Classes with virtual functions need virtual destructors.
     virtual ~HttpResponseCreator() { };
 
+    /// @brief Create a new request.
+    ///
+    /// This method creates a bare instance of the @ref HttpRequest or
+    /// its derivation. The @ref HttpConnection calls this method to create
+    /// the object into which each request received over the connection is
+    /// parsed. The derived classes return the objects of the request types
+    /// they expect, e.g. @ref PostHttpRequestJson.
+    ///
+    /// @return Pointer to the new instance of the @ref HttpRequest.
+    virtual HttpRequestPtr createNewHttpRequest() const = 0;
+
     /// @brief Create HTTP response from HTTP request received.
     ///
     /// This class implements a generic logic for creating a HTTP response.
@@ -55,7 +72,7 @@ public:
     /// This method accepts instances of both finalized and not finalized
     /// requests. If the request isn't finalized it indicates that
     /// the request parsing has failed. In such case, this method calls
-    /// @c createStockBadRequest to generate a response with HTTP 400 status
+    /// @c createStockHttpResponse to generate a response with HTTP 400 status
     /// code. If the request is finalized, this method calls
     /// @c createDynamicHttpResponse to generate implementation specific
     /// response to the received request.
@@ -70,14 +87,41 @@ public:
     virtual HttpResponsePtr
     createHttpResponse(const ConstHttpRequestPtr& request) final;
 
-protected:
+    /// @brief Create HTTP response from HTTP request received, without
+    /// waiting for the response to be created.
+    ///
+    /// This is the asynchronous counterpart of @c createHttpResponse used
+    /// by the @ref HttpConnection, so as the server keeps serving other
+    /// connections while the response is created. The requests which
+    /// couldn't be parsed are handled the same way. The response to the
+    /// parsed request is created by @c asyncCreateDynamicHttpResponse.
+    ///
+    /// The handler may be invoked before this method returns or later,
+    /// from the IO service.
+    ///
+    /// @param request Pointer to an object representing HTTP request.
+    /// @param handler Callback invoked with the created response.
+    /// @throw HttpResponseError if request is a NULL pointer.
+    virtual void
+    asyncCreateHttpResponse(const ConstHttpRequestPtr& request,
+                            const HttpResponseHandler& handler) final;
 
-    /// @brief Creates implementation specific HTTP 400 response.
+    /// @brief Creates implementation specific HTTP response with the
+    /// specified status code and no request specific content.
+    ///
+    /// This method is used to generate the error responses, e.g. HTTP 400
+    /// when the request couldn't be parsed or HTTP 408 when the request
+    /// hasn't been received within the specified timeout. The request may
+    /// not be finalized in these cases.
     ///
     /// @param request Pointer to an object representing HTTP request.
-    /// @return Pointer to an object representing HTTP 400 response.
+    /// @param status_code Status code of the response.
+    /// @return Pointer to an object representing HTTP response.
     virtual HttpResponsePtr
-    createStockBadRequest(const ConstHttpRequestPtr& request) const = 0;
+    createStockHttpResponse(const ConstHttpRequestPtr& request,
+                            const HttpStatusCode& status_code) const = 0;
+
+protected:
 
     /// @brief Creates implementation specific HTTP response.
     ///
@@ -86,8 +130,25 @@ protected:
     virtual HttpResponsePtr
     createDynamicHttpResponse(const ConstHttpRequestPtr& request) = 0;
 
+    /// @brief Creates implementation specific HTTP response without
+    /// waiting for it to be created.
+    ///
+    /// The default implementation passes the response created by
+    /// @c createDynamicHttpResponse to the handler. The derived classes
+    /// which wait for other events to create the response, e.g. for the
+    /// answers of other servers, override this method.
+    ///
+    /// @param request Pointer to an object representing HTTP request.
+    /// @param handler Callback invoked with the created response.
+    virtual void
+    asyncCreateDynamicHttpResponse(const ConstHttpRequestPtr& request,
+                                   const HttpResponseHandler& handler);
+
 };
 
+/// @brief Pointer to the @ref HttpResponseCreator object.
+typedef boost::shared_ptr<HttpResponseCreator> HttpResponseCreatorPtr;
+
 } // namespace http
 } // namespace isc
 
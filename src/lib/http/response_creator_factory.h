@@ -0,0 +1,47 @@
+// Copyright (C) 2017 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef HTTP_RESPONSE_CREATOR_FACTORY_H
+#define HTTP_RESPONSE_CREATOR_FACTORY_H
+
+#include <http/response_creator.h>
+#include <boost/shared_ptr.hpp>
+
+namespace isc {
+namespace http {
+
+/// @brief Specifies the interface for implementing custom factory classes
+/// used to create instances of @ref HttpResponseCreator.
+///
+/// The @ref HttpListener creates a new instance of the
+/// @ref HttpResponseCreator for each accepted connection, so as the
+/// connections don't share the state of the creator. The listener uses
+/// the factory specified by the server to create the instances of the
+/// server specific creator.
+class HttpResponseCreatorFactory {
+public:
+
+    /// @brief Virtual destructor.
+    virtual ~HttpResponseCreatorFactory() { }
+
+    /// @brief Returns an instance of the @ref HttpResponseCreator.
+    ///
+    /// The implementations may return the same instance for each call if
+    /// the creator holds no per connection state.
+    ///
+    /// @return Pointer to the instance of the @ref HttpResponseCreator.
+    virtual HttpResponseCreatorPtr create() const = 0;
+
+};
+
+/// @brief Pointer to the @ref HttpResponseCreatorFactory.
+typedef boost::shared_ptr<HttpResponseCreatorFactory>
+HttpResponseCreatorFactoryPtr;
+
+} // end of namespace isc::http
+} // end of namespace isc
+
+#endif
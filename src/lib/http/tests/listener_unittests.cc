@@ -0,0 +1,524 @@
+// Copyright (C) 2017 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+#include <asiolink/asio_wrapper.h>
+#include <asiolink/interval_timer.h>
+#include <asiolink/io_address.h>
+#include <asiolink/io_service.h>
+#include <http/listener.h>
+#include <http/post_request_json.h>
+#include <http/response_creator.h>
+#include <http/response_creator_factory.h>
+#include <http/response_json.h>
+#include <boost/bind.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <gtest/gtest.h>
+#include <array>
+#include <list>
+#include <string>
+
+using namespace boost::asio::ip;
+using namespace isc::asiolink;
+using namespace isc::http;
+
+namespace {
+
+/// @brief IP address to which HTTP service is bound.
+const std::string SERVER_ADDRESS = "127.0.0.1";
+
+/// @brief Port number to which HTTP service is bound.
+const unsigned short SERVER_PORT = 18123;
+
+/// @brief Request timeout used in most of the tests (ms).
+const long REQUEST_TIMEOUT = 10000;
+
+/// @brief Idle timeout used in most of the tests (ms).
+const long IDLE_TIMEOUT = 10000;
+
+/// @brief Test timeout (ms).
+const long TEST_TIMEOUT = 10000;
+
+/// @brief Body of the requests sent in the tests.
+const std::string REQUEST_BODY = "{ \"command\": \"config-get\" }";
+
+/// @brief Implementation of the @ref HttpResponseCreator.
+class TestHttpResponseCreator : public HttpResponseCreator {
+public:
+
+    /// @brief Create a new request.
+    ///
+    /// @return Pointer to the new instance of the @ref HttpRequest.
+    virtual HttpRequestPtr
+    createNewHttpRequest() const {
+        return (HttpRequestPtr(new PostHttpRequestJson()));
+    }
+
+    /// @brief Creates HTTP response with the specified status code.
+    ///
+    /// @param request Pointer to the HTTP request.
+    /// @param status_code Status code of the response.
+    /// @return Pointer to the generated HTTP response.
+    virtual HttpResponsePtr
+    createStockHttpResponse(const ConstHttpRequestPtr& request,
+                            const HttpStatusCode& status_code) const {
+        // The version is unknown if the request line hasn't been received.
+        HttpVersion http_version(request->context()->http_version_major_,
+                                 request->context()->http_version_minor_);
+        if (http_version.major_ == 0) {
+            http_version = HttpVersion(1, 1);
+        }
+        return (HttpResponsePtr(new HttpResponseJson(http_version,
+                                                     status_code)));
+    }
+
+private:
+
+    /// @brief Creates HTTP response.
+    ///
+    /// @param request Pointer to the HTTP request.
+    /// @return Pointer to the generated HTTP OK response.
+    virtual HttpResponsePtr
+    createDynamicHttpResponse(const ConstHttpRequestPtr& request) {
+        return (HttpResponsePtr(new HttpResponseJson(request->getHttpVersion(),
+                                                     HttpStatusCode::OK)));
+    }
+};
+
+/// @brief Implementation of the test @ref HttpResponseCreatorFactory.
+///
+/// This factory class creates @ref TestHttpResponseCreator instances.
+class TestHttpResponseCreatorFactory : public HttpResponseCreatorFactory {
+public:
+
+    /// @brief Creates @ref TestHttpResponseCreator instance.
+    virtual HttpResponseCreatorPtr create() const {
+        HttpResponseCreatorPtr response_creator(new TestHttpResponseCreator());
+        return (response_creator);
+    }
+};
+
+/// @brief Returns a HTTP request with the JSON body.
+///
+/// @param version HTTP version, e.g. "1.1".
+/// @param extra_headers Headers appended to the required headers, each
+/// terminated with "\r\n".
+std::string
+makeRequest(const std::string& version = "1.1",
+            const std::string& extra_headers = "") {
+    return ("POST /foo/bar HTTP/" + version + "\r\n"
+            "Content-Type: application/json\r\n" + extra_headers +
+            "Content-Length: " +
+            boost::lexical_cast<std::string>(REQUEST_BODY.length()) +
+            "\r\n\r\n" + REQUEST_BODY);
+}
+
+/// @brief Entity which can connect to the HTTP server endpoint.
+///
+/// The client sends the request and collects the responses until the
+/// expected number of complete responses has been received or the server
+/// has closed the connection.
+class TestHttpClient : public boost::noncopyable {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// @param io_service IO service to be stopped when the client is done.
+    explicit TestHttpClient(IOService& io_service)
+        : io_service_(io_service.get_io_service()), socket_(io_service_),
+          buf_(), response_(), expected_responses_(0), closed_(false) {
+    }
+
+    /// @brief Destructor.
+    ~TestHttpClient() {
+        close();
+    }
+
+    /// @brief Connects to the server and sends the request.
+    ///
+    /// @param request Data to be sent.
+    /// @param expected_responses Number of the responses after which the
+    /// client stops the IO service. The value of 0 means that the client
+    /// waits until the server closes the connection.
+    void startRequest(const std::string& request,
+                      const size_t expected_responses = 1) {
+        expected_responses_ = expected_responses;
+        tcp::endpoint endpoint(address::from_string(SERVER_ADDRESS),
+                               SERVER_PORT);
+        socket_.async_connect(endpoint,
+                              [this, request](const boost::system::error_code& ec) {
+            if (ec) {
+                ADD_FAILURE() << "error occurred while connecting: "
+                              << ec.message();
+                io_service_.stop();
+                return;
+            }
+            sendRequest(request);
+        });
+    }
+
+    /// @brief Sends the request over the established connection.
+    ///
+    /// @param request Data to be sent.
+    /// @param expected_responses Number of the complete responses after
+    /// which the client stops the IO service, including the responses
+    /// received so far.
+    void sendRequest(const std::string& request,
+                     const size_t expected_responses = 0) {
+        if (expected_responses > 0) {
+            expected_responses_ = expected_responses;
+        }
+        request_ = request;
+        boost::asio::async_write(socket_, boost::asio::buffer(request_),
+                                 [this](const boost::system::error_code& ec,
+                                        std::size_t /*bytes_transferred*/) {
+            if (ec) {
+                ADD_FAILURE() << "error occurred while sending: "
+                              << ec.message();
+                io_service_.stop();
+                return;
+            }
+            receiveResponse();
+        });
+    }
+
+    /// @brief Receives the response data.
+    void receiveResponse() {
+        socket_.async_read_some(boost::asio::buffer(buf_.data(), buf_.size()),
+                                [this](const boost::system::error_code& ec,
+                                       std::size_t bytes_transferred) {
+            if (ec) {
+                // The server has closed the connection.
+                closed_ = true;
+                io_service_.stop();
+                return;
+            }
+
+            response_.append(buf_.data(), bytes_transferred);
+            if ((expected_responses_ > 0) &&
+                (getResponses().size() >= expected_responses_)) {
+                io_service_.stop();
+                return;
+            }
+            receiveResponse();
+        });
+    }
+
+    /// @brief Returns the complete responses received so far.
+    std::list<std::string> getResponses() const {
+        std::list<std::string> responses;
+        size_t pos = 0;
+        for (;;) {
+            size_t headers_end = response_.find("\r\n\r\n", pos);
+            if (headers_end == std::string::npos) {
+                break;
+            }
+            headers_end += 4;
+
+            size_t length = 0;
+            size_t length_pos = response_.find("Content-Length: ", pos);
+            if ((length_pos != std::string::npos) && (length_pos < headers_end)) {
+                length_pos += 16;
+                length = boost::lexical_cast<size_t>
+                    (response_.substr(length_pos,
+                                      response_.find("\r\n", length_pos) -
+                                      length_pos));
+            }
+
+            if (response_.size() < headers_end + length) {
+                break;
+            }
+            responses.push_back(response_.substr(pos, headers_end + length - pos));
+            pos = headers_end + length;
+        }
+        return (responses);
+    }
+
+    /// @brief Returns all data received from the server.
+    const std::string& getResponse() const {
+        return (response_);
+    }
+
+    /// @brief Checks if the server has closed the connection.
+    bool isClosed() const {
+        return (closed_);
+    }
+
+    /// @brief Closes the connection.
+    void close() {
+        socket_.close();
+    }
+
+private:
+
+    /// @brief Holds reference to the IO service.
+    boost::asio::io_service& io_service_;
+
+    /// @brief A socket used for the connection.
+    tcp::socket socket_;
+
+    /// @brief Buffer into which response is written.
+    std::array<char, 8192> buf_;
+
+    /// @brief Request being sent.
+    std::string request_;
+
+    /// @brief Data received from the server.
+    std::string response_;
+
+    /// @brief Number of the responses to wait for.
+    size_t expected_responses_;
+
+    /// @brief Indicates if the server has closed the connection.
+    bool closed_;
+};
+
+/// @brief Pointer to the TestHttpClient.
+typedef boost::shared_ptr<TestHttpClient> TestHttpClientPtr;
+
+/// @brief Test fixture class for @ref HttpListener.
+class HttpListenerTest : public ::testing::Test {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// Starts test timer which detects timeouts.
+    HttpListenerTest()
+        : io_service_(), factory_(new TestHttpResponseCreatorFactory()),
+          test_timer_(io_service_) {
+        test_timer_.setup(boost::bind(&HttpListenerTest::timeoutHandler, this),
+                          TEST_TIMEOUT, IntervalTimer::ONE_SHOT);
+    }
+
+    /// @brief Callback function invoke upon test timeout.
+    ///
+    /// It stops the IO service and reports test timeout.
+    void timeoutHandler() {
+        ADD_FAILURE() << "Timeout occurred while running the test!";
+        io_service_.stop();
+    }
+
+    /// @brief Creates and starts the listener.
+    ///
+    /// @param request_timeout Request timeout (ms).
+    /// @param idle_timeout Idle timeout (ms).
+    /// @param max_request_size Maximum size of the request (bytes).
+    void startListener(const long request_timeout = REQUEST_TIMEOUT,
+                       const long idle_timeout = IDLE_TIMEOUT,
+                       const size_t max_request_size = 0) {
+        listener_.reset(new HttpListener(io_service_,
+                                         IOAddress(SERVER_ADDRESS),
+                                         SERVER_PORT, factory_,
+                                         request_timeout, idle_timeout,
+                                         max_request_size));
+        ASSERT_NO_THROW(listener_->start());
+    }
+
+    /// @brief Connects to the server, sends the request and runs the IO
+    /// service until the client is done.
+    ///
+    /// @param request Data to be sent.
+    /// @param expected_responses Number of the responses to wait for. The
+    /// value of 0 means that the client waits until the server closes the
+    /// connection.
+    void runClient(const std::string& request,
+                   const size_t expected_responses = 1) {
+        client_.reset(new TestHttpClient(io_service_));
+        client_->startRequest(request, expected_responses);
+        io_service_.run();
+        io_service_.get_io_service().reset();
+    }
+
+    /// @brief IO service used in the tests.
+    IOService io_service_;
+
+    /// @brief Pointer to the response creator factory.
+    HttpResponseCreatorFactoryPtr factory_;
+
+    /// @brief Asynchronous timer service to detect timeouts.
+    IntervalTimer test_timer_;
+
+    /// @brief Listener under test.
+    HttpListenerPtr listener_;
+
+    /// @brief Client connected to the listener.
+    TestHttpClientPtr client_;
+};
+
+// This test verifies that the listener can't be created with invalid
+// parameters.
+TEST_F(HttpListenerTest, invalidParameters) {
+    EXPECT_THROW(HttpListener(io_service_, IOAddress(SERVER_ADDRESS),
+                              SERVER_PORT, HttpResponseCreatorFactoryPtr(),
+                              REQUEST_TIMEOUT, IDLE_TIMEOUT),
+                 HttpListenerError);
+    EXPECT_THROW(HttpListener(io_service_, IOAddress(SERVER_ADDRESS),
+                              SERVER_PORT, factory_, 0, IDLE_TIMEOUT),
+                 HttpListenerError);
+    EXPECT_THROW(HttpListener(io_service_, IOAddress(SERVER_ADDRESS),
+                              SERVER_PORT, factory_, REQUEST_TIMEOUT, 0),
+                 HttpListenerError);
+
+    HttpListener listener(io_service_, IOAddress(SERVER_ADDRESS),
+                          SERVER_PORT, factory_, REQUEST_TIMEOUT,
+                          IDLE_TIMEOUT);
+    EXPECT_EQ(SERVER_ADDRESS, listener.getLocalAddress().toText());
+    EXPECT_EQ(SERVER_PORT, listener.getLocalPort());
+}
+
+// This test verifies that the HTTP/1.1 connection is kept open after
+// sending the response and that it is used for the next request.
+TEST_F(HttpListenerTest, persistentConnection) {
+    ASSERT_NO_FATAL_FAILURE(startListener());
+    ASSERT_NO_FATAL_FAILURE(runClient(makeRequest()));
+
+    std::list<std::string> responses = client_->getResponses();
+    ASSERT_EQ(1, responses.size());
+    EXPECT_EQ(0, responses.front().find("HTTP/1.1 200 OK\r\n"));
+    EXPECT_EQ(std::string::npos, responses.front().find("Connection:"));
+    EXPECT_FALSE(client_->isClosed());
+
+    // Send the next request over the same connection.
+    client_->sendRequest(makeRequest(), 2);
+    io_service_.run();
+
+    responses = client_->getResponses();
+    ASSERT_EQ(2, responses.size());
+    EXPECT_EQ(0, responses.back().find("HTTP/1.1 200 OK\r\n"));
+    EXPECT_FALSE(client_->isClosed());
+}
+
+// This test verifies that the requests sent without waiting for the
+// responses are all answered in order.
+TEST_F(HttpListenerTest, pipelinedRequests) {
+    ASSERT_NO_FATAL_FAILURE(startListener());
+    ASSERT_NO_FATAL_FAILURE(runClient(makeRequest() + makeRequest() +
+                                      makeRequest("1.1", "Connection: close\r\n"),
+                                      0));
+
+    std::list<std::string> responses = client_->getResponses();
+    ASSERT_EQ(3, responses.size());
+    for (auto response = responses.begin(); response != responses.end();
+         ++response) {
+        EXPECT_EQ(0, response->find("HTTP/1.1 200 OK\r\n"));
+    }
+    EXPECT_NE(std::string::npos, responses.back().find("Connection: close"));
+    EXPECT_TRUE(client_->isClosed());
+}
+
+// This test verifies that the server closes the connection after sending
+// the response when the client sends the "Connection: close" header.
+TEST_F(HttpListenerTest, connectionClose) {
+    ASSERT_NO_FATAL_FAILURE(startListener());
+    ASSERT_NO_FATAL_FAILURE(runClient(makeRequest("1.1",
+                                                  "Connection: close\r\n"),
+                                      0));
+
+    std::list<std::string> responses = client_->getResponses();
+    ASSERT_EQ(1, responses.size());
+    EXPECT_EQ(0, responses.front().find("HTTP/1.1 200 OK\r\n"));
+    EXPECT_NE(std::string::npos, responses.front().find("Connection: close"));
+    EXPECT_TRUE(client_->isClosed());
+}
+
+// This test verifies that the HTTP/1.0 connection is closed after sending
+// the response unless the client asks for the persistent connection.
+TEST_F(HttpListenerTest, http10) {
+    ASSERT_NO_FATAL_FAILURE(startListener());
+    ASSERT_NO_FATAL_FAILURE(runClient(makeRequest("1.0"), 0));
+
+    std::list<std::string> responses = client_->getResponses();
+    ASSERT_EQ(1, responses.size());
+    EXPECT_EQ(0, responses.front().find("HTTP/1.0 200 OK\r\n"));
+    EXPECT_TRUE(client_->isClosed());
+
+    ASSERT_NO_FATAL_FAILURE(runClient(makeRequest("1.0",
+                                                  "Connection: Keep-Alive\r\n")));
+    responses = client_->getResponses();
+    ASSERT_EQ(1, responses.size());
+    EXPECT_EQ(0, responses.front().find("HTTP/1.0 200 OK\r\n"));
+    EXPECT_NE(std::string::npos,
+              responses.front().find("Connection: keep-alive"));
+    EXPECT_FALSE(client_->isClosed());
+}
+
+// This test verifies that the server responds with HTTP 400 and closes
+// the connection when the request is malformed.
+TEST_F(HttpListenerTest, badRequest) {
+    ASSERT_NO_FATAL_FAILURE(startListener());
+    ASSERT_NO_FATAL_FAILURE(runClient("POST /foo/bar HTTP/1.1\r\n"
+                                      "Content-Type: text/html\r\n"
+                                      "Content-Length: 2\r\n\r\n{}", 0));
+
+    std::list<std::string> responses = client_->getResponses();
+    ASSERT_EQ(1, responses.size());
+    EXPECT_EQ(0, responses.front().find("HTTP/1.1 400 Bad Request\r\n"));
+    EXPECT_NE(std::string::npos, responses.front().find("Connection: close"));
+    EXPECT_TRUE(client_->isClosed());
+}
+
+// This test verifies that the server responds with HTTP 408 and closes
+// the connection when the request is not received within the timeout.
+TEST_F(HttpListenerTest, requestTimeout) {
+    ASSERT_NO_FATAL_FAILURE(startListener(1000));
+    // Send a partial request.
+    ASSERT_NO_FATAL_FAILURE(runClient("POST /foo/bar HTTP/1.1\r\n"
+                                      "Content-Type: application/json\r\n",
+                                      0));
+
+    std::list<std::string> responses = client_->getResponses();
+    ASSERT_EQ(1, responses.size());
+    EXPECT_EQ(0, responses.front().find("HTTP/1.1 408 Request Time-out\r\n"));
+    EXPECT_TRUE(client_->isClosed());
+}
+
+// This test verifies that the server responds with HTTP 413 and closes
+// the connection when the request exceeds the size limit.
+TEST_F(HttpListenerTest, requestTooLarge) {
+    ASSERT_NO_FATAL_FAILURE(startListener(REQUEST_TIMEOUT, IDLE_TIMEOUT,
+                                          100));
+    ASSERT_NO_FATAL_FAILURE(runClient(makeRequest(), 0));
+
+    std::list<std::string> responses = client_->getResponses();
+    ASSERT_EQ(1, responses.size());
+    EXPECT_EQ(0, responses.front().find("HTTP/1.1 413 Request Entity Too "
+                                        "Large\r\n"));
+    EXPECT_TRUE(client_->isClosed());
+}
+
+// This test verifies that the server closes the persistent connection
+// when no request arrives within the idle timeout.
+TEST_F(HttpListenerTest, idleTimeout) {
+    ASSERT_NO_FATAL_FAILURE(startListener(REQUEST_TIMEOUT, 1000));
+    ASSERT_NO_FATAL_FAILURE(runClient(makeRequest()));
+    ASSERT_EQ(1, client_->getResponses().size());
+
+    // Wait for the server to close the connection.
+    client_->receiveResponse();
+    io_service_.run();
+
+    EXPECT_EQ(1, client_->getResponses().size());
+    EXPECT_TRUE(client_->isClosed());
+}
+
+// This test verifies that the listener handles many connections at
+// the same time.
+TEST_F(HttpListenerTest, concurrentConnections) {
+    ASSERT_NO_FATAL_FAILURE(startListener());
+
+    // The first client sends a partial request and keeps the connection.
+    TestHttpClient slow_client(io_service_);
+    slow_client.startRequest("POST /foo/bar HTTP/1.1\r\n", 1);
+
+    // The second client is answered regardless.
+    ASSERT_NO_FATAL_FAILURE(runClient(makeRequest()));
+    ASSERT_EQ(1, client_->getResponses().size());
+    EXPECT_TRUE(slow_client.getResponses().empty());
+}
+
+}
@@ -11,6 +11,7 @@
 #include <http/request_parser.h>
 #include <http/post_request_json.h>
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <sstream>
 
 using namespace isc::data;
@@ -169,9 +170,69 @@ TEST_F(HttpRequestParserTest, extraneousDataInRequest) {
     EXPECT_FALSE(parser.needData());
     EXPECT_TRUE(parser.httpParseOk());
     EXPECT_TRUE(parser.getErrorMessage().empty());
+
+    // The garbage should be returned as unparsed data.
+    EXPECT_EQ("some stuff which, if parsed, will cause errors",
+              parser.getUnparsedData());
 }
 
 
+// This test verifies that the request delivered one byte at a time is
+// parsed correctly, i.e. the parser can be interrupted at any point
+// while it consumes the runs of characters in bulk.
+TEST_F(HttpRequestParserTest, singleByteChunks) {
+    std::string http_req = "POST /foo/bar HTTP/1.1\r\n"
+        "Content-Type: application/json\r\n"
+        "X-Forwarded-For: 192.0.2.1\r\n";
+    std::string json = "{ \"service\": \"dhcp4\", \"command\": \"shutdown\" }";
+    http_req = createRequestString(http_req, json);
+
+    PostHttpRequestJson request;
+    HttpRequestParser parser(request);
+    ASSERT_NO_THROW(parser.initModel());
+
+    for (size_t i = 0; i < http_req.size(); ++i) {
+        parser.postBuffer(&http_req[i], 1);
+        parser.poll();
+        if (i + 1 < http_req.size()) {
+            ASSERT_TRUE(parser.needData()) << "at byte " << i;
+        }
+    }
+
+    ASSERT_FALSE(parser.needData());
+    ASSERT_TRUE(parser.httpParseOk());
+    EXPECT_EQ(HttpRequest::Method::HTTP_POST, request.getMethod());
+    EXPECT_EQ("/foo/bar", request.getUri());
+    EXPECT_EQ("application/json", request.getHeaderValue("Content-Type"));
+    EXPECT_EQ("192.0.2.1", request.getHeaderValue("X-Forwarded-For"));
+    EXPECT_EQ(json, request.getBody());
+    EXPECT_TRUE(parser.getUnparsedData().empty());
+}
+
+// This test verifies that the large body delivered in chunks is copied
+// completely and the data following the body are not consumed.
+TEST_F(HttpRequestParserTest, largeBody) {
+    std::string http_req = "POST /foo/bar HTTP/1.1\r\n"
+        "Content-Type: application/json\r\n";
+    std::string body(1024 * 1024, 'a');
+    http_req = createRequestString(http_req, body) + "POST";
+
+    HttpRequestParser parser(request_);
+    ASSERT_NO_THROW(parser.initModel());
+
+    // Use chunks which don't end at the boundary of the body.
+    const size_t chunk = 4000;
+    for (size_t i = 0; i < http_req.size(); i += chunk) {
+        parser.postBuffer(&http_req[i], std::min(chunk, http_req.size() - i));
+        parser.poll();
+    }
+
+    ASSERT_FALSE(parser.needData());
+    ASSERT_TRUE(parser.httpParseOk());
+    EXPECT_EQ(body, request_.getBody());
+    EXPECT_EQ("POST", parser.getUnparsedData());
+}
+
 // This test verifies that LWS is parsed correctly. The LWS marks line breaks
 // in the HTTP header values.
 TEST_F(HttpRequestParserTest, getLWS) {
@@ -317,6 +378,14 @@ TEST_F(HttpRequestParserTest, invalidHeaderName) {
     testInvalidHttpRequest(http_req);
 }
 
+// This test verifies that error is reported when HTTP header value
+// contains a control character.
+TEST_F(HttpRequestParserTest, controlCharInHeaderValue) {
+    std::string http_req = "POST /foo/ HTTP/1.1\r\n"
+        "Content-Type: text/\x01html\r\n\r\n";
+    testInvalidHttpRequest(http_req);
+}
+
 // This test verifies that error is reported when HTTP header value
 // is not preceded with the colon character.
 TEST_F(HttpRequestParserTest, noColonInHttpHeader) {
@@ -11,6 +11,7 @@
 #include <http/response_creator.h>
 #include <http/response_json.h>
 #include <http/tests/response_test.h>
+#include <boost/bind.hpp>
 #include <boost/shared_ptr.hpp>
 #include <gtest/gtest.h>
 
@@ -27,14 +28,24 @@ typedef boost::shared_ptr<Response> ResponsePtr;
 
 /// @brief Implementation of the @ref HttpResponseCreator.
 class TestHttpResponseCreator : public HttpResponseCreator {
-private:
+public:
 
-    /// @brief Creates HTTP 400 response.
+    /// @brief Creates a new HTTP request.
+    ///
+    /// @return Pointer to the new instance of the @ref HttpRequest.
+    virtual HttpRequestPtr
+    createNewHttpRequest() const {
+        return (HttpRequestPtr(new HttpRequest()));
+    }
+
+    /// @brief Creates HTTP response with the specified status code.
     ///
     /// @param request Pointer to the HTTP request.
-    /// @return Pointer to the generated HTTP 400 response.
+    /// @param status_code Status code of the response.
+    /// @return Pointer to the generated HTTP response.
     virtual HttpResponsePtr
-    createStockBadRequest(const ConstHttpRequestPtr& request) const {
+    createStockHttpResponse(const ConstHttpRequestPtr& request,
+                            const HttpStatusCode& status_code) const {
         // The request hasn't been finalized so the request object
         // doesn't contain any information about the HTTP version number
         // used. But, the context should have this data (assuming the
@@ -42,11 +53,12 @@ private:
         HttpVersion http_version(request->context()->http_version_major_,
                                  request->context()->http_version_minor_);
         // This will generate the response holding JSON content.
-        ResponsePtr response(new Response(http_version,
-                                          HttpStatusCode::BAD_REQUEST));
+        ResponsePtr response(new Response(http_version, status_code));
         return (response);
     }
 
+private:
+
     /// @brief Creates HTTP response.
     ///
     /// @param request Pointer to the HTTP request.
@@ -61,6 +73,15 @@ private:
     }
 };
 
+/// @brief Handler storing the created response.
+///
+/// @param [out] response Pointer to the stored response.
+/// @param created Created response.
+void
+storeResponse(HttpResponsePtr* response, const HttpResponsePtr& created) {
+    *response = created;
+}
+
 // This test verifies that Bad Request status is generated when the request
 // hasn't been finalized.
 TEST(HttpResponseCreatorTest, badRequest) {
@@ -110,4 +131,53 @@ TEST(HttpResponseCreatorTest, goodRequest) {
               response->toString());
 }
 
+// This test verifies that the stock response with the specified status
+// code is generated.
+TEST(HttpResponseCreatorTest, stockResponse) {
+    HttpRequestPtr request(new HttpRequest());
+    request->context()->http_version_major_ = 1;
+    request->context()->http_version_minor_ = 1;
+
+    TestHttpResponseCreator creator;
+    HttpResponsePtr response;
+    ASSERT_NO_THROW(response = creator.createStockHttpResponse(request,
+                                   HttpStatusCode::REQUEST_TIMEOUT));
+    ASSERT_TRUE(response);
+
+    EXPECT_EQ("HTTP/1.1 408 Request Time-out\r\n"
+              "Content-Length: 45\r\n"
+              "Content-Type: application/json\r\n"
+              "Date: Tue, 19 Dec 2016 18:53:35 GMT\r\n\r\n"
+              "{ \"result\": 408, \"text\": \"Request Time-out\" }",
+              response->toString());
+}
+
+
+// This test verifies that the response created by the default asynchronous
+// implementation is passed to the handler.
+TEST(HttpResponseCreatorTest, asyncGoodRequest) {
+    HttpRequestPtr request(new HttpRequest());
+    request->context()->http_version_major_ = 1;
+    request->context()->http_version_minor_ = 0;
+    request->context()->method_ = "GET";
+    request->context()->uri_ = "/foo";
+    ASSERT_NO_THROW(request->finalize());
+
+    TestHttpResponseCreator creator;
+    HttpResponsePtr response;
+    ASSERT_NO_THROW(creator.asyncCreateHttpResponse(request,
+                        boost::bind(&storeResponse, &response, _1)));
+    ASSERT_TRUE(response);
+
+    EXPECT_EQ("HTTP/1.0 200 OK\r\n"
+              "Content-Type: application/json\r\n"
+              "Date: Tue, 19 Dec 2016 18:53:35 GMT\r\n\r\n",
+              response->toString());
+
+    // Null request is rejected.
+    EXPECT_THROW(creator.asyncCreateHttpResponse(HttpRequestPtr(),
+                     boost::bind(&storeResponse, &response, _1)),
+                 HttpResponseError);
+}
+
 }
@@ -1,4 +1,4 @@
-// Copyright (C) 2015 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -15,32 +15,55 @@ using namespace std;
 using namespace isc::data;
 using namespace boost::posix_time;
 
+namespace {
+
+/// @brief Appends a sample to the JSON list of samples.
+///
+/// @param list list of samples
+/// @param value value of the sample
+/// @param timestamp time when the sample was recorded
+void addSampleJSON(const ElementPtr& list, const ElementPtr& value,
+                   const ptime& timestamp) {
+    ElementPtr entry = Element::createList(); // a single observation
+    entry->add(value);
+    entry->add(Element::create(isc::util::ptimeToText(timestamp)));
+    list->add(entry);
+}
+
+}
+
 namespace isc {
 namespace stats {
 
+const uint32_t Observation::MAX_SAMPLE_COUNT;
+const uint32_t Observation::DEFAULT_AGE_SAMPLE_COUNT;
+
 Observation::Observation(const std::string& name, const int64_t value)
-    :name_(name), type_(STAT_INTEGER) {
+    :name_(name), type_(STAT_INTEGER), max_sample_count_(1),
+     max_sample_age_(0, 0, 0, 0), counter_(new ShardedCounter()), base_(0) {
     setValue(value);
 }
 
 Observation::Observation(const std::string& name, const double value)
-    :name_(name), type_(STAT_FLOAT) {
+    :name_(name), type_(STAT_FLOAT), max_sample_count_(1),
+     max_sample_age_(0, 0, 0, 0), base_(0) {
     setValue(value);
 }
 
 Observation::Observation(const std::string& name, const StatsDuration& value)
-    :name_(name), type_(STAT_DURATION) {
+    :name_(name), type_(STAT_DURATION), max_sample_count_(1),
+     max_sample_age_(0, 0, 0, 0), base_(0) {
     setValue(value);
 }
 
 Observation::Observation(const std::string& name, const std::string& value)
-    :name_(name), type_(STAT_STRING) {
+    :name_(name), type_(STAT_STRING), max_sample_count_(1),
+     max_sample_age_(0, 0, 0, 0), base_(0) {
     setValue(value);
 }
 
 void Observation::addValue(const int64_t value) {
-    IntegerSample current = getInteger();
-    setValue(current.first + value);
+    getShard().add(value);
 }
 
 void Observation::addValue(const double value) {
@@ -59,6 +82,12 @@ void Observation::addValue(const std::string& value) {
 }
 
 void Observation::setValue(const int64_t value) {
+    if (type_ == STAT_INTEGER) {
+        // Merge the updates recorded so far, so as they precede the new
+        // value. The updates recorded later are added to the new value.
+        mergeCounter();
+        base_ = value - counter_->getCollected();
+    }
     setValueInternal(value, integer_samples_, STAT_INTEGER);
 }
 
@@ -83,16 +112,142 @@ void Observation::setValueInternal(SampleType value, StorageType& storage,
                   << typeToText(type_) );
     }
 
-    if (storage.empty()) {
-        storage.push_back(make_pair(value, microsec_clock::local_time()));
-    } else {
+    recordSample(make_pair(value, microsec_clock::local_time()), storage);
+}
+
+template<typename SampleType, typename StorageType>
+void Observation::recordSample(const SampleType& sample,
+                               StorageType& storage) const {
+    storage.push(sample);
+
+    // Discard the samples which are too old, but always keep the newest one.
+    if (max_sample_age_ != StatsDuration(0, 0, 0, 0)) {
+        const ptime oldest_allowed = sample.second - max_sample_age_;
+        while ((storage.size() > 1) &&
+               (storage.oldest().second < oldest_allowed)) {
+            storage.popOldest();
+        }
+    }
+}
+
+void Observation::mergeCounter() const {
+    if (!counter_) {
+        return;
+    }
+
+    std::vector<ShardedCounter::Update> updates;
+    counter_->collect(updates);
+    for (std::vector<ShardedCounter::Update>::const_iterator update =
+             updates.begin(); update != updates.end(); ++update) {
+        IntegerSample sample(base_ + update->first, update->second);
+        // The update may have been made just before the observation was
+        // set, but merged after it. Keep the samples ordered.
+        if (!integer_samples_.empty() &&
+            (sample.second < integer_samples_.at(0).second)) {
+            sample.second = integer_samples_.at(0).second;
+        }
+        recordSample(sample, integer_samples_);
+    }
+}
+
+ShardedCounter::Shard& Observation::getShard() {
+    if (type_ != STAT_INTEGER) {
+        isc_throw(InvalidStatType, "Invalid statistic type requested: "
+                  << typeToText(STAT_INTEGER) << ", but the actual type is "
+                  << typeToText(type_) );
+    }
+    return (counter_->getShard());
+}
+
+void Observation::setMaxSampleCount(const uint32_t max_samples) {
+    if ((max_samples == 0) || (max_samples > MAX_SAMPLE_COUNT)) {
+        isc_throw(BadValue, "invalid maximum number of samples "
+                  << max_samples << " for statistic " << name_
+                  << ", expected a value between 1 and " << MAX_SAMPLE_COUNT);
+    }
+    max_sample_count_ = max_samples;
+    setCapacity(max_sample_count_);
+}
+
+void Observation::setMaxSampleAge(const StatsDuration& duration) {
+    if (duration.is_negative()) {
+        isc_throw(BadValue, "invalid maximum age of samples "
+                  << duration << " for statistic " << name_);
+    }
+    max_sample_age_ = duration;
+    if (max_sample_age_ == StatsDuration(0, 0, 0, 0)) {
+        // Revert to a single value.
+        max_sample_count_ = 1;
+        setCapacity(max_sample_count_);
+
+    } else if (max_sample_count_ == 1) {
+        max_sample_count_ = DEFAULT_AGE_SAMPLE_COUNT;
+        setCapacity(max_sample_count_);
+    }
+}
+
+void Observation::setCapacity(const size_t capacity) {
+    switch (type_) {
+    case STAT_INTEGER:
+        // The shards must hold as many updates as there are samples, so
+        // as no sample is lost when the updates are merged.
+        integer_samples_.setCapacity(capacity);
+        counter_->setCapacity(capacity);
+        mergeCounter();
+        return;
+    case STAT_FLOAT:
+        float_samples_.setCapacity(capacity);
+        return;
+    case STAT_DURATION:
+        duration_samples_.setCapacity(capacity);
+        return;
+    case STAT_STRING:
+        string_samples_.setCapacity(capacity);
+        return;
+    default:
+        isc_throw(InvalidStatType, "Unknown statistic type: "
+                  << typeToText(type_));
+    };
+}
+
+size_t Observation::getSize() const {
+    mergeCounter();
+    const ptime now = microsec_clock::local_time();
+    switch (type_) {
+    case STAT_INTEGER:
+        return (getSizeInternal(integer_samples_, now));
+    case STAT_FLOAT:
+        return (getSizeInternal(float_samples_, now));
+    case STAT_DURATION:
+        return (getSizeInternal(duration_samples_, now));
+    case STAT_STRING:
+        return (getSizeInternal(string_samples_, now));
+    default:
+        isc_throw(InvalidStatType, "Unknown statistic type: "
+                  << typeToText(type_));
+    };
+}
+
+template<typename Storage>
+size_t Observation::getSizeInternal(const Storage& storage,
+                                    const ptime& now) const {
+    if (storage.empty() || (max_sample_age_ == StatsDuration(0, 0, 0, 0))) {
+        return (storage.size());
+    }
 
-        /// @todo: Update once more than one sample is supported
-        *storage.begin() = make_pair(value, microsec_clock::local_time());
+    // The samples may have aged since the last sample was recorded. The
+    // newest sample is always retained.
+    const ptime oldest_allowed = now - max_sample_age_;
+    size_t size = 1;
+    while ((size < storage.size()) &&
+           (storage.at(size).second >= oldest_allowed)) {
+        ++size;
     }
+    return (size);
 }
 
 IntegerSample Observation::getInteger() const {
+    mergeCounter();
     return (getValueInternal<IntegerSample>(integer_samples_, STAT_INTEGER));
 }
 
@@ -122,7 +277,102 @@ SampleType Observation::getValueInternal(Storage& storage, Type exp_type) const
         // still be there.
         isc_throw(Unexpected, "Observation storage container empty");
     }
-    return (*storage.begin());
+    return (storage.at(0));
+}
+
+std::list<IntegerSample> Observation::getIntegers() const {
+    mergeCounter();
+    return (getValuesInternal<IntegerSample>(integer_samples_, STAT_INTEGER));
+}
+
+std::list<FloatSample> Observation::getFloats() const {
+    return (getValuesInternal<FloatSample>(float_samples_, STAT_FLOAT));
+}
+
+std::list<DurationSample> Observation::getDurations() const {
+    return (getValuesInternal<DurationSample>(duration_samples_, STAT_DURATION));
+}
+
+std::list<StringSample> Observation::getStrings() const {
+    return (getValuesInternal<StringSample>(string_samples_, STAT_STRING));
+}
+
+template<typename SampleType, typename Storage>
+std::list<SampleType>
+Observation::getValuesInternal(Storage& storage, Type exp_type) const {
+    if (type_ != exp_type) {
+        isc_throw(InvalidStatType, "Invalid statistic type requested: "
+                  << typeToText(exp_type) << ", but the actual type is "
+                  << typeToText(type_) );
+    }
+
+    if (storage.empty()) {
+        isc_throw(Unexpected, "Observation storage container empty");
+    }
+
+    std::list<SampleType> samples;
+    const size_t size = getSizeInternal(storage, microsec_clock::local_time());
+    for (size_t i = 0; i < size; ++i) {
+        samples.push_back(storage.at(i));
+    }
+    return (samples);
+}
+
+double Observation::getRate() const {
+    double rate = 0.0;
+    double average = 0.0;
+    getRateAndAverage(rate, average);
+    return (rate);
+}
+
+double Observation::getAverage() const {
+    double rate = 0.0;
+    double average = 0.0;
+    getRateAndAverage(rate, average);
+    return (average);
+}
+
+void Observation::getRateAndAverage(double& rate, double& average) const {
+    mergeCounter();
+    switch (type_) {
+    case STAT_INTEGER:
+        getRateInternal(integer_samples_, rate, average);
+        return;
+    case STAT_FLOAT:
+        getRateInternal(float_samples_, rate, average);
+        return;
+    default:
+        isc_throw(InvalidStatType, "Rate and average can't be computed for"
+                  " statistic of type " << typeToText(type_));
+    };
+}
+
+template<typename Storage>
+void Observation::getRateInternal(const Storage& storage, double& rate,
+                                  double& average) const {
+    rate = 0.0;
+    average = 0.0;
+
+    const size_t size = getSizeInternal(storage, microsec_clock::local_time());
+    if (size == 0) {
+        return;
+    }
+
+    double sum = 0.0;
+    for (size_t i = 0; i < size; ++i) {
+        sum += static_cast<double>(storage.at(i).first);
+    }
+    average = sum / size;
+
+    if (size > 1) {
+        const int64_t span = (storage.at(0).second -
+                              storage.at(size - 1).second).total_microseconds();
+        if (span > 0) {
+            rate = (static_cast<double>(storage.at(0).first) -
+                    static_cast<double>(storage.at(size - 1).first)) *
+                1000000.0 / span;
+        }
+    }
 }
 
 std::string Observation::typeToText(Type type) {
@@ -151,36 +401,42 @@ std::string Observation::typeToText(Type type) {
 isc::data::ConstElementPtr
 Observation::getJSON() const {
 
-    ElementPtr entry = isc::data::Element::createList(); // a single observation
-    ElementPtr value;
-    ElementPtr timestamp;
-
-    /// @todo: Add support for retrieving more than one sample for a given
-    /// observation
+    ElementPtr list = isc::data::Element::createList(); // the retained samples
 
     switch (type_) {
     case STAT_INTEGER: {
-        IntegerSample s = getInteger();
-        value = isc::data::Element::create(static_cast<int64_t>(s.first));
-        timestamp = isc::data::Element::create(isc::util::ptimeToText(s.second));
+        std::list<IntegerSample> samples = getIntegers();
+        for (std::list<IntegerSample>::const_iterator s = samples.begin();
+             s != samples.end(); ++s) {
+            addSampleJSON(list, Element::create(static_cast<int64_t>(s->first)),
+                          s->second);
+        }
         break;
     }
     case STAT_FLOAT: {
-        FloatSample s = getFloat();
-        value = isc::data::Element::create(s.first);
-        timestamp = isc::data::Element::create(isc::util::ptimeToText(s.second));
+        std::list<FloatSample> samples = getFloats();
+        for (std::list<FloatSample>::const_iterator s = samples.begin();
+             s != samples.end(); ++s) {
+            addSampleJSON(list, Element::create(s->first), s->second);
+        }
         break;
     }
     case STAT_DURATION: {
-        DurationSample s = getDuration();
-        value = isc::data::Element::create(isc::util::durationToText(s.first));
-        timestamp = isc::data::Element::create(isc::util::ptimeToText(s.second));
+        std::list<DurationSample> samples = getDurations();
+        for (std::list<DurationSample>::const_iterator s = samples.begin();
+             s != samples.end(); ++s) {
+            addSampleJSON(list,
+                          Element::create(isc::util::durationToText(s->first)),
+                          s->second);
+        }
         break;
     }
     case STAT_STRING: {
-        StringSample s = getString();
-        value = isc::data::Element::create(s.first);
-        timestamp = isc::data::Element::create(isc::util::ptimeToText(s.second));
+        std::list<StringSample> samples = getStrings();
+        for (std::list<StringSample>::const_iterator s = samples.begin();
+             s != samples.end(); ++s) {
+            addSampleJSON(list, Element::create(s->first), s->second);
+        }
         break;
     }
     default:
@@ -188,30 +444,47 @@ Observation::getJSON() const {
                   << typeToText(type_));
     };
 
-    entry->add(value);
-    entry->add(timestamp);
-
-    ElementPtr list = isc::data::Element::createList(); // a single observation
-    list->add(entry);
-
     return (list);
 }
 
+isc::data::ConstElementPtr
+Observation::getSummaryJSON() const {
+    ElementPtr summary = isc::data::Element::createMap();
+    summary->set("samples",
+                 isc::data::Element::create(static_cast<int64_t>(getSize())));
+
+    if ((type_ == STAT_INTEGER) || (type_ == STAT_FLOAT)) {
+        double rate = 0.0;
+        double average = 0.0;
+        getRateAndAverage(rate, average);
+        summary->set("rate", isc::data::Element::create(rate));
+        summary->set("average", isc::data::Element::create(average));
+    }
+    return (summary);
+}
+
 void Observation::reset() {
+    // The samples recorded before the reset are discarded, so they are not
+    // taken into account when computing the rate.
     switch(type_) {
     case STAT_INTEGER: {
+        mergeCounter();
+        integer_samples_.clear();
         setValue(static_cast<int64_t>(0));
         return;
     }
     case STAT_FLOAT: {
+        float_samples_.clear();
         setValue(0.0);
         return;
     }
     case STAT_DURATION: {
+        duration_samples_.clear();
         setValue(time_duration(0,0,0,0));
         return;
     }
     case STAT_STRING: {
+        string_samples_.clear();
         setValue(string(""));
         return;
     }
@@ -1,4 +1,4 @@
-// Copyright (C) 2015 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -9,10 +9,12 @@
 
 #include <cc/data.h>
 #include <exceptions/exceptions.h>
+#include <stats/sharded_counter.h>
 #include <boost/shared_ptr.hpp>
 #include <boost/date_time/time_duration.hpp>
 #include <boost/date_time/posix_time/posix_time_types.hpp>
 #include <list>
+#include <vector>
 #include <stdint.h>
 
 namespace isc {
@@ -52,6 +54,109 @@ typedef std::pair<std::string, boost::posix_time::ptime> StringSample;
 
 /// @}
 
+/// @brief Fixed size ring buffer holding the samples of an observation.
+///
+/// The buffer preallocates the storage for the specified number of samples.
+/// When the buffer is full, recording a new sample overwrites the oldest
+/// one, so no memory is allocated when the samples are recorded. The
+/// samples are indexed from the newest (index 0) to the oldest.
+///
+/// @tparam SampleType type of sample (e.g. IntegerSample)
+template<typename SampleType>
+class SampleRing {
+public:
+
+    /// @brief Constructor.
+    ///
+    /// @param capacity maximum number of samples held (must not be 0).
+    explicit SampleRing(const size_t capacity = 1)
+        : samples_(capacity), newest_(0), size_(0) {
+    }
+
+    /// @brief Returns the maximum number of samples held.
+    size_t capacity() const {
+        return (samples_.size());
+    }
+
+    /// @brief Returns the number of samples held.
+    size_t size() const {
+        return (size_);
+    }
+
+    /// @brief Checks if there are no samples.
+    bool empty() const {
+        return (size_ == 0);
+    }
+
+    /// @brief Records a new sample, overwriting the oldest one if the
+    /// buffer is full.
+    ///
+    /// @param sample sample to be recorded.
+    void push(const SampleType& sample) {
+        if (++newest_ == samples_.size()) {
+            newest_ = 0;
+        }
+        samples_[newest_] = sample;
+        if (size_ < samples_.size()) {
+            ++size_;
+        }
+    }
+
+    /// @brief Returns the sample.
+    ///
+    /// @param index index of the sample, where 0 is the newest sample. It
+    /// must be lower than the number of samples held.
+    const SampleType& at(const size_t index) const {
+        const size_t pos = (newest_ >= index ? newest_ - index :
+                            samples_.size() + newest_ - index);
+        return (samples_[pos]);
+    }
+
+    /// @brief Returns the oldest sample.
+    const SampleType& oldest() const {
+        return (at(size_ - 1));
+    }
+
+    /// @brief Discards the oldest sample.
+    void popOldest() {
+        if (size_ > 0) {
+            --size_;
+        }
+    }
+
+    /// @brief Discards all samples.
+    void clear() {
+        size_ = 0;
+    }
+
+    /// @brief Changes the maximum number of samples held.
+    ///
+    /// The newest samples are preserved.
+    ///
+    /// @param capacity new maximum number of samples (must not be 0).
+    void setCapacity(const size_t capacity) {
+        std::vector<SampleType> samples(capacity);
+        const size_t keep = (size_ < capacity ? size_ : capacity);
+        for (size_t i = 0; i < keep; ++i) {
+            samples[keep - 1 - i] = at(i);
+        }
+        samples_.swap(samples);
+        size_ = keep;
+        newest_ = (keep > 0 ? keep - 1 : capacity - 1);
+    }
+
+private:
+
+    /// @brief Preallocated storage for the samples.
+    std::vector<SampleType> samples_;
+
+    /// @brief Position of the newest sample in the storage.
+    size_t newest_;
+
+    /// @brief Number of samples held.
+    size_t size_;
+};
+
 /// @brief Represents a single observable characteristic (a 'statistic')
 ///
 /// Currently it supports one of four types: integer (implemented as signed 64
@@ -66,8 +171,19 @@ typedef std::pair<std::string, boost::posix_time::ptime> StringSample;
 /// @ref getDuration, @ref getString (appropriate type must be used) or
 /// @ref getJSON, which is generic and can be used for all types.
 ///
-/// @todo: Eventually it will be possible to retain multiple samples for the same
-/// observation, but that is outside of scope for 0.9.2.
+/// By default, only the most recent sample is retained. The number of
+/// retained samples can be increased with @ref setMaxSampleCount and the
+/// samples can be limited by age with @ref setMaxSampleAge. The samples are
+/// kept in a @c SampleRing, so recording them doesn't allocate memory. For
+/// integer and floating point statistics, the rate of change and the average
+/// value over the retained samples can be computed with @ref getRate and
+/// @ref getAverage.
+///
+/// The integer observations are backed by a @ref ShardedCounter, so
+/// @ref addValue may be called for them by many threads concurrently
+/// without locking. The updates are merged into the retained samples, with
+/// their own timestamps, when the observation is read or set. All other
+/// methods must be serialized by the caller, e.g. by the @c StatsMgr.
 class Observation {
  public:
 
@@ -86,6 +202,13 @@ class Observation {
         STAT_STRING   ///< this statistic represents a string
     };
 
+    /// @brief Maximum number of samples which can be retained.
+    static const uint32_t MAX_SAMPLE_COUNT = 100000;
+
+    /// @brief Number of samples retained when only the age of the samples
+    /// is limited.
+    static const uint32_t DEFAULT_AGE_SAMPLE_COUNT = 1024;
+
     /// @brief Constructor for integer observations
     ///
     /// @param name observation name
@@ -136,6 +259,10 @@ class Observation {
 
     /// @brief Records incremental integer observation
     ///
+    /// This method doesn't take any lock and may be called concurrently by
+    /// many threads. The update is recorded in the shard of the calling
+    /// thread and merged into the samples when the observation is read.
+    ///
     /// @param value integer value observed
     /// @throw InvalidStatType if statistic is not integer
     void addValue(const int64_t value);
@@ -163,6 +290,52 @@ class Observation {
     /// Sets statistic to a neutral (0, 0.0 or "") value.
     void reset();
 
+    /// @brief Determines how many samples should be retained.
+    ///
+    /// When the limit is reached, recording a new sample discards the
+    /// oldest one. The value of 1 means that only the current value is
+    /// retained, which is the default.
+    ///
+    /// @param max_samples maximum number of retained samples.
+    /// @throw BadValue if the value is 0 or greater than
+    /// @c MAX_SAMPLE_COUNT.
+    void setMaxSampleCount(const uint32_t max_samples);
+
+    /// @brief Determines maximum age of retained samples.
+    ///
+    /// The samples older than the specified duration are discarded, but the
+    /// most recent sample is always retained. The number of samples is still
+    /// limited by @ref setMaxSampleCount. If only a single sample has been
+    /// retained so far, the limit is raised to @c DEFAULT_AGE_SAMPLE_COUNT.
+    /// The duration of 0 reverts the statistic to a single value.
+    ///
+    /// @param duration maximum age of retained samples.
+    /// @throw BadValue if the duration is negative.
+    void setMaxSampleAge(const StatsDuration& duration);
+
+    /// @brief Returns the shard of the counter used by the calling thread
+    /// to update the integer observation.
+    ///
+    /// The shard may be cached by the callers updating the observation
+    /// often. It remains valid as long as the observation.
+    ///
+    /// @return reference to the shard
+    /// @throw InvalidStatType if statistic is not integer
+    ShardedCounter::Shard& getShard();
+
+    /// @brief Returns maximum number of retained samples.
+    uint32_t getMaxSampleCount() const {
+        return (max_sample_count_);
+    }
+
+    /// @brief Returns maximum age of retained samples (0 if not limited).
+    StatsDuration getMaxSampleAge() const {
+        return (max_sample_age_);
+    }
+
+    /// @brief Returns the number of retained samples.
+    size_t getSize() const;
+
     /// @brief Returns statistic type
     /// @return statistic type
     Type getType() const {
@@ -189,10 +362,57 @@ class Observation {
     /// @throw InvalidStatType if statistic is not a string
     StringSample getString() const;
 
+    /// @brief Returns retained integer samples, the newest first
+    /// @return list of samples
+    /// @throw InvalidStatType if statistic is not integer
+    std::list<IntegerSample> getIntegers() const;
+
+    /// @brief Returns retained float samples, the newest first
+    /// @return list of samples
+    /// @throw InvalidStatType if statistic is not fp
+    std::list<FloatSample> getFloats() const;
+
+    /// @brief Returns retained duration samples, the newest first
+    /// @return list of samples
+    /// @throw InvalidStatType if statistic is not time duration
+    std::list<DurationSample> getDurations() const;
+
+    /// @brief Returns retained string samples, the newest first
+    /// @return list of samples
+    /// @throw InvalidStatType if statistic is not a string
+    std::list<StringSample> getStrings() const;
+
+    /// @brief Returns the rate of change of the statistic.
+    ///
+    /// The rate is computed between the oldest and the newest retained
+    /// samples. It is 0 if less than two samples are retained.
+    ///
+    /// @return change of the value per second
+    /// @throw InvalidStatType if statistic is not integer or fp
+    double getRate() const;
+
+    /// @brief Returns the average value of the retained samples.
+    ///
+    /// @return average value
+    /// @throw InvalidStatType if statistic is not integer or fp
+    double getAverage() const;
+
     /// @brief Returns as a JSON structure
+    ///
+    /// The retained samples are returned, the newest first.
+    ///
     /// @return JSON structures representing all observations
     isc::data::ConstElementPtr getJSON() const;
 
+    /// @brief Returns the summary of the retained samples as a JSON structure
+    ///
+    /// The summary is a map containing the number of the retained samples
+    /// ("samples") and, for integer and floating point statistics, the rate
+    /// of change per second ("rate") and the average value ("average").
+    ///
+    /// @return JSON map with the summary
+    isc::data::ConstElementPtr getSummaryJSON() const;
+
     /// @brief Converts statistic type to string
     /// @return textual name of statistic type
     static std::string typeToText(Type type);
@@ -210,7 +430,7 @@ private:
     /// available storages.
     ///
     /// @tparam SampleType type of sample (e.g. IntegerSample)
-    /// @tparam StorageType type of storage (e.g. list<IntegerSample>)
+    /// @tparam StorageType type of storage (e.g. SampleRing<IntegerSample>)
     /// @param value observation to be recorded
     /// @param storage observation will be stored here
     /// @param exp_type expected observation type (used for sanity checking)
@@ -219,10 +439,25 @@ private:
     void setValueInternal(SampleType value, StorageType& storage,
                           Type exp_type);
 
+    /// @brief Records a sample, discarding the samples which are too old
+    ///
+    /// @tparam SampleType type of sample (e.g. IntegerSample)
+    /// @tparam StorageType type of storage (e.g. SampleRing<IntegerSample>)
+    /// @param sample sample to be recorded
+    /// @param storage sample will be stored here
+    template<typename SampleType, typename StorageType>
+    void recordSample(const SampleType& sample, StorageType& storage) const;
+
+    /// @brief Merges the updates of the integer observation recorded in the
+    /// counter into the samples.
+    ///
+    /// It does nothing for other types of observations.
+    void mergeCounter() const;
+
     /// @brief Returns a sample (internal version)
     ///
     /// @tparam SampleType type of sample (e.g. IntegerSample)
-    /// @tparam StorageType type of storage (e.g. list<IntegerSample>)
+    /// @tparam StorageType type of storage (e.g. SampleRing<IntegerSample>)
     /// @param observation storage
     /// @param exp_type expected observation type (used for sanity checking)
     /// @throw InvalidStatType if observation type mismatches
@@ -230,6 +465,52 @@ private:
     template<typename SampleType, typename Storage>
     SampleType getValueInternal(Storage& storage, Type exp_type) const;
 
+    /// @brief Returns retained samples (internal version)
+    ///
+    /// The samples older than the maximum age are skipped, except the
+    /// newest one.
+    ///
+    /// @tparam SampleType type of sample (e.g. IntegerSample)
+    /// @tparam StorageType type of storage (e.g. SampleRing<IntegerSample>)
+    /// @param observation storage
+    /// @param exp_type expected observation type (used for sanity checking)
+    /// @throw InvalidStatType if observation type mismatches
+    /// @return list of samples, the newest first
+    template<typename SampleType, typename Storage>
+    std::list<SampleType> getValuesInternal(Storage& storage,
+                                            Type exp_type) const;
+
+    /// @brief Returns the number of retained samples (internal version)
+    ///
+    /// @tparam StorageType type of storage (e.g. SampleRing<IntegerSample>)
+    /// @param observation storage
+    /// @param now current time
+    template<typename Storage>
+    size_t getSizeInternal(const Storage& storage,
+                           const boost::posix_time::ptime& now) const;
+
+    /// @brief Computes the rate and the average (internal version)
+    ///
+    /// @tparam StorageType type of storage (e.g. SampleRing<IntegerSample>)
+    /// @param observation storage
+    /// @param [out] rate change of the value per second
+    /// @param [out] average average value
+    template<typename Storage>
+    void getRateInternal(const Storage& storage, double& rate,
+                         double& average) const;
+
+    /// @brief Computes the rate and the average of the statistic
+    ///
+    /// @param [out] rate change of the value per second
+    /// @param [out] average average value
+    /// @throw InvalidStatType if statistic is not integer or fp
+    void getRateAndAverage(double& rate, double& average) const;
+
+    /// @brief Changes the capacity of the storage of the statistic
+    ///
+    /// @param capacity new maximum number of samples
+    void setCapacity(const size_t capacity);
+
     /// @brief Observation (statistic) name
     std::string name_;
 
@@ -244,17 +525,37 @@ private:
     /// @{
 
     /// @brief Storage for integer samples
-    std::list<IntegerSample> integer_samples_;
+    ///
+    /// It is updated with the updates recorded in the @c counter_ when the
+    /// observation is read.
+    mutable SampleRing<IntegerSample> integer_samples_;
 
     /// @brief Storage for floating point samples
-    std::list<FloatSample> float_samples_;
+    SampleRing<FloatSample> float_samples_;
 
     /// @brief Storage for time duration samples
-    std::list<DurationSample> duration_samples_;
+    SampleRing<DurationSample> duration_samples_;
 
     /// @brief Storage for string samples
-    std::list<StringSample> string_samples_;
+    SampleRing<StringSample> string_samples_;
     /// @}
+
+    /// @brief Maximum number of retained samples
+    uint32_t max_sample_count_;
+
+    /// @brief Maximum age of retained samples (0 if not limited)
+    StatsDuration max_sample_age_;
+
+    /// @brief Counter holding the updates of the integer observation
+    ///
+    /// It is null for other types of observations.
+    ShardedCounterPtr counter_;
+
+    /// @brief Value of the integer observation when the counter was 0
+    ///
+    /// The value of the observation is the sum of this value and the value
+    /// of the counter. It is adjusted when the observation is set.
+    int64_t base_;
 };
 
 /// @brief Observation pointer
@@ -0,0 +1,280 @@
+// Copyright (C) 2017 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <stats/sharded_counter.h>
+#include <boost/date_time/gregorian/gregorian.hpp>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/scoped_array.hpp>
+#include <algorithm>
+
+using namespace boost::posix_time;
+
+namespace {
+
+/// @brief Returns the time the timestamps of the updates are relative to.
+const ptime& getEpoch() {
+    static const ptime epoch(boost::gregorian::date(1970, 1, 1));
+    return (epoch);
+}
+
+/// @brief Change of the counter made by a single update.
+struct Change {
+    /// @brief Time of the update in microseconds since the epoch.
+    int64_t time_;
+
+    /// @brief Value added by the update.
+    int64_t delta_;
+};
+
+/// @brief Checks if the change has been made before the other one.
+bool earlier(const Change& change1, const Change& change2) {
+    return (change1.time_ < change2.time_);
+}
+
+}
+
+namespace isc {
+namespace stats {
+
+class ShardedCounter::Log : public boost::noncopyable {
+public:
+
+    /// @brief Update read from the log.
+    struct Record {
+        /// @brief Index of the update.
+        uint64_t index_;
+
+        /// @brief Sum of the values added by the owner after the update.
+        int64_t total_;
+
+        /// @brief Time of the update in microseconds since the epoch.
+        int64_t time_;
+    };
+
+    /// @brief Checks if the update precedes the other one.
+    static bool precedes(const Record& record1, const Record& record2) {
+        return (record1.index_ < record2.index_);
+    }
+
+    /// @brief Constructor.
+    ///
+    /// @param capacity number of slots.
+    explicit Log(const size_t capacity)
+        : slots_(new Slot[capacity]), capacity_(capacity) {
+    }
+
+    /// @brief Returns the number of slots.
+    size_t getCapacity() const {
+        return (capacity_);
+    }
+
+    /// @brief Records the update in the slot for its index.
+    ///
+    /// The sequence number of the slot is odd while the slot is written
+    /// and then set to the even number identifying the update.
+    ///
+    /// @param index index of the update.
+    /// @param total sum of the values added by the owner after the update.
+    /// @param time time of the update in microseconds since the epoch.
+    void write(const uint64_t index, const int64_t total, const int64_t time) {
+        Slot& slot = slots_[index % capacity_];
+        slot.seq_.store(2 * index + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        slot.total_.store(total, std::memory_order_relaxed);
+        slot.time_.store(time, std::memory_order_relaxed);
+        slot.seq_.store(2 * index + 2, std::memory_order_release);
+    }
+
+    /// @brief Reads the updates held in the log.
+    ///
+    /// A slot being written is read again when the writer is done.
+    ///
+    /// @param first index of the first update to be read.
+    /// @param [out] records the updates are appended here, in no particular
+    /// order.
+    void read(const uint64_t first, std::vector<Record>& records) const {
+        for (size_t i = 0; i < capacity_; ++i) {
+            const Slot& slot = slots_[i];
+            for (;;) {
+                const uint64_t seq = slot.seq_.load(std::memory_order_acquire);
+                if ((seq & 1) != 0) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                Record record;
+                record.total_ = slot.total_.load(std::memory_order_relaxed);
+                record.time_ = slot.time_.load(std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (slot.seq_.load(std::memory_order_relaxed) != seq) {
+                    continue;
+                }
+                // The sequence number of 0 denotes an unused slot.
+                if ((seq != 0) && (seq / 2 - 1 >= first)) {
+                    record.index_ = seq / 2 - 1;
+                    records.push_back(record);
+                }
+                break;
+            }
+        }
+    }
+
+private:
+
+    /// @brief Slot of the log.
+    struct Slot {
+        /// @brief Constructor.
+        Slot() : seq_(0), total_(0), time_(0) {
+        }
+
+        /// @brief Sequence number.
+        std::atomic<uint64_t> seq_;
+
+        /// @brief Sum of the values added by the owner after the update.
+        std::atomic<int64_t> total_;
+
+        /// @brief Time of the update in microseconds since the epoch.
+        std::atomic<int64_t> time_;
+    };
+
+    /// @brief Slots.
+    boost::scoped_array<Slot> slots_;
+
+    /// @brief Number of slots.
+    size_t capacity_;
+};
+
+ShardedCounter::Shard::Shard(const std::thread::id& owner,
+                             const size_t capacity)
+    : owner_(owner), next_(0), total_(0), next_index_(0),
+      log_(new Log(capacity)), collected_index_(0), collected_total_(0) {
+}
+
+ShardedCounter::Shard::~Shard() {
+    delete log_.load();
+    for (std::vector<Log*>::const_iterator log = retired_.begin();
+         log != retired_.end(); ++log) {
+        delete *log;
+    }
+}
+
+void
+ShardedCounter::Shard::add(const int64_t value) {
+    const int64_t total = total_.load(std::memory_order_relaxed) + value;
+    total_.store(total, std::memory_order_relaxed);
+    const int64_t time = (microsec_clock::local_time() -
+                          getEpoch()).total_microseconds();
+    const uint64_t index = next_index_++;
+
+    Log* log = log_.load(std::memory_order_acquire);
+    for (;;) {
+        log->write(index, total, time);
+        // If the log has been replaced in the meantime, the consumer may
+        // have read the old one before the update was written, so the
+        // update is written to the new log too. The fence pairs with the
+        // one in collect.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        Log* current = log_.load(std::memory_order_acquire);
+        if (current == log) {
+            return;
+        }
+        log = current;
+    }
+}
+
+ShardedCounter::ShardedCounter(const size_t capacity)
+    : shards_(0), capacity_(capacity), collected_total_(0) {
+}
+
+ShardedCounter::~ShardedCounter() {
+    Shard* shard = shards_.load();
+    while (shard) {
+        Shard* next = shard->next_;
+        delete shard;
+        shard = next;
+    }
+}
+
+ShardedCounter::Shard&
+ShardedCounter::getShard() {
+    const std::thread::id self = std::this_thread::get_id();
+    for (Shard* shard = shards_.load(std::memory_order_acquire); shard;
+         shard = shard->next_) {
+        if (shard->owner_ == self) {
+            return (*shard);
+        }
+    }
+
+    // Only the calling thread may add its own shard, so there is no need
+    // to check again if it exists when the list has changed meanwhile.
+    Shard* shard = new Shard(self, capacity_.load(std::memory_order_relaxed));
+    shard->next_ = shards_.load(std::memory_order_relaxed);
+    while (!shards_.compare_exchange_weak(shard->next_, shard,
+                                          std::memory_order_release,
+                                          std::memory_order_relaxed)) {
+    }
+    return (*shard);
+}
+
+int64_t
+ShardedCounter::get() const {
+    int64_t value = 0;
+    for (Shard* shard = shards_.load(std::memory_order_acquire); shard;
+         shard = shard->next_) {
+        value += shard->total_.load(std::memory_order_relaxed);
+    }
+    return (value);
+}
+
+void
+ShardedCounter::collect(std::vector<Update>& updates) {
+    const size_t capacity = capacity_.load(std::memory_order_relaxed);
+    std::vector<Change> changes;
+    std::vector<Log::Record> records;
+
+    for (Shard* shard = shards_.load(std::memory_order_acquire); shard;
+         shard = shard->next_) {
+        records.clear();
+        Log* log = shard->log_.load(std::memory_order_relaxed);
+        if (log->getCapacity() != capacity) {
+            // Replace the log before reading the old one. The update
+            // written concurrently is either read from the old log or
+            // written again by the owner to the new log.
+            shard->retired_.push_back(log);
+            shard->log_.store(new Log(capacity), std::memory_order_seq_cst);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+        log->read(shard->collected_index_, records);
+        std::sort(records.begin(), records.end(), Log::precedes);
+
+        for (std::vector<Log::Record>::const_iterator record = records.begin();
+             record != records.end(); ++record) {
+            Change change;
+            change.time_ = record->time_;
+            change.delta_ = record->total_ - shard->collected_total_;
+            changes.push_back(change);
+            shard->collected_total_ = record->total_;
+            shard->collected_index_ = record->index_ + 1;
+        }
+    }
+
+    // Each change is accounted for once, so the resulting values are
+    // exact even when some updates of a shard have been overwritten.
+    std::stable_sort(changes.begin(), changes.end(), earlier);
+    for (std::vector<Change>::const_iterator change = changes.begin();
+         change != changes.end(); ++change) {
+        collected_total_ += change->delta_;
+        updates.push_back(Update(collected_total_, getEpoch() +
+                                 microseconds(change->time_)));
+    }
+}
+
+void
+ShardedCounter::setCapacity(const size_t capacity) {
+    capacity_.store(capacity, std::memory_order_relaxed);
+}
+
+};
+};
@@ -0,0 +1,177 @@
+// Copyright (C) 2017 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef SHARDED_COUNTER_H
+#define SHARDED_COUNTER_H
+
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+#include <atomic>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <stdint.h>
+
+namespace isc {
+namespace stats {
+
+/// @brief Integer counter which can be updated by many threads without
+/// locking.
+///
+/// Each thread updating the counter gets its own shard, allocated when
+/// the thread first updates the counter, so the threads don't contend for
+/// the same memory when they update the counter at the same time. Each
+/// update is recorded in the shard together with its timestamp, in a log
+/// holding the most recent updates. The log is a ring of slots guarded by
+/// sequence numbers: the thread owning the shard is the only writer and
+/// never waits for the readers.
+///
+/// The updates are merged by a single consumer calling @ref collect,
+/// which returns the values of the counter after each update recorded
+/// since the previous call, in the order of their timestamps. If more
+/// updates than the capacity of the log have been made by a thread in
+/// the meantime, the older ones are skipped, but their changes are still
+/// accounted for in the returned values.
+///
+/// The @ref collect and @ref setCapacity methods must not be called
+/// concurrently with each other, but may be called concurrently with
+/// the updates.
+class ShardedCounter : public boost::noncopyable {
+private:
+
+    /// @brief Log of the updates of a shard.
+    class Log;
+
+public:
+
+    /// @brief Value of the counter after an update and the time of the
+    /// update.
+    typedef std::pair<int64_t, boost::posix_time::ptime> Update;
+
+    /// @brief Part of the counter updated by a single thread.
+    class Shard : public boost::noncopyable {
+    public:
+
+        /// @brief Adds the value to the counter.
+        ///
+        /// This method must only be called by the thread owning the shard.
+        ///
+        /// @param value value to be added (may be negative).
+        void add(const int64_t value);
+
+    private:
+
+        /// @brief Constructor.
+        ///
+        /// @param owner identifier of the thread owning the shard.
+        /// @param capacity maximum number of updates held in the log.
+        Shard(const std::thread::id& owner, const size_t capacity);
+
+        /// @brief Destructor.
+        ~Shard();
+
+        /// @brief Identifier of the thread owning the shard.
+        std::thread::id owner_;
+
+        /// @brief Next shard of the counter.
+        Shard* next_;
+
+        /// @brief Sum of the values added by the owner.
+        std::atomic<int64_t> total_;
+
+        /// @brief Index of the next update recorded by the owner.
+        uint64_t next_index_;
+
+        /// @brief Log of the recent updates.
+        std::atomic<Log*> log_;
+
+        /// @brief Logs replaced by @ref ShardedCounter::collect when the
+        /// capacity changed.
+        ///
+        /// They are only freed with the shard, because the owner may still
+        /// write to them.
+        std::vector<Log*> retired_;
+
+        /// @brief Index of the first update not collected yet.
+        uint64_t collected_index_;
+
+        /// @brief Sum of the values added by the owner as of the last
+        /// collected update.
+        int64_t collected_total_;
+
+        friend class ShardedCounter;
+    };
+
+    /// @brief Constructor.
+    ///
+    /// Creates a counter with the value of 0 and no shards.
+    ///
+    /// @param capacity maximum number of updates held by each shard
+    /// between the calls to @ref collect (must not be 0).
+    explicit ShardedCounter(const size_t capacity = 1);
+
+    /// @brief Destructor.
+    ~ShardedCounter();
+
+    /// @brief Returns the shard of the calling thread, creating it if the
+    /// thread hasn't updated the counter yet.
+    ///
+    /// The callers updating the counter often may cache the returned
+    /// shard, which remains valid as long as the counter.
+    Shard& getShard();
+
+    /// @brief Adds the value to the counter using the shard of the calling
+    /// thread.
+    ///
+    /// @param value value to be added (may be negative).
+    void add(const int64_t value) {
+        getShard().add(value);
+    }
+
+    /// @brief Returns the current value of the counter, i.e. the sum of
+    /// all shards.
+    int64_t get() const;
+
+    /// @brief Returns the value of the counter as of the last update
+    /// returned by @ref collect.
+    int64_t getCollected() const {
+        return (collected_total_);
+    }
+
+    /// @brief Collects the updates recorded since the previous call.
+    ///
+    /// @param [out] updates the values of the counter after the updates
+    /// and their timestamps are appended here, the oldest first.
+    void collect(std::vector<Update>& updates);
+
+    /// @brief Changes the maximum number of updates held by each shard.
+    ///
+    /// The logs of the existing shards are replaced by the next call to
+    /// @ref collect.
+    ///
+    /// @param capacity new maximum number of updates (must not be 0).
+    void setCapacity(const size_t capacity);
+
+private:
+
+    /// @brief Head of the list of the shards.
+    std::atomic<Shard*> shards_;
+
+    /// @brief Maximum number of updates held by each shard.
+    std::atomic<size_t> capacity_;
+
+    /// @brief Value of the counter as of the last collected update.
+    int64_t collected_total_;
+};
+
+/// @brief Pointer to the @c ShardedCounter.
+typedef boost::shared_ptr<ShardedCounter> ShardedCounterPtr;
+
+};
+};
+
+#endif // SHARDED_COUNTER_H
@@ -1,4 +1,4 @@
-// Copyright (C) 2015 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -12,6 +12,39 @@
 using namespace std;
 using namespace isc::data;
 using namespace isc::config;
+using namespace isc::util::thread;
+
+namespace {
+
+/// @brief Shards of the integer statistics cached by a thread.
+struct ShardCache {
+    /// @brief Shard of a statistic.
+    struct Entry {
+        /// @brief Statistic, held so as the shard remains valid.
+        isc::stats::ObservationPtr stat_;
+
+        /// @brief Shard used by the thread.
+        isc::stats::ShardedCounter::Shard* shard_;
+    };
+
+    /// @brief Type of the container holding the shards by names.
+    typedef std::map<std::string, Entry> ShardMap;
+
+    /// @brief Constructor.
+    ShardCache() : generation_(0) {
+    }
+
+    /// @brief Generation of the statistics held in the cache.
+    uint64_t generation_;
+
+    /// @brief Cached shards.
+    ShardMap shards_;
+};
+
+/// @brief Cache of the shards used by the calling thread.
+thread_local ShardCache shard_cache;
+
+}
 
 namespace isc {
 namespace stats {
@@ -22,47 +55,88 @@ StatsMgr& StatsMgr::instance() {
 }
 
 StatsMgr::StatsMgr()
-    :global_(new StatContext()) {
+    :global_(new StatContext()), generation_(1) {
 
 }
 
 void StatsMgr::setValue(const std::string& name, const int64_t value) {
+    Mutex::Locker lock(mutex_);
     setValueInternal(name, value);
 }
 
 void StatsMgr::setValue(const std::string& name, const double value) {
+    Mutex::Locker lock(mutex_);
     setValueInternal(name, value);
 }
 
 void StatsMgr::setValue(const std::string& name, const StatsDuration& value) {
+    Mutex::Locker lock(mutex_);
     setValueInternal(name, value);
 }
 void StatsMgr::setValue(const std::string& name, const std::string& value) {
+    Mutex::Locker lock(mutex_);
     setValueInternal(name, value);
 }
 
 void StatsMgr::addValue(const std::string& name, const int64_t value) {
-    addValueInternal(name, value);
+    getShard(name).add(value);
 }
 
 void StatsMgr::addValue(const std::string& name, const double value) {
+    Mutex::Locker lock(mutex_);
     addValueInternal(name, value);
 }
 
 void StatsMgr::addValue(const std::string& name, const StatsDuration& value) {
+    Mutex::Locker lock(mutex_);
     addValueInternal(name, value);
 }
 
 void StatsMgr::addValue(const std::string& name, const std::string& value) {
+    Mutex::Locker lock(mutex_);
     addValueInternal(name, value);
 }
 
 ObservationPtr StatsMgr::getObservation(const std::string& name) const {
+    Mutex::Locker lock(mutex_);
+    return (getObservationInternal(name));
+}
+
+ObservationPtr StatsMgr::getObservationInternal(const std::string& name) const {
     /// @todo: Implement contexts.
     // Currently we keep everyting in a global context.
     return (global_->get(name));
 }
 
+ShardedCounter::Shard& StatsMgr::getShard(const std::string& name) {
+    // Flush the cache if any statistic has been removed since it was
+    // filled, so as the updates are not recorded in removed statistics.
+    const uint64_t generation = generation_.load(std::memory_order_acquire);
+    if (shard_cache.generation_ != generation) {
+        shard_cache.shards_.clear();
+        shard_cache.generation_ = generation;
+    }
+
+    ShardCache::ShardMap::const_iterator cached =
+        shard_cache.shards_.find(name);
+    if (cached != shard_cache.shards_.end()) {
+        return (*cached->second.shard_);
+    }
+
+    ShardCache::Entry entry;
+    {
+        Mutex::Locker lock(mutex_);
+        entry.stat_ = getObservationInternal(name);
+        if (!entry.stat_) {
+            entry.stat_.reset(new Observation(name, static_cast<int64_t>(0)));
+            addObservation(entry.stat_);
+        }
+        entry.shard_ = &entry.stat_->getShard();
+    }
+    shard_cache.shards_[name] = entry;
+    return (*entry.shard_);
+}
+
 void StatsMgr::addObservation(const ObservationPtr& stat) {
     /// @todo: Implement contexts.
     // Currently we keep everyting in a global context.
@@ -75,17 +149,33 @@ bool StatsMgr::deleteObservation(const std::string& name) {
     return (global_->del(name));
 }
 
-void StatsMgr::setMaxSampleAge(const std::string& ,
-                               const StatsDuration&) {
-    isc_throw(NotImplemented, "setMaxSampleAge not implemented");
+bool StatsMgr::setMaxSampleAge(const std::string& name,
+                               const StatsDuration& duration) {
+    Mutex::Locker lock(mutex_);
+    ObservationPtr obs = getObservationInternal(name);
+    if (obs) {
+        obs->setMaxSampleAge(duration);
+        return (true);
+    } else {
+        return (false);
+    }
 }
 
-void StatsMgr::setMaxSampleCount(const std::string& , uint32_t){
-    isc_throw(NotImplemented, "setMaxSampleCount not implemented");
+bool StatsMgr::setMaxSampleCount(const std::string& name,
+                                 uint32_t max_samples) {
+    Mutex::Locker lock(mutex_);
+    ObservationPtr obs = getObservationInternal(name);
+    if (obs) {
+        obs->setMaxSampleCount(max_samples);
+        return (true);
+    } else {
+        return (false);
+    }
 }
 
 bool StatsMgr::reset(const std::string& name) {
-    ObservationPtr obs = getObservation(name);
+    Mutex::Locker lock(mutex_);
+    ObservationPtr obs = getObservationInternal(name);
     if (obs) {
         obs->reset();
         return (true);
@@ -95,24 +185,42 @@ bool StatsMgr::reset(const std::string& name) {
 }
 
 bool StatsMgr::del(const std::string& name) {
-    return (global_->del(name));
+    Mutex::Locker lock(mutex_);
+    if (global_->del(name)) {
+        generation_.fetch_add(1, std::memory_order_release);
+        return (true);
+    }
+    return (false);
 }
 
 void StatsMgr::removeAll() {
+    Mutex::Locker lock(mutex_);
     global_->stats_.clear();
+    generation_.fetch_add(1, std::memory_order_release);
 }
 
 isc::data::ConstElementPtr StatsMgr::get(const std::string& name) const {
     isc::data::ElementPtr response = isc::data::Element::createMap(); // a map
-    ObservationPtr obs = getObservation(name);
+    Mutex::Locker lock(mutex_);
+    ObservationPtr obs = getObservationInternal(name);
     if (obs) {
         response->set(name, obs->getJSON()); // that contains the observation
     }
     return (response);
 }
 
+isc::data::ConstElementPtr StatsMgr::getSummary(const std::string& name) const {
+    Mutex::Locker lock(mutex_);
+    ObservationPtr obs = getObservationInternal(name);
+    if (obs) {
+        return (obs->getSummaryJSON());
+    }
+    return (isc::data::ConstElementPtr());
+}
+
 isc::data::ConstElementPtr StatsMgr::getAll() const {
     isc::data::ElementPtr map = isc::data::Element::createMap(); // a map
+    Mutex::Locker lock(mutex_);
 
     // Let's iterate over all stored statistics...
     for (std::map<std::string, ObservationPtr>::iterator s = global_->stats_.begin();
@@ -125,6 +233,8 @@ isc::data::ConstElementPtr StatsMgr::getAll() const {
 }
 
 void StatsMgr::resetAll() {
+    Mutex::Locker lock(mutex_);
+
     // Let's iterate over all stored statistics...
     for (std::map<std::string, ObservationPtr>::iterator s = global_->stats_.begin();
          s != global_->stats_.end(); ++s) {
@@ -135,6 +245,7 @@ void StatsMgr::resetAll() {
 }
 
 size_t StatsMgr::count() const {
+    Mutex::Locker lock(mutex_);
     return (global_->stats_.size());
 }
 
@@ -145,8 +256,68 @@ StatsMgr::statisticGetHandler(const std::string& /*name*/,
     if (!getStatName(params, name, error)) {
         return (createAnswer(CONTROL_RESULT_ERROR, error));
     }
-    return (createAnswer(CONTROL_RESULT_SUCCESS,
-                         instance().get(name)));
+    ConstElementPtr summary_param = params->get("summary");
+    if (summary_param && (summary_param->getType() != Element::boolean)) {
+        return (createAnswer(CONTROL_RESULT_ERROR,
+                             "'summary' parameter expected to be a boolean."));
+    }
+
+    ConstElementPtr response = instance().get(name);
+    if (summary_param && summary_param->boolValue()) {
+        ConstElementPtr summary = instance().getSummary(name);
+        if (summary) {
+            ElementPtr map = Element::createMap();
+            map->set(name, response->get(name));
+            map->set("summary", summary);
+            response = map;
+        }
+    }
+    return (createAnswer(CONTROL_RESULT_SUCCESS, response));
+}
+
+isc::data::ConstElementPtr
+StatsMgr::statisticSetMaxSampleAgeHandler(const std::string& /*name*/,
+                                          const isc::data::ConstElementPtr& params) {
+    std::string name, error;
+    int64_t duration = 0;
+    if (!getStatName(params, name, error) ||
+        !getIntegerParam(params, "duration", duration, error)) {
+        return (createAnswer(CONTROL_RESULT_ERROR, error));
+    }
+
+    try {
+        if (instance().setMaxSampleAge(name, StatsDuration(0, 0, duration, 0))) {
+            return (createAnswer(CONTROL_RESULT_SUCCESS,
+                                 "Statistic '" + name + "' duration limit is set."));
+        }
+    } catch (const std::exception& ex) {
+        return (createAnswer(CONTROL_RESULT_ERROR, ex.what()));
+    }
+    return (createAnswer(CONTROL_RESULT_ERROR,
+                         "No '" + name + "' statistic found"));
+}
+
+isc::data::ConstElementPtr
+StatsMgr::statisticSetMaxSampleCountHandler(const std::string& /*name*/,
+                                            const isc::data::ConstElementPtr& params) {
+    std::string name, error;
+    int64_t max_samples = 0;
+    if (!getStatName(params, name, error) ||
+        !getIntegerParam(params, "max-samples", max_samples, error)) {
+        return (createAnswer(CONTROL_RESULT_ERROR, error));
+    }
+    if ((max_samples <= 0) || (max_samples > Observation::MAX_SAMPLE_COUNT)) {
+        return (createAnswer(CONTROL_RESULT_ERROR,
+                             "'max-samples' parameter out of range."));
+    }
+
+    if (instance().setMaxSampleCount(name,
+                                     static_cast<uint32_t>(max_samples))) {
+        return (createAnswer(CONTROL_RESULT_SUCCESS,
+                             "Statistic '" + name + "' count limit is set."));
+    }
+    return (createAnswer(CONTROL_RESULT_ERROR,
+                         "No '" + name + "' statistic found"));
 }
 
 isc::data::ConstElementPtr
@@ -228,5 +399,24 @@ StatsMgr::getStatName(const isc::data::ConstElementPtr& params,
     return (true);
 }
 
+bool
+StatsMgr::getIntegerParam(const isc::data::ConstElementPtr& params,
+                          const std::string& param_name,
+                          int64_t& value,
+                          std::string& reason) {
+    ConstElementPtr param = params->get(param_name);
+    if (!param) {
+        reason = "Missing mandatory '" + param_name + "' parameter.";
+        return (false);
+    }
+    if (param->getType() != Element::integer) {
+        reason = "'" + param_name + "' parameter expected to be an integer.";
+        return (false);
+    }
+
+    value = param->intValue();
+    return (true);
+}
+
 };
 };
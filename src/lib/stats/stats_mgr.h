@@ -1,4 +1,4 @@
-// Copyright (C) 2015 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -9,8 +9,10 @@
 
 #include <stats/observation.h>
 #include <stats/context.h>
+#include <util/threads/sync.h>
 #include <boost/noncopyable.hpp>
 
+#include <atomic>
 #include <map>
 #include <string>
 #include <vector>
@@ -42,6 +44,18 @@ namespace stats {
 /// this approach is how to extract data, but that will remain unsolvable
 /// until we get the control socket implementation.
 ///
+/// The integer statistics, which include all packet and subnet counters
+/// updated for each processed packet, are backed by the
+/// @ref ShardedCounter objects. The @ref addValue method for an integer
+/// statistic looks up the shard of the calling thread in a thread local
+/// cache and records the update in it without taking any lock. The updates
+/// are merged, with their timestamps, into the samples of the observation
+/// when it is read, e.g. by @ref get, @ref getAll or through the pointer
+/// returned by @ref getObservation. The remaining methods, including
+/// the ones retrieving the statistics, are serialized using a mutex, so
+/// the statistics may be retrieved by a thread other than the ones
+/// processing the packets.
+///
 /// Statistics Manager does not use logging by design. The reasons are:
 /// - performance impact (logging every observation would degrade performance
 ///   significantly. While it's possible to log on sufficiently high debug
@@ -100,6 +114,9 @@ class StatsMgr : public boost::noncopyable {
 
     /// @brief Records incremental integer observation.
     ///
+    /// This method doesn't take any lock when the statistic has already been
+    /// used by the calling thread.
+    ///
     /// @param name name of the observation
     /// @param value integer value observed
     /// @throw InvalidStatType if statistic is not integer
@@ -132,15 +149,19 @@ class StatsMgr : public boost::noncopyable {
     /// but rather as a set of values. duration determines the timespan.
     /// Samples older than duration will be discarded. This is time-constrained
     /// approach. For sample count constrained approach, see @ref
-    /// setMaxSampleCount() below.
-    ///
-    /// @todo: Not implemented.
+    /// setMaxSampleCount() below. See @ref Observation::setMaxSampleAge
+    /// for details.
     ///
     /// Example: to set a statistic to keep observations for the last 5 minutes,
     /// call setMaxSampleAge("incoming-packets", time_duration(0,5,0,0));
     /// to revert statistic to a single value, call:
     /// setMaxSampleAge("incoming-packets" time_duration(0,0,0,0))
-    void setMaxSampleAge(const std::string& name, const StatsDuration& duration);
+    ///
+    /// @param name name of the statistic
+    /// @param duration maximum age of the samples
+    /// @return true if successful, false if there's no such statistic
+    /// @throw BadValue if the duration is negative
+    bool setMaxSampleAge(const std::string& name, const StatsDuration& duration);
 
     /// @brief Determines how many samples of a given statistic should be kept.
     ///
@@ -148,12 +169,15 @@ class StatsMgr : public boost::noncopyable {
     /// rather as a set of values. In this form, at most max_samples will be kept.
     /// When adding max_samples+1 sample, the oldest sample will be discarded.
     ///
-    /// @todo: Not implemented.
-    ///
     /// Example:
     /// To set a statistic to keep the last 100 observations, call:
     /// setMaxSampleCount("incoming-packets", 100);
-    void setMaxSampleCount(const std::string& name, uint32_t max_samples);
+    ///
+    /// @param name name of the statistic
+    /// @param max_samples maximum number of the samples
+    /// @return true if successful, false if there's no such statistic
+    /// @throw BadValue if the number is 0 or is too large
+    bool setMaxSampleCount(const std::string& name, uint32_t max_samples);
 
     /// @}
 
@@ -193,6 +217,14 @@ class StatsMgr : public boost::noncopyable {
     /// @return JSON structures representing a single statistic
     isc::data::ConstElementPtr get(const std::string& name) const;
 
+    /// @brief Returns the summary of a single statistic as a JSON structure.
+    ///
+    /// See @ref Observation::getSummaryJSON for details.
+    ///
+    /// @param name name of the statistic
+    /// @return JSON map with the summary or null if there's no such statistic
+    isc::data::ConstElementPtr getSummary(const std::string& name) const;
+
     /// @brief Returns all statistics as a JSON structure.
     ///
     /// @return JSON structures representing all statistics
@@ -237,13 +269,16 @@ class StatsMgr : public boost::noncopyable {
 
     /// @brief Handles statistic-get command
     ///
-    /// This method handles statistic-get command, which returns value
-    /// of a given statistic). It expects one parameter stored in params map:
-    /// name: name-of-the-statistic
+    /// This method handles statistic-get command, which returns the retained
+    /// samples of a given statistic. It expects one parameter stored in params
+    /// map: name: name-of-the-statistic. If the optional boolean "summary"
+    /// parameter is true, the answer also includes the "summary" map with the
+    /// number of the samples, the rate of change and the average value.
     ///
     /// Example params structure:
     /// {
-    ///     "name": "packets-received"
+    ///     "name": "packets-received",
+    ///     "summary": true
     /// }
     ///
     /// @param name name of the command (ignored, should be "statistic-get")
@@ -289,6 +324,52 @@ class StatsMgr : public boost::noncopyable {
     statisticRemoveHandler(const std::string& name,
                            const isc::data::ConstElementPtr& params);
 
+    /// @brief Handles statistic-sample-age-set command
+    ///
+    /// This method handles statistic-sample-age-set command, which sets the
+    /// maximum age of the retained samples of a given statistic. It expects
+    /// two parameters stored in params map:
+    /// name: name-of-the-statistic
+    /// duration: maximum age in seconds (0 reverts to a single sample)
+    ///
+    /// Example params structure:
+    /// {
+    ///     "name": "packets-received",
+    ///     "duration": 300
+    /// }
+    ///
+    /// @param name name of the command (ignored, should be
+    /// "statistic-sample-age-set")
+    /// @param params structure containing a map that contains "name" and
+    /// "duration"
+    /// @return answer containing confirmation
+    static isc::data::ConstElementPtr
+    statisticSetMaxSampleAgeHandler(const std::string& name,
+                                    const isc::data::ConstElementPtr& params);
+
+    /// @brief Handles statistic-sample-count-set command
+    ///
+    /// This method handles statistic-sample-count-set command, which sets
+    /// the maximum number of the retained samples of a given statistic. It
+    /// expects two parameters stored in params map:
+    /// name: name-of-the-statistic
+    /// max-samples: maximum number of samples
+    ///
+    /// Example params structure:
+    /// {
+    ///     "name": "packets-received",
+    ///     "max-samples": 100
+    /// }
+    ///
+    /// @param name name of the command (ignored, should be
+    /// "statistic-sample-count-set")
+    /// @param params structure containing a map that contains "name" and
+    /// "max-samples"
+    /// @return answer containing confirmation
+    static isc::data::ConstElementPtr
+    statisticSetMaxSampleCountHandler(const std::string& name,
+                                      const isc::data::ConstElementPtr& params);
+
     /// @brief Handles statistic-get-all command
     ///
     /// This method handles statistic-get-all command, which returns values
@@ -340,7 +421,7 @@ class StatsMgr : public boost::noncopyable {
     ///
     /// This template method sets statistic identified by name to a value
     /// specified by value. This internal method is used by public @ref setValue
-    /// methods.
+    /// methods. The @c mutex_ must be held by the caller.
     ///
     /// @tparam DataType one of int64_t, double, StatsDuration or string
     /// @param name name of the statistic
@@ -350,7 +431,7 @@ class StatsMgr : public boost::noncopyable {
     void setValueInternal(const std::string& name, DataType value) {
 
         // If we want to log each observation, here would be the best place for it.
-        ObservationPtr stat = getObservation(name);
+        ObservationPtr stat = getObservationInternal(name);
         if (stat) {
             stat->setValue(value);
         } else {
@@ -364,10 +445,11 @@ class StatsMgr : public boost::noncopyable {
     /// @brief Adds specified value to a given statistic (internal version).
     ///
     /// This template method adds specified value to a given statistic (identified
-    /// by name to a value). This internal method is used by public @ref setValue
-    /// methods.
+    /// by name to a value). This internal method is used by public @ref addValue
+    /// methods for the non-integer statistics. The @c mutex_ must be held by
+    /// the caller.
     ///
-    /// @tparam DataType one of int64_t, double, StatsDuration or string
+    /// @tparam DataType one of double, StatsDuration or string
     /// @param name name of the statistic
     /// @param value specified statistic will be set to this value
     /// @throw InvalidStatType is statistic exists and has a different type.
@@ -375,12 +457,12 @@ class StatsMgr : public boost::noncopyable {
     void addValueInternal(const std::string& name, DataType value) {
 
         // If we want to log each observation, here would be the best place for it.
-        ObservationPtr existing = getObservation(name);
+        ObservationPtr existing = getObservationInternal(name);
         if (!existing) {
             // We tried to add to a non-existing statistic. We can recover from
             // that. Simply add the new incremental value as a new statistic and
             // we're done.
-            setValue(name, value);
+            setValueInternal(name, value);
             return;
         } else {
             // Let's hope it is of correct type. If not, the underlying
@@ -406,6 +488,26 @@ class StatsMgr : public boost::noncopyable {
     /// @return true if deleted, false if not found
     bool deleteObservation(const std::string& name);
 
+    /// @brief Returns an observation (internal version).
+    ///
+    /// The @c mutex_ must be held by the caller.
+    ///
+    /// @param name name of the statistic
+    /// @return Pointer to the Observation object or null if not found
+    ObservationPtr getObservationInternal(const std::string& name) const;
+
+    /// @brief Returns the shard of the integer statistic used by the calling
+    /// thread, using the cache of the thread.
+    ///
+    /// The statistic is created if it doesn't exist. The cache is flushed
+    /// when any statistic is removed. The @c mutex_ is taken only when the
+    /// shard is not in the cache.
+    ///
+    /// @param name name of the statistic
+    /// @return Reference to the shard
+    /// @throw InvalidStatType if the statistic exists and is not integer.
+    ShardedCounter::Shard& getShard(const std::string& name);
+
     /// @brief Utility method that attempts to extract statistic name
     ///
     /// This method attempts to extract statistic name from the params
@@ -422,8 +524,27 @@ class StatsMgr : public boost::noncopyable {
                             std::string& name,
                             std::string& reason);
 
+    /// @brief Utility method that attempts to extract an integer parameter
+    ///
+    /// @param params parameters structure received in command
+    /// @param param_name name of the parameter
+    /// @param value [out] value of the parameter (if no error detected)
+    /// @param reason [out] failure reason (if error is detected)
+    /// @return true (if everything is ok), false otherwise
+    static bool getIntegerParam(const isc::data::ConstElementPtr& params,
+                                const std::string& param_name,
+                                int64_t& value,
+                                std::string& reason);
+
     // This is a global context. All statistics will initially be stored here.
     StatContextPtr global_;
+
+    /// @brief Mutex serializing the access to the statistics.
+    mutable isc::util::thread::Mutex mutex_;
+
+    /// @brief Generation of the statistics, incremented when any statistic
+    /// is removed to flush the thread local caches.
+    std::atomic<uint64_t> generation_;
 };
 
 };
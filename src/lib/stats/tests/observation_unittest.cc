@@ -1,4 +1,4 @@
-// Copyright (C) 2015 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -224,6 +224,149 @@ TEST_F(ObservationTest, reset) {
     EXPECT_EQ("", d.getString().first);
 }
 
+// Checks that the ring buffer retains the newest samples.
+TEST(SampleRingTest, pushAndResize) {
+    SampleRing<int> ring(3);
+    EXPECT_EQ(3, ring.capacity());
+    EXPECT_TRUE(ring.empty());
+
+    for (int i = 1; i <= 5; ++i) {
+        ring.push(i);
+    }
+    ASSERT_EQ(3, ring.size());
+    EXPECT_EQ(5, ring.at(0));
+    EXPECT_EQ(4, ring.at(1));
+    EXPECT_EQ(3, ring.oldest());
+
+    // Growing the buffer preserves the samples.
+    ring.setCapacity(5);
+    ASSERT_EQ(3, ring.size());
+    EXPECT_EQ(5, ring.at(0));
+    EXPECT_EQ(3, ring.oldest());
+    ring.push(6);
+    EXPECT_EQ(4, ring.size());
+    EXPECT_EQ(6, ring.at(0));
+    EXPECT_EQ(3, ring.oldest());
+
+    // Shrinking the buffer preserves the newest samples.
+    ring.setCapacity(2);
+    ASSERT_EQ(2, ring.size());
+    EXPECT_EQ(6, ring.at(0));
+    EXPECT_EQ(5, ring.oldest());
+
+    ring.popOldest();
+    ASSERT_EQ(1, ring.size());
+    EXPECT_EQ(6, ring.oldest());
+    ring.clear();
+    EXPECT_TRUE(ring.empty());
+}
+
+// Checks that the number of retained samples can be limited.
+TEST_F(ObservationTest, maxSampleCount) {
+    // By default only the current value is retained.
+    EXPECT_EQ(1, a.getMaxSampleCount());
+    a.setValue(static_cast<int64_t>(10));
+    EXPECT_EQ(1, a.getSize());
+
+    EXPECT_THROW(a.setMaxSampleCount(0), BadValue);
+    EXPECT_THROW(a.setMaxSampleCount(Observation::MAX_SAMPLE_COUNT + 1),
+                 BadValue);
+
+    ASSERT_NO_THROW(a.setMaxSampleCount(3));
+    for (int64_t i = 11; i <= 14; ++i) {
+        a.setValue(i);
+    }
+    std::list<IntegerSample> samples = a.getIntegers();
+    ASSERT_EQ(3, samples.size());
+    EXPECT_EQ(14, samples.front().first);
+    EXPECT_EQ(12, samples.back().first);
+    EXPECT_EQ(14, a.getInteger().first);
+
+    // The samples are reported in JSON, the newest first.
+    std::string exp = "[ [ 14, \"" +
+        isc::util::ptimeToText(samples.front().second) + "\" ], [ 13, \"";
+    EXPECT_EQ(0, a.getJSON()->str().find(exp));
+
+    // Reset discards the retained samples.
+    a.reset();
+    EXPECT_EQ(1, a.getSize());
+    EXPECT_EQ(0, a.getInteger().first);
+
+    // Other types are supported too.
+    ASSERT_NO_THROW(d.setMaxSampleCount(2));
+    d.addValue("5");
+    d.addValue("6");
+    std::list<StringSample> strings = d.getStrings();
+    ASSERT_EQ(2, strings.size());
+    EXPECT_EQ("123456", strings.front().first);
+    EXPECT_EQ("12345", strings.back().first);
+}
+
+// Checks that the age of retained samples can be limited.
+TEST_F(ObservationTest, maxSampleAge) {
+    EXPECT_THROW(b.setMaxSampleAge(millisec::time_duration(0,0,0,0) -
+                                   millisec::time_duration(0,0,1,0)),
+                 BadValue);
+
+    ASSERT_NO_THROW(b.setMaxSampleAge(millisec::time_duration(0,0,0,200000)));
+    EXPECT_EQ(Observation::DEFAULT_AGE_SAMPLE_COUNT, b.getMaxSampleCount());
+    b.setValue(1.0);
+    b.setValue(2.0);
+    EXPECT_EQ(3, b.getSize());
+
+    // Wait until the samples are too old. The newest one is retained.
+    usleep(300000);
+    EXPECT_EQ(1, b.getSize());
+    EXPECT_EQ(2.0, b.getFloat().first);
+
+    // Recording a new sample discards the old ones.
+    b.setValue(3.0);
+    b.setValue(4.0);
+    std::list<FloatSample> samples = b.getFloats();
+    ASSERT_EQ(2, samples.size());
+    EXPECT_EQ(4.0, samples.front().first);
+    EXPECT_EQ(3.0, samples.back().first);
+
+    // The duration of 0 reverts to a single value.
+    ASSERT_NO_THROW(b.setMaxSampleAge(millisec::time_duration(0,0,0,0)));
+    EXPECT_EQ(1, b.getMaxSampleCount());
+    EXPECT_EQ(1, b.getSize());
+    EXPECT_EQ(4.0, b.getFloat().first);
+}
+
+// Checks that the rate and the average are computed over retained samples.
+TEST_F(ObservationTest, rateAndAverage) {
+    // A single sample has no rate.
+    EXPECT_EQ(0.0, a.getRate());
+    EXPECT_EQ(1234.0, a.getAverage());
+
+    // Reset discards the initial value.
+    ASSERT_NO_THROW(a.setMaxSampleCount(10));
+    a.reset();
+    usleep(100000);
+    a.addValue(static_cast<int64_t>(100));
+    a.addValue(static_cast<int64_t>(200));
+
+    // The value has grown by 300 in at least 100ms.
+    double rate = a.getRate();
+    EXPECT_GT(rate, 0.0);
+    EXPECT_LE(rate, 3000.0);
+    EXPECT_DOUBLE_EQ((0.0 + 100.0 + 300.0) / 3, a.getAverage());
+
+    isc::data::ConstElementPtr summary = a.getSummaryJSON();
+    ASSERT_TRUE(summary);
+    ASSERT_TRUE(summary->get("samples"));
+    EXPECT_EQ(3, summary->get("samples")->intValue());
+    ASSERT_TRUE(summary->get("rate"));
+    ASSERT_TRUE(summary->get("average"));
+
+    // Rate and average are not available for durations and strings.
+    EXPECT_THROW(c.getRate(), InvalidStatType);
+    EXPECT_THROW(d.getAverage(), InvalidStatType);
+    summary = d.getSummaryJSON();
+    EXPECT_EQ("{ \"samples\": 1 }", summary->str());
+}
+
 // Checks whether an observation can keep its name.
 TEST_F(ObservationTest, names) {
     EXPECT_EQ("alpha", a.getName());
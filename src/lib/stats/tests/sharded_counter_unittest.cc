@@ -0,0 +1,175 @@
+// Copyright (C) 2017 Internet Systems Consortium, Inc. ("ISC")
+//
+// This Source Code Form is subject to the terms of the Mozilla Public
+// License, v. 2.0. If a copy of the MPL was not distributed with this
+// file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <config.h>
+
+#include <stats/sharded_counter.h>
+#include <util/threads/thread.h>
+#include <boost/bind.hpp>
+#include <boost/shared_ptr.hpp>
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace isc::stats;
+using namespace isc::util::thread;
+
+namespace {
+
+/// @brief Increments the counter the specified number of times.
+///
+/// @param counter Counter to be incremented.
+/// @param cycles Number of increments.
+void increment(ShardedCounter* counter, const uint32_t cycles) {
+    ShardedCounter::Shard& shard = counter->getShard();
+    for (uint32_t i = 0; i < cycles; ++i) {
+        shard.add(1);
+    }
+}
+
+/// @brief Returns the address of the shard of the calling thread.
+///
+/// @param counter Counter holding the shard.
+/// @param [out] shard Address of the shard.
+void getShard(ShardedCounter* counter, ShardedCounter::Shard** shard) {
+    *shard = &counter->getShard();
+}
+
+// Checks that the updates are accounted for in the value of the counter.
+TEST(ShardedCounterTest, basic) {
+    ShardedCounter counter;
+    EXPECT_EQ(0, counter.get());
+
+    counter.add(5);
+    EXPECT_EQ(5, counter.get());
+
+    counter.add(-7);
+    EXPECT_EQ(-2, counter.get());
+}
+
+// Checks that each thread updates its own shard.
+TEST(ShardedCounterTest, shards) {
+    ShardedCounter counter;
+    ShardedCounter::Shard* shard = &counter.getShard();
+    EXPECT_EQ(shard, &counter.getShard());
+
+    ShardedCounter::Shard* other_shard = 0;
+    Thread thread(boost::bind(&getShard, &counter, &other_shard));
+    thread.wait();
+    ASSERT_TRUE(other_shard);
+    EXPECT_NE(shard, other_shard);
+}
+
+// Checks that the updates are collected with their timestamps, the oldest
+// first, and each of them only once.
+TEST(ShardedCounterTest, collect) {
+    ShardedCounter counter(10);
+    counter.add(1);
+    counter.add(2);
+    counter.add(3);
+
+    std::vector<ShardedCounter::Update> updates;
+    counter.collect(updates);
+    ASSERT_EQ(3, updates.size());
+    EXPECT_EQ(1, updates[0].first);
+    EXPECT_EQ(3, updates[1].first);
+    EXPECT_EQ(6, updates[2].first);
+    EXPECT_LE(updates[0].second, updates[1].second);
+    EXPECT_LE(updates[1].second, updates[2].second);
+    EXPECT_EQ(6, counter.getCollected());
+
+    updates.clear();
+    counter.collect(updates);
+    EXPECT_TRUE(updates.empty());
+
+    counter.add(4);
+    counter.collect(updates);
+    ASSERT_EQ(1, updates.size());
+    EXPECT_EQ(10, updates[0].first);
+    EXPECT_EQ(10, counter.getCollected());
+}
+
+// Checks that the updates made by different threads are all accounted for
+// in the collected values.
+TEST(ShardedCounterTest, collectThreads) {
+    ShardedCounter counter(100);
+    counter.add(100);
+    Thread thread(boost::bind(&increment, &counter, 10));
+    thread.wait();
+
+    std::vector<ShardedCounter::Update> updates;
+    counter.collect(updates);
+    ASSERT_EQ(11, updates.size());
+    EXPECT_EQ(100, updates[0].first);
+    for (size_t i = 1; i < updates.size(); ++i) {
+        EXPECT_EQ(100 + i, updates[i].first);
+        EXPECT_LE(updates[i - 1].second, updates[i].second);
+    }
+}
+
+// Checks that only the most recent updates are held by the shards, but the
+// older ones are still accounted for.
+TEST(ShardedCounterTest, capacity) {
+    ShardedCounter counter;
+    counter.add(1);
+    counter.add(2);
+    counter.add(3);
+
+    std::vector<ShardedCounter::Update> updates;
+    counter.collect(updates);
+    ASSERT_EQ(1, updates.size());
+    EXPECT_EQ(6, updates[0].first);
+
+    // The capacity of the existing shard is changed by the next collect.
+    counter.setCapacity(5);
+    updates.clear();
+    counter.collect(updates);
+    EXPECT_TRUE(updates.empty());
+
+    for (int i = 0; i < 7; ++i) {
+        counter.add(1);
+    }
+    counter.collect(updates);
+    ASSERT_EQ(5, updates.size());
+    EXPECT_EQ(9, updates[0].first);
+    EXPECT_EQ(13, updates[4].first);
+}
+
+// Checks that no increment is lost when multiple threads update the
+// counter concurrently with the collection of the updates and the changes
+// of the capacity.
+TEST(ShardedCounterTest, concurrentAdd) {
+    const size_t threads_num = 4;
+    const uint32_t cycles = 100000;
+
+    ShardedCounter counter;
+    std::vector<boost::shared_ptr<Thread> > threads;
+    for (size_t i = 0; i < threads_num; ++i) {
+        threads.push_back(boost::shared_ptr<Thread>
+                          (new Thread(boost::bind(&increment, &counter,
+                                                  cycles))));
+    }
+
+    std::vector<ShardedCounter::Update> updates;
+    for (size_t i = 0; i < 100; ++i) {
+        counter.setCapacity(1 + i % 7);
+        updates.clear();
+        counter.collect(updates);
+        for (size_t j = 1; j < updates.size(); ++j) {
+            ASSERT_LT(updates[j - 1].first, updates[j].first);
+        }
+    }
+
+    for (size_t i = 0; i < threads_num; ++i) {
+        threads[i]->wait();
+    }
+
+    EXPECT_EQ(threads_num * cycles, counter.get());
+    counter.collect(updates);
+    EXPECT_EQ(threads_num * cycles, counter.getCollected());
+}
+
+}
@@ -1,4 +1,4 @@
-// Copyright (C) 2015 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2015-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -11,21 +11,56 @@
 #include <cc/data.h>
 #include <cc/command_interpreter.h>
 #include <util/boost_time_utils.h>
+#include <util/threads/thread.h>
+#include <boost/bind.hpp>
 #include <boost/date_time/posix_time/posix_time_types.hpp>
 #include <boost/shared_ptr.hpp>
 #include <gtest/gtest.h>
 
 #include <iostream>
+#include <list>
 #include <sstream>
+#include <vector>
 
 using namespace isc;
 using namespace isc::data;
 using namespace isc::stats;
 using namespace isc::config;
+using namespace isc::util::thread;
 using namespace boost::posix_time;
 
 namespace {
 
+/// @brief Increments the integer statistic the specified number of times.
+///
+/// @param name Name of the statistic.
+/// @param cycles Number of increments.
+void incrementStat(const std::string& name, const uint32_t cycles) {
+    for (uint32_t i = 0; i < cycles; ++i) {
+        StatsMgr::instance().addValue(name, static_cast<int64_t>(1));
+    }
+}
+
+/// @brief Increments the integer statistic in the specified number of
+/// threads and waits for them to finish.
+///
+/// @param name Name of the statistic.
+/// @param threads_num Number of threads.
+/// @param cycles Number of increments made by each thread.
+void incrementStatConcurrently(const std::string& name,
+                               const size_t threads_num,
+                               const uint32_t cycles) {
+    std::vector<boost::shared_ptr<Thread> > threads;
+    for (size_t i = 0; i < threads_num; ++i) {
+        threads.push_back(boost::shared_ptr<Thread>
+                          (new Thread(boost::bind(&incrementStat, name,
+                                                  cycles))));
+    }
+    for (size_t i = 0; i < threads_num; ++i) {
+        threads[i]->wait();
+    }
+}
+
 /// @brief Fixture class for StatsMgr testing
 ///
 /// Very simple class that makes sure that StatsMgr is indeed instantiated
@@ -119,15 +154,26 @@ TEST_F(StatsMgrTest, stringStat) {
     EXPECT_EQ(exp, StatsMgr::instance().get("delta")->str());
 }
 
-// Setting limits is currently not implemented, so those methods should
-// throw.
+// This test checks that the limits of the retained samples can be set
+// for the existing statistics.
 TEST_F(StatsMgrTest, setLimits) {
-    EXPECT_THROW(StatsMgr::instance().setMaxSampleAge("foo",
-                                                      time_duration(1,0,0,0)),
-                 NotImplemented);
-
-    EXPECT_THROW(StatsMgr::instance().setMaxSampleCount("foo", 100),
-                 NotImplemented);
+    EXPECT_FALSE(StatsMgr::instance().setMaxSampleAge("foo",
+                                                      time_duration(1,0,0,0)));
+    EXPECT_FALSE(StatsMgr::instance().setMaxSampleCount("foo", 100));
+
+    StatsMgr::instance().setValue("foo", static_cast<int64_t>(1));
+    EXPECT_TRUE(StatsMgr::instance().setMaxSampleCount("foo", 100));
+    EXPECT_THROW(StatsMgr::instance().setMaxSampleCount("foo", 0), BadValue);
+    StatsMgr::instance().addValue("foo", static_cast<int64_t>(1));
+
+    ObservationPtr foo = StatsMgr::instance().getObservation("foo");
+    ASSERT_TRUE(foo);
+    EXPECT_EQ(2, foo->getSize());
+
+    EXPECT_TRUE(StatsMgr::instance().setMaxSampleAge("foo",
+                                                     time_duration(0,0,0,0)));
+    EXPECT_EQ(1, foo->getSize());
+    EXPECT_EQ(2, foo->getInteger().first);
 }
 
 // This test checks whether a single (get("foo")) and all (getAll())
@@ -288,6 +334,79 @@ TEST_F(StatsMgrTest, removeAll) {
     EXPECT_FALSE(StatsMgr::instance().getObservation("delta"));
 }
 
+// Test checks that each increment of an integer statistic is recorded as
+// a sample of the observation right away.
+TEST_F(StatsMgrTest, integerSamples) {
+    StatsMgr::instance().setValue("alpha", static_cast<int64_t>(10));
+    ObservationPtr alpha = StatsMgr::instance().getObservation("alpha");
+    ASSERT_TRUE(alpha);
+    ASSERT_NO_THROW(alpha->setMaxSampleCount(10));
+
+    StatsMgr::instance().addValue("alpha", static_cast<int64_t>(1));
+    StatsMgr::instance().addValue("alpha", static_cast<int64_t>(2));
+    EXPECT_EQ(13, alpha->getInteger().first);
+    EXPECT_EQ(3, alpha->getSize());
+}
+
+// Test checks that the type of an integer statistic is enforced.
+TEST_F(StatsMgrTest, integerTypeMismatch) {
+    StatsMgr::instance().addValue("alpha", static_cast<int64_t>(1));
+    EXPECT_THROW(StatsMgr::instance().setValue("alpha", 1.5), InvalidStatType);
+    EXPECT_THROW(StatsMgr::instance().addValue("alpha", 1.5), InvalidStatType);
+
+    StatsMgr::instance().setValue("beta", 1.5);
+    EXPECT_THROW(StatsMgr::instance().setValue("beta", static_cast<int64_t>(1)),
+                 InvalidStatType);
+    EXPECT_THROW(StatsMgr::instance().addValue("beta", static_cast<int64_t>(1)),
+                 InvalidStatType);
+}
+
+// Test checks that no increment is lost when an integer statistic is
+// updated by multiple threads.
+TEST_F(StatsMgrTest, concurrentAdd) {
+    incrementStatConcurrently("alpha", 4, 10000);
+
+    ObservationPtr alpha = StatsMgr::instance().getObservation("alpha");
+    ASSERT_TRUE(alpha);
+    EXPECT_EQ(40000, alpha->getInteger().first);
+}
+
+// Test checks that the increments made by multiple threads are recorded
+// as separate samples and are visible through an observation obtained
+// before they were made.
+TEST_F(StatsMgrTest, concurrentAddSamples) {
+    StatsMgr::instance().setValue("alpha", static_cast<int64_t>(0));
+    ObservationPtr alpha = StatsMgr::instance().getObservation("alpha");
+    ASSERT_TRUE(alpha);
+    ASSERT_NO_THROW(alpha->setMaxSampleCount(100));
+
+    incrementStatConcurrently("alpha", 2, 10);
+
+    std::list<IntegerSample> samples = alpha->getIntegers();
+    ASSERT_EQ(21, samples.size());
+    int64_t value = 20;
+    for (std::list<IntegerSample>::const_iterator sample = samples.begin();
+         sample != samples.end(); ++sample) {
+        EXPECT_EQ(value--, sample->first);
+    }
+    EXPECT_GT(alpha->getRate(), 0.0);
+}
+
+// Test checks that the increments of a removed integer statistic are
+// recorded in the new statistic with the same name.
+TEST_F(StatsMgrTest, addAfterRemove) {
+    StatsMgr::instance().addValue("alpha", static_cast<int64_t>(5));
+    ObservationPtr alpha = StatsMgr::instance().getObservation("alpha");
+    ASSERT_TRUE(alpha);
+    EXPECT_TRUE(StatsMgr::instance().del("alpha"));
+
+    StatsMgr::instance().addValue("alpha", static_cast<int64_t>(2));
+    ObservationPtr alpha2 = StatsMgr::instance().getObservation("alpha");
+    ASSERT_TRUE(alpha2);
+    EXPECT_EQ(2, alpha2->getInteger().first);
+    EXPECT_EQ(5, alpha->getInteger().first);
+}
+
 // This is a performance benchmark that checks how long does it take
 // to increment a single statistic million times.
 //
@@ -392,6 +511,31 @@ TEST_F(StatsMgrTest, DISABLED_performanceMultipleSet) {
               << " times took: " << isc::util::durationToText(dur) << std::endl;
 }
 
+// This is a performance benchmark that checks how the throughput of the
+// increments of a single integer statistic scales with the number of
+// threads, each of them incrementing the statistic million times.
+TEST_F(StatsMgrTest, DISABLED_performanceThreadedAdd) {
+    uint32_t cycles = 1000000;
+
+    for (size_t threads_num = 1; threads_num <= 8; threads_num *= 2) {
+        StatsMgr::instance().removeAll();
+
+        ptime before = microsec_clock::local_time();
+        incrementStatConcurrently("metric1", threads_num, cycles);
+        ptime after = microsec_clock::local_time();
+
+        time_duration dur = after - before;
+        double rate = static_cast<double>(threads_num * cycles) /
+            (dur.total_microseconds() + 1) * 1000000;
+
+        std::cout << "Incrementing a single statistic " << cycles
+                  << " times in each of " << threads_num << " threads took: "
+                  << isc::util::durationToText(dur) << " ("
+                  << static_cast<uint64_t>(rate) << " increments/s)"
+                  << std::endl;
+    }
+}
+
 // Test checks whether statistics name can be generated using various
 // indexes.
 TEST_F(StatsMgrTest, generateName) {
@@ -428,6 +572,88 @@ TEST_F(StatsMgrTest, commandStatisticGet) {
     EXPECT_EQ("{ \"arguments\": " + exp + ", \"result\": 0 }", rsp->str());
 }
 
+// Test checks if statistic-get handler returns the retained samples and
+// their summary.
+TEST_F(StatsMgrTest, commandStatisticGetSummary) {
+    StatsMgr::instance().setValue("alpha", static_cast<int64_t>(10));
+    ASSERT_TRUE(StatsMgr::instance().setMaxSampleCount("alpha", 5));
+    StatsMgr::instance().addValue("alpha", static_cast<int64_t>(10));
+
+    ElementPtr params = Element::createMap();
+    params->set("name", Element::create("alpha"));
+    params->set("summary", Element::create(true));
+
+    ConstElementPtr rsp = StatsMgr::instance().statisticGetHandler("statistic-get",
+                                                                   params);
+    int status_code;
+    ConstElementPtr args = parseAnswer(status_code, rsp);
+    ASSERT_EQ(CONTROL_RESULT_SUCCESS, status_code);
+    ASSERT_TRUE(args);
+    ASSERT_TRUE(args->get("alpha"));
+    EXPECT_EQ(2, args->get("alpha")->size());
+    ConstElementPtr summary = args->get("summary");
+    ASSERT_TRUE(summary);
+    EXPECT_EQ(2, summary->get("samples")->intValue());
+    EXPECT_DOUBLE_EQ(15.0, summary->get("average")->doubleValue());
+    ASSERT_TRUE(summary->get("rate"));
+
+    // The summary parameter must be a boolean.
+    params->set("summary", Element::create("yes"));
+    rsp = StatsMgr::instance().statisticGetHandler("statistic-get", params);
+    ASSERT_NO_THROW(parseAnswer(status_code, rsp));
+    EXPECT_EQ(CONTROL_RESULT_ERROR, status_code);
+}
+
+// Test checks if the statistic-sample-count-set and statistic-sample-age-set
+// handlers set the limits of the retained samples.
+TEST_F(StatsMgrTest, commandSetLimits) {
+    ElementPtr params = Element::createMap();
+    params->set("name", Element::create("alpha"));
+    params->set("max-samples", Element::create(3));
+
+    // The statistic doesn't exist.
+    int status_code;
+    ConstElementPtr rsp = StatsMgr::instance().
+        statisticSetMaxSampleCountHandler("statistic-sample-count-set", params);
+    ASSERT_NO_THROW(parseAnswer(status_code, rsp));
+    EXPECT_EQ(CONTROL_RESULT_ERROR, status_code);
+
+    StatsMgr::instance().setValue("alpha", static_cast<int64_t>(1));
+    rsp = StatsMgr::instance().
+        statisticSetMaxSampleCountHandler("statistic-sample-count-set", params);
+    ASSERT_NO_THROW(parseAnswer(status_code, rsp));
+    EXPECT_EQ(CONTROL_RESULT_SUCCESS, status_code);
+    ObservationPtr alpha = StatsMgr::instance().getObservation("alpha");
+    ASSERT_TRUE(alpha);
+    EXPECT_EQ(3, alpha->getMaxSampleCount());
+
+    // The number must be positive.
+    params->set("max-samples", Element::create(0));
+    rsp = StatsMgr::instance().
+        statisticSetMaxSampleCountHandler("statistic-sample-count-set", params);
+    ASSERT_NO_THROW(parseAnswer(status_code, rsp));
+    EXPECT_EQ(CONTROL_RESULT_ERROR, status_code);
+
+    // The duration is mandatory.
+    rsp = StatsMgr::instance().
+        statisticSetMaxSampleAgeHandler("statistic-sample-age-set", params);
+    ASSERT_NO_THROW(parseAnswer(status_code, rsp));
+    EXPECT_EQ(CONTROL_RESULT_ERROR, status_code);
+
+    params->set("duration", Element::create(300));
+    rsp = StatsMgr::instance().
+        statisticSetMaxSampleAgeHandler("statistic-sample-age-set", params);
+    ASSERT_NO_THROW(parseAnswer(status_code, rsp));
+    EXPECT_EQ(CONTROL_RESULT_SUCCESS, status_code);
+    EXPECT_EQ(time_duration(0,5,0,0), alpha->getMaxSampleAge());
+
+    params->set("duration", Element::create(-1));
+    rsp = StatsMgr::instance().
+        statisticSetMaxSampleAgeHandler("statistic-sample-age-set", params);
+    ASSERT_NO_THROW(parseAnswer(status_code, rsp));
+    EXPECT_EQ(CONTROL_RESULT_ERROR, status_code);
+}
+
 // Test checks if statistic-get is able to handle:
 // - a request without parameters
 // - a request with missing statistic name
@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -73,7 +73,8 @@ const int StateModel::FAIL_EVT;
 
 const int StateModel::SM_DERIVED_EVENT_MIN;
 
-StateModel::StateModel() : events_(), states_(), dictionaries_initted_(false),
+StateModel::StateModel() : events_(), states_(), event_table_(),
+                          state_table_(), dictionaries_initted_(false),
                           curr_state_(NEW_ST), prev_state_(NEW_ST),
                           last_event_(NOP_EVT), next_event_(NOP_EVT),
                           on_entry_flag_(false), on_exit_flag_(false) {
@@ -163,16 +164,22 @@ StateModel::defineEvent(unsigned int event_value, const std::string& label) {
     } catch (const std::exception& ex) {
         isc_throw(StateModelError, "Error adding event: " << ex.what());
     }
+
+    // Index the event by its value.
+    if (event_value >= event_table_.size()) {
+        event_table_.resize(event_value + 1);
+    }
+    event_table_[event_value] = events_.get(event_value);
 }
 
-const EventPtr&
+const EventPtr
 StateModel::getEvent(unsigned int event_value) {
-    if (!events_.isDefined(event_value)) {
+    if (!isEventDefined(event_value)) {
         isc_throw(StateModelError,
                   "Event value is not defined:" << event_value);
     }
 
-    return (events_.get(event_value));
+    return (event_table_[event_value]);
 }
 
 void
@@ -190,16 +197,22 @@ StateModel::defineState(unsigned int state_value, const std::string& label,
     } catch (const std::exception& ex) {
         isc_throw(StateModelError, "Error adding state: " << ex.what());
     }
+
+    // Index the state by its value.
+    if (state_value >= state_table_.size()) {
+        state_table_.resize(state_value + 1);
+    }
+    state_table_[state_value] = states_.getState(state_value);
 }
 
 const StatePtr
 StateModel::getState(unsigned int state_value) {
-    if (!states_.isDefined(state_value)) {
+    if (!isStateDefined(state_value)) {
         isc_throw(StateModelError,
                   "State value is not defined:" << state_value);
     }
 
-    return (states_.getState(state_value));
+    return (state_table_[state_value]);
 }
 
 void
@@ -259,7 +272,7 @@ StateModel::abortModel(const std::string& explanation) {
 
 void
 StateModel::setState(unsigned int state) {
-    if (state != END_ST && !states_.isDefined(state)) {
+    if (state != END_ST && !isStateDefined(state)) {
         isc_throw(StateModelError,
                   "Attempt to set state to an undefined value: " << state );
     }
@@ -278,7 +291,7 @@ void
 StateModel::postNextEvent(unsigned int event_value) {
     // Check for FAIL_EVT as special case of model error before events are
     // defined.
-    if (event_value != FAIL_EVT && !events_.isDefined(event_value)) {
+    if (event_value != FAIL_EVT && !isEventDefined(event_value)) {
         isc_throw(StateModelError,
                   "Attempt to post an undefined event, value: " << event_value);
     }
@@ -1,4 +1,4 @@
-// Copyright (C) 2013-2016 Internet Systems Consortium, Inc. ("ISC")
+// Copyright (C) 2013-2017 Internet Systems Consortium, Inc. ("ISC")
 //
 // This Source Code Form is subject to the terms of the Mozilla Public
 // License, v. 2.0. If a copy of the MPL was not distributed with this
@@ -15,6 +15,7 @@
 #include <boost/shared_ptr.hpp>
 #include <map>
 #include <string>
+#include <vector>
 
 namespace isc {
 namespace util {
@@ -172,7 +173,7 @@ public:
 ///
 /// This loop is implemented in the runModel method.  This method accepts an
 /// event as argument which it "posts" as the next event.  It then retrieves the
-/// handler for the current state from the handler map and invokes it. runModel
+/// handler for the current state from the handler table and invokes it. runModel
 /// repeats this process until either a NOP_EVT posts or the state changes
 /// to END_ST.  In other words each invocation of runModel causes the model to
 /// be traversed from the current state until it must wait or ends.
@@ -199,6 +200,14 @@ public:
 /// check of the dictionaries.  This should help avoid using undefined event
 /// or state values accidentally.
 ///
+/// Besides the dictionaries, the defined events and states are stored in
+/// tables indexed by their values. The model execution uses these tables
+/// to find the state handlers and to validate the posted events and states,
+/// so as each step is a direct index rather than a dictionary lookup. The
+/// labels are only looked up in the dictionaries for the log messages and
+/// the exceptions. As the values index the tables, they should be kept small,
+/// i.e. numbered from the SM_DERIVED_STATE_MIN and SM_DERIVED_EVENT_MIN up.
+///
 /// These methods are intended to be implemented by each "layer" in a StateModel
 /// derivation hierarchy.  This allows each layer to define additional events
 /// and states.
@@ -357,10 +366,10 @@ protected:
     ///
     /// @param value is the numeric value of the event desired.
     ///
-    /// @return returns a constant pointer reference to the event if found
+    /// @return returns a constant pointer to the event if found
     ///
     /// @throw StateModelError if the event is not defined.
-    const EventPtr& getEvent(unsigned int value);
+    const EventPtr getEvent(unsigned int value);
 
     /// @brief Validates the contents of the set of events.
     ///
@@ -632,12 +641,45 @@ public:
     std::string getPrevContextStr() const;
 
 private:
+    /// @brief Checks if the event value is defined.
+    ///
+    /// @param value is the numeric value of the event.
+    ///
+    /// @return true if the event is defined.
+    bool isEventDefined(unsigned int value) const {
+        return ((value < event_table_.size()) && event_table_[value]);
+    }
+
+    /// @brief Checks if the state value is defined.
+    ///
+    /// @param value is the numeric value of the state.
+    ///
+    /// @return true if the state is defined.
+    bool isStateDefined(unsigned int value) const {
+        return ((value < state_table_.size()) && state_table_[value]);
+    }
+
     /// @brief The dictionary of valid events.
     LabeledValueSet events_;
 
     /// @brief The dictionary of valid states.
     StateSet states_;
 
+    /// @brief Defined events indexed by their values.
+    ///
+    /// This is filled along with the dictionary of events so as the events
+    /// posted by the state handlers are validated without the dictionary
+    /// lookups. The values of the undefined events index null pointers.
+    std::vector<EventPtr> event_table_;
+
+    /// @brief Defined states indexed by their values.
+    ///
+    /// This is filled along with the dictionary of states so as the handler
+    /// of the current state is found and the transitions are validated
+    /// without the dictionary lookups. The values of the undefined states
+    /// index null pointers.
+    std::vector<StatePtr> state_table_;
+
     /// @brief Indicates if the event and state dictionaries have been initted.
     bool dictionaries_initted_;
 
@@ -396,6 +396,29 @@ TEST_F(StateModelTest, stateDefinition) {
     EXPECT_NO_THROW(getState(READY_ST));
 }
 
+/// @brief Verifies that the states and the events fetched from the model
+/// remain valid when more states and events are defined.
+TEST_F(StateModelTest, definitionsGrow) {
+    ASSERT_NO_THROW(defineState(READY_ST, "READY_ST",
+                                boost::bind(&StateModelTest::dummyHandler,
+                                            this)));
+    ASSERT_NO_THROW(defineEvent(WORK_START_EVT, "WORK_START_EVT"));
+    const StatePtr& state = getState(READY_ST);
+    const EventPtr& event = getEvent(WORK_START_EVT);
+
+    // Define the states and events with large values, so as the tables
+    // indexing them have to grow.
+    ASSERT_NO_THROW(defineState(READY_ST + 1000, "FAR_ST",
+                                boost::bind(&StateModelTest::dummyHandler,
+                                            this)));
+    ASSERT_NO_THROW(defineEvent(WORK_START_EVT + 1000, "FAR_EVT"));
+
+    ASSERT_TRUE(state);
+    EXPECT_EQ("READY_ST", state->getLabel());
+    ASSERT_TRUE(event);
+    EXPECT_EQ("WORK_START_EVT", event->getLabel());
+}
+
 /// @brief Tests state dictionary initialization and validation.
 /// This tests the basic concept of state dictionary initialization and
 /// verification by manually invoking the methods normally called by startModel.